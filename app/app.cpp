@@ -5,6 +5,7 @@
  */
 #include "app.h"
 #include "hal/hal.h"
+#include "shared/shared.h"
 #include "apps/app_installer.h"
 #include <mooncake.h>
 #include <mooncake_log.h>
@@ -34,6 +35,10 @@ void app::Update()
 {
     GetMooncake().update();
 
+    // Deliver what HAL tasks and LVGL callbacks posted since the last pass, one batch each
+    GetSystemStateEvents().Dispatch();
+    GetInputEvents().Dispatch();
+
 #if defined(__APPLE__) && defined(__MACH__)
     // 'nextEventMatchingMask should only be called from the Main Thread!'
     auto time_till_next = lv_timer_handler();
@@ -10,15 +10,19 @@
 #include <smooth_lvgl.h>
 #include <string>
 
+#include "assets/asset_mount.h"
 #include "hal/hal.h"
 #include "integration/cctv_controller.h"
 #include "integration/media_controller.h"
+#include "integration/home_assistant_sync.h"
 #include "integration/settings_controller.h"
+#include "ui/pages/ui_page_rooms.h"
 #include "ui/pages/ui_page_settings.h"
 #include "ui/ui_root.h"
 
 using namespace launcher_view;
 using custom::integration::CctvController;
+using custom::integration::HomeAssistantSync;
 using custom::integration::MediaController;
 using custom::integration::SettingsController;
 
@@ -36,6 +40,12 @@ void LauncherView::init()
 
     ensure_controllers();
 
+    if (_system_state_subscription == shared_data::SystemStateEventBus_t::kInvalidSubscription)
+    {
+        _system_state_subscription =
+            GetSystemStateEvents().SubscribeAll(LauncherView::system_state_event_cb, this);
+    }
+
     _init_pending = true;
     if (lv_async_call(LauncherView::build_async_cb, this) != LV_RES_OK)
     {
@@ -58,6 +68,11 @@ void LauncherView::ensure_controllers()
     {
         _cctv_controller = std::make_unique<CctvController>();
     }
+    if (_home_assistant_sync == nullptr)
+    {
+        _home_assistant_sync = std::make_unique<HomeAssistantSync>();
+        _home_assistant_sync->Start();
+    }
 }
 
 void LauncherView::build_async_cb(void* param)
@@ -100,6 +115,9 @@ void LauncherView::build_ui()
     lv_obj_add_event_cb(screen, LauncherView::pointer_event_cb, LV_EVENT_PRESSED, this);
     lv_obj_add_event_cb(screen, LauncherView::pointer_event_cb, LV_EVENT_PRESSING, this);
 
+    // Pages resolve their images from the asset bundle, so it is mapped before the first one
+    assets_fs_init();
+
     _ui_root = ui_root_create();
     if (_ui_root == nullptr)
     {
@@ -215,6 +233,18 @@ void LauncherView::build_ui()
 
     ui_page_settings_set_actions(&actions, _settings_controller.get());
 
+    ui_page_rooms_actions_t rooms_actions{};
+    rooms_actions.toggle = [](const char* room_id, const char* entity_id, void* user_data)
+    {
+        (void)room_id;
+        auto* sync = static_cast<HomeAssistantSync*>(user_data);
+        if (sync != nullptr)
+        {
+            sync->Toggle(entity_id);
+        }
+    };
+    ui_page_rooms_set_actions(&rooms_actions, _home_assistant_sync.get());
+
     if (_heartbeat_timer != nullptr)
     {
         lv_timer_del(_heartbeat_timer);
@@ -232,6 +262,11 @@ void LauncherView::build_ui()
     }
     if (_media_controller != nullptr)
     {
+        if (_home_assistant_sync != nullptr)
+        {
+            _media_controller->AttachPlayer(_home_assistant_sync->GetMediaPlayer());
+            _media_controller->AttachArtwork(_home_assistant_sync->GetArtworkLoader());
+        }
         _media_controller->PublishInitialState();
     }
     if (_cctv_controller != nullptr)
@@ -259,6 +294,7 @@ void LauncherView::destroy_ui()
     if (_ui_root != nullptr)
     {
         ui_page_settings_set_actions(nullptr, nullptr);
+        ui_page_rooms_set_actions(nullptr, nullptr);
         ui_root_destroy(_ui_root);
         _ui_root = nullptr;
     }
@@ -270,13 +306,21 @@ void LauncherView::update() {}
 
 LauncherView::~LauncherView()
 {
+    GetSystemStateEvents().Unsubscribe(_system_state_subscription);
+    _system_state_subscription = shared_data::SystemStateEventBus_t::kInvalidSubscription;
+
     if (_ui_root != nullptr || _heartbeat_timer != nullptr || _screen != nullptr)
     {
         LvglLockGuard lock;
         destroy_ui();
     }
 
-    _media_controller.reset();
+    // The media controller reads the sync's player and covers, so it goes first, with its timer
+    {
+        LvglLockGuard lock;
+        _media_controller.reset();
+    }
+    _home_assistant_sync.reset();
     _cctv_controller.reset();
     _settings_controller.reset();
 }
@@ -330,4 +374,46 @@ void LauncherView::heartbeat_timer_cb(lv_timer_t* timer)
 
     LV_UNUSED(timer);
     LV_LOG_INFO("LVGL heartbeat tick=%lu", (unsigned long)lv_tick_get());
+
+    const custom::platform::InputLatencySnapshot latency = GetHAL()->inputLatency.Snapshot();
+    if (latency.presses == 0U)
+    {
+        return;
+    }
+    LV_LOG_INFO("Touch latency presses=%lu no_frame=%lu read_period p50=%luus",
+                (unsigned long)latency.presses,
+                (unsigned long)latency.no_frame,
+                (unsigned long)latency.read_interval.p50_us);
+    LV_LOG_INFO("  read->dispatch p50/p95/p99=%lu/%lu/%luus dispatch->frame=%lu/%lu/%luus",
+                (unsigned long)latency.read_to_dispatch.p50_us,
+                (unsigned long)latency.read_to_dispatch.p95_us,
+                (unsigned long)latency.read_to_dispatch.p99_us,
+                (unsigned long)latency.dispatch_to_frame.p50_us,
+                (unsigned long)latency.dispatch_to_frame.p95_us,
+                (unsigned long)latency.dispatch_to_frame.p99_us);
+    LV_LOG_INFO("  read->frame p50/p95/p99=%lu/%lu/%luus max=%luus",
+                (unsigned long)latency.read_to_frame.p50_us,
+                (unsigned long)latency.read_to_frame.p95_us,
+                (unsigned long)latency.read_to_frame.p99_us,
+                (unsigned long)latency.read_to_frame.max_us);
+}
+
+void LauncherView::system_state_event_cb(shared_data::SystemStateEvent_t event,
+                                         const shared_data::EventData_t& data,
+                                         void*                           user_data)
+{
+    LV_UNUSED(user_data);
+
+    switch (event)
+    {
+        case shared_data::SystemStateEvent_t::UsbHidDevice:
+            mclog::tagInfo(_tag, "usb hid device {}", data.value != 0 ? "connected" : "removed");
+            break;
+        case shared_data::SystemStateEvent_t::CameraCapture:
+            mclog::tagInfo(_tag, "camera capture {}", data.value != 0 ? "started" : "stopped");
+            break;
+        default:
+            mclog::tagInfo(_tag, "system state {} = {}", static_cast<int>(event), data.value);
+            break;
+    }
 }
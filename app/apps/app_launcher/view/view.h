@@ -7,8 +7,10 @@
 #include <memory>
 
 #include "integration/cctv_controller.h"
+#include "integration/home_assistant_sync.h"
 #include "integration/media_controller.h"
 #include "integration/settings_controller.h"
+#include "shared/shared.h"
 
 typedef struct _lv_obj_t   lv_obj_t;
 typedef struct _lv_timer_t lv_timer_t;
@@ -33,15 +35,20 @@ namespace launcher_view
         static void build_async_cb(void* param);
         static void pointer_event_cb(lv_event_t* event);
         static void heartbeat_timer_cb(lv_timer_t* timer);
+        static void system_state_event_cb(shared_data::SystemStateEvent_t event,
+                                          const shared_data::EventData_t& data,
+                                          void*                           user_data);
 
         ui_root_t*                                               _ui_root = nullptr;
         std::unique_ptr<custom::integration::SettingsController> _settings_controller;
         std::unique_ptr<custom::integration::MediaController>    _media_controller;
         std::unique_ptr<custom::integration::CctvController>     _cctv_controller;
+        std::unique_ptr<custom::integration::HomeAssistantSync>  _home_assistant_sync;
         lv_timer_t*                                              _heartbeat_timer = nullptr;
         lv_obj_t*                                                _screen          = nullptr;
         bool                                                     _init_pending    = false;
         bool                                                     _touch_logged    = false;
+        int _system_state_subscription = shared_data::SystemStateEventBus_t::kInvalidSubscription;
     };
 
 }  // namespace launcher_view
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <mooncake_log.h>
+#include "platform/input/input_latency_lvgl.h"
 
 /* -------------------------------------------------------------------------- */
 /*                                  Singleton                                 */
@@ -57,3 +58,38 @@ bool hal::Check()
     }
     return false;
 }
+
+/* -------------------------------------------------------------------------- */
+/*                                   Events                                   */
+/* -------------------------------------------------------------------------- */
+void hal::HalBase::notifySystemState(shared_data::SystemStateEvent_t event, int32_t value)
+{
+    shared_data::EventData_t data;
+    data.value = value;
+    if (!GetSystemStateEvents().Post(event, data)) {
+        mclog::tagWarn(_tag, "system state queue full, dropped event {}", static_cast<int>(event));
+    }
+}
+
+void hal::HalBase::notifyInput(shared_data::InputEvent_t event, int32_t value, int16_t x, int16_t y)
+{
+    shared_data::EventData_t data;
+    data.value = value;
+    data.x     = x;
+    data.y     = y;
+    GetInputEvents().Post(event, data);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                Input latency                               */
+/* -------------------------------------------------------------------------- */
+void hal::HalBase::instrumentLvglInputLatency(lv_indev_t* indev, lv_display_t* display)
+{
+    // Posted from the indev, so presses on clickable pages are seen too
+    auto on_press = [this](const lv_point_t& point) {
+        notifyInput(shared_data::InputEvent_t::TouchPressed, 0, point.x, point.y);
+    };
+    if (!custom::platform::InstrumentLvglInputLatency(inputLatency, indev, display, on_press)) {
+        mclog::tagWarn(_tag, "indev could not be hooked, input latency not tracked");
+    }
+}
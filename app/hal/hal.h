@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: MIT
  */
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <queue>
@@ -11,6 +12,15 @@
 #include <lvgl.h>
 #include <mutex>
 #include <vector>
+#include "platform/audio/audio_stats.h"
+#include "platform/input/hid_input_queue.h"
+#include "platform/input/input_latency.h"
+#include "platform/spsc_ring.h"
+#include "shared/shared.h"
+
+namespace custom::platform {
+class ModbusPoller;
+}
 
 /**
  * @brief Hardware abstraction layer
@@ -44,6 +54,12 @@ public:
     {
     }
 
+    /* --------------------------------- Events --------------------------------- */
+    // Post a state change to GetSystemStateEvents(); safe from any task, never blocks for long
+    void notifySystemState(shared_data::SystemStateEvent_t event, int32_t value);
+    // Post an input event to GetInputEvents(); safe from any task
+    void notifyInput(shared_data::InputEvent_t event, int32_t value, int16_t x, int16_t y);
+
     /* --------------------------------- System --------------------------------- */
     virtual void delay(uint32_t ms)
     {
@@ -76,6 +92,11 @@ public:
 
     /* ---------------------------------- Lvgl ---------------------------------- */
     lv_indev_t* lvTouchpad = nullptr;
+    // Touch-to-frame timing, fed on the LVGL thread once instrumentLvglInputLatency() ran
+    custom::platform::InputLatencyTracker inputLatency;
+    // Wrap a pointer indev's read callback, hook its presses (posting TouchPressed) and the
+    // display's refresh events
+    void instrumentLvglInputLatency(lv_indev_t* indev, lv_display_t* display);
     virtual void lvglLock()
     {
     }
@@ -164,6 +185,8 @@ public:
     }
 
     /* --------------------------------- Camera --------------------------------- */
+    // imgCanvas must be an RGB565 lv_canvas. Frames are scaled (by the PPA on Tab5) into a
+    // triple buffer that includes its draw buffer; the canvas always shows the newest frame.
     virtual void startCameraCapture(lv_obj_t* imgCanvas)
     {
     }
@@ -176,14 +199,14 @@ public:
     }
 
     /* ---------------------------------- USB-A --------------------------------- */
-    struct HidMouseData_t {
-        std::mutex mutex;
-        int x         = 0;
-        int y         = 0;
-        bool btnLeft  = false;
-        bool btnRight = false;
+    // Filled by the USB host task, drained by the LVGL indev read callbacks; no locks on either
+    // side. Mouse motion is coalesced on read, button and key edges are kept in order.
+    struct HidInputData_t {
+        custom::platform::PointerEventQueue pointer{128};
+        custom::platform::SpscRing<custom::platform::KeyEvent> keys{64};
+        std::atomic<uint32_t> keysDropped{0};
     };
-    HidMouseData_t hidMouseData;
+    HidInputData_t hidInputData;
 
     /* ---------------------------------- Audio --------------------------------- */
     virtual void setSpeakerVolume(uint8_t volume)
@@ -200,6 +223,11 @@ public:
     virtual void audioPlay(std::vector<int16_t>& data, bool async = true)
     {
     }
+    // Underruns, queue depth, write-call and trigger-to-sound latency of the playback path
+    virtual custom::platform::AudioStatsSnapshot getAudioStats()
+    {
+        return {};
+    }
 
     // Mic record test
     enum MicTestState_t {
@@ -238,6 +266,18 @@ public:
     {
     }
 
+    // Stream a WAV/MP3 file (SD card path or URL) through the music player, stopped with
+    // stopPlayMusicTest()
+    virtual bool playAudioFile(const std::string& uri)
+    {
+        return false;
+    }
+    // Whether playAudioFile() has a decoder for this file's format
+    virtual bool canPlayAudioFile(const std::string& uri)
+    {
+        return false;
+    }
+
     // Sfx
     virtual void playStartupSfx()
     {
@@ -307,21 +347,32 @@ public:
     }
 
     /* ------------------------------ UART monitor ------------------------------ */
+    // Lock-free byte rings: rxRing is filled by the UART task and read by the UI, txRing the
+    // other way round. Each side moves whole spans; bytes that do not fit are dropped and counted.
     struct UartMonitorData_t {
-        std::mutex mutex;
-        std::queue<uint8_t> rxQueue;
-        std::queue<uint8_t> txQueue;
+        custom::platform::SpscRing<uint8_t> rxRing{4096};
+        custom::platform::SpscRing<uint8_t> txRing{4096};
+        std::atomic<uint32_t> rxDropped{0};
+        std::atomic<uint32_t> txDropped{0};
     };
     UartMonitorData_t uartMonitorData;
+    // Call from a single task (the UI); the UART task is the only consumer
     virtual void uartMonitorSend(std::string msg, bool newLine = true)
     {
-        std::lock_guard<std::mutex> lock(uartMonitorData.mutex);
-        for (auto c : msg) {
-            uartMonitorData.txQueue.push(c);
-        }
         if (newLine) {
-            uartMonitorData.txQueue.push('\n');
+            msg.push_back('\n');
         }
+        const auto* bytes    = reinterpret_cast<const uint8_t*>(msg.data());
+        const size_t written = uartMonitorData.txRing.Push(bytes, msg.size());
+        uartMonitorData.txDropped += static_cast<uint32_t>(msg.size() - written);
+    }
+
+    /* ------------------------------- Modbus RTU ------------------------------- */
+    // Periodic register polls and queued writes on the RS485 bus; nullptr when the port is not
+    // running as a Modbus master
+    virtual custom::platform::ModbusPoller* getModbusPoller()
+    {
+        return nullptr;
     }
 };
 
@@ -4,14 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 #pragma once
-#include <string>
-#include <thread>
-#include <mutex>
-#include <string>
-#include <vector>
-#include <queue>
-#include <functional>
-#include <smooth_ui_toolkit.h>
+#include <cstdint>
+#include "platform/event_bus.h"
 
 /**
  * @brief 共享数据层，提供一个带互斥锁的全局共享数据单例
@@ -19,13 +13,53 @@
  */
 namespace shared_data {
 
+/**
+ * @brief System state topics, posted by the HAL when a setting or attached device changes
+ *
+ */
+enum class SystemStateEvent_t : uint8_t {
+    DisplayBrightness,  // value: brightness 0-100
+    SpeakerVolume,      // value: volume 0-100
+    ChargeEnable,       // value: 1 enabled, 0 disabled
+    ChargeQcEnable,     // value: 1 enabled, 0 disabled
+    Usb5vEnable,        // value: 1 enabled, 0 disabled
+    Ext5vEnable,        // value: 1 enabled, 0 disabled
+    UsbHidDevice,       // value: 1 connected, 0 disconnected
+    CameraCapture,      // value: 1 started, 0 stopped
+};
+
+/**
+ * @brief Input topics
+ *
+ */
+enum class InputEvent_t : uint8_t {
+    TouchPressed,    // x/y: touch point
+    HidMouseButton,  // value: button bits (bit 0 left, bit 1 right), x/y: cursor
+};
+
+/**
+ * @brief Payload shared by both buses; fields unused by a topic stay 0
+ *
+ */
+struct EventData_t {
+    int32_t value = 0;
+    int16_t x     = 0;
+    int16_t y     = 0;
+};
+
+using SystemStateEventBus_t = custom::platform::EventBus<SystemStateEvent_t, EventData_t, 8, 32>;
+using InputEventBus_t       = custom::platform::EventBus<InputEvent_t, EventData_t, 8, 64>;
+
 /**
  * @brief 共享数据定义
  *
+ * Producers on any task Post() events; app::Update() dispatches them to subscribers on the
+ * main loop, so handlers run there and must take LvglLockGuard before touching LVGL.
+ *
  */
 struct SharedData_t {
-    smooth_ui_toolkit::Signal<std::string> systemStateEvents;
-    smooth_ui_toolkit::Signal<std::string> inputEvents;
+    SystemStateEventBus_t systemStateEvents;
+    InputEventBus_t inputEvents;
 };
 
 /**
@@ -53,12 +87,12 @@ inline shared_data::SharedData_t* GetSharedData()
     return shared_data::Get();
 }
 
-inline smooth_ui_toolkit::Signal<std::string>& GetSystemStateEvents()
+inline shared_data::SystemStateEventBus_t& GetSystemStateEvents()
 {
     return GetSharedData()->systemStateEvents;
 }
 
-inline smooth_ui_toolkit::Signal<std::string>& GetInputEvents()
+inline shared_data::InputEventBus_t& GetInputEvents()
 {
     return GetSharedData()->inputEvents;
 }
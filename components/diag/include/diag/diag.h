@@ -5,7 +5,10 @@
  */
 #pragma once
 
+#include <stddef.h>
+
 #include "esp_err.h"
+#include "diag/diag_metrics.h"
 #include "esp_http_server.h"
 #include "mqtt_client.h"
 #include "settings_core/app_cfg.h"
@@ -38,6 +41,39 @@ extern "C"
 
     typedef void (*diag_event_cb_t)(const diag_event_t* event, void* user_data);
 
+    /**
+     * Writes one JSON value (object, number, ...) for a /health section into @p buf.
+     * Returns the number of characters written, or a negative value to omit the section.
+     */
+    typedef int (*diag_health_writer_t)(char* buf, size_t len, void* user_data);
+
+#define DIAG_MAX_HEALTH_SECTIONS 8U
+
+    /* Sections may be registered before or after diag_start(). */
+    esp_err_t diag_register_health_section(const char*          name,
+                                           diag_health_writer_t writer,
+                                           void*                user_data);
+
+    /**
+     * Samples the CPU for @p seconds and streams the folded-stack profile through @p sink.
+     * Returns ESP_ERR_INVALID_STATE, having written nothing, while another capture runs.
+     */
+    typedef esp_err_t (*diag_profiler_t)(uint32_t            seconds,
+                                         diag_metrics_sink_t sink,
+                                         void*               sink_ctx,
+                                         void*               user_data);
+
+    /* Serves GET /profile?seconds=N (1-60, default 10); without one the endpoint answers 404. */
+    esp_err_t diag_register_profiler(diag_profiler_t profiler, void* user_data);
+
+    /* Writes the heap report (live allocations by site, free block sizes) through @p sink. */
+    typedef esp_err_t (*diag_heap_report_t)(diag_metrics_sink_t sink,
+                                            void*               sink_ctx,
+                                            void*               user_data);
+
+    /* Serves GET /heap; without a report the endpoint answers 404. */
+    esp_err_t diag_register_heap_report(diag_heap_report_t report, void* user_data);
+
     esp_err_t diag_start(const app_cfg_t* cfg,
                          diag_handles_t*  handles,
                          diag_event_cb_t  callback,
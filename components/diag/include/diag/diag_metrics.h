@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /*
+     * Runtime metrics registry, exported by diag at /metrics (Prometheus text) and as periodic
+     * MQTT telemetry (JSON).
+     *
+     * A module defines its metrics in static storage with the DIAG_METRIC_*_DEFINE macros and
+     * registers them once; nothing is allocated. Updates are single atomic operations, so
+     * they are safe from any task and cheap enough for hot paths such as a frame callback.
+     * Values that are cheaper to read than to track (free heap, stack high-water marks) come
+     * from collectors, which run at the start of every export.
+     */
+
+    typedef enum
+    {
+        DIAG_METRIC_COUNTER = 0,
+        DIAG_METRIC_GAUGE,
+        DIAG_METRIC_HISTOGRAM,
+    } diag_metric_type_t;
+
+    typedef struct diag_metric_t
+    {
+        const char*           name; /* Prometheus name, e.g. "lvgl_frame_us" */
+        const char*           help;
+        diag_metric_type_t    type;
+        const uint32_t*       bounds; /* histogram: ascending bucket upper bounds */
+        size_t                bound_count;
+        uint32_t*             buckets; /* histogram: bound_count + 1 counts, the last is +Inf */
+        uint32_t              counter;
+        int32_t               gauge;
+        uint64_t              sum; /* histogram: sum of observed values */
+        uint32_t              registered;
+        struct diag_metric_t* next;
+    } diag_metric_t;
+
+/* Zero value, registration flag and list link that follow the definition fields */
+#define DIAG_METRIC_STATE_INIT 0U, 0, 0U, 0U, NULL
+
+#define DIAG_METRIC_COUNTER_DEFINE(var, metric_name, help_text)                                    \
+    static diag_metric_t var = {                                                                   \
+        (metric_name), (help_text), DIAG_METRIC_COUNTER, NULL, 0U, NULL, DIAG_METRIC_STATE_INIT}
+
+#define DIAG_METRIC_GAUGE_DEFINE(var, metric_name, help_text)                                      \
+    static diag_metric_t var = {                                                                   \
+        (metric_name), (help_text), DIAG_METRIC_GAUGE, NULL, 0U, NULL, DIAG_METRIC_STATE_INIT}
+
+/* The variadic part lists the bucket upper bounds, ascending. */
+#define DIAG_METRIC_HISTOGRAM_DEFINE(var, metric_name, help_text, ...)                             \
+    static const uint32_t var##_bounds[] = {__VA_ARGS__};                                          \
+    static uint32_t       var##_buckets[sizeof(var##_bounds) / sizeof(var##_bounds[0]) + 1U];      \
+    static diag_metric_t  var            = {(metric_name),                                         \
+                                            (help_text),                                           \
+                                            DIAG_METRIC_HISTOGRAM,                                 \
+                                            var##_bounds,                                          \
+                                            sizeof(var##_bounds) / sizeof(var##_bounds[0]),        \
+                                            var##_buckets,                                         \
+                                            DIAG_METRIC_STATE_INIT}
+
+    /* Opaque output of an export in progress, handed to collectors. */
+    typedef struct diag_metrics_writer_t diag_metrics_writer_t;
+
+    /*
+     * Runs at the start of every export. May update registered gauges, and may write samples
+     * with diag_metrics_write_sample() for values that have no static metric, such as one per
+     * task.
+     */
+    typedef void (*diag_metrics_collector_t)(diag_metrics_writer_t* out, void* user_data);
+
+    /* Receives the export in chunks. Returns false to abort it. */
+    typedef bool (*diag_metrics_sink_t)(const char* data, size_t len, void* user_data);
+
+    typedef enum
+    {
+        DIAG_METRICS_PROMETHEUS = 0,
+        DIAG_METRICS_JSON,
+    } diag_metrics_format_t;
+
+#define DIAG_MAX_METRIC_COLLECTORS 8U
+
+    /* Registering the same metric again is a no-op. */
+    esp_err_t diag_metric_register(diag_metric_t* metric);
+    esp_err_t diag_metrics_register_collector(diag_metrics_collector_t collector, void* user_data);
+
+    void diag_metric_add(diag_metric_t* counter, uint32_t delta);
+    void diag_metric_set(diag_metric_t* gauge, int32_t value);
+    void diag_metric_observe(diag_metric_t* histogram, uint32_t value);
+
+    /*
+     * One sample of a labelled gauge family; consecutive calls with the same name form one
+     * family. @p label may be NULL for an unlabelled value.
+     */
+    void diag_metrics_write_sample(diag_metrics_writer_t* out,
+                                   const char*            name,
+                                   const char*            help,
+                                   const char*            label,
+                                   const char*            label_value,
+                                   int64_t                value);
+
+    /* Runs the collectors, then writes every registered metric. */
+    esp_err_t
+    diag_metrics_export(diag_metrics_format_t format, diag_metrics_sink_t sink, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,8 +6,12 @@
 #include "diag/diag.h"
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "diag/diag_metrics.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_system.h"
@@ -16,6 +20,37 @@
 
 static const char* TAG = "diag";
 
+#define DIAG_HEALTH_PAYLOAD_LEN  1024U
+#define DIAG_METRICS_PAYLOAD_LEN 2048U
+#define DIAG_METRICS_PUBLISH_US  (30LL * 1000 * 1000)
+#define DIAG_METRICS_TOPIC_LEN   96U
+#define DIAG_PROFILE_DEFAULT_S   10U
+#define DIAG_PROFILE_MAX_S       60U
+
+typedef struct
+{
+    const char*          name;
+    diag_health_writer_t writer;
+    void*                user_data;
+} diag_health_section_t;
+
+typedef struct
+{
+    char*  buf;
+    size_t len;
+    size_t used;
+} diag_metrics_buffer_t;
+
+static diag_health_section_t s_health_sections[DIAG_MAX_HEALTH_SECTIONS];
+static size_t                s_health_section_count;
+static esp_timer_handle_t    s_metrics_timer;
+static volatile bool         s_mqtt_connected;
+static char                  s_metrics_topic[DIAG_METRICS_TOPIC_LEN];
+static diag_profiler_t       s_profiler;
+static void*                 s_profiler_user_data;
+static diag_heap_report_t    s_heap_report;
+static void*                 s_heap_report_user_data;
+
 static void
 emit_diag_event(diag_event_cb_t callback, void* user_data, diag_event_type_t type, esp_err_t error)
 {
@@ -48,21 +83,246 @@ static esp_err_t diag_register_mdns(const app_cfg_t* cfg)
     return ESP_OK;
 }
 
+esp_err_t diag_register_health_section(const char*          name,
+                                       diag_health_writer_t writer,
+                                       void*                user_data)
+{
+    if (name == NULL || writer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_health_section_count >= DIAG_MAX_HEALTH_SECTIONS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    s_health_sections[s_health_section_count++] = (diag_health_section_t){
+        .name      = name,
+        .writer    = writer,
+        .user_data = user_data,
+    };
+    return ESP_OK;
+}
+
 static esp_err_t health_handler(httpd_req_t* req)
 {
+    static char payload[DIAG_HEALTH_PAYLOAD_LEN];
+
     int64_t uptime_ms = esp_timer_get_time() / 1000;
-    char    payload[128];
-    int     written = snprintf(payload,
+    int     written   = snprintf(payload,
                            sizeof(payload),
-                           "{\"uptime_ms\":%lld,\"heap\":%" PRIu32 "}",
+                           "{\"uptime_ms\":%lld,\"heap\":%" PRIu32,
                            (long long)uptime_ms,
                            esp_get_free_heap_size());
-    if (written < 0)
+    if (written < 0 || (size_t)written >= sizeof(payload))
     {
         return ESP_FAIL;
     }
+
+    size_t used = (size_t)written;
+    for (size_t i = 0; i < s_health_section_count; ++i)
+    {
+        const diag_health_section_t* section = &s_health_sections[i];
+        int key = snprintf(payload + used, sizeof(payload) - used, ",\"%s\":", section->name);
+        if (key < 0 || used + (size_t)key >= sizeof(payload) - 1U)
+        {
+            payload[used] = '\0';
+            break;
+        }
+        int value = section->writer(
+            payload + used + key, sizeof(payload) - used - (size_t)key - 1U, section->user_data);
+        if (value < 0 || used + (size_t)key + (size_t)value >= sizeof(payload) - 1U)
+        {
+            /* Drop the half-written key and keep the rest of the payload valid */
+            payload[used] = '\0';
+            continue;
+        }
+        used += (size_t)key + (size_t)value;
+    }
+    payload[used++] = '}';
+    payload[used]   = '\0';
+
     httpd_resp_set_type(req, "application/json");
-    return httpd_resp_send(req, payload, HTTPD_RESP_USE_STRLEN);
+    return httpd_resp_send(req, payload, (ssize_t)used);
+}
+
+static bool resp_send_chunk(const char* data, size_t len, void* user_data)
+{
+    return httpd_resp_send_chunk((httpd_req_t*)user_data, data, (ssize_t)len) == ESP_OK;
+}
+
+/* Streamed in chunks, so the page size is not bounded by a payload buffer */
+static esp_err_t metrics_handler(httpd_req_t* req)
+{
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    esp_err_t err = diag_metrics_export(DIAG_METRICS_PROMETHEUS, resp_send_chunk, req);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Metrics export failed: 0x%x", (unsigned int)err);
+        if (err == ESP_FAIL)
+        {
+            return ESP_FAIL; /* the client went away mid-response */
+        }
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t diag_register_profiler(diag_profiler_t profiler, void* user_data)
+{
+    if (profiler == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_profiler != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_profiler_user_data = user_data;
+    s_profiler           = profiler;
+    return ESP_OK;
+}
+
+/*
+ * The capture runs on the server task, so other endpoints wait until it is done. That keeps
+ * the profile free of the server's own work, and one capture at a time is all the sampler
+ * supports anyway.
+ */
+static esp_err_t profile_handler(httpd_req_t* req)
+{
+    if (s_profiler == NULL)
+    {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No profiler in this build");
+    }
+
+    uint32_t seconds = DIAG_PROFILE_DEFAULT_S;
+    char     query[32];
+    char     value[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK
+        && httpd_query_key_value(query, "seconds", value, sizeof(value)) == ESP_OK)
+    {
+        char*         end    = NULL;
+        unsigned long parsed = strtoul(value, &end, 10);
+        if (end == value || *end != '\0' || parsed == 0UL || parsed > DIAG_PROFILE_MAX_S)
+        {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "seconds must be 1-60");
+        }
+        seconds = (uint32_t)parsed;
+    }
+
+    ESP_LOGI(TAG, "Profiling for %" PRIu32 " s", seconds);
+    httpd_resp_set_type(req, "text/plain");
+    esp_err_t err = s_profiler(seconds, resp_send_chunk, req, s_profiler_user_data);
+    if (err == ESP_ERR_INVALID_STATE)
+    {
+        httpd_resp_set_status(req, "409 Conflict");
+        return httpd_resp_sendstr(req, "A capture is already running\n");
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Profile capture failed: 0x%x", (unsigned int)err);
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t diag_register_heap_report(diag_heap_report_t report, void* user_data)
+{
+    if (report == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_heap_report != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_heap_report_user_data = user_data;
+    s_heap_report           = report;
+    return ESP_OK;
+}
+
+static esp_err_t heap_handler(httpd_req_t* req)
+{
+    if (s_heap_report == NULL)
+    {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No heap report in this build");
+    }
+    httpd_resp_set_type(req, "text/plain");
+    esp_err_t err = s_heap_report(resp_send_chunk, req, s_heap_report_user_data);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Heap report failed: 0x%x", (unsigned int)err);
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static bool metrics_append(const char* data, size_t len, void* user_data)
+{
+    diag_metrics_buffer_t* buffer = (diag_metrics_buffer_t*)user_data;
+    if (buffer->used + len > buffer->len)
+    {
+        return false;
+    }
+    memcpy(buffer->buf + buffer->used, data, len);
+    buffer->used += len;
+    return true;
+}
+
+static void metrics_publish(void* arg)
+{
+    static char payload[DIAG_METRICS_PAYLOAD_LEN];
+
+    esp_mqtt_client_handle_t mqtt = (esp_mqtt_client_handle_t)arg;
+    if (!s_mqtt_connected)
+    {
+        return;
+    }
+    diag_metrics_buffer_t buffer = {
+        .buf  = payload,
+        .len  = sizeof(payload),
+        .used = 0U,
+    };
+    esp_err_t err = diag_metrics_export(DIAG_METRICS_JSON, metrics_append, &buffer);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Metrics telemetry skipped: 0x%x", (unsigned int)err);
+        return;
+    }
+    /* Enqueue rather than publish: this runs on the esp_timer task and must not block on I/O */
+    esp_mqtt_client_enqueue(mqtt, s_metrics_topic, payload, (int)buffer.used, 0, 0, true);
+}
+
+static void
+mqtt_event_handler(void* handler_args, esp_event_base_t base, int32_t event_id, void* event_data)
+{
+    (void)handler_args;
+    (void)base;
+    (void)event_data;
+    if (event_id == MQTT_EVENT_CONNECTED)
+    {
+        s_mqtt_connected = true;
+    }
+    else if (event_id == MQTT_EVENT_DISCONNECTED)
+    {
+        s_mqtt_connected = false;
+    }
+}
+
+static esp_err_t diag_start_metrics_telemetry(const app_cfg_t* cfg, esp_mqtt_client_handle_t mqtt)
+{
+    snprintf(s_metrics_topic, sizeof(s_metrics_topic), "tab5/%s/metrics", cfg->network.hostname);
+    esp_mqtt_client_register_event(mqtt, MQTT_EVENT_ANY, mqtt_event_handler, NULL);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = metrics_publish,
+        .arg      = mqtt,
+        .name     = "diag_metrics",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_metrics_timer);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return esp_timer_start_periodic(s_metrics_timer, DIAG_METRICS_PUBLISH_US);
 }
 
 esp_err_t
@@ -95,6 +355,30 @@ diag_start(const app_cfg_t* cfg, diag_handles_t* handles, diag_event_cb_t callba
     };
     httpd_register_uri_handler(handles->httpd, &health_uri);
 
+    httpd_uri_t metrics_uri = {
+        .uri      = "/metrics",
+        .method   = HTTP_GET,
+        .handler  = metrics_handler,
+        .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(handles->httpd, &metrics_uri);
+
+    httpd_uri_t profile_uri = {
+        .uri      = "/profile",
+        .method   = HTTP_GET,
+        .handler  = profile_handler,
+        .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(handles->httpd, &profile_uri);
+
+    httpd_uri_t heap_uri = {
+        .uri      = "/heap",
+        .method   = HTTP_GET,
+        .handler  = heap_handler,
+        .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(handles->httpd, &heap_uri);
+
     esp_mqtt_client_config_t mqtt_config = {
         .broker.address.uri                  = cfg->mqtt.broker_uri,
         .credentials.username                = cfg->mqtt.username,
@@ -103,6 +387,12 @@ diag_start(const app_cfg_t* cfg, diag_handles_t* handles, diag_event_cb_t callba
     handles->mqtt = esp_mqtt_client_init(&mqtt_config);
     if (handles->mqtt)
     {
+        esp_err_t telemetry_err = diag_start_metrics_telemetry(cfg, handles->mqtt);
+        if (telemetry_err != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Metrics telemetry disabled: 0x%x", (unsigned int)telemetry_err);
+            emit_diag_event(callback, user_data, DIAG_EVENT_WARNING, telemetry_err);
+        }
         esp_err_t mqtt_err = esp_mqtt_client_start(handles->mqtt);
         if (mqtt_err != ESP_OK)
         {
@@ -134,6 +424,13 @@ void diag_stop(diag_handles_t* handles)
     {
         return;
     }
+    if (s_metrics_timer)
+    {
+        esp_timer_stop(s_metrics_timer);
+        esp_timer_delete(s_metrics_timer);
+        s_metrics_timer  = NULL;
+        s_mqtt_connected = false;
+    }
     if (handles->mqtt)
     {
         esp_mqtt_client_stop(handles->mqtt);
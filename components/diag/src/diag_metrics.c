@@ -0,0 +1,397 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "diag/diag_metrics.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Kept free of ESP-IDF APIs so the host tests can build it */
+
+#define DIAG_METRICS_CHUNK_LEN 256U
+#define DIAG_METRICS_LINE_LEN  192U
+
+struct diag_metrics_writer_t
+{
+    diag_metrics_format_t format;
+    diag_metrics_sink_t   sink;
+    void*                 user_data;
+    esp_err_t             status;
+    bool                  first_member; /* JSON: no comma before the next member */
+    const char*           family;       /* labelled family whose header was written */
+    bool                  family_open;  /* JSON: its object is still open */
+    size_t                used;
+    char                  chunk[DIAG_METRICS_CHUNK_LEN];
+};
+
+typedef struct
+{
+    diag_metrics_collector_t collector;
+    void*                    user_data;
+} diag_metrics_collector_entry_t;
+
+static diag_metric_t*                 s_metrics;
+static diag_metrics_collector_entry_t s_collectors[DIAG_MAX_METRIC_COLLECTORS];
+static uint32_t                       s_collector_count;
+
+static void writer_flush(diag_metrics_writer_t* out)
+{
+    if (out->used > 0U && out->status == ESP_OK
+        && !out->sink(out->chunk, out->used, out->user_data))
+    {
+        out->status = ESP_FAIL;
+    }
+    out->used = 0U;
+}
+
+static void writer_put(diag_metrics_writer_t* out, const char* data, size_t len)
+{
+    while (len > 0U && out->status == ESP_OK)
+    {
+        size_t room = sizeof(out->chunk) - out->used;
+        size_t take = len < room ? len : room;
+        memcpy(out->chunk + out->used, data, take);
+        out->used += take;
+        data += take;
+        len -= take;
+        if (out->used == sizeof(out->chunk))
+        {
+            writer_flush(out);
+        }
+    }
+}
+
+static void writer_printf(diag_metrics_writer_t* out, const char* fmt, ...)
+{
+    char    line[DIAG_METRICS_LINE_LEN];
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= sizeof(line))
+    {
+        out->status = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+    writer_put(out, line, (size_t)written);
+}
+
+/* Label values are free text (task names); both formats escape the same two characters */
+static void writer_put_escaped(diag_metrics_writer_t* out, const char* text)
+{
+    for (const char* c = text; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            writer_put(out, "\\", 1U);
+            writer_put(out, c, 1U);
+        }
+        else if ((unsigned char)*c < 0x20U)
+        {
+            writer_put(out, "_", 1U);
+        }
+        else
+        {
+            writer_put(out, c, 1U);
+        }
+    }
+}
+
+static void json_close_family(diag_metrics_writer_t* out)
+{
+    if (out->family_open)
+    {
+        writer_put(out, "}", 1U);
+        out->family_open = false;
+    }
+}
+
+/* JSON: separator and key of the next top-level member */
+static void json_member(diag_metrics_writer_t* out, const char* name)
+{
+    json_close_family(out);
+    out->family = NULL;
+    writer_printf(out, "%s\"%s\":", out->first_member ? "" : ",", name);
+    out->first_member = false;
+}
+
+static void prometheus_header(diag_metrics_writer_t* out,
+                              const char*            name,
+                              const char*            help,
+                              const char*            type)
+{
+    writer_printf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help != NULL ? help : "", name, type);
+}
+
+static void write_histogram(diag_metrics_writer_t* out, const diag_metric_t* metric)
+{
+    uint64_t sum   = __atomic_load_n(&metric->sum, __ATOMIC_RELAXED);
+    uint64_t total = 0U;
+
+    /* Buckets are read one by one, so a scrape racing an update may be off by one sample */
+    if (out->format == DIAG_METRICS_PROMETHEUS)
+    {
+        prometheus_header(out, metric->name, metric->help, "histogram");
+        for (size_t i = 0; i <= metric->bound_count; ++i)
+        {
+            total += __atomic_load_n(&metric->buckets[i], __ATOMIC_RELAXED);
+            if (i < metric->bound_count)
+            {
+                writer_printf(out,
+                              "%s_bucket{le=\"%" PRIu32 "\"} %" PRIu64 "\n",
+                              metric->name,
+                              metric->bounds[i],
+                              total);
+            }
+            else
+            {
+                writer_printf(out, "%s_bucket{le=\"+Inf\"} %" PRIu64 "\n", metric->name, total);
+            }
+        }
+        writer_printf(out,
+                      "%s_sum %" PRIu64 "\n%s_count %" PRIu64 "\n",
+                      metric->name,
+                      sum,
+                      metric->name,
+                      total);
+        return;
+    }
+
+    json_member(out, metric->name);
+    writer_put(out, "{\"le\":[", 7U);
+    for (size_t i = 0; i < metric->bound_count; ++i)
+    {
+        writer_printf(out, "%s%" PRIu32, i > 0U ? "," : "", metric->bounds[i]);
+    }
+    writer_put(out, "],\"counts\":[", 12U);
+    for (size_t i = 0; i <= metric->bound_count; ++i)
+    {
+        uint32_t count = __atomic_load_n(&metric->buckets[i], __ATOMIC_RELAXED);
+        total += count;
+        writer_printf(out, "%s%" PRIu32, i > 0U ? "," : "", count);
+    }
+    writer_printf(out, "],\"sum\":%" PRIu64 ",\"count\":%" PRIu64 "}", sum, total);
+}
+
+static void write_metric(diag_metrics_writer_t* out, const diag_metric_t* metric)
+{
+    switch (metric->type)
+    {
+        case DIAG_METRIC_COUNTER:
+        {
+            uint32_t value = __atomic_load_n(&metric->counter, __ATOMIC_RELAXED);
+            if (out->format == DIAG_METRICS_PROMETHEUS)
+            {
+                prometheus_header(out, metric->name, metric->help, "counter");
+                writer_printf(out, "%s %" PRIu32 "\n", metric->name, value);
+            }
+            else
+            {
+                json_member(out, metric->name);
+                writer_printf(out, "%" PRIu32, value);
+            }
+            break;
+        }
+        case DIAG_METRIC_GAUGE:
+        {
+            int32_t value = __atomic_load_n(&metric->gauge, __ATOMIC_RELAXED);
+            if (out->format == DIAG_METRICS_PROMETHEUS)
+            {
+                prometheus_header(out, metric->name, metric->help, "gauge");
+                writer_printf(out, "%s %" PRId32 "\n", metric->name, value);
+            }
+            else
+            {
+                json_member(out, metric->name);
+                writer_printf(out, "%" PRId32, value);
+            }
+            break;
+        }
+        case DIAG_METRIC_HISTOGRAM:
+            write_histogram(out, metric);
+            break;
+    }
+}
+
+esp_err_t diag_metric_register(diag_metric_t* metric)
+{
+    if (metric == NULL || metric->name == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (metric->type == DIAG_METRIC_HISTOGRAM
+        && (metric->bounds == NULL || metric->buckets == NULL || metric->bound_count == 0U))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (__atomic_exchange_n(&metric->registered, 1U, __ATOMIC_ACQ_REL) != 0U)
+    {
+        return ESP_OK;
+    }
+
+    /* Push onto a list that is never unlinked from, so exports can walk it without a lock */
+    diag_metric_t* head = __atomic_load_n(&s_metrics, __ATOMIC_ACQUIRE);
+    do
+    {
+        metric->next = head;
+    } while (!__atomic_compare_exchange_n(
+        &s_metrics, &head, metric, true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    return ESP_OK;
+}
+
+esp_err_t diag_metrics_register_collector(diag_metrics_collector_t collector, void* user_data)
+{
+    if (collector == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t count = __atomic_load_n(&s_collector_count, __ATOMIC_ACQUIRE);
+    if (count >= DIAG_MAX_METRIC_COLLECTORS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    s_collectors[count] = (diag_metrics_collector_entry_t){
+        .collector = collector,
+        .user_data = user_data,
+    };
+    __atomic_store_n(&s_collector_count, count + 1U, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+void diag_metric_add(diag_metric_t* counter, uint32_t delta)
+{
+    if (counter != NULL)
+    {
+        __atomic_fetch_add(&counter->counter, delta, __ATOMIC_RELAXED);
+    }
+}
+
+void diag_metric_set(diag_metric_t* gauge, int32_t value)
+{
+    if (gauge != NULL)
+    {
+        __atomic_store_n(&gauge->gauge, value, __ATOMIC_RELAXED);
+    }
+}
+
+void diag_metric_observe(diag_metric_t* histogram, uint32_t value)
+{
+    if (histogram == NULL || histogram->buckets == NULL)
+    {
+        return;
+    }
+    size_t bucket = 0U;
+    while (bucket < histogram->bound_count && value > histogram->bounds[bucket])
+    {
+        bucket++;
+    }
+    __atomic_fetch_add(&histogram->buckets[bucket], 1U, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, (uint64_t)value, __ATOMIC_RELAXED);
+}
+
+void diag_metrics_write_sample(diag_metrics_writer_t* out,
+                               const char*            name,
+                               const char*            help,
+                               const char*            label,
+                               const char*            label_value,
+                               int64_t                value)
+{
+    if (out == NULL || name == NULL)
+    {
+        return;
+    }
+    const bool labelled   = label != NULL && label_value != NULL;
+    const bool same_group = out->family != NULL && strcmp(out->family, name) == 0;
+
+    if (out->format == DIAG_METRICS_PROMETHEUS)
+    {
+        if (!same_group)
+        {
+            prometheus_header(out, name, help, "gauge");
+            out->family = name;
+        }
+        if (labelled)
+        {
+            writer_printf(out, "%s{%s=\"", name, label);
+            writer_put_escaped(out, label_value);
+            writer_printf(out, "\"} %" PRId64 "\n", value);
+        }
+        else
+        {
+            writer_printf(out, "%s %" PRId64 "\n", name, value);
+        }
+        return;
+    }
+
+    /* JSON: a labelled family becomes one object keyed by label value */
+    if (!labelled)
+    {
+        json_member(out, name);
+        writer_printf(out, "%" PRId64, value);
+        return;
+    }
+    if (same_group && out->family_open)
+    {
+        writer_put(out, ",", 1U);
+    }
+    else
+    {
+        json_member(out, name);
+        writer_put(out, "{", 1U);
+        out->family      = name;
+        out->family_open = true;
+    }
+    writer_put(out, "\"", 1U);
+    writer_put_escaped(out, label_value);
+    writer_printf(out, "\":%" PRId64, value);
+}
+
+esp_err_t
+diag_metrics_export(diag_metrics_format_t format, diag_metrics_sink_t sink, void* user_data)
+{
+    if (sink == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    diag_metrics_writer_t out = {
+        .format       = format,
+        .sink         = sink,
+        .user_data    = user_data,
+        .status       = ESP_OK,
+        .first_member = true,
+    };
+    if (format == DIAG_METRICS_JSON)
+    {
+        writer_put(&out, "{", 1U);
+    }
+
+    uint32_t collectors = __atomic_load_n(&s_collector_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < collectors; ++i)
+    {
+        s_collectors[i].collector(&out, s_collectors[i].user_data);
+        out.family = NULL;
+        if (format == DIAG_METRICS_JSON)
+        {
+            json_close_family(&out);
+        }
+    }
+
+    for (const diag_metric_t* metric = __atomic_load_n(&s_metrics, __ATOMIC_ACQUIRE);
+         metric != NULL;
+         metric = metric->next)
+    {
+        write_metric(&out, metric);
+    }
+
+    if (format == DIAG_METRICS_JSON)
+    {
+        writer_put(&out, "}", 1U);
+    }
+    writer_flush(&out);
+    return out.status;
+}
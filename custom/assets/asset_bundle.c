@@ -0,0 +1,306 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "asset_bundle.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_partition.h"
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSET_BUNDLE_HAS_MMAP 1
+#endif
+
+enum {
+    MAPPING_NONE = 0,
+    MAPPING_PARTITION,
+    MAPPING_MMAP,
+    MAPPING_HEAP,
+};
+
+/* Header field offsets. */
+enum {
+    HDR_MAGIC          = 0,
+    HDR_VERSION        = 4,
+    HDR_HEADER_SIZE    = 6,
+    HDR_ENTRY_COUNT    = 8,
+    HDR_INDEX_OFFSET   = 12,
+    HDR_STRINGS_OFFSET = 16,
+    HDR_STRINGS_SIZE   = 20,
+    HDR_DATA_OFFSET    = 24,
+    HDR_TOTAL_SIZE     = 28,
+};
+
+/* Index entry field offsets. */
+enum {
+    ENT_HASH        = 0,
+    ENT_NAME_OFFSET = 4,
+    ENT_DATA_OFFSET = 8,
+    ENT_DATA_SIZE   = 12,
+    ENT_RAW_SIZE    = 16,
+    ENT_WIDTH       = 20,
+    ENT_HEIGHT      = 22,
+    ENT_STRIDE      = 24,
+    ENT_FORMAT      = 26,
+    ENT_COMPRESSION = 27,
+};
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool range_ok(size_t size, uint32_t offset, uint64_t length)
+{
+    return (uint64_t)offset + length <= size;
+}
+
+uint32_t asset_bundle_hash(const char *id)
+{
+    uint32_t hash = 2166136261U;
+    if (id == NULL) {
+        return hash;
+    }
+    for (const unsigned char *p = (const unsigned char *)id; *p != '\0'; ++p) {
+        hash ^= *p;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+bool asset_bundle_open_memory(asset_bundle_t *bundle, const void *data, size_t size)
+{
+    if (bundle == NULL || data == NULL) {
+        return false;
+    }
+    memset(bundle, 0, sizeof(*bundle));
+
+    const uint8_t *base = (const uint8_t *)data;
+    if (size < ASSET_BUNDLE_HEADER_SIZE || memcmp(base + HDR_MAGIC, ASSET_BUNDLE_MAGIC, 4) != 0) {
+        return false;
+    }
+    if (rd16(base + HDR_VERSION) != ASSET_BUNDLE_VERSION
+        || rd16(base + HDR_HEADER_SIZE) < ASSET_BUNDLE_HEADER_SIZE) {
+        return false;
+    }
+
+    /* A flash partition is usually larger than the bundle it holds. */
+    const uint32_t total = rd32(base + HDR_TOTAL_SIZE);
+    if (total < ASSET_BUNDLE_HEADER_SIZE || total > size) {
+        return false;
+    }
+
+    const uint32_t count         = rd32(base + HDR_ENTRY_COUNT);
+    const uint32_t index_offset  = rd32(base + HDR_INDEX_OFFSET);
+    const uint32_t string_offset = rd32(base + HDR_STRINGS_OFFSET);
+    const uint32_t string_size   = rd32(base + HDR_STRINGS_SIZE);
+    if (!range_ok(total, index_offset, (uint64_t)count * ASSET_BUNDLE_ENTRY_SIZE)
+        || !range_ok(total, string_offset, string_size)) {
+        return false;
+    }
+    if (string_size > 0U && base[string_offset + string_size - 1U] != '\0') {
+        return false;
+    }
+
+    bundle->base         = base;
+    bundle->size         = total;
+    bundle->entry_count  = count;
+    bundle->index        = base + index_offset;
+    bundle->strings      = (const char *)(base + string_offset);
+    bundle->strings_size = string_size;
+    return true;
+}
+
+bool asset_bundle_entry_at(const asset_bundle_t *bundle, uint32_t index, asset_bundle_entry_t *out)
+{
+    if (bundle == NULL || bundle->base == NULL || index >= bundle->entry_count || out == NULL) {
+        return false;
+    }
+
+    const uint8_t *e         = bundle->index + (size_t)index * ASSET_BUNDLE_ENTRY_SIZE;
+    const uint32_t name_off  = rd32(e + ENT_NAME_OFFSET);
+    const uint32_t data_off  = rd32(e + ENT_DATA_OFFSET);
+    const uint32_t data_size = rd32(e + ENT_DATA_SIZE);
+    if (name_off >= bundle->strings_size || !range_ok(bundle->size, data_off, data_size)) {
+        return false;
+    }
+
+    out->index       = index;
+    out->id          = bundle->strings + name_off;
+    out->data        = bundle->base + data_off;
+    out->data_size   = data_size;
+    out->raw_size    = rd32(e + ENT_RAW_SIZE);
+    out->width       = rd16(e + ENT_WIDTH);
+    out->height      = rd16(e + ENT_HEIGHT);
+    out->stride      = rd16(e + ENT_STRIDE);
+    out->format      = e[ENT_FORMAT];
+    out->compression = e[ENT_COMPRESSION];
+    return true;
+}
+
+bool asset_bundle_find(const asset_bundle_t *bundle, const char *id, asset_bundle_entry_t *out)
+{
+    if (bundle == NULL || bundle->base == NULL || id == NULL) {
+        return false;
+    }
+
+    /* Lower bound on the hash, then walk the (rare) run of colliding ids. */
+    const uint32_t hash = asset_bundle_hash(id);
+    uint32_t lo         = 0U;
+    uint32_t hi         = bundle->entry_count;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2U;
+        if (rd32(bundle->index + (size_t)mid * ASSET_BUNDLE_ENTRY_SIZE + ENT_HASH) < hash) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (uint32_t i = lo; i < bundle->entry_count; ++i) {
+        const uint8_t *e = bundle->index + (size_t)i * ASSET_BUNDLE_ENTRY_SIZE;
+        if (rd32(e + ENT_HASH) != hash) {
+            break;
+        }
+        const uint32_t name_off = rd32(e + ENT_NAME_OFFSET);
+        if (name_off < bundle->strings_size && strcmp(bundle->strings + name_off, id) == 0) {
+            asset_bundle_entry_t scratch;
+            return asset_bundle_entry_at(bundle, i, out != NULL ? out : &scratch);
+        }
+    }
+    return false;
+}
+
+/* ---- Mapping backends ---- */
+
+#if defined(ESP_PLATFORM)
+
+static bool map_source(asset_bundle_t *bundle, const char *label)
+{
+    const esp_partition_t *part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL) {
+        return false;
+    }
+
+    const void *ptr                    = NULL;
+    esp_partition_mmap_handle_t handle = 0;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &handle) != ESP_OK) {
+        return false;
+    }
+    if (!asset_bundle_open_memory(bundle, ptr, part->size)) {
+        esp_partition_munmap(handle);
+        return false;
+    }
+    bundle->mapping      = (void *)(uintptr_t)handle;
+    bundle->mapping_kind = MAPPING_PARTITION;
+    return true;
+}
+
+#elif defined(ASSET_BUNDLE_HAS_MMAP)
+
+static bool map_source(asset_bundle_t *bundle, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    void *ptr         = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    if (!asset_bundle_open_memory(bundle, ptr, size)) {
+        munmap(ptr, size);
+        return false;
+    }
+    bundle->mapping      = ptr;
+    bundle->mapping_size = size;
+    bundle->mapping_kind = MAPPING_MMAP;
+    return true;
+}
+
+#else
+
+static bool map_source(asset_bundle_t *bundle, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        size = ftell(f);
+    }
+    if (size <= 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return false;
+    }
+
+    void *buf = malloc((size_t)size);
+    bool ok   = buf != NULL && fread(buf, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    if (!ok || !asset_bundle_open_memory(bundle, buf, (size_t)size)) {
+        free(buf);
+        return false;
+    }
+    bundle->mapping      = buf;
+    bundle->mapping_kind = MAPPING_HEAP;
+    return true;
+}
+
+#endif
+
+bool asset_bundle_open(asset_bundle_t *bundle, const char *source)
+{
+    if (bundle == NULL || source == NULL) {
+        return false;
+    }
+    memset(bundle, 0, sizeof(*bundle));
+    return map_source(bundle, source);
+}
+
+void asset_bundle_close(asset_bundle_t *bundle)
+{
+    if (bundle == NULL) {
+        return;
+    }
+    switch (bundle->mapping_kind) {
+#if defined(ESP_PLATFORM)
+        case MAPPING_PARTITION:
+            esp_partition_munmap((esp_partition_mmap_handle_t)(uintptr_t)bundle->mapping);
+            break;
+#elif defined(ASSET_BUNDLE_HAS_MMAP)
+        case MAPPING_MMAP:
+            munmap(bundle->mapping, bundle->mapping_size);
+            break;
+#else
+        case MAPPING_HEAP:
+            free(bundle->mapping);
+            break;
+#endif
+        default:
+            break;
+    }
+    memset(bundle, 0, sizeof(*bundle));
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Packed asset bundle written by `tools/gen_assets.py`.
+ *
+ * Layout (all integers little-endian):
+ *   header   32 bytes, see ASSET_BUNDLE_HEADER_SIZE
+ *   index    entry_count x 32-byte entries, sorted by (id hash, id)
+ *   strings  NUL-terminated asset ids referenced by the index
+ *   blobs    pixel data, each blob aligned to ASSET_BUNDLE_BLOB_ALIGN
+ *
+ * The reader never copies: lookups return pointers into the mapped bundle, so blobs can be
+ * handed to LVGL as-is.
+ */
+
+#define ASSET_BUNDLE_MAGIC        "T5AB"
+#define ASSET_BUNDLE_VERSION      1U
+#define ASSET_BUNDLE_HEADER_SIZE  32U
+#define ASSET_BUNDLE_ENTRY_SIZE   32U
+#define ASSET_BUNDLE_BLOB_ALIGN   64U
+#define ASSET_BUNDLE_DEFAULT_PART "assets"
+
+typedef enum {
+    ASSET_FORMAT_RGB565 = 1,
+} asset_format_t;
+
+typedef enum {
+    ASSET_COMPRESSION_NONE  = 0,
+    ASSET_COMPRESSION_RLE16 = 1, /* see asset_codec.h */
+    ASSET_COMPRESSION_LZ4   = 2,
+} asset_compression_t;
+
+typedef struct {
+    uint32_t index; /* position in the bundle index, stable for the bundle's lifetime */
+    const char *id;
+    const uint8_t *data;
+    uint32_t data_size; /* bytes stored in the bundle */
+    uint32_t raw_size;  /* bytes once decoded; equals data_size when uncompressed */
+    uint16_t width;
+    uint16_t height;
+    uint16_t stride; /* bytes per decoded row */
+    uint8_t format;
+    uint8_t compression;
+} asset_bundle_entry_t;
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    uint32_t entry_count;
+    const uint8_t *index;
+    const char *strings;
+    size_t strings_size;
+    /* Backend bookkeeping for asset_bundle_close(). */
+    void *mapping;
+    size_t mapping_size;
+    uint32_t mapping_kind;
+} asset_bundle_t;
+
+/** 32-bit FNV-1a of @p id; the key the index is sorted by. */
+uint32_t asset_bundle_hash(const char *id);
+
+/** Validate a bundle that is already in memory; @p data must outlive the bundle. */
+bool asset_bundle_open_memory(asset_bundle_t *bundle, const void *data, size_t size);
+
+/**
+ * Map a bundle for zero-copy access.
+ *
+ * On device @p source is a data partition label (mapped with esp_partition_mmap); on the
+ * desktop it is a file path (mmap on POSIX, read into memory elsewhere).
+ */
+bool asset_bundle_open(asset_bundle_t *bundle, const char *source);
+
+void asset_bundle_close(asset_bundle_t *bundle);
+
+/** Binary-search the index for @p id. */
+bool asset_bundle_find(const asset_bundle_t *bundle, const char *id, asset_bundle_entry_t *out);
+
+bool asset_bundle_entry_at(const asset_bundle_t *bundle, uint32_t index, asset_bundle_entry_t *out);
+
+#ifdef __cplusplus
+}
+#endif
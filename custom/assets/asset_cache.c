@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "asset_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_bundle.h"
+
+typedef struct asset_cache_entry {
+    struct asset_cache_entry *prev; /* towards the most recently used */
+    struct asset_cache_entry *next; /* towards the least recently used */
+    uint32_t hash;
+    uint32_t refs;
+    bool pinned;
+    void *data;
+    size_t size;
+    char id[];
+} asset_cache_entry_t;
+
+struct asset_cache {
+    asset_cache_config_t config;
+    asset_cache_entry_t *head;
+    asset_cache_entry_t *tail;
+    asset_cache_stats_t stats;
+};
+
+static void list_unlink(asset_cache_t *cache, asset_cache_entry_t *entry)
+{
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+static void list_push_front(asset_cache_t *cache, asset_cache_entry_t *entry)
+{
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head != NULL) {
+        cache->head->prev = entry;
+    } else {
+        cache->tail = entry;
+    }
+    cache->head = entry;
+}
+
+static asset_cache_entry_t *find_entry(const asset_cache_t *cache, const char *id)
+{
+    if (cache == NULL || id == NULL) {
+        return NULL;
+    }
+    const uint32_t hash = asset_bundle_hash(id);
+    for (asset_cache_entry_t *e = cache->head; e != NULL; e = e->next) {
+        if (e->hash == hash && strcmp(e->id, id) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void drop_entry(asset_cache_t *cache, asset_cache_entry_t *entry)
+{
+    list_unlink(cache, entry);
+    cache->stats.bytes_used -= entry->size;
+    cache->stats.entries--;
+    if (cache->config.discard != NULL) {
+        cache->config.discard(cache->config.ctx, entry->data);
+    }
+    free(entry);
+}
+
+/* Evict unreferenced, unpinned images from the cold end until @p incoming more bytes fit. */
+static void evict_to_fit(asset_cache_t *cache, size_t incoming)
+{
+    asset_cache_entry_t *e = cache->tail;
+    while (e != NULL && cache->stats.bytes_used + incoming > cache->config.budget_bytes) {
+        asset_cache_entry_t *prev = e->prev;
+        if (e->refs == 0U && !e->pinned) {
+            drop_entry(cache, e);
+            cache->stats.evictions++;
+        }
+        e = prev;
+    }
+}
+
+static asset_cache_entry_t *lookup_or_decode(asset_cache_t *cache, const char *id)
+{
+    asset_cache_entry_t *entry = find_entry(cache, id);
+    if (entry != NULL) {
+        cache->stats.hits++;
+        list_unlink(cache, entry);
+        list_push_front(cache, entry);
+        return entry;
+    }
+
+    cache->stats.misses++;
+    if (cache->config.decode == NULL) {
+        cache->stats.decode_failures++;
+        return NULL;
+    }
+    size_t size = 0U;
+    void *data  = cache->config.decode(cache->config.ctx, id, &size);
+    if (data == NULL) {
+        cache->stats.decode_failures++;
+        return NULL;
+    }
+
+    const size_t id_len = strlen(id);
+    entry               = calloc(1, sizeof(*entry) + id_len + 1U);
+    if (entry == NULL) {
+        if (cache->config.discard != NULL) {
+            cache->config.discard(cache->config.ctx, data);
+        }
+        cache->stats.decode_failures++;
+        return NULL;
+    }
+    memcpy(entry->id, id, id_len + 1U);
+    entry->hash = asset_bundle_hash(id);
+    entry->data = data;
+    entry->size = size;
+
+    /* Images still on screen may push the cache over budget; release() trims it back. */
+    evict_to_fit(cache, size);
+    list_push_front(cache, entry);
+    cache->stats.entries++;
+    cache->stats.bytes_used += size;
+    if (cache->stats.bytes_used > cache->stats.bytes_peak) {
+        cache->stats.bytes_peak = cache->stats.bytes_used;
+    }
+    return entry;
+}
+
+asset_cache_t *asset_cache_create(const asset_cache_config_t *config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+    asset_cache_t *cache = calloc(1, sizeof(*cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->config             = *config;
+    cache->stats.budget_bytes = config->budget_bytes;
+    return cache;
+}
+
+void asset_cache_destroy(asset_cache_t *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+    while (cache->head != NULL) {
+        drop_entry(cache, cache->head);
+    }
+    free(cache);
+}
+
+const void *asset_cache_acquire(asset_cache_t *cache, const char *id)
+{
+    if (cache == NULL || id == NULL) {
+        return NULL;
+    }
+    asset_cache_entry_t *entry = lookup_or_decode(cache, id);
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->refs++;
+    return entry->data;
+}
+
+void asset_cache_release(asset_cache_t *cache, const char *id)
+{
+    asset_cache_entry_t *entry = find_entry(cache, id);
+    if (entry == NULL || entry->refs == 0U) {
+        return;
+    }
+    entry->refs--;
+    if (entry->refs == 0U) {
+        evict_to_fit(cache, 0U);
+    }
+}
+
+const void *asset_cache_pin(asset_cache_t *cache, const char *id)
+{
+    if (cache == NULL || id == NULL) {
+        return NULL;
+    }
+    asset_cache_entry_t *entry = lookup_or_decode(cache, id);
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (!entry->pinned) {
+        entry->pinned = true;
+        cache->stats.pinned++;
+    }
+    return entry->data;
+}
+
+void asset_cache_unpin(asset_cache_t *cache, const char *id)
+{
+    asset_cache_entry_t *entry = find_entry(cache, id);
+    if (entry == NULL || !entry->pinned) {
+        return;
+    }
+    entry->pinned = false;
+    cache->stats.pinned--;
+    evict_to_fit(cache, 0U);
+}
+
+bool asset_cache_contains(const asset_cache_t *cache, const char *id)
+{
+    return find_entry(cache, id) != NULL;
+}
+
+void asset_cache_set_budget(asset_cache_t *cache, size_t budget_bytes)
+{
+    if (cache == NULL) {
+        return;
+    }
+    cache->config.budget_bytes = budget_bytes;
+    cache->stats.budget_bytes  = budget_bytes;
+    evict_to_fit(cache, 0U);
+}
+
+void asset_cache_get_stats(const asset_cache_t *cache, asset_cache_stats_t *out)
+{
+    if (cache == NULL || out == NULL) {
+        return;
+    }
+    *out = cache->stats;
+}
+
+void asset_cache_reset_stats(asset_cache_t *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+    cache->stats.hits            = 0U;
+    cache->stats.misses          = 0U;
+    cache->stats.evictions       = 0U;
+    cache->stats.decode_failures = 0U;
+    cache->stats.bytes_peak      = cache->stats.bytes_used;
+}
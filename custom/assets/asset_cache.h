@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Decoded-image cache with a byte budget.
+ *
+ * Images are decoded on the first acquire and stay resident until the least recently used
+ * ones have to make room for a new decode. Acquired images are never evicted while a
+ * reference is held, and pinned images (wallpaper, nav rail icons) are never evicted at all.
+ * The cache is not thread-safe; use it from the LVGL task.
+ */
+
+typedef struct {
+    size_t budget_bytes;
+    /* Produce the decoded image for @p id and its size in bytes; NULL on failure. */
+    void *(*decode)(void *ctx, const char *id, size_t *out_size);
+    /* Free a buffer returned by decode(). */
+    void (*discard)(void *ctx, void *data);
+    void *ctx;
+} asset_cache_config_t;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t decode_failures;
+    uint32_t entries;
+    uint32_t pinned;
+    size_t bytes_used;
+    size_t bytes_peak;
+    size_t budget_bytes;
+} asset_cache_stats_t;
+
+typedef struct asset_cache asset_cache_t;
+
+asset_cache_t *asset_cache_create(const asset_cache_config_t *config);
+void asset_cache_destroy(asset_cache_t *cache);
+
+/** Return the decoded image for @p id, decoding on a miss; pair with asset_cache_release(). */
+const void *asset_cache_acquire(asset_cache_t *cache, const char *id);
+void asset_cache_release(asset_cache_t *cache, const char *id);
+
+/** Decode if needed and keep @p id resident until asset_cache_unpin(). */
+const void *asset_cache_pin(asset_cache_t *cache, const char *id);
+void asset_cache_unpin(asset_cache_t *cache, const char *id);
+
+/** True if @p id is resident; does not touch the counters or the LRU order. */
+bool asset_cache_contains(const asset_cache_t *cache, const char *id);
+
+/** Change the budget, evicting unreferenced images that no longer fit. */
+void asset_cache_set_budget(asset_cache_t *cache, size_t budget_bytes);
+
+void asset_cache_get_stats(const asset_cache_t *cache, asset_cache_stats_t *out);
+void asset_cache_reset_stats(asset_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "asset_codec.h"
+
+#include <string.h>
+
+static uint16_t le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* LZ4 length fields continue with 255-valued bytes. */
+static bool lz4_read_length(const uint8_t **ip, const uint8_t *iend, size_t *length)
+{
+    uint8_t b;
+    do {
+        if (*ip >= iend) {
+            return false;
+        }
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 255U);
+    return true;
+}
+
+size_t asset_lz4_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap)
+{
+    const uint8_t *ip   = src;
+    const uint8_t *iend = src + src_len;
+    uint8_t *op         = dst;
+    uint8_t *oend       = dst + dst_cap;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15U && !lz4_read_length(&ip, iend, &literals)) {
+            return SIZE_MAX;
+        }
+        if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op)) {
+            return SIZE_MAX;
+        }
+        memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == iend) {
+            break; /* the last sequence has no match */
+        }
+
+        if (iend - ip < 2) {
+            return SIZE_MAX;
+        }
+        const size_t offset = le16(ip);
+        ip += 2;
+        if (offset == 0U || offset > (size_t)(op - dst)) {
+            return SIZE_MAX;
+        }
+
+        size_t match = token & 0x0FU;
+        if (match == 15U && !lz4_read_length(&ip, iend, &match)) {
+            return SIZE_MAX;
+        }
+        match += 4U;
+        if (match > (size_t)(oend - op)) {
+            return SIZE_MAX;
+        }
+        const uint8_t *ref = op - offset;
+        if (offset >= match) {
+            memcpy(op, ref, match);
+            op += match;
+        } else {
+            while (match-- > 0U) { /* overlapping copy repeats the pattern */
+                *op++ = *ref++;
+            }
+        }
+    }
+    return (size_t)(op - dst);
+}
+
+size_t asset_rle16_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap)
+{
+    const uint8_t *ip   = src;
+    const uint8_t *iend = src + src_len;
+    uint8_t *op         = dst;
+    uint8_t *oend       = dst + dst_cap;
+
+    while (ip < iend) {
+        const uint8_t header = *ip++;
+        const size_t count   = (size_t)(header & 0x7FU) + 1U;
+        if (count * 2U > (size_t)(oend - op)) {
+            return SIZE_MAX;
+        }
+        if ((header & 0x80U) != 0U) {
+            if (iend - ip < 2) {
+                return SIZE_MAX;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                op[0] = ip[0];
+                op[1] = ip[1];
+                op += 2;
+            }
+            ip += 2;
+        } else {
+            if ((size_t)(iend - ip) < count * 2U) {
+                return SIZE_MAX;
+            }
+            memcpy(op, ip, count * 2U);
+            ip += count * 2U;
+            op += count * 2U;
+        }
+    }
+    return (size_t)(op - dst);
+}
+
+bool asset_stream_open(asset_stream_t *stream, const asset_bundle_entry_t *entry)
+{
+    if (stream == NULL || entry == NULL) {
+        return false;
+    }
+    memset(stream, 0, sizeof(*stream));
+    stream->entry = *entry;
+    if ((uint64_t)entry->stride * entry->height != entry->raw_size) {
+        return false;
+    }
+
+    if (entry->compression == ASSET_COMPRESSION_NONE) {
+        if (entry->data_size != entry->raw_size) {
+            return false;
+        }
+        stream->band_rows    = entry->height;
+        stream->band_count   = entry->height > 0U ? 1U : 0U;
+        stream->payload      = entry->data;
+        stream->payload_size = entry->data_size;
+        return true;
+    }
+    if (entry->compression != ASSET_COMPRESSION_RLE16
+        && entry->compression != ASSET_COMPRESSION_LZ4) {
+        return false;
+    }
+
+    if (entry->data_size < ASSET_BAND_TABLE_HEADER) {
+        return false;
+    }
+    const uint16_t band_rows  = le16(entry->data);
+    const uint16_t band_count = le16(entry->data + 2);
+    const size_t table        = ASSET_BAND_TABLE_HEADER + ((size_t)band_count + 1U) * 4U;
+    if (band_rows == 0U || table > entry->data_size
+        || (uint32_t)band_count * band_rows < entry->height
+        || (uint32_t)(band_count - 1U) * band_rows >= entry->height) {
+        return false;
+    }
+
+    stream->band_rows    = band_rows;
+    stream->band_count   = band_count;
+    stream->offsets      = entry->data + ASSET_BAND_TABLE_HEADER;
+    stream->payload      = entry->data + table;
+    stream->payload_size = entry->data_size - table;
+    return true;
+}
+
+uint32_t asset_stream_row(const asset_stream_t *stream)
+{
+    return stream != NULL ? (uint32_t)stream->next_band * stream->band_rows : 0U;
+}
+
+uint32_t asset_stream_next(asset_stream_t *stream, uint8_t *dst_rows)
+{
+    if (stream == NULL || dst_rows == NULL || stream->error
+        || stream->next_band >= stream->band_count) {
+        return 0U;
+    }
+
+    const asset_bundle_entry_t *entry = &stream->entry;
+    const uint32_t first_row          = asset_stream_row(stream);
+    uint32_t rows                     = entry->height - first_row;
+    if (rows > stream->band_rows) {
+        rows = stream->band_rows;
+    }
+    const size_t expected = (size_t)rows * entry->stride;
+
+    size_t written = SIZE_MAX;
+    if (entry->compression == ASSET_COMPRESSION_NONE) {
+        memcpy(dst_rows, stream->payload, expected);
+        written = expected;
+    } else {
+        const uint32_t begin = le32(stream->offsets + (size_t)stream->next_band * 4U);
+        const uint32_t end   = le32(stream->offsets + ((size_t)stream->next_band + 1U) * 4U);
+        if (begin <= end && end <= stream->payload_size) {
+            const uint8_t *band = stream->payload + begin;
+            written             = entry->compression == ASSET_COMPRESSION_LZ4
+                                      ? asset_lz4_decode(band, end - begin, dst_rows, expected)
+                                      : asset_rle16_decode(band, end - begin, dst_rows, expected);
+        }
+    }
+
+    if (written != expected) {
+        stream->error = true;
+        return 0U;
+    }
+    stream->next_band++;
+    return rows;
+}
+
+bool asset_bundle_decode(const asset_bundle_entry_t *entry, uint8_t *dst)
+{
+    asset_stream_t stream;
+    if (dst == NULL || !asset_stream_open(&stream, entry)) {
+        return false;
+    }
+    uint32_t rows;
+    while ((rows = asset_stream_next(&stream, dst)) > 0U) {
+        dst += (size_t)rows * entry->stride;
+    }
+    return !stream.error && stream.next_band == stream.band_count;
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "asset_bundle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compressed bundle entries are split into bands of whole rows that compress independently,
+ * so a band can be decoded straight into its rows of the destination buffer without a
+ * scratch copy of the image:
+ *
+ *   u16 band_rows, u16 band_count
+ *   u32 offsets[band_count + 1]   band i is payload[offsets[i] .. offsets[i + 1])
+ *   payload
+ *
+ * RLE16 packets: a header byte h, then either one pixel repeated (h & 0x7F) + 1 times
+ * (h & 0x80 set) or h + 1 literal pixels; pixels are little-endian RGB565.
+ * LZ4 bands are plain LZ4 blocks (no frame header).
+ */
+
+#define ASSET_BAND_TABLE_HEADER 4U
+
+typedef struct {
+    asset_bundle_entry_t entry;
+    uint16_t band_rows;
+    uint16_t band_count;
+    uint16_t next_band;
+    const uint8_t *offsets;
+    const uint8_t *payload;
+    size_t payload_size;
+    bool error;
+} asset_stream_t;
+
+/** Prepare to decode @p entry band by band; uncompressed entries are one band. */
+bool asset_stream_open(asset_stream_t *stream, const asset_bundle_entry_t *entry);
+
+/**
+ * Decode the next band into @p dst_rows, the first row of that band in a buffer with the
+ * entry's stride. Returns the number of rows written; 0 once every band is done or on a
+ * corrupt band (stream->error is set then).
+ */
+uint32_t asset_stream_next(asset_stream_t *stream, uint8_t *dst_rows);
+
+/** First image row of the band asset_stream_next() will decode. */
+uint32_t asset_stream_row(const asset_stream_t *stream);
+
+/** Decode a whole entry into @p dst (entry->raw_size bytes). */
+bool asset_bundle_decode(const asset_bundle_entry_t *entry, uint8_t *dst);
+
+/** Decode one LZ4 block; returns bytes written or SIZE_MAX on corrupt input. */
+size_t asset_lz4_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap);
+
+/** Decode one RLE16 band; returns bytes written or SIZE_MAX on corrupt input. */
+size_t asset_rle16_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,12 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_bundle.h"
+#include "asset_cache.h"
+#include "asset_codec.h"
 
 #if defined(ESP_PLATFORM)
 #if defined(__has_include)
@@ -192,6 +198,253 @@ static const char *k_tag = "assets";
 
 static bool s_fs_initialized = false;
 
+#if defined(ESP_PLATFORM)
+#define ASSET_BUNDLE_DEFAULT_SOURCE ASSET_BUNDLE_DEFAULT_PART
+#else
+#define ASSET_BUNDLE_DEFAULT_SOURCE "out/assets/assets.bundle"
+#endif
+
+/* Decoded images kept in RAM: the wallpaper plus a few pages of icons fits comfortably in
+ * the Tab5's PSRAM. */
+#ifndef ASSETS_IMAGE_CACHE_BUDGET
+#define ASSETS_IMAGE_CACHE_BUDGET (8U * 1024U * 1024U)
+#endif
+
+static asset_bundle_t s_bundle;
+/* One descriptor per index entry, filled on first lookup. */
+static lv_image_dsc_t *s_bundle_images = NULL;
+/* Per index entry: acquires answered in place, which hold no image cache ref. */
+static uint32_t *s_in_place_refs    = NULL;
+static asset_cache_t *s_image_cache = NULL;
+
+static const char *bundle_default_source(void)
+{
+#if !defined(ESP_PLATFORM)
+    const char *env = getenv("TAB5_ASSET_BUNDLE");
+    if (env != NULL && env[0] != '\0') {
+        return env;
+    }
+#endif
+    return ASSET_BUNDLE_DEFAULT_SOURCE;
+}
+
+#define ASSET_ALIGN_UP(x, align) (((x) + ((align) - 1U)) & ~((uintptr_t)(align) - 1U))
+
+static bool entry_drawable_in_place(const asset_bundle_entry_t *entry)
+{
+    return entry->format == ASSET_FORMAT_RGB565 && entry->compression == ASSET_COMPRESSION_NONE;
+}
+
+/* Cache decoder: one lv_malloc block holding the descriptor followed by the pixels. */
+static void *bundle_decode(void *ctx, const char *id, size_t *out_size)
+{
+    LV_UNUSED(ctx);
+    asset_bundle_entry_t entry;
+    if (!asset_bundle_find(&s_bundle, id, &entry) || entry.format != ASSET_FORMAT_RGB565) {
+        return NULL;
+    }
+
+    const size_t header = ASSET_ALIGN_UP(sizeof(lv_image_dsc_t), LV_DRAW_BUF_ALIGN);
+    uint8_t *block      = lv_malloc(header + entry.raw_size + LV_DRAW_BUF_ALIGN);
+    if (block == NULL) {
+        return NULL;
+    }
+    uint8_t *pixels = (uint8_t *)ASSET_ALIGN_UP((uintptr_t)(block + header), LV_DRAW_BUF_ALIGN);
+
+    /* Compressed entries inflate band by band straight into the image buffer; uncompressed
+     * ones become a resident copy, e.g. a pinned wallpaper redrawn every frame. */
+    if (!asset_bundle_decode(&entry, pixels)) {
+        lv_free(block);
+        return NULL;
+    }
+
+    lv_image_dsc_t *dsc = (lv_image_dsc_t *)block;
+    lv_memzero(dsc, sizeof(*dsc));
+    dsc->header.magic  = LV_IMAGE_HEADER_MAGIC;
+    dsc->header.cf     = LV_COLOR_FORMAT_RGB565;
+    dsc->header.w      = entry.width;
+    dsc->header.h      = entry.height;
+    dsc->header.stride = entry.stride;
+    dsc->data_size     = entry.raw_size;
+    dsc->data          = pixels;
+    *out_size          = header + entry.raw_size;
+    return block;
+}
+
+static void bundle_discard(void *ctx, void *data)
+{
+    LV_UNUSED(ctx);
+    lv_free(data);
+}
+
+static asset_cache_t *image_cache_create(void)
+{
+    asset_cache_config_t config = {
+        .budget_bytes = ASSETS_IMAGE_CACHE_BUDGET,
+        .decode       = bundle_decode,
+        .discard      = bundle_discard,
+        .ctx          = NULL,
+    };
+    return asset_cache_create(&config);
+}
+
+bool assets_bundle_mount(const char *source)
+{
+    if (source == NULL) {
+        source = bundle_default_source();
+    }
+
+    asset_bundle_t bundle;
+    if (!asset_bundle_open(&bundle, source)) {
+        ASSET_LOGW(k_tag, "No asset bundle at %s", source);
+        return false;
+    }
+    lv_image_dsc_t *images = NULL;
+    uint32_t *in_place_refs = NULL;
+    if (bundle.entry_count > 0U) {
+        images        = lv_malloc_zeroed(sizeof(lv_image_dsc_t) * bundle.entry_count);
+        in_place_refs = lv_malloc_zeroed(sizeof(uint32_t) * bundle.entry_count);
+        if (images == NULL || in_place_refs == NULL) {
+            lv_free(images);
+            lv_free(in_place_refs);
+            asset_bundle_close(&bundle);
+            return false;
+        }
+    }
+
+    /* Descriptors handed out earlier point into the old mapping or the old cache; callers
+     * remount between screens, never while images are on display. */
+    asset_bundle_close(&s_bundle);
+    lv_free(s_bundle_images);
+    lv_free(s_in_place_refs);
+    asset_cache_destroy(s_image_cache);
+    s_bundle        = bundle;
+    s_bundle_images = images;
+    s_in_place_refs = in_place_refs;
+    s_image_cache   = image_cache_create();
+    ASSET_LOGI(k_tag, "Mapped asset bundle %s (%u entries)", source, (unsigned)bundle.entry_count);
+    return true;
+}
+
+const void *assets_image(const char *id)
+{
+    asset_bundle_entry_t entry;
+    if (!asset_bundle_find(&s_bundle, id, &entry)) {
+        return NULL;
+    }
+    if (!entry_drawable_in_place(&entry)) {
+        return NULL;
+    }
+
+    lv_image_dsc_t *dsc = &s_bundle_images[entry.index];
+    if (dsc->data == NULL) {
+        dsc->header.magic  = LV_IMAGE_HEADER_MAGIC;
+        dsc->header.cf     = LV_COLOR_FORMAT_RGB565;
+        dsc->header.w      = entry.width;
+        dsc->header.h      = entry.height;
+        dsc->header.stride = entry.stride;
+        dsc->data_size     = entry.data_size;
+        dsc->data          = entry.data;
+    }
+    return dsc;
+}
+
+const void *assets_image_acquire(const char *id)
+{
+    asset_bundle_entry_t entry;
+    if (!asset_bundle_find(&s_bundle, id, &entry)) {
+        return NULL;
+    }
+    /* Flash-mapped blobs are drawn in place unless a pin made them resident. */
+    if (entry_drawable_in_place(&entry) && !asset_cache_contains(s_image_cache, id)) {
+        s_in_place_refs[entry.index]++;
+        return assets_image(id);
+    }
+    return asset_cache_acquire(s_image_cache, id);
+}
+
+void assets_image_release(const char *id)
+{
+    asset_bundle_entry_t entry;
+    if (!asset_bundle_find(&s_bundle, id, &entry)) {
+        return;
+    }
+    /* Settle in-place acquires first: the id may have become resident since, and the cache
+     * refs then belong to whoever acquired it through the cache. */
+    if (s_in_place_refs[entry.index] > 0U) {
+        s_in_place_refs[entry.index]--;
+        return;
+    }
+    asset_cache_release(s_image_cache, id);
+}
+
+const void *assets_image_pin(const char *id)
+{
+    return asset_cache_pin(s_image_cache, id);
+}
+
+void assets_image_unpin(const char *id)
+{
+    asset_cache_unpin(s_image_cache, id);
+}
+
+bool assets_image_cache_stats(asset_cache_stats_t *out)
+{
+    if (s_image_cache == NULL || out == NULL) {
+        return false;
+    }
+    asset_cache_get_stats(s_image_cache, out);
+    return true;
+}
+
+bool assets_image_ready(const char *id)
+{
+    asset_bundle_entry_t entry;
+    if (!asset_bundle_find(&s_bundle, id, &entry)) {
+        return false;
+    }
+    return entry_drawable_in_place(&entry) || asset_cache_contains(s_image_cache, id);
+}
+
+bool assets_image_prefetch(const char *id)
+{
+    asset_bundle_entry_t entry;
+    if (s_image_cache == NULL || !asset_bundle_find(&s_bundle, id, &entry)) {
+        return false;
+    }
+    if (entry_drawable_in_place(&entry) || asset_cache_contains(s_image_cache, id)) {
+        return true;
+    }
+
+    /* Only spend free budget: evicting to make room could throw out what the user is looking
+     * at now for a page they may never open. */
+    asset_cache_stats_t stats;
+    asset_cache_get_stats(s_image_cache, &stats);
+    const size_t need = ASSET_ALIGN_UP(sizeof(lv_image_dsc_t), LV_DRAW_BUF_ALIGN) + entry.raw_size;
+    if (stats.bytes_used + need > stats.budget_bytes) {
+        return false;
+    }
+    if (asset_cache_acquire(s_image_cache, id) == NULL) {
+        return false;
+    }
+    asset_cache_release(s_image_cache, id);
+    return true;
+}
+
+size_t assets_image_ids(const char *prefix, const char **out, size_t max)
+{
+    const size_t prefix_len = prefix != NULL ? strlen(prefix) : 0U;
+    size_t count            = 0U;
+    for (uint32_t i = 0; i < s_bundle.entry_count && count < max; ++i) {
+        asset_bundle_entry_t entry;
+        if (asset_bundle_entry_at(&s_bundle, i, &entry)
+            && strncmp(entry.id, prefix != NULL ? prefix : "", prefix_len) == 0) {
+            out[count++] = entry.id;
+        }
+    }
+    return count;
+}
+
 void assets_fs_init(void)
 {
     if (s_fs_initialized) {
@@ -210,4 +463,6 @@ void assets_fs_init(void)
 #else
     ASSET_LOGI(k_tag, "Desktop build: using host filesystem without SD mount");
 #endif
+
+    assets_bundle_mount(NULL);
 }
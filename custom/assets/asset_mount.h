@@ -5,12 +5,63 @@
  */
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "asset_cache.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void assets_fs_init(void);
 
+/**
+ * Map the packed asset bundle (see asset_bundle.h). @p source is a partition label on device
+ * and a file path on the desktop; NULL picks the platform default. assets_fs_init() already
+ * tries the default, so callers only need this to switch bundles.
+ */
+bool assets_bundle_mount(const char *source);
+
+/**
+ * Image source for @p id from the mounted bundle, suitable for lv_image_set_src(). The
+ * descriptor points straight into the mapped bundle; NULL if the id is unknown.
+ */
+const void *assets_image(const char *id);
+
+/**
+ * Image source for @p id that stays valid until assets_image_release(). Entries LVGL can draw
+ * in place come straight from the mapping; anything that needs decoding goes through the
+ * image cache, so showing a page again does not decode it again. Each acquire of a found id
+ * takes one ref that exactly one release of the same id gives back, whichever way it was served.
+ */
+const void *assets_image_acquire(const char *id);
+void assets_image_release(const char *id);
+
+/**
+ * Keep @p id decoded in RAM until assets_image_unpin(); meant for always-visible images such
+ * as the wallpaper and nav rail icons. Pinned images are never evicted.
+ */
+const void *assets_image_pin(const char *id);
+void assets_image_unpin(const char *id);
+
+bool assets_image_cache_stats(asset_cache_stats_t *out);
+
+/** True if @p id can be drawn now without a decode: flash-drawable or already cached. */
+bool assets_image_ready(const char *id);
+
+/**
+ * Decode @p id into the image cache ahead of use without holding a reference. Prefetching
+ * only uses free budget and never evicts; returns false if the image does not fit.
+ */
+bool assets_image_prefetch(const char *id);
+
+/**
+ * Collect up to @p max ids that start with @p prefix, in index order, into @p out. The ids
+ * live as long as the mounted bundle. Returns the number written.
+ */
+size_t assets_image_ids(const char *prefix, const char **out, size_t max);
+
 #ifdef __cplusplus
 }
 #endif
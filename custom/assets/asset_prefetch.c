@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "asset_prefetch.h"
+
+#include <string.h>
+
+static bool prefetch_ready(const asset_prefetch_t *prefetch, const char *id)
+{
+    return prefetch->ops.is_ready != NULL && prefetch->ops.is_ready(prefetch->ops.ctx, id);
+}
+
+void asset_prefetch_init(asset_prefetch_t *prefetch, const asset_prefetch_ops_t *ops)
+{
+    if (prefetch == NULL) {
+        return;
+    }
+    memset(prefetch, 0, sizeof(*prefetch));
+    if (ops != NULL) {
+        prefetch->ops = *ops;
+    }
+}
+
+bool asset_prefetch_enqueue(asset_prefetch_t *prefetch, const char *id)
+{
+    if (prefetch == NULL || id == NULL) {
+        return false;
+    }
+    for (uint32_t i = prefetch->head; i < prefetch->count; ++i) {
+        if (strcmp(prefetch->queue[i], id) == 0) {
+            return true;
+        }
+    }
+    if (prefetch->head == prefetch->count) {
+        prefetch->head  = 0U;
+        prefetch->count = 0U;
+    }
+    if (prefetch->count >= ASSET_PREFETCH_QUEUE_MAX) {
+        return false;
+    }
+    prefetch->queue[prefetch->count++] = id;
+    prefetch->stats.queued++;
+    return true;
+}
+
+bool asset_prefetch_pending(const asset_prefetch_t *prefetch)
+{
+    return prefetch != NULL && prefetch->head < prefetch->count;
+}
+
+bool asset_prefetch_step(asset_prefetch_t *prefetch)
+{
+    if (prefetch == NULL) {
+        return false;
+    }
+    /* Ready ids are cheap to skip, so keep going until one decode has been paid for. */
+    while (prefetch->head < prefetch->count) {
+        const char *id = prefetch->queue[prefetch->head++];
+        if (prefetch_ready(prefetch, id)) {
+            prefetch->stats.skipped++;
+            continue;
+        }
+        if (prefetch->ops.warm != NULL && prefetch->ops.warm(prefetch->ops.ctx, id)) {
+            prefetch->stats.warmed++;
+        } else {
+            prefetch->stats.declined++;
+        }
+        break;
+    }
+    return asset_prefetch_pending(prefetch);
+}
+
+void asset_prefetch_cancel(asset_prefetch_t *prefetch)
+{
+    if (prefetch == NULL) {
+        return;
+    }
+    prefetch->stats.cancelled += prefetch->count - prefetch->head;
+    prefetch->head  = 0U;
+    prefetch->count = 0U;
+}
+
+void asset_prefetch_commit(asset_prefetch_t *prefetch, const char *const *ids, size_t count)
+{
+    if (prefetch == NULL) {
+        return;
+    }
+    asset_prefetch_cancel(prefetch);
+
+    uint32_t misses = 0U;
+    for (size_t i = 0; ids != NULL && i < count; ++i) {
+        if (prefetch_ready(prefetch, ids[i])) {
+            prefetch->stats.commit_hits++;
+        } else {
+            misses++;
+        }
+    }
+    prefetch->stats.commit_misses += misses;
+    prefetch->stats.commits++;
+    if (misses == 0U) {
+        prefetch->stats.decode_free_commits++;
+    }
+}
+
+uint32_t asset_prefetch_hit_rate(const asset_prefetch_stats_t *stats)
+{
+    if (stats == NULL) {
+        return 0U;
+    }
+    const uint64_t total = (uint64_t)stats->commit_hits + stats->commit_misses;
+    return total == 0U ? 100U : (uint32_t)(stats->commit_hits * 100ULL / total);
+}
+
+void asset_prefetch_reset_stats(asset_prefetch_t *prefetch)
+{
+    if (prefetch != NULL) {
+        memset(&prefetch->stats, 0, sizeof(prefetch->stats));
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Navigation-driven image prefetcher.
+ *
+ * While the nav rail is open the UI queues the assets of the pages the user is likely to
+ * open next, then calls asset_prefetch_step() from idle frames; each step decodes at most
+ * one image. Committing to a page drops whatever is still queued and records how many of
+ * that page's assets were already drawable, so the hit rate shows whether page transitions
+ * are decode-free. Not thread-safe; use it from the LVGL task.
+ */
+
+#define ASSET_PREFETCH_QUEUE_MAX 32U
+
+typedef struct {
+    /* True if @p id can be drawn right now without a decode. */
+    bool (*is_ready)(void *ctx, const char *id);
+    /* Decode @p id into the image cache without keeping a reference; false if declined. */
+    bool (*warm)(void *ctx, const char *id);
+    void *ctx;
+} asset_prefetch_ops_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t warmed;
+    uint32_t skipped;   /* already ready when their turn came */
+    uint32_t declined;  /* warm() refused, e.g. no free cache budget */
+    uint32_t cancelled; /* still queued when the user committed or closed the rail */
+    uint32_t commits;
+    uint32_t commit_hits; /* assets of the committed page that were ready */
+    uint32_t commit_misses;
+    uint32_t decode_free_commits;
+} asset_prefetch_stats_t;
+
+typedef struct {
+    asset_prefetch_ops_t ops;
+    /* Pending ids are queue[head .. count); ids must outlive the queue (bundle strings do). */
+    const char *queue[ASSET_PREFETCH_QUEUE_MAX];
+    uint32_t head;
+    uint32_t count;
+    asset_prefetch_stats_t stats;
+} asset_prefetch_t;
+
+void asset_prefetch_init(asset_prefetch_t *prefetch, const asset_prefetch_ops_t *ops);
+
+/** Queue @p id behind everything already queued; duplicates are ignored. False when full. */
+bool asset_prefetch_enqueue(asset_prefetch_t *prefetch, const char *id);
+
+bool asset_prefetch_pending(const asset_prefetch_t *prefetch);
+
+/** Warm the next queued id that is not ready yet; returns true while work remains. */
+bool asset_prefetch_step(asset_prefetch_t *prefetch);
+
+/** Drop everything still queued. */
+void asset_prefetch_cancel(asset_prefetch_t *prefetch);
+
+/** The user opened a page showing @p ids: cancel the queue and score the prefetch. */
+void asset_prefetch_commit(asset_prefetch_t *prefetch, const char *const *ids, size_t count);
+
+/** Percentage of committed-page assets that were ready at commit; 100 with no assets. */
+uint32_t asset_prefetch_hit_rate(const asset_prefetch_stats_t *stats);
+
+void asset_prefetch_reset_stats(asset_prefetch_t *prefetch);
+
+#ifdef __cplusplus
+}
+#endif
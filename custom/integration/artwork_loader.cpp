@@ -0,0 +1,396 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/artwork_loader.h"
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "../app_trace.h"
+#include "assets/asset_bundle.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kTag = "artwork";
+
+        // SD slot file: magic, width, height and key length (u16 each, native order), the key,
+        // then width x height RGB565 pixels
+        constexpr char        kSdMagic[4]   = {'A', 'R', 'T', '1'};
+        constexpr std::size_t kSdHeaderSize = sizeof(kSdMagic) + 3U * sizeof(std::uint16_t);
+        constexpr std::size_t kMaxKeyBytes  = 0xFFFFU;
+
+        std::uint32_t KeyHash(const std::string& key)
+        {
+            return asset_bundle_hash(key.c_str());
+        }
+
+        std::uint32_t ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            return static_cast<std::uint32_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+        }
+
+    }  // namespace
+
+    ArtworkLoader::ArtworkLoader(Config config) :
+        config_(std::move(config)),
+        open_(config_.open ? config_.open
+                           : [](const std::string& url) { return platform::OpenAudioSource(url); })
+    {
+        asset_cache_config_t cache_config = {};
+        cache_config.budget_bytes         = config_.ram_budget_bytes;
+        cache_config.decode               = DecodeCb;
+        cache_config.discard              = DiscardCb;
+        cache_config.ctx                  = this;
+        cache_                            = asset_cache_create(&cache_config);
+    }
+
+    ArtworkLoader::~ArtworkLoader()
+    {
+        Stop();
+        ReleaseShown();
+        asset_cache_destroy(cache_);
+    }
+
+    std::string ArtworkLoader::CacheKey(const std::string& url)
+    {
+        const std::size_t query = url.find('?');
+        if (query == std::string::npos)
+        {
+            return url;
+        }
+        std::string key       = url.substr(0, query);
+        char        separator = '?';
+        std::size_t start     = query + 1U;
+        while (start <= url.size())
+        {
+            std::size_t end = url.find('&', start);
+            if (end == std::string::npos)
+            {
+                end = url.size();
+            }
+            if (end > start && url.compare(start, 6U, "token=") != 0)
+            {
+                key += separator;
+                key.append(url, start, end - start);
+                separator = '&';
+            }
+            start = end + 1U;
+        }
+        return key;
+    }
+
+    void ArtworkLoader::Show(const std::string& url)
+    {
+        std::string key = CacheKey(url);
+        if (key == wanted_key_)
+        {
+            // Same cover; a fresh token only matters to a fetch still waiting to start
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (has_request_ && request_key_ == key)
+            {
+                request_url_ = url;
+            }
+            return;
+        }
+
+        wanted_key_ = key;
+        ReleaseShown();
+        changed_ = true;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        has_request_ = false;
+        if (key.empty())
+        {
+            return;
+        }
+        if (cache_ != nullptr && asset_cache_contains(cache_, key.c_str()))
+        {
+            shown_     = static_cast<const ArtworkImage*>(asset_cache_acquire(cache_, key.c_str()));
+            shown_key_ = shown_ != nullptr ? key : std::string();
+            ram_hits_++;
+            return;
+        }
+        request_url_ = url;
+        request_key_ = std::move(key);
+        has_request_ = true;
+        wake_.notify_one();
+    }
+
+    bool ArtworkLoader::TakeReady(const ArtworkImage*& image)
+    {
+        std::string                   key;
+        std::unique_ptr<ArtworkImage> finished;
+        bool                          took = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (has_done_)
+            {
+                key       = std::move(done_key_);
+                finished  = std::move(done_image_);
+                has_done_ = false;
+                took      = true;
+            }
+        }
+
+        // A cover for a track already skipped past is dropped rather than cached
+        if (took && finished != nullptr && key == wanted_key_ && shown_ == nullptr
+            && cache_ != nullptr)
+        {
+            adopt_     = finished.release();
+            shown_     = static_cast<const ArtworkImage*>(asset_cache_acquire(cache_, key.c_str()));
+            shown_key_ = shown_ != nullptr ? key : std::string();
+            delete adopt_;  // not taken if the key was resident after all
+            adopt_   = nullptr;
+            changed_ = true;
+        }
+
+        if (!changed_)
+        {
+            return false;
+        }
+        changed_ = false;
+        image    = shown_;
+        return true;
+    }
+
+    bool ArtworkLoader::RunOnce(std::uint32_t wait_ms)
+    {
+        std::string url;
+        std::string key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(wait_ms), [this]() {
+                return stopping_ || has_request_;
+            });
+            if (stopping_)
+            {
+                return false;
+            }
+            if (!has_request_)
+            {
+                return true;
+            }
+            url          = std::move(request_url_);
+            key          = std::move(request_key_);
+            has_request_ = false;
+        }
+
+        auto image = std::make_unique<ArtworkImage>();
+        if (ReadSd(key, *image))
+        {
+            sd_hits_++;
+        }
+        else if (Fetch(url, *image))
+        {
+            WriteSd(key, *image);
+        }
+        else
+        {
+            failures_++;
+            image.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_key_   = std::move(key);
+        done_image_ = std::move(image);
+        has_done_   = true;
+        return true;
+    }
+
+    void ArtworkLoader::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+    }
+
+    ArtworkLoader::Stats ArtworkLoader::GetStats() const
+    {
+        Stats stats;
+        stats.ram_hits = ram_hits_.load();
+        stats.sd_hits  = sd_hits_.load();
+        stats.fetches  = fetches_.load();
+        stats.failures = failures_.load();
+        return stats;
+    }
+
+    void* ArtworkLoader::DecodeCb(void* ctx, const char* id, std::size_t* out_size)
+    {
+        (void)id;
+        auto*         self  = static_cast<ArtworkLoader*>(ctx);
+        ArtworkImage* image = self->adopt_;
+        if (image == nullptr)
+        {
+            return nullptr;  // only TakeReady() brings covers in
+        }
+        self->adopt_ = nullptr;
+        *out_size    = sizeof(*image) + image->pixels.size() * sizeof(std::uint16_t);
+        return image;
+    }
+
+    void ArtworkLoader::DiscardCb(void* ctx, void* data)
+    {
+        (void)ctx;
+        delete static_cast<ArtworkImage*>(data);
+    }
+
+    void ArtworkLoader::ReleaseShown()
+    {
+        if (cache_ != nullptr && !shown_key_.empty())
+        {
+            asset_cache_release(cache_, shown_key_.c_str());
+        }
+        shown_key_.clear();
+        shown_ = nullptr;
+    }
+
+    bool ArtworkLoader::Fetch(const std::string& url, ArtworkImage& image)
+    {
+        fetches_++;
+        // Logged by hash: the URL may carry an access token
+        const std::uint32_t hash  = KeyHash(CacheKey(url));
+        const auto          start = std::chrono::steady_clock::now();
+
+        std::unique_ptr<platform::AudioSource> source = open_(url);
+        if (source == nullptr)
+        {
+            APP_LOG_WARN(kTag, "%08x: could not be opened", static_cast<unsigned>(hash));
+            return false;
+        }
+
+        platform::ImageScaleOptions options;
+        options.width      = config_.width;
+        options.height     = config_.height;
+        options.background = config_.background;
+        platform::ImageDecodeInfo         info;
+        const platform::ImageDecodeResult result = platform::DecodeImageScaled(
+            [&source](std::uint8_t* dst, std::size_t len) { return source->Read(dst, len); },
+            options,
+            image,
+            &info);
+        if (result != platform::ImageDecodeResult::kOk)
+        {
+            APP_LOG_WARN(kTag,
+                         "%08x: %s (%ux%u)",
+                         static_cast<unsigned>(hash),
+                         platform::ImageDecodeResultName(result),
+                         static_cast<unsigned>(info.source_width),
+                         static_cast<unsigned>(info.source_height));
+            return false;
+        }
+        APP_TRACEI(kTag,
+                   "%08x: %ux%u to %ux%u in %u ms",
+                   static_cast<unsigned>(hash),
+                   static_cast<unsigned>(info.source_width),
+                   static_cast<unsigned>(info.source_height),
+                   static_cast<unsigned>(image.width),
+                   static_cast<unsigned>(image.height),
+                   static_cast<unsigned>(ElapsedMs(start)));
+        return true;
+    }
+
+    std::string ArtworkLoader::SlotPath(const std::string& key) const
+    {
+        const std::uint32_t slots = config_.sd_slots > 0U ? config_.sd_slots : 1U;
+        char                name[16];
+        std::snprintf(name, sizeof(name), "/%04x.art", static_cast<unsigned>(KeyHash(key) % slots));
+        return config_.sd_dir + name;
+    }
+
+    bool ArtworkLoader::ReadSd(const std::string& key, ArtworkImage& image) const
+    {
+        if (config_.sd_dir.empty())
+        {
+            return false;
+        }
+        FILE* file = std::fopen(SlotPath(key).c_str(), "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::uint8_t  header[kSdHeaderSize];
+        std::uint16_t fields[3] = {};  // width, height, key length
+        bool          ok        = std::fread(header, 1, sizeof(header), file) == sizeof(header)
+                         && std::memcmp(header, kSdMagic, sizeof(kSdMagic)) == 0;
+        if (ok)
+        {
+            std::memcpy(fields, header + sizeof(kSdMagic), sizeof(fields));
+            ok = fields[0] > 0U && fields[0] <= config_.width && fields[1] > 0U
+                 && fields[1] <= config_.height && fields[2] == key.size();
+        }
+        if (ok)
+        {
+            std::string stored(fields[2], '\0');
+            ok = std::fread(&stored[0], 1, stored.size(), file) == stored.size() && stored == key;
+        }
+        if (ok)
+        {
+            image.width  = fields[0];
+            image.height = fields[1];
+            image.pixels.resize(static_cast<std::size_t>(image.width) * image.height);
+            ok = std::fread(image.pixels.data(), sizeof(std::uint16_t), image.pixels.size(), file)
+                 == image.pixels.size();
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    void ArtworkLoader::WriteSd(const std::string& key, const ArtworkImage& image)
+    {
+        if (config_.sd_dir.empty() || key.size() > kMaxKeyBytes)
+        {
+            return;
+        }
+        if (!sd_dir_made_)
+        {
+            // Fails harmlessly when it exists; a missing card shows up at fopen()
+            ::mkdir(config_.sd_dir.c_str(), 0775);
+            sd_dir_made_ = true;
+        }
+
+        // Written aside and renamed, so a reset mid-write leaves no half cover in the slot. Both
+        // names stay 8.3: the card's FAT is built without long file names
+        const std::string path = SlotPath(key);
+        const std::string temp = path.substr(0, path.size() - 4U) + ".tmp";
+        FILE*             file = std::fopen(temp.c_str(), "wb");
+        if (file == nullptr)
+        {
+            APP_LOG_DEBUG(kTag, "no SD cache at %s", config_.sd_dir.c_str());
+            return;
+        }
+        const std::uint16_t fields[3] = {static_cast<std::uint16_t>(image.width),
+                                         static_cast<std::uint16_t>(image.height),
+                                         static_cast<std::uint16_t>(key.size())};
+        bool ok = std::fwrite(kSdMagic, 1, sizeof(kSdMagic), file) == sizeof(kSdMagic)
+                  && std::fwrite(fields, sizeof(fields), 1, file) == 1U
+                  && std::fwrite(key.data(), 1, key.size(), file) == key.size()
+                  && std::fwrite(image.pixels.data(), sizeof(std::uint16_t), image.pixels.size(),
+                                 file)
+                         == image.pixels.size();
+        ok = std::fclose(file) == 0 && ok;
+
+        // FAT will not rename onto an existing file
+        std::remove(path.c_str());
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp.c_str());
+            APP_LOG_WARN(kTag, "could not write %s", path.c_str());
+        }
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "assets/asset_cache.h"
+#include "platform/audio/audio_source.h"
+#include "platform/image/image_decoder.h"
+
+namespace custom::integration
+{
+
+    /** A cover at card size, RGB565. */
+    using ArtworkImage = platform::ScaledImage;
+
+    /**
+     * @brief Album art for the media page: fetched by URL, decoded to card size, cached.
+     *
+     * Show() is called from the UI task with the cover the page should show. A cover decoded
+     * recently is still in RAM and shows on the next TakeReady(). Anything else becomes the
+     * one pending request, replacing any older one, for a worker task looping on RunOnce().
+     * The worker first looks for the cover on the SD card. Otherwise it fetches the image,
+     * decodes it straight to card size (DecodeImageScaled) and writes it to the SD card.
+     *
+     * Both caches are keyed by CacheKey(): Home Assistant's media proxy URLs carry an access
+     * token that rotates every few minutes, and the key leaves it out so that an unchanged
+     * cover stays cached. The RAM cache is an asset_cache with a byte budget. The SD cache is
+     * direct-mapped: one file per slot, picked by the key's hash. Each file records its key, so
+     * a collision is a miss that overwrites the slot and never shows the wrong cover.
+     *
+     * Show(), TakeReady() and the destructor run on the UI task. RunOnce() runs on the worker.
+     * A lock covers the request and the finished image between the two.
+     */
+    class ArtworkLoader
+    {
+    public:
+        /** A byte source for @p url, or nullptr if it cannot be opened. */
+        using Opener =
+            std::function<std::unique_ptr<platform::AudioSource>(const std::string& url)>;
+
+        struct Config
+        {
+            std::uint32_t width            = 240U;  // the media page's album art card
+            std::uint32_t height           = 240U;
+            std::uint32_t background       = 0x000000U;  // RGB888 under transparent PNG pixels
+            std::size_t   ram_budget_bytes = 4U * 240U * 240U * 2U;  // four covers
+            std::string   sd_dir           = "/sdcard/artwork";       // empty: RAM only
+            std::uint32_t sd_slots         = 256U;
+            Opener        open;  // empty: platform::OpenAudioSource()
+        };
+
+        struct Stats
+        {
+            std::uint32_t ram_hits = 0U;
+            std::uint32_t sd_hits  = 0U;
+            std::uint32_t fetches  = 0U;
+            std::uint32_t failures = 0U;  // fetches that could not be opened or decoded
+        };
+
+        explicit ArtworkLoader(Config config);
+        ~ArtworkLoader();
+
+        ArtworkLoader(const ArtworkLoader&)            = delete;
+        ArtworkLoader& operator=(const ArtworkLoader&) = delete;
+
+        /** The URL with Home Assistant's rotating access token taken out. */
+        static std::string CacheKey(const std::string& url);
+
+        /** UI task. An empty @p url shows no cover. */
+        void Show(const std::string& url);
+
+        /**
+         * UI task. True when the cover to show has changed since the last call, with
+         * @p image set to it, or to nullptr for none. @p image stays valid until the next call
+         * that returns true.
+         */
+        bool TakeReady(const ArtworkImage*& image);
+
+        /**
+         * Worker task: wait up to @p wait_ms for a request and serve it. False once Stop()
+         * has been called.
+         */
+        bool RunOnce(std::uint32_t wait_ms);
+        void Stop();
+
+        Stats GetStats() const;
+
+    private:
+        static void* DecodeCb(void* ctx, const char* id, std::size_t* out_size);
+        static void  DiscardCb(void* ctx, void* data);
+
+        // UI task
+        void ReleaseShown();
+
+        // Worker task
+        bool        Fetch(const std::string& url, ArtworkImage& image);
+        std::string SlotPath(const std::string& key) const;
+        bool        ReadSd(const std::string& key, ArtworkImage& image) const;
+        void        WriteSd(const std::string& key, const ArtworkImage& image);
+
+        const Config config_;
+        Opener       open_;
+
+        // UI task only
+        asset_cache_t*      cache_ = nullptr;
+        std::string         wanted_key_;
+        std::string         shown_key_;  // acquired from cache_; empty for none
+        const ArtworkImage* shown_   = nullptr;
+        bool                changed_ = false;
+        ArtworkImage*       adopt_   = nullptr;  // what DecodeCb hands to the cache
+
+        // Between the two tasks
+        std::mutex                    mutex_;
+        std::condition_variable       wake_;
+        bool                          stopping_    = false;
+        bool                          has_request_ = false;
+        std::string                   request_url_;
+        std::string                   request_key_;
+        bool                          has_done_ = false;
+        std::string                   done_key_;
+        std::unique_ptr<ArtworkImage> done_image_;  // nullptr if the cover could not be had
+
+        // Worker task only
+        bool sd_dir_made_ = false;
+
+        std::atomic<std::uint32_t> ram_hits_{0U};
+        std::atomic<std::uint32_t> sd_hits_{0U};
+        std::atomic<std::uint32_t> fetches_{0U};
+        std::atomic<std::uint32_t> failures_{0U};
+    };
+
+}  // namespace custom::integration
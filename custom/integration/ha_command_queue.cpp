@@ -0,0 +1,395 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_command_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../app_trace.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kCommandQueueTag = "ha-commands";
+
+        /** @p now is at or past @p deadline, with the millisecond clock allowed to wrap. */
+        bool Reached(std::uint32_t now, std::uint32_t deadline)
+        {
+            return static_cast<std::int32_t>(now - deadline) >= 0;
+        }
+
+        bool SameOutcome(bool on, std::int32_t brightness, bool other_on, std::int32_t other)
+        {
+            // Brightness means nothing while off
+            return on == other_on && (!on || brightness == other);
+        }
+
+    }  // namespace
+
+    HaCommandQueue::HaCommandQueue(HaEntityStore& store, Config config) :
+        store_(store), config_(config)
+    {
+    }
+
+    void HaCommandQueue::SetChangeCallback(ChangeCallback callback)
+    {
+        on_change_ = std::move(callback);
+    }
+
+    void HaCommandQueue::SetSink(HaCommandSink* sink, std::uint32_t now_ms)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sink_      = sink;
+        tokens_    = config_.burst;
+        refill_ms_ = now_ms;
+        if (sink == nullptr)
+        {
+            stats_.failed += static_cast<std::uint32_t>(slots_.size());
+            slots_.clear();
+        }
+    }
+
+    bool HaCommandQueue::Toggle(std::string_view entity_id, std::uint32_t now_ms)
+    {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Slot*                       slot = Begin(entity_id);
+            if (slot == nullptr)
+            {
+                return false;
+            }
+            // Every tap restarts the quiet period, so a burst of taps sends one command at most
+            slot->on     = !slot->on;
+            slot->due_ms = now_ms + config_.debounce_ms;
+            changed      = ShowWanted(*slot);
+            Settle(*slot);
+            stats_.cancelled += slot->done ? 1U : 0U;
+            EraseDone();
+        }
+        if (changed)
+        {
+            NotifyChanged();
+        }
+        return true;
+    }
+
+    bool HaCommandQueue::SetBrightness(std::string_view entity_id,
+                                       std::int32_t     brightness,
+                                       std::uint32_t    now_ms)
+    {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Slot*                       slot = Begin(entity_id);
+            if (slot == nullptr)
+            {
+                return false;
+            }
+            brightness = std::clamp(brightness, 0, 255);
+            slot->on   = brightness > 0;
+            if (slot->on)
+            {
+                slot->brightness = brightness;
+            }
+            // A drag is not debounced: the first step goes out at once, later ones replace
+            // each other until it is back
+            if (!slot->dirty)
+            {
+                slot->due_ms = now_ms;
+            }
+            changed = ShowWanted(*slot);
+            Settle(*slot);
+            stats_.cancelled += slot->done ? 1U : 0U;
+            EraseDone();
+        }
+        if (changed)
+        {
+            NotifyChanged();
+        }
+        return true;
+    }
+
+    void HaCommandQueue::Poll(std::uint32_t now_ms)
+    {
+        struct Outgoing
+        {
+            std::string   entity_id;
+            bool          on         = false;
+            std::int32_t  brightness = -1;
+            std::uint32_t request_id = 0U;
+        };
+
+        std::vector<Outgoing> outgoing;
+        HaCommandSink*        sink    = nullptr;
+        bool                  changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sink_ == nullptr)
+            {
+                return;
+            }
+            Refill(now_ms);
+            const std::uint32_t rolled_back = stats_.rolled_back;
+            std::uint32_t       budget      = tokens_;
+            bool                throttled   = false;
+            for (Slot& slot : slots_)
+            {
+                if (slot.request_id != 0U)
+                {
+                    if (Reached(now_ms, slot.sent_ms + config_.timeout_ms))
+                    {
+                        APP_LOG_WARN(kCommandQueueTag, "no result for %s", slot.entity_id.c_str());
+                        Fail(slot);
+                    }
+                    continue;
+                }
+                if (!slot.dirty || !Reached(now_ms, slot.due_ms))
+                {
+                    continue;
+                }
+                if (budget == 0U)
+                {
+                    throttled = true;
+                    continue;
+                }
+                budget--;
+
+                // In flight from here on, so taps made while it is sent settle against it
+                slot.sending         = true;
+                slot.sent_on         = slot.on;
+                slot.sent_brightness = slot.brightness;
+                slot.dirty           = false;
+
+                Outgoing command;
+                command.entity_id  = slot.entity_id;
+                command.on         = slot.on;
+                command.brightness = slot.on ? slot.brightness : -1;
+                outgoing.push_back(std::move(command));
+            }
+            if (throttled)
+            {
+                stats_.throttled++;
+            }
+            changed  = stats_.rolled_back != rolled_back;
+            sending_ = !outgoing.empty();
+            sink     = sink_;
+            EraseDone();
+        }
+
+        // The sink may block on the socket, so it runs unlocked; OnResult() holds back any
+        // reply that beats its request id being recorded below
+        for (Outgoing& command : outgoing)
+        {
+            HaCommand call;
+            call.entity_id     = command.entity_id;
+            call.on            = command.on;
+            call.brightness    = command.brightness;
+            command.request_id = sink->SendCommand(call);
+        }
+
+        if (!outgoing.empty())
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const std::uint32_t         rolled_back = stats_.rolled_back;
+            for (const Outgoing& command : outgoing)
+            {
+                const auto it =
+                    std::find_if(slots_.begin(), slots_.end(), [&command](const Slot& slot) {
+                        return slot.sending && slot.entity_id == command.entity_id;
+                    });
+                if (it == slots_.end())
+                {
+                    continue;  // the connection dropped while it was sent
+                }
+                Slot& slot   = *it;
+                slot.sending = false;
+                if (command.request_id == 0U)
+                {
+                    Fail(slot);
+                    continue;
+                }
+                tokens_--;
+                stats_.sent++;
+                slot.request_id = command.request_id;
+                slot.sent_ms    = now_ms;
+
+                const auto early = std::find_if(
+                    early_results_.begin(),
+                    early_results_.end(),
+                    [&command](const EarlyResult& result) {
+                        return result.request_id == command.request_id;
+                    });
+                if (early != early_results_.end())
+                {
+                    changed = Resolve(slot, early->success) || changed;
+                }
+            }
+            early_results_.clear();
+            sending_ = false;
+            changed  = changed || stats_.rolled_back != rolled_back;
+            EraseDone();
+        }
+        if (changed)
+        {
+            NotifyChanged();
+        }
+    }
+
+    void HaCommandQueue::OnResult(std::uint32_t request_id, bool success)
+    {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (request_id == 0U)
+            {
+                return;
+            }
+            const auto it =
+                std::find_if(slots_.begin(), slots_.end(), [request_id](const Slot& slot) {
+                    return slot.request_id == request_id;
+                });
+            if (it == slots_.end())
+            {
+                if (sending_)
+                {
+                    // Possibly for a command Poll() has sent but not recorded yet
+                    early_results_.push_back({request_id, success});
+                }
+                return;  // timed out already, or not ours
+            }
+            changed = Resolve(*it, success);
+            EraseDone();
+        }
+        if (changed)
+        {
+            NotifyChanged();
+        }
+    }
+
+    std::size_t HaCommandQueue::Pending() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+
+    HaCommandQueue::Stats HaCommandQueue::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    HaCommandQueue::Slot* HaCommandQueue::Begin(std::string_view entity_id)
+    {
+        if (sink_ == nullptr)
+        {
+            return nullptr;
+        }
+        for (Slot& slot : slots_)
+        {
+            if (slot.entity_id == entity_id)
+            {
+                stats_.actions++;
+                return &slot;
+            }
+        }
+        HaEntityState state;
+        if (!store_.Peek(entity_id, state) || !state.available)
+        {
+            return nullptr;
+        }
+        Slot slot;
+        slot.entity_id  = std::string(entity_id);
+        slot.confirmed  = state;
+        slot.on         = state.on;
+        slot.brightness = state.brightness;
+        slots_.push_back(std::move(slot));
+        stats_.actions++;
+        return &slots_.back();
+    }
+
+    void HaCommandQueue::Settle(Slot& slot)
+    {
+        const bool in_flight       = slot.sending || slot.request_id != 0U;
+        const bool base_on         = in_flight ? slot.sent_on : slot.confirmed.on;
+        const auto base_brightness = in_flight ? slot.sent_brightness : slot.confirmed.brightness;
+        slot.dirty = !SameOutcome(slot.on, slot.brightness, base_on, base_brightness);
+        // Nothing in flight and nothing left to send: the slot has served its purpose
+        slot.done = !slot.dirty && !in_flight;
+    }
+
+    bool HaCommandQueue::Resolve(Slot& slot, bool success)
+    {
+        if (!success)
+        {
+            APP_LOG_WARN(kCommandQueueTag, "command for %s rejected", slot.entity_id.c_str());
+            Fail(slot);
+            return true;
+        }
+        bool changed              = false;
+        slot.confirmed.available  = true;
+        slot.confirmed.on         = slot.sent_on;
+        slot.confirmed.brightness = slot.sent_brightness;
+        slot.request_id           = 0U;
+        if (slot.dirty)
+        {
+            // The state_changed for the command just acknowledged may have shown the older
+            // value; the newer one is still what the user sees as wanted
+            changed = ShowWanted(slot);
+        }
+        Settle(slot);
+        return changed;
+    }
+
+    bool HaCommandQueue::ShowWanted(const Slot& slot)
+    {
+        return store_.Apply(slot.entity_id, slot.on ? "on" : "off", slot.on ? slot.brightness : -1);
+    }
+
+    void HaCommandQueue::Fail(Slot& slot)
+    {
+        stats_.failed++;
+        stats_.rolled_back++;
+        const HaEntityState& confirmed = slot.confirmed;
+        store_.Apply(slot.entity_id,
+                     !confirmed.available ? "unavailable" : (confirmed.on ? "on" : "off"),
+                     confirmed.brightness);
+        slot.done = true;
+    }
+
+    void HaCommandQueue::EraseDone()
+    {
+        slots_.erase(std::remove_if(slots_.begin(),
+                                    slots_.end(),
+                                    [](const Slot& slot) { return slot.done; }),
+                     slots_.end());
+    }
+
+    void HaCommandQueue::Refill(std::uint32_t now_ms)
+    {
+        if (config_.interval_ms == 0U || tokens_ >= config_.burst)
+        {
+            tokens_    = config_.burst;
+            refill_ms_ = now_ms;
+            return;
+        }
+        const std::uint32_t earned = (now_ms - refill_ms_) / config_.interval_ms;
+        tokens_                    = std::min(config_.burst, tokens_ + earned);
+        refill_ms_ += earned * config_.interval_ms;
+    }
+
+    void HaCommandQueue::NotifyChanged()
+    {
+        if (on_change_)
+        {
+            on_change_();
+        }
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+
+namespace custom::integration
+{
+
+    /** One service call: turn an entity on, optionally at a brightness, or off. */
+    struct HaCommand
+    {
+        std::string_view entity_id;
+        bool             on         = false;
+        std::int32_t     brightness = -1;  // 0..255 for lights, -1 to leave it as it is
+    };
+
+    /** Carries commands to Home Assistant on the current connection. */
+    class HaCommandSink
+    {
+    public:
+        virtual ~HaCommandSink() = default;
+
+        /** Request id that the result will carry, or 0 if the command could not be sent. */
+        virtual std::uint32_t SendCommand(const HaCommand& command) = 0;
+    };
+
+    /**
+     * @brief Outbound entity commands, coalesced per entity and rate-limited per connection.
+     *
+     * The UI calls Toggle() and SetBrightness() for every tap or slider step. Each call only
+     * updates the entity's wanted state and shows it at once in the store (optimistic UI), so
+     * the card reacts within the frame. Poll() turns wanted states into commands:
+     *  - a toggle waits until taps have been quiet for debounce_ms, and an even number of taps
+     *    sends nothing;
+     *  - brightness is last-write-wins: while one command for an entity is in flight, newer
+     *    values replace each other and only the latest goes out once the result is back;
+     *  - a token bucket (burst, then one per interval_ms) caps the whole connection.
+     * A rejected, unsendable or timed-out command restores the entity to the last state Home
+     * Assistant confirmed, and drops whatever was still pending for it.
+     *
+     * Toggle(), SetBrightness() and Poll() run on the UI thread; OnResult() runs on the
+     * network task. A lock covers the queue but is released while the sink sends, since that
+     * can block on the socket; a result that arrives before Poll() has recorded its request id
+     * is held until it has.
+     */
+    class HaCommandQueue
+    {
+    public:
+        struct Config
+        {
+            std::uint32_t debounce_ms = 300U;   // quiet time after the last tap of a toggle
+            std::uint32_t burst       = 4U;     // commands a connection may send back to back
+            std::uint32_t interval_ms = 100U;   // after that, one more per interval
+            std::uint32_t timeout_ms  = 5000U;  // no result by then counts as a failure
+        };
+
+        struct Stats
+        {
+            std::uint32_t actions     = 0U;  // Toggle() and SetBrightness() calls accepted
+            std::uint32_t sent        = 0U;  // commands handed to the sink
+            std::uint32_t cancelled   = 0U;  // changes that ended where they started
+            std::uint32_t throttled   = 0U;  // Poll() passes that held a due command back
+            std::uint32_t failed      = 0U;  // rejected, unsendable or timed out
+            std::uint32_t rolled_back = 0U;  // optimistic states undone after a failure
+        };
+
+        using ChangeCallback = std::function<void()>;
+
+        HaCommandQueue(HaEntityStore& store, Config config);
+
+        HaCommandQueue(const HaCommandQueue&)            = delete;
+        HaCommandQueue& operator=(const HaCommandQueue&) = delete;
+
+        /** Called after an optimistic change or a rollback touched the store. */
+        void SetChangeCallback(ChangeCallback callback);
+
+        /**
+         * A new connection (fresh rate budget), or nullptr when it dropped. Commands still
+         * pending then are discarded without a rollback: the store goes unavailable anyway
+         * and the next snapshot is authoritative. A sink must outlive any Poll() that is
+         * sending through it.
+         */
+        void SetSink(HaCommandSink* sink, std::uint32_t now_ms);
+
+        /** False if offline or the entity is untracked or unavailable. */
+        bool Toggle(std::string_view entity_id, std::uint32_t now_ms);
+        /** @p brightness 0..255; 0 turns the entity off. */
+        bool SetBrightness(std::string_view entity_id,
+                           std::int32_t     brightness,
+                           std::uint32_t    now_ms);
+
+        /** Send what is due within the rate limit, and fail commands that timed out. */
+        void Poll(std::uint32_t now_ms);
+
+        void OnResult(std::uint32_t request_id, bool success);
+
+        /** Entities with a command pending or in flight. */
+        std::size_t Pending() const;
+        Stats       GetStats() const;
+
+    private:
+        struct Slot
+        {
+            std::string   entity_id;
+            HaEntityState confirmed;  // last state Home Assistant acknowledged
+            bool          on              = false;  // wanted
+            std::int32_t  brightness      = -1;
+            bool          dirty           = false;  // wanted differs from what was last sent
+            std::uint32_t due_ms          = 0U;
+            std::uint32_t request_id      = 0U;  // in flight if not 0
+            std::uint32_t sent_ms         = 0U;
+            bool          sent_on         = false;
+            std::int32_t  sent_brightness = -1;
+            bool          sending         = false;  // handed to the sink, id not known yet
+            bool          done            = false;  // erase at the end of the pass
+        };
+
+        struct EarlyResult
+        {
+            std::uint32_t request_id = 0U;
+            bool          success    = false;
+        };
+
+        Slot* Begin(std::string_view entity_id);
+        void  Settle(Slot& slot);
+        bool  Resolve(Slot& slot, bool success);
+        bool  ShowWanted(const Slot& slot);
+        void  Fail(Slot& slot);
+        void  EraseDone();
+        void  Refill(std::uint32_t now_ms);
+        void  NotifyChanged();
+
+        HaEntityStore&     store_;
+        Config             config_;
+        ChangeCallback     on_change_;
+        mutable std::mutex mutex_;
+        HaCommandSink*     sink_      = nullptr;
+        std::uint32_t      tokens_    = 0U;
+        std::uint32_t      refill_ms_ = 0U;
+        std::vector<Slot>  slots_;
+        Stats              stats_;
+
+        // A Poll() is in the sink, unlocked; replies that beat their request id wait here
+        bool                     sending_ = false;
+        std::vector<EarlyResult> early_results_;
+    };
+
+}  // namespace custom::integration
@@ -0,0 +1,293 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_entity_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+
+#include "integration/rooms_provider.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        room_entity_kind_t KindForEntity(std::string_view entity_id)
+        {
+            const std::string_view domain = entity_id.substr(0, entity_id.find('.'));
+            if (domain == "light")
+            {
+                return ROOM_ENTITY_LIGHT;
+            }
+            if (domain == "switch" || domain == "input_boolean" || domain == "fan")
+            {
+                return ROOM_ENTITY_SWITCH;
+            }
+            return ROOM_ENTITY_SENSOR;
+        }
+
+        // Longest state ParseReading() tries as a number
+        constexpr std::size_t kMaxReadingText = 31U;
+
+        bool ParseReading(std::string_view state, double& reading)
+        {
+            if (state.empty() || state.size() > kMaxReadingText)
+            {
+                return false;
+            }
+            char text[kMaxReadingText + 1U];
+            state.copy(text, state.size());
+            text[state.size()] = '\0';
+            char*        end   = nullptr;
+            const double value = std::strtod(text, &end);
+            if (end != text + state.size() || !std::isfinite(value))
+            {
+                return false;
+            }
+            reading = value;
+            return true;
+        }
+
+        std::int32_t RoundReading(double reading, std::int32_t lo, std::int32_t hi)
+        {
+            const double clamped =
+                std::clamp(reading, static_cast<double>(lo), static_cast<double>(hi));
+            return static_cast<std::int32_t>(std::lround(clamped));
+        }
+
+    }  // namespace
+
+    HaEntityStore::HaEntityStore(std::vector<HaRoomLayout> layout)
+    {
+        rooms_.reserve(layout.size());
+        for (HaRoomLayout& room_layout : layout)
+        {
+            const std::size_t index = rooms_.size();
+            Room              room;
+            room.room_id = std::move(room_layout.room_id);
+            room.name    = std::move(room_layout.name);
+            for (const std::string& entity_id : room_layout.entities)
+            {
+                room.members.push_back(AddEntity(entity_id, index));
+            }
+            if (!room_layout.temperature_entity.empty())
+            {
+                room.temperature = AddEntity(room_layout.temperature_entity, index);
+            }
+            if (!room_layout.humidity_entity.empty())
+            {
+                room.humidity = AddEntity(room_layout.humidity_entity, index);
+            }
+            rooms_.push_back(std::move(room));
+        }
+
+        // Entities and rooms are fixed from here on, so the index and the published views can
+        // point into them for the lifetime of the store
+        index_.reserve(entities_.size());
+        entity_views_.resize(entities_.size());
+        for (std::size_t i = 0; i < entities_.size(); ++i)
+        {
+            index_.emplace(entities_[i].entity_id, i);
+            entity_views_[i].entity_id = entities_[i].entity_id.c_str();
+            entity_views_[i].kind      = entities_[i].kind;
+            entity_views_[i].value     = -1;
+        }
+        room_views_.resize(rooms_.size());
+        for (std::size_t i = 0; i < rooms_.size(); ++i)
+        {
+            Room& room = rooms_[i];
+            for (std::size_t member : room.members)
+            {
+                room.views.push_back(&entity_views_[member]);
+            }
+            room_views_[i].room_id      = room.room_id.c_str();
+            room_views_[i].name         = room.name.c_str();
+            room_views_[i].entities     = room.views.empty() ? nullptr : room.views.data();
+            room_views_[i].entity_count = room.views.size();
+        }
+        state_.rooms      = room_views_.empty() ? nullptr : room_views_.data();
+        state_.room_count = room_views_.size();
+    }
+
+    std::size_t HaEntityStore::AddEntity(const std::string& entity_id, std::size_t room)
+    {
+        // Linear, and only while the layout is loaded: index_ is built once entities_ stops
+        // growing, because a reallocation would move the strings it points into
+        std::size_t index = 0U;
+        while (index < entities_.size() && entities_[index].entity_id != entity_id)
+        {
+            ++index;
+        }
+        if (index == entities_.size())
+        {
+            Entity entity;
+            entity.entity_id = entity_id;
+            entity.kind      = KindForEntity(entity_id);
+            entities_.push_back(std::move(entity));
+        }
+
+        std::vector<std::size_t>& rooms = entities_[index].rooms;
+        if (std::find(rooms.begin(), rooms.end(), room) == rooms.end())
+        {
+            rooms.push_back(room);
+        }
+        return index;
+    }
+
+    bool HaEntityStore::Apply(const HaEntityUpdate& update)
+    {
+        return Apply(update.entity_id, update.state, update.brightness);
+    }
+
+    bool HaEntityStore::Apply(std::string_view entity_id,
+                              std::string_view state,
+                              std::int32_t     brightness)
+    {
+        const auto it = index_.find(entity_id);
+        if (it == index_.end())
+        {
+            return false;
+        }
+
+        // kind never changes, so the new values can be worked out before taking the lock
+        const room_entity_kind_t kind      = entities_[it->second].kind;
+        const bool               available = state != "unavailable" && state != "unknown";
+        const bool               on        = state == "on";
+        double                   reading   = 0.0;
+        const bool               numeric   = ParseReading(state, reading);
+        std::int32_t             value     = -1;
+        if (kind == ROOM_ENTITY_LIGHT && on && brightness >= 0)
+        {
+            value = static_cast<std::int32_t>((brightness * 100 + 127) / 255);
+        }
+        else if (kind == ROOM_ENTITY_SENSOR && numeric)
+        {
+            value = RoundReading(reading, INT32_MIN, INT32_MAX);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        Entity&    entity  = entities_[it->second];
+        const bool changed = available != entity.available || on != entity.on
+                             || value != entity.value || numeric != entity.numeric
+                             || (numeric && reading != entity.reading);
+        // Kept even when the percentage shown stays the same
+        entity.brightness = brightness;
+        if (!changed)
+        {
+            return false;
+        }
+        entity.available = available;
+        entity.on        = on;
+        entity.value     = value;
+        entity.numeric   = numeric;
+        entity.reading   = reading;
+        for (std::size_t room : entity.rooms)
+        {
+            rooms_[room].dirty = true;
+        }
+        return true;
+    }
+
+    void HaEntityStore::MarkAllUnavailable()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entity& entity : entities_)
+        {
+            entity.available = false;
+        }
+        for (Room& room : rooms_)
+        {
+            room.dirty = true;
+        }
+    }
+
+    bool HaEntityStore::Tracks(std::string_view entity_id) const
+    {
+        return index_.find(entity_id) != index_.end();
+    }
+
+    std::size_t HaEntityStore::EntityCount() const
+    {
+        return entities_.size();
+    }
+
+    bool HaEntityStore::Peek(std::string_view entity_id, HaEntityState& out) const
+    {
+        const auto it = index_.find(entity_id);
+        if (it == index_.end())
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entity&               entity = entities_[it->second];
+        out.available                      = entity.available;
+        out.on                             = entity.on;
+        out.brightness                     = entity.brightness;
+        return true;
+    }
+
+    const rooms_state_t* HaEntityStore::Publish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::size_t i = 0; i < rooms_.size(); ++i)
+            {
+                PublishRoom(i);
+            }
+        }
+        rooms_provider_set_state(&state_);
+        return &state_;
+    }
+
+    std::size_t HaEntityStore::PublishChanged(std::vector<const room_t*>& changed)
+    {
+        changed.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::size_t i = 0; i < rooms_.size(); ++i)
+            {
+                if (rooms_[i].dirty)
+                {
+                    PublishRoom(i);
+                    changed.push_back(&room_views_[i]);
+                }
+            }
+        }
+        if (!changed.empty())
+        {
+            rooms_provider_set_state(&state_);
+        }
+        return changed.size();
+    }
+
+    void HaEntityStore::PublishRoom(std::size_t index)
+    {
+        Room& room = rooms_[index];
+        for (std::size_t member : room.members)
+        {
+            entity_views_[member].available = entities_[member].available;
+            entity_views_[member].on        = entities_[member].on;
+            entity_views_[member].value     = entities_[member].value;
+        }
+        if (room.temperature != SIZE_MAX && entities_[room.temperature].numeric)
+        {
+            room_views_[index].temp_c = static_cast<std::int8_t>(
+                RoundReading(entities_[room.temperature].reading, INT8_MIN, INT8_MAX));
+        }
+        if (room.humidity != SIZE_MAX && entities_[room.humidity].numeric)
+        {
+            room_views_[index].humidity =
+                static_cast<std::uint8_t>(RoundReading(entities_[room.humidity].reading, 0, 100));
+        }
+        room.dirty = false;
+    }
+
+}  // namespace custom::integration
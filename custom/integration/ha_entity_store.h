@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ui/pages/ui_rooms_model.h"
+
+namespace custom::integration
+{
+
+    /** One Home Assistant state object, reduced to the fields the rooms page uses. */
+    struct HaEntityUpdate
+    {
+        std::string  entity_id;
+        std::string  state;            // "on", "off", "21.5", "unavailable", ...
+        std::int32_t brightness = -1;  // light attribute 0..255, -1 if absent
+    };
+
+    /** What the store currently holds for one entity. */
+    struct HaEntityState
+    {
+        bool         available  = false;
+        bool         on         = false;
+        std::int32_t brightness = -1;  // last light attribute 0..255, -1 if absent
+    };
+
+    /** Which entities make up a room card. The first entity is the card's toggle. */
+    struct HaRoomLayout
+    {
+        std::string              room_id;
+        std::string              name;
+        std::vector<std::string> entities;
+        std::string              temperature_entity;  // optional sensor for temp_c
+        std::string              humidity_entity;     // optional sensor for humidity
+    };
+
+    /**
+     * @brief Home Assistant entities the UI shows, indexed by entity_id.
+     *
+     * Only entities named by the room layout are stored; updates for anything else are
+     * rejected with one hash lookup, so a busy HA instance costs no memory here. Apply() may
+     * run on the network task while Publish() or PublishChanged() runs on the LVGL thread; a
+     * short internal lock covers the copy. The publish calls write the rooms_state_t handed to
+     * rooms_provider_set_state(), so they must run where the UI reads that state (the LVGL
+     * thread, or with the LVGL lock held).
+     */
+    class HaEntityStore
+    {
+    public:
+        explicit HaEntityStore(std::vector<HaRoomLayout> layout);
+
+        HaEntityStore(const HaEntityStore&)            = delete;
+        HaEntityStore& operator=(const HaEntityStore&) = delete;
+
+        /** Returns true if a tracked entity changed. */
+        bool Apply(const HaEntityUpdate& update);
+        /** Same, without an owning copy; nothing is allocated. */
+        bool Apply(std::string_view entity_id, std::string_view state, std::int32_t brightness);
+
+        /** Connection lost: everything goes unavailable until the next snapshot. */
+        void MarkAllUnavailable();
+
+        bool        Tracks(std::string_view entity_id) const;
+        std::size_t EntityCount() const;
+        /** False if @p entity_id is not tracked. Thread-safe like Apply(). */
+        bool Peek(std::string_view entity_id, HaEntityState& out) const;
+
+        /** Refresh the rooms snapshot and install it with rooms_provider_set_state(). */
+        const rooms_state_t* Publish();
+
+        /**
+         * Like Publish(), but only refreshes rooms touched since the last publish. Fills
+         * @p changed with those rooms (pointers into the published state) and returns how many.
+         */
+        std::size_t PublishChanged(std::vector<const room_t*>& changed);
+
+    private:
+        struct Entity
+        {
+            std::string              entity_id;
+            room_entity_kind_t       kind       = ROOM_ENTITY_SENSOR;
+            bool                     available  = false;
+            bool                     on         = false;
+            std::int32_t             value      = -1;
+            std::int32_t             brightness = -1;   // raw light attribute, for Peek()
+            bool                     numeric    = false;
+            double                   reading    = 0.0;  // numeric state, for sensors
+            std::vector<std::size_t> rooms;             // rooms that show this entity
+        };
+
+        struct Room
+        {
+            std::string                 room_id;
+            std::string                 name;
+            std::vector<std::size_t>    members;
+            std::vector<room_entity_t*> views;
+            std::size_t                 temperature = SIZE_MAX;
+            std::size_t                 humidity    = SIZE_MAX;
+            bool                        dirty       = true;
+        };
+
+        std::size_t AddEntity(const std::string& entity_id, std::size_t room);
+        void        PublishRoom(std::size_t room);
+
+        mutable std::mutex                                mutex_;  // entities_ and Room::dirty
+        std::vector<Entity>                               entities_;
+        std::unordered_map<std::string_view, std::size_t> index_;  // views of Entity::entity_id
+        std::vector<Room>                                 rooms_;
+
+        // Published copy the UI reads; only written by the publish calls
+        std::vector<room_entity_t> entity_views_;
+        std::vector<room_t>        room_views_;
+        rooms_state_t              state_ = {nullptr, 0U};
+    };
+
+}  // namespace custom::integration
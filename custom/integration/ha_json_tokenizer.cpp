@@ -0,0 +1,483 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_json_tokenizer.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        // Longest number text NumberValue() converts; JSON from Home Assistant stays far below
+        constexpr std::size_t kMaxNumberText = 63U;
+
+        bool IsDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        int HexValue(char c)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+            if (c >= 'a' && c <= 'f')
+            {
+                return c - 'a' + 10;
+            }
+            if (c >= 'A' && c <= 'F')
+            {
+                return c - 'A' + 10;
+            }
+            return -1;
+        }
+
+        bool ReadHex4(const char* p, std::uint32_t& value)
+        {
+            value = 0U;
+            for (int i = 0; i < 4; ++i)
+            {
+                const int digit = HexValue(p[i]);
+                if (digit < 0)
+                {
+                    return false;
+                }
+                value = (value << 4) | static_cast<std::uint32_t>(digit);
+            }
+            return true;
+        }
+
+        std::size_t EncodeUtf8(std::uint32_t cp, char* out)
+        {
+            if (cp < 0x80U)
+            {
+                out[0] = static_cast<char>(cp);
+                return 1U;
+            }
+            if (cp < 0x800U)
+            {
+                out[0] = static_cast<char>(0xC0U | (cp >> 6));
+                out[1] = static_cast<char>(0x80U | (cp & 0x3FU));
+                return 2U;
+            }
+            if (cp < 0x10000U)
+            {
+                out[0] = static_cast<char>(0xE0U | (cp >> 12));
+                out[1] = static_cast<char>(0x80U | ((cp >> 6) & 0x3FU));
+                out[2] = static_cast<char>(0x80U | (cp & 0x3FU));
+                return 3U;
+            }
+            out[0] = static_cast<char>(0xF0U | (cp >> 18));
+            out[1] = static_cast<char>(0x80U | ((cp >> 12) & 0x3FU));
+            out[2] = static_cast<char>(0x80U | ((cp >> 6) & 0x3FU));
+            out[3] = static_cast<char>(0x80U | (cp & 0x3FU));
+            return 4U;
+        }
+
+    }  // namespace
+
+    HaJsonTokenizer::HaJsonTokenizer(const char* data, std::size_t length) :
+        pos_(data), end_(data + length)
+    {
+    }
+
+    HaJsonToken HaJsonTokenizer::Next()
+    {
+        SkipWhitespace();
+        switch (expect_)
+        {
+            case Expect::kFailed:
+                return HaJsonToken::kError;
+            case Expect::kDone:
+                return pos_ == end_ ? HaJsonToken::kEnd : Fail();
+            default:
+                break;
+        }
+        if (pos_ == end_)
+        {
+            return Fail();
+        }
+
+        const char c = *pos_;
+        switch (expect_)
+        {
+            case Expect::kCommaOrEnd:
+                if (c == (InArray() ? ']' : '}'))
+                {
+                    return Close(InArray());
+                }
+                if (c != ',')
+                {
+                    return Fail();
+                }
+                ++pos_;
+                SkipWhitespace();
+                if (InArray())
+                {
+                    return ReadValue();
+                }
+                return ReadKey();
+            case Expect::kKeyOrEnd:
+                return c == '}' ? Close(false) : ReadKey();
+            case Expect::kValueOrEnd:
+                return c == ']' ? Close(true) : ReadValue();
+            default:
+                return ReadValue();
+        }
+    }
+
+    bool HaJsonTokenizer::SkipValue()
+    {
+        const std::size_t depth = depth_;
+        HaJsonToken       token = Next();
+        if (token != HaJsonToken::kObjectBegin && token != HaJsonToken::kArrayBegin)
+        {
+            return token != HaJsonToken::kError && token != HaJsonToken::kEnd;
+        }
+        while (depth_ > depth)
+        {
+            token = Next();
+            if (token == HaJsonToken::kError || token == HaJsonToken::kEnd)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view HaJsonTokenizer::Text() const
+    {
+        return text_ != nullptr ? std::string_view(text_, text_length_) : std::string_view();
+    }
+
+    bool HaJsonTokenizer::CopyText(char* out, std::size_t capacity) const
+    {
+        if (out == nullptr || capacity == 0U)
+        {
+            return false;
+        }
+        out[0] = '\0';
+        if (!escaped_)
+        {
+            if (text_length_ >= capacity)
+            {
+                return false;
+            }
+            std::memcpy(out, text_, text_length_);
+            out[text_length_] = '\0';
+            return true;
+        }
+
+        const char* p   = text_;
+        const char* end = text_ + text_length_;
+        std::size_t n   = 0U;
+        while (p < end)
+        {
+            char        utf8[4];
+            std::size_t width = 1U;
+            if (*p != '\\')
+            {
+                utf8[0] = *p++;
+            }
+            else
+            {
+                const char escape = p[1];
+                p += 2;
+                switch (escape)
+                {
+                    case 'b':
+                        utf8[0] = '\b';
+                        break;
+                    case 'f':
+                        utf8[0] = '\f';
+                        break;
+                    case 'n':
+                        utf8[0] = '\n';
+                        break;
+                    case 'r':
+                        utf8[0] = '\r';
+                        break;
+                    case 't':
+                        utf8[0] = '\t';
+                        break;
+                    case 'u':
+                    {
+                        std::uint32_t cp = 0U;
+                        ReadHex4(p, cp);  // digits were checked by ScanString()
+                        p += 4;
+                        if (cp >= 0xD800U && cp <= 0xDBFFU)
+                        {
+                            std::uint32_t low = 0U;
+                            if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !ReadHex4(p + 2, low)
+                                || low < 0xDC00U || low > 0xDFFFU)
+                            {
+                                out[0] = '\0';
+                                return false;
+                            }
+                            p += 6;
+                            cp = 0x10000U + ((cp - 0xD800U) << 10) + (low - 0xDC00U);
+                        }
+                        else if (cp >= 0xDC00U && cp <= 0xDFFFU)
+                        {
+                            out[0] = '\0';
+                            return false;
+                        }
+                        width = EncodeUtf8(cp, utf8);
+                        break;
+                    }
+                    default:  // '"', '\\' and '/' stand for themselves
+                        utf8[0] = escape;
+                        break;
+                }
+            }
+            if (n + width >= capacity)
+            {
+                out[0] = '\0';
+                return false;
+            }
+            std::memcpy(out + n, utf8, width);
+            n += width;
+        }
+        out[n] = '\0';
+        return true;
+    }
+
+    bool HaJsonTokenizer::NumberValue(double& value) const
+    {
+        if (text_ == nullptr || text_length_ == 0U || text_length_ > kMaxNumberText)
+        {
+            return false;
+        }
+        char buffer[kMaxNumberText + 1U];
+        std::memcpy(buffer, text_, text_length_);
+        buffer[text_length_] = '\0';
+        char* parsed_end     = nullptr;
+        value                = std::strtod(buffer, &parsed_end);
+        return parsed_end == buffer + text_length_ && std::isfinite(value);
+    }
+
+    std::size_t HaJsonTokenizer::Depth() const
+    {
+        return depth_;
+    }
+
+    HaJsonToken HaJsonTokenizer::ReadKey()
+    {
+        if (pos_ == end_ || *pos_ != '"' || !ScanString())
+        {
+            return Fail();
+        }
+        SkipWhitespace();
+        if (pos_ == end_ || *pos_ != ':')
+        {
+            return Fail();
+        }
+        ++pos_;
+        expect_ = Expect::kValue;
+        return HaJsonToken::kKey;
+    }
+
+    HaJsonToken HaJsonTokenizer::ReadValue()
+    {
+        if (pos_ == end_)
+        {
+            return Fail();
+        }
+        switch (*pos_)
+        {
+            case '{':
+                return Open(false);
+            case '[':
+                return Open(true);
+            case '"':
+                return ScanString() ? Scalar(HaJsonToken::kString) : Fail();
+            case 't':
+                return ScanLiteral("true") ? Scalar(HaJsonToken::kTrue) : Fail();
+            case 'f':
+                return ScanLiteral("false") ? Scalar(HaJsonToken::kFalse) : Fail();
+            case 'n':
+                return ScanLiteral("null") ? Scalar(HaJsonToken::kNull) : Fail();
+            default:
+                return ScanNumber() ? Scalar(HaJsonToken::kNumber) : Fail();
+        }
+    }
+
+    HaJsonToken HaJsonTokenizer::Open(bool array)
+    {
+        if (depth_ >= kMaxDepth)
+        {
+            return Fail();
+        }
+        const std::uint64_t bit = std::uint64_t{1} << depth_;
+        array_bits_             = array ? (array_bits_ | bit) : (array_bits_ & ~bit);
+        ++depth_;
+        ++pos_;
+        text_   = nullptr;
+        expect_ = array ? Expect::kValueOrEnd : Expect::kKeyOrEnd;
+        return array ? HaJsonToken::kArrayBegin : HaJsonToken::kObjectBegin;
+    }
+
+    HaJsonToken HaJsonTokenizer::Close(bool array)
+    {
+        --depth_;
+        ++pos_;
+        text_   = nullptr;
+        expect_ = depth_ == 0U ? Expect::kDone : Expect::kCommaOrEnd;
+        return array ? HaJsonToken::kArrayEnd : HaJsonToken::kObjectEnd;
+    }
+
+    HaJsonToken HaJsonTokenizer::Scalar(HaJsonToken token)
+    {
+        expect_ = depth_ == 0U ? Expect::kDone : Expect::kCommaOrEnd;
+        return token;
+    }
+
+    HaJsonToken HaJsonTokenizer::Fail()
+    {
+        expect_ = Expect::kFailed;
+        text_   = nullptr;
+        return HaJsonToken::kError;
+    }
+
+    bool HaJsonTokenizer::ScanString()
+    {
+        const char* p = pos_ + 1;
+        escaped_      = false;
+        while (p < end_)
+        {
+            const char c = *p;
+            if (c == '"')
+            {
+                text_        = pos_ + 1;
+                text_length_ = static_cast<std::size_t>(p - text_);
+                pos_         = p + 1;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20U)
+            {
+                return false;
+            }
+            if (c != '\\')
+            {
+                ++p;
+                continue;
+            }
+            escaped_ = true;
+            if (end_ - p < 2)
+            {
+                return false;
+            }
+            if (p[1] == 'u')
+            {
+                std::uint32_t cp = 0U;
+                if (end_ - p < 6 || !ReadHex4(p + 2, cp))
+                {
+                    return false;
+                }
+                p += 6;
+            }
+            else if (std::strchr("\"\\/bfnrt", p[1]) != nullptr && p[1] != '\0')
+            {
+                p += 2;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool HaJsonTokenizer::ScanNumber()
+    {
+        const char* p = pos_;
+        if (p < end_ && *p == '-')
+        {
+            ++p;
+        }
+        if (p == end_ || !IsDigit(*p))
+        {
+            return false;
+        }
+        if (*p == '0')
+        {
+            ++p;
+        }
+        else
+        {
+            while (p < end_ && IsDigit(*p))
+            {
+                ++p;
+            }
+        }
+        if (p < end_ && *p == '.')
+        {
+            ++p;
+            if (p == end_ || !IsDigit(*p))
+            {
+                return false;
+            }
+            while (p < end_ && IsDigit(*p))
+            {
+                ++p;
+            }
+        }
+        if (p < end_ && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+            if (p < end_ && (*p == '+' || *p == '-'))
+            {
+                ++p;
+            }
+            if (p == end_ || !IsDigit(*p))
+            {
+                return false;
+            }
+            while (p < end_ && IsDigit(*p))
+            {
+                ++p;
+            }
+        }
+        text_        = pos_;
+        text_length_ = static_cast<std::size_t>(p - pos_);
+        escaped_     = false;
+        pos_         = p;
+        return true;
+    }
+
+    bool HaJsonTokenizer::ScanLiteral(std::string_view literal)
+    {
+        if (static_cast<std::size_t>(end_ - pos_) < literal.size()
+            || std::memcmp(pos_, literal.data(), literal.size()) != 0)
+        {
+            return false;
+        }
+        text_        = pos_;
+        text_length_ = literal.size();
+        escaped_     = false;
+        pos_        += literal.size();
+        return true;
+    }
+
+    void HaJsonTokenizer::SkipWhitespace()
+    {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t'))
+        {
+            ++pos_;
+        }
+    }
+
+    bool HaJsonTokenizer::InArray() const
+    {
+        return depth_ > 0U && ((array_bits_ >> (depth_ - 1U)) & 1U) != 0U;
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace custom::integration
+{
+
+    enum class HaJsonToken : std::uint8_t
+    {
+        kEnd,    // the whole document was consumed
+        kError,  // malformed input; every later Next() returns kError too
+        kObjectBegin,
+        kObjectEnd,
+        kArrayBegin,
+        kArrayEnd,
+        kKey,
+        kString,
+        kNumber,
+        kTrue,
+        kFalse,
+        kNull,
+    };
+
+    /**
+     * @brief Pull tokenizer for one JSON document held in memory.
+     *
+     * Each Next() returns the next token and never allocates: keys, strings and numbers are
+     * views into the input (Text()), with escapes left as they are until CopyText() decodes
+     * them into a caller buffer. Structure is validated as it goes (commas, colons, matching
+     * brackets, nesting up to kMaxDepth), so a truncated frame ends in kError rather than a
+     * half-read value. SkipValue() steps over a whole subtree, which is how callers ignore the
+     * parts of a message they do not need.
+     */
+    class HaJsonTokenizer
+    {
+    public:
+        static constexpr std::size_t kMaxDepth = 64U;
+
+        HaJsonTokenizer(const char* data, std::size_t length);
+
+        HaJsonToken Next();
+
+        /** Skip the next value (scalar or whole container). False on malformed input. */
+        bool SkipValue();
+
+        /** Raw text of the last key, string (without quotes) or number/literal token. */
+        std::string_view Text() const;
+
+        /**
+         * Decode the last key or string into @p out, NUL-terminated. False if it does not fit
+         * or holds an invalid escape; @p out is then an empty string.
+         */
+        bool CopyText(char* out, std::size_t capacity) const;
+
+        /** Value of the last kNumber token. */
+        bool NumberValue(double& value) const;
+
+        /** Containers currently open. */
+        std::size_t Depth() const;
+
+    private:
+        enum class Expect : std::uint8_t
+        {
+            kValue,
+            kKeyOrEnd,    // just after '{'
+            kValueOrEnd,  // just after '['
+            kCommaOrEnd,  // after a complete value inside a container
+            kDone,        // top-level value complete
+            kFailed,
+        };
+
+        HaJsonToken ReadKey();
+        HaJsonToken ReadValue();
+        HaJsonToken Open(bool array);
+        HaJsonToken Close(bool array);
+        HaJsonToken Scalar(HaJsonToken token);
+        HaJsonToken Fail();
+        bool        ScanString();
+        bool        ScanNumber();
+        bool        ScanLiteral(std::string_view literal);
+        void        SkipWhitespace();
+        bool        InArray() const;
+
+        const char*   pos_;
+        const char*   end_;
+        const char*   text_        = nullptr;
+        std::size_t   text_length_ = 0U;
+        bool          escaped_     = false;  // last string contains backslash escapes
+        std::size_t   depth_       = 0U;
+        std::uint64_t array_bits_  = 0U;  // bit n set: level n is an array
+        Expect        expect_      = Expect::kValue;
+    };
+
+}  // namespace custom::integration
@@ -0,0 +1,407 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_media_player.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "../app_trace.h"
+#include "cJSON.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kMediaPlayerTag = "ha-media";
+
+        const char* MediaStringAttribute(const cJSON* attributes, const char* key)
+        {
+            const cJSON* item = cJSON_GetObjectItemCaseSensitive(attributes, key);
+            return cJSON_IsString(item) ? item->valuestring : nullptr;
+        }
+
+        bool MediaNumberAttribute(const cJSON* attributes, const char* key, double& out)
+        {
+            const cJSON* item = cJSON_GetObjectItemCaseSensitive(attributes, key);
+            if (!cJSON_IsNumber(item))
+            {
+                return false;
+            }
+            out = item->valuedouble;
+            return true;
+        }
+
+        // Days from 1970-01-01 to a proleptic Gregorian date (H. Hinnant's days_from_civil)
+        std::int64_t DaysFromCivil(int year, int month, int day)
+        {
+            year -= month <= 2 ? 1 : 0;
+            const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+            const int          yoe = static_cast<int>(year - era * 400);
+            const int          doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const int          doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + doe - 719468;
+        }
+
+        /** "2025-01-01T12:00:03.123456+00:00" (or "...Z") -> epoch seconds. */
+        bool ParseMediaTimestamp(const char* text, double& epoch_s)
+        {
+            int    year     = 0;
+            int    month    = 0;
+            int    day      = 0;
+            int    hour     = 0;
+            int    minute   = 0;
+            double second   = 0.0;
+            int    consumed = 0;
+            if (text == nullptr
+                || std::sscanf(text,
+                               "%4d-%2d-%2dT%2d:%2d:%lf%n",
+                               &year,
+                               &month,
+                               &day,
+                               &hour,
+                               &minute,
+                               &second,
+                               &consumed)
+                       != 6)
+            {
+                return false;
+            }
+            const double days    = static_cast<double>(DaysFromCivil(year, month, day));
+            double       seconds = days * 86400.0 + hour * 3600.0 + minute * 60.0 + second;
+            const char*  zone    = text + consumed;
+            if (*zone == '+' || *zone == '-')
+            {
+                int zone_hours   = 0;
+                int zone_minutes = 0;
+                if (std::sscanf(zone + 1, "%2d:%2d", &zone_hours, &zone_minutes) != 2)
+                {
+                    return false;
+                }
+                const double offset = zone_hours * 3600.0 + zone_minutes * 60.0;
+                seconds += *zone == '+' ? -offset : offset;
+            }
+            else if (*zone != 'Z' && *zone != '\0')
+            {
+                return false;
+            }
+            epoch_s = seconds;
+            return true;
+        }
+
+    }  // namespace
+
+    bool HaMediaView::operator==(const HaMediaView& other) const
+    {
+        return available == other.available && playing == other.playing && title == other.title
+               && artist == other.artist && source == other.source && volume == other.volume
+               && position_s == other.position_s && duration_s == other.duration_s
+               && artwork_url == other.artwork_url;
+    }
+
+    bool HaMediaView::operator!=(const HaMediaView& other) const
+    {
+        return !(*this == other);
+    }
+
+    HaMediaPlayer::HaMediaPlayer(std::string entity_id, Clock clock_ms) :
+        entity_id_(std::move(entity_id)), clock_ms_(std::move(clock_ms))
+    {
+    }
+
+    const std::string& HaMediaPlayer::EntityId() const
+    {
+        return entity_id_;
+    }
+
+    void HaMediaPlayer::Attach(HaWsClient* client)
+    {
+        client_ = client;
+        if (client_ != nullptr)
+        {
+            client_->AddObserver(entity_id_, this);
+        }
+    }
+
+    void HaMediaPlayer::SetPictureBase(std::string base_url)
+    {
+        while (!base_url.empty() && base_url.back() == '/')
+        {
+            base_url.pop_back();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        picture_base_ = std::move(base_url);
+    }
+
+    HaMediaView HaMediaPlayer::View(std::uint32_t now_ms) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ViewLocked(now_ms);
+    }
+
+    bool HaMediaPlayer::TakeViewIfChanged(std::uint32_t now_ms, HaMediaView& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        HaMediaView                 view = ViewLocked(now_ms);
+        if (taken_ && view == last_taken_)
+        {
+            return false;
+        }
+        last_taken_ = view;
+        taken_      = true;
+        out         = std::move(view);
+        return true;
+    }
+
+    bool HaMediaPlayer::PlayPause(std::uint32_t now_ms)
+    {
+        bool   playing  = false;
+        double position = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!confirmed_.available)
+            {
+                return false;
+            }
+            playing  = !ShownPlaying(now_ms);
+            position = ShownPosition(now_ms);
+        }
+
+        // Explicit play or pause rather than media_play_pause: a toggle that crosses a
+        // change made elsewhere would undo it
+        if (!Call(playing ? "media_play" : "media_pause"))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.has_playing = true;
+        pending_.playing     = playing;
+        pending_.position_s  = position;
+        pending_.anchor_ms   = now_ms;
+        pending_.until_ms    = now_ms + kOptimisticHoldMs;
+        APP_TRACEI(kMediaPlayerTag, playing ? "play %s" : "pause %s", entity_id_.c_str());
+        return true;
+    }
+
+    bool HaMediaPlayer::Next()
+    {
+        return Call("media_next_track");
+    }
+
+    bool HaMediaPlayer::Previous()
+    {
+        return Call("media_previous_track");
+    }
+
+    bool HaMediaPlayer::SetVolume(std::uint8_t percent, std::uint32_t now_ms)
+    {
+        if (percent > 100U)
+        {
+            percent = 100U;
+        }
+        if (!Call("volume_set", "volume_level", percent / 100.0))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.has_volume = true;
+        pending_.volume     = percent;
+        pending_.until_ms   = now_ms + kOptimisticHoldMs;
+        return true;
+    }
+
+    void HaMediaPlayer::OnEntityState(const cJSON* new_state, const char* time_fired)
+    {
+        const std::uint32_t         now_ms = clock_ms_();
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Server time now: time_fired itself, or the local clock moved onto the server's
+        bool   have_server_now = false;
+        double server_now_s    = 0.0;
+        if (ParseMediaTimestamp(time_fired, server_now_s))
+        {
+            server_offset_s_    = server_now_s - now_ms / 1000.0;
+            have_server_offset_ = true;
+            have_server_now     = true;
+        }
+        else if (have_server_offset_)
+        {
+            server_now_s    = now_ms / 1000.0 + server_offset_s_;
+            have_server_now = true;
+        }
+
+        if (new_state == nullptr)
+        {
+            // Removed, or missing from the snapshot
+            confirmed_         = HaMediaView();
+            anchor_position_s_ = 0.0;
+            pending_           = Pending();
+            return;
+        }
+
+        const cJSON* state_item = cJSON_GetObjectItemCaseSensitive(new_state, "state");
+        const cJSON* attributes = cJSON_GetObjectItemCaseSensitive(new_state, "attributes");
+        const char*  state      = cJSON_IsString(state_item) ? state_item->valuestring : "unknown";
+
+        HaMediaView view;
+        view.available =
+            std::strcmp(state, "unavailable") != 0 && std::strcmp(state, "unknown") != 0;
+        view.playing = std::strcmp(state, "playing") == 0;
+
+        const char* title  = MediaStringAttribute(attributes, "media_title");
+        const char* artist = MediaStringAttribute(attributes, "media_artist");
+        const char* app    = MediaStringAttribute(attributes, "app_name");
+        const char* input  = MediaStringAttribute(attributes, "source");
+        const char* name   = MediaStringAttribute(attributes, "friendly_name");
+        view.title         = title != nullptr ? title : "";
+        view.artist        = artist != nullptr ? artist : "";
+        // "Spotify · Living Room", as the built-in tracks read
+        view.source = app != nullptr ? app : (input != nullptr ? input : "");
+        if (name != nullptr)
+        {
+            view.source += view.source.empty() ? name : std::string(" · ") + name;
+        }
+
+        // entity_picture is usually the media proxy, a path on Home Assistant itself
+        const char* picture = MediaStringAttribute(attributes, "entity_picture");
+        if (picture != nullptr && picture[0] != '\0')
+        {
+            const bool absolute = std::strncmp(picture, "http://", 7) == 0
+                                  || std::strncmp(picture, "https://", 8) == 0;
+            if (absolute)
+            {
+                view.artwork_url = picture;
+            }
+            else if (!picture_base_.empty())
+            {
+                view.artwork_url = picture_base_ + (picture[0] == '/' ? "" : "/") + picture;
+            }
+        }
+
+        double number = 0.0;
+        if (MediaNumberAttribute(attributes, "volume_level", number))
+        {
+            number      = number < 0.0 ? 0.0 : (number > 1.0 ? 1.0 : number);
+            view.volume = static_cast<std::uint8_t>(std::lround(number * 100.0));
+        }
+        if (MediaNumberAttribute(attributes, "media_duration", number) && number > 0.0)
+        {
+            view.duration_s = static_cast<std::uint32_t>(number);
+        }
+
+        // The position was true at media_position_updated_at, not now
+        double position = 0.0;
+        if (MediaNumberAttribute(attributes, "media_position", number) && number > 0.0)
+        {
+            position = number;
+        }
+        double updated_s = 0.0;
+        if (view.playing && have_server_now
+            && ParseMediaTimestamp(MediaStringAttribute(attributes, "media_position_updated_at"),
+                                   updated_s))
+        {
+            if (server_now_s > updated_s)
+            {
+                position += server_now_s - updated_s;
+            }
+        }
+
+        confirmed_         = std::move(view);
+        anchor_position_s_ = position;
+        anchor_ms_         = now_ms;
+
+        // A command is confirmed once Home Assistant shows its effect
+        if (pending_.has_playing && pending_.playing == confirmed_.playing)
+        {
+            pending_.has_playing = false;
+        }
+        if (pending_.has_volume && pending_.volume == confirmed_.volume)
+        {
+            pending_.has_volume = false;
+        }
+    }
+
+    void HaMediaPlayer::OnEntityUnavailable()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        confirmed_.available = false;
+        confirmed_.playing   = false;
+        anchor_position_s_   = 0.0;
+        pending_             = Pending();
+    }
+
+    bool HaMediaPlayer::Call(const char* service, const char* number_key, double number)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!confirmed_.available)
+            {
+                return false;
+            }
+        }
+        if (client_ == nullptr)
+        {
+            return false;
+        }
+        HaServiceCall call;
+        call.entity_id  = entity_id_;
+        call.service    = service;
+        call.number_key = number_key;
+        call.number     = number;
+        return client_->CallService(call) != 0U;
+    }
+
+    bool HaMediaPlayer::PendingLive(std::uint32_t now_ms) const
+    {
+        return (pending_.has_playing || pending_.has_volume)
+               && static_cast<std::int32_t>(now_ms - pending_.until_ms) < 0;
+    }
+
+    bool HaMediaPlayer::ShownPlaying(std::uint32_t now_ms) const
+    {
+        return PendingLive(now_ms) && pending_.has_playing ? pending_.playing : confirmed_.playing;
+    }
+
+    double HaMediaPlayer::ShownPosition(std::uint32_t now_ms) const
+    {
+        double        position  = anchor_position_s_;
+        bool          playing   = confirmed_.playing;
+        std::uint32_t anchor_ms = anchor_ms_;
+        if (PendingLive(now_ms) && pending_.has_playing)
+        {
+            position  = pending_.position_s;
+            playing   = pending_.playing;
+            anchor_ms = pending_.anchor_ms;
+        }
+        if (playing)
+        {
+            position += static_cast<std::uint32_t>(now_ms - anchor_ms) / 1000.0;
+        }
+        if (confirmed_.duration_s > 0U && position > confirmed_.duration_s)
+        {
+            position = confirmed_.duration_s;
+        }
+        return position;
+    }
+
+    HaMediaView HaMediaPlayer::ViewLocked(std::uint32_t now_ms) const
+    {
+        HaMediaView view = confirmed_;
+        view.playing     = ShownPlaying(now_ms);
+        view.position_s  = static_cast<std::uint32_t>(ShownPosition(now_ms));
+        if (PendingLive(now_ms) && pending_.has_volume)
+        {
+            view.volume = pending_.volume;
+        }
+        return view;
+    }
+
+}  // namespace custom::integration
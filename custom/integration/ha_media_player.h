@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "integration/ha_ws_client.h"
+
+namespace custom::integration
+{
+
+    /** What the media page shows of a media_player, position already interpolated. */
+    struct HaMediaView
+    {
+        bool          available = false;
+        bool          playing   = false;
+        std::string   title;
+        std::string   artist;
+        std::string   source;
+        std::uint8_t  volume     = 0U;  // percent
+        std::uint32_t position_s = 0U;
+        std::uint32_t duration_s = 0U;  // 0 when unknown, e.g. a radio stream
+        std::string   artwork_url;      // absolute; empty when there is no cover
+
+        bool operator==(const HaMediaView& other) const;
+        bool operator!=(const HaMediaView& other) const;
+    };
+
+    /**
+     * @brief Follows one Home Assistant media_player entity and sends its transport commands.
+     *
+     * Home Assistant reports media_position only with the time it was taken
+     * (media_position_updated_at) and does not push it again while the track plays. The player
+     * anchors the reported position to the local clock, corrected by how long ago it was
+     * taken, and View() moves it forward from there. The progress bar therefore advances every
+     * second with no network traffic. The server clock is learned from the time_fired of each
+     * event; a snapshot received before the first event is taken at face value.
+     *
+     * Play/pause and volume show at once and are confirmed by the next state_changed. If
+     * nothing confirms them within 5 s, the view falls back to the last state Home Assistant
+     * reported, as HaCommandQueue does for room toggles.
+     *
+     * State arrives on the socket task and View() is read from the UI task; a mutex keeps the
+     * two apart. Commands may be sent from the UI task.
+     */
+    class HaMediaPlayer : public HaEntityObserver
+    {
+    public:
+        /** Monotonic milliseconds, e.g. lv_tick_get(); wraps like it. */
+        using Clock = std::function<std::uint32_t()>;
+
+        static constexpr std::uint32_t kOptimisticHoldMs = 5000U;
+
+        HaMediaPlayer(std::string entity_id, Clock clock_ms);
+
+        HaMediaPlayer(const HaMediaPlayer&)            = delete;
+        HaMediaPlayer& operator=(const HaMediaPlayer&) = delete;
+
+        const std::string& EntityId() const;
+
+        /** Observe the entity on @p client and send commands through it. Before it connects. */
+        void Attach(HaWsClient* client);
+        /**
+         * The Home Assistant URL, e.g. "http://homeassistant.local:8123", that relative
+         * entity_picture paths (the media proxy) are resolved against. Before it connects.
+         */
+        void SetPictureBase(std::string base_url);
+
+        HaMediaView View(std::uint32_t now_ms) const;
+        /** Copy the view to @p out if anything shown differs from the last one taken. */
+        bool TakeViewIfChanged(std::uint32_t now_ms, HaMediaView& out);
+
+        /** False when the command could not be sent (not connected, entity unavailable). */
+        bool PlayPause(std::uint32_t now_ms);
+        bool Next();
+        bool Previous();
+        bool SetVolume(std::uint8_t percent, std::uint32_t now_ms);
+
+        // HaEntityObserver, on the socket task
+        void OnEntityState(const cJSON* new_state, const char* time_fired) override;
+        void OnEntityUnavailable() override;
+
+    private:
+        struct Pending
+        {
+            std::uint32_t until_ms    = 0U;
+            bool          has_playing = false;
+            bool          playing     = false;
+            double        position_s  = 0.0;  // where the optimistic play/pause took over
+            std::uint32_t anchor_ms   = 0U;
+            bool          has_volume  = false;
+            std::uint8_t  volume      = 0U;
+        };
+
+        bool Call(const char* service, const char* number_key = nullptr, double number = 0.0);
+
+        // mutex_ held
+        bool        PendingLive(std::uint32_t now_ms) const;
+        bool        ShownPlaying(std::uint32_t now_ms) const;
+        double      ShownPosition(std::uint32_t now_ms) const;
+        HaMediaView ViewLocked(std::uint32_t now_ms) const;
+
+        const std::string  entity_id_;
+        const Clock        clock_ms_;
+        HaWsClient*        client_ = nullptr;
+        std::string        picture_base_;
+        mutable std::mutex mutex_;
+        HaMediaView        confirmed_;  // position_s unused; see anchor_position_s_
+        double             anchor_position_s_  = 0.0;
+        std::uint32_t      anchor_ms_          = 0U;
+        bool               have_server_offset_ = false;
+        double             server_offset_s_    = 0.0;  // server epoch seconds - local seconds
+        Pending            pending_;
+        HaMediaView        last_taken_;
+        bool               taken_ = false;
+    };
+
+}  // namespace custom::integration
@@ -0,0 +1,298 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_state_event.h"
+
+#include <string_view>
+
+#include "integration/ha_json_tokenizer.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        // kStateChanged doubles as "fine so far" while walking the message
+        constexpr HaFrameKind kContinue = HaFrameKind::kStateChanged;
+
+        /** Copy the next value into @p out; it must be a string that fits. */
+        HaFrameKind TakeString(HaJsonTokenizer& json, char* out, std::size_t capacity)
+        {
+            const HaJsonToken token = json.Next();
+            if (token == HaJsonToken::kError)
+            {
+                return HaFrameKind::kMalformed;
+            }
+            if (token != HaJsonToken::kString || !json.CopyText(out, capacity))
+            {
+                return HaFrameKind::kOther;
+            }
+            return kContinue;
+        }
+
+        /** Step over the value of the key just read. */
+        HaFrameKind SkipEntry(HaJsonTokenizer& json)
+        {
+            return json.SkipValue() ? kContinue : HaFrameKind::kMalformed;
+        }
+
+        /** A value that had to be a scalar: containers mean this is not a frame we decode. */
+        HaFrameKind CheckScalar(HaJsonToken token)
+        {
+            if (token == HaJsonToken::kError)
+            {
+                return HaFrameKind::kMalformed;
+            }
+            if (token == HaJsonToken::kObjectBegin || token == HaJsonToken::kArrayBegin)
+            {
+                return HaFrameKind::kOther;
+            }
+            return kContinue;
+        }
+
+        /**
+         * Open the object that is the next value. @p present is false when the value is a
+         * scalar instead, such as null.
+         */
+        HaFrameKind EnterObject(HaJsonTokenizer& json, bool& present)
+        {
+            const HaJsonToken token = json.Next();
+            present                 = token == HaJsonToken::kObjectBegin;
+            return present ? kContinue : CheckScalar(token);
+        }
+
+        /**
+         * Read the next key of the object just entered into @p key. Returns false at the end of
+         * the object or on error (@p result says which).
+         */
+        bool NextKey(HaJsonTokenizer& json, std::string_view& key, HaFrameKind& result)
+        {
+            const HaJsonToken token = json.Next();
+            if (token == HaJsonToken::kKey)
+            {
+                key = json.Text();
+                return true;
+            }
+            result = token == HaJsonToken::kObjectEnd ? kContinue : HaFrameKind::kMalformed;
+            return false;
+        }
+
+        HaFrameKind DecodeAttributes(HaJsonTokenizer& json, HaStateChanged& out)
+        {
+            bool        present = false;
+            HaFrameKind result  = EnterObject(json, present);
+            if (result != kContinue || !present)
+            {
+                return result;
+            }
+            std::string_view key;
+            while (NextKey(json, key, result))
+            {
+                if (key != "brightness")
+                {
+                    result = SkipEntry(json);
+                }
+                else
+                {
+                    // null while the light is off
+                    const HaJsonToken token = json.Next();
+                    double            value = 0.0;
+                    result                  = CheckScalar(token);
+                    if (token == HaJsonToken::kNumber && json.NumberValue(value) && value >= 0.0
+                        && value <= 255.0)
+                    {
+                        out.brightness = static_cast<std::int32_t>(value);
+                    }
+                }
+                if (result != kContinue)
+                {
+                    return result;
+                }
+            }
+            return result;
+        }
+
+        HaFrameKind DecodeNewState(HaJsonTokenizer& json, HaStateChanged& out, bool& has_state)
+        {
+            bool        present = false;
+            HaFrameKind result  = EnterObject(json, present);
+            if (result != kContinue)
+            {
+                return result;
+            }
+            if (!present)
+            {
+                // null when the entity was removed
+                out.removed = true;
+                has_state   = true;
+                return kContinue;
+            }
+            std::string_view key;
+            while (NextKey(json, key, result))
+            {
+                if (key == "state")
+                {
+                    result    = TakeString(json, out.state, sizeof(out.state));
+                    has_state = result == kContinue;
+                }
+                else if (key == "attributes")
+                {
+                    result = DecodeAttributes(json, out);
+                }
+                else
+                {
+                    result = SkipEntry(json);
+                }
+                if (result != kContinue)
+                {
+                    return result;
+                }
+            }
+            return result;
+        }
+
+        HaFrameKind DecodeEventData(HaJsonTokenizer& json, HaStateChanged& out, bool& has_state)
+        {
+            bool        present = false;
+            HaFrameKind result  = EnterObject(json, present);
+            if (result != kContinue || !present)
+            {
+                return result;
+            }
+            std::string_view key;
+            while (NextKey(json, key, result))
+            {
+                if (key == "entity_id")
+                {
+                    result = TakeString(json, out.entity_id, sizeof(out.entity_id));
+                }
+                else if (key == "new_state")
+                {
+                    result = DecodeNewState(json, out, has_state);
+                }
+                else
+                {
+                    // old_state is as large as new_state and of no use here
+                    result = SkipEntry(json);
+                }
+                if (result != kContinue)
+                {
+                    return result;
+                }
+            }
+            return result;
+        }
+
+        HaFrameKind DecodeEvent(HaJsonTokenizer& json, HaStateChanged& out, bool& has_state)
+        {
+            bool        present = false;
+            HaFrameKind result  = EnterObject(json, present);
+            if (result != kContinue || !present)
+            {
+                return result;
+            }
+            std::string_view key;
+            while (NextKey(json, key, result))
+            {
+                if (key == "event_type")
+                {
+                    const HaJsonToken token = json.Next();
+                    if (token == HaJsonToken::kError)
+                    {
+                        return HaFrameKind::kMalformed;
+                    }
+                    if (token != HaJsonToken::kString || json.Text() != "state_changed")
+                    {
+                        return HaFrameKind::kOther;
+                    }
+                }
+                else if (key == "data")
+                {
+                    result = DecodeEventData(json, out, has_state);
+                }
+                else
+                {
+                    result = SkipEntry(json);
+                }
+                if (result != kContinue)
+                {
+                    return result;
+                }
+            }
+            return result;
+        }
+
+    }  // namespace
+
+    HaFrameKind HaDecodeStateChanged(const char* data, std::size_t length, HaStateChanged& out)
+    {
+        out.id           = 0U;
+        out.entity_id[0] = '\0';
+        out.removed      = false;
+        out.state[0]     = '\0';
+        out.brightness   = -1;
+
+        HaJsonTokenizer json(data, length);
+        if (json.Next() != HaJsonToken::kObjectBegin)
+        {
+            return HaFrameKind::kMalformed;
+        }
+
+        bool             is_event  = false;
+        bool             has_state = false;
+        HaFrameKind      result    = kContinue;
+        std::string_view key;
+        while (NextKey(json, key, result))
+        {
+            if (key == "type")
+            {
+                const HaJsonToken token = json.Next();
+                if (token == HaJsonToken::kError)
+                {
+                    return HaFrameKind::kMalformed;
+                }
+                if (token != HaJsonToken::kString || json.Text() != "event")
+                {
+                    // auth_required, result, pong, ...: not worth tokenizing further
+                    return HaFrameKind::kOther;
+                }
+                is_event = true;
+            }
+            else if (key == "id")
+            {
+                const HaJsonToken token = json.Next();
+                double            id    = 0.0;
+                result                  = CheckScalar(token);
+                if (token == HaJsonToken::kNumber && json.NumberValue(id) && id >= 0.0)
+                {
+                    out.id = static_cast<std::uint32_t>(id);
+                }
+            }
+            else if (key == "event")
+            {
+                result = DecodeEvent(json, out, has_state);
+            }
+            else
+            {
+                result = SkipEntry(json);
+            }
+            if (result != kContinue)
+            {
+                return result;
+            }
+        }
+        if (result != kContinue || json.Next() != HaJsonToken::kEnd)
+        {
+            return HaFrameKind::kMalformed;
+        }
+        if (!is_event || !has_state || out.entity_id[0] == '\0')
+        {
+            return HaFrameKind::kOther;
+        }
+        return HaFrameKind::kStateChanged;
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace custom::integration
+{
+
+    /** The parts of a state_changed event the rooms page uses, in fixed-size buffers. */
+    struct HaStateChanged
+    {
+        static constexpr std::size_t kEntityIdSize = 128U;  // including the NUL
+        static constexpr std::size_t kStateSize    = 256U;  // Home Assistant caps states at 255
+
+        std::uint32_t id = 0U;  // subscription id of the event message
+        char          entity_id[kEntityIdSize];
+        bool          removed = false;  // new_state was null
+        char          state[kStateSize];
+        std::int32_t  brightness = -1;  // light attribute 0..255, -1 if absent
+    };
+
+    enum class HaFrameKind : std::uint8_t
+    {
+        kStateChanged,  // @p out is filled in
+        kOther,         // valid start but not a state_changed event (or too large to decode)
+        kMalformed,
+    };
+
+    /**
+     * @brief Decode a Home Assistant WebSocket frame if it is a state_changed event.
+     *
+     * Pulls tokens with HaJsonTokenizer and copies only entity_id, new_state.state and
+     * new_state.attributes.brightness; old_state, context and every other attribute are
+     * skipped without being decoded. Nothing is allocated. Stops at the top-level "type" key
+     * when it is not "event", so results and auth frames cost a few tokens before the caller
+     * hands them to a DOM parser.
+     */
+    HaFrameKind HaDecodeStateChanged(const char* data, std::size_t length, HaStateChanged& out);
+
+}  // namespace custom::integration
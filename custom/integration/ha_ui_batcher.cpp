@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_ui_batcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace custom::integration
+{
+
+    HaUiBatcher::HaUiBatcher(HaEntityStore& store, ScheduleFlush schedule, ApplyRoom apply) :
+        store_(store), schedule_(std::move(schedule)), apply_(std::move(apply))
+    {
+    }
+
+    void HaUiBatcher::MarkChanged()
+    {
+        changes_.fetch_add(1U, std::memory_order_relaxed);
+        if (!pending_.exchange(true) && schedule_)
+        {
+            schedule_();
+        }
+    }
+
+    std::size_t HaUiBatcher::Flush()
+    {
+        // Clear the flag before reading the store: a change that lands after this point
+        // schedules another flush rather than being left behind until the next one
+        pending_.store(false);
+        stats_.flushes++;
+
+        const std::size_t count = store_.PublishChanged(changed_rooms_);
+        if (count == 0U)
+        {
+            stats_.empty_passes++;
+            return 0U;
+        }
+        if (apply_)
+        {
+            for (const room_t* room : changed_rooms_)
+            {
+                apply_(*room);
+            }
+        }
+        const auto rooms = static_cast<std::uint32_t>(count);
+        stats_.rooms    += rooms;
+        stats_.max_rooms = std::max(stats_.max_rooms, rooms);
+        return count;
+    }
+
+    HaUiBatcher::Stats HaUiBatcher::GetStats() const
+    {
+        Stats stats   = stats_;
+        stats.changes = changes_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+}  // namespace custom::integration
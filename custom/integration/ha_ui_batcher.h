@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+
+namespace custom::integration
+{
+
+    /**
+     * @brief Coalesces entity store changes into at most one UI update per frame.
+     *
+     * The network task calls MarkChanged() after every delta that changed the store. Only the
+     * first call after a flush asks the UI thread for work (via lv_async_call on the device),
+     * so a scene that changes hundreds of entities costs one callback. Flush() then publishes
+     * the rooms touched since the last flush and hands each one to the room callback. Cards of
+     * rooms that did not change are left alone.
+     */
+    class HaUiBatcher
+    {
+    public:
+        /** Arrange for Flush() to run once on the UI thread; called from the network task. */
+        using ScheduleFlush = std::function<void()>;
+        /** Refresh the card of one changed room; called from Flush() on the UI thread. */
+        using ApplyRoom = std::function<void(const room_t& room)>;
+
+        struct Stats
+        {
+            std::uint32_t changes      = 0U;  // MarkChanged() calls
+            std::uint32_t flushes      = 0U;  // scheduled flushes that ran
+            std::uint32_t rooms        = 0U;  // room cards updated
+            std::uint32_t max_rooms    = 0U;  // most cards updated by one flush
+            std::uint32_t empty_passes = 0U;  // flushes that found nothing left to do
+        };
+
+        HaUiBatcher(HaEntityStore& store, ScheduleFlush schedule, ApplyRoom apply);
+
+        HaUiBatcher(const HaUiBatcher&)            = delete;
+        HaUiBatcher& operator=(const HaUiBatcher&) = delete;
+
+        /** Thread-safe; schedules a flush unless one is already pending. */
+        void MarkChanged();
+
+        /** UI thread only. Returns the number of room cards updated. */
+        std::size_t Flush();
+
+        /** UI thread only. */
+        Stats GetStats() const;
+
+    private:
+        HaEntityStore&             store_;
+        ScheduleFlush              schedule_;
+        ApplyRoom                  apply_;
+        std::atomic<bool>          pending_{false};
+        std::atomic<std::uint32_t> changes_{0U};
+        std::vector<const room_t*> changed_rooms_;  // reused, so a flush does not allocate
+        Stats                      stats_;
+    };
+
+}  // namespace custom::integration
@@ -0,0 +1,455 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_ws_client.h"
+
+#include <cstring>
+#include <utility>
+
+#include "../app_trace.h"
+#include "cJSON.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kWsClientTag = "ha-ws-client";
+
+        // Bounded so a snapshot that never arrives cannot grow the backlog forever
+        constexpr std::size_t kMaxEarlyDeltas = 256U;
+
+        const char* StringField(const cJSON* object, const char* key)
+        {
+            const cJSON* item = cJSON_GetObjectItemCaseSensitive(object, key);
+            return cJSON_IsString(item) ? item->valuestring : nullptr;
+        }
+
+        bool DecodeStateObject(const cJSON* object, HaEntityUpdate& out)
+        {
+            const char* entity_id = StringField(object, "entity_id");
+            const char* state     = StringField(object, "state");
+            if (entity_id == nullptr || state == nullptr)
+            {
+                return false;
+            }
+            out.entity_id  = entity_id;
+            out.state      = state;
+            out.brightness = -1;
+
+            const cJSON* attributes = cJSON_GetObjectItemCaseSensitive(object, "attributes");
+            const cJSON* brightness = cJSON_GetObjectItemCaseSensitive(attributes, "brightness");
+            if (cJSON_IsNumber(brightness))
+            {
+                out.brightness = static_cast<std::int32_t>(brightness->valuedouble);
+            }
+            return true;
+        }
+
+        std::string PrintAndDelete(cJSON* object)
+        {
+            std::string text;
+            char*       printed = cJSON_PrintUnformatted(object);
+            if (printed != nullptr)
+            {
+                text = printed;
+                cJSON_free(printed);
+            }
+            cJSON_Delete(object);
+            return text;
+        }
+
+    }  // namespace
+
+    std::string HaWebSocketUrl(const std::string& base_url)
+    {
+        std::string url = base_url;
+        if (url.compare(0, 8, "https://") == 0)
+        {
+            url.replace(0, 5, "wss");
+        }
+        else if (url.compare(0, 7, "http://") == 0)
+        {
+            url.replace(0, 4, "ws");
+        }
+        while (!url.empty() && url.back() == '/')
+        {
+            url.pop_back();
+        }
+        return url + "/api/websocket";
+    }
+
+    HaWsClient::HaWsClient(HaWsTransport& transport,
+                           HaEntityStore& store,
+                           std::string    access_token) :
+        transport_(transport), store_(store), access_token_(std::move(access_token))
+    {
+    }
+
+    void HaWsClient::SetChangeCallback(std::function<void()> callback)
+    {
+        on_change_ = std::move(callback);
+    }
+
+    void HaWsClient::SetCommandResultCallback(std::function<void(std::uint32_t, bool)> callback)
+    {
+        on_command_result_ = std::move(callback);
+    }
+
+    void HaWsClient::AddObserver(std::string entity_id, HaEntityObserver* observer)
+    {
+        if (observer != nullptr)
+        {
+            observed_.push_back(Observed{std::move(entity_id), observer, std::string()});
+        }
+    }
+
+    void HaWsClient::OnConnected()
+    {
+        // The server speaks first (auth_required); ids restart with every connection
+        state_         = State::kAuthenticating;
+        next_id_       = 1U;
+        subscribe_id_  = 0U;
+        get_states_id_ = 0U;
+        early_deltas_.clear();
+        for (Observed& observed : observed_)
+        {
+            observed.early_frame.clear();
+        }
+    }
+
+    void HaWsClient::OnDisconnected()
+    {
+        if (state_ == State::kDisconnected)
+        {
+            return;
+        }
+        const bool was_synced = state_ == State::kLive;
+        state_                = State::kDisconnected;
+        early_deltas_.clear();
+        for (Observed& observed : observed_)
+        {
+            observed.early_frame.clear();
+        }
+        if (was_synced)
+        {
+            store_.MarkAllUnavailable();
+            for (Observed& observed : observed_)
+            {
+                observed.observer->OnEntityUnavailable();
+            }
+            NotifyChanged();
+        }
+    }
+
+    void HaWsClient::OnText(const char* data, std::size_t length)
+    {
+        stats_.messages++;
+        switch (HaDecodeStateChanged(data, length, event_))
+        {
+            case HaFrameKind::kStateChanged:
+                if (Observed* observed = FindObserved(event_.entity_id))
+                {
+                    HandleObservedEvent(*observed, data, length);
+                }
+                HandleStateChanged(event_);
+                return;
+            case HaFrameKind::kMalformed:
+                stats_.parse_errors++;
+                return;
+            case HaFrameKind::kOther:
+                break;
+        }
+
+        stats_.dom_parses++;
+        cJSON* message = cJSON_ParseWithLength(data, length);
+        if (message == nullptr)
+        {
+            stats_.parse_errors++;
+            return;
+        }
+
+        const char* type = StringField(message, "type");
+        if (type == nullptr)
+        {
+            stats_.parse_errors++;
+        }
+        else if (std::strcmp(type, "result") == 0)
+        {
+            HandleResult(message);
+        }
+        else if (std::strcmp(type, "auth_required") == 0)
+        {
+            cJSON* auth = cJSON_CreateObject();
+            cJSON_AddStringToObject(auth, "type", "auth");
+            cJSON_AddStringToObject(auth, "access_token", access_token_.c_str());
+            Send(PrintAndDelete(auth));
+        }
+        else if (std::strcmp(type, "auth_ok") == 0)
+        {
+            HandleAuthOk();
+        }
+        else if (std::strcmp(type, "auth_invalid") == 0)
+        {
+            state_ = State::kAuthFailed;
+            APP_LOG_WARN(kWsClientTag, "authentication rejected, check the access token");
+        }
+        cJSON_Delete(message);
+    }
+
+    void HaWsClient::HandleAuthOk()
+    {
+        state_ = State::kSyncing;
+
+        // Subscribe before the snapshot so no change can fall between the two
+        subscribe_id_    = next_id_++;
+        cJSON* subscribe = cJSON_CreateObject();
+        cJSON_AddNumberToObject(subscribe, "id", subscribe_id_);
+        cJSON_AddStringToObject(subscribe, "type", "subscribe_events");
+        cJSON_AddStringToObject(subscribe, "event_type", "state_changed");
+        if (!Send(PrintAndDelete(subscribe)))
+        {
+            return;
+        }
+
+        get_states_id_    = next_id_++;
+        cJSON* get_states = cJSON_CreateObject();
+        cJSON_AddNumberToObject(get_states, "id", get_states_id_);
+        cJSON_AddStringToObject(get_states, "type", "get_states");
+        Send(PrintAndDelete(get_states));
+    }
+
+    void HaWsClient::HandleResult(const cJSON* message)
+    {
+        const cJSON* id      = cJSON_GetObjectItemCaseSensitive(message, "id");
+        const cJSON* success = cJSON_GetObjectItemCaseSensitive(message, "success");
+        if (!cJSON_IsNumber(id))
+        {
+            stats_.parse_errors++;
+            return;
+        }
+        const auto request = static_cast<std::uint32_t>(id->valueint);
+        if (request != subscribe_id_ && request != get_states_id_)
+        {
+            // Anything else is a command
+            if (on_command_result_)
+            {
+                on_command_result_(request, cJSON_IsTrue(success));
+            }
+            return;
+        }
+        if (!cJSON_IsTrue(success))
+        {
+            APP_LOG_WARN(kWsClientTag, "request %d failed", id->valueint);
+            return;
+        }
+        if (request != get_states_id_ || state_ != State::kSyncing)
+        {
+            return;
+        }
+
+        const cJSON*   states = cJSON_GetObjectItemCaseSensitive(message, "result");
+        const cJSON*   object = nullptr;
+        HaEntityUpdate update;
+        cJSON_ArrayForEach(object, states)
+        {
+            if (DecodeStateObject(object, update))
+            {
+                store_.Apply(update);
+            }
+        }
+        for (const HaEntityUpdate& early : early_deltas_)
+        {
+            store_.Apply(early);
+        }
+        early_deltas_.clear();
+
+        state_ = State::kLive;
+        DispatchSnapshot(states);
+        stats_.snapshots++;
+        APP_LOG_INFO(
+            kWsClientTag, "snapshot applied, tracking %u entities", (unsigned)store_.EntityCount());
+        NotifyChanged();
+    }
+
+    void HaWsClient::HandleStateChanged(const HaStateChanged& event)
+    {
+        if (event.id != subscribe_id_)
+        {
+            return;
+        }
+        if (!store_.Tracks(event.entity_id))
+        {
+            // Most of the firehose ends here
+            stats_.deltas_ignored++;
+            return;
+        }
+
+        // new_state is null when the entity was removed
+        const char* state = event.removed ? "unavailable" : event.state;
+        if (state_ == State::kSyncing)
+        {
+            if (early_deltas_.size() < kMaxEarlyDeltas)
+            {
+                early_deltas_.push_back(HaEntityUpdate{event.entity_id, state, event.brightness});
+            }
+            return;
+        }
+        if (state_ != State::kLive)
+        {
+            return;
+        }
+        if (!store_.Apply(event.entity_id, state, event.brightness))
+        {
+            stats_.deltas_ignored++;
+            return;
+        }
+        stats_.deltas_applied++;
+        NotifyChanged();
+    }
+
+    void HaWsClient::HandleObservedEvent(Observed& observed, const char* data, std::size_t length)
+    {
+        if (event_.id != subscribe_id_)
+        {
+            return;
+        }
+        if (state_ == State::kSyncing)
+        {
+            // Only the newest matters: each event carries the whole state
+            observed.early_frame.assign(data, length);
+            return;
+        }
+        if (state_ == State::kLive)
+        {
+            DispatchEvent(observed, data, length);
+        }
+    }
+
+    void HaWsClient::DispatchEvent(Observed& observed, const char* data, std::size_t length)
+    {
+        stats_.dom_parses++;
+        cJSON* message = cJSON_ParseWithLength(data, length);
+        if (message == nullptr)
+        {
+            stats_.parse_errors++;
+            return;
+        }
+        const cJSON* event      = cJSON_GetObjectItemCaseSensitive(message, "event");
+        const cJSON* event_data = cJSON_GetObjectItemCaseSensitive(event, "data");
+        const cJSON* new_state  = cJSON_GetObjectItemCaseSensitive(event_data, "new_state");
+        observed.observer->OnEntityState(cJSON_IsObject(new_state) ? new_state : nullptr,
+                                         StringField(event, "time_fired"));
+        cJSON_Delete(message);
+    }
+
+    void HaWsClient::DispatchSnapshot(const cJSON* states)
+    {
+        for (Observed& observed : observed_)
+        {
+            const cJSON* found  = nullptr;
+            const cJSON* object = nullptr;
+            cJSON_ArrayForEach(object, states)
+            {
+                const char* entity_id = StringField(object, "entity_id");
+                if (entity_id != nullptr && observed.entity_id == entity_id)
+                {
+                    found = object;
+                    break;
+                }
+            }
+            observed.observer->OnEntityState(found, nullptr);
+
+            if (!observed.early_frame.empty())
+            {
+                const std::string frame = std::move(observed.early_frame);
+                observed.early_frame.clear();
+                DispatchEvent(observed, frame.data(), frame.size());
+            }
+        }
+    }
+
+    HaWsClient::Observed* HaWsClient::FindObserved(std::string_view entity_id)
+    {
+        for (Observed& observed : observed_)
+        {
+            if (observed.entity_id == entity_id)
+            {
+                return &observed;
+            }
+        }
+        return nullptr;
+    }
+
+    std::uint32_t HaWsClient::SendCommand(const HaCommand& command)
+    {
+        HaServiceCall call;
+        call.entity_id = command.entity_id;
+        call.service   = command.on ? "turn_on" : "turn_off";
+        if (command.on && command.brightness >= 0 && command.entity_id.substr(0U, 6U) == "light.")
+        {
+            call.number_key = "brightness";
+            call.number     = command.brightness;
+        }
+        return CallService(call);
+    }
+
+    std::uint32_t HaWsClient::CallService(const HaServiceCall& service_call)
+    {
+        const std::size_t dot = service_call.entity_id.find('.');
+        if (state_ != State::kLive || dot == std::string_view::npos
+            || service_call.service == nullptr)
+        {
+            return 0U;
+        }
+        const std::string   domain(service_call.entity_id.substr(0U, dot));
+        const std::string   entity_id(service_call.entity_id);
+        const std::uint32_t id = next_id_++;
+
+        cJSON* call = cJSON_CreateObject();
+        cJSON_AddNumberToObject(call, "id", id);
+        cJSON_AddStringToObject(call, "type", "call_service");
+        cJSON_AddStringToObject(call, "domain", domain.c_str());
+        cJSON_AddStringToObject(call, "service", service_call.service);
+        if (service_call.number_key != nullptr)
+        {
+            cJSON* data = cJSON_AddObjectToObject(call, "service_data");
+            cJSON_AddNumberToObject(data, service_call.number_key, service_call.number);
+        }
+        cJSON* target = cJSON_AddObjectToObject(call, "target");
+        cJSON_AddStringToObject(target, "entity_id", entity_id.c_str());
+        return Send(PrintAndDelete(call)) ? id : 0U;
+    }
+
+    bool HaWsClient::Send(const std::string& text)
+    {
+        if (text.empty() || !transport_.SendText(text))
+        {
+            APP_LOG_WARN(kWsClientTag, "send failed");
+            return false;
+        }
+        return true;
+    }
+
+    void HaWsClient::NotifyChanged()
+    {
+        if (on_change_)
+        {
+            on_change_();
+        }
+    }
+
+    HaWsClient::State HaWsClient::GetState() const
+    {
+        return state_;
+    }
+
+    HaWsClient::Stats HaWsClient::GetStats() const
+    {
+        return stats_;
+    }
+
+}  // namespace custom::integration
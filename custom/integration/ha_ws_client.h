@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "integration/ha_command_queue.h"
+#include "integration/ha_entity_store.h"
+#include "integration/ha_state_event.h"
+
+struct cJSON;
+
+namespace custom::integration
+{
+
+    /** Sends text frames on an open Home Assistant WebSocket. */
+    class HaWsTransport
+    {
+    public:
+        virtual ~HaWsTransport() = default;
+
+        /** False if the frame could not be queued; the client then waits for a reconnect. */
+        virtual bool SendText(const std::string& text) = 0;
+    };
+
+    /** Gets the full state object of one entity, for what HaEntityStore does not keep. */
+    class HaEntityObserver
+    {
+    public:
+        virtual ~HaEntityObserver() = default;
+
+        /**
+         * @p new_state is the state object (entity_id, state, attributes...), or nullptr once
+         * the entity is gone. @p time_fired is the event's ISO 8601 timestamp, nullptr when the
+         * state comes from the get_states snapshot. Both are only valid during the call.
+         */
+        virtual void OnEntityState(const cJSON* new_state, const char* time_fired) = 0;
+        /** The connection dropped; nothing is known until the next snapshot. */
+        virtual void OnEntityUnavailable() = 0;
+    };
+
+    /** A call_service on one entity, with at most one numeric service_data field. */
+    struct HaServiceCall
+    {
+        std::string_view entity_id;
+        const char*      service    = nullptr;  // in the entity's domain, e.g. "media_next_track"
+        const char*      number_key = nullptr;  // service_data key, nullptr for none
+        double           number     = 0.0;
+    };
+
+    /** "http://ha.local:8123" -> "ws://ha.local:8123/api/websocket" (https -> wss). */
+    std::string HaWebSocketUrl(const std::string& base_url);
+
+    /**
+     * @brief Home Assistant WebSocket API client that keeps an HaEntityStore current.
+     *
+     * After authenticating it subscribes to state_changed and then asks for one get_states
+     * snapshot. Deltas that arrive before the snapshot are held back and replayed on top of it,
+     * so nothing in between is lost. From then on each state_changed event updates the store
+     * directly; the REST API is never polled. Events are decoded in place with
+     * HaDecodeStateChanged() and never allocate; only the rare other frames (auth, results such
+     * as the snapshot) go through cJSON.
+     *
+     * Transport-agnostic: the owner feeds OnConnected(), OnText() and OnDisconnected() from
+     * whatever carries the socket (esp_websocket_client on the device, HaWsStubServer in host
+     * tests), all from one task. The change callback runs on that task after a snapshot or any
+     * delta that changed a tracked entity.
+     *
+     * As an HaCommandSink it also sends call_service requests once live. SendCommand() may
+     * be called from another task (the UI); its result comes back through the command result
+     * callback on the socket task.
+     *
+     * An HaEntityObserver added with AddObserver() gets the whole new_state of its entity,
+     * attributes included. Only events for observed entities pay for a cJSON parse; events
+     * that arrive before the snapshot are held back for them too (the latest one only).
+     */
+    class HaWsClient : public HaCommandSink
+    {
+    public:
+        enum class State : std::uint8_t
+        {
+            kDisconnected,
+            kAuthenticating,
+            kSyncing,  // subscribed, waiting for the get_states result
+            kLive,
+            kAuthFailed,  // bad token; stays here until the next OnConnected()
+        };
+
+        struct Stats
+        {
+            std::uint32_t messages       = 0U;
+            std::uint32_t snapshots      = 0U;
+            std::uint32_t deltas_applied = 0U;  // tracked entity changed
+            std::uint32_t deltas_ignored = 0U;  // untracked entity or no visible change
+            std::uint32_t parse_errors   = 0U;
+            std::uint32_t dom_parses     = 0U;  // not state_changed, or for an observer
+        };
+
+        HaWsClient(HaWsTransport& transport, HaEntityStore& store, std::string access_token);
+
+        HaWsClient(const HaWsClient&)            = delete;
+        HaWsClient& operator=(const HaWsClient&) = delete;
+
+        void SetChangeCallback(std::function<void()> callback);
+        /** Result of a request sent with SendCommand(): its id and whether it succeeded. */
+        void SetCommandResultCallback(std::function<void(std::uint32_t, bool)> callback);
+        /** Before the first OnConnected(); @p observer must outlive the client. */
+        void AddObserver(std::string entity_id, HaEntityObserver* observer);
+
+        void OnConnected();
+        void OnDisconnected();
+        void OnText(const char* data, std::size_t length);
+
+        /** turn_on/turn_off for the entity's domain; 0 unless live. */
+        std::uint32_t SendCommand(const HaCommand& command) override;
+        /** Any service in the entity's domain; 0 unless live. Same threading as SendCommand(). */
+        std::uint32_t CallService(const HaServiceCall& call);
+
+        State GetState() const;
+        Stats GetStats() const;
+
+    private:
+        struct Observed
+        {
+            std::string       entity_id;
+            HaEntityObserver* observer = nullptr;
+            std::string       early_frame;  // latest event before the snapshot, replayed after
+        };
+
+        bool      Send(const std::string& text);
+        Observed* FindObserved(std::string_view entity_id);
+        void      HandleObservedEvent(Observed& observed, const char* data, std::size_t length);
+        void      DispatchEvent(Observed& observed, const char* data, std::size_t length);
+        void      DispatchSnapshot(const cJSON* states);
+        void      HandleAuthOk();
+        void      HandleResult(const cJSON* message);
+        void      HandleStateChanged(const HaStateChanged& event);
+        void      NotifyChanged();
+
+        HaWsTransport&                           transport_;
+        HaEntityStore&                           store_;
+        std::string                              access_token_;
+        std::function<void()>                    on_change_;
+        std::function<void(std::uint32_t, bool)> on_command_result_;
+        std::atomic<State>                       state_{State::kDisconnected};
+        std::atomic<std::uint32_t>               next_id_{1U};  // SendCommand() takes ids too
+        std::uint32_t                            subscribe_id_  = 0U;
+        std::uint32_t                            get_states_id_ = 0U;
+        std::vector<HaEntityUpdate>              early_deltas_;  // state_changed before snapshot
+        std::vector<Observed>                    observed_;
+        HaStateChanged                           event_;  // decode target, off the task stack
+        Stats                                    stats_;
+    };
+
+}  // namespace custom::integration
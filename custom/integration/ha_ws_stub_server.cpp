@@ -0,0 +1,451 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/ha_ws_stub_server.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "cJSON.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        std::string PrintStubFrame(cJSON* object)
+        {
+            std::string text;
+            char*       printed = cJSON_PrintUnformatted(object);
+            if (printed != nullptr)
+            {
+                text = printed;
+                cJSON_free(printed);
+            }
+            cJSON_Delete(object);
+            return text;
+        }
+
+        /** Epoch seconds -> "2025-01-01T00:00:03.500000+00:00", as Home Assistant writes them. */
+        std::string StubTimestamp(double epoch_s)
+        {
+            // H. Hinnant's civil_from_days
+            const double       whole_days = std::floor(epoch_s / 86400.0);
+            const double       second     = epoch_s - whole_days * 86400.0;
+            const std::int64_t z          = static_cast<std::int64_t>(whole_days) + 719468;
+            const std::int64_t era        = (z >= 0 ? z : z - 146096) / 146097;
+            const std::int64_t doe        = z - era * 146097;
+            const std::int64_t yoe        = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const std::int64_t doy        = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const std::int64_t mp         = (5 * doy + 2) / 153;
+            const std::int64_t day        = doy - (153 * mp + 2) / 5 + 1;
+            const std::int64_t month      = mp < 10 ? mp + 3 : mp - 9;
+            const std::int64_t year       = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+            const int hours   = static_cast<int>(second / 3600.0);
+            const int minutes = static_cast<int>((second - hours * 3600.0) / 60.0);
+            char      text[48];
+            std::snprintf(text,
+                          sizeof(text),
+                          "%04d-%02d-%02dT%02d:%02d:%09.6f+00:00",
+                          static_cast<int>(year),
+                          static_cast<int>(month),
+                          static_cast<int>(day),
+                          hours,
+                          minutes,
+                          second - hours * 3600.0 - minutes * 60.0);
+            return text;
+        }
+
+        cJSON* StubStateObject(const std::string& entity_id,
+                               const std::string& state,
+                               std::int32_t       brightness)
+        {
+            cJSON* object = cJSON_CreateObject();
+            cJSON_AddStringToObject(object, "entity_id", entity_id.c_str());
+            cJSON_AddStringToObject(object, "state", state.c_str());
+            cJSON* attributes = cJSON_AddObjectToObject(object, "attributes");
+            cJSON_AddStringToObject(attributes, "friendly_name", entity_id.c_str());
+            if (brightness >= 0)
+            {
+                cJSON_AddNumberToObject(attributes, "brightness", brightness);
+            }
+            cJSON_AddStringToObject(object, "last_changed", "2025-01-01T00:00:00+00:00");
+            return object;
+        }
+
+    }  // namespace
+
+    HaWsStubServer::HaWsStubServer(std::string access_token) :
+        access_token_(std::move(access_token))
+    {
+    }
+
+    void HaWsStubServer::Attach(HaWsClient* client)
+    {
+        client_ = client;
+    }
+
+    void HaWsStubServer::Connect()
+    {
+        outbox_.clear();
+        connected_       = true;
+        authenticated_   = false;
+        subscription_id_ = 0U;
+        if (client_ != nullptr)
+        {
+            client_->OnConnected();
+        }
+        Queue(R"({"type":"auth_required","ha_version":"2025.1.0"})");
+    }
+
+    void HaWsStubServer::Disconnect()
+    {
+        outbox_.clear();
+        connected_       = false;
+        authenticated_   = false;
+        subscription_id_ = 0U;
+        if (client_ != nullptr)
+        {
+            client_->OnDisconnected();
+        }
+    }
+
+    void HaWsStubServer::SetState(const std::string& entity_id,
+                                  const std::string& state,
+                                  std::int32_t       brightness)
+    {
+        Entity& entity    = entities_[entity_id];
+        entity.state      = state;
+        entity.brightness = brightness;
+        Broadcast(entity_id, &entity);
+    }
+
+    void HaWsStubServer::RemoveEntity(const std::string& entity_id)
+    {
+        if (entities_.erase(entity_id) > 0U)
+        {
+            Broadcast(entity_id, nullptr);
+        }
+    }
+
+    void HaWsStubServer::AddMediaPlayer(const std::string&       entity_id,
+                                        std::vector<HaStubTrack> tracks,
+                                        double                   volume_level)
+    {
+        Entity& entity             = entities_[entity_id];
+        entity.state               = tracks.empty() ? "idle" : "paused";
+        entity.media               = true;
+        entity.tracks              = std::move(tracks);
+        entity.track               = 0U;
+        entity.position_s          = 0.0;
+        entity.position_updated_at = clock_s_;
+        entity.volume_level        = volume_level;
+        Broadcast(entity_id, &entity);
+    }
+
+    bool HaWsStubServer::MediaService(const std::string& entity_id,
+                                      const std::string& service,
+                                      double             volume_level)
+    {
+        const auto it = entities_.find(entity_id);
+        if (it == entities_.end() || !ApplyMediaService(it->second, service.c_str(), volume_level))
+        {
+            return false;
+        }
+        Broadcast(it->first, &it->second);
+        return true;
+    }
+
+    double HaWsStubServer::MediaPosition(const std::string& entity_id) const
+    {
+        const auto it = entities_.find(entity_id);
+        return it != entities_.end() ? PositionOf(it->second) : 0.0;
+    }
+
+    void HaWsStubServer::SetClock(double epoch_s)
+    {
+        clock_s_ = epoch_s;
+    }
+
+    void HaWsStubServer::AdvanceClock(double seconds)
+    {
+        clock_s_ += seconds;
+    }
+
+    double HaWsStubServer::Clock() const
+    {
+        return clock_s_;
+    }
+
+    std::size_t HaWsStubServer::Pump(std::size_t max)
+    {
+        std::size_t delivered = 0U;
+        while (delivered < max && !outbox_.empty() && client_ != nullptr)
+        {
+            // Replies the client triggers go to the back of the queue, so pop first
+            const std::string frame = std::move(outbox_.front());
+            outbox_.pop_front();
+            bytes_sent_ += frame.size();
+            client_->OnText(frame.data(), frame.size());
+            delivered++;
+        }
+        return delivered;
+    }
+
+    std::size_t HaWsStubServer::PendingFrames() const
+    {
+        return outbox_.size();
+    }
+
+    std::uint32_t HaWsStubServer::GetStatesRequests() const
+    {
+        return get_states_requests_;
+    }
+
+    std::size_t HaWsStubServer::BytesSent() const
+    {
+        return bytes_sent_;
+    }
+
+    void HaWsStubServer::FailServiceCalls(bool fail)
+    {
+        fail_service_calls_ = fail;
+    }
+
+    std::uint32_t HaWsStubServer::ServiceCalls() const
+    {
+        return service_calls_;
+    }
+
+    bool HaWsStubServer::SendText(const std::string& text)
+    {
+        if (!connected_)
+        {
+            return false;
+        }
+        cJSON* message = cJSON_ParseWithLength(text.data(), text.size());
+        if (message == nullptr)
+        {
+            return true;
+        }
+
+        const cJSON*  type_item = cJSON_GetObjectItemCaseSensitive(message, "type");
+        const cJSON*  id_item   = cJSON_GetObjectItemCaseSensitive(message, "id");
+        const char*   type      = cJSON_IsString(type_item) ? type_item->valuestring : "";
+        std::uint32_t id =
+            cJSON_IsNumber(id_item) ? static_cast<std::uint32_t>(id_item->valueint) : 0U;
+
+        if (std::strcmp(type, "auth") == 0)
+        {
+            const cJSON* token = cJSON_GetObjectItemCaseSensitive(message, "access_token");
+            authenticated_ = cJSON_IsString(token) && access_token_ == token->valuestring;
+            Queue(authenticated_ ? R"({"type":"auth_ok","ha_version":"2025.1.0"})"
+                                 : R"({"type":"auth_invalid","message":"Invalid access token"})");
+        }
+        else if (!authenticated_)
+        {
+            // Home Assistant closes the socket here; the stub just ignores the frame
+        }
+        else if (std::strcmp(type, "subscribe_events") == 0)
+        {
+            subscription_id_ = id;
+            Reply(id, true, "null");
+        }
+        else if (std::strcmp(type, "get_states") == 0)
+        {
+            get_states_requests_++;
+            std::string result = "[";
+            for (const auto& [entity_id, entity] : entities_)
+            {
+                result += result.size() > 1U ? "," : "";
+                result += StateJson(entity_id, entity);
+            }
+            Reply(id, true, result + "]");
+        }
+        else if (std::strcmp(type, "call_service") == 0)
+        {
+            HandleServiceCall(id, message);
+        }
+        else
+        {
+            Reply(id, false, "null");
+        }
+        cJSON_Delete(message);
+        return true;
+    }
+
+    void HaWsStubServer::HandleServiceCall(std::uint32_t id, const cJSON* message)
+    {
+        service_calls_++;
+        const cJSON* service = cJSON_GetObjectItemCaseSensitive(message, "service");
+        const cJSON* target  = cJSON_GetObjectItemCaseSensitive(message, "target");
+        const cJSON* entity  = cJSON_GetObjectItemCaseSensitive(target, "entity_id");
+        const cJSON* data    = cJSON_GetObjectItemCaseSensitive(message, "service_data");
+        const cJSON* level   = cJSON_GetObjectItemCaseSensitive(data, "brightness");
+        const cJSON* volume  = cJSON_GetObjectItemCaseSensitive(data, "volume_level");
+        const auto   it =
+            cJSON_IsString(entity) ? entities_.find(entity->valuestring) : entities_.end();
+        if (fail_service_calls_ || it == entities_.end() || !cJSON_IsString(service))
+        {
+            Reply(id, false, "null");
+            return;
+        }
+        if (it->second.media)
+        {
+            const double level_arg = cJSON_IsNumber(volume) ? volume->valuedouble : -1.0;
+            const bool   applied   = ApplyMediaService(it->second, service->valuestring, level_arg);
+            if (applied)
+            {
+                Broadcast(it->first, &it->second);
+            }
+            Reply(id, applied, "null");
+            return;
+        }
+
+        // Like Home Assistant: the state change is broadcast before the call returns
+        Entity&    target_entity = it->second;
+        const bool on            = std::strcmp(service->valuestring, "turn_on") == 0;
+        target_entity.state      = on ? "on" : "off";
+        if (!on)
+        {
+            target_entity.brightness = -1;
+        }
+        else if (cJSON_IsNumber(level))
+        {
+            target_entity.brightness = level->valueint;
+        }
+        Broadcast(it->first, &target_entity);
+        Reply(id, true, "null");
+    }
+
+    bool HaWsStubServer::ApplyMediaService(Entity&     entity,
+                                           const char* service,
+                                           double      volume_level)
+    {
+        if (!entity.media || entity.state == "off" || entity.state == "unavailable")
+        {
+            return false;
+        }
+        const bool  playing = entity.state == "playing";
+        std::string verb    = service;
+        if (verb == "media_play_pause")
+        {
+            verb = playing ? "media_pause" : "media_play";
+        }
+
+        if (verb == "media_play" || verb == "media_pause")
+        {
+            if (entity.tracks.empty())
+            {
+                return false;
+            }
+            // Home Assistant stamps a new position whenever playback starts or stops
+            entity.position_s          = PositionOf(entity);
+            entity.position_updated_at = clock_s_;
+            entity.state               = verb == "media_play" ? "playing" : "paused";
+        }
+        else if (verb == "media_next_track" || verb == "media_previous_track")
+        {
+            if (entity.tracks.empty())
+            {
+                return false;
+            }
+            const std::size_t count    = entity.tracks.size();
+            const std::size_t step     = verb == "media_next_track" ? 1U : count - 1U;
+            entity.track               = (entity.track + step) % count;
+            entity.position_s          = 0.0;
+            entity.position_updated_at = clock_s_;
+        }
+        else if (verb == "volume_set")
+        {
+            if (volume_level < 0.0 || volume_level > 1.0)
+            {
+                return false;
+            }
+            entity.volume_level = volume_level;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    double HaWsStubServer::PositionOf(const Entity& entity) const
+    {
+        if (!entity.media || entity.tracks.empty())
+        {
+            return 0.0;
+        }
+        double position = entity.position_s;
+        if (entity.state == "playing")
+        {
+            position += clock_s_ - entity.position_updated_at;
+        }
+        const double duration = entity.tracks[entity.track].duration_s;
+        return duration > 0.0 && position > duration ? duration : position;
+    }
+
+    std::string HaWsStubServer::StateJson(const std::string& entity_id,
+                                          const Entity&      entity) const
+    {
+        cJSON* object = StubStateObject(entity_id, entity.state, entity.brightness);
+        if (entity.media && entity.state != "off" && entity.state != "unavailable")
+        {
+            cJSON* attributes = cJSON_GetObjectItemCaseSensitive(object, "attributes");
+            cJSON_AddNumberToObject(attributes, "volume_level", entity.volume_level);
+            cJSON_AddBoolToObject(attributes, "is_volume_muted", false);
+            if (!entity.tracks.empty())
+            {
+                const HaStubTrack& track = entity.tracks[entity.track];
+                cJSON_AddStringToObject(attributes, "media_content_type", "music");
+                cJSON_AddNumberToObject(attributes, "media_duration", track.duration_s);
+                cJSON_AddNumberToObject(attributes, "media_position", entity.position_s);
+                cJSON_AddStringToObject(attributes,
+                                        "media_position_updated_at",
+                                        StubTimestamp(entity.position_updated_at).c_str());
+                cJSON_AddStringToObject(attributes, "media_title", track.title.c_str());
+                cJSON_AddStringToObject(attributes, "media_artist", track.artist.c_str());
+                if (!track.picture.empty())
+                {
+                    cJSON_AddStringToObject(attributes, "entity_picture", track.picture.c_str());
+                }
+            }
+        }
+        return PrintStubFrame(object);
+    }
+
+    void HaWsStubServer::Queue(std::string frame)
+    {
+        if (connected_)
+        {
+            outbox_.push_back(std::move(frame));
+        }
+    }
+
+    void HaWsStubServer::Reply(std::uint32_t id, bool success, const std::string& result)
+    {
+        Queue("{\"id\":" + std::to_string(id) + ",\"type\":\"result\",\"success\":"
+              + (success ? "true" : "false") + ",\"result\":" + result + "}");
+    }
+
+    void HaWsStubServer::Broadcast(const std::string& entity_id, const Entity* entity)
+    {
+        if (subscription_id_ == 0U)
+        {
+            return;
+        }
+        const std::string new_state = entity != nullptr ? StateJson(entity_id, *entity) : "null";
+        Queue("{\"id\":" + std::to_string(subscription_id_)
+              + R"(,"type":"event","event":{"event_type":"state_changed","data":{"entity_id":")"
+              + entity_id + R"(","new_state":)" + new_state + R"(},"origin":"LOCAL","time_fired":")"
+              + StubTimestamp(clock_s_) + "\"}}");
+    }
+
+}  // namespace custom::integration
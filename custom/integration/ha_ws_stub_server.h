@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "integration/ha_ws_client.h"
+
+namespace custom::integration
+{
+
+    /** One entry of a stub media_player's play queue. */
+    struct HaStubTrack
+    {
+        std::string title;
+        std::string artist;
+        double      duration_s = 0.0;
+        std::string picture;  // entity_picture; empty for none
+    };
+
+    /**
+     * @brief In-process stand-in for the Home Assistant WebSocket API, for host tests.
+     *
+     * Implements the part of the protocol HaWsClient uses: auth with a fixed token,
+     * subscribe_events for state_changed, get_states and call_service (turn_on/turn_off). It
+     * doubles as the client's transport.
+     *
+     * It can also play a media_player entity the way Home Assistant reports one: position
+     * and media_position_updated_at change only with the state, never while a track plays.
+     * Events carry time_fired from a clock the test advances, and the media services
+     * (media_play, media_pause, media_play_pause, media_next_track, media_previous_track,
+     * volume_set) act on the play queue. Frames for the client are queued and only delivered by
+     * Pump(), as if they had crossed a socket, so a test controls how replies and events
+     * interleave.
+     */
+    class HaWsStubServer : public HaWsTransport
+    {
+    public:
+        explicit HaWsStubServer(std::string access_token);
+
+        void Attach(HaWsClient* client);
+
+        /** Open the socket: the client sees OnConnected() and then auth_required. */
+        void Connect();
+        /** Drop the socket and any undelivered frames. */
+        void Disconnect();
+
+        /** Change an entity; subscribers get a state_changed event. */
+        void SetState(const std::string& entity_id,
+                      const std::string& state,
+                      std::int32_t       brightness = -1);
+        /** Remove an entity; subscribers get a state_changed event with new_state null. */
+        void RemoveEntity(const std::string& entity_id);
+
+        /** Add a paused media_player at the start of @p tracks. */
+        void AddMediaPlayer(const std::string&       entity_id,
+                            std::vector<HaStubTrack> tracks,
+                            double                   volume_level = 0.5);
+        /** Run a media service as if another client had called it; false if it does not apply. */
+        bool MediaService(const std::string& entity_id,
+                          const std::string& service,
+                          double             volume_level = 0.0);
+        /** Where the server's clock puts the media_player's track now, in seconds. */
+        double MediaPosition(const std::string& entity_id) const;
+
+        /** The server's wall clock, in epoch seconds; starts at 2025-01-01T00:00:00Z. */
+        void   SetClock(double epoch_s);
+        void   AdvanceClock(double seconds);
+        double Clock() const;
+
+        /** Deliver up to @p max queued frames to the client; returns how many. */
+        std::size_t Pump(std::size_t max = SIZE_MAX);
+        std::size_t PendingFrames() const;
+
+        std::uint32_t GetStatesRequests() const;
+        std::size_t   BytesSent() const;
+
+        /** Reject every call_service from now on, as for an entity that stopped responding. */
+        void          FailServiceCalls(bool fail);
+        std::uint32_t ServiceCalls() const;
+
+        // HaWsTransport: frames from the client
+        bool SendText(const std::string& text) override;
+
+    private:
+        struct Entity
+        {
+            std::string  state;
+            std::int32_t brightness = -1;
+
+            // media_player only
+            bool                     media = false;
+            std::vector<HaStubTrack> tracks;
+            std::size_t              track               = 0U;
+            double                   position_s          = 0.0;
+            double                   position_updated_at = 0.0;
+            double                   volume_level        = 0.5;
+        };
+
+        void        HandleServiceCall(std::uint32_t id, const cJSON* message);
+        bool        ApplyMediaService(Entity& entity, const char* service, double volume_level);
+        double      PositionOf(const Entity& entity) const;
+        std::string StateJson(const std::string& entity_id, const Entity& entity) const;
+        void        Queue(std::string frame);
+        void        Reply(std::uint32_t id, bool success, const std::string& result);
+        void        Broadcast(const std::string& entity_id, const Entity* entity);
+
+        std::string                   access_token_;
+        HaWsClient*                   client_ = nullptr;
+        std::map<std::string, Entity> entities_;
+        std::deque<std::string>       outbox_;
+        bool                          connected_           = false;
+        bool                          authenticated_       = false;
+        std::uint32_t                 subscription_id_     = 0U;  // 0: not subscribed
+        std::uint32_t                 get_states_requests_ = 0U;
+        std::uint32_t                 service_calls_       = 0U;
+        bool                          fail_service_calls_  = false;
+        std::size_t                   bytes_sent_          = 0U;
+        double                        clock_s_             = 1735689600.0;
+    };
+
+}  // namespace custom::integration
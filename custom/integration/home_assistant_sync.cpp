@@ -0,0 +1,538 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/home_assistant_sync.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../app_trace.h"
+#include "integration/artwork_loader.h"
+#include "integration/ha_command_queue.h"
+#include "integration/ha_entity_store.h"
+#include "integration/ha_media_player.h"
+#include "integration/ha_ui_batcher.h"
+#include "integration/ha_ws_client.h"
+#include "integration/mqtt_ingest.h"
+
+#if defined(ESP_PLATFORM)
+#    include "esp_crt_bundle.h"
+#    include "esp_websocket_client.h"
+#    include "freertos/FreeRTOS.h"
+#    include "freertos/task.h"
+#    include "hal/hal.h"
+#    include "mqtt_client.h"
+#    include "settings_core/app_cfg.h"
+#    include "ui/pages/ui_page_rooms.h"
+#endif
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kTag = "ha-sync";
+
+#if defined(ESP_PLATFORM)
+        constexpr int         kWsBufferSize     = 4096;
+        constexpr int         kWsTaskStack      = 6144;
+        constexpr int         kWsReconnectMs    = 5000;
+        constexpr int         kWsSendTimeoutMs  = 1000;
+        constexpr std::size_t kMaxMessageBytes  = 512U * 1024U;  // get_states of a large home
+        constexpr int         kWsOpcodeContinue = 0x00;
+        constexpr int         kWsOpcodeText     = 0x01;
+        constexpr int         kMqttBufferSize   = 2048;
+        constexpr int         kMqttTaskStack    = 6144;
+
+        // Well under the toggle debounce, so the wait a command sees is the debounce itself
+        constexpr std::uint32_t kCommandPollMs = 20U;
+
+        // Room for the TLS handshake of an https cover; decoding itself works on the heap
+        constexpr std::uint32_t kArtworkTaskStack    = 8192U;
+        constexpr UBaseType_t   kArtworkTaskPriority = 2U;
+        constexpr std::uint32_t kArtworkWaitMs       = 1000U;
+
+        // The player the media page follows, named like the built-in rooms' entities
+        constexpr const char* kMediaPlayerEntity = "media_player.living_room";
+
+        struct DefaultRoom
+        {
+            const char* room_id;
+            const char* name;
+        };
+
+        constexpr DefaultRoom kDefaultRooms[] = {
+            {"bakery", "Bakery"},
+            {"bedroom", "Bedroom"},
+            {"living", "Living Room"},
+        };
+
+        // The cards on the rooms page, with the entity ids the built-in mock data uses
+        std::vector<HaRoomLayout> DefaultRoomLayout()
+        {
+            std::vector<HaRoomLayout> layout;
+            for (const DefaultRoom& card : kDefaultRooms)
+            {
+                const std::string id = card.room_id;
+                HaRoomLayout      room;
+                room.room_id            = id;
+                room.name               = card.name;
+                room.entities           = {"light." + id + "_main"};
+                room.temperature_entity = "sensor." + id + "_temperature";
+                room.humidity_entity    = "sensor." + id + "_humidity";
+                layout.push_back(std::move(room));
+            }
+            return layout;
+        }
+#endif
+
+    }  // namespace
+
+#if defined(ESP_PLATFORM)
+
+    class HomeAssistantSync::Impl : public HaWsTransport, public MqttTransport
+    {
+    public:
+        Impl() :
+            store_(DefaultRoomLayout()),
+            batcher_(
+                store_,
+                [this]() { ScheduleFlush(); },
+                [](const room_t& room) { ui_page_rooms_set_room(&room); }),
+            commands_(store_, HaCommandQueue::Config()),
+            media_player_(kMediaPlayerEntity, []() { return lv_tick_get(); })
+        {
+            commands_.SetChangeCallback([this]() { batcher_.MarkChanged(); });
+        }
+
+        ~Impl() override
+        {
+            Stop();
+            StopArtwork();
+        }
+
+        void Start()
+        {
+            if (socket_ != nullptr || mqtt_ != nullptr)
+            {
+                return;
+            }
+
+            app_cfg_t config;
+            app_cfg_set_defaults(&config);
+            if (app_cfg_load(&config) != ESP_OK)
+            {
+                APP_LOG_INFO(kTag, "no saved settings, keeping local room state");
+                return;
+            }
+            if (config.home_assistant.enabled && config.home_assistant.url[0] != '\0'
+                && config.home_assistant.token[0] != '\0')
+            {
+                StartWebSocket(config);
+            }
+            else if (config.mqtt.enabled && config.mqtt.ha_discovery
+                     && config.mqtt.broker_uri[0] != '\0')
+            {
+                StartMqtt(config);
+            }
+            else
+            {
+                APP_LOG_INFO(kTag, "Home Assistant not configured, keeping local room state");
+            }
+        }
+
+        void Stop()
+        {
+            if (socket_ != nullptr)
+            {
+                esp_websocket_client_stop(socket_);
+                esp_websocket_client_destroy(socket_);
+                socket_ = nullptr;
+            }
+            if (mqtt_ != nullptr)
+            {
+                esp_mqtt_client_stop(mqtt_);
+                esp_mqtt_client_destroy(mqtt_);
+                mqtt_ = nullptr;
+            }
+            commands_.SetSink(nullptr, 0U);
+            GetHAL()->lvglLock();
+            if (poll_timer_ != nullptr)
+            {
+                lv_timer_delete(poll_timer_);
+                poll_timer_ = nullptr;
+            }
+            lv_async_call_cancel(FlushAsyncCb, this);
+            GetHAL()->lvglUnlock();
+        }
+
+        bool Toggle(const char* entity_id)
+        {
+            return client_ != nullptr && entity_id != nullptr
+                   && commands_.Toggle(entity_id, lv_tick_get());
+        }
+
+        HaMediaPlayer* GetMediaPlayer()
+        {
+            return client_ != nullptr ? &media_player_ : nullptr;
+        }
+
+        ArtworkLoader* GetArtworkLoader()
+        {
+            return client_ != nullptr ? &artwork_ : nullptr;
+        }
+
+        bool SendText(const std::string& text) override
+        {
+            return socket_ != nullptr
+                   && esp_websocket_client_send_text(socket_,
+                                                     text.data(),
+                                                     static_cast<int>(text.size()),
+                                                     pdMS_TO_TICKS(kWsSendTimeoutMs))
+                          >= 0;
+        }
+
+        bool Subscribe(const std::string& filter) override
+        {
+            return mqtt_ != nullptr
+                   && esp_mqtt_client_subscribe_single(mqtt_, filter.c_str(), 0) >= 0;
+        }
+
+    private:
+        void StartWebSocket(const app_cfg_t& config)
+        {
+            url_    = HaWebSocketUrl(config.home_assistant.url);
+            client_ = std::make_unique<HaWsClient>(*this, store_, config.home_assistant.token);
+            client_->SetChangeCallback([this]() { batcher_.MarkChanged(); });
+            client_->SetCommandResultCallback(
+                [this](std::uint32_t id, bool success) { commands_.OnResult(id, success); });
+            media_player_.Attach(client_.get());
+            media_player_.SetPictureBase(config.home_assistant.url);
+            StartArtwork();
+
+            esp_websocket_client_config_t ws_config = {};
+            ws_config.uri                           = url_.c_str();
+            ws_config.buffer_size                   = kWsBufferSize;
+            ws_config.task_stack                    = kWsTaskStack;
+            ws_config.reconnect_timeout_ms          = kWsReconnectMs;
+            ws_config.crt_bundle_attach             = esp_crt_bundle_attach;
+
+            socket_ = esp_websocket_client_init(&ws_config);
+            if (socket_ == nullptr)
+            {
+                APP_LOG_WARN(kTag, "websocket client init failed");
+                return;
+            }
+            esp_websocket_register_events(socket_, WEBSOCKET_EVENT_ANY, EventHandler, this);
+            if (esp_websocket_client_start(socket_) != ESP_OK)
+            {
+                APP_LOG_WARN(kTag, "websocket client start failed");
+                Stop();
+                return;
+            }
+            GetHAL()->lvglLock();
+            poll_timer_ = lv_timer_create(PollTimerCb, kCommandPollMs, this);
+            GetHAL()->lvglUnlock();
+            APP_LOG_INFO(kTag, "connecting to %s", url_.c_str());
+        }
+
+        void StartMqtt(const app_cfg_t& config)
+        {
+            ingest_ = std::make_unique<MqttIngest>(*this, store_);
+            ingest_->SetChangeCallback([this]() { batcher_.MarkChanged(); });
+
+            esp_mqtt_client_config_t mqtt_config            = {};
+            mqtt_config.broker.address.uri                  = config.mqtt.broker_uri;
+            mqtt_config.credentials.client_id               = config.mqtt.client_id;
+            mqtt_config.credentials.username                = config.mqtt.username;
+            mqtt_config.credentials.authentication.password = config.mqtt.password;
+            mqtt_config.buffer.size                         = kMqttBufferSize;
+            mqtt_config.task.stack_size                     = kMqttTaskStack;
+            if (config.mqtt.use_tls)
+            {
+                mqtt_config.broker.verification.crt_bundle_attach = esp_crt_bundle_attach;
+            }
+
+            // esp-mqtt copies the strings, so config may go out of scope
+            mqtt_ = esp_mqtt_client_init(&mqtt_config);
+            if (mqtt_ == nullptr)
+            {
+                APP_LOG_WARN(kTag, "mqtt client init failed");
+                return;
+            }
+            esp_mqtt_client_register_event(mqtt_, MQTT_EVENT_ANY, MqttEventHandler, this);
+            if (esp_mqtt_client_start(mqtt_) != ESP_OK)
+            {
+                APP_LOG_WARN(kTag, "mqtt client start failed");
+                Stop();
+                return;
+            }
+            APP_LOG_INFO(kTag, "following MQTT discovery on %s", config.mqtt.broker_uri);
+        }
+
+        static void EventHandler(void*            arg,
+                                 esp_event_base_t base,
+                                 int32_t          event_id,
+                                 void*            event_data)
+        {
+            (void)base;
+            auto* self = static_cast<Impl*>(arg);
+            auto* data = static_cast<esp_websocket_event_data_t*>(event_data);
+            switch (event_id)
+            {
+                case WEBSOCKET_EVENT_CONNECTED:
+                    self->rx_.clear();
+                    self->client_->OnConnected();
+                    self->commands_.SetSink(self->client_.get(), lv_tick_get());
+                    break;
+                case WEBSOCKET_EVENT_DISCONNECTED:
+                case WEBSOCKET_EVENT_CLOSED:
+                    self->commands_.SetSink(nullptr, 0U);
+                    self->client_->OnDisconnected();
+                    break;
+                case WEBSOCKET_EVENT_DATA:
+                    self->OnData(*data);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Frames larger than the socket buffer arrive in pieces; join them before parsing
+        void OnData(const esp_websocket_event_data_t& data)
+        {
+            if (data.op_code != kWsOpcodeText && data.op_code != kWsOpcodeContinue)
+            {
+                return;
+            }
+            if (data.op_code == kWsOpcodeText && data.payload_offset == 0)
+            {
+                rx_.clear();
+                rx_overflow_ = false;
+            }
+            if (rx_.size() + static_cast<std::size_t>(data.data_len) > kMaxMessageBytes)
+            {
+                rx_overflow_ = true;
+            }
+            if (!rx_overflow_)
+            {
+                rx_.append(data.data_ptr, static_cast<std::size_t>(data.data_len));
+            }
+            if (data.payload_offset + data.data_len < data.payload_len || !data.fin)
+            {
+                return;
+            }
+            if (rx_overflow_)
+            {
+                APP_LOG_WARN(kTag, "dropped a message over %u bytes", (unsigned)kMaxMessageBytes);
+            }
+            else
+            {
+                client_->OnText(rx_.data(), rx_.size());
+            }
+            rx_.clear();
+        }
+
+        static void MqttEventHandler(void*            arg,
+                                     esp_event_base_t base,
+                                     int32_t          event_id,
+                                     void*            event_data)
+        {
+            (void)base;
+            auto* self  = static_cast<Impl*>(arg);
+            auto* event = static_cast<esp_mqtt_event_handle_t>(event_data);
+            switch (event_id)
+            {
+                case MQTT_EVENT_CONNECTED:
+                    self->ingest_->OnConnected();
+                    break;
+                case MQTT_EVENT_DISCONNECTED:
+                    self->ingest_->OnDisconnected();
+                    break;
+                case MQTT_EVENT_DATA:
+                    self->OnMqttData(*event);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Payloads larger than the MQTT buffer arrive in pieces; only the first has the topic
+        void OnMqttData(const esp_mqtt_event_t& event)
+        {
+            if (event.current_data_offset == 0)
+            {
+                mqtt_topic_.assign(event.topic, static_cast<std::size_t>(event.topic_len));
+                mqtt_rx_.clear();
+                mqtt_rx_overflow_ = false;
+            }
+            if (mqtt_rx_.size() + static_cast<std::size_t>(event.data_len) > kMaxMessageBytes)
+            {
+                mqtt_rx_overflow_ = true;
+            }
+            if (!mqtt_rx_overflow_)
+            {
+                mqtt_rx_.append(event.data, static_cast<std::size_t>(event.data_len));
+            }
+            if (event.current_data_offset + event.data_len < event.total_data_len)
+            {
+                return;
+            }
+            if (!mqtt_rx_overflow_)
+            {
+                ingest_->OnMessage(mqtt_topic_, mqtt_rx_.data(), mqtt_rx_.size());
+            }
+            mqtt_rx_.clear();
+        }
+
+        // Network task: one lv_async_call per frame at most, however many deltas arrive
+        void ScheduleFlush()
+        {
+            GetHAL()->lvglLock();
+            lv_async_call(FlushAsyncCb, this);
+            GetHAL()->lvglUnlock();
+        }
+
+        // LVGL task, on the next lv_timer_handler() pass, i.e. before the next refresh
+        static void FlushAsyncCb(void* user_data)
+        {
+            static_cast<Impl*>(user_data)->batcher_.Flush();
+        }
+
+        // The worker outlives Stop(): the media controller may hold the loader until teardown
+        void StartArtwork()
+        {
+            if (artwork_active_.load())
+            {
+                return;
+            }
+            artwork_active_.store(true);
+            if (xTaskCreate(ArtworkTaskEntry,
+                            "artwork",
+                            kArtworkTaskStack,
+                            this,
+                            kArtworkTaskPriority,
+                            nullptr)
+                != pdPASS)
+            {
+                artwork_active_.store(false);
+                APP_LOG_WARN(kTag, "artwork task start failed");
+            }
+        }
+
+        void StopArtwork()
+        {
+            artwork_.Stop();
+            while (artwork_active_.load())
+            {
+                vTaskDelay(pdMS_TO_TICKS(10));
+            }
+        }
+
+        static void ArtworkTaskEntry(void* arg)
+        {
+            auto* self = static_cast<Impl*>(arg);
+            while (self->artwork_.RunOnce(kArtworkWaitMs))
+            {
+            }
+            self->artwork_active_.store(false);
+            vTaskDelete(nullptr);
+        }
+
+        // UI thread: sends due commands and times out the ones that got no result
+        static void PollTimerCb(lv_timer_t* timer)
+        {
+            static_cast<Impl*>(lv_timer_get_user_data(timer))->commands_.Poll(lv_tick_get());
+        }
+
+        HaEntityStore                 store_;
+        HaUiBatcher                   batcher_;
+        HaCommandQueue                commands_;
+        HaMediaPlayer                 media_player_;
+        ArtworkLoader                 artwork_{ArtworkLoader::Config()};
+        std::atomic<bool>             artwork_active_{false};
+        lv_timer_t*                   poll_timer_ = nullptr;
+        std::unique_ptr<HaWsClient>   client_;
+        std::string                   url_;
+        esp_websocket_client_handle_t socket_ = nullptr;
+        std::string                   rx_;
+        bool                          rx_overflow_ = false;
+        std::unique_ptr<MqttIngest>   ingest_;
+        esp_mqtt_client_handle_t      mqtt_ = nullptr;
+        std::string                   mqtt_topic_;
+        std::string                   mqtt_rx_;
+        bool                          mqtt_rx_overflow_ = false;
+    };
+
+#else
+
+    class HomeAssistantSync::Impl
+    {
+    public:
+        void Start()
+        {
+            // Host tests drive HaWsClient and MqttIngest through the stubs instead
+            APP_LOG_INFO(kTag, "no WebSocket client on this platform, keeping local room state");
+        }
+
+        void Stop()
+        {
+        }
+
+        bool Toggle(const char* entity_id)
+        {
+            (void)entity_id;
+            return false;
+        }
+
+        HaMediaPlayer* GetMediaPlayer()
+        {
+            return nullptr;
+        }
+
+        ArtworkLoader* GetArtworkLoader()
+        {
+            return nullptr;
+        }
+    };
+
+#endif
+
+    HomeAssistantSync::HomeAssistantSync() : impl_(std::make_unique<Impl>())
+    {
+    }
+
+    HomeAssistantSync::~HomeAssistantSync() = default;
+
+    void HomeAssistantSync::Start()
+    {
+        impl_->Start();
+    }
+
+    void HomeAssistantSync::Stop()
+    {
+        impl_->Stop();
+    }
+
+    bool HomeAssistantSync::Toggle(const char* entity_id)
+    {
+        return impl_->Toggle(entity_id);
+    }
+
+    HaMediaPlayer* HomeAssistantSync::GetMediaPlayer()
+    {
+        return impl_->GetMediaPlayer();
+    }
+
+    ArtworkLoader* HomeAssistantSync::GetArtworkLoader()
+    {
+        return impl_->GetArtworkLoader();
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <memory>
+
+namespace custom::integration
+{
+
+    class ArtworkLoader;
+    class HaMediaPlayer;
+
+    /**
+     * @brief Keeps the rooms page in sync with Home Assistant over its WebSocket API or MQTT.
+     *
+     * Start() reads the Home Assistant URL and token from app_cfg and connects with
+     * esp_websocket_client, which also reconnects on its own. Without a URL and token it falls
+     * back to MQTT discovery on the configured broker when mqtt.enabled and mqtt.ha_discovery
+     * are set (MqttIngest over esp-mqtt). Live state reaches the rooms page through
+     * rooms_provider_set_state(). With neither configured, and on the desktop build, the page
+     * keeps the provider's built-in snapshot.
+     *
+     * Over the WebSocket API, Toggle() also sends the tap back through an HaCommandQueue:
+     * the card flips at once and rapid taps coalesce into at most one call_service.
+     *
+     * The same connection follows media_player.living_room for the media page; see
+     * GetMediaPlayer(). Its covers are fetched on a worker task of their own through
+     * GetArtworkLoader().
+     */
+    class HomeAssistantSync
+    {
+    public:
+        HomeAssistantSync();
+        ~HomeAssistantSync();
+
+        HomeAssistantSync(const HomeAssistantSync&)            = delete;
+        HomeAssistantSync& operator=(const HomeAssistantSync&) = delete;
+
+        void Start();
+        void Stop();
+
+        /** UI thread. False if the entity cannot be commanded right now. */
+        bool Toggle(const char* entity_id);
+
+        /** nullptr unless Start() connected over the WebSocket API. Lives as long as this. */
+        HaMediaPlayer* GetMediaPlayer();
+        /** nullptr unless Start() connected over the WebSocket API. Lives as long as this. */
+        ArtworkLoader* GetArtworkLoader();
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+}  // namespace custom::integration
@@ -9,6 +9,7 @@
 #include <array>
 
 #include "../app_trace.h"
+#include "hal/hal.h"
 
 namespace custom::integration
 {
@@ -18,6 +19,26 @@ namespace custom::integration
 
         constexpr const char* kTag = "media-controller";
 
+        // Four checks a second keep the shown position within a quarter second of the truth
+        constexpr std::uint32_t kRefreshMs = 250U;
+
+#if defined(ESP_PLATFORM)
+        constexpr const char* kMusicDir = "/sdcard/music";
+#else
+        constexpr const char* kMusicDir = "music";
+#endif
+        constexpr std::size_t kMaxLocalTracks = 64U;
+
+        // Only what this HAL can decode is listed; the rest would fail on the first tap
+        bool IsPlayableFile(const std::string& name)
+        {
+            if (name.empty() || name[0] == '.' || name.rfind('.') == std::string::npos)
+            {
+                return false;
+            }
+            return GetHAL()->canPlayAudioFile(name);
+        }
+
         struct Track
         {
             const char* media_id;
@@ -45,25 +66,104 @@ namespace custom::integration
 
     MediaController::MediaController()
     {
-        page_ = ui_page_media_get_obj();
-        if (page_ != nullptr)
-        {
-            lv_obj_add_event_cb(page_, PageEventCb, UI_PAGE_MEDIA_EVENT_COMMAND, this);
-        }
+        BindPage();
     }
 
     MediaController::~MediaController()
     {
-        if (page_ != nullptr)
+        StopLocalPlayback();
+        local_tracks_.clear();
+        AttachArtwork(nullptr);
+        AttachPlayer(nullptr);
+        // A page that was rebuilt or torn down has taken the callback with it
+        if (page_ != nullptr && page_ == ui_page_media_get_obj())
         {
             lv_obj_remove_event_cb_with_user_data(page_, PageEventCb, this);
         }
     }
 
+    void MediaController::AttachPlayer(HaMediaPlayer* player)
+    {
+        if (player != nullptr)
+        {
+            StopLocalPlayback();
+        }
+        player_         = player;
+        pending_volume_ = -1;
+        UpdateRefreshTimer();
+    }
+
+    void MediaController::UpdateRefreshTimer()
+    {
+        const bool wanted = player_ != nullptr || !local_tracks_.empty();
+        if (wanted && refresh_timer_ == nullptr)
+        {
+            refresh_timer_ = lv_timer_create(RefreshTimerCb, kRefreshMs, this);
+        }
+        else if (!wanted && refresh_timer_ != nullptr)
+        {
+            lv_timer_delete(refresh_timer_);
+            refresh_timer_ = nullptr;
+        }
+    }
+
+    void MediaController::AttachArtwork(ArtworkLoader* artwork)
+    {
+        if (artwork_ != nullptr && page_ != nullptr && page_ == ui_page_media_get_obj())
+        {
+            // The page must not keep drawing pixels owned by the old loader
+            ui_page_media_set_artwork(nullptr);
+        }
+        artwork_ = artwork;
+        if (artwork_ != nullptr && player_ != nullptr)
+        {
+            PushPlayerView(true);
+        }
+    }
+
     void MediaController::PublishInitialState()
     {
+        // The controller is made before the launcher builds its pages
+        BindPage();
+        if (player_ == nullptr && local_tracks_.empty())
+        {
+            LoadLocalTracks();
+        }
         PushScenes();
-        PushNowPlaying();
+        PushNowPlaying(true);
+    }
+
+    void MediaController::BindPage()
+    {
+        lv_obj_t* page = ui_page_media_get_obj();
+        if (page == nullptr || page == page_)
+        {
+            return;
+        }
+        page_ = page;
+        lv_obj_add_event_cb(page_, PageEventCb, UI_PAGE_MEDIA_EVENT_COMMAND, this);
+    }
+
+    void MediaController::RefreshTimerCb(lv_timer_t* timer)
+    {
+        auto* controller = static_cast<MediaController*>(lv_timer_get_user_data(timer));
+        if (controller == nullptr)
+        {
+            return;
+        }
+        if (controller->player_ == nullptr)
+        {
+            controller->PollLocalPlayback();
+            return;
+        }
+        if (controller->pending_volume_ >= 0)
+        {
+            controller->player_->SetVolume(static_cast<std::uint8_t>(controller->pending_volume_),
+                                           lv_tick_get());
+            controller->pending_volume_ = -1;
+        }
+        controller->PushPlayerView(false);
+        controller->PushArtwork();
     }
 
     void MediaController::PageEventCb(lv_event_t* event)
@@ -90,6 +190,17 @@ namespace custom::integration
 
     void MediaController::HandleEvent(const ui_page_media_event_t& event)
     {
+        if (player_ != nullptr)
+        {
+            HandlePlayerEvent(event);
+            return;
+        }
+        if (!local_tracks_.empty())
+        {
+            HandleLocalEvent(event);
+            return;
+        }
+
         switch (event.signal)
         {
             case UI_PAGE_MEDIA_SIGNAL_PREVIOUS:
@@ -132,26 +243,215 @@ namespace custom::integration
                 break;
         }
 
-        PushNowPlaying();
+        PushNowPlaying(false);
+    }
+
+    void MediaController::HandlePlayerEvent(const ui_page_media_event_t& event)
+    {
+        const std::uint32_t now_ms = lv_tick_get();
+        bool                sent   = true;
+        switch (event.signal)
+        {
+            case UI_PAGE_MEDIA_SIGNAL_PREVIOUS:
+                sent = player_->Previous();
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_NEXT:
+                sent = player_->Next();
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_PLAY_PAUSE:
+                sent = player_->PlayPause(now_ms);
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_VOLUME:
+                // A drag fires on every move; the refresh timer sends the latest
+                pending_volume_ = std::min<std::uint8_t>(event.volume, 100U);
+                return;
+
+            case UI_PAGE_MEDIA_SIGNAL_TRIGGER_SCENE:
+                APP_TRACEI(kTag,
+                           "Trigger quick scene: %s",
+                           event.scene_id != nullptr ? event.scene_id : "(none)");
+                return;
+        }
+
+        if (!sent)
+        {
+            APP_TRACEI(kTag, "%s not reachable, command dropped", player_->EntityId().c_str());
+        }
+        PushPlayerView(false);
+    }
+
+    void MediaController::HandleLocalEvent(const ui_page_media_event_t& event)
+    {
+        switch (event.signal)
+        {
+            case UI_PAGE_MEDIA_SIGNAL_PREVIOUS:
+                track_index_ = (track_index_ + local_tracks_.size() - 1U) % local_tracks_.size();
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_NEXT:
+                track_index_ = (track_index_ + 1U) % local_tracks_.size();
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_PLAY_PAUSE:
+                if (playing_)
+                {
+                    StopLocalPlayback();
+                    PushNowPlaying(false);
+                    return;
+                }
+                playing_ = true;
+                break;
+
+            case UI_PAGE_MEDIA_SIGNAL_VOLUME:
+                volume_percent_ = std::min<uint8_t>(event.volume, 100U);
+                GetHAL()->setSpeakerVolume(volume_percent_);
+                return;
+
+            case UI_PAGE_MEDIA_SIGNAL_TRIGGER_SCENE:
+                APP_TRACEI(kTag,
+                           "Trigger quick scene: %s",
+                           event.scene_id != nullptr ? event.scene_id : "(none)");
+                return;
+        }
+
+        if (playing_)
+        {
+            // A skip stops the current file; the next one starts once the HAL has let go of it
+            if (GetHAL()->getMusicPlayTestState() != hal::HalBase::MUSIC_PLAY_IDLE)
+            {
+                GetHAL()->stopPlayMusicTest();
+            }
+            local_start_pending_ = true;
+            PollLocalPlayback();
+        }
+        PushNowPlaying(false);
+    }
+
+    void MediaController::LoadLocalTracks()
+    {
+        if (!GetHAL()->isSdCardMounted())
+        {
+            return;
+        }
+
+        const std::string dir = kMusicDir;
+        for (const hal::HalBase::FileEntry_t& entry : GetHAL()->scanSdCard(dir))
+        {
+            if (entry.isDir || !IsPlayableFile(entry.name))
+            {
+                continue;
+            }
+            local_tracks_.push_back(
+                LocalTrack{dir + "/" + entry.name, entry.name.substr(0, entry.name.rfind('.'))});
+            if (local_tracks_.size() >= kMaxLocalTracks)
+            {
+                break;
+            }
+        }
+        if (local_tracks_.empty())
+        {
+            return;
+        }
+
+        std::sort(local_tracks_.begin(),
+                  local_tracks_.end(),
+                  [](const LocalTrack& a, const LocalTrack& b) { return a.title < b.title; });
+        track_index_    = 0;
+        playing_        = false;  // nothing starts before the first tap
+        volume_percent_ = GetHAL()->getSpeakerVolume();
+        APP_TRACEI(kTag, "%u local tracks in %s", (unsigned)local_tracks_.size(), kMusicDir);
+        UpdateRefreshTimer();
+    }
+
+    void MediaController::PollLocalPlayback()
+    {
+        if (local_tracks_.empty() || !playing_)
+        {
+            return;
+        }
+        if (GetHAL()->getMusicPlayTestState() != hal::HalBase::MUSIC_PLAY_IDLE)
+        {
+            return;
+        }
+
+        if (!local_start_pending_)
+        {
+            // The file played out: carry on with the next one, and stop after the last
+            track_index_ = (track_index_ + 1U) % local_tracks_.size();
+            if (track_index_ == 0U)
+            {
+                playing_ = false;
+                PushNowPlaying(false);
+                return;
+            }
+        }
+
+        local_start_pending_    = false;
+        const LocalTrack& track = local_tracks_[track_index_];
+        if (!GetHAL()->playAudioFile(track.uri))
+        {
+            APP_TRACEI(kTag, "Cannot play %s", track.uri.c_str());
+            playing_ = false;
+        }
+        PushNowPlaying(false);
+    }
+
+    void MediaController::StopLocalPlayback()
+    {
+        if (local_tracks_.empty() || !playing_)
+        {
+            return;
+        }
+        playing_             = false;
+        local_start_pending_ = false;
+        GetHAL()->stopPlayMusicTest();
     }
 
-    void MediaController::PushNowPlaying()
+    void MediaController::PushNowPlaying(bool force)
     {
         if (page_ == nullptr)
         {
             return;
         }
+        if (player_ != nullptr)
+        {
+            PushPlayerView(force);
+            return;
+        }
+
+        if (!local_tracks_.empty())
+        {
+            const LocalTrack& local = local_tracks_[track_index_];
+
+            ui_page_media_now_playing_t now_playing = {
+                .media_id   = local.uri.c_str(),
+                .title      = local.title.c_str(),
+                .artist     = "SD Card",
+                .source     = "Speaker",
+                .playing    = playing_,
+                .volume     = volume_percent_,
+                .position_s = 0U,
+                .duration_s = 0U,
+            };
+            ui_page_media_set_now_playing(&now_playing);
+            return;
+        }
 
         const Track& track =
             kTracks.empty() ? Track{"media.none", "Idle", "", ""} : kTracks[track_index_];
 
         ui_page_media_now_playing_t now_playing = {
-            .media_id = track.media_id,
-            .title    = track.title,
-            .artist   = track.artist,
-            .source   = track.source,
-            .playing  = playing_,
-            .volume   = volume_percent_,
+            .media_id   = track.media_id,
+            .title      = track.title,
+            .artist     = track.artist,
+            .source     = track.source,
+            .playing    = playing_,
+            .volume     = volume_percent_,
+            .position_s = 0U,
+            .duration_s = 0U,  // the demo tracks have no timeline
         };
 
         ui_page_media_set_now_playing(&now_playing);
@@ -167,4 +467,75 @@ namespace custom::integration
         ui_page_media_set_quick_scenes(kScenes.data(), kScenes.size());
     }
 
+    void MediaController::PushPlayerView(bool force)
+    {
+        if (page_ == nullptr || player_ == nullptr)
+        {
+            return;
+        }
+
+        const std::uint32_t now_ms  = lv_tick_get();
+        HaMediaView         view;
+        const bool          changed = player_->TakeViewIfChanged(now_ms, view);
+        if (!changed && !force)
+        {
+            return;
+        }
+        if (!changed)
+        {
+            view = player_->View(now_ms);
+        }
+
+        ui_page_media_now_playing_t now_playing = {
+            .media_id   = player_->EntityId().c_str(),
+            .title      = view.available ? view.title.c_str() : "Unavailable",
+            .artist     = view.artist.c_str(),
+            .source     = view.source.c_str(),
+            .playing    = view.playing,
+            .volume     = view.volume,
+            .position_s = view.position_s,
+            .duration_s = view.available ? view.duration_s : 0U,
+        };
+        if (view.available && view.title.empty())
+        {
+            now_playing.title = nullptr;  // the page's "Nothing Playing"
+        }
+        if (pending_volume_ >= 0)
+        {
+            now_playing.volume = static_cast<std::uint8_t>(pending_volume_);
+        }
+
+        ui_page_media_set_now_playing(&now_playing);
+        if (artwork_ != nullptr)
+        {
+            // The old cover may be dropped from now on, so it leaves the page at once
+            artwork_->Show(view.available ? view.artwork_url : std::string());
+            PushArtwork();
+        }
+    }
+
+    void MediaController::PushArtwork()
+    {
+        const ArtworkImage* image = nullptr;
+        if (page_ == nullptr || artwork_ == nullptr || !artwork_->TakeReady(image))
+        {
+            return;
+        }
+        if (image == nullptr)
+        {
+            ui_page_media_set_artwork(nullptr);
+            return;
+        }
+
+        artwork_dsc_               = {};
+        artwork_dsc_.header.magic  = LV_IMAGE_HEADER_MAGIC;
+        artwork_dsc_.header.cf     = LV_COLOR_FORMAT_RGB565;
+        artwork_dsc_.header.w      = image->width;
+        artwork_dsc_.header.h      = image->height;
+        artwork_dsc_.header.stride = image->width * sizeof(std::uint16_t);
+        artwork_dsc_.data_size     = image->pixels.size() * sizeof(std::uint16_t);
+        artwork_dsc_.data          = reinterpret_cast<const std::uint8_t*>(image->pixels.data());
+        ui_page_media_set_artwork(&artwork_dsc_);
+    }
+
 }  // namespace custom::integration
@@ -7,6 +7,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #ifdef __has_include
 #    if __has_include("lvgl.h")
@@ -22,11 +24,25 @@
 #    include "lvgl/lvgl.h"
 #endif
 
+#include "integration/artwork_loader.h"
+#include "integration/ha_media_player.h"
 #include "ui/pages/ui_page_media.h"
 
 namespace custom::integration
 {
 
+    /**
+     * @brief Drives the media page, from a Home Assistant media_player when one is attached.
+     *
+     * Without a player it plays the files in the SD card's music folder that the HAL can decode
+     * (WAV and MP3 on the device, WAV on desktop), or cycles through built-in demo tracks when
+     * there are none. With one, transport buttons
+     * become service calls, and a 250 ms timer pushes the player's view to the page only when
+     * something shown has changed: once a second while a track plays, for the position.
+     * Volume drags are sent at most once per tick, latest value first. With an ArtworkLoader
+     * attached, the player's cover is requested as each track comes in and shown from the same
+     * tick once it is ready.
+     */
     class MediaController
     {
     public:
@@ -36,19 +52,47 @@ namespace custom::integration
         MediaController(const MediaController&)            = delete;
         MediaController& operator=(const MediaController&) = delete;
 
+        /** UI thread; nullptr goes back to the demo tracks. @p player must outlive it. */
+        void AttachPlayer(HaMediaPlayer* player);
+        /** UI thread; nullptr shows no covers. @p artwork must outlive it. */
+        void AttachArtwork(ArtworkLoader* artwork);
         void PublishInitialState();
 
     private:
         static void PageEventCb(lv_event_t* event);
+        static void RefreshTimerCb(lv_timer_t* timer);
 
+        void BindPage();
         void HandleEvent(const ui_page_media_event_t& event);
-        void PushNowPlaying();
+        void HandlePlayerEvent(const ui_page_media_event_t& event);
+        void HandleLocalEvent(const ui_page_media_event_t& event);
+        void PushNowPlaying(bool force);
+        void PushPlayerView(bool force);
         void PushScenes();
+        void PushArtwork();
+        void LoadLocalTracks();
+        void PollLocalPlayback();
+        void StopLocalPlayback();
+        void UpdateRefreshTimer();
 
-        lv_obj_t*    page_           = nullptr;
-        std::size_t  track_index_    = 0;
-        bool         playing_        = true;
-        std::uint8_t volume_percent_ = 40U;
+        struct LocalTrack
+        {
+            std::string uri;
+            std::string title;
+        };
+
+        lv_obj_t*      page_           = nullptr;
+        std::size_t    track_index_    = 0;
+        bool           playing_        = true;
+        std::uint8_t   volume_percent_ = 40U;
+        HaMediaPlayer* player_         = nullptr;
+        lv_timer_t*    refresh_timer_  = nullptr;
+        std::int16_t   pending_volume_ = -1;  // dragged, not sent yet
+        ArtworkLoader* artwork_        = nullptr;
+        lv_image_dsc_t artwork_dsc_    = {};  // the page shows this while a cover is up
+
+        std::vector<LocalTrack> local_tracks_;
+        bool                    local_start_pending_ = false;  // waiting for the HAL to go idle
     };
 
 }  // namespace custom::integration
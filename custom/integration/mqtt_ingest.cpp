@@ -0,0 +1,425 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/mqtt_ingest.h"
+
+#include <utility>
+
+#include "../app_trace.h"
+#include "integration/ha_json_tokenizer.h"
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        constexpr const char* kMqttIngestTag = "mqtt-ingest";
+
+        // Longest discovery topic or state value the ingest keeps
+        constexpr std::size_t kMaxTopicLength = 256U;
+        constexpr std::size_t kMaxStateLength = 255U;
+
+        /** Home Assistant maps the default payload_on/payload_off to "on"/"off". */
+        std::string_view MqttStateText(std::string_view payload)
+        {
+            if (payload == "ON")
+            {
+                return "on";
+            }
+            if (payload == "OFF")
+            {
+                return "off";
+            }
+            return payload;
+        }
+
+        /** "~/state" with base "zigbee2mqtt/lamp" -> "zigbee2mqtt/lamp/state". */
+        std::string ExpandBaseTopic(std::string topic, const std::string& base)
+        {
+            if (!topic.empty() && topic.front() == '~')
+            {
+                topic.replace(0U, 1U, base);
+            }
+            else if (!topic.empty() && topic.back() == '~')
+            {
+                topic.replace(topic.size() - 1U, 1U, base);
+            }
+            return topic;
+        }
+
+        bool IsTopicName(const std::string& topic)
+        {
+            return MqttFilterValid(topic) && topic.find_first_of("+#") == std::string::npos;
+        }
+
+        /** Read the next value as a string into @p out. False on malformed JSON. */
+        bool TakeConfigString(HaJsonTokenizer& json, std::string& out)
+        {
+            const HaJsonToken token = json.Next();
+            if (token == HaJsonToken::kString)
+            {
+                char text[kMaxTopicLength];
+                if (json.CopyText(text, sizeof(text)))
+                {
+                    out = text;
+                }
+                return true;
+            }
+            if (token == HaJsonToken::kObjectBegin || token == HaJsonToken::kArrayBegin)
+            {
+                return json.SkipValue();
+            }
+            return token != HaJsonToken::kError && token != HaJsonToken::kEnd;
+        }
+
+        /** {"state":"ON","brightness":128}; keys that are absent leave the value as it was. */
+        bool DecodeJsonState(const char*   payload,
+                             std::size_t   length,
+                             std::string&  state,
+                             std::int32_t& brightness)
+        {
+            HaJsonTokenizer json(payload, length);
+            bool            ok = json.Next() == HaJsonToken::kObjectBegin;
+            for (HaJsonToken token = ok ? json.Next() : HaJsonToken::kError;
+                 ok && token == HaJsonToken::kKey;
+                 token = ok ? json.Next() : HaJsonToken::kError)
+            {
+                const std::string_view key = json.Text();
+                if (key == "state")
+                {
+                    const HaJsonToken value = json.Next();
+                    ok = value == HaJsonToken::kString || value == HaJsonToken::kNull;
+                    if (value == HaJsonToken::kString && json.Text().size() <= kMaxStateLength)
+                    {
+                        state.assign(MqttStateText(json.Text()));
+                    }
+                }
+                else if (key == "brightness")
+                {
+                    // null while the light is off
+                    const HaJsonToken value  = json.Next();
+                    double            number = 0.0;
+                    ok = value == HaJsonToken::kNumber || value == HaJsonToken::kNull;
+                    if (value == HaJsonToken::kNumber && json.NumberValue(number) && number >= 0.0
+                        && number <= 255.0)
+                    {
+                        brightness = static_cast<std::int32_t>(number);
+                    }
+                }
+                else
+                {
+                    ok = json.SkipValue();
+                }
+            }
+            return ok && json.Depth() == 0U && json.Next() == HaJsonToken::kEnd;
+        }
+
+    }  // namespace
+
+    MqttIngest::MqttIngest(MqttTransport& transport,
+                           HaEntityStore& store,
+                           std::string    discovery_prefix) :
+        transport_(transport), store_(store), prefix_(std::move(discovery_prefix))
+    {
+        Rebuild();
+    }
+
+    void MqttIngest::SetChangeCallback(std::function<void()> callback)
+    {
+        on_change_ = std::move(callback);
+    }
+
+    void MqttIngest::OnConnected()
+    {
+        // Clean session: the broker has forgotten every subscription, so repeat them all.
+        // Retained configs and states arrive again in reply.
+        connected_ = true;
+        subscribed_.clear();
+        SubscribeOnce(prefix_ + "/+/+/config");
+        SubscribeOnce(prefix_ + "/+/+/+/config");
+        for (const Entity& entity : entities_)
+        {
+            SubscribeOnce(entity.state_topic);
+            SubscribeOnce(entity.brightness_topic);
+        }
+    }
+
+    void MqttIngest::OnDisconnected()
+    {
+        if (!connected_)
+        {
+            return;
+        }
+        connected_ = false;
+        subscribed_.clear();
+        if (!entities_.empty())
+        {
+            store_.MarkAllUnavailable();
+            NotifyChanged();
+        }
+    }
+
+    void MqttIngest::OnMessage(std::string_view topic, const char* payload, std::size_t length)
+    {
+        stats_.messages++;
+
+        // Discovery changes the trie, so it runs after the walk instead of inside it
+        bool              discovery = false;
+        const std::size_t matched   = trie_.Match(topic, [&](MqttTopicTrie::HandlerId id) {
+            const Route& route = routes_[id];
+            if (route.kind == RouteKind::kDiscovery)
+            {
+                discovery = true;
+            }
+            else
+            {
+                HandleState(route, payload, length);
+            }
+        });
+        if (matched == 0U)
+        {
+            stats_.unrouted++;
+        }
+        if (discovery)
+        {
+            HandleConfig(topic, payload, length);
+        }
+    }
+
+    void MqttIngest::HandleConfig(std::string_view topic, const char* payload, std::size_t length)
+    {
+        // <prefix>/<component>/[<node_id>/]<object_id>/config
+        const std::string_view path      = topic.substr(prefix_.size() + 1U);
+        const std::string_view component = path.substr(0U, path.find('/'));
+        std::string_view       object_id = path.substr(0U, path.rfind('/'));
+        object_id                        = object_id.substr(object_id.rfind('/') + 1U);
+
+        std::string state_topic;
+        std::string brightness_topic;
+        std::string base;
+        std::string schema;
+        std::string payload_object_id;
+        if (length > 0U)
+        {
+            HaJsonTokenizer json(payload, length);
+            bool            ok = json.Next() == HaJsonToken::kObjectBegin;
+            for (HaJsonToken token = ok ? json.Next() : HaJsonToken::kError;
+                 ok && token == HaJsonToken::kKey;
+                 token = ok ? json.Next() : HaJsonToken::kError)
+            {
+                // Home Assistant accepts the abbreviated and the full key names
+                const std::string_view key = json.Text();
+                if (key == "stat_t" || key == "state_topic")
+                {
+                    ok = TakeConfigString(json, state_topic);
+                }
+                else if (key == "bri_stat_t" || key == "brightness_state_topic")
+                {
+                    ok = TakeConfigString(json, brightness_topic);
+                }
+                else if (key == "~")
+                {
+                    ok = TakeConfigString(json, base);
+                }
+                else if (key == "schema")
+                {
+                    ok = TakeConfigString(json, schema);
+                }
+                else if (key == "obj_id" || key == "object_id")
+                {
+                    ok = TakeConfigString(json, payload_object_id);
+                }
+                else
+                {
+                    ok = json.SkipValue();
+                }
+            }
+            if (!ok || json.Depth() != 0U || json.Next() != HaJsonToken::kEnd)
+            {
+                stats_.parse_errors++;
+                APP_LOG_WARN(kMqttIngestTag,
+                             "malformed discovery config on %.*s",
+                             (int)topic.size(),
+                             topic.data());
+                return;
+            }
+        }
+
+        std::string entity_id(component);
+        entity_id += '.';
+        if (payload_object_id.empty())
+        {
+            entity_id.append(object_id.data(), object_id.size());
+        }
+        else
+        {
+            entity_id += payload_object_id;
+        }
+        if (!store_.Tracks(entity_id))
+        {
+            stats_.configs_other++;
+            return;
+        }
+        stats_.configs++;
+
+        state_topic      = ExpandBaseTopic(std::move(state_topic), base);
+        brightness_topic = ExpandBaseTopic(std::move(brightness_topic), base);
+        if (!IsTopicName(state_topic))
+        {
+            state_topic.clear();
+        }
+        if (!IsTopicName(brightness_topic))
+        {
+            brightness_topic.clear();
+        }
+
+        // An empty retained config means the entity was removed from Home Assistant
+        auto it = by_entity_id_.find(entity_id);
+        if (it == by_entity_id_.end())
+        {
+            if (length == 0U)
+            {
+                return;
+            }
+            it = by_entity_id_.emplace(entity_id, entities_.size()).first;
+            entities_.emplace_back();
+            entities_.back().entity_id = entity_id;
+        }
+        Entity&    entity      = entities_[it->second];
+        const bool json_schema = schema == "json";
+        if (entity.state_topic == state_topic && entity.brightness_topic == brightness_topic
+            && entity.json_schema == json_schema)
+        {
+            return;
+        }
+        entity.state_topic      = std::move(state_topic);
+        entity.brightness_topic = std::move(brightness_topic);
+        entity.json_schema      = json_schema;
+        Rebuild();
+        SubscribeOnce(entity.state_topic);
+        SubscribeOnce(entity.brightness_topic);
+
+        if (length == 0U)
+        {
+            entity.state      = "unavailable";
+            entity.brightness = -1;
+            ApplyEntity(entity);
+        }
+    }
+
+    void MqttIngest::HandleState(const Route& route, const char* payload, std::size_t length)
+    {
+        Entity& entity = entities_[route.entity];
+        switch (route.kind)
+        {
+            case RouteKind::kState:
+                if (length > kMaxStateLength)
+                {
+                    stats_.parse_errors++;
+                    return;
+                }
+                entity.state.assign(MqttStateText(std::string_view(payload, length)));
+                break;
+
+            case RouteKind::kBrightness:
+            {
+                // A bare number is a complete JSON document
+                HaJsonTokenizer json(payload, length);
+                double          value = 0.0;
+                if (json.Next() != HaJsonToken::kNumber || !json.NumberValue(value)
+                    || json.Next() != HaJsonToken::kEnd || value < 0.0 || value > 255.0)
+                {
+                    stats_.parse_errors++;
+                    return;
+                }
+                entity.brightness = static_cast<std::int32_t>(value);
+                break;
+            }
+
+            case RouteKind::kJsonState:
+                if (!DecodeJsonState(payload, length, entity.state, entity.brightness))
+                {
+                    stats_.parse_errors++;
+                    return;
+                }
+                break;
+
+            case RouteKind::kDiscovery:
+                return;
+        }
+        ApplyEntity(entity);
+    }
+
+    bool MqttIngest::ApplyEntity(Entity& entity)
+    {
+        if (!store_.Apply(entity.entity_id, entity.state, entity.brightness))
+        {
+            stats_.states_ignored++;
+            return false;
+        }
+        stats_.states_applied++;
+        NotifyChanged();
+        return true;
+    }
+
+    void MqttIngest::Rebuild()
+    {
+        trie_.Clear();
+        routes_.clear();
+        const auto add = [this](const std::string& filter, RouteKind kind, std::size_t entity) {
+            if (!filter.empty()
+                && trie_.Add(filter, static_cast<MqttTopicTrie::HandlerId>(routes_.size())))
+            {
+                routes_.push_back(Route{kind, entity});
+            }
+        };
+        add(prefix_ + "/+/+/config", RouteKind::kDiscovery, 0U);
+        add(prefix_ + "/+/+/+/config", RouteKind::kDiscovery, 0U);
+        for (std::size_t i = 0; i < entities_.size(); ++i)
+        {
+            const Entity& entity = entities_[i];
+            add(entity.state_topic,
+                entity.json_schema ? RouteKind::kJsonState : RouteKind::kState,
+                i);
+            add(entity.brightness_topic, RouteKind::kBrightness, i);
+        }
+        trie_.Compile();
+        stats_.recompiles++;
+    }
+
+    void MqttIngest::SubscribeOnce(const std::string& filter)
+    {
+        if (!connected_ || filter.empty() || subscribed_.count(filter) > 0U)
+        {
+            return;
+        }
+        if (!transport_.Subscribe(filter))
+        {
+            APP_LOG_WARN(kMqttIngestTag, "subscribe to %s failed", filter.c_str());
+            return;
+        }
+        subscribed_.insert(filter);
+    }
+
+    void MqttIngest::NotifyChanged()
+    {
+        if (on_change_)
+        {
+            on_change_();
+        }
+    }
+
+    std::size_t MqttIngest::SubscriptionCount() const
+    {
+        return subscribed_.size();
+    }
+
+    MqttIngest::Stats MqttIngest::GetStats() const
+    {
+        return stats_;
+    }
+
+}  // namespace custom::integration
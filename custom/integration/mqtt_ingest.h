@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/mqtt_topic_trie.h"
+
+namespace custom::integration
+{
+
+    /** Subscribes on an open MQTT session. */
+    class MqttTransport
+    {
+    public:
+        virtual ~MqttTransport() = default;
+
+        /** False if the request could not be queued; the ingest retries on the next connect. */
+        virtual bool Subscribe(const std::string& filter) = 0;
+    };
+
+    /**
+     * @brief Keeps an HaEntityStore current from Home Assistant MQTT discovery and state topics.
+     *
+     * On connect it subscribes to the discovery configs under the prefix
+     * ("homeassistant/<component>/[<node_id>/]<object_id>/config"). A config for an entity the
+     * store tracks (entity id "<component>.<object_id>", or the payload's object_id) names its
+     * state topics; those are subscribed and added to an MqttTopicTrie, which is recompiled
+     * only when the set of topics changes. Every message is then routed by one trie walk, so
+     * the cost per message follows the topic length rather than the number of subscriptions.
+     * Configs for untracked entities are dropped after the topic is parsed.
+     *
+     * Understands the default and JSON light schemas (state_topic, brightness_state_topic,
+     * "~" abbreviations) and plain-text sensor states. ON/OFF payloads become "on"/"off" as in
+     * Home Assistant. State messages are decoded with HaJsonTokenizer and do not allocate.
+     *
+     * Transport-agnostic like HaWsClient: the owner feeds OnConnected(), OnMessage() and
+     * OnDisconnected() from one task (the esp-mqtt event task on the device, MqttStubBroker in
+     * host tests). The change callback runs on that task when a tracked entity changed.
+     */
+    class MqttIngest
+    {
+    public:
+        struct Stats
+        {
+            std::uint32_t messages       = 0U;
+            std::uint32_t unrouted       = 0U;  // no filter matched
+            std::uint32_t configs        = 0U;  // discovery configs for tracked entities
+            std::uint32_t configs_other  = 0U;  // for entities the store does not track
+            std::uint32_t states_applied = 0U;  // tracked entity changed
+            std::uint32_t states_ignored = 0U;  // no visible change
+            std::uint32_t parse_errors   = 0U;
+            std::uint32_t recompiles     = 0U;
+        };
+
+        static constexpr const char* kDefaultDiscoveryPrefix = "homeassistant";
+
+        MqttIngest(MqttTransport& transport,
+                   HaEntityStore& store,
+                   std::string    discovery_prefix = kDefaultDiscoveryPrefix);
+
+        MqttIngest(const MqttIngest&)            = delete;
+        MqttIngest& operator=(const MqttIngest&) = delete;
+
+        void SetChangeCallback(std::function<void()> callback);
+
+        void OnConnected();
+        void OnDisconnected();
+        void OnMessage(std::string_view topic, const char* payload, std::size_t length);
+
+        std::size_t SubscriptionCount() const;
+        Stats       GetStats() const;
+
+    private:
+        enum class RouteKind : std::uint8_t
+        {
+            kDiscovery,
+            kState,       // plain ON/OFF or sensor value
+            kJsonState,   // {"state":"ON","brightness":128}
+            kBrightness,  // plain 0..255
+        };
+
+        struct Route
+        {
+            RouteKind   kind;
+            std::size_t entity;
+        };
+
+        struct Entity
+        {
+            std::string  entity_id;
+            std::string  state_topic;
+            std::string  brightness_topic;
+            bool         json_schema = false;
+            std::string  state       = "unknown";  // last state, for brightness-only messages
+            std::int32_t brightness  = -1;
+        };
+
+        void HandleConfig(std::string_view topic, const char* payload, std::size_t length);
+        void HandleState(const Route& route, const char* payload, std::size_t length);
+        bool ApplyEntity(Entity& entity);
+        void Rebuild();
+        void SubscribeOnce(const std::string& filter);
+        void NotifyChanged();
+
+        MqttTransport&                               transport_;
+        HaEntityStore&                               store_;
+        std::string                                  prefix_;
+        std::function<void()>                        on_change_;
+        bool                                         connected_ = false;
+        std::vector<Entity>                          entities_;
+        std::unordered_map<std::string, std::size_t> by_entity_id_;
+        std::set<std::string>                        subscribed_;  // this session
+        std::vector<Route>                           routes_;      // indexed by trie handler id
+        MqttTopicTrie                                trie_;
+        Stats                                        stats_;
+    };
+
+}  // namespace custom::integration
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/mqtt_stub_broker.h"
+
+#include <utility>
+
+#include "integration/mqtt_topic_trie.h"
+
+namespace custom::integration
+{
+
+    void MqttStubBroker::Attach(MqttIngest* client)
+    {
+        client_ = client;
+    }
+
+    void MqttStubBroker::Connect()
+    {
+        outbox_.clear();
+        subscriptions_.clear();
+        connected_ = true;
+        if (client_ != nullptr)
+        {
+            client_->OnConnected();
+        }
+    }
+
+    void MqttStubBroker::Disconnect()
+    {
+        outbox_.clear();
+        subscriptions_.clear();
+        connected_ = false;
+        if (client_ != nullptr)
+        {
+            client_->OnDisconnected();
+        }
+    }
+
+    void MqttStubBroker::Publish(const std::string& topic, const std::string& payload, bool retain)
+    {
+        if (retain && payload.empty())
+        {
+            retained_.erase(topic);
+        }
+        else if (retain)
+        {
+            retained_[topic] = payload;
+        }
+        if (connected_ && Subscribed(topic))
+        {
+            outbox_.push_back(Message{topic, payload});
+        }
+    }
+
+    std::size_t MqttStubBroker::Pump(std::size_t max)
+    {
+        std::size_t delivered = 0U;
+        while (delivered < max && !outbox_.empty() && client_ != nullptr)
+        {
+            // Subscriptions the client makes in reply queue more, so pop first
+            const Message message = std::move(outbox_.front());
+            outbox_.pop_front();
+            client_->OnMessage(message.topic, message.payload.data(), message.payload.size());
+            delivered++;
+        }
+        return delivered;
+    }
+
+    std::size_t MqttStubBroker::PendingMessages() const
+    {
+        return outbox_.size();
+    }
+
+    const std::vector<std::string>& MqttStubBroker::Subscriptions() const
+    {
+        return subscriptions_;
+    }
+
+    bool MqttStubBroker::Subscribe(const std::string& filter)
+    {
+        if (!connected_ || !MqttFilterValid(filter))
+        {
+            return false;
+        }
+        subscriptions_.push_back(filter);
+        for (const auto& [topic, payload] : retained_)
+        {
+            if (MqttTopicMatches(filter, topic))
+            {
+                outbox_.push_back(Message{topic, payload});
+            }
+        }
+        return true;
+    }
+
+    bool MqttStubBroker::Subscribed(const std::string& topic) const
+    {
+        for (const std::string& filter : subscriptions_)
+        {
+            if (MqttTopicMatches(filter, topic))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}  // namespace custom::integration
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "integration/mqtt_ingest.h"
+
+namespace custom::integration
+{
+
+    /**
+     * @brief In-process stand-in for an MQTT broker, for host tests.
+     *
+     * Keeps retained messages and one client's subscriptions, matching topics with
+     * MqttTopicMatches(); a new subscription gets the retained messages it matches, as from a
+     * real broker. It doubles as the ingest's transport. Messages for the client are queued and
+     * only delivered by Pump(), so a test controls how they interleave.
+     */
+    class MqttStubBroker : public MqttTransport
+    {
+    public:
+        void Attach(MqttIngest* client);
+
+        /** Open a clean session: the client sees OnConnected(). */
+        void Connect();
+        /** Drop the session, its subscriptions and any undelivered messages. */
+        void Disconnect();
+
+        /** Publish as another client would. An empty retained payload clears the retained one. */
+        void Publish(const std::string& topic, const std::string& payload, bool retain = false);
+
+        /** Deliver up to @p max queued messages to the client; returns how many. */
+        std::size_t Pump(std::size_t max = SIZE_MAX);
+        std::size_t PendingMessages() const;
+
+        const std::vector<std::string>& Subscriptions() const;
+
+        // MqttTransport: requests from the client
+        bool Subscribe(const std::string& filter) override;
+
+    private:
+        struct Message
+        {
+            std::string topic;
+            std::string payload;
+        };
+
+        bool Subscribed(const std::string& topic) const;
+
+        MqttIngest*                        client_    = nullptr;
+        bool                               connected_ = false;
+        std::map<std::string, std::string> retained_;
+        std::vector<std::string>           subscriptions_;
+        std::deque<Message>                outbox_;
+    };
+
+}  // namespace custom::integration
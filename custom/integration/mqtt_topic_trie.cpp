@@ -0,0 +1,260 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "integration/mqtt_topic_trie.h"
+
+#include <cstring>
+
+namespace custom::integration
+{
+
+    namespace
+    {
+
+        /** Splits "a/b/c" into levels, including empty ones ("a//b", "/a"). */
+        class TopicLevels
+        {
+        public:
+            explicit TopicLevels(std::string_view text) : text_(text)
+            {
+            }
+
+            bool Next(std::string_view& level)
+            {
+                if (done_)
+                {
+                    return false;
+                }
+                const std::size_t slash = text_.find('/', start_);
+                level                   = text_.substr(start_, slash - start_);
+                done_                   = slash == std::string_view::npos;
+                start_                  = done_ ? text_.size() : slash + 1U;
+                return true;
+            }
+
+        private:
+            std::string_view text_;
+            std::size_t      start_ = 0U;
+            bool             done_  = false;
+        };
+
+        std::size_t RoundUpPowerOfTwo(std::size_t value)
+        {
+            std::size_t size = 1U;
+            while (size < value)
+            {
+                size <<= 1U;
+            }
+            return size;
+        }
+
+    }  // namespace
+
+    bool MqttFilterValid(std::string_view filter)
+    {
+        if (filter.empty())
+        {
+            return false;
+        }
+        TopicLevels      levels(filter);
+        std::string_view level;
+        bool             after_hash = false;
+        while (levels.Next(level))
+        {
+            if (after_hash)
+            {
+                return false;  // '#' must be the last level
+            }
+            if (level == "#")
+            {
+                after_hash = true;
+            }
+            else if (level != "+" && level.find_first_of("+#") != std::string_view::npos)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool MqttTopicMatches(std::string_view filter, std::string_view topic)
+    {
+        if (!topic.empty() && topic[0] == '$' && !filter.empty()
+            && (filter[0] == '+' || filter[0] == '#'))
+        {
+            return false;
+        }
+        TopicLevels      filter_levels(filter);
+        TopicLevels      topic_levels(topic);
+        std::string_view wanted;
+        std::string_view level;
+        while (filter_levels.Next(wanted))
+        {
+            if (wanted == "#")
+            {
+                return true;
+            }
+            if (!topic_levels.Next(level) || (wanted != "+" && wanted != level))
+            {
+                return false;
+            }
+        }
+        return !topic_levels.Next(level);
+    }
+
+    bool MqttTopicTrie::Add(std::string_view filter, HandlerId handler)
+    {
+        if (!MqttFilterValid(filter))
+        {
+            return false;
+        }
+        std::uint32_t    node = 0U;
+        TopicLevels      levels(filter);
+        std::string_view level;
+        while (levels.Next(level))
+        {
+            if (level == "#")
+            {
+                build_[node].hash.push_back(handler);
+                filters_++;
+                return true;
+            }
+            node = BuildChild(node, level);
+        }
+        build_[node].exact.push_back(handler);
+        filters_++;
+        return true;
+    }
+
+    void MqttTopicTrie::Clear()
+    {
+        build_.assign(1U, BuildNode{});
+        filters_ = 0U;
+        nodes_.clear();
+        handlers_.clear();
+        edges_.clear();
+        levels_.clear();
+    }
+
+    void MqttTopicTrie::Compile()
+    {
+        nodes_.clear();
+        handlers_.clear();
+        levels_.clear();
+
+        std::size_t edge_count = 0U;
+        for (const BuildNode& node : build_)
+        {
+            edge_count += node.children.size();
+        }
+        edges_.assign(RoundUpPowerOfTwo(edge_count * 2U + 1U), Edge{});
+
+        nodes_.reserve(build_.size());
+        for (std::uint32_t i = 0; i < build_.size(); ++i)
+        {
+            const BuildNode& built = build_[i];
+            Node             node;
+            node.plus        = built.plus;
+            node.exact_begin = static_cast<std::uint32_t>(handlers_.size());
+            handlers_.insert(handlers_.end(), built.exact.begin(), built.exact.end());
+            node.exact_end  = static_cast<std::uint32_t>(handlers_.size());
+            node.hash_begin = node.exact_end;
+            handlers_.insert(handlers_.end(), built.hash.begin(), built.hash.end());
+            node.hash_end = static_cast<std::uint32_t>(handlers_.size());
+            nodes_.push_back(node);
+
+            for (const auto& [level, child] : built.children)
+            {
+                InsertEdge(i, level, child);
+            }
+        }
+    }
+
+    std::size_t MqttTopicTrie::FilterCount() const
+    {
+        return filters_;
+    }
+
+    std::size_t MqttTopicTrie::NodeCount() const
+    {
+        return build_.size();
+    }
+
+    std::uint32_t MqttTopicTrie::HashLevel(std::uint32_t parent, std::string_view level)
+    {
+        // FNV-1a over the parent index and the level text
+        std::uint32_t hash = 2166136261U ^ parent;
+        hash *= 16777619U;
+        for (char c : level)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    std::uint32_t MqttTopicTrie::FindChild(std::uint32_t node, std::string_view level) const
+    {
+        const std::uint32_t hash = HashLevel(node, level);
+        const std::size_t   mask = edges_.size() - 1U;
+        for (std::size_t slot = hash & mask;; slot = (slot + 1U) & mask)
+        {
+            const Edge& edge = edges_[slot];
+            if (edge.parent == kNone)
+            {
+                return kNone;
+            }
+            if (edge.parent == node && edge.hash == hash && edge.length == level.size()
+                && std::memcmp(levels_.data() + edge.text, level.data(), level.size()) == 0)
+            {
+                return edge.child;
+            }
+        }
+    }
+
+    std::uint32_t MqttTopicTrie::BuildChild(std::uint32_t node, std::string_view level)
+    {
+        if (level == "+")
+        {
+            if (build_[node].plus == kNone)
+            {
+                build_[node].plus = static_cast<std::uint32_t>(build_.size());
+                build_.emplace_back();
+            }
+            return build_[node].plus;
+        }
+        const auto it = build_[node].children.find(level);
+        if (it != build_[node].children.end())
+        {
+            return it->second;
+        }
+        const auto child = static_cast<std::uint32_t>(build_.size());
+        build_[node].children.emplace(std::string(level), child);
+        build_.emplace_back();  // invalidates references into build_, so after the emplace
+        return child;
+    }
+
+    void MqttTopicTrie::InsertEdge(std::uint32_t    parent,
+                                   std::string_view level,
+                                   std::uint32_t    child)
+    {
+        Edge edge;
+        edge.parent = parent;
+        edge.hash   = HashLevel(parent, level);
+        edge.text   = static_cast<std::uint32_t>(levels_.size());
+        edge.length = static_cast<std::uint32_t>(level.size());
+        edge.child  = child;
+        levels_.append(level.data(), level.size());
+
+        const std::size_t mask = edges_.size() - 1U;
+        std::size_t       slot = edge.hash & mask;
+        while (edges_[slot].parent != kNone)
+        {
+            slot = (slot + 1U) & mask;
+        }
+        edges_[slot] = edge;
+    }
+
+}  // namespace custom::integration
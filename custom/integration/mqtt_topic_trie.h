@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace custom::integration
+{
+
+    /** True if @p filter is a valid MQTT subscription filter ('+' and '#' as whole levels). */
+    bool MqttFilterValid(std::string_view filter);
+
+    /**
+     * True if @p topic matches @p filter under the MQTT rules: '+' is one level, a trailing '#'
+     * is any number of levels including none, and wildcards in the first level do not match
+     * topics starting with '$'. Linear scan; the stub broker and the tests use it as reference.
+     */
+    bool MqttTopicMatches(std::string_view filter, std::string_view topic);
+
+    /**
+     * @brief Routes MQTT topics to handler ids through a compiled topic trie.
+     *
+     * Add() collects filters into a build tree. Compile() flattens it: every exact level edge
+     * goes into one open-addressing table keyed by (parent node, level text), and the handlers
+     * of each node sit in a contiguous range. Match() splits the topic once and walks it a
+     * level at a time, one hash probe per level, following the '+' branch alongside. Routing
+     * therefore costs O(topic length) for exact filters, whatever the number of subscriptions,
+     * plus the wildcard branches that actually exist at each level. Matching does not allocate.
+     *
+     * Add() and Compile() must not run concurrently with Match(); callers that learn new
+     * filters at runtime (discovery) recompile on the thread that routes.
+     */
+    class MqttTopicTrie
+    {
+    public:
+        using HandlerId = std::uint32_t;
+
+        /** Topics with more levels than this match nothing. */
+        static constexpr std::size_t kMaxLevels = 24U;
+
+        /** False if @p filter is invalid. Takes effect at the next Compile(). */
+        bool Add(std::string_view filter, HandlerId handler);
+        void Clear();
+        void Compile();
+
+        std::size_t FilterCount() const;
+        std::size_t NodeCount() const;
+
+        /** Calls @p on_match(HandlerId) for each matching filter; returns how many matched. */
+        template <typename OnMatch>
+        std::size_t Match(std::string_view topic, OnMatch&& on_match) const;
+
+    private:
+        static constexpr std::uint32_t kNone = UINT32_MAX;
+
+        struct BuildNode
+        {
+            std::map<std::string, std::uint32_t, std::less<>> children;
+            std::uint32_t                                     plus = kNone;
+            std::vector<HandlerId>                            exact;  // filter ends here
+            std::vector<HandlerId>                            hash;   // filter ends in '#' here
+        };
+
+        struct Node
+        {
+            std::uint32_t plus;
+            std::uint32_t exact_begin;
+            std::uint32_t exact_end;
+            std::uint32_t hash_begin;
+            std::uint32_t hash_end;
+        };
+
+        struct Edge
+        {
+            std::uint32_t parent = kNone;  // kNone marks an empty slot
+            std::uint32_t hash   = 0U;
+            std::uint32_t text   = 0U;  // offset into levels_
+            std::uint32_t length = 0U;
+            std::uint32_t child  = 0U;
+        };
+
+        static std::uint32_t HashLevel(std::uint32_t parent, std::string_view level);
+        std::uint32_t        FindChild(std::uint32_t node, std::string_view level) const;
+        std::uint32_t        BuildChild(std::uint32_t node, std::string_view level);
+        void                 InsertEdge(std::uint32_t    parent,
+                                        std::string_view level,
+                                        std::uint32_t    child);
+
+        std::vector<BuildNode> build_{1U};
+        std::size_t            filters_ = 0U;
+
+        // Compiled form, read by Match()
+        std::vector<Node>      nodes_;
+        std::vector<HandlerId> handlers_;
+        std::vector<Edge>      edges_;  // power-of-two sized, at most half full
+        std::string            levels_;
+    };
+
+    template <typename OnMatch>
+    std::size_t MqttTopicTrie::Match(std::string_view topic, OnMatch&& on_match) const
+    {
+        if (nodes_.empty())
+        {
+            return 0U;
+        }
+
+        std::array<std::string_view, kMaxLevels> levels;
+        std::size_t                              level_count = 0U;
+        std::size_t                              start       = 0U;
+        for (;;)
+        {
+            if (level_count == kMaxLevels)
+            {
+                return 0U;
+            }
+            const std::size_t slash = topic.find('/', start);
+            levels[level_count++]   = topic.substr(start, slash - start);
+            if (slash == std::string_view::npos)
+            {
+                break;
+            }
+            start = slash + 1U;
+        }
+        const bool system_topic = !topic.empty() && topic[0] == '$';
+
+        std::size_t found = 0U;
+        std::size_t depth = 0U;
+        // (node, levels consumed); each pop pushes at most two entries, one level deeper
+        std::array<std::pair<std::uint32_t, std::uint32_t>, kMaxLevels + 2U> stack;
+
+        stack[depth++] = {0U, 0U};
+        while (depth > 0U)
+        {
+            const auto [index, level] = stack[--depth];
+            const Node& node          = nodes_[index];
+            const bool  wildcards_ok  = level > 0U || !system_topic;
+            if (wildcards_ok)
+            {
+                for (std::uint32_t h = node.hash_begin; h < node.hash_end; ++h)
+                {
+                    on_match(handlers_[h]);
+                    found++;
+                }
+            }
+            if (level == level_count)
+            {
+                for (std::uint32_t h = node.exact_begin; h < node.exact_end; ++h)
+                {
+                    on_match(handlers_[h]);
+                    found++;
+                }
+                continue;
+            }
+            const std::uint32_t child = FindChild(index, levels[level]);
+            if (child != kNone)
+            {
+                stack[depth++] = {child, level + 1U};
+            }
+            if (node.plus != kNone && wildcards_ok)
+            {
+                stack[depth++] = {node.plus, level + 1U};
+            }
+        }
+        return found;
+    }
+
+}  // namespace custom::integration
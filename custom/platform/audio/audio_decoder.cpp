@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint16_t kWaveFormatPcm        = 0x0001U;
+        constexpr std::uint16_t kWaveFormatExtensible = 0xFFFEU;
+
+        std::uint16_t ReadLe16(const std::uint8_t* p)
+        {
+            return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        std::uint32_t ReadLe32(const std::uint8_t* p)
+        {
+            return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+                   | (static_cast<std::uint32_t>(p[2]) << 16)
+                   | (static_cast<std::uint32_t>(p[3]) << 24);
+        }
+
+        bool ReadExact(AudioSource& source, std::uint8_t* dst, std::size_t len)
+        {
+            std::size_t done = 0U;
+            while (done < len)
+            {
+                const std::size_t got = source.Read(dst + done, len - done);
+                if (got == 0U)
+                {
+                    return false;
+                }
+                done += got;
+            }
+            return true;
+        }
+
+    }  // namespace
+
+    /* ---- Raw PCM ---- */
+
+    PcmDecoder::PcmDecoder(const PcmFormat& format)
+    {
+        SetFormat(format);
+    }
+
+    bool PcmDecoder::SetFormat(const PcmFormat& format)
+    {
+        if (format.channels == 0U || format.sample_rate == 0U
+            || (format.bits_per_sample != 8U && format.bits_per_sample != 16U))
+        {
+            return false;
+        }
+        format_          = format;
+        bytes_per_frame_ = static_cast<std::size_t>(format.channels) * (format.bits_per_sample / 8U);
+        return true;
+    }
+
+    bool PcmDecoder::Open(AudioSource& source)
+    {
+        source_ = &source;
+        carry_  = 0U;
+        end_    = false;
+        return bytes_per_frame_ > 0U;
+    }
+
+    PcmFormat PcmDecoder::Format() const
+    {
+        return format_;
+    }
+
+    bool PcmDecoder::AtEnd() const
+    {
+        return end_;
+    }
+
+    std::size_t PcmDecoder::Decode(std::int16_t* dst, std::size_t max_frames)
+    {
+        if (source_ == nullptr || dst == nullptr || end_ || max_frames == 0U)
+        {
+            return 0U;
+        }
+
+        const std::size_t chunk_bytes = max_frames * bytes_per_frame_;
+        if (scratch_.size() < chunk_bytes)
+        {
+            scratch_.resize(chunk_bytes);
+        }
+
+        const std::size_t want = std::min(chunk_bytes - carry_, data_remaining_);
+        const std::size_t got  = want > 0U ? source_->Read(scratch_.data() + carry_, want) : 0U;
+        if (data_remaining_ != SIZE_MAX)
+        {
+            data_remaining_ -= got;
+        }
+
+        const std::size_t total  = carry_ + got;
+        const std::size_t frames = total / bytes_per_frame_;
+        const std::size_t values = frames * format_.channels;
+
+        const std::uint8_t* in = scratch_.data();
+        if (format_.bits_per_sample == 16U)
+        {
+            for (std::size_t i = 0; i < values; ++i)
+            {
+                dst[i] = static_cast<std::int16_t>(ReadLe16(in + i * 2U));
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < values; ++i)
+            {
+                dst[i] = static_cast<std::int16_t>((static_cast<int>(in[i]) - 128) * 256);
+            }
+        }
+
+        // A partial frame stays in front of the scratch buffer until the rest arrives.
+        carry_ = total - frames * bytes_per_frame_;
+        if (carry_ > 0U)
+        {
+            std::memmove(scratch_.data(), scratch_.data() + frames * bytes_per_frame_, carry_);
+        }
+
+        if (data_remaining_ == 0U || source_->AtEnd())
+        {
+            end_ = true;
+        }
+        return frames;
+    }
+
+    /* ---- WAV ---- */
+
+    bool WavDecoder::Open(AudioSource& source)
+    {
+        std::uint8_t riff[12];
+        if (!ReadExact(source, riff, sizeof(riff)) || std::memcmp(riff, "RIFF", 4) != 0
+            || std::memcmp(riff + 8, "WAVE", 4) != 0)
+        {
+            return false;
+        }
+
+        bool have_format = false;
+        while (true)
+        {
+            std::uint8_t header[8];
+            if (!ReadExact(source, header, sizeof(header)))
+            {
+                return false;
+            }
+            const std::uint32_t size   = ReadLe32(header + 4);
+            const std::size_t   padded = size + (size & 1U);
+
+            if (std::memcmp(header, "fmt ", 4) == 0)
+            {
+                std::uint8_t fmt[16];
+                if (size < sizeof(fmt) || !ReadExact(source, fmt, sizeof(fmt)))
+                {
+                    return false;
+                }
+                const std::uint16_t tag = ReadLe16(fmt);
+                if (tag != kWaveFormatPcm && tag != kWaveFormatExtensible)
+                {
+                    return false;
+                }
+
+                PcmFormat format;
+                format.channels        = static_cast<std::uint8_t>(ReadLe16(fmt + 2));
+                format.sample_rate     = ReadLe32(fmt + 4);
+                format.bits_per_sample = static_cast<std::uint8_t>(ReadLe16(fmt + 14));
+                if (!SetFormat(format)
+                    || !source.Seek(source.Tell() + (padded - sizeof(fmt))))
+                {
+                    return false;
+                }
+                have_format = true;
+            }
+            else if (std::memcmp(header, "data", 4) == 0)
+            {
+                if (!have_format)
+                {
+                    return false;
+                }
+                // Streamed WAVs often carry a placeholder size; trust the source instead.
+                data_remaining_ = (size == 0U || size == 0xFFFFFFFFU) ? SIZE_MAX : size;
+                return PcmDecoder::Open(source);
+            }
+            else if (!source.Seek(source.Tell() + padded))
+            {
+                return false;
+            }
+        }
+    }
+
+}  // namespace custom::platform
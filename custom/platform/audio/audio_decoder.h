@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "platform/audio/audio_source.h"
+
+namespace custom::platform
+{
+
+    struct PcmFormat
+    {
+        std::uint32_t sample_rate     = 48000U;
+        std::uint8_t  channels        = 2U;
+        std::uint8_t  bits_per_sample = 16U;
+    };
+
+    /**
+     * @brief Turns bytes pulled from an AudioSource into interleaved signed 16-bit PCM.
+     *
+     * Decode() works on bounded chunks so the caller controls how much is resident at once.
+     * Output keeps the source channel count; AudioStream takes care of the stereo mix-down.
+     */
+    class AudioDecoder
+    {
+    public:
+        virtual ~AudioDecoder() = default;
+
+        virtual bool      Open(AudioSource& source) = 0;
+        virtual PcmFormat Format() const            = 0;
+
+        /** Decode up to @p max_frames frames into @p dst, returns the number of frames written. */
+        virtual std::size_t Decode(std::int16_t* dst, std::size_t max_frames) = 0;
+
+        /** True once every frame of the source has been returned. */
+        virtual bool AtEnd() const = 0;
+    };
+
+    /** Headerless little-endian PCM (8-bit unsigned or 16-bit signed). */
+    class PcmDecoder : public AudioDecoder
+    {
+    public:
+        PcmDecoder() = default;
+        explicit PcmDecoder(const PcmFormat& format);
+
+        bool        Open(AudioSource& source) override;
+        PcmFormat   Format() const override;
+        std::size_t Decode(std::int16_t* dst, std::size_t max_frames) override;
+        bool        AtEnd() const override;
+
+    protected:
+        bool SetFormat(const PcmFormat& format);
+
+        AudioSource* source_ = nullptr;
+        PcmFormat    format_;
+        std::size_t  bytes_per_frame_ = 4U;
+        /** Bytes of PCM payload still to read; SIZE_MAX when bounded only by the source. */
+        std::size_t data_remaining_ = SIZE_MAX;
+
+    private:
+        std::vector<std::uint8_t> scratch_;
+        std::size_t               carry_ = 0U;
+        bool                      end_   = false;
+    };
+
+    /** RIFF/WAVE container around PCM data. */
+    class WavDecoder : public PcmDecoder
+    {
+    public:
+        bool Open(AudioSource& source) override;
+    };
+
+}  // namespace custom::platform
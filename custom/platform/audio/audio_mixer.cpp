@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_mixer.h"
+
+#include <algorithm>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        std::uint16_t PercentToQ8(std::uint8_t percent)
+        {
+            return static_cast<std::uint16_t>((std::min<std::uint8_t>(percent, 100U) * 256U) / 100U);
+        }
+
+    }  // namespace
+
+    bool AudioMixer::AddVoice(AudioStream* stream, std::uint8_t gain_percent)
+    {
+        if (stream == nullptr)
+        {
+            return false;
+        }
+        for (auto& voice : voices_)
+        {
+            if (voice.stream == nullptr)
+            {
+                voice.stream = stream;
+                voice.gain   = PercentToQ8(gain_percent);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AudioMixer::RemoveVoice(AudioStream* stream)
+    {
+        for (auto& voice : voices_)
+        {
+            if (voice.stream == stream)
+            {
+                voice = Voice{};
+            }
+        }
+    }
+
+    void AudioMixer::SetMasterVolume(std::uint8_t percent)
+    {
+        master_ = PercentToQ8(percent);
+    }
+
+    std::size_t AudioMixer::ActiveVoices() const
+    {
+        return static_cast<std::size_t>(std::count_if(
+            voices_.begin(), voices_.end(), [](const Voice& v) { return v.stream != nullptr; }));
+    }
+
+    std::size_t AudioMixer::Mix(std::int16_t* out, std::size_t frames)
+    {
+        if (out == nullptr)
+        {
+            return 0U;
+        }
+
+        std::int32_t* acc       = acc_.data();
+        std::int16_t* voice_buf = voice_buf_.data();
+        std::size_t   produced  = 0U;
+
+        for (std::size_t done = 0; done < frames; done += kBlockFrames)
+        {
+            const std::size_t block   = std::min(kBlockFrames, frames - done);
+            const std::size_t samples = block * 2U;
+            std::fill(acc, acc + samples, 0);
+
+            std::size_t block_max = 0U;
+            for (auto& voice : voices_)
+            {
+                if (voice.stream == nullptr)
+                {
+                    continue;
+                }
+                const std::size_t got = voice.stream->Read(voice_buf, block);
+                block_max             = std::max(block_max, got);
+                for (std::size_t i = 0; i < got * 2U; ++i)
+                {
+                    acc[i] += (static_cast<std::int32_t>(voice_buf[i]) * voice.gain) >> 8;
+                }
+            }
+            produced += block_max;
+
+            std::int16_t* dst = out + done * 2U;
+            for (std::size_t i = 0; i < samples; ++i)
+            {
+                const std::int32_t v = (acc[i] * master_) >> 8;
+                dst[i]               = static_cast<std::int16_t>(std::clamp(v, -32768, 32767));
+            }
+        }
+        return produced;
+    }
+
+}  // namespace custom::platform
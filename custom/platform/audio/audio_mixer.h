@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform/audio/audio_stream.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Sums a handful of AudioStreams into one interleaved stereo period.
+     *
+     * All voices are expected to run at the sink's sample rate. The voice table is owned by the
+     * sink thread: add and remove voices from the thread that calls Mix().
+     */
+    class AudioMixer
+    {
+    public:
+        static constexpr std::size_t kMaxVoices   = 4U;
+        static constexpr std::size_t kBlockFrames = 256U;
+
+        bool AddVoice(AudioStream* stream, std::uint8_t gain_percent = 100U);
+        void RemoveVoice(AudioStream* stream);
+        void SetMasterVolume(std::uint8_t percent);
+
+        std::size_t ActiveVoices() const;
+
+        /** Mix @p frames stereo frames into @p out; returns the largest voice contribution. */
+        std::size_t Mix(std::int16_t* out, std::size_t frames);
+
+    private:
+        struct Voice
+        {
+            AudioStream*  stream = nullptr;
+            std::uint16_t gain   = 256U;
+        };
+
+        std::array<Voice, kMaxVoices> voices_{};
+        std::uint16_t                 master_ = 256U;
+
+        // Scratch lives here rather than on the stack so sink tasks can stay small.
+        std::array<std::int32_t, kBlockFrames * 2U> acc_{};
+        std::array<std::int16_t, kBlockFrames * 2U> voice_buf_{};
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_play_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        std::uint64_t SteadyNowUs()
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+        }
+
+        std::uint32_t Saturate32(std::uint64_t value)
+        {
+            return value > UINT32_MAX ? UINT32_MAX : static_cast<std::uint32_t>(value);
+        }
+
+    }  // namespace
+
+    AudioPlayQueue::AudioPlayQueue(WriteFn write, const Config& config, AudioStats& stats) :
+        write_(std::move(write)), config_(config), stats_(stats)
+    {
+        if (!config_.clock)
+        {
+            config_.clock = SteadyNowUs;
+        }
+        config_.max_depth     = std::max<std::size_t>(config_.max_depth, 1U);
+        config_.period_frames = std::max<std::size_t>(config_.period_frames, 1U);
+        config_.sample_rate   = std::max<std::uint32_t>(config_.sample_rate, 1U);
+    }
+
+    std::uint64_t AudioPlayQueue::Now() const
+    {
+        return config_.clock();
+    }
+
+    std::uint64_t AudioPlayQueue::FramesToUs(std::size_t frames) const
+    {
+        return static_cast<std::uint64_t>(frames) * 1000000ULL / config_.sample_rate;
+    }
+
+    bool AudioPlayQueue::Submit(std::vector<std::int16_t> clip, std::uint64_t trigger_us)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (clips_.size() >= config_.max_depth)
+            {
+                stats_.RecordDrop();
+                return false;
+            }
+            clips_.push_back(Clip{std::move(clip), trigger_us});
+            stats_.SetQueueDepth(static_cast<std::uint32_t>(clips_.size()));
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    bool AudioPlayQueue::PlayNext(std::chrono::milliseconds wait)
+    {
+        Clip clip;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!cv_.wait_for(lock, wait, [this]() { return !clips_.empty(); }))
+            {
+                return false;
+            }
+            clip = std::move(clips_.front());
+            clips_.pop_front();
+            stats_.SetQueueDepth(static_cast<std::uint32_t>(clips_.size()));
+        }
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        WriteClip(clip.samples.data(), clip.samples.size(), clip.trigger_us);
+        return true;
+    }
+
+    void AudioPlayQueue::PlayNow(const std::int16_t* samples,
+                                 std::size_t         count,
+                                 std::uint64_t       trigger_us)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        WriteClip(samples, count, trigger_us);
+    }
+
+    std::size_t AudioPlayQueue::Depth() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return clips_.size();
+    }
+
+    void AudioPlayQueue::WriteClip(const std::int16_t* samples,
+                                   std::size_t         count,
+                                   std::uint64_t       trigger_us)
+    {
+        if (samples == nullptr || count == 0U)
+        {
+            return;
+        }
+
+        if (config_.prepare)
+        {
+            config_.prepare(config_.sample_rate);
+        }
+
+        const std::size_t period = config_.period_frames * 2U;
+        for (std::size_t offset = 0; offset < count; offset += period)
+        {
+            const std::size_t   n  = std::min(period, count - offset);
+            const std::uint64_t t0 = Now();
+
+            if (offset == 0U)
+            {
+                // The first sample waits for whatever is still queued, then the device pipeline.
+                const std::uint64_t audible_at = std::max(t0, device_drained_at_us_)
+                                                 + FramesToUs(config_.device_latency_frames);
+                stats_.TriggerToSound().Record(
+                    Saturate32(audible_at > trigger_us ? audible_at - trigger_us : 0U));
+            }
+            else if (t0 > device_drained_at_us_)
+            {
+                // The device played out everything we gave it before the rest of the clip arrived.
+                stats_.RecordUnderrun();
+            }
+
+            write_(samples + offset, n);
+
+            stats_.WriteLatency().Record(Saturate32(Now() - t0));
+            device_drained_at_us_ = std::max(t0, device_drained_at_us_) + FramesToUs(n / 2U);
+        }
+        stats_.RecordClip();
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "platform/audio/audio_stats.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Bounded queue of short PCM clips (UI clicks, tones) played by one worker.
+     *
+     * audioPlay() callers Submit() clips with the time they were triggered; the HAL worker calls
+     * PlayNext() in a loop, which writes the clip to the device one period at a time. The queue
+     * keeps a model of when the device will run dry so it can count underruns and estimate when
+     * the first sample of each clip becomes audible, even on sinks that cannot report their
+     * fill level.
+     */
+    class AudioPlayQueue
+    {
+    public:
+        /** Hands interleaved stereo samples to the device; may block until there is room. */
+        using WriteFn = std::function<void(const std::int16_t* samples, std::size_t count)>;
+        using ClockFn = std::function<std::uint64_t()>;
+        /**
+         * Runs before each clip with the queue's sample rate, e.g. to restore a clock the music
+         * player reconfigured for a stream at another rate.
+         */
+        using PrepareFn = std::function<void(std::uint32_t sample_rate)>;
+
+        struct Config
+        {
+            std::size_t   max_depth     = 4U;
+            std::uint32_t sample_rate   = 48000U;
+            std::size_t   period_frames = 480U;
+            /** Frames buffered between the write call and the DAC (DMA ring, SDL buffer). */
+            std::uint32_t device_latency_frames = 0U;
+            /** Monotonic microsecond clock; defaults to std::chrono::steady_clock. */
+            ClockFn   clock;
+            PrepareFn prepare;
+        };
+
+        AudioPlayQueue(WriteFn write, const Config& config, AudioStats& stats);
+
+        AudioPlayQueue(const AudioPlayQueue&)            = delete;
+        AudioPlayQueue& operator=(const AudioPlayQueue&) = delete;
+
+        std::uint64_t Now() const;
+
+        /** Queue a clip; a full queue drops it (and counts the drop) rather than adding lag. */
+        bool Submit(std::vector<std::int16_t> clip, std::uint64_t trigger_us);
+
+        /** Worker: wait up to @p wait for a clip and play it; returns false if none arrived. */
+        bool PlayNext(std::chrono::milliseconds wait);
+
+        /** Blocking path for audioPlay(..., false); instrumented like queued clips. */
+        void PlayNow(const std::int16_t* samples, std::size_t count, std::uint64_t trigger_us);
+
+        std::size_t Depth() const;
+
+    private:
+        struct Clip
+        {
+            std::vector<std::int16_t> samples;
+            std::uint64_t             trigger_us = 0U;
+        };
+
+        void WriteClip(const std::int16_t* samples, std::size_t count, std::uint64_t trigger_us);
+        std::uint64_t FramesToUs(std::size_t frames) const;
+
+        WriteFn     write_;
+        Config      config_;
+        AudioStats& stats_;
+
+        mutable std::mutex      mutex_;
+        std::condition_variable cv_;
+        std::deque<Clip>        clips_;
+
+        /** Serialises device writes between the worker and PlayNow(). */
+        std::mutex write_mutex_;
+        /** Modelled time at which everything written so far has been played. */
+        std::uint64_t device_drained_at_us_ = 0U;
+    };
+
+}  // namespace custom::platform
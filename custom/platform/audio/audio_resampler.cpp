@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_resampler.h"
+
+namespace custom::platform
+{
+
+    void LinearResampler::SetRates(std::uint32_t from_rate, std::uint32_t to_rate)
+    {
+        if (from_rate == from_rate_ && to_rate == to_rate_)
+        {
+            return;
+        }
+        from_rate_ = from_rate;
+        to_rate_   = to_rate;
+        Reset();
+    }
+
+    void LinearResampler::Reset()
+    {
+        position_ = 0U;
+        prev_[0]  = 0;
+        prev_[1]  = 0;
+        has_prev_ = false;
+    }
+
+    void LinearResampler::Process(const std::int16_t*        in,
+                                  std::size_t                frames,
+                                  std::vector<std::int16_t>& out)
+    {
+        if (in == nullptr || frames == 0U)
+        {
+            return;
+        }
+        if (from_rate_ == to_rate_ || from_rate_ == 0U || to_rate_ == 0U)
+        {
+            out.insert(out.end(), in, in + frames * 2U);
+            return;
+        }
+        if (!has_prev_)
+        {
+            // Start on the first frame rather than ramping in from silence
+            prev_[0]  = in[0];
+            prev_[1]  = in[1];
+            has_prev_ = true;
+            position_ = to_rate_;
+        }
+
+        // Input frame i of this call sits at index i + 1, after the carried-over prev_
+        const std::uint64_t end = static_cast<std::uint64_t>(frames) * to_rate_;
+        while (position_ < end)
+        {
+            const std::size_t   index = static_cast<std::size_t>(position_ / to_rate_);
+            const std::int64_t  frac  = static_cast<std::int64_t>(position_ % to_rate_);
+            const std::int16_t* a     = index == 0U ? prev_ : in + (index - 1U) * 2U;
+            const std::int16_t* b     = in + index * 2U;
+            for (std::size_t ch = 0; ch < 2U; ++ch)
+            {
+                out.push_back(static_cast<std::int16_t>(
+                    a[ch] + (static_cast<std::int64_t>(b[ch] - a[ch]) * frac) / to_rate_));
+            }
+            position_ += from_rate_;
+        }
+        position_ -= end;
+        prev_[0] = in[(frames - 1U) * 2U];
+        prev_[1] = in[(frames - 1U) * 2U + 1U];
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Streaming linear-interpolation resampler for interleaved stereo PCM.
+     *
+     * Keeps its fractional position and the last input frame between calls, so a sound fed
+     * one period at a time comes out without clicks at the period seams. Linear interpolation
+     * is fine for UI clips played under a stream at another rate; it is not meant for music.
+     */
+    class LinearResampler
+    {
+    public:
+        /** Also resets the position when either rate changes. */
+        void SetRates(std::uint32_t from_rate, std::uint32_t to_rate);
+        void Reset();
+
+        /** Appends the resampled form of @p frames stereo frames to @p out. */
+        void Process(const std::int16_t* in, std::size_t frames, std::vector<std::int16_t>& out);
+
+    private:
+        std::uint32_t from_rate_ = 0U;
+        std::uint32_t to_rate_   = 0U;
+        // Position of the next output frame past prev_, in 1/to_rate_ input frames
+        std::uint64_t position_ = 0U;
+        std::int16_t  prev_[2]  = {0, 0};
+        bool          has_prev_ = false;
+    };
+
+}  // namespace custom::platform
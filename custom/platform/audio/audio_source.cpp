@@ -0,0 +1,366 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_source.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/types.h>
+
+#if defined(ESP_PLATFORM)
+#    include "esp_crt_bundle.h"
+#    include "esp_http_client.h"
+#endif
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::size_t kSkipChunkBytes = 256U;
+
+        bool StartsWith(const std::string& value, const char* prefix)
+        {
+            return value.compare(0, std::strlen(prefix), prefix) == 0;
+        }
+
+    }  // namespace
+
+    bool AudioSource::Seek(std::size_t offset)
+    {
+        std::size_t position = Tell();
+        if (offset < position)
+        {
+            return false;
+        }
+
+        std::uint8_t scratch[kSkipChunkBytes];
+        while (position < offset)
+        {
+            const std::size_t want = std::min(offset - position, sizeof(scratch));
+            const std::size_t got  = Read(scratch, want);
+            if (got == 0U)
+            {
+                return false;
+            }
+            position += got;
+        }
+        return true;
+    }
+
+    /* ---- Memory ---- */
+
+    MemoryAudioSource::MemoryAudioSource(const void* data, std::size_t size) :
+        data_(static_cast<const std::uint8_t*>(data)), size_(data != nullptr ? size : 0U)
+    {
+    }
+
+    std::size_t MemoryAudioSource::Read(std::uint8_t* dst, std::size_t len)
+    {
+        const std::size_t n = std::min(len, size_ - position_);
+        if (n > 0U)
+        {
+            std::memcpy(dst, data_ + position_, n);
+            position_ += n;
+        }
+        return n;
+    }
+
+    bool MemoryAudioSource::AtEnd() const
+    {
+        return position_ >= size_;
+    }
+
+    std::size_t MemoryAudioSource::Tell() const
+    {
+        return position_;
+    }
+
+    std::int64_t MemoryAudioSource::Size() const
+    {
+        return static_cast<std::int64_t>(size_);
+    }
+
+    bool MemoryAudioSource::Seek(std::size_t offset)
+    {
+        if (offset > size_)
+        {
+            return false;
+        }
+        position_ = offset;
+        return true;
+    }
+
+    /* ---- File ---- */
+
+    FileAudioSource::~FileAudioSource()
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    bool FileAudioSource::Open(const std::string& path, std::size_t buffer_bytes)
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+
+        // FAT on SD cards is far happier with a few large reads than many small ones.
+        if (buffer_bytes > 0U)
+        {
+            std::setvbuf(file_, nullptr, _IOFBF, buffer_bytes);
+        }
+
+        size_ = -1;
+        if (std::fseek(file_, 0, SEEK_END) == 0)
+        {
+            const long end = std::ftell(file_);
+            if (end >= 0)
+            {
+                size_ = end;
+            }
+        }
+        std::fseek(file_, 0, SEEK_SET);
+
+        position_ = 0U;
+        eof_      = false;
+        return true;
+    }
+
+    std::size_t FileAudioSource::Read(std::uint8_t* dst, std::size_t len)
+    {
+        if (file_ == nullptr || eof_)
+        {
+            return 0U;
+        }
+
+        const std::size_t got = std::fread(dst, 1U, len, file_);
+        position_ += got;
+        if (got < len)
+        {
+            eof_ = true;
+        }
+        return got;
+    }
+
+    bool FileAudioSource::AtEnd() const
+    {
+        return file_ == nullptr || eof_;
+    }
+
+    std::size_t FileAudioSource::Tell() const
+    {
+        return position_;
+    }
+
+    std::int64_t FileAudioSource::Size() const
+    {
+        return size_;
+    }
+
+    bool FileAudioSource::Seek(std::size_t offset)
+    {
+        if (file_ == nullptr || std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0)
+        {
+            return false;
+        }
+        position_ = offset;
+        eof_      = false;
+        return true;
+    }
+
+    /* ---- HTTP ---- */
+
+#if defined(ESP_PLATFORM)
+    HttpAudioSource::~HttpAudioSource()
+    {
+        if (client_ != nullptr)
+        {
+            auto client = static_cast<esp_http_client_handle_t>(client_);
+            esp_http_client_close(client);
+            esp_http_client_cleanup(client);
+        }
+    }
+
+    bool HttpAudioSource::Open(const std::string& url, int timeout_ms)
+    {
+        esp_http_client_config_t config = {};
+        config.url                      = url.c_str();
+        config.timeout_ms               = timeout_ms;
+        config.buffer_size              = 4096;
+        config.crt_bundle_attach        = esp_crt_bundle_attach;  // album art CDNs are https
+
+        esp_http_client_handle_t client = esp_http_client_init(&config);
+        if (client == nullptr)
+        {
+            return false;
+        }
+        client_ = client;
+
+        if (esp_http_client_open(client, 0) != ESP_OK)
+        {
+            return false;
+        }
+
+        const int64_t length = esp_http_client_fetch_headers(client);
+        const int     status = esp_http_client_get_status_code(client);
+        if (status < 200 || status >= 300)
+        {
+            return false;
+        }
+
+        size_     = length > 0 ? length : -1;
+        position_ = 0U;
+        eof_      = false;
+        return true;
+    }
+
+    std::size_t HttpAudioSource::Read(std::uint8_t* dst, std::size_t len)
+    {
+        if (client_ == nullptr || eof_)
+        {
+            return 0U;
+        }
+
+        auto      client = static_cast<esp_http_client_handle_t>(client_);
+        const int got    = esp_http_client_read(client, reinterpret_cast<char*>(dst), len);
+        if (got <= 0)
+        {
+            eof_ = true;
+            return 0U;
+        }
+
+        position_ += static_cast<std::size_t>(got);
+        if (esp_http_client_is_complete_data_received(client))
+        {
+            eof_ = true;
+        }
+        return static_cast<std::size_t>(got);
+    }
+
+    bool HttpAudioSource::AtEnd() const
+    {
+        return client_ == nullptr || eof_;
+    }
+
+    std::size_t HttpAudioSource::Tell() const
+    {
+        return position_;
+    }
+
+    std::int64_t HttpAudioSource::Size() const
+    {
+        return size_;
+    }
+#endif
+
+    std::unique_ptr<AudioSource> OpenAudioSource(const std::string& uri)
+    {
+        if (StartsWith(uri, "http://") || StartsWith(uri, "https://"))
+        {
+#if defined(ESP_PLATFORM)
+            auto source = std::make_unique<HttpAudioSource>();
+            if (source->Open(uri))
+            {
+                return source;
+            }
+#endif
+            return nullptr;
+        }
+
+        auto source = std::make_unique<FileAudioSource>();
+        if (!source->Open(uri))
+        {
+            return nullptr;
+        }
+        return source;
+    }
+
+    /* ---- stdio bridge ---- */
+
+#if defined(ESP_PLATFORM) || defined(__GLIBC__)
+    namespace
+    {
+
+        ssize_t CookieRead(void* cookie, char* buf, size_t size)
+        {
+            auto* source = static_cast<AudioSource*>(cookie);
+            return static_cast<ssize_t>(source->Read(reinterpret_cast<std::uint8_t*>(buf), size));
+        }
+
+        // newlib and glibc disagree on the offset type, so let the assignment pick it.
+        template <typename Offset>
+        int CookieSeek(void* cookie, Offset* offset, int whence)
+        {
+            auto*        source = static_cast<AudioSource*>(cookie);
+            std::int64_t target = static_cast<std::int64_t>(*offset);
+            if (whence == SEEK_CUR)
+            {
+                target += static_cast<std::int64_t>(source->Tell());
+            }
+            else if (whence == SEEK_END)
+            {
+                if (source->Size() < 0)
+                {
+                    return -1;
+                }
+                target += source->Size();
+            }
+
+            if (target < 0 || !source->Seek(static_cast<std::size_t>(target)))
+            {
+                return -1;
+            }
+            *offset = static_cast<Offset>(target);
+            return 0;
+        }
+
+        int CookieClose(void* cookie)
+        {
+            delete static_cast<AudioSource*>(cookie);
+            return 0;
+        }
+
+    }  // namespace
+
+    FILE* OpenAudioSourceAsFile(std::unique_ptr<AudioSource> source)
+    {
+        if (!source)
+        {
+            return nullptr;
+        }
+
+        cookie_io_functions_t io = {};
+        io.read                  = CookieRead;
+        io.seek                  = CookieSeek;
+        io.close                 = CookieClose;
+
+        FILE* file = fopencookie(source.get(), "rb", io);
+        if (file != nullptr)
+        {
+            source.release();
+        }
+        return file;
+    }
+#else
+    FILE* OpenAudioSourceAsFile(std::unique_ptr<AudioSource> source)
+    {
+        (void)source;
+        return nullptr;
+    }
+#endif
+
+}  // namespace custom::platform
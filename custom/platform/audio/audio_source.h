@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Pull-based byte source feeding an audio decoder.
+     *
+     * Sources are read in small chunks from a single decode thread, so a long track never has
+     * to be resident in RAM. Read() may return fewer bytes than requested (e.g. a slow
+     * network); it returns 0 once AtEnd() is true or on error.
+     */
+    class AudioSource
+    {
+    public:
+        virtual ~AudioSource() = default;
+
+        virtual std::size_t Read(std::uint8_t* dst, std::size_t len) = 0;
+        virtual bool        AtEnd() const                             = 0;
+
+        /** Absolute position in bytes from the start of the stream. */
+        virtual std::size_t Tell() const = 0;
+
+        /** Total size in bytes, or -1 when unknown (live streams). */
+        virtual std::int64_t Size() const
+        {
+            return -1;
+        }
+
+        /**
+         * Move to an absolute offset. The default only supports skipping forward by reading,
+         * which is all a decoder needs to step over unknown container chunks.
+         */
+        virtual bool Seek(std::size_t offset);
+    };
+
+    /** Source over a blob already mapped in memory (embedded flash data, test buffers). */
+    class MemoryAudioSource : public AudioSource
+    {
+    public:
+        MemoryAudioSource(const void* data, std::size_t size);
+
+        std::size_t  Read(std::uint8_t* dst, std::size_t len) override;
+        bool         AtEnd() const override;
+        std::size_t  Tell() const override;
+        std::int64_t Size() const override;
+        bool         Seek(std::size_t offset) override;
+
+    private:
+        const std::uint8_t* data_     = nullptr;
+        std::size_t         size_     = 0U;
+        std::size_t         position_ = 0U;
+    };
+
+    /** Source over a file (SD card, host filesystem) read through a sized stdio buffer. */
+    class FileAudioSource : public AudioSource
+    {
+    public:
+        static constexpr std::size_t kDefaultBufferBytes = 16U * 1024U;
+
+        FileAudioSource() = default;
+        ~FileAudioSource() override;
+
+        FileAudioSource(const FileAudioSource&)            = delete;
+        FileAudioSource& operator=(const FileAudioSource&) = delete;
+
+        bool Open(const std::string& path, std::size_t buffer_bytes = kDefaultBufferBytes);
+
+        std::size_t  Read(std::uint8_t* dst, std::size_t len) override;
+        bool         AtEnd() const override;
+        std::size_t  Tell() const override;
+        std::int64_t Size() const override;
+        bool         Seek(std::size_t offset) override;
+
+    private:
+        FILE*        file_     = nullptr;
+        std::int64_t size_     = -1;
+        std::size_t  position_ = 0U;
+        bool         eof_      = false;
+    };
+
+#if defined(ESP_PLATFORM)
+    /** Source over an HTTP(S) response body, read incrementally from the socket. */
+    class HttpAudioSource : public AudioSource
+    {
+    public:
+        HttpAudioSource() = default;
+        ~HttpAudioSource() override;
+
+        HttpAudioSource(const HttpAudioSource&)            = delete;
+        HttpAudioSource& operator=(const HttpAudioSource&) = delete;
+
+        bool Open(const std::string& url, int timeout_ms = 5000);
+
+        std::size_t  Read(std::uint8_t* dst, std::size_t len) override;
+        bool         AtEnd() const override;
+        std::size_t  Tell() const override;
+        std::int64_t Size() const override;
+
+    private:
+        void*        client_   = nullptr;
+        std::int64_t size_     = -1;
+        std::size_t  position_ = 0U;
+        bool         eof_      = false;
+    };
+#endif
+
+    /**
+     * @brief Open a source from a path or URL.
+     *
+     * "http://" and "https://" URLs map to HttpAudioSource on the device; anything else is
+     * treated as a file path. Returns nullptr when the source cannot be opened.
+     */
+    std::unique_ptr<AudioSource> OpenAudioSource(const std::string& uri);
+
+    /**
+     * @brief Expose a source as a read-only FILE* for decoders that only speak stdio.
+     *
+     * The FILE takes ownership of the source and destroys it on fclose(). Returns nullptr when
+     * the C library has no cookie stream support.
+     */
+    FILE* OpenAudioSourceAsFile(std::unique_ptr<AudioSource> source);
+
+}  // namespace custom::platform
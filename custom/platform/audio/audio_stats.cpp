@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_stats.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        void StoreMax(std::atomic<std::uint32_t>& slot, std::uint32_t value)
+        {
+            std::uint32_t current = slot.load(std::memory_order_relaxed);
+            while (value > current
+                   && !slot.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void StoreMin(std::atomic<std::uint32_t>& slot, std::uint32_t value)
+        {
+            std::uint32_t current = slot.load(std::memory_order_relaxed);
+            while (value < current
+                   && !slot.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+    }  // namespace
+
+    /* ---- LatencyRecorder ---- */
+
+    void LatencyRecorder::Record(std::uint32_t us)
+    {
+        count_.fetch_add(1U, std::memory_order_relaxed);
+        total_.fetch_add(us, std::memory_order_relaxed);
+        last_.store(us, std::memory_order_relaxed);
+        StoreMin(min_, us);
+        StoreMax(max_, us);
+    }
+
+    LatencySummary LatencyRecorder::Summary() const
+    {
+        LatencySummary summary;
+        summary.count = count_.load(std::memory_order_relaxed);
+        if (summary.count == 0U)
+        {
+            return summary;
+        }
+        summary.last_us = last_.load(std::memory_order_relaxed);
+        summary.min_us  = min_.load(std::memory_order_relaxed);
+        summary.max_us  = max_.load(std::memory_order_relaxed);
+        summary.avg_us =
+            static_cast<std::uint32_t>(total_.load(std::memory_order_relaxed) / summary.count);
+        return summary;
+    }
+
+    void LatencyRecorder::Reset()
+    {
+        count_.store(0U, std::memory_order_relaxed);
+        total_.store(0U, std::memory_order_relaxed);
+        last_.store(0U, std::memory_order_relaxed);
+        min_.store(UINT32_MAX, std::memory_order_relaxed);
+        max_.store(0U, std::memory_order_relaxed);
+    }
+
+    /* ---- AudioStats ---- */
+
+    void AudioStats::RecordClip()
+    {
+        clips_.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    void AudioStats::RecordDrop()
+    {
+        dropped_.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    void AudioStats::RecordUnderrun(std::uint32_t count)
+    {
+        underruns_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void AudioStats::SetQueueDepth(std::uint32_t depth)
+    {
+        depth_.store(depth, std::memory_order_relaxed);
+        StoreMax(max_depth_, depth);
+    }
+
+    AudioStatsSnapshot AudioStats::Snapshot() const
+    {
+        AudioStatsSnapshot snapshot;
+        snapshot.clips_played        = clips_.load(std::memory_order_relaxed);
+        snapshot.dropped_clips       = dropped_.load(std::memory_order_relaxed);
+        snapshot.underruns           = underruns_.load(std::memory_order_relaxed);
+        snapshot.queue_depth         = depth_.load(std::memory_order_relaxed);
+        snapshot.max_queue_depth     = max_depth_.load(std::memory_order_relaxed);
+        snapshot.write_us            = write_.Summary();
+        snapshot.trigger_to_sound_us = trigger_to_sound_.Summary();
+        return snapshot;
+    }
+
+    void AudioStats::Reset()
+    {
+        clips_.store(0U, std::memory_order_relaxed);
+        dropped_.store(0U, std::memory_order_relaxed);
+        underruns_.store(0U, std::memory_order_relaxed);
+        max_depth_.store(depth_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        write_.Reset();
+        trigger_to_sound_.Reset();
+    }
+
+    int FormatAudioStatsJson(const AudioStatsSnapshot& stats, char* buf, std::size_t len)
+    {
+        if (buf == nullptr || len == 0U)
+        {
+            return -1;
+        }
+
+        const LatencySummary& w = stats.write_us;
+        const LatencySummary& t = stats.trigger_to_sound_us;
+        const int             written =
+            std::snprintf(buf,
+                          len,
+                          "{\"clips\":%" PRIu32 ",\"dropped\":%" PRIu32 ",\"underruns\":%" PRIu32
+                          ",\"queue_depth\":%" PRIu32 ",\"max_queue_depth\":%" PRIu32
+                          ",\"write_us\":{\"avg\":%" PRIu32 ",\"max\":%" PRIu32 "}"
+                          ",\"trigger_to_sound_us\":{\"last\":%" PRIu32 ",\"avg\":%" PRIu32
+                          ",\"max\":%" PRIu32 "}}",
+                          stats.clips_played,
+                          stats.dropped_clips,
+                          stats.underruns,
+                          stats.queue_depth,
+                          stats.max_queue_depth,
+                          w.avg_us,
+                          w.max_us,
+                          t.last_us,
+                          t.avg_us,
+                          t.max_us);
+        if (written < 0 || static_cast<std::size_t>(written) >= len)
+        {
+            return -1;
+        }
+        return written;
+    }
+
+}  // namespace custom::platform
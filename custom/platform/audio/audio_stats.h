@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace custom::platform
+{
+
+    struct LatencySummary
+    {
+        std::uint32_t count   = 0U;
+        std::uint32_t last_us = 0U;
+        std::uint32_t min_us  = 0U;
+        std::uint32_t max_us  = 0U;
+        std::uint32_t avg_us  = 0U;
+    };
+
+    struct AudioStatsSnapshot
+    {
+        std::uint32_t  clips_played    = 0U;
+        std::uint32_t  dropped_clips   = 0U;
+        std::uint32_t  underruns       = 0U;
+        std::uint32_t  queue_depth     = 0U;
+        std::uint32_t  max_queue_depth = 0U;
+        LatencySummary write_us;
+        LatencySummary trigger_to_sound_us;
+    };
+
+    /** Lock-free min/max/avg accumulator for microsecond latencies. */
+    class LatencyRecorder
+    {
+    public:
+        void           Record(std::uint32_t us);
+        LatencySummary Summary() const;
+        void           Reset();
+
+    private:
+        std::atomic<std::uint32_t> count_{0U};
+        std::atomic<std::uint64_t> total_{0U};
+        std::atomic<std::uint32_t> last_{0U};
+        std::atomic<std::uint32_t> min_{UINT32_MAX};
+        std::atomic<std::uint32_t> max_{0U};
+    };
+
+    /**
+     * @brief Playback counters shared by the HAL audio paths.
+     *
+     * Writers are the audio worker and audioPlay() callers; readers (diag endpoint, benchmarks)
+     * take a Snapshot() at any time without locking.
+     */
+    class AudioStats
+    {
+    public:
+        void RecordClip();
+        void RecordDrop();
+        void RecordUnderrun(std::uint32_t count = 1U);
+        void SetQueueDepth(std::uint32_t depth);
+
+        LatencyRecorder& WriteLatency()
+        {
+            return write_;
+        }
+        LatencyRecorder& TriggerToSound()
+        {
+            return trigger_to_sound_;
+        }
+
+        AudioStatsSnapshot Snapshot() const;
+        void               Reset();
+
+    private:
+        std::atomic<std::uint32_t> clips_{0U};
+        std::atomic<std::uint32_t> dropped_{0U};
+        std::atomic<std::uint32_t> underruns_{0U};
+        std::atomic<std::uint32_t> depth_{0U};
+        std::atomic<std::uint32_t> max_depth_{0U};
+        LatencyRecorder            write_;
+        LatencyRecorder            trigger_to_sound_;
+    };
+
+    /**
+     * @brief Render a snapshot as a compact JSON object.
+     *
+     * Returns the number of characters written (excluding the terminator), or -1 when @p len
+     * is too small.
+     */
+    int FormatAudioStatsJson(const AudioStatsSnapshot& stats, char* buf, std::size_t len);
+
+}  // namespace custom::platform
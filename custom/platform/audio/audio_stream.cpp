@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/audio/audio_stream.h"
+
+#include <algorithm>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::size_t   kOutputChannels = 2U;
+        constexpr std::size_t   kChunkFrames    = 1024U;
+        constexpr std::uint32_t kMaxSampleRate  = 48000U;
+        constexpr std::uint32_t kFileStallMs    = 80U;
+        constexpr std::uint32_t kNetworkStallMs = 400U;
+
+        AudioStream::Config Sanitize(AudioStream::Config config)
+        {
+            config.chunk_frames    = std::max<std::size_t>(config.chunk_frames, 64U);
+            config.capacity_frames = std::max(config.capacity_frames, config.chunk_frames * 2U);
+            config.prefetch_frames =
+                std::min(config.prefetch_frames, config.capacity_frames - config.chunk_frames);
+            return config;
+        }
+
+    }  // namespace
+
+    AudioStream::AudioStream(std::unique_ptr<AudioSource>  source,
+                             std::unique_ptr<AudioDecoder> decoder,
+                             const Config&                 config) :
+        source_(std::move(source)),
+        decoder_(std::move(decoder)),
+        config_(Sanitize(config)),
+        ring_(config_.capacity_frames * kOutputChannels)
+    {
+    }
+
+    bool AudioStream::Open()
+    {
+        if (!source_ || !decoder_ || !decoder_->Open(*source_))
+        {
+            return false;
+        }
+
+        format_ = decoder_->Format();
+        decode_buf_.resize(config_.chunk_frames * format_.channels);
+        stereo_buf_.resize(config_.chunk_frames * kOutputChannels);
+        return true;
+    }
+
+    PcmFormat AudioStream::Format() const
+    {
+        return format_;
+    }
+
+    void AudioStream::ReportUnderrunsTo(AudioStats* stats)
+    {
+        stats_ = stats;
+    }
+
+    bool AudioStream::WantsData() const
+    {
+        return !decoded_all_.load(std::memory_order_relaxed)
+               && ring_.Free() >= config_.chunk_frames * kOutputChannels;
+    }
+
+    AudioStream::PumpResult AudioStream::Pump()
+    {
+        if (decoded_all_.load(std::memory_order_relaxed) || decode_buf_.empty())
+        {
+            return PumpResult::kEnd;
+        }
+        if (!WantsData())
+        {
+            return PumpResult::kFull;
+        }
+
+        const std::size_t frames = decoder_->Decode(decode_buf_.data(), config_.chunk_frames);
+        if (frames > 0U)
+        {
+            const std::int16_t* src = decode_buf_.data();
+            std::int16_t*       dst = stereo_buf_.data();
+            const std::size_t   ch  = format_.channels;
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                dst[i * 2U]      = src[i * ch];
+                dst[i * 2U + 1U] = src[i * ch + (ch > 1U ? 1U : 0U)];
+            }
+            ring_.Push(dst, frames * kOutputChannels);
+            decoded_frames_.fetch_add(frames, std::memory_order_relaxed);
+
+            const std::size_t buffered = ring_.Size() / kOutputChannels;
+            if (buffered > max_buffered_.load(std::memory_order_relaxed))
+            {
+                max_buffered_.store(buffered, std::memory_order_relaxed);
+            }
+            if (buffered >= config_.prefetch_frames)
+            {
+                primed_.store(true, std::memory_order_release);
+            }
+        }
+
+        if (decoder_->AtEnd())
+        {
+            decoded_all_.store(true, std::memory_order_release);
+            primed_.store(true, std::memory_order_release);
+            return frames > 0U ? PumpResult::kDecoded : PumpResult::kEnd;
+        }
+        return frames > 0U ? PumpResult::kDecoded : PumpResult::kStalled;
+    }
+
+    std::size_t AudioStream::Read(std::int16_t* out, std::size_t frames)
+    {
+        if (out == nullptr || frames == 0U)
+        {
+            return 0U;
+        }
+
+        const std::size_t samples = frames * kOutputChannels;
+        if (!primed_.load(std::memory_order_acquire))
+        {
+            std::fill(out, out + samples, static_cast<std::int16_t>(0));
+            return 0U;
+        }
+
+        const std::size_t got = ring_.Pop(out, samples) / kOutputChannels;
+        std::fill(out + got * kOutputChannels, out + samples, static_cast<std::int16_t>(0));
+        played_frames_.fetch_add(got, std::memory_order_relaxed);
+
+        if (got < frames && !decoded_all_.load(std::memory_order_acquire))
+        {
+            underruns_.fetch_add(1U, std::memory_order_relaxed);
+            underrun_frames_.fetch_add(frames - got, std::memory_order_relaxed);
+            if (stats_ != nullptr)
+            {
+                stats_->RecordUnderrun();
+            }
+            if (config_.rebuffer_on_underrun)
+            {
+                primed_.store(false, std::memory_order_release);
+            }
+        }
+        return got;
+    }
+
+    bool AudioStream::Finished() const
+    {
+        return decoded_all_.load(std::memory_order_acquire) && ring_.Empty();
+    }
+
+    AudioStreamStats AudioStream::Stats() const
+    {
+        AudioStreamStats stats;
+        stats.decoded_frames  = decoded_frames_.load(std::memory_order_relaxed);
+        stats.played_frames   = played_frames_.load(std::memory_order_relaxed);
+        stats.underruns       = underruns_.load(std::memory_order_relaxed);
+        stats.underrun_frames = underrun_frames_.load(std::memory_order_relaxed);
+        stats.buffered_frames = ring_.Size() / kOutputChannels;
+        stats.max_buffered    = max_buffered_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::size_t RecommendedPrefetchFrames(std::uint32_t sample_rate,
+                                          std::uint32_t worst_stall_ms,
+                                          std::size_t   chunk_frames)
+    {
+        if (chunk_frames == 0U)
+        {
+            return 0U;
+        }
+        const std::uint64_t stall_frames =
+            (static_cast<std::uint64_t>(sample_rate) * worst_stall_ms + 999U) / 1000U;
+        const std::uint64_t chunks = (stall_frames + chunk_frames - 1U) / chunk_frames + 1U;
+        return static_cast<std::size_t>(chunks * chunk_frames);
+    }
+
+    std::unique_ptr<AudioStream> OpenWavStream(const std::string& uri)
+    {
+        auto source = OpenAudioSource(uri);
+        if (!source)
+        {
+            return nullptr;
+        }
+
+        // SD reads stall on FAT lookups; network sources can pause for a few hundred ms.
+        const bool          remote   = source->Size() < 0 || uri.find("://") != std::string::npos;
+        const std::uint32_t stall_ms = remote ? kNetworkStallMs : kFileStallMs;
+
+        AudioStream::Config config;
+        config.chunk_frames = kChunkFrames;
+        config.prefetch_frames =
+            RecommendedPrefetchFrames(kMaxSampleRate, stall_ms, config.chunk_frames);
+        config.capacity_frames = config.prefetch_frames + 4U * config.chunk_frames;
+
+        auto stream = std::make_unique<AudioStream>(
+            std::move(source), std::make_unique<WavDecoder>(), config);
+        if (!stream->Open())
+        {
+            return nullptr;
+        }
+        return stream;
+    }
+
+}  // namespace custom::platform
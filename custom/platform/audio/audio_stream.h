@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "platform/audio/audio_decoder.h"
+#include "platform/audio/audio_stats.h"
+#include "platform/spsc_ring.h"
+
+namespace custom::platform
+{
+
+    struct AudioStreamStats
+    {
+        std::uint64_t decoded_frames  = 0U;
+        std::uint64_t played_frames   = 0U;
+        std::uint32_t underruns       = 0U;
+        std::uint64_t underrun_frames = 0U;
+        std::size_t   buffered_frames = 0U;
+        std::size_t   max_buffered    = 0U;
+    };
+
+    /**
+     * @brief Decoded PCM buffered between a decode thread and the audio sink.
+     *
+     * The producer calls Pump() to decode one chunk at a time into a lock-free ring; the sink
+     * (or AudioMixer) calls Read() for each output period. Playback only starts once
+     * prefetch_frames are buffered, and every period the sink has to pad with silence while
+     * the decoder still has data is counted as an underrun.
+     */
+    class AudioStream
+    {
+    public:
+        struct Config
+        {
+            std::size_t chunk_frames    = 1024U;
+            std::size_t prefetch_frames = 4096U;
+            std::size_t capacity_frames = 8192U;
+            /** Go back to prefetching after an underrun instead of stuttering on a thin buffer. */
+            bool rebuffer_on_underrun = true;
+        };
+
+        enum class PumpResult
+        {
+            kDecoded,
+            kFull,
+            kStalled,
+            kEnd,
+        };
+
+        AudioStream(std::unique_ptr<AudioSource> source,
+                    std::unique_ptr<AudioDecoder> decoder,
+                    const Config&                 config);
+
+        AudioStream(const AudioStream&)            = delete;
+        AudioStream& operator=(const AudioStream&) = delete;
+
+        /** Opens the decoder on the source; must succeed before pumping. */
+        bool Open();
+
+        PcmFormat Format() const;
+
+        /** Also count underruns into @p stats as they happen; set before the sink starts. */
+        void ReportUnderrunsTo(AudioStats* stats);
+
+        /* ---- Producer (decode thread) ---- */
+        PumpResult Pump();
+        bool       WantsData() const;
+
+        /* ---- Consumer (sink thread) ---- */
+        /** Fill @p frames stereo frames, padding with silence; returns frames of real audio. */
+        std::size_t Read(std::int16_t* out, std::size_t frames);
+        /** True once the decoder hit the end and everything buffered has been played. */
+        bool Finished() const;
+
+        AudioStreamStats Stats() const;
+
+    private:
+        std::unique_ptr<AudioSource>  source_;
+        std::unique_ptr<AudioDecoder> decoder_;
+        Config                        config_;
+        PcmFormat                     format_;
+
+        SpscRing<std::int16_t>    ring_;
+        std::vector<std::int16_t> decode_buf_;
+        std::vector<std::int16_t> stereo_buf_;
+
+        std::atomic<bool> primed_{false};
+        std::atomic<bool> decoded_all_{false};
+
+        std::atomic<std::uint64_t> decoded_frames_{0U};
+        std::atomic<std::uint64_t> played_frames_{0U};
+        std::atomic<std::uint32_t> underruns_{0U};
+        std::atomic<std::uint64_t> underrun_frames_{0U};
+        std::atomic<std::size_t>   max_buffered_{0U};
+        AudioStats*                stats_ = nullptr;
+    };
+
+    /**
+     * @brief Prefetch depth that rides out the longest expected decode/source stall.
+     *
+     * Rounds up to whole chunks and adds one chunk of slack for the chunk being decoded when
+     * the stall begins.
+     */
+    std::size_t RecommendedPrefetchFrames(std::uint32_t sample_rate,
+                                          std::uint32_t worst_stall_ms,
+                                          std::size_t   chunk_frames);
+
+    /**
+     * @brief Open a WAV file or URL as a stream, with prefetch sized for its transport.
+     *
+     * Returns nullptr when the source cannot be opened or is not PCM WAV.
+     */
+    std::unique_ptr<AudioStream> OpenWavStream(const std::string& uri);
+
+}  // namespace custom::platform
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/camera_preview.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        std::uint64_t SteadyNowUs()
+        {
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+        }
+
+    }  // namespace
+
+    /* ---- FramePacer ---- */
+
+    FramePacer::FramePacer(std::uint32_t max_fps) :
+        interval_us_(max_fps == 0U ? 0U : 1000000U / max_fps)
+    {
+    }
+
+    bool FramePacer::Admit(std::uint64_t now_us)
+    {
+        // Accept up to a quarter interval early so sensor jitter at exactly max_fps does not drop
+        // every other frame.
+        if (now_us + interval_us_ / 4U < next_due_us_)
+        {
+            return false;
+        }
+        // Stay on the cadence while frames keep up; restart it after a gap.
+        next_due_us_ = (now_us < next_due_us_ + interval_us_) ? next_due_us_ + interval_us_
+                                                               : now_us + interval_us_;
+        return true;
+    }
+
+    /* ---- CameraPreview ---- */
+
+    CameraPreview::CameraPreview(const Surfaces& surfaces, BlitFn blit, const Config& config) :
+        surfaces_(surfaces[0], surfaces[1], surfaces[2]),
+        blit_(blit ? std::move(blit) : BlitFn(SoftwareBlit)),
+        pacer_(config.max_fps)
+    {
+    }
+
+    bool CameraPreview::Offer(const FrameView& frame, std::uint64_t now_us)
+    {
+        std::uint8_t expected = kOpen;
+        if (!gate_.compare_exchange_strong(expected, kWriting, std::memory_order_acquire))
+        {
+            return false;
+        }
+        captured_.fetch_add(1U, std::memory_order_relaxed);
+
+        bool published = false;
+        if (!pacer_.Admit(now_us))
+        {
+            dropped_paced_.fetch_add(1U, std::memory_order_relaxed);
+        }
+        else
+        {
+            const std::uint64_t start = SteadyNowUs();
+            const bool          ok    = blit_(frame, surfaces_.Back());
+            const auto          took  = static_cast<std::uint32_t>(SteadyNowUs() - start);
+            last_blit_us_.store(took, std::memory_order_relaxed);
+            if (took > max_blit_us_.load(std::memory_order_relaxed))
+            {
+                max_blit_us_.store(took, std::memory_order_relaxed);
+            }
+
+            if (!ok)
+            {
+                blit_failures_.fetch_add(1U, std::memory_order_relaxed);
+            }
+            else
+            {
+                if (surfaces_.Publish())
+                {
+                    dropped_stale_.fetch_add(1U, std::memory_order_relaxed);
+                }
+                published = true;
+            }
+        }
+
+        gate_.store(kOpen, std::memory_order_release);
+        return published;
+    }
+
+    bool CameraPreview::AcquireLatest()
+    {
+        if (!surfaces_.Acquire())
+        {
+            return false;
+        }
+        displayed_.fetch_add(1U, std::memory_order_relaxed);
+        return true;
+    }
+
+    void CameraPreview::Close()
+    {
+        std::uint8_t current = gate_.load(std::memory_order_acquire);
+        while (current != kClosed)
+        {
+            if (current == kWriting)
+            {
+                std::this_thread::yield();
+                current = gate_.load(std::memory_order_acquire);
+                continue;
+            }
+            gate_.compare_exchange_weak(current, kClosed, std::memory_order_acq_rel);
+        }
+    }
+
+    CameraPreviewStats CameraPreview::Stats() const
+    {
+        CameraPreviewStats stats;
+        stats.captured      = captured_.load(std::memory_order_relaxed);
+        stats.displayed     = displayed_.load(std::memory_order_relaxed);
+        stats.dropped_stale = dropped_stale_.load(std::memory_order_relaxed);
+        stats.dropped_paced = dropped_paced_.load(std::memory_order_relaxed);
+        stats.blit_failures = blit_failures_.load(std::memory_order_relaxed);
+        stats.last_blit_us  = last_blit_us_.load(std::memory_order_relaxed);
+        stats.max_blit_us   = max_blit_us_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    bool SoftwareBlit(const FrameView& src, const FrameTarget& dst)
+    {
+        ScaleRgb565Nearest(src, dst, FitInside(src.width, src.height, dst.width, dst.height));
+        return true;
+    }
+
+}  // namespace custom::platform
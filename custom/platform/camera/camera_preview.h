@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "platform/camera/frame_scaler.h"
+#include "platform/triple_buffer.h"
+
+namespace custom::platform
+{
+
+    /** Caps the preview rate; frames arriving early are dropped, never delayed. */
+    class FramePacer
+    {
+    public:
+        explicit FramePacer(std::uint32_t max_fps);
+
+        /** True when a frame captured at @p now_us should be shown. */
+        bool Admit(std::uint64_t now_us);
+
+    private:
+        std::uint64_t interval_us_ = 0U;
+        std::uint64_t next_due_us_ = 0U;
+    };
+
+    struct CameraPreviewStats
+    {
+        std::uint32_t captured      = 0U;
+        std::uint32_t displayed     = 0U;
+        std::uint32_t dropped_stale = 0U;
+        std::uint32_t dropped_paced = 0U;
+        std::uint32_t blit_failures = 0U;
+        std::uint32_t last_blit_us  = 0U;
+        std::uint32_t max_blit_us   = 0U;
+    };
+
+    /**
+     * @brief Latest-frame-wins hand-off from the capture task to the UI.
+     *
+     * Three RGB565 surfaces rotate through a TripleBuffer. The capture task calls Offer() with a
+     * dequeued driver buffer; the frame is scaled straight into the back surface (PPA on Tab5,
+     * ScaleRgb565Nearest() on host), published, and the driver buffer can be requeued as soon as
+     * Offer() returns. The UI calls AcquireLatest() whenever it likes and points its widget at
+     * Front(). Neither side takes a lock or waits for the other; a frame the UI never got to is
+     * counted in dropped_stale and its surface reused.
+     */
+    class CameraPreview
+    {
+    public:
+        /** Scale/convert @p src into @p dst; returns false if the hardware refused. */
+        using BlitFn   = std::function<bool(const FrameView& src, const FrameTarget& dst)>;
+        using Surfaces = std::array<FrameTarget, 3>;
+
+        struct Config
+        {
+            std::uint32_t max_fps = 30U;
+        };
+
+        /** Surface 1 is shown first (typically the widget's own buffer); 0 is written first. */
+        CameraPreview(const Surfaces& surfaces, BlitFn blit, const Config& config);
+
+        CameraPreview(const CameraPreview&)            = delete;
+        CameraPreview& operator=(const CameraPreview&) = delete;
+
+        /** Capture task: scale @p frame into the back surface and publish it. */
+        bool Offer(const FrameView& frame, std::uint64_t now_us);
+
+        /** UI: switch to the newest frame; returns false if none arrived since the last call. */
+        bool AcquireLatest();
+
+        /** UI: the surface to display, stable until the next AcquireLatest(). */
+        const FrameTarget& Front()
+        {
+            return surfaces_.Front();
+        }
+        std::size_t FrontIndex() const
+        {
+            return surfaces_.FrontIndex();
+        }
+
+        /** Stop accepting frames; waits only for a blit that is already in progress. */
+        void Close();
+
+        CameraPreviewStats Stats() const;
+
+    private:
+        enum Gate : std::uint8_t
+        {
+            kOpen,
+            kWriting,
+            kClosed,
+        };
+
+        TripleBuffer<FrameTarget> surfaces_;
+        BlitFn                    blit_;
+        FramePacer                pacer_;
+
+        std::atomic<std::uint8_t> gate_{kOpen};
+
+        std::atomic<std::uint32_t> captured_{0U};
+        std::atomic<std::uint32_t> displayed_{0U};
+        std::atomic<std::uint32_t> dropped_stale_{0U};
+        std::atomic<std::uint32_t> dropped_paced_{0U};
+        std::atomic<std::uint32_t> blit_failures_{0U};
+        std::atomic<std::uint32_t> last_blit_us_{0U};
+        std::atomic<std::uint32_t> max_blit_us_{0U};
+    };
+
+    /** Default BlitFn: aspect-preserving software scale into the centre of the target. */
+    bool SoftwareBlit(const FrameView& src, const FrameTarget& dst);
+
+}  // namespace custom::platform
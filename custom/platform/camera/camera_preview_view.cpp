@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/camera_preview_view.h"
+
+#include <cstring>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint32_t kPollPeriodMs = 5U;
+        /** Index of the canvas' own buffer; TripleBuffer shows slot 1 first. */
+        constexpr std::size_t kOriginalSlot = 1U;
+
+        void* DefaultAlloc(std::size_t bytes)
+        {
+            return lv_malloc(bytes);
+        }
+
+        void DefaultFree(void* ptr)
+        {
+            lv_free(ptr);
+        }
+
+        FrameTarget TargetOf(const lv_draw_buf_t* buf)
+        {
+            FrameTarget target;
+            target.pixels    = reinterpret_cast<std::uint16_t*>(buf->data);
+            target.width     = buf->header.w;
+            target.height    = buf->header.h;
+            target.stride_px = buf->header.stride / sizeof(std::uint16_t);
+            return target;
+        }
+
+    }  // namespace
+
+    std::unique_ptr<CameraPreviewView> CameraPreviewView::Attach(
+        lv_obj_t*                    canvas,
+        CameraPreview::BlitFn        blit,
+        const CameraPreview::Config& config,
+        const SurfaceAllocator&      allocator)
+    {
+        if (canvas == nullptr)
+        {
+            return nullptr;
+        }
+        lv_draw_buf_t* original = lv_canvas_get_draw_buf(canvas);
+        if (original == nullptr || original->data == nullptr
+            || original->header.cf != LV_COLOR_FORMAT_RGB565)
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<CameraPreviewView> view(new CameraPreviewView());
+        view->canvas_          = canvas;
+        view->original_        = original;
+        view->allocator_.alloc = allocator.alloc != nullptr ? allocator.alloc : DefaultAlloc;
+        view->allocator_.free  = allocator.free != nullptr ? allocator.free : DefaultFree;
+
+        // Letterbox bars are never written by the blit, so start every surface black.
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+
+        const std::uint32_t size = original->header.stride * original->header.h;
+        for (lv_draw_buf_t& extra : view->extra_)
+        {
+            void* data = view->allocator_.alloc(size);
+            if (data == nullptr)
+            {
+                return nullptr;  // the destructor frees whatever was allocated
+            }
+            std::memcpy(data, original->data, size);
+            lv_draw_buf_init(&extra,
+                             original->header.w,
+                             original->header.h,
+                             LV_COLOR_FORMAT_RGB565,
+                             original->header.stride,
+                             data,
+                             size);
+        }
+
+        view->bufs_[0]             = &view->extra_[0];
+        view->bufs_[kOriginalSlot] = original;
+        view->bufs_[2]             = &view->extra_[1];
+
+        const CameraPreview::Surfaces surfaces = {
+            TargetOf(view->bufs_[0]), TargetOf(view->bufs_[1]), TargetOf(view->bufs_[2])};
+        view->preview_ = std::make_shared<CameraPreview>(surfaces, std::move(blit), config);
+        view->timer_   = lv_timer_create(OnTimer, kPollPeriodMs, view.get());
+        return view;
+    }
+
+    CameraPreviewView::~CameraPreviewView()
+    {
+        if (timer_ != nullptr)
+        {
+            lv_timer_delete(timer_);
+        }
+        if (preview_)
+        {
+            preview_->Close();
+            // Leave the caller's canvas on its own buffer, showing the last frame.
+            const std::size_t front = preview_->FrontIndex();
+            if (front != kOriginalSlot)
+            {
+                std::memcpy(original_->data,
+                            bufs_[front]->data,
+                            original_->header.stride * original_->header.h);
+                lv_canvas_set_draw_buf(canvas_, original_);
+                lv_obj_invalidate(canvas_);
+            }
+        }
+        for (lv_draw_buf_t& extra : extra_)
+        {
+            if (extra.data != nullptr)
+            {
+                allocator_.free(extra.data);
+            }
+        }
+    }
+
+    void CameraPreviewView::OnTimer(lv_timer_t* timer)
+    {
+        auto* self = static_cast<CameraPreviewView*>(lv_timer_get_user_data(timer));
+        if (self->preview_->AcquireLatest())
+        {
+            // LVGL only reads canvas pixels while rendering inside lv_timer_handler(), so the
+            // surface handed back to the capture task here is no longer referenced.
+            lv_canvas_set_draw_buf(self->canvas_, self->bufs_[self->preview_->FrontIndex()]);
+            lv_obj_invalidate(self->canvas_);
+        }
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#ifdef __has_include
+#    if __has_include("lvgl.h")
+#        ifndef LV_LVGL_H_INCLUDE_SIMPLE
+#            define LV_LVGL_H_INCLUDE_SIMPLE
+#        endif
+#    endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#    include "lvgl.h"
+#else
+#    include "lvgl/lvgl.h"
+#endif
+
+#include "platform/camera/camera_preview.h"
+
+namespace custom::platform
+{
+
+    /** Backing store for the two surfaces added next to the canvas' own buffer. */
+    struct SurfaceAllocator
+    {
+        void* (*alloc)(std::size_t bytes) = nullptr;  // lv_malloc() when unset
+        void (*free)(void* ptr)           = nullptr;
+    };
+
+    /**
+     * @brief Binds a CameraPreview to an RGB565 lv_canvas.
+     *
+     * The canvas' own draw buffer becomes one of the three preview surfaces; two more of the
+     * same geometry are allocated. A short LVGL timer swaps the canvas onto the newest frame with
+     * lv_canvas_set_draw_buf(), so displaying a frame never copies pixels. Create and destroy
+     * with the LVGL lock held; on destruction the last frame is copied back into the canvas'
+     * original buffer.
+     */
+    class CameraPreviewView
+    {
+    public:
+        /** Returns nullptr if @p canvas has no RGB565 draw buffer or allocation fails. */
+        static std::unique_ptr<CameraPreviewView> Attach(
+            lv_obj_t*                    canvas,
+            CameraPreview::BlitFn        blit,
+            const CameraPreview::Config& config,
+            const SurfaceAllocator&      allocator = {});
+
+        ~CameraPreviewView();
+
+        CameraPreviewView(const CameraPreviewView&)            = delete;
+        CameraPreviewView& operator=(const CameraPreviewView&) = delete;
+
+        /** Shared with the capture task so a late frame never touches a freed object. */
+        std::shared_ptr<CameraPreview> Preview() const
+        {
+            return preview_;
+        }
+
+    private:
+        CameraPreviewView() = default;
+
+        static void OnTimer(lv_timer_t* timer);
+
+        lv_obj_t*                      canvas_   = nullptr;
+        lv_timer_t*                    timer_    = nullptr;
+        SurfaceAllocator               allocator_;
+        lv_draw_buf_t*                 original_ = nullptr;
+        lv_draw_buf_t                  extra_[2] = {};
+        lv_draw_buf_t*                 bufs_[3]  = {};
+        std::shared_ptr<CameraPreview> preview_;
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/frame_scaler.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        std::uint16_t YuvToRgb565(int c, int d, int e)
+        {
+            const int r = std::clamp((298 * c + 409 * e + 128) >> 8, 0, 255);
+            const int g = std::clamp((298 * c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+            const int b = std::clamp((298 * c + 516 * d + 128) >> 8, 0, 255);
+            return static_cast<std::uint16_t>(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+        }
+
+    }  // namespace
+
+    FitRect FitInside(std::uint32_t src_w,
+                      std::uint32_t src_h,
+                      std::uint32_t dst_w,
+                      std::uint32_t dst_h)
+    {
+        FitRect rect;
+        if (src_w == 0U || src_h == 0U || dst_w == 0U || dst_h == 0U)
+        {
+            return rect;
+        }
+
+        // Compare dst_w / src_w against dst_h / src_h without floating point.
+        const std::uint64_t sw = src_w;
+        const std::uint64_t sh = src_h;
+        if (dst_w * sh <= dst_h * sw)
+        {
+            rect.width  = dst_w;
+            rect.height = static_cast<std::uint32_t>(sh * dst_w / sw);
+        }
+        else
+        {
+            rect.height = dst_h;
+            rect.width  = static_cast<std::uint32_t>(sw * dst_h / sh);
+        }
+        rect.width  = std::max<std::uint32_t>(rect.width, 1U);
+        rect.height = std::max<std::uint32_t>(rect.height, 1U);
+        rect.x      = (dst_w - rect.width) / 2U;
+        rect.y      = (dst_h - rect.height) / 2U;
+        return rect;
+    }
+
+    void ScaleRgb565Nearest(const FrameView& src, const FrameTarget& dst, const FitRect& rect)
+    {
+        if (src.pixels == nullptr || dst.pixels == nullptr || rect.width == 0U || rect.height == 0U
+            || rect.x + rect.width > dst.width || rect.y + rect.height > dst.height)
+        {
+            return;
+        }
+
+        const std::uint32_t step_x = (src.width << 16) / rect.width;
+        const std::uint32_t step_y = (src.height << 16) / rect.height;
+
+        std::uint32_t fy = step_y / 2U;
+        for (std::uint32_t y = 0; y < rect.height; ++y, fy += step_y)
+        {
+            const std::uint16_t* src_row =
+                src.pixels + static_cast<std::size_t>(fy >> 16) * src.stride_px;
+            std::uint16_t* dst_row =
+                dst.pixels + static_cast<std::size_t>(rect.y + y) * dst.stride_px + rect.x;
+
+            if (rect.width == src.width)
+            {
+                std::memcpy(dst_row, src_row, rect.width * sizeof(std::uint16_t));
+                continue;
+            }
+
+            std::uint32_t fx = step_x / 2U;
+            for (std::uint32_t x = 0; x < rect.width; ++x, fx += step_x)
+            {
+                dst_row[x] = src_row[fx >> 16];
+            }
+        }
+    }
+
+    void ConvertYuyvToRgb565(const std::uint8_t* src,
+                             std::uint32_t       width,
+                             std::uint32_t       height,
+                             std::uint32_t       src_stride,
+                             std::uint16_t*      dst)
+    {
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            const std::uint8_t* in  = src + static_cast<std::size_t>(y) * src_stride;
+            std::uint16_t*      out = dst + static_cast<std::size_t>(y) * width;
+            for (std::uint32_t x = 0; x + 1U < width; x += 2U, in += 4)
+            {
+                const int d = in[1] - 128;
+                const int e = in[3] - 128;
+                out[x]      = YuvToRgb565(in[0] - 16, d, e);
+                out[x + 1U] = YuvToRgb565(in[2] - 16, d, e);
+            }
+        }
+    }
+
+}  // namespace custom::platform
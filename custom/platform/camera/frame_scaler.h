@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace custom::platform
+{
+
+    /** Read-only view of an RGB565 image; stride is in pixels. */
+    struct FrameView
+    {
+        const std::uint16_t* pixels    = nullptr;
+        std::uint32_t        width     = 0U;
+        std::uint32_t        height    = 0U;
+        std::uint32_t        stride_px = 0U;
+    };
+
+    /** Writable RGB565 surface, e.g. an LVGL canvas draw buffer. */
+    struct FrameTarget
+    {
+        std::uint16_t* pixels    = nullptr;
+        std::uint32_t  width     = 0U;
+        std::uint32_t  height    = 0U;
+        std::uint32_t  stride_px = 0U;
+    };
+
+    struct FitRect
+    {
+        std::uint32_t x      = 0U;
+        std::uint32_t y      = 0U;
+        std::uint32_t width  = 0U;
+        std::uint32_t height = 0U;
+    };
+
+    /** Largest rectangle with the source aspect ratio that fits the target, centred. */
+    FitRect FitInside(std::uint32_t src_w,
+                      std::uint32_t src_h,
+                      std::uint32_t dst_w,
+                      std::uint32_t dst_h);
+
+    /**
+     * @brief Nearest-neighbour scale of @p src into @p rect of @p dst.
+     *
+     * Host fallback for the PPA: one pass, no temporaries, pixels outside @p rect untouched.
+     */
+    void ScaleRgb565Nearest(const FrameView& src, const FrameTarget& dst, const FitRect& rect);
+
+    /**
+     * @brief Convert packed YUYV 4:2:2 (BT.601, limited range) to RGB565.
+     *
+     * @p width must be even; @p src_stride is in bytes, @p dst is tightly packed.
+     */
+    void ConvertYuyvToRgb565(const std::uint8_t* src,
+                             std::uint32_t       width,
+                             std::uint32_t       height,
+                             std::uint32_t       src_stride,
+                             std::uint16_t*      dst);
+
+}  // namespace custom::platform
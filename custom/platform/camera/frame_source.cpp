@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/frame_source.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "platform/camera/raw_file_frame_source.h"
+#include "platform/camera/synthetic_frame_source.h"
+#include "platform/camera/v4l2_frame_source.h"
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        bool EndsWith(const std::string& text, const char* suffix)
+        {
+            const std::string tail(suffix);
+            return text.size() >= tail.size()
+                   && text.compare(text.size() - tail.size(), tail.size(), tail) == 0;
+        }
+
+    }  // namespace
+
+    /* ---- MemoryFrameSource ---- */
+
+    MemoryFrameSource::MemoryFrameSource(std::uint32_t width,
+                                         std::uint32_t height,
+                                         std::size_t   buffer_count,
+                                         std::uint32_t fps) :
+        width_(width),
+        height_(height),
+        buffers_(std::max<std::size_t>(buffer_count, 1U),
+                 std::vector<std::uint16_t>(static_cast<std::size_t>(width) * height)),
+        interval_(fps == 0U ? 0U : 1000000U / fps),
+        next_frame_(std::chrono::steady_clock::now())
+    {
+        for (std::size_t i = 0; i < buffers_.size(); ++i)
+        {
+            queued_.push_back(i);
+        }
+    }
+
+    bool MemoryFrameSource::Dequeue(CapturedFrame& frame)
+    {
+        if (queued_.empty())
+        {
+            return false;
+        }
+
+        if (interval_.count() > 0)
+        {
+            std::this_thread::sleep_until(next_frame_);
+            // Like a sensor, keep the cadence but never try to catch up on missed frames.
+            next_frame_ = std::max(next_frame_ + interval_, std::chrono::steady_clock::now());
+        }
+
+        const std::size_t index = queued_.front();
+        if (!Fill(buffers_[index].data()))
+        {
+            return false;
+        }
+        queued_.pop_front();
+
+        frame.index          = index;
+        frame.view.pixels    = buffers_[index].data();
+        frame.view.width     = width_;
+        frame.view.height    = height_;
+        frame.view.stride_px = width_;
+        frame.timestamp_us   = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+        return true;
+    }
+
+    void MemoryFrameSource::Requeue(const CapturedFrame& frame)
+    {
+        if (frame.index < buffers_.size()
+            && std::find(queued_.begin(), queued_.end(), frame.index) == queued_.end())
+        {
+            queued_.push_back(frame.index);
+        }
+    }
+
+    /* ---- Capture loop ---- */
+
+    CaptureResult PumpCapture(FrameSource& source, CameraPreview& preview)
+    {
+        CapturedFrame frame;
+        if (!source.Dequeue(frame))
+        {
+            return CaptureResult::kNoFrame;
+        }
+        // The preview scales straight out of the driver buffer, so it can go back immediately.
+        const bool displayed = preview.Offer(frame.view, frame.timestamp_us);
+        source.Requeue(frame);
+        return displayed ? CaptureResult::kDisplayed : CaptureResult::kDropped;
+    }
+
+    std::unique_ptr<FrameSource> OpenFrameSource(const std::string& spec,
+                                                 std::uint32_t      width,
+                                                 std::uint32_t      height,
+                                                 std::uint32_t      fps)
+    {
+        if (spec.empty() || spec == "pattern")
+        {
+            return std::make_unique<SyntheticFrameSource>(width, height, 2U, fps);
+        }
+
+        if (spec.rfind("file:", 0) == 0)
+        {
+            const std::string path   = spec.substr(5);
+            const auto        format = (EndsWith(path, ".yuyv") || EndsWith(path, ".yuv"))
+                                           ? RawPixelFormat::kYuyv
+                                           : RawPixelFormat::kRgb565;
+            auto source =
+                std::make_unique<RawFileFrameSource>(path, width, height, format, 2U, fps);
+            if (!source->IsOpen())
+            {
+                return nullptr;
+            }
+            return source;
+        }
+
+#if CUSTOM_PLATFORM_HAS_V4L2
+        if (spec.rfind("/dev/video", 0) == 0)
+        {
+            auto source = std::make_unique<V4l2FrameSource>(spec, width, height);
+            if (!source->IsOpen())
+            {
+                return nullptr;
+            }
+            return source;
+        }
+#endif
+
+        return nullptr;
+    }
+
+}  // namespace custom::platform
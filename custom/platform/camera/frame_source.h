@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "platform/camera/camera_preview.h"
+#include "platform/camera/frame_scaler.h"
+
+namespace custom::platform
+{
+
+    /** A filled driver buffer, owned by the caller between Dequeue() and Requeue(). */
+    struct CapturedFrame
+    {
+        FrameView     view;
+        std::size_t   index        = 0U;
+        std::uint64_t timestamp_us = 0U;
+    };
+
+    /**
+     * @brief Camera behind a V4L2-style buffer queue (VIDIOC_DQBUF / VIDIOC_QBUF).
+     *
+     * The Tab5 MIPI-CSI device, host webcams, test patterns and raw files all implement this, so
+     * the capture loop (PumpCapture()) and its buffer accounting are the same everywhere.
+     */
+    class FrameSource
+    {
+    public:
+        virtual ~FrameSource() = default;
+
+        /** Wait for the next filled buffer; false on timeout, starvation or end of stream. */
+        virtual bool Dequeue(CapturedFrame& frame) = 0;
+
+        /** Give a buffer obtained from Dequeue() back to the producer. */
+        virtual void Requeue(const CapturedFrame& frame) = 0;
+
+        virtual std::uint32_t Width() const  = 0;
+        virtual std::uint32_t Height() const = 0;
+    };
+
+    /**
+     * @brief Buffer ring for sources that render in software.
+     *
+     * Mirrors the driver's ownership rules: Dequeue() fails rather than overwriting a buffer the
+     * caller still holds, and an optional frame rate makes Dequeue() wait like a real sensor.
+     */
+    class MemoryFrameSource : public FrameSource
+    {
+    public:
+        bool Dequeue(CapturedFrame& frame) override;
+        void Requeue(const CapturedFrame& frame) override;
+
+        std::uint32_t Width() const override
+        {
+            return width_;
+        }
+        std::uint32_t Height() const override
+        {
+            return height_;
+        }
+
+        std::size_t QueuedBuffers() const
+        {
+            return queued_.size();
+        }
+
+    protected:
+        /** @p fps of 0 delivers frames as fast as they can be rendered. */
+        MemoryFrameSource(std::uint32_t width,
+                          std::uint32_t height,
+                          std::size_t   buffer_count,
+                          std::uint32_t fps);
+
+        /** Render the next frame into @p pixels (stride == width); false ends the stream. */
+        virtual bool Fill(std::uint16_t* pixels) = 0;
+
+    private:
+        std::uint32_t                           width_;
+        std::uint32_t                           height_;
+        std::vector<std::vector<std::uint16_t>> buffers_;
+        std::deque<std::size_t>                 queued_;
+        std::chrono::microseconds               interval_;
+        std::chrono::steady_clock::time_point   next_frame_;
+    };
+
+    enum class CaptureResult
+    {
+        kDisplayed,  // handed to the preview
+        kDropped,    // paced out, blit failed or preview closed
+        kNoFrame,    // source timed out or ended
+    };
+
+    /** One capture-loop iteration shared by every HAL: dequeue, offer, requeue. */
+    CaptureResult PumpCapture(FrameSource& source, CameraPreview& preview);
+
+    /**
+     * @brief Open a host frame source from a spec string.
+     *
+     *  - "" or "pattern"            scrolling test pattern
+     *  - "file:<path>"              raw frames, RGB565 unless the path ends in .yuyv/.yuv
+     *  - "/dev/video<N>"            V4L2 capture device (Linux hosts only)
+     *
+     * Returns nullptr if the source cannot be opened.
+     */
+    std::unique_ptr<FrameSource> OpenFrameSource(const std::string& spec,
+                                                 std::uint32_t      width,
+                                                 std::uint32_t      height,
+                                                 std::uint32_t      fps);
+
+}  // namespace custom::platform
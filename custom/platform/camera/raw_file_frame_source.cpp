@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/raw_file_frame_source.h"
+
+namespace custom::platform
+{
+
+    RawFileFrameSource::RawFileFrameSource(const std::string& path,
+                                           std::uint32_t      width,
+                                           std::uint32_t      height,
+                                           RawPixelFormat     format,
+                                           std::size_t        buffer_count,
+                                           std::uint32_t      fps) :
+        MemoryFrameSource(width, height, buffer_count, fps),
+        format_(format),
+        frame_bytes_(static_cast<std::size_t>(width) * height * 2U)
+    {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr)
+        {
+            return;
+        }
+
+        std::fseek(file_, 0, SEEK_END);
+        const long size = std::ftell(file_);
+        std::fseek(file_, 0, SEEK_SET);
+        if (size < 0 || static_cast<std::size_t>(size) < frame_bytes_ || frame_bytes_ == 0U)
+        {
+            std::fclose(file_);
+            file_ = nullptr;
+            return;
+        }
+
+        if (format_ == RawPixelFormat::kYuyv)
+        {
+            staging_.resize(frame_bytes_);
+        }
+    }
+
+    RawFileFrameSource::~RawFileFrameSource()
+    {
+        if (file_ != nullptr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    bool RawFileFrameSource::ReadFrame(void* dst)
+    {
+        if (std::fread(dst, 1U, frame_bytes_, file_) == frame_bytes_)
+        {
+            return true;
+        }
+        // Loop; a trailing partial frame is skipped.
+        std::clearerr(file_);
+        std::fseek(file_, 0, SEEK_SET);
+        return std::fread(dst, 1U, frame_bytes_, file_) == frame_bytes_;
+    }
+
+    bool RawFileFrameSource::Fill(std::uint16_t* pixels)
+    {
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+        if (format_ == RawPixelFormat::kRgb565)
+        {
+            return ReadFrame(pixels);
+        }
+        if (!ReadFrame(staging_.data()))
+        {
+            return false;
+        }
+        ConvertYuyvToRgb565(staging_.data(), Width(), Height(), Width() * 2U, pixels);
+        return true;
+    }
+
+}  // namespace custom::platform
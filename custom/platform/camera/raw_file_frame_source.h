@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "platform/camera/frame_source.h"
+
+namespace custom::platform
+{
+
+    enum class RawPixelFormat
+    {
+        kRgb565,  // little-endian, what the Tab5 sensor delivers
+        kYuyv,    // packed 4:2:2, what most USB webcams and `ffmpeg -pix_fmt yuyv422` produce
+    };
+
+    /**
+     * @brief Replays headerless raw frames from a file, looping at the end.
+     *
+     * Record with e.g. `ffmpeg -i clip.mp4 -s 1280x720 -pix_fmt rgb565le -f rawvideo out.rgb565`.
+     */
+    class RawFileFrameSource : public MemoryFrameSource
+    {
+    public:
+        RawFileFrameSource(const std::string& path,
+                           std::uint32_t      width,
+                           std::uint32_t      height,
+                           RawPixelFormat     format,
+                           std::size_t        buffer_count = 2U,
+                           std::uint32_t      fps          = 0U);
+        ~RawFileFrameSource() override;
+
+        RawFileFrameSource(const RawFileFrameSource&)            = delete;
+        RawFileFrameSource& operator=(const RawFileFrameSource&) = delete;
+
+        /** False if the file is missing or shorter than one frame. */
+        bool IsOpen() const
+        {
+            return file_ != nullptr;
+        }
+
+    protected:
+        bool Fill(std::uint16_t* pixels) override;
+
+    private:
+        bool ReadFrame(void* dst);
+
+        std::FILE*                file_ = nullptr;
+        RawPixelFormat            format_;
+        std::size_t               frame_bytes_;
+        std::vector<std::uint8_t> staging_;
+    };
+
+}  // namespace custom::platform
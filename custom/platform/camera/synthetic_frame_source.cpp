@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/synthetic_frame_source.h"
+
+#include <algorithm>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint16_t kBarColors[] = {
+            0xFFFFU, 0xFFE0U, 0x07FFU, 0x07E0U, 0xF81FU, 0xF800U, 0x001FU, 0x0000U,
+        };
+        constexpr std::uint32_t kBarCount    = sizeof(kBarColors) / sizeof(kBarColors[0]);
+        constexpr std::uint32_t kScrollPx    = 4U;
+        constexpr std::uint32_t kMarkerSize  = 64U;
+        constexpr std::uint16_t kMarkerColor = 0xFD20U;
+
+    }  // namespace
+
+    SyntheticFrameSource::SyntheticFrameSource(std::uint32_t width,
+                                               std::uint32_t height,
+                                               std::size_t   buffer_count,
+                                               std::uint32_t fps) :
+        MemoryFrameSource(width, height, buffer_count, fps)
+    {
+    }
+
+    bool SyntheticFrameSource::Fill(std::uint16_t* pixels)
+    {
+        const std::uint32_t width  = Width();
+        const std::uint32_t height = Height();
+
+        const std::uint32_t bar_width = std::max<std::uint32_t>(width / kBarCount, 1U);
+        const std::uint32_t scroll    = frame_index_ * kScrollPx;
+        for (std::uint32_t x = 0; x < width; ++x)
+        {
+            pixels[x] = kBarColors[((x + scroll) / bar_width) % kBarCount];
+        }
+        for (std::uint32_t y = 1; y < height; ++y)
+        {
+            std::copy_n(pixels, width, pixels + std::size_t{y} * width);
+        }
+
+        const std::uint32_t marker = std::min({kMarkerSize, width, height});
+        const std::uint32_t span_x = width - marker + 1U;
+        const std::uint32_t span_y = height - marker + 1U;
+        const std::uint32_t mx     = (frame_index_ * 7U) % span_x;
+        const std::uint32_t my     = (frame_index_ * 5U) % span_y;
+        for (std::uint32_t y = my; y < my + marker; ++y)
+        {
+            std::fill_n(pixels + std::size_t{y} * width + mx, marker, kMarkerColor);
+        }
+
+        ++frame_index_;
+        return true;
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "platform/camera/frame_source.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Stand-in for the MIPI-CSI sensor on host builds and benchmarks.
+     *
+     * Renders scrolling colour bars with a moving marker, so motion and tearing are easy to spot.
+     */
+    class SyntheticFrameSource : public MemoryFrameSource
+    {
+    public:
+        SyntheticFrameSource(std::uint32_t width,
+                             std::uint32_t height,
+                             std::size_t   buffer_count = 2U,
+                             std::uint32_t fps          = 0U);
+
+        std::uint32_t FrameIndex() const
+        {
+            return frame_index_;
+        }
+
+    protected:
+        bool Fill(std::uint16_t* pixels) override;
+
+    private:
+        std::uint32_t frame_index_ = 0U;
+    };
+
+}  // namespace custom::platform
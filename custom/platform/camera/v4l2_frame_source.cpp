@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/camera/v4l2_frame_source.h"
+
+#if CUSTOM_PLATFORM_HAS_V4L2
+
+#    include <cerrno>
+#    include <cstring>
+#    include <fcntl.h>
+#    include <linux/videodev2.h>
+#    include <poll.h>
+#    include <sys/ioctl.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        int Xioctl(int fd, unsigned long request, void* arg)
+        {
+            int result;
+            do
+            {
+                result = ioctl(fd, request, arg);
+            } while (result == -1 && errno == EINTR);
+            return result;
+        }
+
+    }  // namespace
+
+    V4l2FrameSource::V4l2FrameSource(const std::string& device,
+                                     std::uint32_t      width,
+                                     std::uint32_t      height,
+                                     int                timeout_ms) :
+        timeout_ms_(timeout_ms)
+    {
+        if (!Open(device, width, height))
+        {
+            Release();
+        }
+    }
+
+    V4l2FrameSource::~V4l2FrameSource()
+    {
+        Release();
+    }
+
+    bool V4l2FrameSource::Open(const std::string& device, std::uint32_t width, std::uint32_t height)
+    {
+        fd_ = open(device.c_str(), O_RDWR | O_NONBLOCK);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+
+        v4l2_format format{};
+        format.type                = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        format.fmt.pix.width       = width;
+        format.fmt.pix.height      = height;
+        format.fmt.pix.field       = V4L2_FIELD_NONE;
+        format.fmt.pix.pixelformat = V4L2_PIX_FMT_RGB565;
+        if (Xioctl(fd_, VIDIOC_S_FMT, &format) != 0
+            || format.fmt.pix.pixelformat != V4L2_PIX_FMT_RGB565)
+        {
+            format.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+            if (Xioctl(fd_, VIDIOC_S_FMT, &format) != 0
+                || format.fmt.pix.pixelformat != V4L2_PIX_FMT_YUYV)
+            {
+                return false;
+            }
+            yuyv_ = true;
+        }
+        width_  = format.fmt.pix.width;
+        height_ = format.fmt.pix.height;
+        stride_ = format.fmt.pix.bytesperline != 0U ? format.fmt.pix.bytesperline : width_ * 2U;
+
+        v4l2_requestbuffers request{};
+        request.count  = kBufferCount;
+        request.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        request.memory = V4L2_MEMORY_MMAP;
+        if (Xioctl(fd_, VIDIOC_REQBUFS, &request) != 0 || request.count == 0U)
+        {
+            return false;
+        }
+
+        for (std::uint32_t i = 0; i < request.count && i < kBufferCount; ++i)
+        {
+            v4l2_buffer buf{};
+            buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index  = i;
+            if (Xioctl(fd_, VIDIOC_QUERYBUF, &buf) != 0)
+            {
+                return false;
+            }
+            void* data =
+                mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+            if (data == MAP_FAILED)
+            {
+                return false;
+            }
+            mappings_[i].data   = data;
+            mappings_[i].length = buf.length;
+            if (yuyv_)
+            {
+                mappings_[i].converted.resize(static_cast<std::size_t>(width_) * height_);
+            }
+            mapped_ = i + 1U;
+
+            if (Xioctl(fd_, VIDIOC_QBUF, &buf) != 0)
+            {
+                return false;
+            }
+        }
+
+        int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (Xioctl(fd_, VIDIOC_STREAMON, &type) != 0)
+        {
+            return false;
+        }
+        streaming_ = true;
+        return true;
+    }
+
+    void V4l2FrameSource::Release()
+    {
+        if (streaming_)
+        {
+            int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            Xioctl(fd_, VIDIOC_STREAMOFF, &type);
+            streaming_ = false;
+        }
+        for (std::size_t i = 0; i < mapped_; ++i)
+        {
+            munmap(mappings_[i].data, mappings_[i].length);
+            mappings_[i] = Mapping();
+        }
+        mapped_ = 0U;
+        if (fd_ >= 0)
+        {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    bool V4l2FrameSource::Dequeue(CapturedFrame& frame)
+    {
+        if (!streaming_)
+        {
+            return false;
+        }
+
+        pollfd pfd{};
+        pfd.fd     = fd_;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, timeout_ms_) <= 0)
+        {
+            return false;
+        }
+
+        v4l2_buffer buf{};
+        buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (Xioctl(fd_, VIDIOC_DQBUF, &buf) != 0 || buf.index >= mapped_)
+        {
+            return false;
+        }
+
+        Mapping& mapping  = mappings_[buf.index];
+        frame.index       = buf.index;
+        frame.view.width  = width_;
+        frame.view.height = height_;
+        if (yuyv_)
+        {
+            ConvertYuyvToRgb565(static_cast<const std::uint8_t*>(mapping.data),
+                                width_,
+                                height_,
+                                stride_,
+                                mapping.converted.data());
+            frame.view.pixels    = mapping.converted.data();
+            frame.view.stride_px = width_;
+        }
+        else
+        {
+            frame.view.pixels    = static_cast<const std::uint16_t*>(mapping.data);
+            frame.view.stride_px = stride_ / 2U;
+        }
+        frame.timestamp_us = static_cast<std::uint64_t>(buf.timestamp.tv_sec) * 1000000U
+                             + static_cast<std::uint64_t>(buf.timestamp.tv_usec);
+        return true;
+    }
+
+    void V4l2FrameSource::Requeue(const CapturedFrame& frame)
+    {
+        if (!streaming_ || frame.index >= mapped_)
+        {
+            return;
+        }
+        v4l2_buffer buf{};
+        buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index  = static_cast<std::uint32_t>(frame.index);
+        Xioctl(fd_, VIDIOC_QBUF, &buf);
+    }
+
+}  // namespace custom::platform
+
+#endif  // CUSTOM_PLATFORM_HAS_V4L2
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+// Host webcams only; on Tab5 the CSI device is driven by the HAL through esp_video.
+#if defined(__linux__) && !defined(ESP_PLATFORM) && defined(__has_include)
+#    if __has_include(<linux/videodev2.h>)
+#        define CUSTOM_PLATFORM_HAS_V4L2 1
+#    endif
+#endif
+#ifndef CUSTOM_PLATFORM_HAS_V4L2
+#    define CUSTOM_PLATFORM_HAS_V4L2 0
+#endif
+
+#if CUSTOM_PLATFORM_HAS_V4L2
+
+#    include <cstdint>
+#    include <string>
+#    include <vector>
+
+#    include "platform/camera/frame_source.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Memory-mapped V4L2 capture, e.g. a USB webcam on a Linux desktop.
+     *
+     * Asks for RGB565 and falls back to YUYV, which is converted into a per-buffer staging
+     * image. The driver may pick a different size than requested; Width()/Height() report it.
+     */
+    class V4l2FrameSource : public FrameSource
+    {
+    public:
+        static constexpr std::size_t kBufferCount = 3U;
+
+        V4l2FrameSource(const std::string& device,
+                        std::uint32_t      width,
+                        std::uint32_t      height,
+                        int                timeout_ms = 200);
+        ~V4l2FrameSource() override;
+
+        V4l2FrameSource(const V4l2FrameSource&)            = delete;
+        V4l2FrameSource& operator=(const V4l2FrameSource&) = delete;
+
+        bool IsOpen() const
+        {
+            return streaming_;
+        }
+
+        bool Dequeue(CapturedFrame& frame) override;
+        void Requeue(const CapturedFrame& frame) override;
+
+        std::uint32_t Width() const override
+        {
+            return width_;
+        }
+        std::uint32_t Height() const override
+        {
+            return height_;
+        }
+
+    private:
+        struct Mapping
+        {
+            void*                      data   = nullptr;
+            std::size_t                length = 0U;
+            std::vector<std::uint16_t> converted;
+        };
+
+        bool Open(const std::string& device, std::uint32_t width, std::uint32_t height);
+        void Release();
+
+        int           fd_         = -1;
+        int           timeout_ms_ = 200;
+        bool          streaming_  = false;
+        bool          yuyv_       = false;
+        std::uint32_t width_      = 0U;
+        std::uint32_t height_     = 0U;
+        std::uint32_t stride_     = 0U;
+        Mapping       mappings_[kBufferCount];
+        std::size_t   mapped_ = 0U;
+    };
+
+}  // namespace custom::platform
+
+#endif  // CUSTOM_PLATFORM_HAS_V4L2
@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Typed publish/subscribe bus with fixed-size tables and no heap use.
+     *
+     * Topics are enumerators (at most 64) and payloads are trivially copyable structs, so an
+     * event is a plain copy and subscribers switch on the topic instead of comparing strings.
+     * Handlers are function pointers plus a context pointer, held in kMaxSubscribers slots.
+     *
+     * Subscribe(), Unsubscribe(), Publish() and Dispatch() belong to the thread that owns the
+     * bus. Publish() calls the matching handlers right away. Any other thread (HAL tasks,
+     * LVGL callbacks, ISRs deferred to a task) uses Post(), which copies the event into a
+     * kQueueDepth ring under a short lock. The owner drains the ring in batches with Dispatch(),
+     * taking the lock once per batch and calling the handlers outside it. A full ring drops the
+     * new event and counts it.
+     */
+    template <typename Topic,
+              typename Payload,
+              std::size_t kMaxSubscribers = 8U,
+              std::size_t kQueueDepth     = 32U>
+    class EventBus
+    {
+        static_assert(std::is_enum<Topic>::value, "EventBus topics must be an enum");
+        static_assert(std::is_trivially_copyable<Payload>::value,
+                      "EventBus payloads must be trivially copyable");
+        static_assert(kMaxSubscribers > 0U && kQueueDepth > 0U, "EventBus needs capacity");
+
+    public:
+        using Handler = void (*)(Topic topic, const Payload& payload, void* ctx);
+
+        /** Returned by Subscribe() when every slot is taken. */
+        static constexpr int kInvalidSubscription = -1;
+
+        struct Stats
+        {
+            std::uint32_t published  = 0U;  // Publish() calls
+            std::uint32_t posted     = 0U;  // Post() calls that were queued
+            std::uint32_t dropped    = 0U;  // Post() calls rejected by a full queue
+            std::uint32_t dispatched = 0U;  // queued events delivered by Dispatch()
+            std::uint32_t batches    = 0U;  // Dispatch() calls that found work
+            std::uint32_t max_batch  = 0U;  // largest single batch
+            std::uint32_t max_queued = 0U;  // deepest the queue got
+        };
+
+        EventBus() = default;
+
+        EventBus(const EventBus&)            = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        /** Call @p handler for @p topic only. Returns a slot id, or kInvalidSubscription. */
+        int Subscribe(Topic topic, Handler handler, void* ctx = nullptr)
+        {
+            return AddSubscriber(TopicBit(topic), handler, ctx);
+        }
+
+        /** Call @p handler for every topic. */
+        int SubscribeAll(Handler handler, void* ctx = nullptr)
+        {
+            return AddSubscriber(~std::uint64_t{0U}, handler, ctx);
+        }
+
+        /** Free a slot; safe to call from inside a handler. */
+        void Unsubscribe(int id)
+        {
+            if (id >= 0 && static_cast<std::size_t>(id) < kMaxSubscribers)
+            {
+                subscribers_[static_cast<std::size_t>(id)] = Subscriber{};
+            }
+        }
+
+        std::size_t SubscriberCount() const
+        {
+            return static_cast<std::size_t>(
+                std::count_if(subscribers_.begin(), subscribers_.end(), [](const Subscriber& s) {
+                    return s.handler != nullptr;
+                }));
+        }
+
+        /** Owner thread: deliver now, on the caller's stack. */
+        void Publish(Topic topic, const Payload& payload)
+        {
+            stats_.published++;
+            Deliver(topic, payload);
+        }
+
+        /** Any thread: queue for the next Dispatch(). Returns false if the event was dropped. */
+        bool Post(Topic topic, const Payload& payload)
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (queued_ == kQueueDepth)
+            {
+                queue_stats_.dropped++;
+                return false;
+            }
+            queue_[(head_ + queued_) % kQueueDepth] = Event{topic, payload};
+            queued_++;
+            queue_stats_.posted++;
+            queue_stats_.max_queued =
+                std::max(queue_stats_.max_queued, static_cast<std::uint32_t>(queued_));
+            return true;
+        }
+
+        /** Owner thread: deliver up to @p max_events queued events, returns how many. */
+        std::size_t Dispatch(std::size_t max_events = kQueueDepth)
+        {
+            std::size_t count = 0U;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                count = std::min({max_events, queued_, kQueueDepth});
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    batch_[i] = queue_[(head_ + i) % kQueueDepth];
+                }
+                head_ = (head_ + count) % kQueueDepth;
+                queued_ -= count;
+            }
+            if (count == 0U)
+            {
+                return 0U;
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Deliver(batch_[i].topic, batch_[i].payload);
+            }
+            stats_.dispatched += static_cast<std::uint32_t>(count);
+            stats_.batches++;
+            stats_.max_batch = std::max(stats_.max_batch, static_cast<std::uint32_t>(count));
+            return count;
+        }
+
+        std::size_t Pending() const
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            return queued_;
+        }
+
+        Stats GetStats() const
+        {
+            Stats stats = stats_;
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stats.posted     = queue_stats_.posted;
+            stats.dropped    = queue_stats_.dropped;
+            stats.max_queued = queue_stats_.max_queued;
+            return stats;
+        }
+
+    private:
+        struct Subscriber
+        {
+            std::uint64_t topics  = 0U;
+            Handler       handler = nullptr;
+            void*         ctx     = nullptr;
+        };
+
+        struct Event
+        {
+            Topic   topic;
+            Payload payload;
+        };
+
+        static std::uint64_t TopicBit(Topic topic)
+        {
+            const auto index = static_cast<std::uint64_t>(topic);
+            return index < 64U ? (std::uint64_t{1U} << index) : 0U;
+        }
+
+        int AddSubscriber(std::uint64_t topics, Handler handler, void* ctx)
+        {
+            if (handler == nullptr || topics == 0U)
+            {
+                return kInvalidSubscription;
+            }
+            for (std::size_t i = 0; i < kMaxSubscribers; ++i)
+            {
+                if (subscribers_[i].handler == nullptr)
+                {
+                    subscribers_[i] = Subscriber{topics, handler, ctx};
+                    return static_cast<int>(i);
+                }
+            }
+            return kInvalidSubscription;
+        }
+
+        void Deliver(Topic topic, const Payload& payload)
+        {
+            const std::uint64_t bit = TopicBit(topic);
+            for (std::size_t i = 0; i < kMaxSubscribers; ++i)
+            {
+                // Re-read the slot each time so handlers may unsubscribe themselves or others.
+                const Subscriber subscriber = subscribers_[i];
+                if (subscriber.handler != nullptr && (subscriber.topics & bit) != 0U)
+                {
+                    subscriber.handler(topic, payload, subscriber.ctx);
+                }
+            }
+        }
+
+        std::array<Subscriber, kMaxSubscribers> subscribers_{};
+        Stats                                   stats_{};
+
+        mutable std::mutex             queue_mutex_;
+        std::array<Event, kQueueDepth> queue_{};
+        std::size_t                    head_   = 0U;
+        std::size_t                    queued_ = 0U;
+        Stats                          queue_stats_{};
+        std::array<Event, kQueueDepth> batch_{};  // owner thread only
+    };
+
+}  // namespace custom::platform
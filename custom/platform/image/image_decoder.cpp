@@ -0,0 +1,296 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/image/image_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        // Beyond this an output pixel could sum more than 2^32 / 255 source pixels
+        constexpr std::uint64_t kMaxPixelsPerOutput = 1U << 24;
+
+        constexpr std::uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    }  // namespace
+
+    const char* ImageDecodeResultName(ImageDecodeResult result)
+    {
+        switch (result)
+        {
+            case ImageDecodeResult::kOk:
+                return "ok";
+            case ImageDecodeResult::kUnknownFormat:
+                return "unknown format";
+            case ImageDecodeResult::kUnsupported:
+                return "unsupported";
+            case ImageDecodeResult::kCorrupt:
+                return "corrupt";
+            case ImageDecodeResult::kTruncated:
+                return "truncated";
+            case ImageDecodeResult::kTooLarge:
+                return "too large";
+        }
+        return "?";
+    }
+
+    /* ---- ImageStream ---- */
+
+    ImageStream::ImageStream(ImageReader read, std::size_t buffer_bytes) :
+        read_(std::move(read)), buffer_(std::max<std::size_t>(buffer_bytes, 64U))
+    {
+    }
+
+    bool ImageStream::Refill()
+    {
+        if (eof_)
+        {
+            return false;
+        }
+        if (pos_ > 0U)
+        {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0U;
+        }
+        const std::size_t got = read_ ? read_(buffer_.data() + end_, buffer_.size() - end_) : 0U;
+        if (got == 0U)
+        {
+            eof_ = true;
+            return false;
+        }
+        end_ += got;
+        return true;
+    }
+
+    bool ImageStream::Read(std::uint8_t* dst, std::size_t len)
+    {
+        while (len > 0U)
+        {
+            if (pos_ == end_ && !Refill())
+            {
+                return false;
+            }
+            const std::size_t chunk = std::min(len, end_ - pos_);
+            std::memcpy(dst, buffer_.data() + pos_, chunk);
+            pos_ += chunk;
+            dst += chunk;
+            len -= chunk;
+        }
+        return true;
+    }
+
+    bool ImageStream::Skip(std::size_t len)
+    {
+        while (len > 0U)
+        {
+            if (pos_ == end_ && !Refill())
+            {
+                return false;
+            }
+            const std::size_t chunk = std::min(len, end_ - pos_);
+            pos_ += chunk;
+            len -= chunk;
+        }
+        return true;
+    }
+
+    const std::uint8_t* ImageStream::Peek(std::size_t len)
+    {
+        if (len > buffer_.size())
+        {
+            return nullptr;
+        }
+        while (end_ - pos_ < len)
+        {
+            if (!Refill())
+            {
+                return nullptr;
+            }
+        }
+        return buffer_.data() + pos_;
+    }
+
+    /* ---- BoxRowScaler ---- */
+
+    bool BoxRowScaler::SourceFits(std::uint32_t            src_width,
+                                  std::uint32_t            src_height,
+                                  const ImageScaleOptions& options)
+    {
+        return src_width <= kMaxSide && src_height <= kMaxSide
+               && static_cast<std::uint64_t>(src_width) * src_height <= options.max_source_pixels;
+    }
+
+    void BoxRowScaler::Plan(std::uint32_t            src_width,
+                            std::uint32_t            src_height,
+                            const ImageScaleOptions& options,
+                            std::uint32_t&           crop_width,
+                            std::uint32_t&           crop_height,
+                            std::uint32_t&           out_width,
+                            std::uint32_t&           out_height)
+    {
+        crop_width  = src_width;
+        crop_height = src_height;
+        if (options.width == 0U || options.height == 0U)
+        {
+            out_width  = src_width;
+            out_height = src_height;
+            return;
+        }
+
+        // The largest rectangle with the card's aspect ratio, as FitInside() but the other way
+        const std::uint64_t sw = src_width;
+        const std::uint64_t sh = src_height;
+        if (sw * options.height <= sh * options.width)
+        {
+            crop_height = static_cast<std::uint32_t>(sw * options.height / options.width);
+        }
+        else
+        {
+            crop_width = static_cast<std::uint32_t>(sh * options.width / options.height);
+        }
+        crop_width  = std::max<std::uint32_t>(crop_width, 1U);
+        crop_height = std::max<std::uint32_t>(crop_height, 1U);
+        out_width   = std::min(options.width, crop_width);
+        out_height  = std::min(options.height, crop_height);
+    }
+
+    bool BoxRowScaler::Begin(std::uint32_t            src_width,
+                             std::uint32_t            src_height,
+                             const ImageScaleOptions& options,
+                             ScaledImage&             out)
+    {
+        if (src_width == 0U || src_height == 0U || src_width > kMaxSide
+            || src_height > kMaxSide)
+        {
+            return false;
+        }
+        std::uint32_t crop_width  = 0U;
+        std::uint32_t out_width   = 0U;
+        std::uint32_t out_height  = 0U;
+        Plan(src_width, src_height, options, crop_width, crop_height_, out_width, out_height);
+        const std::uint64_t per_output = static_cast<std::uint64_t>(crop_width / out_width + 1U)
+                                         * (crop_height_ / out_height + 1U);
+        if (per_output > kMaxPixelsPerOutput)
+        {
+            return false;
+        }
+
+        out_       = &out;
+        out.width  = out_width;
+        out.height = out_height;
+        out.pixels.assign(static_cast<std::size_t>(out_width) * out_height, 0U);
+        crop_x_      = (src_width - crop_width) / 2U;
+        crop_y_      = (src_height - crop_height_) / 2U;
+        src_row_     = 0U;
+        out_row_     = 0U;
+        rows_summed_ = 0U;
+
+        column_.resize(crop_width);
+        per_column_.assign(out_width, 0U);
+        for (std::uint32_t x = 0U; x < crop_width; ++x)
+        {
+            const auto target = static_cast<std::uint16_t>(
+                static_cast<std::uint64_t>(x) * out_width / crop_width);
+            column_[x] = target;
+            per_column_[target]++;
+        }
+        sums_.assign(static_cast<std::size_t>(out_width) * 3U, 0U);
+        return true;
+    }
+
+    void BoxRowScaler::PushRow(const std::uint8_t* rgb)
+    {
+        if (Done())
+        {
+            return;
+        }
+        const std::uint32_t y = src_row_++;
+        if (y < crop_y_)
+        {
+            return;
+        }
+        const std::uint32_t row = y - crop_y_;
+        const auto          target = static_cast<std::uint32_t>(
+            static_cast<std::uint64_t>(row) * out_->height / crop_height_);
+        if (target != out_row_ && rows_summed_ > 0U)
+        {
+            FlushRow();
+        }
+
+        const std::uint8_t* in = rgb + static_cast<std::size_t>(crop_x_) * 3U;
+        for (const std::uint16_t x : column_)
+        {
+            std::uint32_t* sum = &sums_[x * 3U];
+            sum[0] += in[0];
+            sum[1] += in[1];
+            sum[2] += in[2];
+            in += 3;
+        }
+        rows_summed_++;
+        if (row + 1U == crop_height_)
+        {
+            FlushRow();
+        }
+    }
+
+    bool BoxRowScaler::Done() const
+    {
+        return out_ == nullptr || out_row_ >= out_->height;
+    }
+
+    void BoxRowScaler::FlushRow()
+    {
+        std::uint16_t* dst = out_->pixels.data() + static_cast<std::size_t>(out_row_) * out_->width;
+        for (std::uint32_t x = 0U; x < out_->width; ++x)
+        {
+            const std::uint32_t count = per_column_[x] * rows_summed_;
+            const std::uint32_t half  = count / 2U;
+            std::uint32_t*      sum   = &sums_[x * 3U];
+            const std::uint32_t r     = (sum[0] + half) / count;
+            const std::uint32_t g     = (sum[1] + half) / count;
+            const std::uint32_t b     = (sum[2] + half) / count;
+            dst[x] = static_cast<std::uint16_t>(((r & 0xF8U) << 8) | ((g & 0xFCU) << 3) | (b >> 3));
+            sum[0] = sum[1] = sum[2] = 0U;
+        }
+        rows_summed_ = 0U;
+        out_row_++;
+    }
+
+    /* ---- Dispatch ---- */
+
+    ImageDecodeResult DecodeImageScaled(const ImageReader&       read,
+                                        const ImageScaleOptions& options,
+                                        ScaledImage&             out,
+                                        ImageDecodeInfo*         info)
+    {
+        ImageStream         in(read);
+        const std::uint8_t* head = in.Peek(sizeof(kPngSignature));
+        if (head == nullptr)
+        {
+            head = in.Peek(2U);
+        }
+        if (head == nullptr)
+        {
+            return ImageDecodeResult::kTruncated;
+        }
+        if (head[0] == 0xFFU && head[1] == 0xD8U)
+        {
+            return DecodeJpegScaled(in, options, out, info);
+        }
+        if (std::memcmp(head, kPngSignature, 2U) == 0)
+        {
+            return DecodePngScaled(in, options, out, info);
+        }
+        return ImageDecodeResult::kUnknownFormat;
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace custom::platform
+{
+
+    /** Copy up to @p len bytes into @p dst; 0 at the end of the data or on error. */
+    using ImageReader = std::function<std::size_t(std::uint8_t* dst, std::size_t len)>;
+
+    enum class ImageFormat : std::uint8_t
+    {
+        kUnknown,
+        kJpeg,
+        kPng,
+    };
+
+    enum class ImageDecodeResult : std::uint8_t
+    {
+        kOk,
+        kUnknownFormat,
+        kUnsupported,  // progressive or arithmetic JPEG, CMYK, interlaced PNG
+        kCorrupt,
+        kTruncated,
+        kTooLarge,
+    };
+
+    const char* ImageDecodeResultName(ImageDecodeResult result);
+
+    struct ImageScaleOptions
+    {
+        /** The card. The image fills it, the longer side cropped; never scaled up. */
+        std::uint32_t width  = 0U;
+        std::uint32_t height = 0U;
+        /** RGB888 shown under transparent PNG pixels. */
+        std::uint32_t background = 0x000000U;
+        /** Larger sources are refused before anything is allocated for them. */
+        std::uint32_t max_source_pixels = 24U * 1000U * 1000U;
+    };
+
+    /** Tightly packed RGB565, at most the card size and with its aspect ratio. */
+    struct ScaledImage
+    {
+        std::uint32_t              width  = 0U;
+        std::uint32_t              height = 0U;
+        std::vector<std::uint16_t> pixels;
+    };
+
+    struct ImageDecodeInfo
+    {
+        ImageFormat   format        = ImageFormat::kUnknown;
+        std::uint32_t source_width  = 0U;
+        std::uint32_t source_height = 0U;
+        /** JPEG only: 1, 2, 4 or 8, the reduction taken in the DCT before the box filter. */
+        std::uint8_t block_scale = 1U;
+    };
+
+    /**
+     * @brief Buffered pull reader shared by the decoders.
+     *
+     * The buffer is the only copy of the compressed data the decoders ever hold, so a download
+     * can be decoded as it arrives.
+     */
+    class ImageStream
+    {
+    public:
+        static constexpr std::size_t kDefaultBufferBytes = 4096U;
+
+        explicit ImageStream(ImageReader read, std::size_t buffer_bytes = kDefaultBufferBytes);
+
+        /** Next byte, or -1 at the end of the data. */
+        int Next()
+        {
+            if (pos_ == end_ && !Refill())
+            {
+                return -1;
+            }
+            return buffer_[pos_++];
+        }
+
+        bool Read(std::uint8_t* dst, std::size_t len);
+        bool Skip(std::size_t len);
+
+        /** The next @p len bytes without consuming them; nullptr if the data ends first. */
+        const std::uint8_t* Peek(std::size_t len);
+
+    private:
+        bool Refill();
+
+        ImageReader               read_;
+        std::vector<std::uint8_t> buffer_;
+        std::size_t               pos_ = 0U;
+        std::size_t               end_ = 0U;
+        bool                      eof_ = false;
+    };
+
+    /**
+     * @brief Box-filters RGB888 rows, top to bottom, into a ScaledImage.
+     *
+     * Every source pixel inside the crop lands in exactly one output pixel, so the only state
+     * is one output row of sums. Decoders stop once Done() is true: rows under the crop are
+     * never decoded.
+     */
+    class BoxRowScaler
+    {
+    public:
+        static constexpr std::uint32_t kMaxSide = 16384U;
+
+        /** False for a source too large to decode at all under @p options. */
+        static bool SourceFits(std::uint32_t            src_width,
+                               std::uint32_t            src_height,
+                               const ImageScaleOptions& options);
+
+        /** Size @p out for a @p src_width x @p src_height source; false if it cannot be. */
+        bool Begin(std::uint32_t            src_width,
+                   std::uint32_t            src_height,
+                   const ImageScaleOptions& options,
+                   ScaledImage&             out);
+
+        /** @p rgb holds src_width pixels. */
+        void PushRow(const std::uint8_t* rgb);
+        bool Done() const;
+
+        /** The crop and output size Begin() would pick, for choosing a JPEG block scale. */
+        static void Plan(std::uint32_t            src_width,
+                         std::uint32_t            src_height,
+                         const ImageScaleOptions& options,
+                         std::uint32_t&           crop_width,
+                         std::uint32_t&           crop_height,
+                         std::uint32_t&           out_width,
+                         std::uint32_t&           out_height);
+
+    private:
+        void FlushRow();
+
+        ScaledImage*               out_         = nullptr;
+        std::uint32_t              crop_x_      = 0U;
+        std::uint32_t              crop_y_      = 0U;
+        std::uint32_t              crop_height_ = 0U;
+        std::uint32_t              src_row_     = 0U;
+        std::uint32_t              out_row_     = 0U;
+        std::uint32_t              rows_summed_ = 0U;
+        std::vector<std::uint16_t> column_;      // output column of each column in the crop
+        std::vector<std::uint16_t> per_column_;  // crop columns summed into each output pixel
+        std::vector<std::uint32_t> sums_;        // r, g, b per output pixel
+    };
+
+    /**
+     * @brief Decode a JPEG or PNG straight to card size.
+     *
+     * Nothing the size of the source image is allocated. Baseline JPEG is decoded one MCU row
+     * at a time, reduced by up to 8x in the DCT itself (an 8x reduction needs only the DC
+     * coefficient); PNG is inflated one row at a time through a 32 KB window. Either way rows
+     * go through a BoxRowScaler as soon as they are complete.
+     */
+    ImageDecodeResult DecodeImageScaled(const ImageReader&       read,
+                                        const ImageScaleOptions& options,
+                                        ScaledImage&             out,
+                                        ImageDecodeInfo*         info = nullptr);
+
+    /** The same, for a stream already known to hold a JPEG (from its SOI marker on). */
+    ImageDecodeResult DecodeJpegScaled(ImageStream&             in,
+                                       const ImageScaleOptions& options,
+                                       ScaledImage&             out,
+                                       ImageDecodeInfo*         info = nullptr);
+
+    /** The same, for a PNG (from its signature on). */
+    ImageDecodeResult DecodePngScaled(ImageStream&             in,
+                                      const ImageScaleOptions& options,
+                                      ScaledImage&             out,
+                                      ImageDecodeInfo*         info = nullptr);
+
+}  // namespace custom::platform
@@ -0,0 +1,843 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/image/image_decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint8_t kZigzag[64] = {
+            0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+            12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+            35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+            58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+        constexpr int kFastBits     = 9;
+        constexpr int kTableBits    = 11;  // fixed point of the IDCT tables
+        constexpr int kPass1Shift   = 8;   // leaves 3 fractional bits between the passes
+        constexpr int kCoefLimit    = 4095;
+        constexpr int kDcLimit      = 2047;  // enough for 8-bit samples, and x quant fits
+        constexpr int kMaxSampling  = 4;
+        constexpr int kMaxMcuBlocks = 10;
+
+        constexpr int kMarkerSof0 = 0xC0;
+        constexpr int kMarkerSof1 = 0xC1;
+        constexpr int kMarkerDht  = 0xC4;
+        constexpr int kMarkerRst0 = 0xD0;
+        constexpr int kMarkerRst7 = 0xD7;
+        constexpr int kMarkerSoi  = 0xD8;
+        constexpr int kMarkerEoi  = 0xD9;
+        constexpr int kMarkerSos  = 0xDA;
+        constexpr int kMarkerDqt  = 0xDB;
+        constexpr int kMarkerDri  = 0xDD;
+
+        bool IsUnsupportedFrame(int marker)
+        {
+            // Progressive, lossless and arithmetic-coded frames; 0xC4 and 0xCC are tables
+            return marker >= 0xC2 && marker <= 0xCF && marker != kMarkerDht && marker != 0xCC;
+        }
+
+        struct HuffmanTable
+        {
+            bool          defined = false;
+            std::uint16_t fast[1 << kFastBits];  // (length << 8) | symbol; 0 for longer codes
+            std::int32_t  max_code[17];          // largest code of each length, -1 if none
+            std::int32_t  value_offset[17];      // index into values minus the first code
+            std::uint8_t  values[256];
+        };
+
+        bool BuildHuffman(HuffmanTable&       table,
+                          const std::uint8_t* counts,
+                          const std::uint8_t* values,
+                          int                 total)
+        {
+            std::memset(table.fast, 0, sizeof(table.fast));
+            std::memcpy(table.values, values, static_cast<std::size_t>(total));
+            std::int32_t code  = 0;
+            int          index = 0;
+            for (int length = 1; length <= 16; ++length)
+            {
+                table.value_offset[length] = index - code;
+                for (int i = 0; i < counts[length - 1]; ++i, ++code, ++index)
+                {
+                    if (code >= (1 << length))
+                    {
+                        return false;  // more codes than this length can hold
+                    }
+                    if (length <= kFastBits)
+                    {
+                        const int spread = 1 << (kFastBits - length);
+                        const int first  = code << (kFastBits - length);
+                        for (int j = 0; j < spread; ++j)
+                        {
+                            table.fast[first + j] =
+                                static_cast<std::uint16_t>((length << 8) | values[index]);
+                        }
+                    }
+                }
+                table.max_code[length] = counts[length - 1] > 0 ? code - 1 : -1;
+                code <<= 1;
+            }
+            table.defined = true;
+            return true;
+        }
+
+        struct Component
+        {
+            int           id       = 0;
+            int           h        = 1;
+            int           v        = 1;
+            int           quant    = 0;
+            int           dc_table = 0;
+            int           ac_table = 0;
+            int           dc_pred  = 0;
+            std::uint8_t* plane    = nullptr;  // this MCU's samples, plane_stride_ wide
+        };
+
+        /** One decode; large enough that it lives on the heap, not a task stack. */
+        class JpegDecoder
+        {
+        public:
+            JpegDecoder(ImageStream& in, const ImageScaleOptions& options) :
+                in_(in), options_(options)
+            {
+            }
+
+            ImageDecodeResult Run(ScaledImage& out, ImageDecodeInfo* info)
+            {
+                if (in_.Next() != 0xFF || in_.Next() != kMarkerSoi)
+                {
+                    return ImageDecodeResult::kUnknownFormat;
+                }
+                for (;;)
+                {
+                    const int marker = NextMarker();
+                    if (marker < 0)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    ImageDecodeResult result = ImageDecodeResult::kOk;
+                    if (marker == kMarkerSof0 || marker == kMarkerSof1)
+                    {
+                        result = ReadFrame();
+                        if (result == ImageDecodeResult::kOk && info != nullptr)
+                        {
+                            info->format        = ImageFormat::kJpeg;
+                            info->source_width  = width_;
+                            info->source_height = height_;
+                        }
+                    }
+                    else if (IsUnsupportedFrame(marker))
+                    {
+                        return ImageDecodeResult::kUnsupported;
+                    }
+                    else if (marker == kMarkerDht)
+                    {
+                        result = ReadHuffmanTables();
+                    }
+                    else if (marker == kMarkerDqt)
+                    {
+                        result = ReadQuantTables();
+                    }
+                    else if (marker == kMarkerDri)
+                    {
+                        result = ReadRestartInterval();
+                    }
+                    else if (marker == kMarkerSos)
+                    {
+                        result = ReadScanHeader();
+                        if (result != ImageDecodeResult::kOk)
+                        {
+                            return result;
+                        }
+                        result = DecodeScan(out);
+                        if (info != nullptr)
+                        {
+                            info->block_scale = static_cast<std::uint8_t>(8 / block_size_);
+                        }
+                        return result;
+                    }
+                    else if (marker == kMarkerEoi)
+                    {
+                        return ImageDecodeResult::kCorrupt;  // no scan
+                    }
+                    else if (marker != kMarkerSoi)
+                    {
+                        result = SkipSegment();
+                    }
+                    if (result != ImageDecodeResult::kOk)
+                    {
+                        return result;
+                    }
+                }
+            }
+
+        private:
+            /* ---- Headers ---- */
+
+            int NextMarker()
+            {
+                int byte = in_.Next();
+                while (byte >= 0 && byte != 0xFF)
+                {
+                    byte = in_.Next();  // garbage between segments
+                }
+                while (byte == 0xFF)
+                {
+                    byte = in_.Next();
+                }
+                return byte;
+            }
+
+            bool ReadLength(int& length)
+            {
+                const int high = in_.Next();
+                const int low  = in_.Next();
+                if (low < 0)
+                {
+                    return false;
+                }
+                length = ((high << 8) | low) - 2;
+                return length >= 0;
+            }
+
+            ImageDecodeResult SkipSegment()
+            {
+                int length = 0;
+                if (!ReadLength(length))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                return in_.Skip(static_cast<std::size_t>(length)) ? ImageDecodeResult::kOk
+                                                                  : ImageDecodeResult::kTruncated;
+            }
+
+            ImageDecodeResult ReadQuantTables()
+            {
+                int length = 0;
+                if (!ReadLength(length))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                while (length > 0)
+                {
+                    const int spec = in_.Next();
+                    if (spec < 0)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    const bool wide  = (spec >> 4) != 0;
+                    const int  table = spec & 0x0F;
+                    if (table > 3 || (spec >> 4) > 1)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    for (int k = 0; k < 64; ++k)
+                    {
+                        int value = in_.Next();
+                        if (wide)
+                        {
+                            value = (value << 8) | in_.Next();
+                        }
+                        if (value < 0)
+                        {
+                            return ImageDecodeResult::kTruncated;
+                        }
+                        quant_[table][k] = static_cast<std::uint16_t>(value);
+                    }
+                    length -= 1 + (wide ? 128 : 64);
+                }
+                return length == 0 ? ImageDecodeResult::kOk : ImageDecodeResult::kCorrupt;
+            }
+
+            ImageDecodeResult ReadHuffmanTables()
+            {
+                int length = 0;
+                if (!ReadLength(length))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                while (length > 0)
+                {
+                    std::uint8_t spec_and_counts[17];
+                    std::uint8_t values[256];
+                    if (!in_.Read(spec_and_counts, sizeof(spec_and_counts)))
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    const int spec  = spec_and_counts[0];
+                    int       total = 0;
+                    for (int i = 1; i <= 16; ++i)
+                    {
+                        total += spec_and_counts[i];
+                    }
+                    if ((spec >> 4) > 1 || (spec & 0x0F) > 3 || total > 256)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    if (!in_.Read(values, static_cast<std::size_t>(total)))
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    HuffmanTable& table = (spec >> 4) == 0 ? dc_[spec & 0x0F] : ac_[spec & 0x0F];
+                    if (!BuildHuffman(table, spec_and_counts + 1, values, total))
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    length -= 17 + total;
+                }
+                return length == 0 ? ImageDecodeResult::kOk : ImageDecodeResult::kCorrupt;
+            }
+
+            ImageDecodeResult ReadRestartInterval()
+            {
+                int length = 0;
+                if (!ReadLength(length) || length != 2)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                const int high = in_.Next();
+                const int low  = in_.Next();
+                if (low < 0)
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                restart_interval_ = (high << 8) | low;
+                return ImageDecodeResult::kOk;
+            }
+
+            ImageDecodeResult ReadFrame()
+            {
+                int          length = 0;
+                std::uint8_t header[6];
+                if (!ReadLength(length) || !in_.Read(header, sizeof(header)))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                height_     = static_cast<std::uint32_t>((header[1] << 8) | header[2]);
+                width_      = static_cast<std::uint32_t>((header[3] << 8) | header[4]);
+                components_ = header[5];
+                if (header[0] != 8 || height_ == 0U || (components_ != 1 && components_ != 3))
+                {
+                    // 12-bit samples, a DNL-defined height, CMYK
+                    return ImageDecodeResult::kUnsupported;
+                }
+                if (width_ == 0U || length != 6 + 3 * components_)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                if (!BoxRowScaler::SourceFits(width_, height_, options_))
+                {
+                    return ImageDecodeResult::kTooLarge;
+                }
+
+                int blocks = 0;
+                for (int c = 0; c < components_; ++c)
+                {
+                    std::uint8_t spec[3];
+                    if (!in_.Read(spec, sizeof(spec)))
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    Component& component = component_[c];
+                    component.id         = spec[0];
+                    component.h          = spec[1] >> 4;
+                    component.v          = spec[1] & 0x0F;
+                    component.quant      = spec[2];
+                    if (component.h < 1 || component.h > kMaxSampling || component.v < 1
+                        || component.v > kMaxSampling || component.quant > 3)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    if (components_ == 1)
+                    {
+                        component.h = component.v = 1;  // a lone component's MCU is one block
+                    }
+                    blocks += component.h * component.v;
+                    h_max_ = std::max(h_max_, component.h);
+                    v_max_ = std::max(v_max_, component.v);
+                }
+                if (blocks > kMaxMcuBlocks)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                have_frame_ = true;
+                return ImageDecodeResult::kOk;
+            }
+
+            ImageDecodeResult ReadScanHeader()
+            {
+                int length = 0;
+                if (!ReadLength(length))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                const int count = in_.Next();
+                if (!have_frame_ || count < 0 || length != 4 + 2 * count)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                if (count != components_)
+                {
+                    return ImageDecodeResult::kUnsupported;  // non-interleaved scans
+                }
+                for (int i = 0; i < count; ++i)
+                {
+                    const int id     = in_.Next();
+                    const int tables = in_.Next();
+                    if (tables < 0)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    Component* component = nullptr;
+                    for (int c = 0; c < components_; ++c)
+                    {
+                        component = component_[c].id == id ? &component_[c] : component;
+                    }
+                    if (component == nullptr || !dc_[tables >> 4 & 3].defined
+                        || !ac_[tables & 3].defined)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    component->dc_table = tables >> 4 & 3;
+                    component->ac_table = tables & 3;
+                }
+                // Spectral selection and successive approximation; fixed for baseline
+                return in_.Skip(3U) ? ImageDecodeResult::kOk : ImageDecodeResult::kTruncated;
+            }
+
+            /* ---- Entropy-coded data ---- */
+
+            void Fill()
+            {
+                while (bit_count_ <= 24)
+                {
+                    int byte = 0;
+                    if (marker_ == 0)
+                    {
+                        byte = in_.Next();
+                        if (byte < 0)
+                        {
+                            ran_out_ = true;
+                            marker_  = kMarkerEoi;
+                            byte     = 0;
+                        }
+                        else if (byte == 0xFF)
+                        {
+                            int next = in_.Next();
+                            while (next == 0xFF)
+                            {
+                                next = in_.Next();
+                            }
+                            if (next != 0)
+                            {
+                                // A marker ends the segment; zeros pad whatever is decoded
+                                ran_out_ = ran_out_ || next < 0;
+                                marker_  = next < 0 ? kMarkerEoi : next;
+                                byte     = 0;
+                            }
+                        }
+                    }
+                    bits_ |= static_cast<std::uint32_t>(byte) << (24 - bit_count_);
+                    bit_count_ += 8;
+                }
+            }
+
+            int GetBits(int count)
+            {
+                if (bit_count_ < count)
+                {
+                    Fill();
+                }
+                const int value = static_cast<int>(bits_ >> (32 - count));
+                bits_ <<= count;
+                bit_count_ -= count;
+                return value;
+            }
+
+            /** Value of a @p size-bit magnitude category (JPEG's EXTEND). */
+            int Receive(int size)
+            {
+                const int value = GetBits(size);
+                return value < (1 << (size - 1)) ? value - (1 << size) + 1 : value;
+            }
+
+            int DecodeSymbol(const HuffmanTable& table)
+            {
+                if (bit_count_ < 16)
+                {
+                    Fill();
+                }
+                const std::uint16_t fast = table.fast[bits_ >> (32 - kFastBits)];
+                if (fast != 0U)
+                {
+                    bits_ <<= fast >> 8;
+                    bit_count_ -= fast >> 8;
+                    return fast & 0xFF;
+                }
+                for (int length = kFastBits + 1; length <= 16; ++length)
+                {
+                    const auto code = static_cast<std::int32_t>(bits_ >> (32 - length));
+                    if (code <= table.max_code[length])
+                    {
+                        bits_ <<= length;
+                        bit_count_ -= length;
+                        return table.values[(table.value_offset[length] + code) & 0xFF];
+                    }
+                }
+                return -1;
+            }
+
+            /**
+             * Decode one block into coef_ (natural order, dequantised). With a 1x1 block only
+             * the DC coefficient is kept; the AC codes are still read to stay in step.
+             */
+            bool DecodeBlock(Component& component)
+            {
+                const std::uint16_t* quant = quant_[component.quant];
+                const int            size  = DecodeSymbol(dc_[component.dc_table]);
+                if (size < 0 || size > 11)
+                {
+                    return false;
+                }
+                const int diff    = size > 0 ? Receive(size) : 0;
+                component.dc_pred = std::clamp(component.dc_pred + diff, -kDcLimit, kDcLimit);
+                coef_[0]  = std::clamp(component.dc_pred * quant[0], -kCoefLimit, kCoefLimit);
+                row_mask_ = 1U;
+                max_col_  = 0;
+
+                const HuffmanTable& ac   = ac_[component.ac_table];
+                const bool          keep = block_size_ > 1;
+                for (int k = 1; k < 64;)
+                {
+                    const int symbol = DecodeSymbol(ac);
+                    if (symbol < 0)
+                    {
+                        return false;
+                    }
+                    const int run      = symbol >> 4;
+                    const int category = symbol & 0x0F;
+                    if (category == 0)
+                    {
+                        if (run != 15)
+                        {
+                            break;  // end of block
+                        }
+                        k += 16;
+                        continue;
+                    }
+                    k += run;
+                    if (k > 63 || category > 11)
+                    {
+                        return false;
+                    }
+                    const int value = Receive(category);
+                    if (keep)
+                    {
+                        const int natural = kZigzag[k];
+                        coef_[natural] = std::clamp(value * quant[k], -kCoefLimit, kCoefLimit);
+                        row_mask_ |= 1U << (natural >> 3);
+                        max_col_ = std::max(max_col_, natural & 7);
+                    }
+                    k++;
+                }
+                return true;
+            }
+
+            /** Box-averaged inverse DCT: block_size_ x block_size_ samples of this block. */
+            void InverseDct(std::uint8_t* dst, std::size_t stride)
+            {
+                const int n = block_size_;
+                if (n == 1)
+                {
+                    // 8x reduction: the block's average is its DC coefficient over 8
+                    const int value = (coef_[0] + (coef_[0] >= 0 ? 4 : -4)) / 8 + 128;
+                    *dst            = static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+                    return;
+                }
+
+                std::int32_t rows[8 * 8];
+                for (int v = 0; v < 8; ++v)
+                {
+                    if ((row_mask_ & (1U << v)) == 0U)
+                    {
+                        continue;
+                    }
+                    const std::int32_t* in = &coef_[v * 8];
+                    for (int x = 0; x < n; ++x)
+                    {
+                        const std::int16_t* basis = &basis_[x * 8];
+                        std::int32_t        sum   = 0;
+                        for (int u = 0; u <= max_col_; ++u)
+                        {
+                            sum += basis[u] * in[u];
+                        }
+                        rows[v * 8 + x] = (sum + (1 << (kPass1Shift - 1))) >> kPass1Shift;
+                    }
+                }
+
+                constexpr int kPass2Shift = 2 * kTableBits - kPass1Shift;
+                for (int y = 0; y < n; ++y)
+                {
+                    const std::int16_t* basis = &basis_[y * 8];
+                    std::uint8_t*       out   = dst + static_cast<std::size_t>(y) * stride;
+                    for (int x = 0; x < n; ++x)
+                    {
+                        std::int32_t sum = 0;
+                        for (int v = 0; v < 8; ++v)
+                        {
+                            if ((row_mask_ & (1U << v)) != 0U)
+                            {
+                                sum += basis[v] * rows[v * 8 + x];
+                            }
+                        }
+                        const int value = ((sum + (1 << (kPass2Shift - 1))) >> kPass2Shift) + 128;
+                        out[x]          = static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+                    }
+                }
+            }
+
+            /**
+             * basis_[k][u]: frequency u's contribution to the average of output sample k, where
+             * each output sample covers 8 / n source samples. The average of cos((2x+1)u pi/16)
+             * over s consecutive x is a Dirichlet factor times the cosine at their centre.
+             */
+            void BuildBasis()
+            {
+                const double pi    = std::acos(-1.0);
+                const int    n     = block_size_;
+                const int    scale = 8 / n;
+                for (int k = 0; k < n; ++k)
+                {
+                    for (int u = 0; u < 8; ++u)
+                    {
+                        double factor = u == 0 ? std::sqrt(0.5) / 2.0 : 0.5;
+                        if (u > 0 && scale > 1)
+                        {
+                            factor *= std::sin(scale * u * pi / 16.0)
+                                      / (scale * std::sin(u * pi / 16.0));
+                        }
+                        const double value =
+                            factor * std::cos((2 * k + 1) * scale * u * pi / 16.0);
+                        basis_[k * 8 + u] =
+                            static_cast<std::int16_t>(std::lround(value * (1 << kTableBits)));
+                    }
+                }
+            }
+
+            /** Find the RSTn the encoder put after every restart_interval_ MCUs. */
+            bool Restart()
+            {
+                bits_      = 0U;
+                bit_count_ = 0;
+                int marker = marker_;
+                if (marker == 0)
+                {
+                    marker = NextMarker();
+                }
+                marker_ = 0;
+                if (marker < kMarkerRst0 || marker > kMarkerRst7)
+                {
+                    return false;
+                }
+                for (int c = 0; c < components_; ++c)
+                {
+                    component_[c].dc_pred = 0;
+                }
+                return true;
+            }
+
+            /** The samples of @p component under MCU row @p y, upsampled by repetition. */
+            const std::uint8_t* Row(const Component& component, int y) const
+            {
+                return component.plane
+                       + static_cast<std::size_t>(y * component.v / v_max_) * plane_stride_;
+            }
+
+            void ToRgb(std::uint8_t* dst, std::size_t stride, int mcu_width, int mcu_height)
+            {
+                const Component& y_comp = component_[0];
+                for (int y = 0; y < mcu_height; ++y)
+                {
+                    std::uint8_t*       out = dst + static_cast<std::size_t>(y) * stride;
+                    const std::uint8_t* luma = Row(y_comp, y);
+                    if (components_ == 1)
+                    {
+                        for (int x = 0; x < mcu_width; ++x, out += 3)
+                        {
+                            out[0] = out[1] = out[2] = luma[x];
+                        }
+                        continue;
+                    }
+                    const Component&    cb_comp = component_[1];
+                    const Component&    cr_comp = component_[2];
+                    const std::uint8_t* cb      = Row(cb_comp, y);
+                    const std::uint8_t* cr      = Row(cr_comp, y);
+                    for (int x = 0; x < mcu_width; ++x, out += 3)
+                    {
+                        // JFIF full-range BT.601, 16-bit fixed point
+                        const int l = luma[x * y_comp.h / h_max_];
+                        const int b = cb[x * cb_comp.h / h_max_] - 128;
+                        const int r = cr[x * cr_comp.h / h_max_] - 128;
+                        out[0]      = static_cast<std::uint8_t>(
+                            std::clamp(l + ((91881 * r + 32768) >> 16), 0, 255));
+                        out[1] = static_cast<std::uint8_t>(
+                            std::clamp(l - ((22554 * b + 46802 * r + 32768) >> 16), 0, 255));
+                        out[2] = static_cast<std::uint8_t>(
+                            std::clamp(l + ((116130 * b + 32768) >> 16), 0, 255));
+                    }
+                }
+            }
+
+            ImageDecodeResult DecodeScan(ScaledImage& out)
+            {
+                // The largest DCT reduction that still leaves the box filter something to do
+                std::uint32_t crop_width  = 0U;
+                std::uint32_t crop_height = 0U;
+                std::uint32_t out_width   = 0U;
+                std::uint32_t out_height  = 0U;
+                BoxRowScaler::Plan(
+                    width_, height_, options_, crop_width, crop_height, out_width, out_height);
+                int scale = 8;
+                while (scale > 1
+                       && (crop_width / scale < out_width || crop_height / scale < out_height))
+                {
+                    scale /= 2;
+                }
+                block_size_ = 8 / scale;
+                BuildBasis();
+
+                const std::uint32_t scaled_width  = (width_ + scale - 1) / scale;
+                const std::uint32_t scaled_height = (height_ + scale - 1) / scale;
+                BoxRowScaler        scaler;
+                if (!scaler.Begin(scaled_width, scaled_height, options_, out))
+                {
+                    return ImageDecodeResult::kTooLarge;
+                }
+
+                const int           mcu_width  = h_max_ * block_size_;
+                const int           mcu_height = v_max_ * block_size_;
+                const std::uint32_t mcus_x     = (width_ + h_max_ * 8U - 1U) / (h_max_ * 8U);
+                const std::uint32_t mcus_y     = (height_ + v_max_ * 8U - 1U) / (v_max_ * 8U);
+                plane_stride_                  = static_cast<std::size_t>(mcu_width);
+
+                // One MCU of samples per component, and one MCU row of RGB
+                const std::size_t strip_stride = static_cast<std::size_t>(mcus_x) * mcu_width * 3U;
+                std::vector<std::uint8_t> planes(plane_stride_ * mcu_height * components_);
+                std::vector<std::uint8_t> strip(strip_stride * mcu_height);
+                for (int c = 0; c < components_; ++c)
+                {
+                    component_[c].plane = planes.data() + plane_stride_ * mcu_height * c;
+                }
+
+                int until_restart = restart_interval_;
+                for (std::uint32_t mcu_y = 0U; mcu_y < mcus_y && !scaler.Done(); ++mcu_y)
+                {
+                    for (std::uint32_t mcu_x = 0U; mcu_x < mcus_x; ++mcu_x)
+                    {
+                        if (restart_interval_ > 0)
+                        {
+                            if (until_restart == 0)
+                            {
+                                if (!Restart())
+                                {
+                                    return ImageDecodeResult::kCorrupt;
+                                }
+                                until_restart = restart_interval_;
+                            }
+                            until_restart--;
+                        }
+                        for (int c = 0; c < components_; ++c)
+                        {
+                            Component& component = component_[c];
+                            for (int by = 0; by < component.v; ++by)
+                            {
+                                for (int bx = 0; bx < component.h; ++bx)
+                                {
+                                    if (block_size_ > 1)
+                                    {
+                                        std::memset(coef_, 0, sizeof(coef_));
+                                    }
+                                    if (!DecodeBlock(component))
+                                    {
+                                        return ImageDecodeResult::kCorrupt;
+                                    }
+                                    InverseDct(component.plane
+                                                   + static_cast<std::size_t>(by * block_size_)
+                                                         * plane_stride_
+                                                   + bx * block_size_,
+                                               plane_stride_);
+                                }
+                            }
+                        }
+                        ToRgb(strip.data() + static_cast<std::size_t>(mcu_x) * mcu_width * 3U,
+                              strip_stride,
+                              mcu_width,
+                              mcu_height);
+                    }
+
+                    const std::uint32_t top = mcu_y * static_cast<std::uint32_t>(mcu_height);
+                    const std::uint32_t rows =
+                        std::min<std::uint32_t>(mcu_height, scaled_height - top);
+                    for (std::uint32_t row = 0U; row < rows; ++row)
+                    {
+                        scaler.PushRow(strip.data() + row * strip_stride);
+                    }
+                    if (ran_out_)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                }
+                return ImageDecodeResult::kOk;
+            }
+
+            ImageStream&             in_;
+            const ImageScaleOptions& options_;
+
+            std::uint16_t quant_[4][64] = {};  // zigzag order, as stored
+            HuffmanTable  dc_[4];
+            HuffmanTable  ac_[4];
+            Component     component_[3];
+            int           components_       = 0;
+            int           h_max_            = 1;
+            int           v_max_            = 1;
+            bool          have_frame_       = false;
+            int           restart_interval_ = 0;
+            std::uint32_t width_            = 0U;
+            std::uint32_t height_           = 0U;
+
+            std::uint32_t bits_      = 0U;  // MSB first
+            int           bit_count_ = 0;
+            int           marker_    = 0;  // the marker that ended the entropy-coded data
+            bool          ran_out_   = false;
+
+            int           block_size_ = 8;  // output samples per block side: 8, 4, 2 or 1
+            std::int16_t  basis_[8 * 8] = {};
+            std::int32_t  coef_[64]     = {};
+            std::uint32_t row_mask_     = 0U;  // coefficient rows holding anything
+            int           max_col_      = 0;
+            std::size_t   plane_stride_ = 0U;
+        };
+
+    }  // namespace
+
+    ImageDecodeResult DecodeJpegScaled(ImageStream&             in,
+                                       const ImageScaleOptions& options,
+                                       ScaledImage&             out,
+                                       ImageDecodeInfo*         info)
+    {
+        auto decoder = std::make_unique<JpegDecoder>(in, options);
+        return decoder->Run(out, info);
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,788 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/image/image_decoder.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+        constexpr std::uint32_t kWindowBytes = 32768U;  // the largest deflate distance
+        constexpr std::uint32_t kWindowMask  = kWindowBytes - 1U;
+        constexpr int           kFastBits    = 9;
+        constexpr int           kMaxCodeBits = 15;
+
+        constexpr int kColorGray      = 0;
+        constexpr int kColorRgb       = 2;
+        constexpr int kColorPalette   = 3;
+        constexpr int kColorGrayAlpha = 4;
+        constexpr int kColorRgba      = 6;
+
+        constexpr std::uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                                   15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                                   67, 83, 99, 115, 131, 163, 195, 227, 258};
+        constexpr std::uint8_t  kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        constexpr std::uint16_t kDistBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,
+                                                 17,   25,   33,   49,   65,   97,    129,   193,
+                                                 257,  385,  513,  769,  1025, 1537,  2049,  3073,
+                                                 4097, 6145, 8193, 12289, 16385, 24577};
+        constexpr std::uint8_t  kDistExtra[30] = {0, 0, 0,  0,  1,  1,  2,  2,  3,  3,
+                                                  4, 4, 5,  5,  6,  6,  7,  7,  8,  8,
+                                                  9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        // Order of the code length code lengths in a dynamic block header
+        constexpr std::uint8_t kCodeLengthOrder[19] = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        std::uint32_t Be32(const std::uint8_t* p)
+        {
+            return (static_cast<std::uint32_t>(p[0]) << 24)
+                   | (static_cast<std::uint32_t>(p[1]) << 16)
+                   | (static_cast<std::uint32_t>(p[2]) << 8) | p[3];
+        }
+
+        std::uint8_t Blend(int color, int alpha, int background)
+        {
+            return static_cast<std::uint8_t>(
+                (color * alpha + background * (255 - alpha) + 127) / 255);
+        }
+
+        /** Canonical Huffman code, looked up 9 bits at a time with a bitwise walk behind it. */
+        struct InflateTable
+        {
+            std::uint16_t fast[1 << kFastBits];  // (symbol << 4) | length; 0 for longer codes
+            std::uint16_t counts[kMaxCodeBits + 1];
+            std::uint16_t symbols[288];
+
+            bool Build(const std::uint8_t* lengths, int count)
+            {
+                std::memset(counts, 0, sizeof(counts));
+                std::memset(fast, 0, sizeof(fast));
+                for (int i = 0; i < count; ++i)
+                {
+                    counts[lengths[i]]++;
+                }
+                counts[0] = 0;
+                int left  = 1;
+                for (int length = 1; length <= kMaxCodeBits; ++length)
+                {
+                    left = (left << 1) - counts[length];
+                    if (left < 0)
+                    {
+                        return false;  // over-subscribed; incomplete codes are allowed
+                    }
+                }
+
+                std::uint16_t offsets[kMaxCodeBits + 2]   = {};
+                std::uint16_t next_code[kMaxCodeBits + 1] = {};
+                std::uint32_t code                        = 0U;
+                for (int length = 1; length <= kMaxCodeBits; ++length)
+                {
+                    offsets[length + 1] =
+                        static_cast<std::uint16_t>(offsets[length] + counts[length]);
+                    code              = (code + counts[length - 1]) << 1;
+                    next_code[length] = static_cast<std::uint16_t>(code);
+                }
+                for (int symbol = 0; symbol < count; ++symbol)
+                {
+                    const int length = lengths[symbol];
+                    if (length == 0)
+                    {
+                        continue;
+                    }
+                    symbols[offsets[length]++] = static_cast<std::uint16_t>(symbol);
+                    const std::uint32_t value  = next_code[length]++;
+                    if (length > kFastBits)
+                    {
+                        continue;
+                    }
+                    // Deflate sends codes from their top bit down; the bit buffer is LSB first
+                    std::uint32_t reversed = 0U;
+                    for (int bit = 0; bit < length; ++bit)
+                    {
+                        reversed |= ((value >> bit) & 1U) << (length - 1 - bit);
+                    }
+                    for (std::uint32_t i = reversed; i < (1U << kFastBits); i += 1U << length)
+                    {
+                        fast[i] = static_cast<std::uint16_t>((symbol << 4) | length);
+                    }
+                }
+                return true;
+            }
+        };
+
+        class PngDecoder
+        {
+        public:
+            PngDecoder(ImageStream& in, const ImageScaleOptions& options) :
+                in_(in), options_(options)
+            {
+            }
+
+            ImageDecodeResult Run(ScaledImage& out, ImageDecodeInfo* info)
+            {
+                std::uint8_t signature[sizeof(kSignature)];
+                if (!in_.Read(signature, sizeof(signature))
+                    || std::memcmp(signature, kSignature, sizeof(kSignature)) != 0)
+                {
+                    return ImageDecodeResult::kUnknownFormat;
+                }
+
+                for (;;)
+                {
+                    std::uint32_t length = 0U;
+                    std::uint8_t  type[4];
+                    if (!ReadChunkHeader(length, type))
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    ImageDecodeResult result = ImageDecodeResult::kOk;
+                    if (std::memcmp(type, "IHDR", 4) == 0)
+                    {
+                        result = ReadHeader(length);
+                        if (result == ImageDecodeResult::kOk && info != nullptr)
+                        {
+                            info->format        = ImageFormat::kPng;
+                            info->source_width  = width_;
+                            info->source_height = height_;
+                        }
+                    }
+                    else if (std::memcmp(type, "PLTE", 4) == 0)
+                    {
+                        result = ReadPalette(length);
+                    }
+                    else if (std::memcmp(type, "tRNS", 4) == 0 && color_type_ == kColorPalette)
+                    {
+                        result = ReadPaletteAlpha(length);
+                    }
+                    else if (std::memcmp(type, "IDAT", 4) == 0)
+                    {
+                        if (width_ == 0U || (color_type_ == kColorPalette && palette_size_ == 0U))
+                        {
+                            return ImageDecodeResult::kCorrupt;
+                        }
+                        idat_left_ = length;
+                        return Inflate(out);
+                    }
+                    else if (std::memcmp(type, "IEND", 4) == 0)
+                    {
+                        return ImageDecodeResult::kCorrupt;  // no image data
+                    }
+                    else
+                    {
+                        result = in_.Skip(length) ? ImageDecodeResult::kOk
+                                                  : ImageDecodeResult::kTruncated;
+                    }
+                    if (result != ImageDecodeResult::kOk)
+                    {
+                        return result;
+                    }
+                    if (!in_.Skip(4U))  // CRC; a transfer that corrupts bytes is not our problem
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                }
+            }
+
+        private:
+            /* ---- Chunks ---- */
+
+            bool ReadChunkHeader(std::uint32_t& length, std::uint8_t* type)
+            {
+                std::uint8_t header[8];
+                if (!in_.Read(header, sizeof(header)))
+                {
+                    return false;
+                }
+                length = Be32(header);
+                std::memcpy(type, header + 4, 4);
+                return true;
+            }
+
+            ImageDecodeResult ReadHeader(std::uint32_t length)
+            {
+                std::uint8_t header[13];
+                if (length != sizeof(header))
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                if (!in_.Read(header, sizeof(header)))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                width_      = Be32(header);
+                height_     = Be32(header + 4);
+                depth_      = header[8];
+                color_type_ = header[9];
+                switch (color_type_)
+                {
+                    case kColorGray:
+                        channels_ = 1;
+                        break;
+                    case kColorRgb:
+                        channels_ = 3;
+                        break;
+                    case kColorPalette:
+                        channels_ = 1;
+                        break;
+                    case kColorGrayAlpha:
+                        channels_ = 2;
+                        break;
+                    case kColorRgba:
+                        channels_ = 4;
+                        break;
+                    default:
+                        return ImageDecodeResult::kCorrupt;
+                }
+                const bool low_depth = depth_ == 1 || depth_ == 2 || depth_ == 4;
+                const bool depth_ok =
+                    depth_ == 8 || (depth_ == 16 && color_type_ != kColorPalette)
+                    || (low_depth && (color_type_ == kColorGray || color_type_ == kColorPalette));
+                if (width_ == 0U || height_ == 0U || !depth_ok || header[10] != 0
+                    || header[11] != 0)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                if (header[12] != 0)
+                {
+                    return ImageDecodeResult::kUnsupported;  // Adam7 needs the whole image
+                }
+                if (!BoxRowScaler::SourceFits(width_, height_, options_))
+                {
+                    return ImageDecodeResult::kTooLarge;
+                }
+                return ImageDecodeResult::kOk;
+            }
+
+            ImageDecodeResult ReadPalette(std::uint32_t length)
+            {
+                if (length % 3U != 0U || length > sizeof(palette_))
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                std::uint8_t entries[sizeof(palette_)];
+                if (!in_.Read(entries, length))
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                palette_size_ = length / 3U;
+                std::memcpy(palette_, entries, length);
+                for (std::uint32_t i = 0U; i < 256U; ++i)
+                {
+                    palette_alpha_[i] = 255U;
+                }
+                return ImageDecodeResult::kOk;
+            }
+
+            ImageDecodeResult ReadPaletteAlpha(std::uint32_t length)
+            {
+                if (length > 256U)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+                return in_.Read(palette_alpha_, length) ? ImageDecodeResult::kOk
+                                                        : ImageDecodeResult::kTruncated;
+            }
+
+            /** The zlib stream, which may run across any number of IDAT chunks. */
+            int NextIdatByte()
+            {
+                while (idat_left_ == 0U)
+                {
+                    std::uint32_t length = 0U;
+                    std::uint8_t  type[4];
+                    if (!in_.Skip(4U) || !ReadChunkHeader(length, type)
+                        || std::memcmp(type, "IDAT", 4) != 0)
+                    {
+                        return -1;
+                    }
+                    idat_left_ = length;
+                }
+                idat_left_--;
+                return in_.Next();
+            }
+
+            /* ---- Inflate ---- */
+
+            void Need(int count)
+            {
+                while (bit_count_ < count)
+                {
+                    const int byte = NextIdatByte();
+                    if (byte < 0)
+                    {
+                        ran_out_ = true;
+                    }
+                    bits_ |= static_cast<std::uint32_t>(byte < 0 ? 0 : byte) << bit_count_;
+                    bit_count_ += 8;
+                }
+            }
+
+            std::uint32_t Bits(int count)
+            {
+                Need(count);
+                const std::uint32_t value = bits_ & ((1U << count) - 1U);
+                bits_ >>= count;
+                bit_count_ -= count;
+                return value;
+            }
+
+            int Decode(const InflateTable& table)
+            {
+                Need(kMaxCodeBits);
+                const std::uint16_t fast = table.fast[bits_ & ((1U << kFastBits) - 1U)];
+                if (fast != 0U)
+                {
+                    bits_ >>= fast & 15U;
+                    bit_count_ -= fast & 15U;
+                    return fast >> 4;
+                }
+                int code  = 0;
+                int first = 0;
+                int index = 0;
+                for (int length = 1; length <= kMaxCodeBits; ++length)
+                {
+                    code |= static_cast<int>((bits_ >> (length - 1)) & 1U);
+                    const int count = table.counts[length];
+                    if (code - count < first)
+                    {
+                        bits_ >>= length;
+                        bit_count_ -= length;
+                        return table.symbols[index + (code - first)];
+                    }
+                    index += count;
+                    first = (first + count) << 1;
+                    code <<= 1;
+                }
+                return -1;
+            }
+
+            bool ReadDynamicTables()
+            {
+                const int literals  = static_cast<int>(Bits(5)) + 257;
+                const int distances = static_cast<int>(Bits(5)) + 1;
+                const int codes     = static_cast<int>(Bits(4)) + 4;
+                if (literals > 286 || distances > 30)
+                {
+                    return false;
+                }
+
+                std::uint8_t lengths[286 + 30] = {};
+                for (int i = 0; i < codes; ++i)
+                {
+                    lengths[kCodeLengthOrder[i]] = static_cast<std::uint8_t>(Bits(3));
+                }
+                if (!length_codes_.Build(lengths, 19))
+                {
+                    return false;
+                }
+
+                std::memset(lengths, 0, sizeof(lengths));
+                for (int i = 0; i < literals + distances;)
+                {
+                    const int symbol = Decode(length_codes_);
+                    if (symbol < 0)
+                    {
+                        return false;
+                    }
+                    if (symbol < 16)
+                    {
+                        lengths[i++] = static_cast<std::uint8_t>(symbol);
+                        continue;
+                    }
+                    std::uint8_t value  = 0U;
+                    int          repeat = 0;
+                    if (symbol == 16)
+                    {
+                        if (i == 0)
+                        {
+                            return false;
+                        }
+                        value  = lengths[i - 1];
+                        repeat = 3 + static_cast<int>(Bits(2));
+                    }
+                    else
+                    {
+                        repeat = symbol == 17 ? 3 + static_cast<int>(Bits(3))
+                                              : 11 + static_cast<int>(Bits(7));
+                    }
+                    if (i + repeat > literals + distances)
+                    {
+                        return false;
+                    }
+                    while (repeat-- > 0)
+                    {
+                        lengths[i++] = value;
+                    }
+                }
+                if (lengths[256] == 0)
+                {
+                    return false;  // no end-of-block code
+                }
+                return literal_codes_.Build(lengths, literals)
+                       && distance_codes_.Build(lengths + literals, distances);
+            }
+
+            void BuildFixedTables()
+            {
+                std::uint8_t lengths[288];
+                std::memset(lengths, 8, 144);
+                std::memset(lengths + 144, 9, 112);
+                std::memset(lengths + 256, 7, 24);
+                std::memset(lengths + 280, 8, 8);
+                literal_codes_.Build(lengths, 288);
+                std::memset(lengths, 5, 30);
+                distance_codes_.Build(lengths, 30);
+            }
+
+            void Emit(std::uint8_t byte)
+            {
+                window_[window_pos_++ & kWindowMask] = byte;
+                row_[row_fill_++]                   = byte;
+                if (row_fill_ == row_.size())
+                {
+                    FinishRow();
+                }
+            }
+
+            /** Huffman-coded data up to the end of the block, or until the image is done. */
+            ImageDecodeResult InflateBlock()
+            {
+                for (;;)
+                {
+                    if (finished_)
+                    {
+                        return ImageDecodeResult::kOk;
+                    }
+                    if (ran_out_)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                    if (bad_filter_)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    const int symbol = Decode(literal_codes_);
+                    if (symbol < 256)
+                    {
+                        if (symbol < 0)
+                        {
+                            return ImageDecodeResult::kCorrupt;
+                        }
+                        Emit(static_cast<std::uint8_t>(symbol));
+                        continue;
+                    }
+                    if (symbol == 256)
+                    {
+                        return ImageDecodeResult::kOk;
+                    }
+                    const int length_code = symbol - 257;
+                    if (length_code >= 29)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    const std::uint32_t length =
+                        kLengthBase[length_code] + Bits(kLengthExtra[length_code]);
+                    const int distance_code = Decode(distance_codes_);
+                    if (distance_code < 0 || distance_code >= 30)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    const std::uint32_t distance =
+                        kDistBase[distance_code] + Bits(kDistExtra[distance_code]);
+                    if (distance > window_pos_)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    for (std::uint32_t i = 0U; i < length && !finished_; ++i)
+                    {
+                        Emit(window_[(window_pos_ - distance) & kWindowMask]);
+                    }
+                }
+            }
+
+            ImageDecodeResult Inflate(ScaledImage& out)
+            {
+                const std::uint32_t bits_per_pixel = static_cast<std::uint32_t>(channels_) * depth_;
+                const std::size_t   stride =
+                    (static_cast<std::size_t>(width_) * bits_per_pixel + 7U) / 8U;
+                filter_step_ = bits_per_pixel >= 8U ? bits_per_pixel / 8U : 1U;
+                if (!scaler_.Begin(width_, height_, options_, out))
+                {
+                    return ImageDecodeResult::kTooLarge;
+                }
+                window_.assign(kWindowBytes, 0U);
+                row_.assign(stride + 1U, 0U);  // filter type, then the scanline
+                previous_.assign(stride, 0U);
+                rgb_.assign(static_cast<std::size_t>(width_) * 3U, 0U);
+                PrepareBackground();
+
+                const int cmf = NextIdatByte();
+                const int flg = NextIdatByte();
+                if (flg < 0)
+                {
+                    return ImageDecodeResult::kTruncated;
+                }
+                if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20) != 0)
+                {
+                    return ImageDecodeResult::kCorrupt;
+                }
+
+                bool last = false;
+                while (!last && !finished_)
+                {
+                    last             = Bits(1) != 0U;
+                    const auto  type = Bits(2);
+                    ImageDecodeResult result = ImageDecodeResult::kOk;
+                    if (type == 0U)
+                    {
+                        // Stored: byte-aligned LEN, NLEN, then raw bytes
+                        Bits(bit_count_ % 8);
+                        const std::uint32_t length = Bits(16);
+                        if ((Bits(16) ^ 0xFFFFU) != length)
+                        {
+                            return ImageDecodeResult::kCorrupt;
+                        }
+                        for (std::uint32_t i = 0U; i < length && !finished_ && !ran_out_; ++i)
+                        {
+                            Emit(static_cast<std::uint8_t>(Bits(8)));
+                        }
+                    }
+                    else if (type == 1U)
+                    {
+                        BuildFixedTables();
+                        result = InflateBlock();
+                    }
+                    else if (type == 2U)
+                    {
+                        if (!ReadDynamicTables())
+                        {
+                            return ran_out_ ? ImageDecodeResult::kTruncated
+                                            : ImageDecodeResult::kCorrupt;
+                        }
+                        result = InflateBlock();
+                    }
+                    else
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    if (result != ImageDecodeResult::kOk)
+                    {
+                        return result;
+                    }
+                    if (bad_filter_)
+                    {
+                        return ImageDecodeResult::kCorrupt;
+                    }
+                    if (ran_out_ && !finished_)
+                    {
+                        return ImageDecodeResult::kTruncated;
+                    }
+                }
+                return finished_ ? ImageDecodeResult::kOk : ImageDecodeResult::kTruncated;
+            }
+
+            /* ---- Scanlines ---- */
+
+            void PrepareBackground()
+            {
+                background_[0] = static_cast<std::uint8_t>(options_.background >> 16);
+                background_[1] = static_cast<std::uint8_t>(options_.background >> 8);
+                background_[2] = static_cast<std::uint8_t>(options_.background);
+                if (color_type_ != kColorPalette)
+                {
+                    return;
+                }
+                // tRNS is applied to the palette once rather than to every pixel
+                for (std::uint32_t i = 0U; i < palette_size_; ++i)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        palette_[i * 3U + c] =
+                            Blend(palette_[i * 3U + c], palette_alpha_[i], background_[c]);
+                    }
+                }
+            }
+
+            static std::uint8_t Paeth(int left, int up, int up_left)
+            {
+                const int estimate = left + up - up_left;
+                const int to_left  = estimate > left ? estimate - left : left - estimate;
+                const int to_up    = estimate > up ? estimate - up : up - estimate;
+                const int to_diag  = estimate > up_left ? estimate - up_left : up_left - estimate;
+                if (to_left <= to_up && to_left <= to_diag)
+                {
+                    return static_cast<std::uint8_t>(left);
+                }
+                return static_cast<std::uint8_t>(to_up <= to_diag ? up : up_left);
+            }
+
+            void FinishRow()
+            {
+                std::uint8_t*       line   = row_.data() + 1;
+                const std::uint8_t* above  = previous_.data();
+                const std::size_t   length = previous_.size();
+                const std::size_t   step   = filter_step_;
+                switch (row_[0])
+                {
+                    case 0:
+                        break;
+                    case 1:
+                        for (std::size_t i = step; i < length; ++i)
+                        {
+                            line[i] = static_cast<std::uint8_t>(line[i] + line[i - step]);
+                        }
+                        break;
+                    case 2:
+                        for (std::size_t i = 0U; i < length; ++i)
+                        {
+                            line[i] = static_cast<std::uint8_t>(line[i] + above[i]);
+                        }
+                        break;
+                    case 3:
+                        for (std::size_t i = 0U; i < length; ++i)
+                        {
+                            const int left = i >= step ? line[i - step] : 0;
+                            line[i] = static_cast<std::uint8_t>(line[i] + ((left + above[i]) >> 1));
+                        }
+                        break;
+                    case 4:
+                        for (std::size_t i = 0U; i < length; ++i)
+                        {
+                            const int left    = i >= step ? line[i - step] : 0;
+                            const int up_left = i >= step ? above[i - step] : 0;
+                            line[i] = static_cast<std::uint8_t>(line[i]
+                                                                + Paeth(left, above[i], up_left));
+                        }
+                        break;
+                    default:
+                        bad_filter_ = true;
+                        finished_   = true;
+                        return;
+                }
+
+                ToRgb(line);
+                scaler_.PushRow(rgb_.data());
+                std::memcpy(previous_.data(), line, length);
+                row_fill_ = 0U;
+                finished_ = ++rows_done_ == height_ || scaler_.Done();
+            }
+
+            void ToRgb(const std::uint8_t* line)
+            {
+                std::uint8_t* out = rgb_.data();
+                const int     wide = depth_ == 16 ? 2 : 1;  // only the high byte of 16-bit samples
+                if (depth_ < 8)
+                {
+                    const int mask  = (1 << depth_) - 1;
+                    const int scale = 255 / mask;
+                    for (std::uint32_t x = 0U; x < width_; ++x, out += 3)
+                    {
+                        const std::uint32_t bit = x * depth_;
+                        const int value = (line[bit >> 3] >> (8 - depth_ - (bit & 7U))) & mask;
+                        if (color_type_ == kColorPalette)
+                        {
+                            std::memcpy(out, PaletteEntry(value), 3);
+                        }
+                        else
+                        {
+                            out[0] = out[1] = out[2] = static_cast<std::uint8_t>(value * scale);
+                        }
+                    }
+                    return;
+                }
+
+                const std::size_t pixel = static_cast<std::size_t>(channels_) * wide;
+                for (std::uint32_t x = 0U; x < width_; ++x, out += 3, line += pixel)
+                {
+                    switch (color_type_)
+                    {
+                        case kColorGray:
+                            out[0] = out[1] = out[2] = line[0];
+                            break;
+                        case kColorRgb:
+                            out[0] = line[0];
+                            out[1] = line[wide];
+                            out[2] = line[2 * wide];
+                            break;
+                        case kColorPalette:
+                            std::memcpy(out, PaletteEntry(line[0]), 3);
+                            break;
+                        case kColorGrayAlpha:
+                            out[0] = Blend(line[0], line[wide], background_[0]);
+                            out[1] = Blend(line[0], line[wide], background_[1]);
+                            out[2] = Blend(line[0], line[wide], background_[2]);
+                            break;
+                        default:
+                            out[0] = Blend(line[0], line[3 * wide], background_[0]);
+                            out[1] = Blend(line[wide], line[3 * wide], background_[1]);
+                            out[2] = Blend(line[2 * wide], line[3 * wide], background_[2]);
+                            break;
+                    }
+                }
+            }
+
+            /** Out-of-range indices show as the background rather than failing the image. */
+            const std::uint8_t* PaletteEntry(int index) const
+            {
+                return static_cast<std::uint32_t>(index) < palette_size_ ? &palette_[index * 3]
+                                                                         : background_;
+            }
+
+            ImageStream&             in_;
+            const ImageScaleOptions& options_;
+
+            std::uint32_t width_         = 0U;
+            std::uint32_t height_        = 0U;
+            int           depth_         = 0;
+            int           color_type_    = 0;
+            int           channels_      = 0;
+            std::uint8_t  palette_[256 * 3] = {};
+            std::uint8_t  palette_alpha_[256] = {};
+            std::uint32_t palette_size_  = 0U;
+            std::uint8_t  background_[3] = {};
+
+            std::uint32_t idat_left_ = 0U;
+            std::uint32_t bits_      = 0U;  // LSB first
+            int           bit_count_ = 0;
+            bool          ran_out_   = false;
+
+            InflateTable              literal_codes_;
+            InflateTable              distance_codes_;
+            InflateTable              length_codes_;
+            std::vector<std::uint8_t> window_;
+            std::uint32_t             window_pos_ = 0U;  // bytes inflated so far
+
+            BoxRowScaler              scaler_;
+            std::vector<std::uint8_t> row_;
+            std::vector<std::uint8_t> previous_;
+            std::vector<std::uint8_t> rgb_;
+            std::size_t               row_fill_    = 0U;
+            std::size_t               filter_step_ = 1U;
+            std::uint32_t             rows_done_   = 0U;
+            bool                      finished_    = false;
+            bool                      bad_filter_  = false;
+        };
+
+    }  // namespace
+
+    ImageDecodeResult DecodePngScaled(ImageStream&             in,
+                                      const ImageScaleOptions& options,
+                                      ScaledImage&             out,
+                                      ImageDecodeInfo*         info)
+    {
+        auto decoder = std::make_unique<PngDecoder>(in, options);
+        return decoder->Run(out, info);
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/input/hid_input_queue.h"
+
+#include <algorithm>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint8_t kUsageRollover = 0x01U;
+
+        bool ContainsKey(const std::uint8_t* keys, std::size_t count, std::uint8_t usage)
+        {
+            return std::find(keys, keys + count, usage) != keys + count;
+        }
+
+    }  // namespace
+
+    PointerEventQueue::PointerEventQueue(std::size_t capacity) : ring_(capacity)
+    {
+    }
+
+    bool PointerEventQueue::Push(const PointerReport& report)
+    {
+        if (ring_.Push(&report, 1U) == 0U)
+        {
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+        pushed_.fetch_add(1U, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool PointerEventQueue::Drain(PointerState& state, std::int32_t max_x, std::int32_t max_y)
+    {
+        std::int32_t  dx    = 0;
+        std::int32_t  dy    = 0;
+        std::uint32_t batch = 0U;
+        bool          edge  = false;
+
+        // Look at reports in place; at most two spans when the batch wraps the ring
+        for (auto span = ring_.ReadSpan(); span.size > 0U && !edge; span = ring_.ReadSpan())
+        {
+            std::size_t used = 0U;
+            while (used < span.size)
+            {
+                const PointerReport& report = span.data[used++];
+                dx += report.dx;
+                dy += report.dy;
+                if (report.buttons != state.buttons)
+                {
+                    state.buttons = report.buttons;
+                    edge          = true;
+                    break;
+                }
+            }
+            ring_.CommitRead(used);
+            batch += static_cast<std::uint32_t>(used);
+        }
+
+        state.x = std::clamp(state.x + dx, std::int32_t{0}, max_x);
+        state.y = std::clamp(state.y + dy, std::int32_t{0}, max_y);
+
+        drained_ += batch;
+        coalesced_ += batch > 1U ? batch - 1U : 0U;
+        max_batch_ = std::max(max_batch_, batch);
+        return !ring_.Empty();
+    }
+
+    void PointerEventQueue::Clear()
+    {
+        for (auto span = ring_.ReadSpan(); span.size > 0U; span = ring_.ReadSpan())
+        {
+            ring_.CommitRead(span.size);
+        }
+    }
+
+    PointerEventQueue::Stats PointerEventQueue::GetStats() const
+    {
+        Stats stats;
+        stats.pushed    = pushed_.load(std::memory_order_relaxed);
+        stats.dropped   = dropped_.load(std::memory_order_relaxed);
+        stats.drained   = drained_;
+        stats.coalesced = coalesced_;
+        stats.max_batch = max_batch_;
+        return stats;
+    }
+
+    std::size_t KeyboardReportDecoder::Decode(const std::uint8_t* report,
+                                              std::size_t         length,
+                                              KeyEvent*           out,
+                                              std::size_t         max)
+    {
+        if (report == nullptr || length < 2U + kBootKeys || report[2] == kUsageRollover)
+        {
+            return 0U;
+        }
+
+        const std::uint8_t  modifiers = report[0];
+        const std::uint8_t* keys      = report + 2;
+        std::size_t         count     = 0U;
+
+        for (std::size_t i = 0; i < kBootKeys && count < max; ++i)
+        {
+            if (keys_[i] != 0U && !ContainsKey(keys, kBootKeys, keys_[i]))
+            {
+                out[count++] = KeyEvent{keys_[i], modifiers, false};
+            }
+        }
+        for (std::size_t i = 0; i < kBootKeys && count < max; ++i)
+        {
+            if (keys[i] != 0U && !ContainsKey(keys_, kBootKeys, keys[i]))
+            {
+                out[count++] = KeyEvent{keys[i], modifiers, true};
+            }
+        }
+
+        std::copy(keys, keys + kBootKeys, keys_);
+        return count;
+    }
+
+    void KeyboardReportDecoder::Reset()
+    {
+        std::fill(keys_, keys_ + kBootKeys, std::uint8_t{0U});
+    }
+
+}  // namespace custom::platform
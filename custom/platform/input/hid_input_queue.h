@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform/spsc_ring.h"
+
+namespace custom::platform
+{
+
+    /** One USB mouse report: relative motion in screen axes plus the button bits after it. */
+    struct PointerReport
+    {
+        std::int16_t dx      = 0;
+        std::int16_t dy      = 0;
+        std::uint8_t buttons = 0U;  // bit 0 left, bit 1 right, bit 2 middle
+    };
+
+    /** Absolute cursor as seen by the UI; owned by the consumer. */
+    struct PointerState
+    {
+        std::int32_t x       = 0;
+        std::int32_t y       = 0;
+        std::uint8_t buttons = 0U;
+    };
+
+    /**
+     * @brief Mouse reports from the USB host task to the LVGL indev, without a lock.
+     *
+     * The HID task pushes every report; the indev read callback drains them in batches.
+     * Consecutive reports that only move the cursor are summed into one position, but a batch
+     * always ends right after a button change, so a press and release arriving within one
+     * LVGL read period still reach LVGL as two reads (see Drain()). A full queue drops the
+     * new report and counts it.
+     */
+    class PointerEventQueue
+    {
+    public:
+        struct Stats
+        {
+            std::uint32_t pushed    = 0U;
+            std::uint32_t dropped   = 0U;
+            std::uint32_t drained   = 0U;  // reports consumed
+            std::uint32_t coalesced = 0U;  // motion-only reports folded into a neighbour
+            std::uint32_t max_batch = 0U;
+        };
+
+        explicit PointerEventQueue(std::size_t capacity = 128U);
+
+        /** Producer (HID task). False if the queue was full. */
+        bool Push(const PointerReport& report);
+
+        /**
+         * Consumer (LVGL task): apply queued reports to @p state, clamped to
+         * [0, max_x] x [0, max_y], up to and including the first button change. Returns true
+         * if reports remain, i.e. the caller should read again right away.
+         */
+        bool Drain(PointerState& state, std::int32_t max_x, std::int32_t max_y);
+
+        /** Consumer: discard everything, e.g. after the device was unplugged. */
+        void Clear();
+
+        Stats GetStats() const;
+
+    private:
+        SpscRing<PointerReport>    ring_;
+        std::atomic<std::uint32_t> pushed_{0U};
+        std::atomic<std::uint32_t> dropped_{0U};
+        std::uint32_t              drained_   = 0U;
+        std::uint32_t              coalesced_ = 0U;
+        std::uint32_t              max_batch_ = 0U;
+    };
+
+    /** A key going down or up, as a HID keyboard usage code (0x04 'a' ... 0x52 up arrow). */
+    struct KeyEvent
+    {
+        std::uint8_t usage     = 0U;
+        std::uint8_t modifiers = 0U;  // HID modifier bits at the time of the edge
+        bool         pressed   = false;
+    };
+
+    /**
+     * @brief Turns boot-protocol keyboard reports into key edges.
+     *
+     * A boot report is the modifier byte, a reserved byte and up to six pressed usages. Keys
+     * that appear are reported as pressed, keys that disappear as released. Rollover error
+     * reports (usage 0x01 in every slot) are ignored so held keys are not released by them.
+     */
+    class KeyboardReportDecoder
+    {
+    public:
+        static constexpr std::size_t kBootKeys = 6U;
+
+        /**
+         * Writes at most @p max edges to @p out and returns how many; 2 * kBootKeys is always
+         * enough.
+         */
+        std::size_t Decode(const std::uint8_t* report,
+                           std::size_t         length,
+                           KeyEvent*           out,
+                           std::size_t         max);
+
+        void Reset();
+
+    private:
+        std::uint8_t keys_[kBootKeys] = {};
+    };
+
+}  // namespace custom::platform
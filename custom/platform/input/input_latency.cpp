@@ -0,0 +1,198 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/input/input_latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        std::uint32_t ElapsedUs(std::uint64_t from, std::uint64_t to)
+        {
+            return static_cast<std::uint32_t>(std::min<std::uint64_t>(to - from, UINT32_MAX));
+        }
+
+    }  // namespace
+
+    LatencyHistogram::LatencyHistogram(std::uint32_t bucket_us, std::size_t buckets)
+        : bucket_us_(std::max<std::uint32_t>(bucket_us, 1U)),
+          buckets_(std::max<std::size_t>(buckets, 1U) + 1U, 0U)
+    {
+    }
+
+    void LatencyHistogram::Record(std::uint32_t us)
+    {
+        const std::size_t index = std::min<std::size_t>(us / bucket_us_, buckets_.size() - 1U);
+        buckets_[index]++;
+        count_++;
+        total_ += us;
+        min_ = std::min(min_, us);
+        max_ = std::max(max_, us);
+    }
+
+    std::uint32_t LatencyHistogram::PercentileUs(std::uint64_t rank) const
+    {
+        std::uint64_t seen = 0U;
+        for (std::size_t i = 0; i + 1U < buckets_.size(); ++i)
+        {
+            seen += buckets_[i];
+            if (seen >= rank)
+            {
+                return std::min(static_cast<std::uint32_t>((i + 1U) * bucket_us_), max_);
+            }
+        }
+        return max_;
+    }
+
+    LatencyPercentiles LatencyHistogram::Summary() const
+    {
+        LatencyPercentiles summary;
+        if (count_ == 0U)
+        {
+            return summary;
+        }
+        summary.count  = count_;
+        summary.min_us = min_;
+        summary.max_us = max_;
+        summary.avg_us = static_cast<std::uint32_t>(total_ / count_);
+        // Nearest-rank: the smallest value with at least p% of samples at or below it
+        summary.p50_us = PercentileUs((static_cast<std::uint64_t>(count_) * 50U + 99U) / 100U);
+        summary.p95_us = PercentileUs((static_cast<std::uint64_t>(count_) * 95U + 99U) / 100U);
+        summary.p99_us = PercentileUs((static_cast<std::uint64_t>(count_) * 99U + 99U) / 100U);
+        return summary;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        std::fill(buckets_.begin(), buckets_.end(), 0U);
+        count_ = 0U;
+        total_ = 0U;
+        min_   = UINT32_MAX;
+        max_   = 0U;
+    }
+
+    InputLatencyTracker::InputLatencyTracker() : InputLatencyTracker(Config{})
+    {
+    }
+
+    InputLatencyTracker::InputLatencyTracker(Config config) : config_(std::move(config))
+    {
+        if (!config_.clock)
+        {
+            config_.clock = []() {
+                return static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+            };
+        }
+    }
+
+    std::uint64_t InputLatencyTracker::Now() const
+    {
+        // Keep 0 free as the "nothing pending" marker
+        return std::max<std::uint64_t>(config_.clock(), 1U);
+    }
+
+    void InputLatencyTracker::OnIndevRead(bool pressed)
+    {
+        const std::uint64_t now = Now();
+        if (last_read_us_ != 0U)
+        {
+            read_interval_.Record(ElapsedUs(last_read_us_, now));
+        }
+        last_read_us_ = now;
+        if (pressed && !last_pressed_)
+        {
+            press_read_us_ = now;
+        }
+        last_pressed_ = pressed;
+    }
+
+    void InputLatencyTracker::OnPressDispatched()
+    {
+        const std::uint64_t now = Now();
+        presses_++;
+        if (dispatched_us_ != 0U)
+        {
+            // The previous press never got its frame; a new one replaces it
+            no_frame_++;
+        }
+        if (press_read_us_ != 0U)
+        {
+            read_to_dispatch_.Record(ElapsedUs(press_read_us_, now));
+        }
+        dispatched_us_   = now;
+        dispatched_from_ = press_read_us_;
+        press_read_us_   = 0U;
+        frame_rendered_  = false;
+    }
+
+    void InputLatencyTracker::OnRenderStart()
+    {
+        if (dispatched_us_ != 0U)
+        {
+            frame_rendered_ = true;
+        }
+    }
+
+    void InputLatencyTracker::OnRefreshReady()
+    {
+        if (dispatched_us_ == 0U)
+        {
+            return;
+        }
+        const std::uint64_t now = Now();
+        if (frame_rendered_)
+        {
+            dispatch_to_frame_.Record(ElapsedUs(dispatched_us_, now));
+            if (dispatched_from_ != 0U)
+            {
+                read_to_frame_.Record(ElapsedUs(dispatched_from_, now));
+            }
+            dispatched_us_ = 0U;
+        }
+        else if (now - dispatched_us_ > config_.frame_timeout_us)
+        {
+            no_frame_++;
+            dispatched_us_ = 0U;
+        }
+        frame_rendered_ = false;
+    }
+
+    InputLatencySnapshot InputLatencyTracker::Snapshot() const
+    {
+        InputLatencySnapshot snapshot;
+        snapshot.read_interval     = read_interval_.Summary();
+        snapshot.read_to_dispatch  = read_to_dispatch_.Summary();
+        snapshot.dispatch_to_frame = dispatch_to_frame_.Summary();
+        snapshot.read_to_frame     = read_to_frame_.Summary();
+        snapshot.presses           = presses_;
+        snapshot.no_frame          = no_frame_;
+        return snapshot;
+    }
+
+    void InputLatencyTracker::Reset()
+    {
+        read_interval_.Reset();
+        read_to_dispatch_.Reset();
+        dispatch_to_frame_.Reset();
+        read_to_frame_.Reset();
+        last_read_us_   = 0U;
+        last_pressed_   = false;
+        press_read_us_  = 0U;
+        dispatched_us_  = 0U;
+        frame_rendered_ = false;
+        presses_        = 0U;
+        no_frame_       = 0U;
+    }
+
+}  // namespace custom::platform
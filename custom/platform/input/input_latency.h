@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace custom::platform
+{
+
+    struct LatencyPercentiles
+    {
+        std::uint32_t count  = 0U;
+        std::uint32_t min_us = 0U;
+        std::uint32_t max_us = 0U;
+        std::uint32_t avg_us = 0U;
+        std::uint32_t p50_us = 0U;
+        std::uint32_t p95_us = 0U;
+        std::uint32_t p99_us = 0U;
+    };
+
+    /**
+     * @brief Fixed-bucket latency histogram.
+     *
+     * Percentiles are reported as the upper edge of their bucket, so they err on the slow side
+     * by at most one bucket width; min, max and mean are exact. Samples past the last bucket
+     * land in an overflow bucket that reports max_us. Not thread-safe.
+     */
+    class LatencyHistogram
+    {
+    public:
+        explicit LatencyHistogram(std::uint32_t bucket_us = 500U, std::size_t buckets = 200U);
+
+        void               Record(std::uint32_t us);
+        LatencyPercentiles Summary() const;
+        void               Reset();
+
+    private:
+        std::uint32_t PercentileUs(std::uint64_t rank) const;
+
+        std::uint32_t              bucket_us_;
+        std::vector<std::uint32_t> buckets_;  // last one is the overflow bucket
+        std::uint32_t              count_ = 0U;
+        std::uint64_t              total_ = 0U;
+        std::uint32_t              min_   = UINT32_MAX;
+        std::uint32_t              max_   = 0U;
+    };
+
+    struct InputLatencySnapshot
+    {
+        LatencyPercentiles read_interval;      // time between indev reads (sampling period)
+        LatencyPercentiles read_to_dispatch;   // press read -> LV_EVENT_PRESSED handler
+        LatencyPercentiles dispatch_to_frame;  // handler -> first refresh that drew something
+        LatencyPercentiles read_to_frame;      // press read -> that refresh, end to end
+        std::uint32_t      presses  = 0U;
+        std::uint32_t      no_frame = 0U;  // presses that never led to a redraw in time
+    };
+
+    /**
+     * @brief Touch-to-frame latency of pointer presses.
+     *
+     * Fed from four points on the LVGL thread: every indev read, the app's press handler, and
+     * the display's render-start and refresh-ready events. A press is timed from the read that
+     * first reported it, through its dispatch, to the end of the first refresh after dispatch
+     * that actually rendered an area, i.e. the frame that shows the reaction. The read
+     * interval histogram bounds the part not seen here: a finger can land up to one read
+     * period before it is sampled. Single-threaded; call everything from the LVGL thread.
+     */
+    class InputLatencyTracker
+    {
+    public:
+        struct Config
+        {
+            /** A press with no redraw within this time is counted in no_frame and dropped. */
+            std::uint32_t frame_timeout_us = 500000U;
+            /** Monotonic microsecond clock; defaults to std::chrono::steady_clock. */
+            std::function<std::uint64_t()> clock;
+        };
+
+        InputLatencyTracker();
+        explicit InputLatencyTracker(Config config);
+
+        /** After each indev read; @p pressed is the state the read reported. */
+        void OnIndevRead(bool pressed);
+        /** In the handler that reacts to LV_EVENT_PRESSED. */
+        void OnPressDispatched();
+        /** LV_EVENT_RENDER_START: this refresh is drawing something. */
+        void OnRenderStart();
+        /** LV_EVENT_REFR_READY: the refresh is rendered and handed to the flush callback. */
+        void OnRefreshReady();
+
+        InputLatencySnapshot Snapshot() const;
+        void                 Reset();
+
+    private:
+        std::uint64_t Now() const;
+
+        Config           config_;
+        LatencyHistogram read_interval_{250U, 200U};
+        LatencyHistogram read_to_dispatch_;
+        LatencyHistogram dispatch_to_frame_;
+        LatencyHistogram read_to_frame_;
+        std::uint64_t    last_read_us_    = 0U;
+        bool             last_pressed_    = false;
+        std::uint64_t    press_read_us_   = 0U;  // 0: no press waiting for dispatch
+        std::uint64_t    dispatched_us_   = 0U;  // 0: no press waiting for a frame
+        std::uint64_t    dispatched_from_ = 0U;  // read time of the dispatched press
+        bool             frame_rendered_  = false;
+        std::uint32_t    presses_         = 0U;
+        std::uint32_t    no_frame_        = 0U;
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/input/input_latency_lvgl.h"
+
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        // The indev's driver_data belongs to the BSP touch driver or the SDL mouse, so the
+        // wrapped read callback and the tracker live here instead
+        struct LvglHooks
+        {
+            InputLatencyTracker* tracker       = nullptr;
+            lv_indev_read_cb_t   inner_read_cb = nullptr;
+            LvglPressFn          on_press;
+        };
+
+        LvglHooks hooks;
+
+        void ReadCb(lv_indev_t* indev, lv_indev_data_t* data)
+        {
+            hooks.inner_read_cb(indev, data);
+            hooks.tracker->OnIndevRead(data->state == LV_INDEV_STATE_PRESSED);
+        }
+
+        void IndevEventCb(lv_event_t* event)
+        {
+            LV_UNUSED(event);
+            hooks.tracker->OnPressDispatched();
+            if (hooks.on_press)
+            {
+                lv_point_t point = {0, 0};
+                lv_indev_get_point(lv_indev_active(), &point);
+                hooks.on_press(point);
+            }
+        }
+
+        void DisplayEventCb(lv_event_t* event)
+        {
+            if (lv_event_get_code(event) == LV_EVENT_RENDER_START)
+            {
+                hooks.tracker->OnRenderStart();
+            }
+            else
+            {
+                hooks.tracker->OnRefreshReady();
+            }
+        }
+
+    }  // namespace
+
+    bool InstrumentLvglInputLatency(InputLatencyTracker& tracker,
+                                    lv_indev_t*          indev,
+                                    lv_display_t*        display,
+                                    LvglPressFn          on_press)
+    {
+        if (indev == nullptr || display == nullptr || hooks.inner_read_cb != nullptr)
+        {
+            return false;
+        }
+        lv_indev_read_cb_t read_cb = lv_indev_get_read_cb(indev);
+        if (read_cb == nullptr)
+        {
+            return false;
+        }
+
+        hooks.tracker       = &tracker;
+        hooks.inner_read_cb = read_cb;
+        hooks.on_press      = std::move(on_press);
+        lv_indev_set_read_cb(indev, ReadCb);
+        lv_indev_add_event_cb(indev, IndevEventCb, LV_EVENT_PRESSED, nullptr);
+        lv_display_add_event_cb(display, DisplayEventCb, LV_EVENT_RENDER_START, nullptr);
+        lv_display_add_event_cb(display, DisplayEventCb, LV_EVENT_REFR_READY, nullptr);
+        tracker.Reset();
+        return true;
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <functional>
+
+#ifdef __has_include
+#    if __has_include("lvgl.h")
+#        ifndef LV_LVGL_H_INCLUDE_SIMPLE
+#            define LV_LVGL_H_INCLUDE_SIMPLE
+#        endif
+#    endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#    include "lvgl.h"
+#else
+#    include "lvgl/lvgl.h"
+#endif
+
+#include "platform/input/input_latency.h"
+
+namespace custom::platform
+{
+
+    /** Runs right after a press is timed as dispatched, with the point it landed on. */
+    using LvglPressFn = std::function<void(const lv_point_t& point)>;
+
+    /**
+     * @brief Feeds @p tracker from a pointer indev and the display it draws on.
+     *
+     * Wraps the indev's read callback, and times the dispatch from LV_EVENT_PRESSED on the
+     * indev itself rather than on an object: the pages are full-screen clickable objects that
+     * keep PRESSED from bubbling to the screen, but the indev sees every press, whatever it
+     * lands on. The indev keeps its own driver_data, so only one indev can be instrumented per
+     * process. Call with the LVGL lock held; returns false if already done or the indev has
+     * no read callback.
+     */
+    bool InstrumentLvglInputLatency(InputLatencyTracker& tracker,
+                                    lv_indev_t*          indev,
+                                    lv_display_t*        display,
+                                    LvglPressFn          on_press = nullptr);
+
+}  // namespace custom::platform
@@ -0,0 +1,328 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/memory/heap_site_profile.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uintptr_t kTombstone = 1U;  // no heap returns an odd address
+        constexpr std::size_t    kMaxProbe  = 16U;
+        constexpr std::uint32_t  kMaxSize   = 0x00FFFFFFU;
+        constexpr unsigned       kTagShift  = 24U;
+        constexpr const char*    kOtherTag  = "[other]";
+        constexpr const char*    kClassLabels[kHeapSizeClasses] = {
+            "16", "32", "64", "128", "256", "512", "1K", "2K", "4K", "8K", "16K", "64K", ">64K"};
+
+        thread_local const char* t_heap_tag = nullptr;
+
+        std::size_t SlotHash(std::uintptr_t address)
+        {
+            // Blocks are at least 4-byte aligned and often share their high bits
+            return static_cast<std::size_t>((address >> 2U) * 0x9E3779B1U);
+        }
+
+        std::size_t FloorPowerOfTwo(std::size_t value)
+        {
+            std::size_t result = 1U;
+            while (result <= value / 2U)
+            {
+                result *= 2U;
+            }
+            return result;
+        }
+
+    }  // namespace
+
+    HeapTagScope::HeapTagScope(const char* tag) : previous_(t_heap_tag)
+    {
+        t_heap_tag = tag;
+    }
+
+    HeapTagScope::~HeapTagScope()
+    {
+        t_heap_tag = previous_;
+    }
+
+    const char* HeapTagScope::Current()
+    {
+        return t_heap_tag;
+    }
+
+    HeapSiteProfile::HeapSiteProfile(Slot* slots, std::size_t slot_count)
+        : slots_(slot_count > 0U ? slots : nullptr),
+          mask_(slot_count > 0U ? FloorPowerOfTwo(slot_count) - 1U : 0U)
+    {
+        std::strncpy(tags_[0].name, kOtherTag, kHeapSiteTagLen - 1U);
+        tags_[0].used.store(2U, std::memory_order_release);
+    }
+
+    std::size_t HeapSiteProfile::SizeClass(std::size_t size)
+    {
+        std::size_t index = 0U;
+        while (index + 1U < kHeapSizeClasses && size > kHeapSizeClassBounds[index])
+        {
+            index++;
+        }
+        return index;
+    }
+
+    void HeapSiteProfile::OnAlloc(const void* ptr, std::size_t size, const char* tag)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        const std::uint32_t tag_index = TagIndex(tag);
+        const std::uint32_t bytes     =
+            size > kMaxSize ? kMaxSize : static_cast<std::uint32_t>(size);
+        AtomicCell&         cell      = CellFor(tag_index, SizeClass(bytes));
+        cell.allocs.fetch_add(1U, std::memory_order_relaxed);
+
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        if (slots_ != nullptr)
+        {
+            const std::size_t home = SlotHash(address);
+            for (std::size_t probe = 0U; probe < kMaxProbe; ++probe)
+            {
+                Slot&          slot     = slots_[(home + probe) & mask_];
+                std::uintptr_t expected = slot.address.load(std::memory_order_relaxed);
+                if ((expected == 0U || expected == kTombstone) &&
+                    slot.address.compare_exchange_strong(
+                        expected, address, std::memory_order_acq_rel))
+                {
+                    // Nobody frees the block before its allocation returns, so no reader
+                    // looks at info before this store lands
+                    slot.info.store(tag_index << kTagShift | bytes, std::memory_order_release);
+                    cell.live_blocks.fetch_add(1U, std::memory_order_relaxed);
+                    cell.live_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                    tracked_.fetch_add(1U, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+        untracked_.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    void HeapSiteProfile::OnFree(const void* ptr)
+    {
+        if (ptr == nullptr || slots_ == nullptr)
+        {
+            return;
+        }
+        const auto        address = reinterpret_cast<std::uintptr_t>(ptr);
+        const std::size_t home    = SlotHash(address);
+        for (std::size_t probe = 0U; probe < kMaxProbe; ++probe)
+        {
+            Slot&          slot    = slots_[(home + probe) & mask_];
+            std::uintptr_t current = slot.address.load(std::memory_order_acquire);
+            if (current == 0U)
+            {
+                return;  // allocated before the profile, or untracked
+            }
+            if (current != address)
+            {
+                continue;
+            }
+            const std::uint32_t info = slot.info.load(std::memory_order_acquire);
+            if (!slot.address.compare_exchange_strong(
+                    current, kTombstone, std::memory_order_acq_rel))
+            {
+                return;
+            }
+            const std::uint32_t bytes = info & kMaxSize;
+            AtomicCell&         cell  = CellFor(info >> kTagShift, SizeClass(bytes));
+            cell.live_blocks.fetch_sub(1U, std::memory_order_relaxed);
+            cell.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            tracked_.fetch_sub(1U, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    std::size_t HeapSiteProfile::Summaries(TagSummary* out, std::size_t max) const
+    {
+        std::size_t count = 0U;
+        for (std::size_t tag = 0U; tag < kHeapSiteTags; ++tag)
+        {
+            if (tags_[tag].used.load(std::memory_order_acquire) != 2U)
+            {
+                continue;
+            }
+            TagSummary summary;
+            summary.name = tags_[tag].name;
+            for (std::size_t size_class = 0U; size_class < kHeapSizeClasses; ++size_class)
+            {
+                const AtomicCell& cell  = cells_[tag][size_class];
+                Cell&             local = summary.classes[size_class];
+                local.live_blocks       = cell.live_blocks.load(std::memory_order_relaxed);
+                local.live_bytes        = cell.live_bytes.load(std::memory_order_relaxed);
+                local.allocs            = cell.allocs.load(std::memory_order_relaxed);
+                summary.live_blocks += local.live_blocks;
+                summary.live_bytes += local.live_bytes;
+                summary.allocs += local.allocs;
+            }
+            if (summary.allocs == 0U)
+            {
+                continue;
+            }
+
+            // Insertion into the sorted prefix; a summary that would fall off the end is dropped
+            std::size_t position = count < max ? count : max;
+            while (position > 0U && out[position - 1U].live_bytes < summary.live_bytes)
+            {
+                if (position < max)
+                {
+                    out[position] = out[position - 1U];
+                }
+                position--;
+            }
+            if (position < max)
+            {
+                out[position] = summary;
+                count         = count < max ? count + 1U : count;
+            }
+        }
+        return count;
+    }
+
+    HeapSiteProfile::Stats HeapSiteProfile::GetStats() const
+    {
+        Stats stats;
+        stats.tracked   = tracked_.load(std::memory_order_relaxed);
+        stats.untracked = untracked_.load(std::memory_order_relaxed);
+        stats.capacity  = slots_ != nullptr ? static_cast<std::uint32_t>(mask_ + 1U) : 0U;
+        return stats;
+    }
+
+    bool HeapSiteProfile::Write(const Writer& out) const
+    {
+        // Sorted by index rather than through Summaries(): this may run on a small stack
+        std::uint8_t  order[kHeapSiteTags];
+        std::uint32_t live[kHeapSiteTags] = {};
+        std::size_t   count               = 0U;
+        for (std::size_t tag = 0U; tag < kHeapSiteTags; ++tag)
+        {
+            std::uint32_t allocs = 0U;
+            if (tags_[tag].used.load(std::memory_order_acquire) != 2U)
+            {
+                continue;
+            }
+            for (const AtomicCell& cell : cells_[tag])
+            {
+                live[tag] += cell.live_bytes.load(std::memory_order_relaxed);
+                allocs += cell.allocs.load(std::memory_order_relaxed);
+            }
+            if (allocs == 0U)
+            {
+                continue;
+            }
+            std::size_t position = count++;
+            while (position > 0U && live[order[position - 1U]] < live[tag])
+            {
+                order[position] = order[position - 1U];
+                position--;
+            }
+            order[position] = static_cast<std::uint8_t>(tag);
+        }
+
+        char line[192];
+        int  len = std::snprintf(
+            line, sizeof(line), "%-15s %10s %8s %10s", "site", "live_bytes", "blocks", "allocs");
+        for (const char* label : kClassLabels)
+        {
+            len += std::snprintf(line + len, sizeof(line) - len, " %5s", label);
+        }
+        len += std::snprintf(line + len, sizeof(line) - len, "\n");
+        if (!out(line, static_cast<std::size_t>(len)))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0U; i < count; ++i)
+        {
+            const std::size_t tag    = order[i];
+            std::uint32_t     blocks = 0U;
+            std::uint32_t     allocs = 0U;
+            for (const AtomicCell& cell : cells_[tag])
+            {
+                blocks += cell.live_blocks.load(std::memory_order_relaxed);
+                allocs += cell.allocs.load(std::memory_order_relaxed);
+            }
+            len = std::snprintf(line,
+                                sizeof(line),
+                                "%-15s %10" PRIu32 " %8" PRIu32 " %10" PRIu32,
+                                tags_[tag].name,
+                                live[tag],
+                                blocks,
+                                allocs);
+            for (const AtomicCell& cell : cells_[tag])
+            {
+                len += std::snprintf(line + len,
+                                     sizeof(line) - len,
+                                     " %5" PRIu32,
+                                     cell.live_blocks.load(std::memory_order_relaxed));
+            }
+            len += std::snprintf(line + len, sizeof(line) - len, "\n");
+            if (!out(line, static_cast<std::size_t>(len)))
+            {
+                return false;
+            }
+        }
+
+        const Stats stats = GetStats();
+        len               = std::snprintf(line,
+                            sizeof(line),
+                            "# %" PRIu32 " blocks tracked of %" PRIu32 " slots, %" PRIu32
+                            " allocations untracked\n",
+                            stats.tracked,
+                            stats.capacity,
+                            stats.untracked);
+        return out(line, static_cast<std::size_t>(len));
+    }
+
+    std::uint32_t HeapSiteProfile::TagIndex(const char* tag)
+    {
+        if (tag == nullptr || tag[0] == '\0')
+        {
+            return 0U;
+        }
+        for (std::uint32_t index = 1U; index < kHeapSiteTags; ++index)
+        {
+            TagEntry&     entry = tags_[index];
+            std::uint32_t state = entry.used.load(std::memory_order_acquire);
+            if (state == 0U && entry.used.compare_exchange_strong(
+                                   state, 1U, std::memory_order_acq_rel))
+            {
+                std::strncpy(entry.name, tag, kHeapSiteTagLen - 1U);
+                entry.used.store(2U, std::memory_order_release);
+                return index;
+            }
+            if (state == 1U)
+            {
+                // Another thread is naming this slot; waiting could stall behind a preempted
+                // task, so the allocation goes to [other] instead
+                return 0U;
+            }
+            if (std::strncmp(entry.name, tag, kHeapSiteTagLen - 1U) == 0)
+            {
+                return index;
+            }
+        }
+        return 0U;
+    }
+
+    HeapSiteProfile::AtomicCell& HeapSiteProfile::CellFor(std::uint32_t tag, std::size_t size_class)
+    {
+        return cells_[tag < kHeapSiteTags ? tag : 0U][size_class];
+    }
+
+}  // namespace custom::platform
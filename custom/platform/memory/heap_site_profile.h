@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace custom::platform
+{
+
+    /** Upper bounds of the size classes; anything larger lands in one last class. */
+    constexpr std::uint32_t kHeapSizeClassBounds[] = {
+        16U, 32U, 64U, 128U, 256U, 512U, 1024U, 2048U, 4096U, 8192U, 16384U, 65536U};
+    constexpr std::size_t kHeapSizeClasses =
+        sizeof(kHeapSizeClassBounds) / sizeof(kHeapSizeClassBounds[0]) + 1U;
+    constexpr std::size_t kHeapSiteTags   = 32U;  // tag 0 collects whatever does not fit
+    constexpr std::size_t kHeapSiteTagLen = 16U;
+
+    /**
+     * @brief Names the allocations made on this thread while it is alive.
+     *
+     * Without a scope, an allocation is tagged with the task (or thread) name. Scopes nest;
+     * the innermost wins. The name must outlive the scope; a string literal is the usual case.
+     */
+    class HeapTagScope
+    {
+    public:
+        explicit HeapTagScope(const char* tag);
+        ~HeapTagScope();
+
+        HeapTagScope(const HeapTagScope&)            = delete;
+        HeapTagScope& operator=(const HeapTagScope&) = delete;
+
+        /** Innermost tag on this thread, or nullptr. */
+        static const char* Current();
+
+    private:
+        const char* previous_;
+    };
+
+    /**
+     * @brief Live allocations per call-site tag and size class, kept for the whole uptime.
+     *
+     * Fed from the allocator's own hooks, so OnAlloc() and OnFree() never allocate, never
+     * block and are safe from any thread at once. Each live block is remembered in an
+     * open-addressing table in caller-provided storage, keyed by address, so a free is
+     * charged back to the tag that allocated it. A block that finds no slot within a short
+     * probe is counted as untracked instead; so is every free of a block allocated before the
+     * profile existed. Counts are read without stopping allocators, so a report is a close
+     * snapshot rather than an atomic one.
+     */
+    class HeapSiteProfile
+    {
+    public:
+        struct Slot
+        {
+            std::atomic<std::uintptr_t> address{0U};
+            std::atomic<std::uint32_t>  info{0U};  // tag << 24 | size, size capped at 16 MB
+        };
+
+        struct Cell
+        {
+            std::uint32_t live_blocks = 0U;
+            std::uint32_t live_bytes  = 0U;
+            std::uint32_t allocs      = 0U;  // since start, freed or not
+        };
+
+        struct TagSummary
+        {
+            const char*   name        = nullptr;
+            std::uint32_t live_blocks = 0U;
+            std::uint32_t live_bytes  = 0U;
+            std::uint32_t allocs      = 0U;
+            Cell          classes[kHeapSizeClasses];
+        };
+
+        struct Stats
+        {
+            std::uint32_t tracked   = 0U;  // blocks in the table now
+            std::uint32_t untracked = 0U;  // allocations the table had no room for
+            std::uint32_t capacity  = 0U;
+        };
+
+        /** Receives the report in pieces. Returns false to stop. */
+        using Writer = std::function<bool(const char* data, std::size_t len)>;
+
+        /** @p slots must be zeroed and outlive the profile. */
+        HeapSiteProfile(Slot* slots, std::size_t slot_count);
+
+        HeapSiteProfile(const HeapSiteProfile&)            = delete;
+        HeapSiteProfile& operator=(const HeapSiteProfile&) = delete;
+
+        static std::size_t SizeClass(std::size_t size);
+
+        void OnAlloc(const void* ptr, std::size_t size, const char* tag);
+        void OnFree(const void* ptr);
+
+        /** Tags in order of live bytes, largest first. Returns how many were filled in. */
+        std::size_t Summaries(TagSummary* out, std::size_t max) const;
+        Stats       GetStats() const;
+
+        /**
+         * Text table: one row per tag with its live bytes, then live blocks per size class.
+         * Allocates nothing, so it also works from an allocation-failed callback.
+         */
+        bool Write(const Writer& out) const;
+
+    private:
+        struct TagEntry
+        {
+            std::atomic<std::uint32_t> used{0U};  // 0 free, 1 being written, 2 ready
+            char                       name[kHeapSiteTagLen] = {};
+        };
+
+        struct AtomicCell
+        {
+            std::atomic<std::uint32_t> live_blocks{0U};
+            std::atomic<std::uint32_t> live_bytes{0U};
+            std::atomic<std::uint32_t> allocs{0U};
+        };
+
+        std::uint32_t TagIndex(const char* tag);
+        AtomicCell&   CellFor(std::uint32_t tag, std::size_t size_class);
+
+        Slot*                      slots_;
+        std::size_t                mask_;
+        TagEntry                   tags_[kHeapSiteTags];
+        AtomicCell                 cells_[kHeapSiteTags][kHeapSizeClasses];
+        std::atomic<std::uint32_t> tracked_{0U};
+        std::atomic<std::uint32_t> untracked_{0U};
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// lv_malloc() backend for LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM: the system heap, as with
+// LV_STDLIB_CLIB, but tagged so the heap site profile shows LVGL's share on its own
+#ifdef __has_include
+#    if __has_include("lvgl.h")
+#        ifndef LV_LVGL_H_INCLUDE_SIMPLE
+#            define LV_LVGL_H_INCLUDE_SIMPLE
+#        endif
+#    endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#    include "lvgl.h"
+#else
+#    include "lvgl/lvgl.h"
+#endif
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+#    include <cstdlib>
+#    include <cstring>
+
+#    include "platform/memory/heap_site_profile.h"
+
+namespace
+{
+
+    constexpr const char* kLvglHeapTag = "lv_malloc";
+
+    /** A scope the caller opened (an image decoder, say) says more than "LVGL". */
+    const char* LvglTag()
+    {
+        const char* current = custom::platform::HeapTagScope::Current();
+        return current != nullptr ? current : kLvglHeapTag;
+    }
+
+}  // namespace
+
+extern "C"
+{
+
+    void lv_mem_init(void)
+    {
+    }
+
+    void lv_mem_deinit(void)
+    {
+    }
+
+    lv_mem_pool_t lv_mem_add_pool(void* mem, size_t bytes)
+    {
+        LV_UNUSED(mem);
+        LV_UNUSED(bytes);
+        return NULL;
+    }
+
+    void lv_mem_remove_pool(lv_mem_pool_t pool)
+    {
+        LV_UNUSED(pool);
+    }
+
+    void* lv_malloc_core(size_t size)
+    {
+        custom::platform::HeapTagScope scope(LvglTag());
+        return std::malloc(size);
+    }
+
+    void* lv_realloc_core(void* p, size_t new_size)
+    {
+        custom::platform::HeapTagScope scope(LvglTag());
+        return std::realloc(p, new_size);
+    }
+
+    void lv_free_core(void* p)
+    {
+        std::free(p);
+    }
+
+    void lv_mem_monitor_core(lv_mem_monitor_t* mon_p)
+    {
+        // Not a pool of its own; heap figures come from the heap site profile
+        std::memset(mon_p, 0, sizeof(lv_mem_monitor_t));
+    }
+
+    lv_result_t lv_mem_test_core(void)
+    {
+        return LV_RESULT_OK;
+    }
+
+}  // extern "C"
+
+#endif  // LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/modbus/modbus_crc.h"
+
+#include <array>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        using CrcTable = std::array<std::uint16_t, 256>;
+
+        constexpr CrcTable MakeCrcTable()
+        {
+            CrcTable table{};
+            for (std::uint32_t i = 0; i < 256U; ++i)
+            {
+                std::uint16_t crc = static_cast<std::uint16_t>(i);
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc & 1U) != 0U ? static_cast<std::uint16_t>((crc >> 1) ^ 0xA001U)
+                                           : static_cast<std::uint16_t>(crc >> 1);
+                }
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        // kCrcHigh[i] is kCrcLow[i] advanced by one more zero byte, which lets Step2 fold two
+        // input bytes per iteration (slicing-by-2).
+        constexpr CrcTable MakeCrcTableShifted(const CrcTable& low)
+        {
+            CrcTable table{};
+            for (std::uint32_t i = 0; i < 256U; ++i)
+            {
+                table[i] = static_cast<std::uint16_t>((low[i] >> 8) ^ low[low[i] & 0xFFU]);
+            }
+            return table;
+        }
+
+        constexpr CrcTable kCrcLow  = MakeCrcTable();
+        constexpr CrcTable kCrcHigh = MakeCrcTableShifted(kCrcLow);
+
+    }  // namespace
+
+    std::uint16_t ModbusCrc16(const std::uint8_t* data, std::size_t length, std::uint16_t crc)
+    {
+        std::size_t i = 0U;
+        for (; i + 2U <= length; i += 2U)
+        {
+            const std::uint16_t word =
+                static_cast<std::uint16_t>(crc ^ (data[i] | (data[i + 1U] << 8)));
+            crc = static_cast<std::uint16_t>(kCrcHigh[word & 0xFFU] ^ kCrcLow[word >> 8]);
+        }
+        if (i < length)
+        {
+            crc = static_cast<std::uint16_t>((crc >> 8) ^ kCrcLow[(crc ^ data[i]) & 0xFFU]);
+        }
+        return crc;
+    }
+
+    std::size_t ModbusAppendCrc(std::uint8_t* frame, std::size_t length)
+    {
+        const std::uint16_t crc = ModbusCrc16(frame, length);
+        frame[length]           = static_cast<std::uint8_t>(crc & 0xFFU);
+        frame[length + 1U]      = static_cast<std::uint8_t>(crc >> 8);
+        return length + 2U;
+    }
+
+    bool ModbusCheckCrc(const std::uint8_t* frame, std::size_t length)
+    {
+        if (length < 3U)
+        {
+            return false;
+        }
+        const std::uint16_t crc = ModbusCrc16(frame, length - 2U);
+        return frame[length - 2U] == static_cast<std::uint8_t>(crc & 0xFFU)
+               && frame[length - 1U] == static_cast<std::uint8_t>(crc >> 8);
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,31 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief CRC-16/MODBUS (reflected polynomial 0xA001, initial value 0xFFFF).
+     *
+     * Table-driven, two bytes per step through a pair of 256-entry tables, so the loop has no
+     * per-bit branches and a frame's CRC costs a few cycles per byte. Pass a previous result as
+     * @p crc to continue over a split buffer.
+     */
+    std::uint16_t ModbusCrc16(const std::uint8_t* data,
+                              std::size_t         length,
+                              std::uint16_t       crc = 0xFFFFU);
+
+    /** Append the CRC of @p frame[0, length) low byte first; returns length + 2. */
+    std::size_t ModbusAppendCrc(std::uint8_t* frame, std::size_t length);
+
+    /** True if the last two bytes of @p frame are the CRC of the bytes before them. */
+    bool ModbusCheckCrc(const std::uint8_t* frame, std::size_t length);
+
+}  // namespace custom::platform
@@ -0,0 +1,387 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/modbus/modbus_master.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "platform/modbus/modbus_crc.h"
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint8_t kExceptionFlag  = 0x80U;
+        constexpr std::size_t  kExceptionReply = 5U;  // address, function|0x80, code, CRC
+        constexpr std::size_t  kWriteReply     = 8U;  // address, function, address/count echo, CRC
+
+        bool ValidSlave(std::uint8_t slave)
+        {
+            return slave >= 1U && slave <= 247U;
+        }
+
+        bool ValidRange(std::uint16_t start, std::uint16_t count, std::uint16_t limit)
+        {
+            return count >= 1U && count <= limit
+                   && static_cast<std::uint32_t>(start) + count <= 0x10000U;
+        }
+
+        void PutU16(std::uint8_t* out, std::uint16_t value)
+        {
+            out[0] = static_cast<std::uint8_t>(value >> 8);
+            out[1] = static_cast<std::uint8_t>(value & 0xFFU);
+        }
+
+        std::uint16_t GetU16(const std::uint8_t* in)
+        {
+            return static_cast<std::uint16_t>((in[0] << 8) | in[1]);
+        }
+
+        std::uint64_t SteadyNowUs()
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+        }
+
+    }  // namespace
+
+    ModbusTiming ModbusTimingForBaud(std::uint32_t baud)
+    {
+        ModbusTiming timing;
+        if (baud == 0U)
+        {
+            baud = 9600U;
+        }
+        timing.char_us = (11U * 1000000U + baud - 1U) / baud;
+        if (baud > 19200U)
+        {
+            timing.t15_us = 750U;
+            timing.t35_us = 1750U;
+        }
+        else
+        {
+            timing.t15_us = (timing.char_us * 3U + 1U) / 2U;
+            timing.t35_us = (timing.char_us * 7U + 1U) / 2U;
+        }
+        return timing;
+    }
+
+    const char* ModbusStatusName(ModbusStatus status)
+    {
+        switch (status)
+        {
+            case ModbusStatus::kOk:
+                return "ok";
+            case ModbusStatus::kTimeout:
+                return "timeout";
+            case ModbusStatus::kCrcError:
+                return "crc error";
+            case ModbusStatus::kException:
+                return "exception";
+            case ModbusStatus::kBadResponse:
+                return "bad response";
+            case ModbusStatus::kTransportError:
+                return "transport error";
+            case ModbusStatus::kInvalidRequest:
+                return "invalid request";
+        }
+        return "unknown";
+    }
+
+    bool ModbusBuildRead(ModbusRequest& request,
+                         std::uint8_t   slave,
+                         ModbusFunction function,
+                         std::uint16_t  start,
+                         std::uint16_t  count)
+    {
+        if (!ValidSlave(slave) || !ValidRange(start, count, kModbusMaxReadRegisters)
+            || (function != ModbusFunction::kReadHoldingRegisters
+                && function != ModbusFunction::kReadInputRegisters))
+        {
+            return false;
+        }
+        request.slave    = slave;
+        request.function = static_cast<std::uint8_t>(function);
+        request.count    = count;
+        request.frame[0] = slave;
+        request.frame[1] = request.function;
+        PutU16(&request.frame[2], start);
+        PutU16(&request.frame[4], count);
+        request.length          = ModbusAppendCrc(request.frame, 6U);
+        request.response_length = 5U + 2U * count;
+        return true;
+    }
+
+    bool ModbusBuildWriteSingle(ModbusRequest& request,
+                                std::uint8_t   slave,
+                                std::uint16_t  address,
+                                std::uint16_t  value)
+    {
+        if (!ValidSlave(slave))
+        {
+            return false;
+        }
+        request.slave    = slave;
+        request.function = static_cast<std::uint8_t>(ModbusFunction::kWriteSingleRegister);
+        request.count    = 1U;
+        request.frame[0] = slave;
+        request.frame[1] = request.function;
+        PutU16(&request.frame[2], address);
+        PutU16(&request.frame[4], value);
+        request.length          = ModbusAppendCrc(request.frame, 6U);
+        request.response_length = kWriteReply;
+        return true;
+    }
+
+    bool ModbusBuildWriteMultiple(ModbusRequest&       request,
+                                  std::uint8_t         slave,
+                                  std::uint16_t        start,
+                                  std::uint16_t        count,
+                                  const std::uint16_t* values)
+    {
+        if (!ValidSlave(slave) || values == nullptr
+            || !ValidRange(start, count, kModbusMaxWriteRegisters))
+        {
+            return false;
+        }
+        request.slave    = slave;
+        request.function = static_cast<std::uint8_t>(ModbusFunction::kWriteMultipleRegisters);
+        request.count    = count;
+        request.frame[0] = slave;
+        request.frame[1] = request.function;
+        PutU16(&request.frame[2], start);
+        PutU16(&request.frame[4], count);
+        request.frame[6] = static_cast<std::uint8_t>(count * 2U);
+        for (std::uint16_t i = 0; i < count; ++i)
+        {
+            PutU16(&request.frame[7U + 2U * i], values[i]);
+        }
+        request.length          = ModbusAppendCrc(request.frame, 7U + 2U * count);
+        request.response_length = kWriteReply;
+        return true;
+    }
+
+    ModbusMaster::ModbusMaster(ModbusTransport& transport, Config config)
+        : transport_(transport),
+          config_(std::move(config)),
+          timing_(ModbusTimingForBaud(config_.baud))
+    {
+        if (!config_.clock)
+        {
+            config_.clock = SteadyNowUs;
+        }
+        if (!config_.sleep_us)
+        {
+            config_.sleep_us = [](std::uint64_t us) {
+                std::this_thread::sleep_for(std::chrono::microseconds(us));
+            };
+        }
+    }
+
+    ModbusResult ModbusMaster::ReadHoldingRegisters(std::uint8_t   slave,
+                                                    std::uint16_t  start,
+                                                    std::uint16_t  count,
+                                                    std::uint16_t* out)
+    {
+        ModbusRequest request;
+        if (out == nullptr
+            || !ModbusBuildRead(
+                request, slave, ModbusFunction::kReadHoldingRegisters, start, count))
+        {
+            return ModbusResult{ModbusStatus::kInvalidRequest, 0U};
+        }
+        return Execute(request, out);
+    }
+
+    ModbusResult ModbusMaster::ReadInputRegisters(std::uint8_t   slave,
+                                                  std::uint16_t  start,
+                                                  std::uint16_t  count,
+                                                  std::uint16_t* out)
+    {
+        ModbusRequest request;
+        if (out == nullptr
+            || !ModbusBuildRead(request, slave, ModbusFunction::kReadInputRegisters, start, count))
+        {
+            return ModbusResult{ModbusStatus::kInvalidRequest, 0U};
+        }
+        return Execute(request, out);
+    }
+
+    ModbusResult ModbusMaster::WriteSingleRegister(std::uint8_t  slave,
+                                                   std::uint16_t address,
+                                                   std::uint16_t value)
+    {
+        ModbusRequest request;
+        if (!ModbusBuildWriteSingle(request, slave, address, value))
+        {
+            return ModbusResult{ModbusStatus::kInvalidRequest, 0U};
+        }
+        return Execute(request, nullptr);
+    }
+
+    ModbusResult ModbusMaster::WriteMultipleRegisters(std::uint8_t         slave,
+                                                      std::uint16_t        start,
+                                                      std::uint16_t        count,
+                                                      const std::uint16_t* values)
+    {
+        ModbusRequest request;
+        if (!ModbusBuildWriteMultiple(request, slave, start, count, values))
+        {
+            return ModbusResult{ModbusStatus::kInvalidRequest, 0U};
+        }
+        return Execute(request, nullptr);
+    }
+
+    ModbusResult ModbusMaster::Execute(const ModbusRequest& request, std::uint16_t* registers)
+    {
+        if (request.length == 0U || request.response_length > kModbusMaxFrame)
+        {
+            return ModbusResult{ModbusStatus::kInvalidRequest, 0U};
+        }
+
+        std::uint8_t reply[kModbusMaxFrame];
+        ModbusResult result;
+        for (std::uint32_t attempt = 0; attempt <= config_.retries; ++attempt)
+        {
+            if (attempt > 0U)
+            {
+                stats_.retries++;
+            }
+            stats_.transactions++;
+            result = TransactOnce(request, reply);
+            switch (result.status)
+            {
+                case ModbusStatus::kOk:
+                    stats_.ok++;
+                    break;
+                case ModbusStatus::kTimeout:
+                    stats_.timeouts++;
+                    break;
+                case ModbusStatus::kCrcError:
+                    stats_.crc_errors++;
+                    break;
+                case ModbusStatus::kException:
+                    stats_.exceptions++;
+                    break;
+                default:
+                    stats_.bad_replies++;
+                    break;
+            }
+            if (result.status != ModbusStatus::kTimeout
+                && result.status != ModbusStatus::kCrcError
+                && result.status != ModbusStatus::kBadResponse)
+            {
+                break;
+            }
+        }
+
+        const bool is_read =
+            request.function == static_cast<std::uint8_t>(ModbusFunction::kReadHoldingRegisters)
+            || request.function == static_cast<std::uint8_t>(ModbusFunction::kReadInputRegisters);
+        if (result.Ok() && is_read && registers != nullptr)
+        {
+            for (std::uint16_t i = 0; i < request.count; ++i)
+            {
+                registers[i] = GetU16(&reply[3U + 2U * i]);
+            }
+        }
+        return result;
+    }
+
+    void ModbusMaster::WaitForQuietBus()
+    {
+        const std::uint64_t now   = config_.clock();
+        const std::uint64_t ready = bus_quiet_since_us_ + timing_.t35_us;
+        if (bus_quiet_since_us_ != 0U && now < ready)
+        {
+            config_.sleep_us(ready - now);
+            stats_.idle_wait_us += ready - now;
+        }
+    }
+
+    ModbusResult ModbusMaster::TransactOnce(const ModbusRequest& request, std::uint8_t* reply)
+    {
+        WaitForQuietBus();
+        transport_.DiscardInput();
+
+        const std::uint64_t start = config_.clock();
+        if (!transport_.Write(request.frame, request.length))
+        {
+            bus_quiet_since_us_ = config_.clock();
+            return ModbusResult{ModbusStatus::kTransportError, 0U};
+        }
+        stats_.bytes_tx += request.length;
+
+        // Stop as soon as the expected length is in; only a gap longer than t3.5 (or no reply
+        // within the response timeout) ends the read early.
+        std::size_t expected = request.response_length;
+        std::size_t received = 0U;
+        while (received < expected)
+        {
+            const auto timeout = received == 0U
+                                     ? std::chrono::microseconds(config_.response_timeout)
+                                     : std::chrono::microseconds(timing_.t35_us);
+            const std::size_t n = transport_.Read(reply + received, expected - received, timeout);
+            if (n == 0U)
+            {
+                break;
+            }
+            received += n;
+            if (received >= 2U && (reply[1] & kExceptionFlag) != 0U)
+            {
+                expected = kExceptionReply;
+            }
+        }
+
+        bus_quiet_since_us_ = config_.clock();
+        stats_.bus_us += bus_quiet_since_us_ - start;
+        stats_.bytes_rx += received;
+
+        if (received == 0U)
+        {
+            return ModbusResult{ModbusStatus::kTimeout, 0U};
+        }
+        if (received != expected)
+        {
+            return ModbusResult{ModbusStatus::kBadResponse, 0U};
+        }
+        if (!ModbusCheckCrc(reply, received))
+        {
+            return ModbusResult{ModbusStatus::kCrcError, 0U};
+        }
+        if (reply[0] != request.slave)
+        {
+            return ModbusResult{ModbusStatus::kBadResponse, 0U};
+        }
+        if (reply[1] == (request.function | kExceptionFlag))
+        {
+            return ModbusResult{ModbusStatus::kException, reply[2]};
+        }
+        if (reply[1] != request.function)
+        {
+            return ModbusResult{ModbusStatus::kBadResponse, 0U};
+        }
+
+        // Writes echo address and value/count; reads carry a byte count
+        const bool is_write =
+            request.function == static_cast<std::uint8_t>(ModbusFunction::kWriteSingleRegister)
+            || request.function
+                   == static_cast<std::uint8_t>(ModbusFunction::kWriteMultipleRegisters);
+        const bool echo_ok = is_write ? std::equal(reply + 2, reply + 6, request.frame + 2)
+                                      : reply[2] == request.count * 2U;
+        if (!echo_ok)
+        {
+            return ModbusResult{ModbusStatus::kBadResponse, 0U};
+        }
+        return ModbusResult{ModbusStatus::kOk, 0U};
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,211 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Half-duplex byte link to the RS485 bus.
+     *
+     * Tab5 wraps the UART driver, the desktop build a serial port or pty (SerialModbusTransport),
+     * and tests an in-memory bus of simulated devices (LoopbackModbusTransport).
+     */
+    class ModbusTransport
+    {
+    public:
+        virtual ~ModbusTransport() = default;
+
+        /** Send a whole frame; returns once the last byte has left the transmitter. */
+        virtual bool Write(const std::uint8_t* data, std::size_t length) = 0;
+
+        /**
+         * Read up to @p max bytes, waiting at most @p timeout for the first one. Returns the
+         * number read, 0 on timeout.
+         */
+        virtual std::size_t Read(std::uint8_t*             out,
+                                 std::size_t               max,
+                                 std::chrono::microseconds timeout) = 0;
+
+        /** Drop anything already received, e.g. a late reply to a timed-out request. */
+        virtual void DiscardInput()
+        {
+        }
+    };
+
+    /** Character and inter-frame times for 11-bit RTU characters (8 data, parity/stop, start). */
+    struct ModbusTiming
+    {
+        std::uint32_t char_us = 0U;
+        std::uint32_t t15_us  = 0U;  // longest gap allowed inside a frame
+        std::uint32_t t35_us  = 0U;  // silence that separates frames
+    };
+
+    /** Spec timing; above 19200 baud the gaps are fixed at 750 us and 1750 us. */
+    ModbusTiming ModbusTimingForBaud(std::uint32_t baud);
+
+    enum class ModbusStatus : std::uint8_t
+    {
+        kOk,
+        kTimeout,         // no reply at all
+        kCrcError,        // reply arrived but failed the CRC
+        kException,       // device answered with an exception code
+        kBadResponse,     // wrong address/function/length, or reply cut short
+        kTransportError,  // write failed
+        kInvalidRequest,  // bad address, count or slave id; nothing was sent
+    };
+
+    const char* ModbusStatusName(ModbusStatus status);
+
+    struct ModbusResult
+    {
+        ModbusStatus status    = ModbusStatus::kOk;
+        std::uint8_t exception = 0U;  // valid for kException
+
+        bool Ok() const
+        {
+            return status == ModbusStatus::kOk;
+        }
+    };
+
+    enum class ModbusFunction : std::uint8_t
+    {
+        kReadHoldingRegisters   = 0x03,
+        kReadInputRegisters     = 0x04,
+        kWriteSingleRegister    = 0x06,
+        kWriteMultipleRegisters = 0x10,
+    };
+
+    /** Largest RTU frame: address, PDU of up to 253 bytes, CRC. */
+    constexpr std::size_t kModbusMaxFrame = 256U;
+    /** Register count limit of one read request. */
+    constexpr std::uint16_t kModbusMaxReadRegisters = 125U;
+    /** Register count limit of one write-multiple request. */
+    constexpr std::uint16_t kModbusMaxWriteRegisters = 123U;
+
+    /** An encoded request, built once and reusable (the poller keeps one per scheduled read). */
+    struct ModbusRequest
+    {
+        std::uint8_t  frame[kModbusMaxFrame] = {};
+        std::size_t   length                 = 0U;
+        std::size_t   response_length        = 0U;  // expected reply size on success
+        std::uint8_t  slave                  = 0U;
+        std::uint8_t  function               = 0U;
+        std::uint16_t count                  = 0U;  // registers read or written
+    };
+
+    /** Encode a read of @p count registers; false if the arguments are out of range. */
+    bool ModbusBuildRead(ModbusRequest& request,
+                         std::uint8_t   slave,
+                         ModbusFunction function,
+                         std::uint16_t  start,
+                         std::uint16_t  count);
+
+    bool ModbusBuildWriteSingle(ModbusRequest& request,
+                                std::uint8_t   slave,
+                                std::uint16_t  address,
+                                std::uint16_t  value);
+
+    bool ModbusBuildWriteMultiple(ModbusRequest&       request,
+                                  std::uint8_t         slave,
+                                  std::uint16_t        start,
+                                  std::uint16_t        count,
+                                  const std::uint16_t* values);
+
+    /**
+     * @brief Modbus RTU master: one request on the bus at a time, with spec inter-frame timing.
+     *
+     * Every transaction waits until the bus has been quiet for t3.5, sends the prepared frame,
+     * and reads the reply until its expected length (known from the function code) arrives,
+     * rather than waiting out a trailing gap. A reply that stops for longer than t3.5 mid-frame
+     * is rejected. Timeouts and CRC failures are retried up to Config::retries times;
+     * exceptions are not. Not thread-safe: drive it from one task (see ModbusPoller).
+     */
+    class ModbusMaster
+    {
+    public:
+        struct Config
+        {
+            std::uint32_t             baud             = 115200U;
+            std::chrono::milliseconds response_timeout = std::chrono::milliseconds(100);
+            std::uint8_t              retries          = 1U;
+            // Microsecond clock and sleep, replaceable for deterministic tests; default to
+            // std::chrono::steady_clock and std::this_thread::sleep_for.
+            std::function<std::uint64_t()>     clock;
+            std::function<void(std::uint64_t)> sleep_us;
+        };
+
+        struct Stats
+        {
+            std::uint32_t transactions = 0U;
+            std::uint32_t ok           = 0U;
+            std::uint32_t timeouts     = 0U;
+            std::uint32_t crc_errors   = 0U;
+            std::uint32_t exceptions   = 0U;
+            std::uint32_t bad_replies  = 0U;
+            std::uint32_t retries      = 0U;
+            std::uint64_t bytes_tx     = 0U;
+            std::uint64_t bytes_rx     = 0U;
+            std::uint64_t bus_us       = 0U;  // time spent from send to reply (or give-up)
+            std::uint64_t idle_wait_us = 0U;  // time spent enforcing t3.5 before sending
+        };
+
+        ModbusMaster(ModbusTransport& transport, Config config);
+
+        ModbusResult ReadHoldingRegisters(std::uint8_t   slave,
+                                          std::uint16_t  start,
+                                          std::uint16_t  count,
+                                          std::uint16_t* out);
+        ModbusResult ReadInputRegisters(std::uint8_t   slave,
+                                        std::uint16_t  start,
+                                        std::uint16_t  count,
+                                        std::uint16_t* out);
+        ModbusResult WriteSingleRegister(std::uint8_t  slave,
+                                         std::uint16_t address,
+                                         std::uint16_t value);
+        ModbusResult WriteMultipleRegisters(std::uint8_t         slave,
+                                            std::uint16_t        start,
+                                            std::uint16_t        count,
+                                            const std::uint16_t* values);
+
+        /**
+         * Run a prepared request. For reads, the registers are decoded into @p registers
+         * (request.count entries); writes ignore it.
+         */
+        ModbusResult Execute(const ModbusRequest& request, std::uint16_t* registers);
+
+        const ModbusTiming& Timing() const
+        {
+            return timing_;
+        }
+
+        Stats GetStats() const
+        {
+            return stats_;
+        }
+
+        std::uint64_t NowUs() const
+        {
+            return config_.clock();
+        }
+
+    private:
+        ModbusResult TransactOnce(const ModbusRequest& request, std::uint8_t* reply);
+        void         WaitForQuietBus();
+
+        ModbusTransport& transport_;
+        Config           config_;
+        ModbusTiming     timing_;
+        Stats            stats_;
+        std::uint64_t    bus_quiet_since_us_ = 0U;
+    };
+
+}  // namespace custom::platform
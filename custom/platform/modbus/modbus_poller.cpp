@@ -0,0 +1,284 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/modbus/modbus_poller.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::chrono::microseconds kIdleWait = std::chrono::milliseconds(100);
+
+        std::uint64_t PeriodUs(const ModbusPoller::Poll& poll)
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(poll.period).count());
+        }
+
+    }  // namespace
+
+    ModbusPoller::ModbusPoller(ModbusMaster& master) : ModbusPoller(master, Config{})
+    {
+    }
+
+    ModbusPoller::ModbusPoller(ModbusMaster& master, Config config)
+        : master_(master), config_(config)
+    {
+    }
+
+    int ModbusPoller::Add(const Poll& poll)
+    {
+        Entry entry;
+        if (poll.period.count() <= 0
+            || !ModbusBuildRead(entry.request, poll.slave, poll.function, poll.start, poll.count))
+        {
+            return kInvalidPoll;
+        }
+        entry.poll = poll;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.id     = next_id_++;
+        entry.due_us = master_.NowUs();
+        entries_.push_back(std::move(entry));
+        return entries_.back().id;
+    }
+
+    void ModbusPoller::Remove(int id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(std::remove_if(entries_.begin(),
+                                      entries_.end(),
+                                      [id](const Entry& entry) { return entry.id == id; }),
+                       entries_.end());
+    }
+
+    bool ModbusPoller::QueueWrite(std::uint8_t  slave,
+                                  std::uint16_t address,
+                                  std::uint16_t value,
+                                  WriteCallback done)
+    {
+        PendingWrite write;
+        if (!ModbusBuildWriteSingle(write.request, slave, address, value))
+        {
+            return false;
+        }
+        write.done = std::move(done);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (writes_.size() >= config_.max_writes)
+        {
+            return false;
+        }
+        writes_.push_back(std::move(write));
+        return true;
+    }
+
+    bool ModbusPoller::GetPollStats(int id, PollStats& stats) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Entry& entry : entries_)
+        {
+            if (entry.id == id)
+            {
+                stats = entry.stats;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ModbusPoller::RunQueuedWrite()
+    {
+        PendingWrite write;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (writes_.empty())
+            {
+                return false;
+            }
+            write = std::move(writes_.front());
+            writes_.pop_front();
+        }
+
+        const ModbusResult result = master_.Execute(write.request, nullptr);
+        if (write.done)
+        {
+            write.done(result);
+        }
+        return true;
+    }
+
+    void ModbusPoller::CollectMergeGroup(std::size_t first, std::uint64_t now)
+    {
+        const Entry&  anchor = entries_[first];
+        std::uint32_t lo     = anchor.poll.start;
+        std::uint32_t hi     = static_cast<std::uint32_t>(anchor.poll.start) + anchor.poll.count;
+
+        group_.clear();
+        group_.push_back(first);
+
+        // Grow the span until no other due poll of the same device and function fits into it
+        bool grew = true;
+        while (grew)
+        {
+            grew = false;
+            for (std::size_t i = 0; i < entries_.size(); ++i)
+            {
+                const Entry& entry = entries_[i];
+                if (entry.due_us > now || entry.poll.slave != anchor.poll.slave
+                    || entry.poll.function != anchor.poll.function
+                    || std::find(group_.begin(), group_.end(), i) != group_.end())
+                {
+                    continue;
+                }
+                const std::uint32_t start = entry.poll.start;
+                const std::uint32_t end   = start + entry.poll.count;
+                if (start > hi + config_.max_merge_gap || end + config_.max_merge_gap < lo)
+                {
+                    continue;
+                }
+                const std::uint32_t new_lo = std::min(lo, start);
+                const std::uint32_t new_hi = std::max(hi, end);
+                if (new_hi - new_lo > kModbusMaxReadRegisters)
+                {
+                    continue;
+                }
+                lo = new_lo;
+                hi = new_hi;
+                group_.push_back(i);
+                grew = true;
+            }
+        }
+    }
+
+    std::chrono::microseconds ModbusPoller::RunOnce()
+    {
+        if (RunQueuedWrite())
+        {
+            return std::chrono::microseconds(0);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (entries_.empty())
+        {
+            return kIdleWait;
+        }
+
+        // Earliest deadline first; ties go to the poll added first
+        std::size_t first = 0U;
+        for (std::size_t i = 1; i < entries_.size(); ++i)
+        {
+            if (entries_[i].due_us < entries_[first].due_us)
+            {
+                first = i;
+            }
+        }
+        const std::uint64_t now = master_.NowUs();
+        if (entries_[first].due_us > now)
+        {
+            return std::chrono::microseconds(entries_[first].due_us - now);
+        }
+
+        CollectMergeGroup(first, now);
+
+        ModbusRequest request;
+        std::uint32_t span_start = entries_[first].poll.start;
+        if (group_.size() == 1U)
+        {
+            request = entries_[first].request;
+        }
+        else
+        {
+            std::uint32_t span_end = 0U;
+            for (std::size_t index : group_)
+            {
+                const Poll& poll = entries_[index].poll;
+                span_start       = std::min<std::uint32_t>(span_start, poll.start);
+                span_end         = std::max<std::uint32_t>(
+                    span_end, static_cast<std::uint32_t>(poll.start) + poll.count);
+            }
+            ModbusBuildRead(request,
+                            entries_[first].poll.slave,
+                            entries_[first].poll.function,
+                            static_cast<std::uint16_t>(span_start),
+                            static_cast<std::uint16_t>(span_end - span_start));
+        }
+
+        // Remember who gets which slice by id: the table may change while the bus is busy
+        std::vector<int>& ids = group_ids_;
+        ids.clear();
+        deliveries_.clear();
+        for (std::size_t index : group_)
+        {
+            Entry& entry = entries_[index];
+            entry.stats.max_late_us = std::max(entry.stats.max_late_us, now - entry.due_us);
+            ids.push_back(entry.id);
+            deliveries_.push_back(
+                Delivery{entry.poll.on_data, entry.poll.start - span_start, entry.poll.count});
+        }
+        lock.unlock();
+
+        const ModbusResult result = master_.Execute(request, registers_);
+
+        lock.lock();
+        const std::uint64_t done = master_.NowUs();
+        for (Entry& entry : entries_)
+        {
+            if (std::find(ids.begin(), ids.end(), entry.id) == ids.end())
+            {
+                continue;
+            }
+            PollStats& stats = entry.stats;
+            stats.runs++;
+            stats.last_status = result.status;
+            if (ids.size() > 1U)
+            {
+                stats.merged++;
+            }
+            if (result.Ok())
+            {
+                stats.consecutive_failures = 0U;
+            }
+            else
+            {
+                stats.failures++;
+                stats.consecutive_failures++;
+            }
+
+            std::uint64_t multiplier = 1U;
+            if (stats.consecutive_failures >= config_.backoff_after)
+            {
+                const std::uint32_t steps = stats.consecutive_failures - config_.backoff_after + 1U;
+                multiplier = std::min<std::uint64_t>(std::uint64_t{1U} << std::min(steps, 16U),
+                                                     config_.max_backoff);
+            }
+            const std::uint64_t interval = PeriodUs(entry.poll) * multiplier;
+            entry.due_us += interval;
+            if (entry.due_us <= done)
+            {
+                // Fell a whole period behind: restart the phase instead of bursting to catch up
+                entry.due_us = done + interval;
+            }
+        }
+        lock.unlock();
+
+        for (const Delivery& delivery : deliveries_)
+        {
+            if (delivery.callback)
+            {
+                delivery.callback(result,
+                                  result.Ok() ? registers_ + delivery.offset : nullptr,
+                                  delivery.count);
+            }
+        }
+        return std::chrono::microseconds(0);
+    }
+
+}  // namespace custom::platform
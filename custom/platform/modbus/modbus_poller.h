@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "platform/modbus/modbus_master.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Periodic register reads and queued writes over one ModbusMaster.
+     *
+     * Each poll has its own period (an energy meter every second, a thermostat every ten).
+     * RunOnce() performs at most one transaction: a queued write if there is one, otherwise the
+     * most overdue poll. Due polls of the same device and function whose ranges lie within
+     * Config::max_merge_gap registers of each other are merged into one request of up to 125
+     * registers, so a meter polled as three small blocks costs one bus round trip. Request
+     * frames are encoded once when a poll is added and sent as-is. Deadlines keep their phase
+     * (next = due + period), so rates do not drift with bus latency. A device that keeps
+     * failing is polled at up to Config::max_backoff times its period until it answers again,
+     * which stops one dead meter from eating the bus in timeouts.
+     *
+     * Add(), Remove() and QueueWrite() may be called from any thread; RunOnce() and the
+     * callbacks it invokes run on the thread that drives the bus.
+     */
+    class ModbusPoller
+    {
+    public:
+        /** @p registers holds @p count values on success and is nullptr otherwise. */
+        using DataCallback = std::function<void(ModbusResult         result,
+                                                const std::uint16_t* registers,
+                                                std::uint16_t        count)>;
+        using WriteCallback = std::function<void(ModbusResult result)>;
+
+        struct Poll
+        {
+            std::uint8_t              slave    = 1U;
+            ModbusFunction            function = ModbusFunction::kReadHoldingRegisters;
+            std::uint16_t             start    = 0U;
+            std::uint16_t             count    = 1U;
+            std::chrono::milliseconds period   = std::chrono::milliseconds(1000);
+            DataCallback              on_data;
+        };
+
+        struct PollStats
+        {
+            std::uint32_t runs                 = 0U;
+            std::uint32_t failures             = 0U;
+            std::uint32_t consecutive_failures = 0U;
+            std::uint32_t merged               = 0U;  // runs that shared a request
+            std::uint64_t max_late_us          = 0U;  // worst start delay past the deadline
+            ModbusStatus  last_status          = ModbusStatus::kOk;
+        };
+
+        struct Config
+        {
+            std::uint16_t max_merge_gap = 8U;   // unused registers allowed between merged polls
+            std::uint32_t backoff_after = 3U;   // consecutive failures before backing off
+            std::uint32_t max_backoff   = 8U;   // largest period multiplier while failing
+            std::size_t   max_writes    = 16U;  // queued writes before QueueWrite() refuses
+        };
+
+        static constexpr int kInvalidPoll = -1;
+
+        explicit ModbusPoller(ModbusMaster& master);
+        ModbusPoller(ModbusMaster& master, Config config);
+
+        /** Schedule a poll, first run as soon as possible. Returns its id or kInvalidPoll. */
+        int  Add(const Poll& poll);
+        void Remove(int id);
+
+        /** Queue a single-register write ahead of any poll; false if the queue is full. */
+        bool QueueWrite(std::uint8_t  slave,
+                        std::uint16_t address,
+                        std::uint16_t value,
+                        WriteCallback done = nullptr);
+
+        /**
+         * Do at most one transaction. Returns how long the caller may sleep before calling
+         * again: 0 while work is pending, otherwise the time until the next deadline.
+         */
+        std::chrono::microseconds RunOnce();
+
+        bool GetPollStats(int id, PollStats& stats) const;
+
+    private:
+        struct Entry
+        {
+            int           id = kInvalidPoll;
+            Poll          poll;
+            ModbusRequest request;
+            std::uint64_t due_us = 0U;
+            PollStats     stats;
+        };
+
+        struct PendingWrite
+        {
+            ModbusRequest request;
+            WriteCallback done;
+        };
+
+        struct Delivery
+        {
+            DataCallback  callback;
+            std::size_t   offset = 0U;
+            std::uint16_t count  = 0U;
+        };
+
+        bool RunQueuedWrite();
+        void CollectMergeGroup(std::size_t first, std::uint64_t now);
+
+        ModbusMaster& master_;
+        Config        config_;
+
+        mutable std::mutex       mutex_;
+        std::vector<Entry>       entries_;
+        std::deque<PendingWrite> writes_;
+        int                      next_id_ = 0;
+
+        // Scratch reused by RunOnce(); only touched by the bus thread
+        std::vector<std::size_t> group_;
+        std::vector<int>         group_ids_;
+        std::vector<Delivery>    deliveries_;
+        std::uint16_t            registers_[kModbusMaxReadRegisters] = {};
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/modbus/modbus_serial_transport.h"
+
+#if CUSTOM_PLATFORM_HAS_TERMIOS
+
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <termios.h>
+#    include <unistd.h>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        speed_t BaudToSpeed(std::uint32_t baud)
+        {
+            switch (baud)
+            {
+                case 9600U:
+                    return B9600;
+                case 19200U:
+                    return B19200;
+                case 38400U:
+                    return B38400;
+                case 57600U:
+                    return B57600;
+                case 115200U:
+                    return B115200;
+                default:
+                    return B9600;
+            }
+        }
+
+        bool ConfigureRaw(int fd, std::uint32_t baud)
+        {
+            termios tio{};
+            if (tcgetattr(fd, &tio) != 0)
+            {
+                return false;
+            }
+            cfmakeraw(&tio);
+            tio.c_cflag |= CLOCAL | CREAD;
+            tio.c_cflag &= ~static_cast<tcflag_t>(CSTOPB | PARENB);
+            tio.c_cc[VMIN]  = 0;
+            tio.c_cc[VTIME] = 0;
+            cfsetispeed(&tio, BaudToSpeed(baud));
+            cfsetospeed(&tio, BaudToSpeed(baud));
+            return tcsetattr(fd, TCSANOW, &tio) == 0;
+        }
+
+    }  // namespace
+
+    SerialModbusTransport::SerialModbusTransport(const std::string& path, std::uint32_t baud)
+    {
+        fd_ = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd_ >= 0 && isatty(fd_) && !ConfigureRaw(fd_, baud))
+        {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    SerialModbusTransport::SerialModbusTransport(int fd) : fd_(fd)
+    {
+        if (fd_ >= 0)
+        {
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+        }
+    }
+
+    SerialModbusTransport::~SerialModbusTransport()
+    {
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+    }
+
+    bool SerialModbusTransport::Write(const std::uint8_t* data, std::size_t length)
+    {
+        std::size_t sent = 0U;
+        while (sent < length)
+        {
+            const ssize_t n = write(fd_, data + sent, length - sent);
+            if (n > 0)
+            {
+                sent += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+            {
+                return false;
+            }
+            pollfd pfd{fd_, POLLOUT, 0};
+            poll(&pfd, 1, 100);
+        }
+        // Half duplex: the reply timeout starts once the frame is on the wire
+        if (isatty(fd_))
+        {
+            tcdrain(fd_);
+        }
+        return true;
+    }
+
+    std::size_t SerialModbusTransport::Read(std::uint8_t*             out,
+                                            std::size_t               max,
+                                            std::chrono::microseconds timeout)
+    {
+        // poll() has millisecond resolution; round up so a 1750 us gap is not cut to 1 ms
+        const int timeout_ms = static_cast<int>((timeout.count() + 999) / 1000);
+        pollfd    pfd{fd_, POLLIN, 0};
+        int       ready;
+        do
+        {
+            ready = poll(&pfd, 1, timeout_ms);
+        } while (ready < 0 && errno == EINTR);
+        if (ready <= 0 || (pfd.revents & POLLIN) == 0)
+        {
+            return 0U;
+        }
+        const ssize_t n = read(fd_, out, max);
+        return n > 0 ? static_cast<std::size_t>(n) : 0U;
+    }
+
+    void SerialModbusTransport::DiscardInput()
+    {
+        if (isatty(fd_))
+        {
+            tcflush(fd_, TCIFLUSH);
+        }
+    }
+
+}  // namespace custom::platform
+
+#endif  // CUSTOM_PLATFORM_HAS_TERMIOS
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+// Host serial ports and ptys only; on Tab5 the RS485 UART is wrapped by the HAL.
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ESP_PLATFORM) && defined(__has_include)
+#    if __has_include(<termios.h>)
+#        define CUSTOM_PLATFORM_HAS_TERMIOS 1
+#    endif
+#endif
+#ifndef CUSTOM_PLATFORM_HAS_TERMIOS
+#    define CUSTOM_PLATFORM_HAS_TERMIOS 0
+#endif
+
+#if CUSTOM_PLATFORM_HAS_TERMIOS
+
+#    include <string>
+
+#    include "platform/modbus/modbus_master.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Modbus transport over a file descriptor: a USB-RS485 adapter or a pty.
+     *
+     * Put into raw 8N1 mode when it is a tty. Reads wait with poll(), so the master's t3.5
+     * gap detection works on real adapters; the pty pair used by the unit tests behaves the
+     * same way.
+     */
+    class SerialModbusTransport : public ModbusTransport
+    {
+    public:
+        /** Open @p path (e.g. /dev/ttyUSB0) at @p baud; check IsOpen(). */
+        SerialModbusTransport(const std::string& path, std::uint32_t baud);
+        /** Take ownership of an already open descriptor, e.g. a pty master. */
+        explicit SerialModbusTransport(int fd);
+        ~SerialModbusTransport() override;
+
+        SerialModbusTransport(const SerialModbusTransport&)            = delete;
+        SerialModbusTransport& operator=(const SerialModbusTransport&) = delete;
+
+        bool IsOpen() const
+        {
+            return fd_ >= 0;
+        }
+
+        bool        Write(const std::uint8_t* data, std::size_t length) override;
+        std::size_t Read(std::uint8_t*             out,
+                         std::size_t               max,
+                         std::chrono::microseconds timeout) override;
+        void        DiscardInput() override;
+
+    private:
+        int fd_ = -1;
+    };
+
+}  // namespace custom::platform
+
+#endif  // CUSTOM_PLATFORM_HAS_TERMIOS
@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/modbus/modbus_slave_sim.h"
+
+#include <algorithm>
+
+#include "platform/modbus/modbus_crc.h"
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::uint8_t kIllegalFunction = 0x01U;
+        constexpr std::uint8_t kIllegalAddress  = 0x02U;
+        constexpr std::uint8_t kIllegalValue    = 0x03U;
+
+        std::uint16_t SimGetU16(const std::uint8_t* in)
+        {
+            return static_cast<std::uint16_t>((in[0] << 8) | in[1]);
+        }
+
+        void SimPutU16(std::vector<std::uint8_t>& out, std::uint16_t value)
+        {
+            out.push_back(static_cast<std::uint8_t>(value >> 8));
+            out.push_back(static_cast<std::uint8_t>(value & 0xFFU));
+        }
+
+        void SimAppendCrc(std::vector<std::uint8_t>& frame)
+        {
+            const std::uint16_t crc = ModbusCrc16(frame.data(), frame.size());
+            frame.push_back(static_cast<std::uint8_t>(crc & 0xFFU));
+            frame.push_back(static_cast<std::uint8_t>(crc >> 8));
+        }
+
+    }  // namespace
+
+    ModbusSlaveSim::ModbusSlaveSim(std::uint8_t address, std::size_t register_count)
+        : address_(address), holding_(register_count, 0U), input_(register_count, 0U)
+    {
+    }
+
+    void ModbusSlaveSim::SetHolding(std::uint16_t address, std::uint16_t value)
+    {
+        if (address < holding_.size())
+        {
+            holding_[address] = value;
+        }
+    }
+
+    std::uint16_t ModbusSlaveSim::Holding(std::uint16_t address) const
+    {
+        return address < holding_.size() ? holding_[address] : 0U;
+    }
+
+    void ModbusSlaveSim::SetInput(std::uint16_t address, std::uint16_t value)
+    {
+        if (address < input_.size())
+        {
+            input_[address] = value;
+        }
+    }
+
+    std::vector<std::uint8_t> ModbusSlaveSim::Exception(std::uint8_t function,
+                                                        std::uint8_t code) const
+    {
+        std::vector<std::uint8_t> reply = {
+            address_, static_cast<std::uint8_t>(function | 0x80U), code};
+        SimAppendCrc(reply);
+        return reply;
+    }
+
+    std::vector<std::uint8_t> ModbusSlaveSim::Handle(const std::uint8_t* frame, std::size_t length)
+    {
+        if (length < 4U || frame[0] != address_ || !ModbusCheckCrc(frame, length))
+        {
+            return {};
+        }
+        requests_++;
+
+        const std::uint8_t function = frame[1];
+        if (length < 8U)
+        {
+            return Exception(function, kIllegalValue);
+        }
+        const std::uint16_t start = SimGetU16(&frame[2]);
+        const std::uint16_t word  = SimGetU16(&frame[4]);
+
+        std::vector<std::uint8_t> reply = {address_, function};
+        switch (function)
+        {
+            case 0x03U:
+            case 0x04U:
+            {
+                const std::vector<std::uint16_t>& bank = function == 0x03U ? holding_ : input_;
+                if (word == 0U || word > kModbusMaxReadRegisters)
+                {
+                    return Exception(function, kIllegalValue);
+                }
+                if (static_cast<std::size_t>(start) + word > bank.size())
+                {
+                    return Exception(function, kIllegalAddress);
+                }
+                reply.push_back(static_cast<std::uint8_t>(word * 2U));
+                for (std::uint16_t i = 0; i < word; ++i)
+                {
+                    SimPutU16(reply, bank[start + i]);
+                }
+                break;
+            }
+            case 0x06U:
+                if (start >= holding_.size())
+                {
+                    return Exception(function, kIllegalAddress);
+                }
+                holding_[start] = word;
+                SimPutU16(reply, start);
+                SimPutU16(reply, word);
+                break;
+            case 0x10U:
+                if (word == 0U || word > kModbusMaxWriteRegisters || length != 9U + 2U * word
+                    || frame[6] != word * 2U)
+                {
+                    return Exception(function, kIllegalValue);
+                }
+                if (static_cast<std::size_t>(start) + word > holding_.size())
+                {
+                    return Exception(function, kIllegalAddress);
+                }
+                for (std::uint16_t i = 0; i < word; ++i)
+                {
+                    holding_[start + i] = SimGetU16(&frame[7U + 2U * i]);
+                }
+                SimPutU16(reply, start);
+                SimPutU16(reply, word);
+                break;
+            default:
+                return Exception(function, kIllegalFunction);
+        }
+        SimAppendCrc(reply);
+        return reply;
+    }
+
+    LoopbackModbusTransport::LoopbackModbusTransport(std::uint32_t baud, std::uint64_t* clock_us)
+        : timing_(ModbusTimingForBaud(baud)), clock_us_(clock_us)
+    {
+    }
+
+    void LoopbackModbusTransport::Attach(ModbusSlaveSim& device)
+    {
+        devices_.push_back(&device);
+    }
+
+    bool LoopbackModbusTransport::Write(const std::uint8_t* data, std::size_t length)
+    {
+        if (clock_us_ != nullptr)
+        {
+            write_start_us.push_back(*clock_us_);
+            *clock_us_ += length * timing_.char_us;
+            write_end_us.push_back(*clock_us_);
+        }
+
+        for (ModbusSlaveSim* device : devices_)
+        {
+            std::vector<std::uint8_t> reply = device->Handle(data, length);
+            if (reply.empty())
+            {
+                continue;
+            }
+            if (drop_replies > 0U)
+            {
+                drop_replies--;
+                continue;
+            }
+            if (corrupt_replies > 0U)
+            {
+                corrupt_replies--;
+                reply[reply.size() / 2U] ^= 0x10U;
+            }
+            rx_.insert(rx_.end(), reply.begin(), reply.end());
+            pending_turnaround_ = true;
+        }
+        return true;
+    }
+
+    std::size_t LoopbackModbusTransport::Read(std::uint8_t*             out,
+                                              std::size_t               max,
+                                              std::chrono::microseconds timeout)
+    {
+        if (rx_.empty())
+        {
+            if (clock_us_ != nullptr)
+            {
+                *clock_us_ += static_cast<std::uint64_t>(timeout.count());
+            }
+            return 0U;
+        }
+
+        const std::size_t n = std::min(max, rx_.size());
+        std::copy(rx_.begin(), rx_.begin() + static_cast<std::ptrdiff_t>(n), out);
+        rx_.erase(rx_.begin(), rx_.begin() + static_cast<std::ptrdiff_t>(n));
+        if (clock_us_ != nullptr)
+        {
+            // The first chunk of a reply also pays for the device's turnaround
+            *clock_us_ += n * timing_.char_us + (pending_turnaround_ ? turnaround_us : 0U);
+            pending_turnaround_ = false;
+        }
+        return n;
+    }
+
+    void LoopbackModbusTransport::DiscardInput()
+    {
+        rx_.clear();
+        pending_turnaround_ = false;
+    }
+
+}  // namespace custom::platform
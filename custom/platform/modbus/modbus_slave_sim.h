@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "platform/modbus/modbus_master.h"
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Simulated RTU device (meter, thermostat) with holding and input register banks.
+     *
+     * Used by the unit tests and bench_modbus, and as a stand-in device on a pty. Answers
+     * functions 0x03, 0x04, 0x06 and 0x10; other functions and out-of-range addresses get the
+     * matching exception reply. Frames for another address or with a bad CRC are ignored,
+     * like on a real bus.
+     */
+    class ModbusSlaveSim
+    {
+    public:
+        explicit ModbusSlaveSim(std::uint8_t address, std::size_t register_count = 256U);
+
+        std::uint8_t Address() const
+        {
+            return address_;
+        }
+
+        void          SetHolding(std::uint16_t address, std::uint16_t value);
+        std::uint16_t Holding(std::uint16_t address) const;
+        void          SetInput(std::uint16_t address, std::uint16_t value);
+
+        /** Handle one request frame; returns the reply, empty if the device stays silent. */
+        std::vector<std::uint8_t> Handle(const std::uint8_t* frame, std::size_t length);
+
+        std::uint32_t RequestsHandled() const
+        {
+            return requests_;
+        }
+
+    private:
+        std::vector<std::uint8_t> Exception(std::uint8_t function, std::uint8_t code) const;
+
+        std::uint8_t               address_;
+        std::vector<std::uint16_t> holding_;
+        std::vector<std::uint16_t> input_;
+        std::uint32_t              requests_ = 0U;
+    };
+
+    /**
+     * @brief In-memory RS485 bus: frames written by the master reach every simulated device.
+     *
+     * Time is simulated: with a clock attached, Write() advances it by the frame's wire time,
+     * the first Read() of a reply by the device's turnaround plus the bytes' wire time, and a
+     * Read() that finds nothing by the full timeout. Tests and benchmarks therefore check
+     * inter-frame gaps and bus occupancy deterministically without sleeping. Faults can be
+     * injected per reply.
+     */
+    class LoopbackModbusTransport : public ModbusTransport
+    {
+    public:
+        explicit LoopbackModbusTransport(std::uint32_t  baud     = 115200U,
+                                         std::uint64_t* clock_us = nullptr);
+
+        void Attach(ModbusSlaveSim& device);
+
+        bool        Write(const std::uint8_t* data, std::size_t length) override;
+        std::size_t Read(std::uint8_t*             out,
+                         std::size_t               max,
+                         std::chrono::microseconds timeout) override;
+        void        DiscardInput() override;
+
+        /** Device processing time between the request's last byte and the reply's first. */
+        std::uint64_t turnaround_us = 500U;
+
+        /** Swallow the next N replies (device offline / frame lost). */
+        std::uint32_t drop_replies = 0U;
+        /** Flip a bit in the next N replies. */
+        std::uint32_t corrupt_replies = 0U;
+
+        /** Start and end time of every frame the master sent, for checking t3.5 gaps. */
+        std::vector<std::uint64_t> write_start_us;
+        std::vector<std::uint64_t> write_end_us;
+
+    private:
+        ModbusTiming                 timing_;
+        std::uint64_t*               clock_us_;
+        std::vector<ModbusSlaveSim*> devices_;
+        std::deque<std::uint8_t>     rx_;
+        bool                         pending_turnaround_ = false;
+    };
+
+}  // namespace custom::platform
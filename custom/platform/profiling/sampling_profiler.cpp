@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "platform/profiling/sampling_profiler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+
+namespace custom::platform
+{
+
+    namespace
+    {
+
+        constexpr std::size_t kWriteChunk = 1024U;
+
+        std::string HexFrame(std::uintptr_t pc)
+        {
+            char text[2U + 2U * sizeof(std::uintptr_t) + 1U];
+            std::snprintf(text, sizeof(text), "0x%08" PRIxPTR, pc);
+            return text;
+        }
+
+        /** Folded stacks use ';' between frames and a space before the count. */
+        void AppendFrame(std::string& line, const std::string& frame)
+        {
+            for (char c : frame)
+            {
+                line.push_back(c == ';' || c == ' ' ? '_' : c);
+            }
+        }
+
+    }  // namespace
+
+    SamplingProfiler::SamplingProfiler(Config config) : config_(config)
+    {
+        config_.cores = std::max<std::size_t>(config_.cores, 1U);
+        for (std::size_t core = 0; core < config_.cores; ++core)
+        {
+            rings_.push_back(std::make_unique<SampleRing>(config_.ring_capacity));
+        }
+    }
+
+    void SamplingProfiler::Record(std::size_t core, std::uintptr_t pc, const char* task)
+    {
+        if (core >= rings_.size())
+        {
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        }
+        ProfileSample sample;
+        sample.pc = pc;
+        if (task != nullptr)
+        {
+            for (std::size_t i = 0; i + 1U < sizeof(sample.task) && task[i] != '\0'; ++i)
+            {
+                sample.task[i] = task[i];
+            }
+        }
+        if (rings_[core]->Push(&sample, 1U) == 0U)
+        {
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+
+    bool SamplingProfiler::Capture(ProfileTimer&             timer,
+                                   std::chrono::milliseconds duration,
+                                   const Writer&             out,
+                                   const FrameNamer&         namer)
+    {
+        if (!timer.Start(*this))
+        {
+            return false;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (;;)
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            if (elapsed >= duration)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::min(config_.drain_period, duration - elapsed));
+            Drain();
+        }
+        timer.Stop();
+        Drain();
+        return WriteFolded(out, namer);
+    }
+
+    std::uint32_t SamplingProfiler::Samples() const
+    {
+        return samples_;
+    }
+
+    std::uint32_t SamplingProfiler::Dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    void SamplingProfiler::Drain()
+    {
+        ProfileSample batch[32];
+        for (const std::unique_ptr<SampleRing>& ring : rings_)
+        {
+            std::size_t count = 0U;
+            while ((count = ring->Pop(batch, sizeof(batch) / sizeof(batch[0]))) > 0U)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    counts_[SampleKey(batch[i].task, batch[i].pc)]++;
+                }
+                samples_ += static_cast<std::uint32_t>(count);
+            }
+        }
+    }
+
+    bool SamplingProfiler::WriteFolded(const Writer& out, const FrameNamer& namer) const
+    {
+        // Hottest first, so a truncated download still holds what matters
+        std::vector<std::pair<const SampleKey*, std::uint32_t>> sorted;
+        sorted.reserve(counts_.size());
+        for (const auto& [key, count] : counts_)
+        {
+            sorted.emplace_back(&key, count);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second;
+        });
+
+        std::string chunk;
+        auto        flush = [&chunk, &out](std::size_t threshold) {
+            if (chunk.size() < threshold || chunk.empty())
+            {
+                return true;
+            }
+            const bool ok = out(chunk.data(), chunk.size());
+            chunk.clear();
+            return ok;
+        };
+
+        for (const auto& [key, count] : sorted)
+        {
+            AppendFrame(chunk, key->first.empty() ? std::string("[unknown]") : key->first);
+            if (key->second != 0U)
+            {
+                chunk.push_back(';');
+                AppendFrame(chunk, namer ? namer(key->second) : HexFrame(key->second));
+            }
+            chunk += ' ' + std::to_string(count) + '\n';
+            if (!flush(kWriteChunk))
+            {
+                return false;
+            }
+        }
+        const std::uint32_t dropped = Dropped();
+        if (dropped > 0U)
+        {
+            chunk += "[dropped] " + std::to_string(dropped) + '\n';
+        }
+        return flush(0U);
+    }
+
+}  // namespace custom::platform
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "platform/spsc_ring.h"
+
+namespace custom::platform
+{
+
+    /** Matches configMAX_TASK_NAME_LEN on the Tab5 and the 16-byte Linux thread name. */
+    constexpr std::size_t kProfileTaskNameLen = 16U;
+
+    /** What was running when one sampling tick fired. */
+    struct ProfileSample
+    {
+        std::uintptr_t pc                        = 0U;  // 0 when the interrupted PC is not visible
+        char           task[kProfileTaskNameLen] = {};
+    };
+
+    class SamplingProfiler;
+
+    /**
+     * @brief The platform's periodic interrupt or signal.
+     *
+     * While started it calls SamplingProfiler::Record() on every tick, once per core. Start()
+     * fails when another capture already holds the timer.
+     */
+    class ProfileTimer
+    {
+    public:
+        virtual ~ProfileTimer() = default;
+
+        virtual bool Start(SamplingProfiler& profiler) = 0;
+        virtual void Stop()                            = 0;
+    };
+
+    /**
+     * @brief Sampling CPU profiler producing folded stacks for flamegraph.pl.
+     *
+     * The tick side only copies the PC and task name into a per-core SPSC ring; the thread
+     * running Capture() drains the rings and counts identical samples. Frames are written as
+     * raw addresses ("lvgl;0x4001a2b4 57"), so symbols come from the ELF on the host rather
+     * than from tables on the device. A sample that finds its ring full is counted and shows
+     * up as a "[dropped]" line, so the totals still add up to the ticks taken.
+     */
+    class SamplingProfiler
+    {
+    public:
+        struct Config
+        {
+            std::size_t               cores         = 1U;
+            std::size_t               ring_capacity = 1024U;  // per core
+            std::chrono::milliseconds drain_period{100};
+        };
+
+        /** Turns a PC into a frame name; the default writes it as 0x-prefixed hex. */
+        using FrameNamer = std::function<std::string(std::uintptr_t pc)>;
+        /** Receives the folded output in chunks. Returns false to stop writing. */
+        using Writer = std::function<bool(const char* data, std::size_t len)>;
+
+        explicit SamplingProfiler(Config config);
+
+        SamplingProfiler(const SamplingProfiler&)            = delete;
+        SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+        /**
+         * Tick side: wait-free and allocation-free, safe from an interrupt or signal handler.
+         * At most one caller per @p core at a time.
+         */
+        void Record(std::size_t core, std::uintptr_t pc, const char* task);
+
+        /**
+         * Samples through @p timer for @p duration and writes the folded profile to @p out.
+         * Blocks the calling thread. Returns false if the timer could not be started or the
+         * writer gave up.
+         */
+        bool Capture(ProfileTimer&             timer,
+                     std::chrono::milliseconds duration,
+                     const Writer&             out,
+                     const FrameNamer&         namer = nullptr);
+
+        std::uint32_t Samples() const;
+        std::uint32_t Dropped() const;
+
+    private:
+        using SampleRing = SpscRing<ProfileSample>;
+        using SampleKey  = std::pair<std::string, std::uintptr_t>;  // task, pc
+
+        void Drain();
+        bool WriteFolded(const Writer& out, const FrameNamer& namer) const;
+
+        Config                                   config_;
+        std::vector<std::unique_ptr<SampleRing>> rings_;
+        std::atomic<std::uint32_t>               dropped_{0U};
+        std::uint32_t                            samples_ = 0U;
+        std::map<SampleKey, std::uint32_t>       counts_;
+    };
+
+}  // namespace custom::platform
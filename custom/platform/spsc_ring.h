@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Wait-free single-producer/single-consumer ring of trivially copyable elements.
+     *
+     * Exactly one thread may call the producer methods (Push/Free/WriteSpan/CommitWrite) and
+     * exactly one thread the consumer methods (Pop/Size/ReadSpan/CommitRead). Indices run
+     * freely and are masked on access, so the full power-of-two capacity is usable.
+     */
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing requires trivial elements");
+
+    public:
+        explicit SpscRing(std::size_t min_capacity)
+        {
+            std::size_t capacity = 1U;
+            while (capacity < min_capacity)
+            {
+                capacity <<= 1U;
+            }
+            buffer_   = std::make_unique<T[]>(capacity);
+            capacity_ = capacity;
+        }
+
+        SpscRing(const SpscRing&)            = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        std::size_t Capacity() const
+        {
+            return capacity_;
+        }
+
+        std::size_t Size() const
+        {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            return head - tail;
+        }
+
+        std::size_t Free() const
+        {
+            return capacity_ - Size();
+        }
+
+        bool Empty() const
+        {
+            return Size() == 0U;
+        }
+
+        /** Producer: copy up to @p count elements in, returns how many were accepted. */
+        std::size_t Push(const T* data, std::size_t count)
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            const std::size_t n    = std::min(count, capacity_ - (head - tail));
+            if (n == 0U)
+            {
+                return 0U;
+            }
+
+            const std::size_t offset = head & (capacity_ - 1U);
+            const std::size_t first  = std::min(n, capacity_ - offset);
+            std::copy(data, data + first, buffer_.get() + offset);
+            std::copy(data + first, data + n, buffer_.get());
+
+            head_.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        /** Consumer: copy up to @p count elements out, returns how many were taken. */
+        std::size_t Pop(T* out, std::size_t count)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            const std::size_t n    = std::min(count, head - tail);
+            if (n == 0U)
+            {
+                return 0U;
+            }
+
+            const std::size_t offset = tail & (capacity_ - 1U);
+            const std::size_t first  = std::min(n, capacity_ - offset);
+            std::copy(buffer_.get() + offset, buffer_.get() + offset + first, out);
+            std::copy(buffer_.get(), buffer_.get() + (n - first), out + first);
+
+            tail_.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        /** Contiguous run of elements inside the ring. */
+        struct Span
+        {
+            T*          data = nullptr;
+            std::size_t size = 0U;
+        };
+
+        /**
+         * Producer: the free space at the write position, for filling in place (e.g. a driver
+         * read). Stops at the end of the buffer, so it can be shorter than Free().
+         */
+        Span WriteSpan()
+        {
+            const std::size_t head   = head_.load(std::memory_order_relaxed);
+            const std::size_t tail   = tail_.load(std::memory_order_acquire);
+            const std::size_t offset = head & (capacity_ - 1U);
+            const std::size_t n      = std::min(capacity_ - (head - tail), capacity_ - offset);
+            return Span{buffer_.get() + offset, n};
+        }
+
+        /** Producer: publish @p count elements written through WriteSpan(). */
+        void CommitWrite(std::size_t count)
+        {
+            head_.store(head_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        }
+
+        /**
+         * Consumer: the filled elements at the read position, for draining in place (e.g. a
+         * driver write). Stops at the end of the buffer, so it can be shorter than Size().
+         */
+        Span ReadSpan()
+        {
+            const std::size_t tail   = tail_.load(std::memory_order_relaxed);
+            const std::size_t head   = head_.load(std::memory_order_acquire);
+            const std::size_t offset = tail & (capacity_ - 1U);
+            const std::size_t n      = std::min(head - tail, capacity_ - offset);
+            return Span{buffer_.get() + offset, n};
+        }
+
+        /** Consumer: release @p count elements read through ReadSpan(). */
+        void CommitRead(std::size_t count)
+        {
+            tail_.store(tail_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        }
+
+    private:
+        std::unique_ptr<T[]> buffer_;
+        std::size_t          capacity_ = 0U;
+
+        alignas(64) std::atomic<std::size_t> head_{0U};
+        alignas(64) std::atomic<std::size_t> tail_{0U};
+    };
+
+}  // namespace custom::platform
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace custom::platform
+{
+
+    /**
+     * @brief Lock-free latest-value-wins exchange between one producer and one consumer.
+     *
+     * The producer fills Back() and Publish()es it; the consumer Acquire()s the newest published
+     * slot and reads Front(). Neither side ever waits: a slot published twice before the consumer
+     * looks is simply replaced, and the consumer keeps its Front() until something newer exists.
+     * Slot 1 starts as Front(), slot 0 as Back().
+     */
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+
+        TripleBuffer(const T& back, const T& front, const T& spare) : slots_{back, front, spare}
+        {
+        }
+
+        TripleBuffer(const TripleBuffer&)            = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /* ---- Producer ---- */
+
+        T& Back()
+        {
+            return slots_[back_];
+        }
+
+        /** Hand Back() to the consumer; returns true if this replaced a slot it never saw. */
+        bool Publish()
+        {
+            const auto         next     = static_cast<std::uint8_t>(back_ | kFresh);
+            const std::uint8_t previous = middle_.exchange(next, std::memory_order_acq_rel);
+            back_ = previous & kIndexMask;
+            return (previous & kFresh) != 0U;
+        }
+
+        /* ---- Consumer ---- */
+
+        /** Swap in the newest published slot; returns false if nothing new arrived. */
+        bool Acquire()
+        {
+            if ((middle_.load(std::memory_order_acquire) & kFresh) == 0U)
+            {
+                return false;
+            }
+            // Only the consumer clears kFresh, so the slot is still fresh here.
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+            return true;
+        }
+
+        T& Front()
+        {
+            return slots_[front_];
+        }
+
+        std::size_t FrontIndex() const
+        {
+            return front_;
+        }
+
+        T& Slot(std::size_t index)
+        {
+            return slots_[index];
+        }
+
+    private:
+        static constexpr std::uint8_t kIndexMask = 0x03U;
+        static constexpr std::uint8_t kFresh     = 0x04U;
+
+        std::array<T, 3>          slots_{};
+        std::uint8_t              back_  = 0U;
+        std::uint8_t              front_ = 1U;
+        std::atomic<std::uint8_t> middle_{2U};
+    };
+
+}  // namespace custom::platform
@@ -7,6 +7,7 @@
 
 #include <string.h>
 
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 #include "../ui_wallpaper.h"
 #include "../widgets/ui_room_card.h"
@@ -361,7 +362,7 @@ update_events(ui_page_cctv_ctx_t* ctx, const ui_page_cctv_event_t* events, size_
     {
         lv_obj_t* placeholder = lv_label_create(ctx->events_row);
         lv_label_set_text(placeholder, "No recent activity");
-        lv_obj_set_style_text_font(placeholder, &lv_font_montserrat_18, LV_PART_MAIN);
+        lv_obj_set_style_text_font(placeholder, UI_FONT(18), LV_PART_MAIN);
         lv_obj_set_style_text_color(placeholder, ui_theme_color_muted(), LV_PART_MAIN);
 
         if (ctx->timeline_button != NULL)
@@ -417,7 +418,7 @@ update_events(ui_page_cctv_ctx_t* ctx, const ui_page_cctv_event_t* events, size_
         {
             lv_label_set_text(description, "No description");
         }
-        lv_obj_set_style_text_font(description, &lv_font_montserrat_18, LV_PART_MAIN);
+        lv_obj_set_style_text_font(description, UI_FONT(18), LV_PART_MAIN);
         lv_obj_set_style_text_color(description, ui_theme_color_on_surface(), LV_PART_MAIN);
         lv_label_set_long_mode(description, LV_LABEL_LONG_WRAP);
         lv_obj_set_width(description, LV_PCT(100));
@@ -470,7 +471,7 @@ update_events(ui_page_cctv_ctx_t* ctx, const ui_page_cctv_event_t* events, size_
 
         lv_obj_t* placeholder = lv_label_create(ctx->events_row);
         lv_label_set_text(placeholder, "No recent activity");
-        lv_obj_set_style_text_font(placeholder, &lv_font_montserrat_18, LV_PART_MAIN);
+        lv_obj_set_style_text_font(placeholder, UI_FONT(18), LV_PART_MAIN);
         lv_obj_set_style_text_color(placeholder, ui_theme_color_muted(), LV_PART_MAIN);
     }
 }
@@ -628,13 +629,13 @@ static lv_obj_t* create_toolbar(ui_page_cctv_ctx_t* ctx)
 
     lv_obj_t* prev_label = lv_label_create(prev_btn);
     lv_label_set_text(prev_label, LV_SYMBOL_LEFT " Prev");
-    lv_obj_set_style_text_font(prev_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(prev_label, UI_FONT(18), LV_PART_MAIN);
 
     lv_obj_add_event_cb(prev_btn, toolbar_button_cb, LV_EVENT_CLICKED, ctx);
 
     lv_obj_t* camera_label = lv_label_create(toolbar);
     lv_label_set_text(camera_label, "No cameras");
-    lv_obj_set_style_text_font(camera_label, &lv_font_montserrat_20, LV_PART_MAIN);
+    lv_obj_set_style_text_font(camera_label, UI_FONT(20), LV_PART_MAIN);
     lv_obj_set_style_text_color(camera_label, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     lv_obj_t* next_btn = lv_btn_create(toolbar);
@@ -648,7 +649,7 @@ static lv_obj_t* create_toolbar(ui_page_cctv_ctx_t* ctx)
 
     lv_obj_t* next_label = lv_label_create(next_btn);
     lv_label_set_text(next_label, "Next " LV_SYMBOL_RIGHT);
-    lv_obj_set_style_text_font(next_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(next_label, UI_FONT(18), LV_PART_MAIN);
 
     lv_obj_add_event_cb(next_btn, toolbar_button_cb, LV_EVENT_CLICKED, ctx);
 
@@ -665,7 +666,7 @@ static lv_obj_t* create_toolbar(ui_page_cctv_ctx_t* ctx)
 
     lv_obj_t* quality_label = lv_label_create(quality_btn);
     lv_label_set_text(quality_label, "Quality ▾");
-    lv_obj_set_style_text_font(quality_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(quality_label, UI_FONT(18), LV_PART_MAIN);
 
     lv_obj_add_event_cb(quality_btn, toolbar_button_cb, LV_EVENT_CLICKED, ctx);
 
@@ -682,7 +683,7 @@ static lv_obj_t* create_toolbar(ui_page_cctv_ctx_t* ctx)
 
     lv_obj_t* mute_label = lv_label_create(mute_btn);
     lv_label_set_text(mute_label, LV_SYMBOL_AUDIO " Mute");
-    lv_obj_set_style_text_font(mute_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(mute_label, UI_FONT(18), LV_PART_MAIN);
 
     lv_obj_add_event_cb(mute_btn, toolbar_button_cb, LV_EVENT_CLICKED, ctx);
 
@@ -736,7 +737,7 @@ static void create_camera_section(ui_page_cctv_ctx_t* ctx)
 
     ctx->stream_label = lv_label_create(ctx->video_container);
     lv_label_set_text(ctx->stream_label, "Live feed (stub)");
-    lv_obj_set_style_text_font(ctx->stream_label, &lv_font_montserrat_22, LV_PART_MAIN);
+    lv_obj_set_style_text_font(ctx->stream_label, UI_FONT(22), LV_PART_MAIN);
     lv_obj_set_style_text_color(ctx->stream_label, ui_theme_color_on_surface(), LV_PART_MAIN);
     lv_obj_center(ctx->stream_label);
 }
@@ -792,7 +793,7 @@ static void create_actions_section(ui_page_cctv_ctx_t* ctx)
 
         lv_obj_t* label = lv_label_create(button);
         lv_label_set_text(label, buttons[i].label);
-        lv_obj_set_style_text_font(label, &lv_font_montserrat_18, LV_PART_MAIN);
+        lv_obj_set_style_text_font(label, UI_FONT(18), LV_PART_MAIN);
 
         lv_obj_add_event_cb(button, action_button_cb, LV_EVENT_CLICKED, ctx);
         *buttons[i].slot = button;
@@ -815,7 +816,7 @@ static lv_obj_t* create_content(ui_page_cctv_ctx_t* ctx)
 
     lv_obj_t* title = lv_label_create(content);
     lv_label_set_text(title, "Frigate Security");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_32, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, UI_FONT(32), LV_PART_MAIN);
     lv_obj_set_style_text_color(title, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     ctx->content = content;
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 #include "../ui_wallpaper.h"
 #include "../widgets/ui_room_card.h"
@@ -32,11 +33,16 @@ typedef struct
     lv_obj_t*                  track_artist;
     lv_obj_t*                  track_source;
     lv_obj_t*                  album_art;
+    lv_obj_t*                  artwork;
     lv_obj_t*                  previous_btn;
     lv_obj_t*                  play_pause_btn;
     lv_obj_t*                  play_pause_label;
     lv_obj_t*                  next_btn;
     lv_obj_t*                  volume_slider;
+    lv_obj_t*                  progress_row;
+    lv_obj_t*                  progress_bar;
+    lv_obj_t*                  elapsed_label;
+    lv_obj_t*                  duration_label;
     ui_page_media_scene_slot_t scenes[UI_PAGE_MEDIA_MAX_SCENES];
     size_t                     scene_count;
     bool                       slider_updating;
@@ -213,6 +219,23 @@ static void ui_page_media_volume_cb(lv_event_t* event)
     ui_page_media_emit_event(ctx, UI_PAGE_MEDIA_SIGNAL_VOLUME, (uint8_t)value, NULL);
 }
 
+static void ui_page_media_format_time(char* buffer, size_t size, uint32_t seconds)
+{
+    if (seconds >= 3600U)
+    {
+        lv_snprintf(buffer,
+                    size,
+                    "%u:%02u:%02u",
+                    (unsigned)(seconds / 3600U),
+                    (unsigned)((seconds / 60U) % 60U),
+                    (unsigned)(seconds % 60U));
+    }
+    else
+    {
+        lv_snprintf(buffer, size, "%u:%02u", (unsigned)(seconds / 60U), (unsigned)(seconds % 60U));
+    }
+}
+
 static void ui_page_media_scene_cb(lv_event_t* event)
 {
     if (event == NULL)
@@ -359,8 +382,14 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
             lv_obj_set_style_bg_opa(ctx->album_art, LV_OPA_70, LV_PART_MAIN);
             lv_obj_set_style_radius(ctx->album_art, 16, LV_PART_MAIN);
             lv_obj_set_style_border_width(ctx->album_art, 0, LV_PART_MAIN);
+            lv_obj_set_style_clip_corner(ctx->album_art, true, LV_PART_MAIN);
             lv_obj_clear_flag(ctx->album_art, LV_OBJ_FLAG_SCROLLABLE);
 
+            ctx->artwork = lv_image_create(ctx->album_art);
+            lv_obj_set_size(ctx->artwork, 240, 240);
+            lv_image_set_inner_align(ctx->artwork, LV_IMAGE_ALIGN_CENTER);
+            lv_obj_add_flag(ctx->artwork, LV_OBJ_FLAG_HIDDEN);
+
             lv_obj_t* track_info = lv_obj_create(info_row);
             lv_obj_remove_style_all(track_info);
             lv_obj_set_width(track_info, LV_PCT(100));
@@ -373,24 +402,56 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
             lv_obj_set_flex_grow(track_info, 1);
 
             ctx->track_title = lv_label_create(track_info);
-            lv_obj_set_style_text_font(ctx->track_title, &lv_font_montserrat_26, LV_PART_MAIN);
+            lv_obj_set_style_text_font(ctx->track_title, UI_FONT(26), LV_PART_MAIN);
             lv_obj_set_style_text_color(
                 ctx->track_title, ui_theme_color_on_surface(), LV_PART_MAIN);
             lv_label_set_long_mode(ctx->track_title, LV_LABEL_LONG_WRAP);
             lv_obj_set_width(ctx->track_title, LV_PCT(100));
 
             ctx->track_artist = lv_label_create(track_info);
-            lv_obj_set_style_text_font(ctx->track_artist, &lv_font_montserrat_20, LV_PART_MAIN);
+            lv_obj_set_style_text_font(ctx->track_artist, UI_FONT(20), LV_PART_MAIN);
             lv_obj_set_style_text_color(ctx->track_artist, ui_theme_color_muted(), LV_PART_MAIN);
             lv_label_set_long_mode(ctx->track_artist, LV_LABEL_LONG_WRAP);
             lv_obj_set_width(ctx->track_artist, LV_PCT(100));
 
             ctx->track_source = lv_label_create(track_info);
-            lv_obj_set_style_text_font(ctx->track_source, &lv_font_montserrat_18, LV_PART_MAIN);
+            lv_obj_set_style_text_font(ctx->track_source, UI_FONT(18), LV_PART_MAIN);
             lv_obj_set_style_text_color(ctx->track_source, ui_theme_color_muted(), LV_PART_MAIN);
             lv_label_set_long_mode(ctx->track_source, LV_LABEL_LONG_WRAP);
             lv_obj_set_width(ctx->track_source, LV_PCT(100));
 
+            ctx->progress_row = lv_obj_create(track_info);
+            lv_obj_remove_style_all(ctx->progress_row);
+            lv_obj_set_size(ctx->progress_row, LV_PCT(100), LV_SIZE_CONTENT);
+            lv_obj_set_style_bg_opa(ctx->progress_row, LV_OPA_TRANSP, LV_PART_MAIN);
+            lv_obj_set_style_pad_gap(ctx->progress_row, 12, LV_PART_MAIN);
+            lv_obj_set_flex_flow(ctx->progress_row, LV_FLEX_FLOW_ROW);
+            lv_obj_set_flex_align(ctx->progress_row,
+                                  LV_FLEX_ALIGN_START,
+                                  LV_FLEX_ALIGN_CENTER,
+                                  LV_FLEX_ALIGN_CENTER);
+            lv_obj_clear_flag(ctx->progress_row, LV_OBJ_FLAG_SCROLLABLE);
+            lv_obj_add_flag(ctx->progress_row, LV_OBJ_FLAG_HIDDEN);
+
+            ctx->elapsed_label = lv_label_create(ctx->progress_row);
+            lv_obj_set_style_text_font(ctx->elapsed_label, UI_FONT(16), LV_PART_MAIN);
+            lv_obj_set_style_text_color(ctx->elapsed_label, ui_theme_color_muted(), LV_PART_MAIN);
+
+            ctx->progress_bar = lv_bar_create(ctx->progress_row);
+            lv_obj_set_flex_grow(ctx->progress_bar, 1);
+            lv_obj_set_height(ctx->progress_bar, 6);
+            lv_obj_set_style_bg_color(ctx->progress_bar, ui_theme_color_muted(), LV_PART_MAIN);
+            lv_obj_set_style_bg_opa(ctx->progress_bar, LV_OPA_30, LV_PART_MAIN);
+            lv_obj_set_style_radius(ctx->progress_bar, 3, LV_PART_MAIN);
+            lv_obj_set_style_bg_color(
+                ctx->progress_bar, ui_theme_color_accent(), LV_PART_INDICATOR);
+            lv_obj_set_style_bg_opa(ctx->progress_bar, LV_OPA_COVER, LV_PART_INDICATOR);
+            lv_obj_set_style_radius(ctx->progress_bar, 3, LV_PART_INDICATOR);
+
+            ctx->duration_label = lv_label_create(ctx->progress_row);
+            lv_obj_set_style_text_font(ctx->duration_label, UI_FONT(16), LV_PART_MAIN);
+            lv_obj_set_style_text_color(ctx->duration_label, ui_theme_color_muted(), LV_PART_MAIN);
+
             lv_obj_t* transport_row = lv_obj_create(card_obj);
             lv_obj_remove_style_all(transport_row);
             lv_obj_set_width(transport_row, LV_PCT(100));
@@ -408,7 +469,7 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
             lv_obj_t* prev_label = lv_label_create(ctx->previous_btn);
             lv_label_set_text(prev_label, "Prev");
             lv_obj_center(prev_label);
-            lv_obj_set_style_text_font(prev_label, &lv_font_montserrat_18, LV_PART_MAIN);
+            lv_obj_set_style_text_font(prev_label, UI_FONT(18), LV_PART_MAIN);
             lv_obj_set_style_text_color(prev_label, lv_color_white(), LV_PART_MAIN);
 
             ctx->play_pause_btn = lv_btn_create(transport_row);
@@ -418,7 +479,7 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
             ctx->play_pause_label = lv_label_create(ctx->play_pause_btn);
             lv_label_set_text(ctx->play_pause_label, "Play");
             lv_obj_center(ctx->play_pause_label);
-            lv_obj_set_style_text_font(ctx->play_pause_label, &lv_font_montserrat_18, LV_PART_MAIN);
+            lv_obj_set_style_text_font(ctx->play_pause_label, UI_FONT(18), LV_PART_MAIN);
             lv_obj_set_style_text_color(ctx->play_pause_label, lv_color_white(), LV_PART_MAIN);
 
             ctx->next_btn = lv_btn_create(transport_row);
@@ -427,7 +488,7 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
             lv_obj_t* next_label = lv_label_create(ctx->next_btn);
             lv_label_set_text(next_label, "Next");
             lv_obj_center(next_label);
-            lv_obj_set_style_text_font(next_label, &lv_font_montserrat_18, LV_PART_MAIN);
+            lv_obj_set_style_text_font(next_label, UI_FONT(18), LV_PART_MAIN);
             lv_obj_set_style_text_color(next_label, lv_color_white(), LV_PART_MAIN);
 
             ctx->volume_slider = lv_slider_create(transport_row);
@@ -488,8 +549,7 @@ lv_obj_t* ui_page_media_create(lv_obj_t* parent)
                 ui_page_media_configure_scene_button(ctx->scenes[i].button);
                 ctx->scenes[i].label = lv_label_create(ctx->scenes[i].button);
                 lv_obj_center(ctx->scenes[i].label);
-                lv_obj_set_style_text_font(
-                    ctx->scenes[i].label, &lv_font_montserrat_18, LV_PART_MAIN);
+                lv_obj_set_style_text_font(ctx->scenes[i].label, UI_FONT(18), LV_PART_MAIN);
                 lv_obj_set_style_text_color(
                     ctx->scenes[i].label, ui_theme_color_on_surface(), LV_PART_MAIN);
                 lv_obj_add_event_cb(
@@ -548,6 +608,16 @@ lv_obj_t* ui_page_media_get_volume_slider(void)
     return (s_ctx != NULL) ? s_ctx->volume_slider : NULL;
 }
 
+lv_obj_t* ui_page_media_get_progress_bar(void)
+{
+    return (s_ctx != NULL) ? s_ctx->progress_bar : NULL;
+}
+
+lv_obj_t* ui_page_media_get_artwork(void)
+{
+    return (s_ctx != NULL) ? s_ctx->artwork : NULL;
+}
+
 lv_obj_t* ui_page_media_get_scene_button(size_t index)
 {
     if (s_ctx == NULL || index >= UI_PAGE_MEDIA_MAX_SCENES)
@@ -608,6 +678,32 @@ void ui_page_media_set_now_playing(const ui_page_media_now_playing_t* now_playin
         lv_slider_set_value(s_ctx->volume_slider, volume, LV_ANIM_OFF);
         s_ctx->slider_updating = false;
     }
+
+    uint32_t duration = (now_playing != NULL) ? now_playing->duration_s : 0U;
+    if (s_ctx->progress_row != NULL)
+    {
+        if (duration == 0U)
+        {
+            lv_obj_add_flag(s_ctx->progress_row, LV_OBJ_FLAG_HIDDEN);
+        }
+        else
+        {
+            uint32_t position = now_playing->position_s;
+            if (position > duration)
+            {
+                position = duration;
+            }
+
+            char text[16];
+            ui_page_media_format_time(text, sizeof(text), position);
+            lv_label_set_text(s_ctx->elapsed_label, text);
+            ui_page_media_format_time(text, sizeof(text), duration);
+            lv_label_set_text(s_ctx->duration_label, text);
+            lv_bar_set_range(s_ctx->progress_bar, 0, (int32_t)duration);
+            lv_bar_set_value(s_ctx->progress_bar, (int32_t)position, LV_ANIM_OFF);
+            lv_obj_clear_flag(s_ctx->progress_row, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
 }
 
 void ui_page_media_set_quick_scenes(const ui_page_media_scene_t* scenes, size_t scene_count)
@@ -642,3 +738,21 @@ void ui_page_media_set_quick_scenes(const ui_page_media_scene_t* scenes, size_t
 
     s_ctx->scene_count = count;
 }
+
+void ui_page_media_set_artwork(const lv_image_dsc_t* image)
+{
+    if (s_ctx == NULL || s_ctx->artwork == NULL)
+    {
+        return;
+    }
+
+    if (image == NULL)
+    {
+        lv_obj_add_flag(s_ctx->artwork, LV_OBJ_FLAG_HIDDEN);
+        lv_image_set_src(s_ctx->artwork, NULL);
+        return;
+    }
+
+    lv_image_set_src(s_ctx->artwork, image);
+    lv_obj_clear_flag(s_ctx->artwork, LV_OBJ_FLAG_HIDDEN);
+}
@@ -53,6 +53,8 @@ extern "C"
         const char* source;
         bool        playing;
         uint8_t     volume;
+        uint32_t    position_s;
+        uint32_t    duration_s; /* 0 hides the progress bar */
     } ui_page_media_now_playing_t;
 
     typedef struct
@@ -70,11 +72,16 @@ extern "C"
     lv_obj_t* ui_page_media_get_play_pause_button(void);
     lv_obj_t* ui_page_media_get_next_button(void);
     lv_obj_t* ui_page_media_get_volume_slider(void);
+    lv_obj_t* ui_page_media_get_progress_bar(void);
+    lv_obj_t* ui_page_media_get_artwork(void);
     lv_obj_t* ui_page_media_get_scene_button(size_t index);
     size_t    ui_page_media_get_scene_count(void);
 
     void ui_page_media_set_now_playing(const ui_page_media_now_playing_t* now_playing);
     void ui_page_media_set_quick_scenes(const ui_page_media_scene_t* scenes, size_t scene_count);
+    /* RGB565 at most 240x240, centred on the album art card; NULL shows the bare card. The page
+     * keeps the pointer, so the image must stay valid until replaced. */
+    void ui_page_media_set_artwork(const lv_image_dsc_t* image);
 
 #ifdef __cplusplus
 }
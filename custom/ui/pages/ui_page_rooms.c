@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "../../integration/rooms_provider.h"
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 #include "../ui_wallpaper.h"
 #include "../widgets/ui_room_card.h"
@@ -40,8 +41,11 @@ typedef struct
         const char* room_id;
         const char* entity_id;
     } slots[ROOM_CARD_COUNT];
-    ui_wallpaper_t* wallpaper;
-    bool            intro_played;
+    ui_wallpaper_t*         wallpaper;
+    bool                    intro_played;
+    ui_page_rooms_actions_t actions;
+    void*                   actions_user_data;
+    bool                    actions_bound;
 } ui_page_rooms_ctx_t;
 
 static ui_page_rooms_ctx_t* s_ctx = NULL;
@@ -158,6 +162,11 @@ static void toggle_clicked_cb(lv_event_t* event)
         .entity_id = ui_room_card_get_entity_id(card),
     };
 
+    if (s_ctx->actions_bound && s_ctx->actions.toggle != NULL && data.entity_id != NULL)
+    {
+        s_ctx->actions.toggle(data.room_id, data.entity_id, s_ctx->actions_user_data);
+    }
+
     lv_obj_send_event(s_ctx->page, UI_PAGE_ROOMS_EVENT_TOGGLE, &data);
 }
 
@@ -304,7 +313,7 @@ static lv_obj_t* create_content(lv_obj_t* page, ui_page_rooms_ctx_t* ctx)
 
     lv_obj_t* title = lv_label_create(ctx->toolbar);
     lv_label_set_text(title, "Rooms");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_32, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, UI_FONT(32), LV_PART_MAIN);
     lv_obj_set_style_text_color(title, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     create_cards(ctx);
@@ -348,6 +357,28 @@ lv_obj_t* ui_page_rooms_create(lv_obj_t* parent)
     return page;
 }
 
+void ui_page_rooms_set_actions(const ui_page_rooms_actions_t* actions, void* user_data)
+{
+    ui_page_rooms_ctx_t* ctx = s_ctx;
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    if (actions != NULL)
+    {
+        ctx->actions           = *actions;
+        ctx->actions_bound     = true;
+        ctx->actions_user_data = user_data;
+    }
+    else
+    {
+        lv_memset(&ctx->actions, 0, sizeof(ctx->actions));
+        ctx->actions_bound     = false;
+        ctx->actions_user_data = NULL;
+    }
+}
+
 void ui_page_rooms_set_state(const rooms_state_t* state)
 {
     if (s_ctx == NULL)
@@ -363,6 +394,23 @@ void ui_page_rooms_set_state(const rooms_state_t* state)
     }
 }
 
+void ui_page_rooms_set_room(const room_t* room)
+{
+    if (s_ctx == NULL || room == NULL || room->room_id == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < ROOM_CARD_COUNT; i++)
+    {
+        if (s_ctx->slots[i].room_id != NULL && strcmp(s_ctx->slots[i].room_id, room->room_id) == 0)
+        {
+            apply_room_to_card(s_ctx, i, room);
+            return;
+        }
+    }
+}
+
 static ui_room_card_t* find_card_by_room(const char* room_id)
 {
     if (s_ctx == NULL || room_id == NULL)
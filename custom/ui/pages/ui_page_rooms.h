@@ -42,8 +42,17 @@ extern "C"
 #define UI_PAGE_ROOMS_EVENT_TOGGLE     ((lv_event_code_t)(LV_EVENT_LAST + 1))
 #define UI_PAGE_ROOMS_EVENT_OPEN_SHEET ((lv_event_code_t)(LV_EVENT_LAST + 2))
 
+    typedef struct ui_page_rooms_actions_t
+    {
+        /** Tap on a card's toggle; the event is still sent to the page as well. */
+        void (*toggle)(const char* room_id, const char* entity_id, void* user_data);
+    } ui_page_rooms_actions_t;
+
     lv_obj_t* ui_page_rooms_create(lv_obj_t* parent);
+    void      ui_page_rooms_set_actions(const ui_page_rooms_actions_t* actions, void* user_data);
     void      ui_page_rooms_set_state(const rooms_state_t* state);
+    /** Refresh only the card showing @p room; rooms without a card are ignored. */
+    void      ui_page_rooms_set_room(const room_t* room);
     lv_obj_t* ui_page_rooms_get_card(const char* room_id);
     lv_obj_t* ui_page_rooms_get_toggle(const char* room_id);
 
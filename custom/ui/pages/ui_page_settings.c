@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 #include "../ui_wallpaper.h"
 
@@ -214,7 +215,7 @@ static lv_obj_t* create_section_card(lv_obj_t* parent, const char* title, const
     {
         lv_obj_t* title_label = lv_label_create(card);
         lv_label_set_text(title_label, title);
-        lv_obj_set_style_text_font(title_label, &lv_font_montserrat_28, LV_PART_MAIN);
+        lv_obj_set_style_text_font(title_label, UI_FONT(28), LV_PART_MAIN);
         lv_obj_set_style_text_color(title_label, ui_theme_color_on_surface(), LV_PART_MAIN);
     }
 
@@ -222,7 +223,7 @@ static lv_obj_t* create_section_card(lv_obj_t* parent, const char* title, const
     {
         lv_obj_t* subtitle_label = lv_label_create(card);
         lv_label_set_text(subtitle_label, subtitle);
-        lv_obj_set_style_text_font(subtitle_label, &lv_font_montserrat_18, LV_PART_MAIN);
+        lv_obj_set_style_text_font(subtitle_label, UI_FONT(18), LV_PART_MAIN);
         lv_obj_set_style_text_color(subtitle_label, ui_theme_color_muted(), LV_PART_MAIN);
         lv_label_set_long_mode(subtitle_label, LV_LABEL_LONG_WRAP);
         lv_obj_set_width(subtitle_label, LV_PCT(100));
@@ -246,7 +247,7 @@ static lv_obj_t* create_setting_row(lv_obj_t* parent, const char* label_text)
     {
         lv_obj_t* label = lv_label_create(row);
         lv_label_set_text(label, label_text);
-        lv_obj_set_style_text_font(label, &lv_font_montserrat_20, LV_PART_MAIN);
+        lv_obj_set_style_text_font(label, UI_FONT(20), LV_PART_MAIN);
         lv_obj_set_style_text_color(label, ui_theme_color_on_surface(), LV_PART_MAIN);
         lv_obj_set_width(label, LV_PCT(40));
     }
@@ -274,7 +275,7 @@ static lv_obj_t* create_action_button(lv_obj_t* parent, const char* title, const
 
     lv_obj_t* title_label = lv_label_create(button);
     lv_label_set_text(title_label, title != NULL ? title : "Action");
-    lv_obj_set_style_text_font(title_label, &lv_font_montserrat_20, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title_label, UI_FONT(20), LV_PART_MAIN);
     lv_obj_set_style_text_color(title_label, ui_theme_color_on_surface(), LV_PART_MAIN);
     lv_label_set_long_mode(title_label, LV_LABEL_LONG_WRAP);
     lv_obj_set_width(title_label, LV_PCT(100));
@@ -283,7 +284,7 @@ static lv_obj_t* create_action_button(lv_obj_t* parent, const char* title, const
     {
         lv_obj_t* desc_label = lv_label_create(button);
         lv_label_set_text(desc_label, description);
-        lv_obj_set_style_text_font(desc_label, &lv_font_montserrat_16, LV_PART_MAIN);
+        lv_obj_set_style_text_font(desc_label, UI_FONT(16), LV_PART_MAIN);
         lv_obj_set_style_text_color(desc_label, ui_theme_color_muted(), LV_PART_MAIN);
         lv_label_set_long_mode(desc_label, LV_LABEL_LONG_WRAP);
         lv_obj_set_width(desc_label, LV_PCT(100));
@@ -331,7 +332,7 @@ static void build_connectivity_section(ui_page_settings_ctx_t* ctx)
 
         lv_obj_t* title = lv_label_create(button);
         lv_label_set_text(title, tester->label);
-        lv_obj_set_style_text_font(title, &lv_font_montserrat_22, LV_PART_MAIN);
+        lv_obj_set_style_text_font(title, UI_FONT(22), LV_PART_MAIN);
         lv_obj_set_style_text_color(title, lv_color_hex(0xe6edf3), LV_PART_MAIN);
 
         lv_obj_t* pill = lv_obj_create(button);
@@ -346,7 +347,7 @@ static void build_connectivity_section(ui_page_settings_ctx_t* ctx)
         lv_obj_clear_flag(pill, LV_OBJ_FLAG_SCROLLABLE);
 
         lv_obj_t* pill_label = lv_label_create(pill);
-        lv_obj_set_style_text_font(pill_label, &lv_font_montserrat_16, LV_PART_MAIN);
+        lv_obj_set_style_text_font(pill_label, UI_FONT(16), LV_PART_MAIN);
         lv_obj_set_style_text_color(pill_label, lv_color_hex(0x0f172a), LV_PART_MAIN);
 
         tester->pill       = pill;
@@ -387,7 +388,7 @@ static void build_theme_section(ui_page_settings_ctx_t* ctx)
 
     lv_obj_t* value_label = lv_label_create(brightness_row);
     lv_label_set_text(value_label, "75%");
-    lv_obj_set_style_text_font(value_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(value_label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(value_label, ui_theme_color_on_surface(), LV_PART_MAIN);
     ctx->brightness_value = value_label;
 }
@@ -424,7 +425,7 @@ static void build_updates_section(ui_page_settings_ctx_t* ctx)
 
     ctx->ota_status_label = lv_label_create(card);
     lv_label_set_text(ctx->ota_status_label, "Idle");
-    lv_obj_set_style_text_font(ctx->ota_status_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(ctx->ota_status_label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(ctx->ota_status_label, ui_theme_color_muted(), LV_PART_MAIN);
     lv_obj_set_width(ctx->ota_status_label, LV_PCT(100));
     lv_snprintf(ctx->ota_status_text, sizeof(ctx->ota_status_text), "%s", "Idle");
@@ -454,7 +455,7 @@ static void build_diagnostics_section(ui_page_settings_ctx_t* ctx)
 
     ctx->diagnostics_status_label = lv_label_create(card);
     lv_label_set_text(ctx->diagnostics_status_label, "Idle");
-    lv_obj_set_style_text_font(ctx->diagnostics_status_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(ctx->diagnostics_status_label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(
         ctx->diagnostics_status_label, ui_theme_color_muted(), LV_PART_MAIN);
     lv_obj_set_width(ctx->diagnostics_status_label, LV_PCT(100));
@@ -485,7 +486,7 @@ static void build_backup_section(ui_page_settings_ctx_t* ctx)
 
     ctx->backup_status_label = lv_label_create(card);
     lv_label_set_text(ctx->backup_status_label, "Idle");
-    lv_obj_set_style_text_font(ctx->backup_status_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(ctx->backup_status_label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(ctx->backup_status_label, ui_theme_color_muted(), LV_PART_MAIN);
     lv_obj_set_width(ctx->backup_status_label, LV_PCT(100));
     lv_snprintf(ctx->backup_status_text, sizeof(ctx->backup_status_text), "%s", "Idle");
@@ -5,6 +5,7 @@
  */
 #include "ui_page_weather.h"
 
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 #include "../ui_wallpaper.h"
 #include "../widgets/ui_room_card.h"
@@ -21,12 +22,12 @@ static lv_obj_t* create_metric_block(lv_obj_t* parent, const char* title, const
 
     lv_obj_t* title_label = lv_label_create(block);
     lv_label_set_text(title_label, title != NULL ? title : "");
-    lv_obj_set_style_text_font(title_label, &lv_font_montserrat_16, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title_label, UI_FONT(16), LV_PART_MAIN);
     lv_obj_set_style_text_color(title_label, ui_theme_color_muted(), LV_PART_MAIN);
 
     lv_obj_t* value_label = lv_label_create(block);
     lv_label_set_text(value_label, value != NULL ? value : "");
-    lv_obj_set_style_text_font(value_label, &lv_font_montserrat_22, LV_PART_MAIN);
+    lv_obj_set_style_text_font(value_label, UI_FONT(22), LV_PART_MAIN);
     lv_obj_set_style_text_color(value_label, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     return block;
@@ -52,17 +53,17 @@ create_forecast_item(lv_obj_t* parent, const char* day, const char* icon, const
 
     lv_obj_t* day_label = lv_label_create(item);
     lv_label_set_text(day_label, day != NULL ? day : "");
-    lv_obj_set_style_text_font(day_label, &lv_font_montserrat_16, LV_PART_MAIN);
+    lv_obj_set_style_text_font(day_label, UI_FONT(16), LV_PART_MAIN);
     lv_obj_set_style_text_color(day_label, ui_theme_color_muted(), LV_PART_MAIN);
 
     lv_obj_t* icon_label = lv_label_create(item);
     lv_label_set_text(icon_label, icon != NULL ? icon : LV_SYMBOL_MINUS);
-    lv_obj_set_style_text_font(icon_label, &lv_font_montserrat_28, LV_PART_MAIN);
+    lv_obj_set_style_text_font(icon_label, UI_FONT(28), LV_PART_MAIN);
     lv_obj_set_style_text_color(icon_label, ui_theme_color_accent(), LV_PART_MAIN);
 
     lv_obj_t* range_label = lv_label_create(item);
     lv_label_set_text(range_label, range != NULL ? range : "");
-    lv_obj_set_style_text_font(range_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(range_label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(range_label, ui_theme_color_on_surface(), LV_PART_MAIN);
 }
 
@@ -116,7 +117,7 @@ static lv_obj_t* ui_page_create_content(lv_obj_t* page, const char* title_text)
     lv_label_set_text(title, title_text != NULL ? title_text : "");
     lv_obj_set_width(title, LV_PCT(100));
     lv_obj_set_style_text_align(title, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN);
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_32, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, UI_FONT(32), LV_PART_MAIN);
     lv_obj_set_style_text_color(title, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     weather_temperature_unit_t unit = weather_formatter_get_preferred_temperature_unit();
@@ -225,7 +226,7 @@ static lv_obj_t* ui_page_create_content(lv_obj_t* page, const char* title_text)
 
     lv_obj_t* forecast_label = lv_label_create(content);
     lv_label_set_text(forecast_label, "Forecast");
-    lv_obj_set_style_text_font(forecast_label, &lv_font_montserrat_24, LV_PART_MAIN);
+    lv_obj_set_style_text_font(forecast_label, UI_FONT(24), LV_PART_MAIN);
     lv_obj_set_style_text_color(forecast_label, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     lv_obj_t* forecast = lv_obj_create(content);
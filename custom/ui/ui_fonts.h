@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#ifdef __has_include
+#    if __has_include("lvgl.h")
+#        ifndef LV_LVGL_H_INCLUDE_SIMPLE
+#            define LV_LVGL_H_INCLUDE_SIMPLE
+#        endif
+#    endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#    include "lvgl.h"
+#else
+#    include "lvgl/lvgl.h"
+#endif
+
+// `make fonts` (tools/gen_font_subset.py) writes Montserrat subsets holding only the glyphs
+// custom/ui can show into custom/ui/fonts/, together with ui_font_subset.h, which defines
+// UI_FONT_SUBSET and declares them. Without it the UI uses LVGL's built-in fonts.
+#ifdef __has_include
+#    if __has_include("fonts/ui_font_subset.h")
+#        include "fonts/ui_font_subset.h"
+#    endif
+#endif
+
+#if defined(UI_FONT_SUBSET)
+#    define UI_FONT(size) (&ui_font_montserrat_##size)
+#else
+#    define UI_FONT(size) (&lv_font_montserrat_##size)
+#endif
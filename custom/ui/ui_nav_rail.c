@@ -7,10 +7,13 @@
 
 #include <stddef.h>
 
+#include "ui_fonts.h"
+
 struct ui_nav_rail_t
 {
     lv_obj_t*              container;
     lv_obj_t*              buttons[UI_NAV_PAGE_COUNT];
+    lv_obj_t*              icons[UI_NAV_PAGE_COUNT];
     ui_nav_page_t          active;
     ui_nav_rail_callback_t callback;
     void*                  user_data;
@@ -86,11 +89,11 @@ static void ui_nav_apply_button_style(lv_obj_t* button)
     lv_obj_set_flex_align(button, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 }
 
-static void ui_nav_add_button_content(lv_obj_t* button, uint32_t index)
+static lv_obj_t* ui_nav_add_button_content(lv_obj_t* button, uint32_t index)
 {
     lv_obj_t* icon = lv_label_create(button);
     lv_label_set_text(icon, k_nav_icons[index]);
-    lv_obj_set_style_text_font(icon, &lv_font_montserrat_32, LV_PART_MAIN);
+    lv_obj_set_style_text_font(icon, UI_FONT(32), LV_PART_MAIN);
     lv_obj_set_style_text_color(icon, lv_color_hex(0xe6edf3), LV_PART_MAIN);
 
     lv_obj_t* label = lv_label_create(button);
@@ -98,8 +101,10 @@ static void ui_nav_add_button_content(lv_obj_t* button, uint32_t index)
     lv_obj_set_width(label, LV_PCT(100));
     lv_label_set_text(label, k_nav_labels[index]);
     lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, UI_FONT(16), LV_PART_MAIN);
     lv_obj_set_style_text_color(label, lv_color_hex(0xcad3df), LV_PART_MAIN);
+
+    return icon;
 }
 
 static void ui_nav_rail_update_offsets(ui_nav_rail_t* rail)
@@ -179,7 +184,7 @@ ui_nav_rail_create(lv_obj_t* parent, ui_nav_rail_callback_t callback, void* user
         lv_obj_add_flag(button, LV_OBJ_FLAG_CHECKABLE);
         lv_obj_add_event_cb(button, ui_nav_button_event_cb, LV_EVENT_CLICKED, rail);
         ui_nav_apply_button_style(button);
-        ui_nav_add_button_content(button, i);
+        rail->icons[i]   = ui_nav_add_button_content(button, i);
         rail->buttons[i] = button;
     }
 
@@ -238,6 +243,23 @@ void ui_nav_rail_set_active(ui_nav_rail_t* rail, ui_nav_page_t page)
     }
 }
 
+void ui_nav_rail_set_icon(ui_nav_rail_t* rail, ui_nav_page_t page, const void* src)
+{
+    if (rail == NULL || page >= UI_NAV_PAGE_COUNT || src == NULL || rail->buttons[page] == NULL)
+    {
+        return;
+    }
+
+    lv_obj_t* image = lv_image_create(rail->buttons[page]);
+    lv_image_set_src(image, src);
+    lv_obj_move_to_index(image, 0);
+    if (rail->icons[page] != NULL)
+    {
+        lv_obj_del(rail->icons[page]);
+    }
+    rail->icons[page] = image;
+}
+
 lv_obj_t* ui_nav_rail_get_container(ui_nav_rail_t* rail)
 {
     if (rail == NULL)
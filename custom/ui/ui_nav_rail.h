@@ -51,6 +51,8 @@ extern "C"
     void       ui_nav_rail_hide(ui_nav_rail_t* rail, bool animate);
     bool       ui_nav_rail_is_visible(const ui_nav_rail_t* rail);
     lv_coord_t ui_nav_rail_get_hidden_offset(const ui_nav_rail_t* rail);
+    // Replace the page's symbol with an image; @p src must outlive the rail
+    void ui_nav_rail_set_icon(ui_nav_rail_t* rail, ui_nav_page_t page, const void* src);
 
 #ifdef __cplusplus
 }
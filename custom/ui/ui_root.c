@@ -5,11 +5,39 @@
  */
 #include "ui_root.h"
 
+#include "assets/asset_mount.h"
 #include "pages/ui_page_cctv.h"
 #include "pages/ui_page_media.h"
 #include "pages/ui_page_rooms.h"
 #include "pages/ui_page_settings.h"
 #include "pages/ui_page_weather.h"
+#include "ui_wallpaper.h"
+
+// Bundle ids are derived from paths under custom/assets/, so art in custom/assets/<page>/
+// belongs to that page (e.g. media/artwork_empty.png -> "media_artwork_empty").
+static const char* const k_page_asset_prefix[UI_NAV_PAGE_COUNT] = {
+    [UI_NAV_PAGE_ROOMS]    = "rooms_",
+    [UI_NAV_PAGE_CCTV]     = "cctv_",
+    [UI_NAV_PAGE_WEATHER]  = "weather_",
+    [UI_NAV_PAGE_MEDIA]    = "media_",
+    [UI_NAV_PAGE_SETTINGS] = "settings_",
+};
+
+// On screen all the time, so pinned: decoded once and never evicted while the root lives.
+// custom/assets/bg/wallpaper.png and custom/assets/nav/<page>.png; missing ones keep the
+// plain fill and the rail's symbols.
+static const char* const k_wallpaper_asset = "bg_wallpaper";
+
+static const char* const k_nav_icon_asset[UI_NAV_PAGE_COUNT] = {
+    [UI_NAV_PAGE_ROOMS]    = "nav_rooms",
+    [UI_NAV_PAGE_CCTV]     = "nav_cctv",
+    [UI_NAV_PAGE_WEATHER]  = "nav_weather",
+    [UI_NAV_PAGE_MEDIA]    = "nav_media",
+    [UI_NAV_PAGE_SETTINGS] = "nav_settings",
+};
+
+#define UI_ROOT_PAGE_ASSETS_MAX    16U
+#define UI_ROOT_PREFETCH_PERIOD_MS 20U
 
 struct ui_root_t
 {
@@ -20,6 +48,14 @@ struct ui_root_t
     lv_obj_t*      nav_scrim;
     lv_obj_t*      gesture_zone;
 
+    // Assets of the active page, referenced while it is shown
+    const char* page_assets[UI_ROOT_PAGE_ASSETS_MAX];
+    size_t      page_asset_count;
+
+    // Warms likely-next pages while the nav rail is open
+    asset_prefetch_t prefetch;
+    lv_timer_t*      prefetch_timer;
+
     // Edge-swipe + drag-to-reveal state
     bool       edge_swipe_active;
     bool       edge_swipe_triggered;
@@ -84,6 +120,76 @@ static void ui_root_nav_size_event_cb(lv_event_t* event)
     ui_root_update_nav_metrics(root);
 }
 
+static size_t ui_root_page_asset_ids(ui_nav_page_t page, const char** ids, size_t max)
+{
+    return assets_image_ids(k_page_asset_prefix[page], ids, max);
+}
+
+static bool ui_root_prefetch_is_ready(void* ctx, const char* id)
+{
+    LV_UNUSED(ctx);
+    return assets_image_ready(id);
+}
+
+static bool ui_root_prefetch_warm(void* ctx, const char* id)
+{
+    LV_UNUSED(ctx);
+    return assets_image_prefetch(id);
+}
+
+// One decode per tick, and none while the rail is still sliding in.
+static void ui_root_prefetch_timer_cb(lv_timer_t* timer)
+{
+    ui_root_t* root = (ui_root_t*)lv_timer_get_user_data(timer);
+    if (root == NULL || lv_anim_count_running() > 0U)
+    {
+        return;
+    }
+    if (!asset_prefetch_step(&root->prefetch))
+    {
+        lv_timer_pause(timer);
+    }
+}
+
+// Neighbours of the active page in rail order first, then the pages further away. Called on
+// every show; ids still queued from a previous call are not queued twice.
+static void ui_root_plan_prefetch(ui_root_t* root)
+{
+    for (int32_t distance = 1; distance < (int32_t)UI_NAV_PAGE_COUNT; distance++)
+    {
+        const int32_t candidates[2] = {(int32_t)root->active + distance,
+                                       (int32_t)root->active - distance};
+        for (uint32_t c = 0; c < 2U; c++)
+        {
+            if (candidates[c] < 0 || candidates[c] >= (int32_t)UI_NAV_PAGE_COUNT)
+            {
+                continue;
+            }
+            const char* ids[UI_ROOT_PAGE_ASSETS_MAX];
+            size_t      count =
+                ui_root_page_asset_ids((ui_nav_page_t)candidates[c], ids, UI_ROOT_PAGE_ASSETS_MAX);
+            for (size_t i = 0; i < count; i++)
+            {
+                asset_prefetch_enqueue(&root->prefetch, ids[i]);
+            }
+        }
+    }
+
+    if (root->prefetch_timer != NULL && asset_prefetch_pending(&root->prefetch))
+    {
+        lv_timer_resume(root->prefetch_timer);
+    }
+}
+
+static void ui_root_release_page_assets(ui_root_t* root)
+{
+    for (size_t i = 0; i < root->page_asset_count; i++)
+    {
+        assets_image_release(root->page_assets[i]);
+    }
+    root->page_asset_count = 0;
+}
+
 static void ui_root_nav_changed(ui_nav_rail_t* rail, ui_nav_page_t page, void* user_data)
 {
     LV_UNUSED(rail);
@@ -93,6 +199,22 @@ static void ui_root_nav_changed(ui_nav_rail_t* rail, ui_nav_page_t page, void* u
         return;
     }
 
+    const char* ids[UI_ROOT_PAGE_ASSETS_MAX];
+    size_t      count = ui_root_page_asset_ids(page, ids, UI_ROOT_PAGE_ASSETS_MAX);
+    asset_prefetch_commit(&root->prefetch, ids, count);
+    if (root->prefetch_timer != NULL)
+    {
+        lv_timer_pause(root->prefetch_timer);
+    }
+
+    const asset_prefetch_stats_t* stats = &root->prefetch.stats;
+    LV_LOG_INFO("prefetch: %u%% hit rate, %u/%u decode-free commits, %u warmed, %u cancelled",
+                (unsigned)asset_prefetch_hit_rate(stats),
+                (unsigned)stats->decode_free_commits,
+                (unsigned)stats->commits,
+                (unsigned)stats->warmed,
+                (unsigned)stats->cancelled);
+
     ui_root_show_page(root, page);
     ui_root_hide_nav(root, true);
 }
@@ -273,6 +395,27 @@ static void ui_root_nav_gesture_cb(lv_event_t* event)
     }
 }
 
+// Before the pages are built, so every page's wallpaper picks up the pinned image
+static void ui_root_pin_chrome(ui_root_t* root)
+{
+    ui_wallpaper_set_image(assets_image_pin(k_wallpaper_asset));
+    for (uint32_t i = 0; i < UI_NAV_PAGE_COUNT; i++)
+    {
+        ui_nav_rail_set_icon(root->nav, (ui_nav_page_t)i, assets_image_pin(k_nav_icon_asset[i]));
+    }
+}
+
+// After the pages and the rail are gone; nothing draws the pinned images any more
+static void ui_root_unpin_chrome(void)
+{
+    ui_wallpaper_set_image(NULL);
+    assets_image_unpin(k_wallpaper_asset);
+    for (uint32_t i = 0; i < UI_NAV_PAGE_COUNT; i++)
+    {
+        assets_image_unpin(k_nav_icon_asset[i]);
+    }
+}
+
 static void ui_root_create_pages(ui_root_t* root)
 {
     root->pages[UI_NAV_PAGE_ROOMS]    = ui_page_rooms_create(root->screen);
@@ -303,13 +446,31 @@ ui_root_t* ui_root_create(void)
 
     root->screen = lv_screen_active();
 
+    const asset_prefetch_ops_t prefetch_ops = {
+        .is_ready = ui_root_prefetch_is_ready,
+        .warm     = ui_root_prefetch_warm,
+        .ctx      = NULL,
+    };
+    asset_prefetch_init(&root->prefetch, &prefetch_ops);
+    root->prefetch_timer =
+        lv_timer_create(ui_root_prefetch_timer_cb, UI_ROOT_PREFETCH_PERIOD_MS, root);
+    if (root->prefetch_timer != NULL)
+    {
+        lv_timer_pause(root->prefetch_timer);
+    }
+
     root->nav = ui_nav_rail_create(root->screen, ui_root_nav_changed, root);
     if (root->nav == NULL)
     {
+        if (root->prefetch_timer != NULL)
+        {
+            lv_timer_delete(root->prefetch_timer);
+        }
         lv_free(root);
         return NULL;
     }
 
+    ui_root_pin_chrome(root);
     ui_root_create_pages(root);
 
     // Scrim behind nav
@@ -376,6 +537,14 @@ void ui_root_destroy(ui_root_t* root)
         return;
     }
 
+    if (root->prefetch_timer != NULL)
+    {
+        lv_timer_delete(root->prefetch_timer);
+        root->prefetch_timer = NULL;
+    }
+    asset_prefetch_cancel(&root->prefetch);
+    ui_root_release_page_assets(root);
+
     for (uint32_t i = 0; i < UI_NAV_PAGE_COUNT; i++)
     {
         if (root->pages[i] != NULL)
@@ -403,6 +572,7 @@ void ui_root_destroy(ui_root_t* root)
         root->nav_scrim = NULL;
     }
 
+    ui_root_unpin_chrome();
     lv_free(root);
 }
 
@@ -431,6 +601,17 @@ void ui_root_show_page(ui_root_t* root, ui_nav_page_t page)
         }
     }
 
+    // Reference the new page's assets before dropping the old ones so shared images stay put.
+    const char* ids[UI_ROOT_PAGE_ASSETS_MAX];
+    size_t      count = ui_root_page_asset_ids(page, ids, UI_ROOT_PAGE_ASSETS_MAX);
+    for (size_t i = 0; i < count; i++)
+    {
+        assets_image_acquire(ids[i]);
+    }
+    ui_root_release_page_assets(root);
+    lv_memcpy(root->page_assets, ids, count * sizeof(ids[0]));
+    root->page_asset_count = count;
+
     lv_obj_move_foreground(ui_nav_rail_get_container(root->nav));
     ui_nav_rail_set_active(root->nav, page);
     root->active = page;
@@ -451,6 +632,13 @@ static void ui_root_hide_nav(ui_root_t* root, bool animate)
 
     ui_nav_rail_hide(root->nav, animate);
 
+    // Dismissed without picking a page; a commit has already cancelled the queue.
+    asset_prefetch_cancel(&root->prefetch);
+    if (root->prefetch_timer != NULL)
+    {
+        lv_timer_pause(root->prefetch_timer);
+    }
+
     if (root->gesture_zone != NULL)
     {
         lv_obj_clear_flag(root->gesture_zone, LV_OBJ_FLAG_HIDDEN);
@@ -492,6 +680,7 @@ static void ui_root_show_nav(ui_root_t* root, bool animate)
     }
 
     ui_root_update_nav_metrics(root);
+    ui_root_plan_prefetch(root);
 }
 
 ui_nav_page_t ui_root_get_active(const ui_root_t* root)
@@ -502,3 +691,13 @@ ui_nav_page_t ui_root_get_active(const ui_root_t* root)
     }
     return root->active;
 }
+
+bool ui_root_get_prefetch_stats(const ui_root_t* root, asset_prefetch_stats_t* out)
+{
+    if (root == NULL || out == NULL)
+    {
+        return false;
+    }
+    *out = root->prefetch.stats;
+    return true;
+}
@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "assets/asset_prefetch.h"
 #include "ui_nav_rail.h"
 
 #ifdef __has_include
@@ -32,6 +33,9 @@ void ui_root_destroy(ui_root_t *root);
 void ui_root_show_page(ui_root_t *root, ui_nav_page_t page);
 ui_nav_page_t ui_root_get_active(const ui_root_t *root);
 
+/** Prefetch counters since boot; asset_prefetch_hit_rate() turns them into a percentage. */
+bool ui_root_get_prefetch_stats(const ui_root_t *root, asset_prefetch_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
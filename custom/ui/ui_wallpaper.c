@@ -5,6 +5,13 @@
  */
 #include "ui_wallpaper.h"
 
+static const void* s_wallpaper_image = NULL;
+
+void ui_wallpaper_set_image(const void* src)
+{
+    s_wallpaper_image = src;
+}
+
 ui_wallpaper_t* ui_wallpaper_attach(lv_obj_t* parent)
 {
     if (parent == NULL)
@@ -34,6 +41,13 @@ ui_wallpaper_t* ui_wallpaper_attach(lv_obj_t* parent)
     lv_obj_set_style_bg_opa(wallpaper->layer, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_style_border_width(wallpaper->layer, 0, LV_PART_MAIN);
 
+    if (s_wallpaper_image != NULL)
+    {
+        lv_obj_t* image = lv_image_create(wallpaper->layer);
+        lv_image_set_src(image, s_wallpaper_image);
+        lv_obj_center(image);
+    }
+
     return wallpaper;
 }
 
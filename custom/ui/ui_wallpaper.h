@@ -31,6 +31,10 @@ extern "C"
     ui_wallpaper_t* ui_wallpaper_attach(lv_obj_t* parent);
     void            ui_wallpaper_detach(ui_wallpaper_t* wallpaper);
 
+    // Image drawn on wallpapers attached from now on; NULL keeps the plain fill. The caller
+    // keeps @p src alive until every page using it is gone (ui_root pins it).
+    void ui_wallpaper_set_image(const void* src);
+
 #ifdef __cplusplus
 }
 #endif
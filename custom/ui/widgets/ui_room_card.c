@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 
+#include "../ui_fonts.h"
 #include "../ui_theme.h"
 
 struct ui_room_card_t
@@ -83,12 +84,12 @@ static lv_obj_t* create_header(lv_obj_t* parent, const ui_room_card_config_t* co
     lv_obj_t* icon = lv_label_create(header);
     lv_label_set_text(icon, config->icon_text != NULL ? config->icon_text : LV_SYMBOL_HOME);
     lv_obj_set_style_text_color(icon, ui_theme_color_muted(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(icon, &lv_font_montserrat_28, LV_PART_MAIN);
+    lv_obj_set_style_text_font(icon, UI_FONT(28), LV_PART_MAIN);
 
     lv_obj_t* title = lv_label_create(header);
     lv_label_set_text(title, config->title != NULL ? config->title : "Room");
     lv_obj_set_style_text_color(title, ui_theme_color_on_surface(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, UI_FONT(22), LV_PART_MAIN);
 
     LV_UNUSED(icon);
     LV_UNUSED(title);
@@ -115,7 +116,7 @@ static lv_obj_t* create_toggle(lv_obj_t* parent)
     lv_obj_t* label = lv_label_create(btn);
     lv_obj_center(label);
     lv_label_set_text(label, "Off");
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, UI_FONT(18), LV_PART_MAIN);
     lv_obj_set_style_text_color(label, ui_theme_color_on_surface(), LV_PART_MAIN);
 
     return btn;
@@ -125,7 +126,7 @@ static lv_obj_t* create_specs_label(lv_obj_t* parent)
 {
     lv_obj_t* label = lv_label_create(parent);
     lv_label_set_text(label, "24 °C · 48% RH");
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, UI_FONT(14), LV_PART_MAIN);
     lv_obj_set_style_text_color(label, ui_theme_color_muted(), LV_PART_MAIN);
     lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
     lv_obj_set_width(label, LV_PCT(100));
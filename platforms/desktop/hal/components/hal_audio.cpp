@@ -5,12 +5,17 @@
  */
 #include "../hal_desktop.h"
 #include "hal/hal.h"
+#include <cctype>
 #include <cmath>
 #include <mooncake_log.h>
 #include <algorithm>
 #include <SDL2/SDL.h>
 #include <thread>
 #include <iostream>
+#include <memory>
+#include "platform/audio/audio_mixer.h"
+#include "platform/audio/audio_play_queue.h"
+#include "platform/audio/audio_stream.h"
 
 static const std::string _tag = "audio";
 
@@ -18,6 +23,7 @@ void HalDesktop::setSpeakerVolume(uint8_t volume)
 {
     _current_speaker_volume = std::clamp((int)volume, 0, 100);
     mclog::tagInfo(_tag, "set speaker volume: {}%", _current_speaker_volume);
+    notifySystemState(shared_data::SystemStateEvent_t::SpeakerVolume, _current_speaker_volume);
 }
 
 uint8_t HalDesktop::getSpeakerVolume()
@@ -25,11 +31,14 @@ uint8_t HalDesktop::getSpeakerVolume()
     return _current_speaker_volume;
 }
 
-void HalDesktop::audioPlay(std::vector<int16_t>& data, bool async)
+static custom::platform::AudioStats _audio_stats;
+static SDL_AudioDeviceID _clip_device_id    = 0;
+static uint32_t _clip_device_latency_frames = 0;
+static constexpr size_t kAudioQueueDepth    = 4;
+
+static bool open_clip_device()
 {
     static std::once_flag initFlag;
-    static SDL_AudioDeviceID deviceId = 0;
-    static std::mutex audioMutex;
 
     // 音频初始化 & 打开设备（只执行一次）
     std::call_once(initFlag, []() {
@@ -48,40 +57,82 @@ void HalDesktop::audioPlay(std::vector<int16_t>& data, bool async)
         want.samples  = 4096;
         want.callback = nullptr;
 
-        deviceId = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
-        if (deviceId == 0) {
+        _clip_device_id = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+        if (_clip_device_id == 0) {
             std::cerr << "SDL_OpenAudioDevice failed: " << SDL_GetError() << std::endl;
         } else {
-            SDL_PauseAudioDevice(deviceId, 0);  // 开启播放
+            _clip_device_latency_frames = have.samples;
+            SDL_PauseAudioDevice(_clip_device_id, 0);  // 开启播放
         }
     });
 
+    return _clip_device_id != 0;
+}
+
+// SDL_QueueAudio never blocks; the play queue's model tracks the backlog it builds up
+static void clip_device_write(const int16_t* samples, size_t count)
+{
+    if (SDL_QueueAudio(_clip_device_id, samples, count * sizeof(int16_t)) < 0) {
+        std::cerr << "SDL_QueueAudio failed: " << SDL_GetError() << std::endl;
+    }
+}
+
+static custom::platform::AudioPlayQueue::Config clip_queue_config()
+{
+    custom::platform::AudioPlayQueue::Config config;
+    config.max_depth             = kAudioQueueDepth;
+    config.sample_rate           = 48000;
+    config.period_frames         = 480;
+    config.device_latency_frames = _clip_device_latency_frames;
+    return config;
+}
+
+static custom::platform::AudioPlayQueue& audio_play_queue()
+{
+    static custom::platform::AudioPlayQueue queue(clip_device_write, clip_queue_config(), _audio_stats);
+    return queue;
+}
+
+void HalDesktop::audioPlay(std::vector<int16_t>& data, bool async)
+{
+    static std::once_flag workerFlag;
+
     // 若设备打开失败，直接返回
-    if (deviceId == 0) return;
+    if (!open_clip_device()) return;
 
-    // 异步线程提交音频数据
-    auto volume = getSpeakerVolume();
-    std::thread([data, volume]() {
-        std::vector<int16_t> adjustedData = data;
-
-        // 音量缩放
-        float scale = volume / 100.0f;
-        for (size_t i = 0; i < adjustedData.size(); ++i) {
-            int sample = static_cast<int>(adjustedData[i] * scale);
-            if (sample > INT16_MAX) sample = INT16_MAX;
-            if (sample < INT16_MIN) sample = INT16_MIN;
-            adjustedData[i] = static_cast<int16_t>(sample);
-        }
+    auto& queue         = audio_play_queue();
+    uint64_t trigger_us = queue.Now();
+
+    // 音量缩放
+    std::vector<int16_t> adjustedData = data;
+    float scale                       = getSpeakerVolume() / 100.0f;
+    for (size_t i = 0; i < adjustedData.size(); ++i) {
+        int sample = static_cast<int>(adjustedData[i] * scale);
+        if (sample > INT16_MAX) sample = INT16_MAX;
+        if (sample < INT16_MIN) sample = INT16_MIN;
+        adjustedData[i] = static_cast<int16_t>(sample);
+    }
+
+    if (!async) {
+        queue.PlayNow(adjustedData.data(), adjustedData.size(), trigger_us);
+        return;
+    }
 
-        // 加锁提交数据（线程安全）
-        {
-            std::lock_guard<std::mutex> lock(audioMutex);
-            int byteSize = adjustedData.size() * sizeof(int16_t);
-            if (SDL_QueueAudio(deviceId, adjustedData.data(), byteSize) < 0) {
-                std::cerr << "SDL_QueueAudio failed: " << SDL_GetError() << std::endl;
+    std::call_once(workerFlag, []() {
+        std::thread([]() {
+            while (true) {
+                audio_play_queue().PlayNext(std::chrono::milliseconds(100));
             }
-        }
-    }).detach();
+        }).detach();
+    });
+    if (!queue.Submit(std::move(adjustedData), trigger_us)) {
+        mclog::tagWarn(_tag, "audio queue full, clip dropped");
+    }
+}
+
+custom::platform::AudioStatsSnapshot HalDesktop::getAudioStats()
+{
+    return _audio_stats.Snapshot();
 }
 
 void HalDesktop::audioRecord(std::vector<int16_t>& data, uint16_t durationMs, float gain)
@@ -189,3 +240,87 @@ void HalDesktop::stopPlayMusicTest()
     std::lock_guard<std::mutex> lock(_music_play_test_data.mutex);
     _music_play_test_data.killSignal = true;
 }
+
+static void sdl_stream_callback(void* userdata, Uint8* stream, int len)
+{
+    auto mixer = static_cast<custom::platform::AudioMixer*>(userdata);
+    mixer->Mix(reinterpret_cast<int16_t*>(stream), len / (2 * sizeof(int16_t)));
+}
+
+bool HalDesktop::playAudioFile(const std::string& uri)
+{
+    std::lock_guard<std::mutex> lock(_music_play_test_data.mutex);
+    if (_music_play_test_data.state != hal::HalBase::MUSIC_PLAY_IDLE) {
+        mclog::tagInfo(_tag, "already playing");
+        return false;
+    }
+
+    std::shared_ptr<custom::platform::AudioStream> stream = custom::platform::OpenWavStream(uri);
+    if (!stream) {
+        mclog::tagError(_tag, "open wav stream failed: {}", uri);
+        return false;
+    }
+
+    _music_play_test_data.state      = hal::HalBase::MUSIC_PLAY_PLAYING;
+    _music_play_test_data.killSignal = false;
+    stream->ReportUnderrunsTo(&_audio_stats);
+
+    auto volume = getSpeakerVolume();
+    std::thread([stream, volume]() {
+        auto mixer = std::make_unique<custom::platform::AudioMixer>();
+        mixer->AddVoice(stream.get());
+        mixer->SetMasterVolume(volume);
+
+        // The SDL audio thread pulls periods from the mixer; this thread is the decoder
+        SDL_AudioDeviceID deviceId = 0;
+        if ((SDL_WasInit(SDL_INIT_AUDIO) & SDL_INIT_AUDIO) || SDL_InitSubSystem(SDL_INIT_AUDIO) == 0) {
+            SDL_AudioSpec want, have;
+            SDL_memset(&want, 0, sizeof(want));
+            want.freq     = stream->Format().sample_rate;
+            want.format   = AUDIO_S16SYS;
+            want.channels = 2;
+            want.samples  = 1024;
+            want.callback = sdl_stream_callback;
+            want.userdata = mixer.get();
+            deviceId      = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+        }
+
+        if (deviceId == 0) {
+            std::cerr << "SDL_OpenAudioDevice failed: " << SDL_GetError() << std::endl;
+        } else {
+            SDL_PauseAudioDevice(deviceId, 0);
+            while (!stream->Finished()) {
+                {
+                    std::lock_guard<std::mutex> lock(_music_play_test_data.mutex);
+                    if (_music_play_test_data.killSignal) {
+                        break;
+                    }
+                }
+                if (stream->Pump() != custom::platform::AudioStream::PumpResult::kDecoded) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+            SDL_CloseAudioDevice(deviceId);
+        }
+
+        auto stats = stream->Stats();
+        mclog::tagInfo(_tag, "stream done: {} frames decoded, {} played, {} underruns ({} frames)",
+                       stats.decoded_frames, stats.played_frames, stats.underruns, stats.underrun_frames);
+
+        std::lock_guard<std::mutex> lock(_music_play_test_data.mutex);
+        _music_play_test_data.state      = hal::HalBase::MUSIC_PLAY_IDLE;
+        _music_play_test_data.killSignal = false;
+    }).detach();
+    return true;
+}
+
+bool HalDesktop::canPlayAudioFile(const std::string& uri)
+{
+    // Only the WAV stream decoder is built for desktop; there is no MP3 player here
+    if (uri.size() < 4) {
+        return false;
+    }
+    std::string ext = uri.substr(uri.size() - 4);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".wav";
+}
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "../hal_desktop.h"
+#include "hal/hal.h"
+#include <mooncake_log.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "platform/camera/camera_preview_view.h"
+#include "platform/camera/frame_source.h"
+
+using custom::platform::CameraPreview;
+using custom::platform::CameraPreviewView;
+
+static const std::string _tag = "camera";
+
+// Same geometry and rate as the Tab5 MIPI-CSI sensor, so the preview path does the same work
+static constexpr uint32_t kSensorWidth   = 1280;
+static constexpr uint32_t kSensorHeight  = 720;
+static constexpr uint32_t kSensorFps     = 30;
+static constexpr uint32_t kPreviewMaxFps = 30;
+
+static std::unique_ptr<CameraPreviewView> _camera_view;
+static std::thread _camera_thread;
+static std::atomic<bool> _camera_running{false};
+
+// TAB5_CAMERA_SOURCE picks the frame source: "pattern" (default), "file:<raw rgb565/yuyv>" or
+// "/dev/videoN"; see custom::platform::OpenFrameSource()
+static std::unique_ptr<custom::platform::FrameSource> open_camera_source()
+{
+    const char* env  = std::getenv("TAB5_CAMERA_SOURCE");
+    std::string spec = env != nullptr ? env : "pattern";
+    auto source      = custom::platform::OpenFrameSource(spec, kSensorWidth, kSensorHeight, kSensorFps);
+    if (!source) {
+        mclog::tagWarn(_tag, "can not open camera source \"{}\", using test pattern", spec);
+        source = custom::platform::OpenFrameSource("pattern", kSensorWidth, kSensorHeight, kSensorFps);
+    }
+    mclog::tagInfo(_tag, "camera source {} ({}x{})", spec, source->Width(), source->Height());
+    return source;
+}
+
+static void camera_capture_loop(std::shared_ptr<CameraPreview> preview)
+{
+    auto source = open_camera_source();
+
+    // Same dequeue -> offer -> requeue step as the V4L2 loop on the device
+    while (_camera_running.load()) {
+        if (custom::platform::PumpCapture(*source, *preview) == custom::platform::CaptureResult::kNoFrame) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    const auto stats = preview->Stats();
+    mclog::tagInfo(_tag,
+                   "preview: {} captured, {} displayed, {} dropped (stale), {} dropped (paced), blit max {} us",
+                   stats.captured,
+                   stats.displayed,
+                   stats.dropped_stale,
+                   stats.dropped_paced,
+                   stats.max_blit_us);
+}
+
+void HalDesktop::startCameraCapture(lv_obj_t* imgCanvas)
+{
+    mclog::tagInfo(_tag, "start camera capture");
+
+    if (_camera_running.load()) {
+        return;
+    }
+
+    CameraPreview::Config config;
+    config.max_fps = kPreviewMaxFps;
+    _camera_view   = CameraPreviewView::Attach(imgCanvas, custom::platform::SoftwareBlit, config);
+    if (!_camera_view) {
+        mclog::tagError(_tag, "camera preview needs an RGB565 lv_canvas and room for two more frames");
+        return;
+    }
+
+    _camera_running.store(true);
+    _camera_thread = std::thread(camera_capture_loop, _camera_view->Preview());
+    notifySystemState(shared_data::SystemStateEvent_t::CameraCapture, 1);
+}
+
+void HalDesktop::stopCameraCapture()
+{
+    mclog::tagInfo(_tag, "stop camera capture");
+
+    if (!_camera_running.exchange(false)) {
+        return;
+    }
+    // The capture thread never takes the LVGL lock, so joining here (lock held) is safe
+    if (_camera_thread.joinable()) {
+        _camera_thread.join();
+    }
+    _camera_view.reset();
+    notifySystemState(shared_data::SystemStateEvent_t::CameraCapture, 0);
+}
+
+bool HalDesktop::isCameraCapturing()
+{
+    return _camera_running.load();
+}
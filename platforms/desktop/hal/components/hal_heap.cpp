@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "../hal_desktop.h"
+#include <mooncake_log.h>
+#include <malloc.h>
+#include <sys/prctl.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include "platform/memory/heap_site_profile.h"
+
+using custom::platform::HeapSiteProfile;
+using custom::platform::HeapTagScope;
+
+static const std::string _tag = "heap";
+
+// 16 bytes a slot; a desktop session holds far more live blocks than the device
+static constexpr size_t kSlotCount = 1U << 18;
+// prctl() is a syscall, too slow for every allocation; thread names rarely change
+static constexpr uint32_t kNameRefreshAllocs = 1024;
+
+static HeapSiteProfile::Slot _slots[kSlotCount];
+static HeapSiteProfile _profile_storage(_slots, kSlotCount);
+// Published by heap_init(): allocations made during static initialisation run before the
+// profile is constructed
+static std::atomic<HeapSiteProfile*> _profile{nullptr};
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+static const char* thread_tag()
+{
+    const char* tag = HeapTagScope::Current();
+    if (tag != nullptr) {
+        return tag;
+    }
+    thread_local char name[16]     = {};
+    thread_local uint32_t countdown = 0;
+    if (countdown-- == 0) {
+        prctl(PR_GET_NAME, name);
+        countdown = kNameRefreshAllocs;
+    }
+    return name;
+}
+
+static void record_alloc(void* ptr, size_t size)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    if (profile != nullptr && ptr != nullptr) {
+        profile->OnAlloc(ptr, size, thread_tag());
+    }
+}
+
+static void record_free(void* ptr)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    if (profile != nullptr) {
+        profile->OnFree(ptr);
+    }
+}
+
+// The desktop stand-in for the device's CONFIG_HEAP_USE_HOOKS: the executable's malloc family
+// takes precedence over glibc's, for the app, SDL and every other library alike. Blocks from
+// memalign() and friends are not seen; freeing one is a miss, which the profile ignores.
+extern "C" {
+
+void* malloc(size_t size)
+{
+    void* ptr = __libc_malloc(size);
+    record_alloc(ptr, size);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* ptr = __libc_calloc(count, size);
+    record_alloc(ptr, count * size);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    // Dropped first: once glibc has released the old block, another thread may get it back
+    if (ptr != nullptr) {
+        record_free(ptr);
+    }
+    void* result = __libc_realloc(ptr, size);
+    if (result != nullptr) {
+        record_alloc(result, size);
+    } else if (ptr != nullptr && size != 0) {
+        record_alloc(ptr, malloc_usable_size(ptr));  // failed, the old block is still live
+    }
+    return result;
+}
+
+void free(void* ptr)
+{
+    if (ptr != nullptr) {
+        record_free(ptr);
+    }
+    __libc_free(ptr);
+}
+}
+
+bool HalDesktop::writeHeapReport(const std::function<bool(const char*, size_t)>& out)
+{
+    // glibc keeps no largest-free-block figure; free bytes inside the arenas and the releasable
+    // top chunk are the nearest it has
+    struct mallinfo2 info = mallinfo2();
+    char line[160];
+    int len = std::snprintf(line, sizeof(line), "%-9s %10s %10s %10s %10s\n", "arena", "size", "in_use", "free",
+                            "top");
+    if (!out(line, static_cast<size_t>(len))) {
+        return false;
+    }
+    len = std::snprintf(line, sizeof(line), "%-9s %10zu %10zu %10zu %10zu\n\n", "main", info.arena, info.uordblks,
+                        info.fordblks, info.keepcost);
+    if (!out(line, static_cast<size_t>(len))) {
+        return false;
+    }
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    return profile == nullptr || profile->Write(out);
+}
+
+void HalDesktop::heap_init()
+{
+    _profile.store(&_profile_storage, std::memory_order_release);
+    mclog::tagInfo(_tag, "tracking allocation sites, {} slots", kSlotCount);
+}
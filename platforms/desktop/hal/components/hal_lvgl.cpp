@@ -32,6 +32,7 @@ void HalDesktop::lvgl_init()
     lvTouchpad = lv_sdl_mouse_create();
     lv_indev_set_group(lvTouchpad, lv_group_get_default());
     lv_indev_set_display(lvTouchpad, display);
+    instrumentLvglInputLatency(lvTouchpad, display);
 
     // // LV_IMAGE_DECLARE(mouse_cursor_icon); /*Declare the image file.*/
     // lv_obj_t* cursor_obj;
@@ -0,0 +1,254 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "../hal_desktop.h"
+#include <mooncake_log.h>
+#include <arpa/inet.h>
+#include <dlfcn.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "platform/profiling/sampling_profiler.h"
+
+using custom::platform::ProfileTimer;
+using custom::platform::SamplingProfiler;
+
+static const std::string _tag = "profiler";
+
+// Same limits as the diag endpoint on the device
+static constexpr unsigned long kDefaultSeconds = 10;
+static constexpr unsigned long kMaxSeconds     = 60;
+static constexpr int kSampleIntervalUs         = 1000;
+
+static std::atomic<SamplingProfiler*> _active_profiler{nullptr};
+// Any thread burning CPU can take SIGPROF; this keeps the ring single-producer
+static std::atomic_flag _in_handler = ATOMIC_FLAG_INIT;
+
+static void sigprof_handler(int, siginfo_t*, void* context)
+{
+    if (_in_handler.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+    SamplingProfiler* profiler = _active_profiler.load(std::memory_order_relaxed);
+    if (profiler != nullptr) {
+        const int saved_errno = errno;
+        auto* uc              = static_cast<ucontext_t*>(context);
+        uintptr_t pc          = 0;
+#if defined(__x86_64__)
+        pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+        pc = static_cast<uintptr_t>(uc->uc_mcontext.pc);
+#endif
+        char name[16] = {};
+        prctl(PR_GET_NAME, name);
+        profiler->Record(0, pc, name);
+        errno = saved_errno;
+    }
+    _in_handler.clear(std::memory_order_release);
+}
+
+// ITIMER_PROF counts CPU time, so an idle app takes few samples; there is no idle task here
+class SigprofTimer : public ProfileTimer {
+public:
+    bool Start(SamplingProfiler& profiler) override
+    {
+        SamplingProfiler* idle = nullptr;
+        if (!_active_profiler.compare_exchange_strong(idle, &profiler)) {
+            return false;
+        }
+        struct sigaction action = {};
+        action.sa_sigaction     = sigprof_handler;
+        action.sa_flags         = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, &_previous);
+
+        itimerval timer       = {};
+        timer.it_interval     = {0, kSampleIntervalUs};
+        timer.it_value        = timer.it_interval;
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        started = true;
+        return true;
+    }
+
+    void Stop() override
+    {
+        itimerval timer = {};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        // Wait out a handler still running on another thread before the profiler goes away
+        while (_in_handler.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        _active_profiler.store(nullptr, std::memory_order_relaxed);
+        _in_handler.clear(std::memory_order_release);
+        sigaction(SIGPROF, &_previous, nullptr);
+    }
+
+    bool started = false;
+
+private:
+    struct sigaction _previous = {};
+};
+
+// "module+0xoffset", which tools/symbolize_profile.py resolves against the binary; the offset
+// is what addr2line expects for a position-independent executable
+static std::string module_frame(uintptr_t pc)
+{
+    Dl_info info = {};
+    char text[32];
+    if (dladdr(reinterpret_cast<void*>(pc), &info) == 0 || info.dli_fname == nullptr) {
+        std::snprintf(text, sizeof(text), "0x%" PRIxPTR, pc);
+        return text;
+    }
+    const char* slash  = std::strrchr(info.dli_fname, '/');
+    std::string module = slash != nullptr ? slash + 1 : info.dli_fname;
+    std::snprintf(text, sizeof(text), "+0x%" PRIxPTR, pc - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    return module + text;
+}
+
+static bool send_all(int fd, const char* data, size_t len)
+{
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static void send_status(int fd, const char* status, const char* body)
+{
+    std::string response = std::string("HTTP/1.1 ") + status +
+                           "\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n" + body;
+    send_all(fd, response.data(), response.size());
+}
+
+static bool path_is(const char* path, const char* route)
+{
+    size_t len = std::strlen(route);
+    return std::strncmp(path, route, len) == 0 && (path[len] == ' ' || path[len] == '?');
+}
+
+static void serve_heap_request(int fd)
+{
+    send_status(fd, "200 OK", "");
+    HalDesktop::writeHeapReport([fd](const char* data, size_t len) { return send_all(fd, data, len); });
+}
+
+static void serve_profile_request(int fd, const char* path)
+{
+    unsigned long seconds = kDefaultSeconds;
+    const char* param     = std::strstr(path, "seconds=");
+    if (param != nullptr && param < std::strchr(path, ' ')) {
+        char* end = nullptr;
+        seconds   = std::strtoul(param + 8, &end, 10);
+        if (end == param + 8 || (*end != ' ' && *end != '&') || seconds == 0 || seconds > kMaxSeconds) {
+            send_status(fd, "400 Bad Request", "seconds must be 1-60\n");
+            return;
+        }
+    }
+
+    SamplingProfiler::Config config;
+    SamplingProfiler profiler(config);
+    SigprofTimer timer;
+    bool header_sent = false;
+    mclog::tagInfo(_tag, "profiling for {} s", seconds);
+    profiler.Capture(
+        timer, std::chrono::seconds(seconds),
+        [fd, &header_sent](const char* data, size_t len) {
+            if (!header_sent) {
+                send_status(fd, "200 OK", "");
+                header_sent = true;
+            }
+            return send_all(fd, data, len);
+        },
+        module_frame);
+    if (!timer.started) {
+        send_status(fd, "409 Conflict", "A capture is already running\n");
+        return;
+    }
+    if (!header_sent) {
+        send_status(fd, "200 OK", "");  // nothing ran on the CPU
+    }
+    mclog::tagInfo(_tag, "{} samples, {} dropped", profiler.Samples(), profiler.Dropped());
+}
+
+// Just enough HTTP for curl: one GET per connection, answered and closed
+static void serve_request(int fd)
+{
+    char request[512] = {};
+    ssize_t got       = recv(fd, request, sizeof(request) - 1, 0);
+    if (got <= 0) {
+        return;
+    }
+    const char* path = request + 4;
+    if (std::strncmp(request, "GET ", 4) == 0 && path_is(path, "/profile")) {
+        serve_profile_request(fd, path);
+    } else if (std::strncmp(request, "GET ", 4) == 0 && path_is(path, "/heap")) {
+        serve_heap_request(fd);
+    } else {
+        send_status(fd, "404 Not Found", "Only /profile and /heap are served here\n");
+    }
+}
+
+// TAB5_PROFILE_PORT=<port> serves GET /profile?seconds=N and GET /heap on 127.0.0.1, the
+// desktop stand-in for the diag endpoints on the device
+void HalDesktop::profiler_init()
+{
+    const char* env = std::getenv("TAB5_PROFILE_PORT");
+    if (env == nullptr) {
+        return;
+    }
+    int port = std::atoi(env);
+    int fd   = socket(AF_INET, SOCK_STREAM, 0);
+    int one  = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr     = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (port <= 0 || port > 65535 || fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 2) != 0) {
+        mclog::tagError(_tag, "can not listen on 127.0.0.1:{}", env);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    mclog::tagInfo(_tag, "serving http://127.0.0.1:{}/profile and /heap", port);
+
+    // Lives as long as the app; requests are handled one at a time, like the device's server
+    std::thread([fd]() {
+        while (true) {
+            int client = accept(fd, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                mclog::tagError(_tag, "accept failed: {}", std::strerror(errno));
+                close(fd);
+                return;
+            }
+            serve_request(client);
+            close(client);
+        }
+    }).detach();
+}
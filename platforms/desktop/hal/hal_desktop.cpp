@@ -16,7 +16,9 @@ static const std::string _tag = "hal";
 void HalDesktop::init()
 {
     mclog::tagInfo(_tag, "init");
+    heap_init();
     lvgl_init();
+    profiler_init();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -48,6 +50,7 @@ void HalDesktop::setDisplayBrightness(uint8_t brightness)
 {
     _current_lcd_brightness = std::clamp((int)brightness, 0, 100);
     mclog::tagInfo(_tag, "set display brightness: {}%", _current_lcd_brightness);
+    notifySystemState(shared_data::SystemStateEvent_t::DisplayBrightness, _current_lcd_brightness);
 }
 
 uint8_t HalDesktop::getDisplayBrightness()
@@ -89,6 +92,7 @@ void HalDesktop::setChargeQcEnable(bool enable)
 {
     _charge_qc_enable = enable;
     mclog::tagInfo(_tag, "set charge qc enable: {}", _charge_qc_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::ChargeQcEnable, _charge_qc_enable);
 }
 
 bool HalDesktop::getChargeQcEnable()
@@ -100,6 +104,7 @@ void HalDesktop::setChargeEnable(bool enable)
 {
     _charge_enable = enable;
     mclog::tagInfo(_tag, "set charge enable: {}", _charge_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::ChargeEnable, _charge_enable);
 }
 
 bool HalDesktop::getChargeEnable()
@@ -111,6 +116,7 @@ void HalDesktop::setUsb5vEnable(bool enable)
 {
     _usba_5v_enable = enable;
     mclog::tagInfo(_tag, "set usb5v enable: {}", _usba_5v_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::Usb5vEnable, _usba_5v_enable);
 }
 
 bool HalDesktop::getUsb5vEnable()
@@ -122,6 +128,7 @@ void HalDesktop::setExt5vEnable(bool enable)
 {
     _ext_5v_enable = enable;
     mclog::tagInfo(_tag, "set ext5v enable: {}", _ext_5v_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::Ext5vEnable, _ext_5v_enable);
 }
 
 bool HalDesktop::getExt5vEnable()
@@ -152,7 +159,9 @@ std::vector<hal::HalBase::FileEntry_t> HalDesktop::scanSdCard(const std::string&
 {
     std::filesystem::path path(dirPath);
     std::vector<hal::HalBase::FileEntry_t> file_entries;
-    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+    // A missing folder is an empty one, as on a card without it
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
         file_entries.push_back({entry.path().filename().string(), entry.is_directory()});
     }
     return file_entries;
@@ -203,12 +212,11 @@ void HalDesktop::uartMonitorSend(std::string msg, bool newLine)
     std::thread([&]() {
         for (int i = 0; i < 6; i++) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-            std::lock_guard<std::mutex> lock(GetHAL()->uartMonitorData.mutex);
             std::string send_msg = "[2025-04-24 14:32:38.111] [info] [panel-com] recv msg: 32\n";
             mclog::tagInfo(_tag, "send msg: {}", send_msg);
-            for (auto c : send_msg) {
-                GetHAL()->uartMonitorData.rxQueue.push(c);
-            }
+            auto& monitor = GetHAL()->uartMonitorData;
+            size_t pushed = monitor.rxRing.Push(reinterpret_cast<const uint8_t*>(send_msg.data()), send_msg.size());
+            monitor.rxDropped += static_cast<uint32_t>(send_msg.size() - pushed);
         }
         is_test_thread_running = false;
     }).detach();
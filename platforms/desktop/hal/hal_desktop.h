@@ -5,6 +5,7 @@
  */
 #pragma once
 #include <hal/hal.h>
+#include <functional>
 
 class HalDesktop : public hal::HalBase {
 public:
@@ -28,6 +29,7 @@ public:
     void setSpeakerVolume(uint8_t volume) override;
     uint8_t getSpeakerVolume() override;
     void audioPlay(std::vector<int16_t>& data, bool async = true) override;
+    custom::platform::AudioStatsSnapshot getAudioStats() override;
     void audioRecord(std::vector<int16_t>& data, uint16_t durationMs, float gain = 80.0f) override;
     void startDualMicRecordTest() override;
     MicTestState_t getDualMicRecordTestState() override;
@@ -36,6 +38,8 @@ public:
     void startPlayMusicTest() override;
     MusicPlayState_t getMusicPlayTestState() override;
     void stopPlayMusicTest() override;
+    bool playAudioFile(const std::string& uri) override;
+    bool canPlayAudioFile(const std::string& uri) override;
 
     void updatePowerMonitorData() override;
     void setChargeQcEnable(bool enable) override;
@@ -62,6 +66,13 @@ public:
 
     void uartMonitorSend(std::string msg, bool newLine = true) override;
 
+    void startCameraCapture(lv_obj_t* imgCanvas) override;
+    void stopCameraCapture() override;
+    bool isCameraCapturing() override;
+
+    // Region totals and the live allocations by site, as GET /heap serves them
+    static bool writeHeapReport(const std::function<bool(const char*, size_t)>& out);
+
 private:
     uint8_t _current_lcd_brightness = 100;
     uint8_t _current_speaker_volume = 20;
@@ -72,4 +83,6 @@ private:
     bool _ext_antenna_enable        = false;
 
     void lvgl_init();
+    void profiler_init();
+    void heap_init();
 };
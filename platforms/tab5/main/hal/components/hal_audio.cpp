@@ -15,6 +15,18 @@
 #include <thread>
 #include <mutex>
 #include <audio_player.h>
+#include <atomic>
+#include <cctype>
+#include <esp_timer.h>
+#include "diag/diag.h"
+#include "diag/diag_metrics.h"
+#include "platform/audio/audio_mixer.h"
+#include "platform/audio/audio_play_queue.h"
+#include "platform/audio/audio_resampler.h"
+#include "platform/audio/audio_source.h"
+#include "platform/audio/audio_stream.h"
+
+using namespace custom::platform;
 
 static const char* TAG = "audio";
 
@@ -24,6 +36,7 @@ void HalEsp32::setSpeakerVolume(uint8_t volume)
 {
     _current_speaker_volume = std::clamp((int)volume, 0, 100);
     mclog::tagInfo(TAG, "set speaker volume: {}%", _current_speaker_volume);
+    notifySystemState(shared_data::SystemStateEvent_t::SpeakerVolume, _current_speaker_volume);
 }
 
 uint8_t HalEsp32::getSpeakerVolume()
@@ -44,72 +57,128 @@ void HalEsp32::audioRecord(std::vector<int16_t>& data, uint16_t durationMs, floa
     // ESP_LOGI(TAG, "record done, %d bytes", bytes_read);
 }
 
-struct AudioTaskData_t {
-    std::mutex mutex;
-    bool is_task_running  = false;
-    bool is_audio_ready   = false;
-    bool is_audio_playing = false;
-    std::vector<int16_t> audio_data;
-};
-static AudioTaskData_t _audio_task_data;
+// Rough depth of the BSP's I2S DMA ring; sound lags the write call by about this much
+static constexpr uint32_t kI2sDmaLatencyFrames = 480;
+static constexpr size_t kAudioQueueDepth       = 4;
+
+static AudioStats _audio_stats;
+
+// Clips and streams share one I2S port. While a stream plays it owns the clock, and clips are
+// resampled to its rate instead of re-clocking the port under it; once it ends the rate is left
+// as it was, so a clip still being resampled keeps its pitch. 0 when no stream has claimed it.
+static std::mutex _i2s_clock_mutex;
+static uint32_t _stream_sample_rate = 0;
+
+// Only touched from the play queue's prepare and write hooks, which it serialises
+static LinearResampler _clip_resampler;
+static std::vector<int16_t> _clip_resampled;
+static bool _clip_resample = false;
 
-void _audio_play_task(void* param)
+static esp_err_t audio_stream_set_clock(uint32_t rate, uint32_t bits_cfg, i2s_slot_mode_t ch)
 {
-    size_t bytes_written = 0;
+    std::lock_guard<std::mutex> lock(_i2s_clock_mutex);
+    _stream_sample_rate = rate;
+    return bsp_get_codec_handle()->i2s_reconfig_clk_fn(rate, bits_cfg, ch);
+}
 
-    while (true) {
-        _audio_task_data.mutex.lock();
+static void audio_stream_release_clock()
+{
+    std::lock_guard<std::mutex> lock(_i2s_clock_mutex);
+    _stream_sample_rate = 0;
+}
 
-        if (_audio_task_data.is_audio_ready) {
-            _audio_task_data.is_audio_playing = true;
-            _audio_task_data.mutex.unlock();
+static void audio_clip_prepare(uint32_t sample_rate)
+{
+    std::lock_guard<std::mutex> lock(_i2s_clock_mutex);
+    bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
+    codec_handle->set_volume(_current_speaker_volume);
 
-            bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
-            codec_handle->set_volume(_current_speaker_volume);
-            codec_handle->i2s_reconfig_clk_fn(48000, 16, I2S_SLOT_MODE_STEREO);
-            codec_handle->i2s_write(_audio_task_data.audio_data.data(),
-                                    _audio_task_data.audio_data.size() * sizeof(uint16_t), &bytes_written,
-                                    portMAX_DELAY);
+    uint32_t port_rate = sample_rate;
+    if (_stream_sample_rate == 0) {
+        codec_handle->i2s_reconfig_clk_fn(sample_rate, 16, I2S_SLOT_MODE_STEREO);
+    } else {
+        port_rate = _stream_sample_rate;
+    }
+    _clip_resample = port_rate != sample_rate;
+    _clip_resampler.SetRates(sample_rate, port_rate);
+    _clip_resampler.Reset();
+}
 
-            _audio_task_data.mutex.lock();
-            _audio_task_data.is_audio_playing = false;
-            _audio_task_data.is_audio_ready   = false;
-            _audio_task_data.mutex.unlock();
+static void audio_clip_write(const int16_t* samples, size_t count)
+{
+    if (_clip_resample) {
+        _clip_resampled.clear();
+        _clip_resampler.Process(samples, count / 2, _clip_resampled);
+        samples = _clip_resampled.data();
+        count   = _clip_resampled.size();
+    }
+    size_t bytes_written = 0;
+    bsp_get_codec_handle()->i2s_write((void*)samples, count * sizeof(int16_t), &bytes_written, portMAX_DELAY);
+}
 
-            continue;
-        }
+static AudioPlayQueue& audio_play_queue()
+{
+    static AudioPlayQueue queue(audio_clip_write,
+                                AudioPlayQueue::Config{
+                                    .max_depth             = kAudioQueueDepth,
+                                    .sample_rate           = 48000,
+                                    .period_frames         = 480,
+                                    .device_latency_frames = kI2sDmaLatencyFrames,
+                                    .clock                 = []() { return (uint64_t)esp_timer_get_time(); },
+                                    .prepare               = audio_clip_prepare,
+                                },
+                                _audio_stats);
+    return queue;
+}
 
-        _audio_task_data.mutex.unlock();
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+static void _audio_play_task(void* param)
+{
+    while (true) {
+        audio_play_queue().PlayNext(std::chrono::milliseconds(100));
     }
 }
 
 void HalEsp32::audioPlay(std::vector<int16_t>& data, bool async)
 {
-    if (async) {
-        std::lock_guard<std::mutex> lock(_audio_task_data.mutex);
+    static std::once_flag task_once;
 
-        if (_audio_task_data.is_audio_playing) {
-            mclog::tagWarn(TAG, "audio is playing");
-            return;
-        }
+    AudioPlayQueue& queue = audio_play_queue();
+    uint64_t trigger_us   = queue.Now();
 
-        if (!_audio_task_data.is_task_running) {
-            _audio_task_data.is_task_running = true;
-            xTaskCreate(_audio_play_task, "audio", 4096, nullptr, 5, nullptr);
+    if (async) {
+        std::call_once(task_once, []() { xTaskCreate(_audio_play_task, "audio", 4096, nullptr, 5, nullptr); });
+        if (!queue.Submit(data, trigger_us)) {
+            mclog::tagWarn(TAG, "audio queue full, clip dropped");
         }
-
-        _audio_task_data.audio_data     = data;
-        _audio_task_data.is_audio_ready = true;
     } else {
-        bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
-        codec_handle->set_volume(_current_speaker_volume);
-        size_t bytes_written = 0;
-        codec_handle->i2s_reconfig_clk_fn(48000, 16, I2S_SLOT_MODE_STEREO);
-        codec_handle->i2s_write(data.data(), data.size() * sizeof(uint16_t), &bytes_written, portMAX_DELAY);
+        queue.PlayNow(data.data(), data.size(), trigger_us);
     }
 }
 
+AudioStatsSnapshot HalEsp32::getAudioStats()
+{
+    return _audio_stats.Snapshot();
+}
+
+static int audio_health_writer(char* buf, size_t len, void* user_data)
+{
+    return FormatAudioStatsJson(_audio_stats.Snapshot(), buf, len);
+}
+
+DIAG_METRIC_GAUGE_DEFINE(_audio_queue_depth, "audio_queue_depth", "Clips waiting to play");
+
+static void audio_metrics_collector(diag_metrics_writer_t* out, void* user_data)
+{
+    diag_metric_set(&_audio_queue_depth, (int32_t)audio_play_queue().Depth());
+}
+
+void HalEsp32::audio_diag_init()
+{
+    diag_register_health_section("audio", audio_health_writer, nullptr);
+    diag_metric_register(&_audio_queue_depth);
+    diag_metrics_register_collector(audio_metrics_collector, nullptr);
+}
+
 /* -------------------------------------------------------------------------- */
 /*                            Record and play test                            */
 /* -------------------------------------------------------------------------- */
@@ -281,9 +350,50 @@ struct MusicTestData_t
     bool                           killSignal = false;
     hal::HalBase::MusicPlayState_t state      = hal::HalBase::MUSIC_PLAY_IDLE;
     Mp3PlayTarget_t                target     = kDefaultMusicTarget;
+    std::string                    uri;  // Overrides target when set
 };
 static MusicTestData_t _music_test_data;
 
+static bool music_kill_requested()
+{
+    std::lock_guard<std::mutex> lock(_music_test_data.mutex);
+    return _music_test_data.killSignal;
+}
+
+static bool uri_has_extension(const std::string& uri, const char* extension)
+{
+    const size_t len = strlen(extension);
+    if (uri.size() < len) {
+        return false;
+    }
+    std::string ext = uri.substr(uri.size() - len);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == extension;
+}
+
+static bool is_wav_uri(const std::string& uri)
+{
+    return uri_has_extension(uri, ".wav");
+}
+
+static std::unique_ptr<AudioSource> open_embedded_mp3(Mp3PlayTarget_t target)
+{
+    switch (target) {
+#if CONFIG_HAL_AUDIO_ENABLE_LONG_DEMO
+        case MP3_PLAY_TARGET_CANON_IN_D:
+            return std::make_unique<MemoryAudioSource>(canon_in_d_mp3_start,
+                                                       (canon_in_d_mp3_end - canon_in_d_mp3_start) - 1);
+#endif
+        case MP3_PLAY_TARGET_STARTUP_SFX:
+            return std::make_unique<MemoryAudioSource>(startup_sfx_mp3_start,
+                                                       (startup_sfx_mp3_end - startup_sfx_mp3_start) - 1);
+        case MP3_PLAY_TARGET_SHUTDOWN_SFX:
+            return std::make_unique<MemoryAudioSource>(shutdown_sfx_mp3_start,
+                                                       (shutdown_sfx_mp3_end - shutdown_sfx_mp3_start) - 1);
+    }
+    return nullptr;
+}
+
 static esp_err_t audio_mute_function(AUDIO_PLAYER_MUTE_SETTING setting)
 {
     bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
@@ -304,15 +414,14 @@ static void audio_player_callback(audio_player_cb_ctx_t* ctx)
     }
 }
 
-static void _music_play_task(void* param)
+// MP3s go through esp-audio-player, which pulls from the source in small fread() chunks
+static void play_mp3_source(std::unique_ptr<AudioSource> source)
 {
     bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
-    codec_handle->set_volume(_current_speaker_volume);
-    codec_handle->i2s_reconfig_clk_fn(48000, 16, I2S_SLOT_MODE_STEREO);
 
     audio_player_config_t config = {
         .mute_fn    = audio_mute_function,
-        .clk_set_fn = codec_handle->i2s_reconfig_clk_fn,
+        .clk_set_fn = audio_stream_set_clock,
         .write_fn   = codec_handle->i2s_write,
         .priority   = 8,
         .coreID     = 1,
@@ -320,40 +429,15 @@ static void _music_play_task(void* param)
     ESP_ERROR_CHECK(audio_player_new(config));
     audio_player_callback_register(audio_player_callback, NULL);
 
-    size_t mp3_size = 0;
-    FILE*  fp       = nullptr;
-    switch (_music_test_data.target)
-    {
-#if CONFIG_HAL_AUDIO_ENABLE_LONG_DEMO
-        case MP3_PLAY_TARGET_CANON_IN_D:
-            mp3_size = (canon_in_d_mp3_end - canon_in_d_mp3_start) - 1;
-            fp       = fmemopen((void*)canon_in_d_mp3_start, mp3_size, "rb");
-            break;
-#endif
-        case MP3_PLAY_TARGET_STARTUP_SFX:
-            mp3_size = (startup_sfx_mp3_end - startup_sfx_mp3_start) - 1;
-            fp       = fmemopen((void*)startup_sfx_mp3_start, mp3_size, "rb");
-            break;
-        case MP3_PLAY_TARGET_SHUTDOWN_SFX:
-            mp3_size = (shutdown_sfx_mp3_end - shutdown_sfx_mp3_start) - 1;
-            fp       = fmemopen((void*)shutdown_sfx_mp3_start, mp3_size, "rb");
-            break;
-    }
-
-    esp_err_t ret = audio_player_play(fp);
+    FILE* fp      = OpenAudioSourceAsFile(std::move(source));
+    esp_err_t ret = fp != nullptr ? audio_player_play(fp) : ESP_ERR_NO_MEM;
     if (ret != ESP_OK)
     {
         mclog::tagError(TAG, "audio play failed");
-        vTaskDelete(NULL);
-        return;
     }
-
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(100));
-
-        std::lock_guard<std::mutex> lock(_music_test_data.mutex);
-        if (_music_test_data.killSignal) {
-            break;
+    else {
+        while (!music_kill_requested()) {
+            vTaskDelay(pdMS_TO_TICKS(100));
         }
     }
 
@@ -361,27 +445,124 @@ static void _music_play_task(void* param)
     if (ret != ESP_OK) {
         mclog::tagError(TAG, "audio player delete failed");
     }
+}
+
+struct MusicDecodeTaskData_t {
+    AudioStream* stream = nullptr;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> exited{false};
+};
+
+static void _music_decode_task(void* param)
+{
+    auto* data = static_cast<MusicDecodeTaskData_t*>(param);
+    while (!data->stop.load()) {
+        AudioStream::PumpResult result = data->stream->Pump();
+        if (result == AudioStream::PumpResult::kEnd) {
+            break;
+        }
+        if (result != AudioStream::PumpResult::kDecoded) {
+            vTaskDelay(pdMS_TO_TICKS(5));
+        }
+    }
+    data->exited.store(true);
+    vTaskDelete(NULL);
+}
+
+// WAVs are decoded chunk by chunk on a helper task while this task feeds I2S from the mixer
+static void play_wav_stream(std::unique_ptr<AudioStream> stream)
+{
+    static constexpr size_t kPeriodFrames = 512;
+
+    bsp_codec_config_t* codec_handle = bsp_get_codec_handle();
+    audio_stream_set_clock(stream->Format().sample_rate, 16, I2S_SLOT_MODE_STEREO);
+    stream->ReportUnderrunsTo(&_audio_stats);
+
+    MusicDecodeTaskData_t decode_data;
+    decode_data.stream = stream.get();
+    if (xTaskCreatePinnedToCore(_music_decode_task, "music_dec", 4096, &decode_data, 4, nullptr, 1) != pdPASS) {
+        mclog::tagError(TAG, "create decode task failed");
+        return;
+    }
+
+    // About 3 KB of mix scratch, too much for the 4 KB "music" stack; only one music task
+    // runs at a time, so a single static mixer is enough
+    static AudioMixer mixer;
+    mixer.AddVoice(stream.get());
+
+    std::vector<int16_t> period(kPeriodFrames * 2);
+    size_t bytes_written = 0;
+    while (!stream->Finished() && !music_kill_requested()) {
+        mixer.Mix(period.data(), kPeriodFrames);
+        codec_handle->i2s_write(period.data(), period.size() * sizeof(int16_t), &bytes_written, portMAX_DELAY);
+    }
+
+    mixer.RemoveVoice(stream.get());
+    decode_data.stop.store(true);
+    while (!decode_data.exited.load()) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+
+    AudioStreamStats stats = stream->Stats();
+    mclog::tagInfo(TAG, "stream done: {} frames decoded, {} played, {} underruns ({} frames), peak buffer {}",
+                   stats.decoded_frames, stats.played_frames, stats.underruns, stats.underrun_frames,
+                   stats.max_buffered);
+}
+
+// esp-audio-player sets the clock from each MP3's header; WAV streams set it from theirs
+static void _music_play_task(void* param)
+{
+    bsp_get_codec_handle()->set_volume(_current_speaker_volume);
+
+    _music_test_data.mutex.lock();
+    Mp3PlayTarget_t target = _music_test_data.target;
+    std::string uri        = _music_test_data.uri;
+    _music_test_data.mutex.unlock();
+
+    if (uri.empty()) {
+        play_mp3_source(open_embedded_mp3(target));
+    } else if (is_wav_uri(uri)) {
+        auto stream = OpenWavStream(uri);
+        if (stream) {
+            play_wav_stream(std::move(stream));
+        } else {
+            mclog::tagError(TAG, "open wav stream failed: {}", uri);
+        }
+    } else {
+        auto source = OpenAudioSource(uri);
+        if (source) {
+            play_mp3_source(std::move(source));
+        } else {
+            mclog::tagError(TAG, "open audio source failed: {}", uri);
+        }
+    }
+
+    audio_stream_release_clock();
 
     _music_test_data.mutex.lock();
     _music_test_data.state      = hal::HalBase::MUSIC_PLAY_IDLE;
     _music_test_data.killSignal = false;
+    _music_test_data.uri.clear();
     _music_test_data.mutex.unlock();
 
     vTaskDelete(NULL);
 }
 
-void try_create_music_play_task(Mp3PlayTarget_t target)
+static bool try_create_music_play_task(Mp3PlayTarget_t target, const std::string& uri = "")
 {
     if (_music_test_data.state == hal::HalBase::MUSIC_PLAY_IDLE)
     {
         _music_test_data.state      = hal::HalBase::MUSIC_PLAY_PLAYING;
         _music_test_data.target     = target;
+        _music_test_data.uri        = uri;
         _music_test_data.killSignal = false;
-        xTaskCreate(_music_play_task, "music", 3000, nullptr, 5, nullptr);
+        xTaskCreate(_music_play_task, "music", 4096, nullptr, 5, nullptr);
+        return true;
     }
     else
     {
         mclog::tagWarn(TAG, "music play is running");
+        return false;
     }
 }
 
@@ -403,6 +584,18 @@ void HalEsp32::stopPlayMusicTest()
     _music_test_data.killSignal = true;
 }
 
+bool HalEsp32::playAudioFile(const std::string& uri)
+{
+    std::lock_guard<std::mutex> lock(_music_test_data.mutex);
+    return try_create_music_play_task(kDefaultMusicTarget, uri);
+}
+
+bool HalEsp32::canPlayAudioFile(const std::string& uri)
+{
+    // WAVs stream through AudioStream, MP3s through esp-audio-player
+    return is_wav_uri(uri) || uri_has_extension(uri, ".mp3");
+}
+
 /* -------------------------------------------------------------------------- */
 /*                                     SFX                                    */
 /* -------------------------------------------------------------------------- */
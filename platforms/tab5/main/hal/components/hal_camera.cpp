@@ -3,11 +3,12 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <atomic>
 #include <driver/gpio.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <math.h>
 #include <memory>
-#include <mutex>
 #include <mooncake_log.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,7 @@
 #include "bsp/esp-bsp.h"
 #include "driver/i2c_master.h"
 #include "driver/ppa.h"
+#include "esp_cache.h"
 #include "esp_err.h"
 #include "esp_event.h"
 #include "esp_heap_caps.h"
@@ -30,15 +32,25 @@
 #include "esp_video_init.h"
 #include "frame_buffer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
 #include "hal/hal_esp32.h"
 #include "linux/videodev2.h"
+#include "platform/camera/camera_preview_view.h"
+#include "platform/camera/frame_source.h"
 
 #define CAMERA_WIDTH  1280
 #define CAMERA_HEIGHT 720
 
-static lv_obj_t* camera_canvas;
+using custom::platform::CameraPreview;
+using custom::platform::CameraPreviewView;
+using custom::platform::CapturedFrame;
+using custom::platform::FrameTarget;
+using custom::platform::FrameView;
+
+static constexpr uint32_t kPreviewMaxFps = 30;
+
 // extern uint8_t* frame_buf;
 static QueueHandle_t queue_camera_ctrl = NULL;
 // 定义任务控制标志
@@ -46,8 +58,20 @@ static QueueHandle_t queue_camera_ctrl = NULL;
 #define TASK_CONTROL_RESUME 1
 #define TASK_CONTROL_EXIT   2
 
-static bool       is_camera_capturing = false;
-static std::mutex camera_mutex;
+// Written by the capture task on exit, read by the UI; no lock shared between the two.
+static std::atomic<bool> is_camera_capturing{false};
+
+// Set while no capture task exists: cleared just before one is created, set again as its last
+// act, so stop and start can wait for the previous task to be gone. The task never takes the
+// LVGL lock, so waiting with it held is safe.
+static EventGroupHandle_t camera_task_events = NULL;
+#define CAMERA_TASK_EXITED_BIT BIT0
+static constexpr uint32_t kCameraStopTimeoutMs = 1000;
+
+static std::unique_ptr<CameraPreviewView> camera_view;
+static std::shared_ptr<CameraPreview>     camera_preview;
+static ppa_client_handle_t                ppa_srm_handle  = NULL;
+static size_t                             cache_line_size = 0;
 
 static const char* TAG = "camera";
 
@@ -265,10 +289,146 @@ errout:
     return ret;
 }
 
+/**
+ * @brief Scale a dequeued V4L2 buffer straight into the canvas draw buffer with the PPA.
+ *
+ * The PPA writes and invalidates whole cache lines, so canvases that are not cache-line aligned
+ * (or need a scale below 1/16) take the software path instead of risking their neighbours.
+ */
+static bool ppa_blit(const FrameView& src, const FrameTarget& dst)
+{
+    const size_t out_size = dst.stride_px * dst.height * sizeof(uint16_t);
+    if (ppa_srm_handle == NULL || cache_line_size == 0
+        || (reinterpret_cast<uintptr_t>(dst.pixels) % cache_line_size) != 0
+        || (out_size % cache_line_size) != 0)
+    {
+        return custom::platform::SoftwareBlit(src, dst);
+    }
+
+    // PPA scales in 1/16 steps; round down so the output block always fits the canvas.
+    float scale = MIN((float)dst.width / src.width, (float)dst.height / src.height);
+    scale       = floorf(scale * 16.0f) / 16.0f;
+    if (scale < 1.0f / 16.0f)
+    {
+        return custom::platform::SoftwareBlit(src, dst);
+    }
+    const uint32_t out_w = (uint32_t)(src.width * scale);
+    const uint32_t out_h = (uint32_t)(src.height * scale);
+
+    ppa_srm_oper_config_t oper_config = {};
+    oper_config.in.buffer             = src.pixels;
+    oper_config.in.pic_w              = src.stride_px;
+    oper_config.in.pic_h              = src.height;
+    oper_config.in.block_w            = src.width;
+    oper_config.in.block_h            = src.height;
+    oper_config.in.srm_cm             = PPA_SRM_COLOR_MODE_RGB565;
+    oper_config.out.buffer            = dst.pixels;
+    oper_config.out.buffer_size       = out_size;
+    oper_config.out.pic_w             = dst.stride_px;
+    oper_config.out.pic_h             = dst.height;
+    oper_config.out.block_offset_x    = (dst.width - out_w) / 2;
+    oper_config.out.block_offset_y    = (dst.height - out_h) / 2;
+    oper_config.out.srm_cm            = PPA_SRM_COLOR_MODE_RGB565;
+    oper_config.rotation_angle        = PPA_SRM_ROTATION_ANGLE_0;
+    oper_config.scale_x               = scale;
+    oper_config.scale_y               = scale;
+    oper_config.mode                  = PPA_TRANS_MODE_BLOCKING;
+
+    esp_err_t err = ppa_do_scale_rotate_mirror(ppa_srm_handle, &oper_config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(TAG, "PPA blit failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/** The CSI device behind the same buffer-queue interface the host sources use. */
+class EspVideoFrameSource : public custom::platform::FrameSource
+{
+public:
+    explicit EspVideoFrameSource(cam_t* cam) : _cam(cam)
+    {
+    }
+
+    bool Dequeue(CapturedFrame& frame) override
+    {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = MEMORY_TYPE;
+        if (ioctl(_cam->fd, VIDIOC_DQBUF, &buf) != 0)
+        {
+            ESP_LOGE(TAG, "failed to receive video frame");
+            return false;
+        }
+
+        frame.index          = buf.index;
+        frame.view.pixels    = reinterpret_cast<const uint16_t*>(_cam->buffer[buf.index]);
+        frame.view.width     = _cam->width;
+        frame.view.height    = _cam->height;
+        frame.view.stride_px = _cam->width;
+        frame.timestamp_us   = esp_timer_get_time();
+        return true;
+    }
+
+    void Requeue(const CapturedFrame& frame) override
+    {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = MEMORY_TYPE;
+        buf.index  = frame.index;
+        if (ioctl(_cam->fd, VIDIOC_QBUF, &buf) != 0)
+        {
+            ESP_LOGE(TAG, "failed to free video frame");
+        }
+    }
+
+    uint32_t Width() const override
+    {
+        return _cam->width;
+    }
+    uint32_t Height() const override
+    {
+        return _cam->height;
+    }
+
+private:
+    cam_t* _cam;
+};
+
+/** Extra preview surfaces live in PSRAM, cache-line aligned so the PPA can write them. */
+static void* camera_surface_alloc(size_t bytes)
+{
+    const size_t align = cache_line_size != 0 ? cache_line_size : 64;
+    return heap_caps_aligned_calloc(align, 1, (bytes + align - 1) / align * align, MALLOC_CAP_SPIRAM);
+}
+
 // static HumanFaceDetect* human_face_detector;
 static bool   cam_is_initial = false;
 static cam_t* camera         = NULL;
 
+static void camera_task_exit()
+{
+    is_camera_capturing = false;
+    xEventGroupSetBits(camera_task_events, CAMERA_TASK_EXITED_BIT);
+    vTaskDelete(NULL);
+}
+
+static bool wait_camera_task_exit()
+{
+    if (camera_task_events == NULL)
+    {
+        return true;  // no task was ever started
+    }
+    const EventBits_t bits = xEventGroupWaitBits(camera_task_events,
+                                                 CAMERA_TASK_EXITED_BIT,
+                                                 pdFALSE,
+                                                 pdTRUE,
+                                                 pdMS_TO_TICKS(kCameraStopTimeoutMs));
+    return (bits & CAMERA_TASK_EXITED_BIT) != 0;
+}
 void app_camera_display(void* arg)
 {
     /* camera config */
@@ -290,9 +450,11 @@ void app_camera_display(void* arg)
         .jpeg = NULL,         // No JPEG configuration
     };
 
+    // Keep the preview alive until this task is done with it, even if the UI detaches first.
+    std::shared_ptr<CameraPreview> preview = camera_preview;
+
     if (!cam_is_initial)
     {
-        camera = (cam_t*)malloc(sizeof(cam_t));
         printf("\n============= video init ==============\n");
         cam_is_initial = true;
         ESP_ERROR_CHECK(esp_video_init(&cam_config));
@@ -301,6 +463,8 @@ void app_camera_display(void* arg)
         if (video_cam_fd < 0)
         {
             ESP_LOGE(TAG, "video cam open failed");
+            cam_is_initial = false;
+            camera_task_exit();
             return;
         }
         ESP_ERROR_CHECK(new_cam(video_cam_fd, &camera));
@@ -311,58 +475,145 @@ void app_camera_display(void* arg)
             ESP_LOGW(TAG, "Sensor horizontal flip unsupported; the preview may remain mirrored");
         }
         set_sensor_control(video_cam_fd, V4L2_CID_VFLIP, 0, "sensor vertical flip");
-    }
 
-    struct v4l2_buffer buf;
-
-    /* */
-    uint16_t           screen_width         = 1280;  // 640;//lcd_height();
-    uint16_t           screen_height        = 720;   // 480;//lcd_width();
-    uint8_t*           img_show_data        = NULL;
-    constexpr uint32_t kRgb565BytesPerPixel = 2;
-    uint32_t           img_show_size        = screen_width * screen_height * kRgb565BytesPerPixel;
-    // uint32_t img_offset = 280 * 720 * 2;
-    heap_caps_free(img_show_data);
-    img_show_data = NULL;
+        ppa_client_config_t ppa_srm_config = {};
+        ppa_srm_config.oper_type           = PPA_OPERATION_SRM;
+        if (ppa_register_client(&ppa_srm_config, &ppa_srm_handle) != ESP_OK)
+        {
+            ESP_LOGW(TAG, "PPA unavailable; preview falls back to software scaling");
+            ppa_srm_handle = NULL;
+        }
+    }
 
-    // close(camera->fd);
+    // Dequeue -> blit into the canvas (or drop) -> requeue. Nothing here waits on LVGL, so the
+    // sensor keeps its own pace and late frames are simply not shown.
+    EspVideoFrameSource source(camera);
+    int                 control_state = TASK_CONTROL_RESUME;
+    while (true)
+    {
+        int msg;
+        if (xQueueReceive(queue_camera_ctrl, &msg, 0) == pdTRUE)
+        {
+            control_state = msg;
+        }
+        if (control_state == TASK_CONTROL_EXIT)
+        {
+            break;
+        }
+        if (control_state == TASK_CONTROL_PAUSE)
+        {
+            vTaskDelay(pdMS_TO_TICKS(20));
+            continue;
+        }
 
-    camera_mutex.lock();
-    is_camera_capturing = false;
-    camera_mutex.unlock();
+        if (custom::platform::PumpCapture(source, *preview)
+            == custom::platform::CaptureResult::kNoFrame)
+        {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
 
-    vTaskDelete(NULL);
+    const auto stats = preview->Stats();
+    ESP_LOGI(TAG,
+             "preview: %" PRIu32 " captured, %" PRIu32 " displayed, %" PRIu32
+             " dropped (stale), %" PRIu32 " dropped (paced), blit max %" PRIu32 " us",
+             stats.captured,
+             stats.displayed,
+             stats.dropped_stale,
+             stats.dropped_paced,
+             stats.max_blit_us);
+    preview.reset();
+
+    camera_task_exit();
 }
 
 void HalEsp32::startCameraCapture(lv_obj_t* imgCanvas)
 {
     mclog::tagInfo(TAG, "start camera capture");
 
-    camera_canvas = imgCanvas;
+    if (camera_view && isCameraCapturing())
+    {
+        return;  // already running
+    }
+    // A session stopped just before may still be tearing down its task
+    if (!wait_camera_task_exit())
+    {
+        mclog::tagWarn(TAG, "previous capture task still running, camera busy");
+        return;
+    }
+
+    CameraPreview::Config config;
+    config.max_fps = kPreviewMaxFps;
+    if (cache_line_size == 0
+        && esp_cache_get_alignment(MALLOC_CAP_SPIRAM, &cache_line_size) != ESP_OK)
+    {
+        cache_line_size = 0;
+    }
+    custom::platform::SurfaceAllocator allocator;
+    allocator.alloc = camera_surface_alloc;
+    allocator.free  = heap_caps_free;
+    camera_view     = CameraPreviewView::Attach(imgCanvas, ppa_blit, config, allocator);
+    if (!camera_view)
+    {
+        mclog::tagError(TAG, "camera preview needs an RGB565 lv_canvas and room for two more frames");
+        return;
+    }
+    camera_preview = camera_view->Preview();
 
-    queue_camera_ctrl = xQueueCreate(10, sizeof(int));
     if (queue_camera_ctrl == NULL)
     {
-        ESP_LOGD(TAG, "Failed to create semaphore\n");
+        queue_camera_ctrl = xQueueCreate(10, sizeof(int));
+        if (queue_camera_ctrl == NULL)
+        {
+            ESP_LOGD(TAG, "Failed to create semaphore\n");
+        }
+    }
+    xQueueReset(queue_camera_ctrl);
+    if (camera_task_events == NULL)
+    {
+        camera_task_events = xEventGroupCreate();
     }
+    xEventGroupClearBits(camera_task_events, CAMERA_TASK_EXITED_BIT);
 
     is_camera_capturing = true;
-    xTaskCreatePinnedToCore(app_camera_display, "cam", 8 * 1024, NULL, 5, NULL, 1);
+    if (xTaskCreatePinnedToCore(app_camera_display, "cam", 8 * 1024, NULL, 5, NULL, 1) != pdPASS)
+    {
+        mclog::tagError(TAG, "create capture task failed");
+        is_camera_capturing = false;
+        xEventGroupSetBits(camera_task_events, CAMERA_TASK_EXITED_BIT);
+        camera_view.reset();
+        camera_preview.reset();
+        return;
+    }
+    notifySystemState(shared_data::SystemStateEvent_t::CameraCapture, 1);
 }
 
 void HalEsp32::stopCameraCapture()
 {
     mclog::tagInfo(TAG, "stop camera capture");
 
+    if (queue_camera_ctrl == NULL)
+    {
+        return;
+    }
+
     int control_state = 0;  // pause
     xQueueSend(queue_camera_ctrl, &control_state, portMAX_DELAY);
 
     control_state = 2;  // exit
     xQueueSend(queue_camera_ctrl, &control_state, portMAX_DELAY);
+    if (!wait_camera_task_exit())
+    {
+        mclog::tagWarn(TAG, "capture task did not exit within {} ms", kCameraStopTimeoutMs);
+    }
+
+    // Called with the LVGL lock held; waits at most for one in-flight blit.
+    camera_view.reset();
+    camera_preview.reset();
+    notifySystemState(shared_data::SystemStateEvent_t::CameraCapture, 0);
 }
 
 bool HalEsp32::isCameraCapturing()
 {
-    std::lock_guard<std::mutex> lock(camera_mutex);
     return is_camera_capturing;
 }
@@ -0,0 +1,292 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "hal/hal_esp32.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <new>
+
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_private/cache_utils.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mooncake_log.h>
+#include <sdkconfig.h>
+
+#include "diag/diag.h"
+#include "diag/diag_metrics.h"
+#include "platform/memory/heap_site_profile.h"
+
+using custom::platform::HeapSiteProfile;
+using custom::platform::HeapTagScope;
+
+static const char* TAG = "heap";
+
+// 8 bytes a slot in PSRAM; the UI settles at a few thousand live blocks
+static constexpr size_t kSlotCount         = 32768;
+static constexpr uint64_t kLowWaterPeriodUs = 5 * 1000 * 1000;
+// An allocation failure storm should log one report, not one per failure
+static constexpr int64_t kFailureDumpGapUs = 60 * 1000 * 1000;
+static constexpr size_t kReportedSites     = 12;
+
+struct HeapRegion
+{
+    const char* name;
+    uint32_t caps;
+};
+
+static constexpr HeapRegion kHeapRegions[] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"psram", MALLOC_CAP_SPIRAM},
+};
+static constexpr size_t kRegionCount = sizeof(kHeapRegions) / sizeof(kHeapRegions[0]);
+
+static std::atomic<HeapSiteProfile*> _profile{nullptr};
+static std::atomic<size_t> _largest_low_water[kRegionCount];
+static std::atomic<int64_t> _last_failure_dump_us{0};
+static esp_timer_handle_t _low_water_timer = nullptr;
+
+static void record_alloc(void* ptr, size_t size)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    if (profile == nullptr)
+    {
+        return;
+    }
+    const char* tag = HeapTagScope::Current();
+    if (tag == nullptr)
+    {
+        TaskHandle_t task = xTaskGetCurrentTaskHandle();
+        tag               = task != nullptr ? pcTaskGetName(task) : nullptr;
+    }
+    profile->OnAlloc(ptr, size, tag);
+}
+
+static void record_free(void* ptr)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    if (profile != nullptr)
+    {
+        profile->OnFree(ptr);
+    }
+}
+
+// CONFIG_HEAP_USE_HOOKS calls these from every heap_caps allocation and free, which can run
+// with the flash cache off. The profile lives in flash and PSRAM, so those calls are skipped:
+// such an allocation goes unseen, and such a free leaves its block counted as live.
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps)
+{
+    if (spi_flash_cache_enabled())
+    {
+        record_alloc(ptr, size);
+    }
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr)
+{
+    if (spi_flash_cache_enabled())
+    {
+        record_free(ptr);
+    }
+}
+
+// The largest free block shrinks between /metrics scrapes too; this keeps the worst seen
+static void low_water_timer_cb(void* arg)
+{
+    for (size_t i = 0; i < kRegionCount; ++i)
+    {
+        size_t largest = heap_caps_get_largest_free_block(kHeapRegions[i].caps);
+        size_t lowest  = _largest_low_water[i].load(std::memory_order_relaxed);
+        while (largest < lowest && !_largest_low_water[i].compare_exchange_weak(lowest, largest))
+        {
+        }
+    }
+}
+
+static bool write_regions(diag_metrics_sink_t sink, void* sink_ctx)
+{
+    char line[160];
+    int len = std::snprintf(line,
+                            sizeof(line),
+                            "%-9s %10s %10s %10s %10s %8s %8s\n",
+                            "region",
+                            "free",
+                            "min_free",
+                            "largest",
+                            "lowest",
+                            "free_blk",
+                            "used_blk");
+    if (!sink(line, static_cast<size_t>(len), sink_ctx))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < kRegionCount; ++i)
+    {
+        multi_heap_info_t info = {};
+        heap_caps_get_info(&info, kHeapRegions[i].caps);
+        len = std::snprintf(line,
+                            sizeof(line),
+                            "%-9s %10u %10u %10u %10u %8u %8u\n",
+                            kHeapRegions[i].name,
+                            static_cast<unsigned>(info.total_free_bytes),
+                            static_cast<unsigned>(info.minimum_free_bytes),
+                            static_cast<unsigned>(info.largest_free_block),
+                            static_cast<unsigned>(_largest_low_water[i].load()),
+                            static_cast<unsigned>(info.free_blocks),
+                            static_cast<unsigned>(info.allocated_blocks));
+        if (!sink(line, static_cast<size_t>(len), sink_ctx))
+        {
+            return false;
+        }
+    }
+    return sink("\n", 1, sink_ctx);
+}
+
+static esp_err_t heap_report(diag_metrics_sink_t sink, void* sink_ctx, void* user_data)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    if (!write_regions(sink, sink_ctx))
+    {
+        return ESP_FAIL;
+    }
+    if (profile == nullptr)
+    {
+        return ESP_OK;
+    }
+    bool written = profile->Write(
+        [sink, sink_ctx](const char* data, size_t len) { return sink(data, len, sink_ctx); });
+    return written ? ESP_OK : ESP_FAIL;
+}
+
+// Log lines without the trailing newline; ESP_LOG adds its own
+static bool log_report_line(const char* data, size_t len, void* sink_ctx)
+{
+    if (len > 0 && data[len - 1] == '\n')
+    {
+        len--;
+    }
+    if (len > 0)
+    {
+        ESP_LOGW(TAG, "%.*s", static_cast<int>(len), data);
+    }
+    return true;
+}
+
+// Runs on the task whose allocation failed, maybe on a small stack and with the heap short,
+// so it sticks to ESP_LOG and fixed buffers
+static void failed_alloc_cb(size_t size, uint32_t caps, const char* function_name)
+{
+    int64_t now  = esp_timer_get_time();
+    int64_t last = _last_failure_dump_us.load(std::memory_order_relaxed);
+    if ((last != 0 && now - last < kFailureDumpGapUs) ||
+        !_last_failure_dump_us.compare_exchange_strong(last, now))
+    {
+        return;
+    }
+    ESP_LOGW(TAG,
+             "%s could not allocate %u bytes (caps 0x%" PRIx32 "), heap report follows",
+             function_name != nullptr ? function_name : "?",
+             static_cast<unsigned>(size),
+             caps);
+    heap_report(log_report_line, nullptr, nullptr);
+}
+
+static void heap_site_collector(diag_metrics_writer_t* out, void* user_data)
+{
+    HeapSiteProfile* profile = _profile.load(std::memory_order_acquire);
+    for (size_t i = 0; i < kRegionCount; ++i)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_largest_free_block_lowest_bytes",
+                                  "Smallest largest-free-block seen since boot, sampled every 5 s",
+                                  "region",
+                                  kHeapRegions[i].name,
+                                  _largest_low_water[i].load(std::memory_order_relaxed));
+    }
+    if (profile == nullptr)
+    {
+        return;
+    }
+
+    // The biggest holders only; the full table is at /heap. /metrics and the MQTT timer may
+    // export at the same time.
+    static std::mutex mutex;
+    static HeapSiteProfile::TagSummary sites[kReportedSites];
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = profile->Summaries(sites, kReportedSites);
+    for (size_t i = 0; i < count; ++i)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_site_live_bytes",
+                                  "Live heap bytes by allocating task or tag",
+                                  "site",
+                                  sites[i].name,
+                                  sites[i].live_bytes);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_site_live_blocks",
+                                  "Live heap blocks by allocating task or tag",
+                                  "site",
+                                  sites[i].name,
+                                  sites[i].live_blocks);
+    }
+    HeapSiteProfile::Stats stats = profile->GetStats();
+    diag_metrics_write_sample(out,
+                              "heap_site_untracked_total",
+                              "Allocations the site table had no room for",
+                              nullptr,
+                              nullptr,
+                              stats.untracked);
+}
+
+void HalEsp32::heap_diag_init()
+{
+    for (size_t i = 0; i < kRegionCount; ++i)
+    {
+        _largest_low_water[i] = heap_caps_get_largest_free_block(kHeapRegions[i].caps);
+    }
+
+#if CONFIG_HEAP_USE_HOOKS
+    // Both live for the whole uptime, in PSRAM to keep internal RAM for DMA and stacks
+    void* slots   = heap_caps_calloc(kSlotCount, sizeof(HeapSiteProfile::Slot), MALLOC_CAP_SPIRAM);
+    void* storage = heap_caps_calloc(1, sizeof(HeapSiteProfile), MALLOC_CAP_SPIRAM);
+    if (slots == nullptr || storage == nullptr)
+    {
+        mclog::tagError(TAG, "no PSRAM for the allocation site table");
+        heap_caps_free(slots);
+        heap_caps_free(storage);
+    }
+    else
+    {
+        auto* profile =
+            new (storage) HeapSiteProfile(static_cast<HeapSiteProfile::Slot*>(slots), kSlotCount);
+        _profile.store(profile, std::memory_order_release);
+        mclog::tagInfo(TAG, "tracking allocation sites, {} slots", kSlotCount);
+    }
+#else
+    mclog::tagWarn(TAG, "CONFIG_HEAP_USE_HOOKS is off, allocation sites not tracked");
+#endif
+
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback                = low_water_timer_cb;
+    timer_args.name                    = "heap_low_water";
+    if (esp_timer_create(&timer_args, &_low_water_timer) == ESP_OK)
+    {
+        esp_timer_start_periodic(_low_water_timer, kLowWaterPeriodUs);
+    }
+
+    heap_caps_register_failed_alloc_callback(failed_alloc_cb);
+    diag_metrics_register_collector(heap_site_collector, nullptr);
+    diag_register_heap_report(heap_report, nullptr);
+}
@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "hal/hal_esp32.h"
+
+#include <mutex>
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mooncake_log.h>
+
+#include "diag/diag_metrics.h"
+#include "shared/shared.h"
+
+static const char* TAG = "metrics";
+
+// Tasks beyond this are left out of the stack report rather than allocated for
+static constexpr UBaseType_t kMaxReportedTasks = 32;
+
+// 1 ms to 133 ms: the top bounds are 30 fps and 15 fps worth of frame
+DIAG_METRIC_HISTOGRAM_DEFINE(s_lvgl_frame_us,
+                             "lvgl_frame_us",
+                             "LVGL refresh duration in microseconds",
+                             1000U,
+                             2000U,
+                             4000U,
+                             8000U,
+                             16000U,
+                             33000U,
+                             66000U,
+                             133000U);
+
+static int64_t s_refr_start_us;  // only touched on the LVGL task
+
+static void metrics_display_event_cb(lv_event_t* event)
+{
+    if (lv_event_get_code(event) == LV_EVENT_REFR_START)
+    {
+        s_refr_start_us = esp_timer_get_time();
+    }
+    else if (s_refr_start_us != 0)
+    {
+        diag_metric_observe(&s_lvgl_frame_us, (uint32_t)(esp_timer_get_time() - s_refr_start_us));
+        s_refr_start_us = 0;
+    }
+}
+
+struct HeapRegion
+{
+    const char* name;
+    uint32_t caps;
+};
+
+static constexpr HeapRegion kHeapRegions[] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"psram", MALLOC_CAP_SPIRAM},
+};
+
+static void heap_collector(diag_metrics_writer_t* out, void* user_data)
+{
+    for (const HeapRegion& region : kHeapRegions)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_free_bytes",
+                                  "Free heap",
+                                  "region",
+                                  region.name,
+                                  heap_caps_get_free_size(region.caps));
+    }
+    for (const HeapRegion& region : kHeapRegions)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_min_free_bytes",
+                                  "Lowest free heap since boot",
+                                  "region",
+                                  region.name,
+                                  heap_caps_get_minimum_free_size(region.caps));
+    }
+    for (const HeapRegion& region : kHeapRegions)
+    {
+        diag_metrics_write_sample(out,
+                                  "heap_largest_free_block_bytes",
+                                  "Largest single allocation that can still succeed",
+                                  "region",
+                                  region.name,
+                                  heap_caps_get_largest_free_block(region.caps));
+    }
+    // 0 when all free memory is one block; high values mean large allocations fail early
+    for (const HeapRegion& region : kHeapRegions)
+    {
+        size_t free_bytes = heap_caps_get_free_size(region.caps);
+        size_t largest    = heap_caps_get_largest_free_block(region.caps);
+        int64_t percent   = free_bytes == 0 ? 0 : 100 - (int64_t)(largest * 100 / free_bytes);
+        diag_metrics_write_sample(out,
+                                  "heap_fragmentation_percent",
+                                  "Share of free heap outside the largest block",
+                                  "region",
+                                  region.name,
+                                  percent);
+    }
+}
+
+static void task_stack_collector(diag_metrics_writer_t* out, void* user_data)
+{
+    // /metrics and the MQTT timer may export at the same time
+    static std::mutex mutex;
+    static TaskStatus_t tasks[kMaxReportedTasks];
+
+    std::lock_guard<std::mutex> lock(mutex);
+    UBaseType_t count = uxTaskGetSystemState(tasks, kMaxReportedTasks, nullptr);
+    if (count == 0)
+    {
+        mclog::tagWarn(TAG, "more than {} tasks, stack report skipped", kMaxReportedTasks);
+        return;
+    }
+    diag_metrics_write_sample(out, "task_count", "FreeRTOS tasks", nullptr, nullptr, count);
+    // ESP-IDF reports the high-water mark in bytes, not words
+    for (UBaseType_t i = 0; i < count; ++i)
+    {
+        diag_metrics_write_sample(out,
+                                  "task_stack_free_bytes",
+                                  "Lowest free stack the task has had",
+                                  "task",
+                                  tasks[i].pcTaskName,
+                                  tasks[i].usStackHighWaterMark);
+    }
+}
+
+static void event_queue_collector(diag_metrics_writer_t* out, void* user_data)
+{
+    diag_metrics_write_sample(out,
+                              "event_queue_depth",
+                              "Events posted and not yet dispatched",
+                              "queue",
+                              "system_state",
+                              GetSystemStateEvents().Pending());
+    diag_metrics_write_sample(
+        out, "event_queue_depth", nullptr, "queue", "input", GetInputEvents().Pending());
+    diag_metrics_write_sample(out,
+                              "event_queue_dropped",
+                              "Events lost to a full queue since boot",
+                              "queue",
+                              "system_state",
+                              GetSystemStateEvents().GetStats().dropped);
+    diag_metrics_write_sample(
+        out, "event_queue_dropped", nullptr, "queue", "input", GetInputEvents().GetStats().dropped);
+}
+
+void HalEsp32::metrics_diag_init()
+{
+    diag_metric_register(&s_lvgl_frame_us);
+    diag_metrics_register_collector(heap_collector, nullptr);
+    diag_metrics_register_collector(task_stack_collector, nullptr);
+    diag_metrics_register_collector(event_queue_collector, nullptr);
+
+    if (lvDisp == nullptr)
+    {
+        mclog::tagWarn(TAG, "no display, frame time not tracked");
+        return;
+    }
+    lvglLock();
+    lv_display_add_event_cb(lvDisp, metrics_display_event_cb, LV_EVENT_REFR_START, nullptr);
+    lv_display_add_event_cb(lvDisp, metrics_display_event_cb, LV_EVENT_REFR_READY, nullptr);
+    lvglUnlock();
+}
@@ -29,6 +29,7 @@ void HalEsp32::setChargeQcEnable(bool enable)
     _charge_qc_enable = enable;
     mclog::tagInfo(_tag, "set charge qc enable: {}", _charge_qc_enable);
     bsp_set_charge_qc_en(_charge_qc_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::ChargeQcEnable, _charge_qc_enable);
 }
 
 bool HalEsp32::getChargeQcEnable()
@@ -41,6 +42,7 @@ void HalEsp32::setChargeEnable(bool enable)
     _charge_enable = enable;
     mclog::tagInfo(_tag, "set charge enable: {}", _charge_enable);
     bsp_set_charge_en(_charge_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::ChargeEnable, _charge_enable);
 }
 
 bool HalEsp32::getChargeEnable()
@@ -53,6 +55,7 @@ void HalEsp32::setUsb5vEnable(bool enable)
     _usba_5v_enable = enable;
     mclog::tagInfo(_tag, "set usb 5v enable: {}", _usba_5v_enable);
     bsp_set_usb_5v_en(_usba_5v_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::Usb5vEnable, _usba_5v_enable);
 }
 
 bool HalEsp32::getUsb5vEnable()
@@ -65,6 +68,7 @@ void HalEsp32::setExt5vEnable(bool enable)
     _ext_5v_enable = enable;
     mclog::tagInfo(_tag, "set ext 5v enable: {}", _ext_5v_enable);
     bsp_set_ext_5v_en(_ext_5v_enable);
+    notifySystemState(shared_data::SystemStateEvent_t::Ext5vEnable, _ext_5v_enable);
 }
 
 bool HalEsp32::getExt5vEnable()
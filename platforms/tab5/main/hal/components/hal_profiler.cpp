@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include "hal/hal_esp32.h"
+
+#include <atomic>
+#include <chrono>
+
+#include <esp_attr.h>
+#include <esp_cpu.h>
+#include <esp_freertos_hooks.h>
+#include <esp_private/cache_utils.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mooncake_log.h>
+#include <sdkconfig.h>
+#if CONFIG_IDF_TARGET_ARCH_RISCV
+#include <riscv/csr.h>
+#endif
+
+#include "diag/diag.h"
+#include "platform/profiling/sampling_profiler.h"
+
+using custom::platform::ProfileTimer;
+using custom::platform::SamplingProfiler;
+
+static const char* TAG = "profiler";
+
+// 100 ms of drain period at the 1 kHz tick is 100 samples; the rest is headroom
+static constexpr size_t kRingCapacity = 1024;
+
+static std::atomic<SamplingProfiler*> _active_profiler{nullptr};
+
+static void record_tick()
+{
+    SamplingProfiler* profiler = _active_profiler.load(std::memory_order_acquire);
+    if (profiler == nullptr)
+    {
+        return;
+    }
+    uintptr_t pc = 0;
+#if CONFIG_IDF_TARGET_ARCH_RISCV
+    // Still the interrupted instruction: the hook runs inside the tick interrupt
+    pc = RV_READ_CSR(mepc);
+#endif
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    profiler->Record(esp_cpu_get_core_id(), pc, task != nullptr ? pcTaskGetName(task) : nullptr);
+}
+
+// The tick interrupt also fires while flash is busy and the cache is off. record_tick() and
+// the sample rings live in flash and PSRAM, so those ticks are left out of the profile.
+static void IRAM_ATTR profiler_tick_hook()
+{
+    if (spi_flash_cache_enabled())
+    {
+        record_tick();
+    }
+}
+
+// Samples on the FreeRTOS tick of every core (CONFIG_FREERTOS_HZ, 1 kHz on the Tab5)
+class TickHookTimer : public ProfileTimer
+{
+public:
+    bool Start(SamplingProfiler& profiler) override
+    {
+        SamplingProfiler* idle = nullptr;
+        if (!_active_profiler.compare_exchange_strong(idle, &profiler))
+        {
+            return false;
+        }
+        for (int core = 0; core < portNUM_PROCESSORS; ++core)
+        {
+            esp_register_freertos_tick_hook_for_cpu(profiler_tick_hook, core);
+        }
+        started = true;
+        return true;
+    }
+
+    void Stop() override
+    {
+        for (int core = 0; core < portNUM_PROCESSORS; ++core)
+        {
+            esp_deregister_freertos_tick_hook_for_cpu(profiler_tick_hook, core);
+        }
+        // Let a tick already in flight on the other core finish with the profiler
+        vTaskDelay(pdMS_TO_TICKS(2));
+        _active_profiler.store(nullptr, std::memory_order_release);
+    }
+
+    bool started = false;
+};
+
+static esp_err_t profiler_capture(uint32_t            seconds,
+                                  diag_metrics_sink_t sink,
+                                  void*               sink_ctx,
+                                  void*               user_data)
+{
+    SamplingProfiler::Config config;
+    config.cores         = portNUM_PROCESSORS;
+    config.ring_capacity = kRingCapacity;
+    SamplingProfiler profiler(config);
+
+    TickHookTimer timer;
+    bool written = profiler.Capture(
+        timer, std::chrono::seconds(seconds), [sink, sink_ctx](const char* data, size_t len) {
+            return sink(data, len, sink_ctx);
+        });
+    if (!timer.started)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    mclog::tagInfo(
+        TAG, "{} s: {} samples, {} dropped", seconds, profiler.Samples(), profiler.Dropped());
+    return written ? ESP_OK : ESP_FAIL;
+}
+
+void HalEsp32::profiler_diag_init()
+{
+    diag_register_profiler(profiler_capture, nullptr);
+}
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -15,7 +16,10 @@
 
 #include "driver/uart.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "hal/hal_esp32.h"
+#include "platform/modbus/modbus_master.h"
+#include "platform/modbus/modbus_poller.h"
 
 #define TAG "hal_rs485"
 
@@ -39,45 +43,95 @@ static void tab5_rs485_echo_send(const int port, uint8_t* str, uint8_t length)
     }
 }
 
+#if !CONFIG_HAL_RS485_MODBUS_MASTER
 static void _rs485_test_task(void* param)
 {
-    // Allocate buffers for UART
-    uint8_t* data  = (uint8_t*)malloc(TAB5_RS485_BUF_SIZE);
-    uint8_t* wdata = (uint8_t*)malloc(TAB5_RS485_BUF_SIZE);
+    // Only used when the rx ring is full, to keep draining the UART
+    uint8_t* scratch = (uint8_t*)malloc(TAB5_RS485_BUF_SIZE);
+    auto& monitor    = GetHAL()->uartMonitorData;
 
-    int count               = 0;
-    uint64_t last_send_time = 0;
     while (1) {
-        // Read data from UART
-        memset(data, 0, TAB5_RS485_BUF_SIZE);
-        int len = uart_read_bytes(tab5_rs485_uart_num, data, TAB5_RS485_BUF_SIZE, TAB5_RS485_PACKET_READ_TICS);
-
-        // Write data back to UART
+        // Read straight into the rx ring; a read never crosses the ring's wrap point
+        auto rx        = monitor.rxRing.WriteSpan();
+        uint8_t* dst   = rx.size > 0 ? rx.data : scratch;
+        size_t dst_len = rx.size > 0 ? std::min<size_t>(rx.size, TAB5_RS485_BUF_SIZE) : TAB5_RS485_BUF_SIZE;
+        int len        = uart_read_bytes(tab5_rs485_uart_num, dst, dst_len, TAB5_RS485_PACKET_READ_TICS);
         if (len > 0) {
-            // printf("Received [%u] : %s\n", len, data);
-            // tab5_rs485_echo_send(tab5_rs485_uart_num, data, len);
-
-            std::lock_guard<std::mutex> lock(GetHAL()->uartMonitorData.mutex);
-            for (int i = 0; i < len; i++) {
-                GetHAL()->uartMonitorData.rxQueue.push(data[i]);
-            }
-            while (GetHAL()->uartMonitorData.rxQueue.size() > 4096) {
-                GetHAL()->uartMonitorData.rxQueue.pop();
+            if (rx.size > 0) {
+                monitor.rxRing.CommitWrite(len);
+            } else {
+                monitor.rxDropped += len;
             }
         }
 
-        {
-            std::lock_guard<std::mutex> lock(GetHAL()->uartMonitorData.mutex);
-            while (!GetHAL()->uartMonitorData.txQueue.empty()) {
-                uint8_t txData = GetHAL()->uartMonitorData.txQueue.front();
-                GetHAL()->uartMonitorData.txQueue.pop();
-                uart_write_bytes(tab5_rs485_uart_num, &txData, 1);
+        // Hand the driver whole spans of pending tx bytes (two calls when they wrap)
+        for (auto tx = monitor.txRing.ReadSpan(); tx.size > 0; tx = monitor.txRing.ReadSpan()) {
+            int written = uart_write_bytes(tab5_rs485_uart_num, tx.data, tx.size);
+            if (written <= 0) {
+                ESP_LOGE(TAG, "uart write failed: %d", written);
+                break;
             }
+            monitor.txRing.CommitRead(written);
         }
 
         vTaskDelay(10 / portTICK_PERIOD_MS);
     }
 }
+#endif
+
+#if CONFIG_HAL_RS485_MODBUS_MASTER
+// The UART runs in RS485 half-duplex mode, so DE is handled by the driver and a write is done
+// once the TX FIFO has drained
+class Rs485UartTransport : public custom::platform::ModbusTransport {
+public:
+    bool Write(const uint8_t* data, size_t length) override
+    {
+        if (uart_write_bytes(tab5_rs485_uart_num, data, length) != (int)length) {
+            return false;
+        }
+        return uart_wait_tx_done(tab5_rs485_uart_num, pdMS_TO_TICKS(50)) == ESP_OK;
+    }
+
+    size_t Read(uint8_t* out, size_t max, std::chrono::microseconds timeout) override
+    {
+        // Round up to whole ticks so the 1750 us frame gap is never cut short
+        const uint32_t timeout_ms = (uint32_t)((timeout.count() + 999) / 1000);
+        const TickType_t ticks    = std::max<TickType_t>(1, pdMS_TO_TICKS(timeout_ms));
+        const int len             = uart_read_bytes(tab5_rs485_uart_num, out, max, ticks);
+        return len > 0 ? (size_t)len : 0;
+    }
+
+    void DiscardInput() override
+    {
+        uart_flush_input(tab5_rs485_uart_num);
+    }
+};
+
+static std::unique_ptr<Rs485UartTransport> _modbus_transport;
+static std::unique_ptr<custom::platform::ModbusMaster> _modbus_master;
+static std::unique_ptr<custom::platform::ModbusPoller> _modbus_poller;
+
+static void _rs485_modbus_task(void* param)
+{
+    while (1) {
+        // Re-check at least every 100 ms so polls added from the UI start promptly
+        const auto wait        = _modbus_poller->RunOnce();
+        const uint32_t wait_ms = std::min<uint32_t>((uint32_t)(wait.count() / 1000), 100);
+        if (wait_ms > 0) {
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+        }
+    }
+}
+#endif
+
+custom::platform::ModbusPoller* HalEsp32::getModbusPoller()
+{
+#if CONFIG_HAL_RS485_MODBUS_MASTER
+    return _modbus_poller.get();
+#else
+    return nullptr;
+#endif
+}
 
 void HalEsp32::rs485_init()
 {
@@ -111,5 +165,19 @@ void HalEsp32::rs485_init()
     // Set read timeout of UART TOUT feature
     ESP_ERROR_CHECK(uart_set_rx_timeout(tab5_rs485_uart_num, TAB5_RS485_READ_TOUT));
 
+#if CONFIG_HAL_RS485_MODBUS_MASTER
+    custom::platform::ModbusMaster::Config modbus_config;
+    modbus_config.baud     = uart_config.baud_rate;
+    modbus_config.clock    = []() { return (uint64_t)esp_timer_get_time(); };
+    modbus_config.sleep_us = [](uint64_t us) {
+        vTaskDelay(std::max<TickType_t>(1, pdMS_TO_TICKS((uint32_t)((us + 999) / 1000))));
+    };
+    _modbus_transport = std::make_unique<Rs485UartTransport>();
+    _modbus_master    = std::make_unique<custom::platform::ModbusMaster>(*_modbus_transport, modbus_config);
+    _modbus_poller    = std::make_unique<custom::platform::ModbusPoller>(*_modbus_master);
+    mclog::tagInfo(TAG, "modbus master, t3.5 = {} us", _modbus_master->Timing().t35_us);
+    xTaskCreate(_rs485_modbus_task, "modbus", 4096, NULL, 5, NULL);
+#else
     xTaskCreate(_rs485_test_task, "rs485", 2000, NULL, 5, NULL);
+#endif
 }
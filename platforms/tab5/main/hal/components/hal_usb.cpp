@@ -77,29 +77,39 @@ static void hid_host_mouse_report_callback(const uint8_t* const data, const int
         return;
     }
 
-    static int x_pos = 720 / 2;
-    static int y_pos = 1280 / 2;
-
-    // Calculate absolute position from displacement
-    x_pos += mouse_report->y_displacement;
-    y_pos -= mouse_report->x_displacement;
+    hid_print_new_device_report_header(HID_PROTOCOL_MOUSE);
 
-    x_pos = std::clamp(x_pos, 0, 720);
-    y_pos = std::clamp(y_pos, 0, 1280);
+    // The panel is mounted rotated: mouse Y moves along screen X, mouse X against screen Y.
+    // Every report is queued; the indev read callback sums motion and keeps button edges.
+    custom::platform::PointerReport report;
+    report.dx      = mouse_report->y_displacement;
+    report.dy      = -mouse_report->x_displacement;
+    report.buttons = (mouse_report->buttons.button1 ? 0x01 : 0) | (mouse_report->buttons.button2 ? 0x02 : 0) |
+                     (mouse_report->buttons.button3 ? 0x04 : 0);
+    GetHAL()->hidInputData.pointer.Push(report);
+}
 
-    hid_print_new_device_report_header(HID_PROTOCOL_MOUSE);
+static custom::platform::KeyboardReportDecoder _keyboard_decoder;
 
-    // printf("X: %06d\tY: %06d\t|%c|%c|\r", x_pos, y_pos, (mouse_report->buttons.button1 ? 'o' : ' '),
-    //        (mouse_report->buttons.button2 ? 'o' : ' '));
+static void hid_host_keyboard_report_callback(const uint8_t* const data, const int length)
+{
+    hid_print_new_device_report_header(HID_PROTOCOL_KEYBOARD);
 
-    GetHAL()->hidMouseData.mutex.lock();
-    GetHAL()->hidMouseData.x        = x_pos;
-    GetHAL()->hidMouseData.y        = y_pos;
-    GetHAL()->hidMouseData.btnLeft  = mouse_report->buttons.button1;
-    GetHAL()->hidMouseData.btnRight = mouse_report->buttons.button2;
-    GetHAL()->hidMouseData.mutex.unlock();
+    custom::platform::KeyEvent edges[custom::platform::KeyboardReportDecoder::kBootKeys * 2];
+    const size_t count = _keyboard_decoder.Decode(data, length, edges, sizeof(edges) / sizeof(edges[0]));
+    if (count == 0) {
+        return;
+    }
+    auto& input          = GetHAL()->hidInputData;
+    const size_t written = input.keys.Push(edges, count);
+    input.keysDropped += static_cast<uint32_t>(count - written);
+}
 
-    fflush(stdout);
+static void hid_host_keyboard_release_all()
+{
+    // An all-zero report releases whatever was held when the keyboard went away
+    const uint8_t empty[2 + custom::platform::KeyboardReportDecoder::kBootKeys] = {0};
+    hid_host_keyboard_report_callback(empty, sizeof(empty));
 }
 
 void hid_host_interface_callback(hid_host_device_handle_t hid_device_handle, const hid_host_interface_event_t event,
@@ -116,7 +126,7 @@ void hid_host_interface_callback(hid_host_device_handle_t hid_device_handle, con
 
             if (HID_SUBCLASS_BOOT_INTERFACE == dev_params.sub_class) {
                 if (HID_PROTOCOL_KEYBOARD == dev_params.proto) {
-                    // hid_host_keyboard_report_callback(data, data_length);
+                    hid_host_keyboard_report_callback(data, data_length);
                 } else if (HID_PROTOCOL_MOUSE == dev_params.proto) {
                     hid_host_mouse_report_callback(data, data_length);
                 }
@@ -128,10 +138,14 @@ void hid_host_interface_callback(hid_host_device_handle_t hid_device_handle, con
         case HID_HOST_INTERFACE_EVENT_DISCONNECTED:
             ESP_LOGI(TAG, "HID Device, protocol '%s' DISCONNECTED", hid_proto_name_str[dev_params.proto]);
             ESP_ERROR_CHECK(hid_host_device_close(hid_device_handle));
+            if (HID_PROTOCOL_KEYBOARD == dev_params.proto) {
+                hid_host_keyboard_release_all();
+            }
 
             _usba_detect_mutex.lock();
             _is_usba_connected = false;
             _usba_detect_mutex.unlock();
+            GetHAL()->notifySystemState(shared_data::SystemStateEvent_t::UsbHidDevice, 0);
 
             break;
         case HID_HOST_INTERFACE_EVENT_TRANSFER_ERROR:
@@ -166,6 +180,7 @@ void hid_host_device_event(hid_host_device_handle_t hid_device_handle, const hid
             _usba_detect_mutex.lock();
             _is_usba_connected = true;
             _usba_detect_mutex.unlock();
+            GetHAL()->notifySystemState(shared_data::SystemStateEvent_t::UsbHidDevice, 1);
 
             break;
         }
@@ -235,10 +250,16 @@ static void tab5_usb_host_task(void* pvParameters)
 
 static void lvgl_mouse_read_cb(lv_indev_t* indev, lv_indev_data_t* data)
 {
+    // Cursor position lives on the LVGL side; the HID task only sends deltas
+    static custom::platform::PointerState cursor = {720 / 2, 1280 / 2, 0};
+    auto& pointer                                = GetHAL()->hidInputData.pointer;
+
     _usba_detect_mutex.lock();
     if (!_is_usba_connected) {
         _usba_detect_mutex.unlock();
-        data->state = LV_INDEV_STATE_REL;
+        pointer.Clear();
+        cursor.buttons = 0;
+        data->state    = LV_INDEV_STATE_REL;
         if (lv_obj_get_style_opa(_cursor_img, LV_PART_MAIN) == LV_OPA_COVER) {
             lv_obj_set_style_opa(_cursor_img, LV_OPA_TRANSP, LV_PART_MAIN);
         }
@@ -249,10 +270,88 @@ static void lvgl_mouse_read_cb(lv_indev_t* indev, lv_indev_data_t* data)
         lv_obj_set_style_opa(_cursor_img, LV_OPA_COVER, LV_PART_MAIN);
     }
 
-    std::lock_guard<std::mutex> lock(GetHAL()->hidMouseData.mutex);
-    data->point.x = GetHAL()->hidMouseData.x;
-    data->point.y = GetHAL()->hidMouseData.y;
-    data->state   = GetHAL()->hidMouseData.btnLeft ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    // One batch per read: all pending motion up to the next button edge. If more reports are
+    // queued LVGL calls straight back in, so a quick click is seen as press and release.
+    const uint8_t last_buttons = cursor.buttons;
+    data->continue_reading     = pointer.Drain(cursor, 720, 1280);
+    data->point.x              = cursor.x;
+    data->point.y              = cursor.y;
+    data->state                = (cursor.buttons & 0x01) ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+    if (cursor.buttons != last_buttons) {
+        GetHAL()->notifyInput(shared_data::InputEvent_t::HidMouseButton, cursor.buttons, cursor.x, cursor.y);
+    }
+}
+
+// HID keyboard usage (boot protocol) to an LVGL key; 0 for keys LVGL has no use for
+static uint32_t hid_usage_to_lv_key(uint8_t usage, uint8_t modifiers)
+{
+    static const char kDigits[]         = "1234567890";
+    static const char kShiftedDigits[]  = "!@#$%^&*()";
+    static const char kSymbols[]        = "-=[]\\#;'`,./";
+    static const char kShiftedSymbols[] = "_+{}|~:\"~<>?";
+    const bool shift                    = (modifiers & 0x22) != 0;  // left or right shift
+
+    if (usage >= 0x04 && usage <= 0x1D) {
+        return (shift ? 'A' : 'a') + (usage - 0x04);
+    }
+    if (usage >= 0x1E && usage <= 0x27) {
+        return (shift ? kShiftedDigits : kDigits)[usage - 0x1E];
+    }
+    if (usage >= 0x2D && usage <= 0x38) {
+        return (shift ? kShiftedSymbols : kSymbols)[usage - 0x2D];
+    }
+    switch (usage) {
+        case 0x28:
+        case 0x58:
+            return LV_KEY_ENTER;
+        case 0x29:
+            return LV_KEY_ESC;
+        case 0x2A:
+            return LV_KEY_BACKSPACE;
+        case 0x2B:
+            return shift ? LV_KEY_PREV : LV_KEY_NEXT;
+        case 0x2C:
+            return ' ';
+        case 0x4A:
+            return LV_KEY_HOME;
+        case 0x4C:
+            return LV_KEY_DEL;
+        case 0x4D:
+            return LV_KEY_END;
+        case 0x4F:
+            return LV_KEY_RIGHT;
+        case 0x50:
+            return LV_KEY_LEFT;
+        case 0x51:
+            return LV_KEY_DOWN;
+        case 0x52:
+            return LV_KEY_UP;
+        default:
+            return 0;
+    }
+}
+
+static void lvgl_keyboard_read_cb(lv_indev_t* indev, lv_indev_data_t* data)
+{
+    static uint32_t last_key = 0;
+    auto& keys               = GetHAL()->hidInputData.keys;
+
+    // One edge per read so LVGL sees every press and release in order
+    custom::platform::KeyEvent event;
+    while (keys.Pop(&event, 1) == 1) {
+        const uint32_t key = hid_usage_to_lv_key(event.usage, event.modifiers);
+        if (key == 0) {
+            continue;
+        }
+        last_key               = key;
+        data->key              = key;
+        data->state            = event.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        data->continue_reading = !keys.Empty();
+        return;
+    }
+    data->key   = last_key;
+    data->state = LV_INDEV_STATE_RELEASED;
 }
 
 void HalEsp32::hid_init()
@@ -268,6 +367,12 @@ void HalEsp32::hid_init()
     _cursor_img = lv_image_create(lv_screen_active()); /*Create an image object for the cursor */
     lv_image_set_src(_cursor_img, &mouse_cursor);      /*Set the image source*/
     lv_indev_set_cursor(lvMouse, _cursor_img);         /*Connect the image  object to the driver*/
+
+    auto lvKeyboard = lv_indev_create();
+    lv_indev_set_type(lvKeyboard, LV_INDEV_TYPE_KEYPAD);
+    lv_indev_set_read_cb(lvKeyboard, lvgl_keyboard_read_cb);
+    lv_indev_set_display(lvKeyboard, lvDisp);
+    lv_indev_set_group(lvKeyboard, lv_group_get_default());
 }
 
 bool HalEsp32::usbADetect()
@@ -109,6 +109,10 @@ void HalEsp32::init()
 {
     mclog::tagInfo(_tag, "init");
 
+    // First, so the allocation site table sees as much of the boot as it can
+    mclog::tagInfo(_tag, "heap diag init");
+    heap_diag_init();
+
     mclog::tagInfo(_tag, "camera init");
     bsp_cam_osc_init();
 
@@ -189,6 +193,10 @@ void HalEsp32::init()
         {
             lv_display_set_rotation(lvDisp, LV_DISPLAY_ROTATION_90);
             mclog::tagInfo(_tag, "Display rotation set to 90 degrees");
+
+            // Set before the UI is built, so its focusable widgets join the group the USB
+            // keyboard is attached to, as on desktop
+            lv_group_set_default(lv_group_create());
         }
     }
 
@@ -217,6 +225,7 @@ void HalEsp32::init()
                 lv_indev_set_display(lvTouchpad, lvDisp);
             }
         }
+        instrumentLvglInputLatency(lvTouchpad, lvDisp);
 
         bsp_display_unlock();
         display_locked = false;
@@ -235,6 +244,15 @@ void HalEsp32::init()
     mclog::tagInfo(_tag, "rs485 init");
     rs485_init();
 
+    mclog::tagInfo(_tag, "audio diag init");
+    audio_diag_init();
+
+    mclog::tagInfo(_tag, "metrics diag init");
+    metrics_diag_init();
+
+    mclog::tagInfo(_tag, "profiler diag init");
+    profiler_diag_init();
+
     mclog::tagInfo(_tag, "set gpio output capability");
     set_gpio_output_capability();
 }
@@ -354,6 +372,7 @@ void HalEsp32::setDisplayBrightness(uint8_t brightness)
     _current_lcd_brightness = std::clamp((int)brightness, 0, 100);
     mclog::tagInfo("hal", "set display brightness: {}%", _current_lcd_brightness);
     bsp_display_brightness_set(_current_lcd_brightness);
+    notifySystemState(shared_data::SystemStateEvent_t::DisplayBrightness, _current_lcd_brightness);
 }
 
 uint8_t HalEsp32::getDisplayBrightness()
@@ -61,6 +61,7 @@ public:
     uint8_t getSpeakerVolume() override;
     void audioRecord(std::vector<int16_t>& data, uint16_t durationMs, float gain = 80.0f) override;
     void audioPlay(std::vector<int16_t>& data, bool async = true) override;
+    custom::platform::AudioStatsSnapshot getAudioStats() override;
     void startDualMicRecordTest() override;
     MicTestState_t getDualMicRecordTestState() override;
     void startHeadphoneMicRecordTest() override;
@@ -68,6 +69,8 @@ public:
     void startPlayMusicTest() override;
     MusicPlayState_t getMusicPlayTestState() override;
     void stopPlayMusicTest() override;
+    bool playAudioFile(const std::string& uri) override;
+    bool canPlayAudioFile(const std::string& uri) override;
     void playStartupSfx() override;
     void playShutdownSfx() override;
 
@@ -87,11 +90,16 @@ public:
     void gpioInitOutput(uint8_t pin) override;
     void gpioSetLevel(uint8_t pin, bool level) override;
     void gpioReset(uint8_t pin) override;
+    custom::platform::ModbusPoller* getModbusPoller() override;
 
 private:
     void set_gpio_output_capability();
     void hid_init();
     void rs485_init();
+    void audio_diag_init();
+    void metrics_diag_init();
+    void profiler_diag_init();
+    void heap_diag_init();
     bool wifi_init();
     void imu_init();
     void update_system_time();
@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Page-switch cost with and without the decoded-image cache. Each switch releases the old
+// page's images and acquires the new page's full-screen wallpaper plus icons, as the UI does
+// when it tears one page down and builds the next. "Decoding" converts packed RGB888 to
+// RGB565, so the numbers are a lower bound for PNG or compressed sources.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "assets/asset_cache.h"
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchImage
+    {
+        std::uint32_t             width;
+        std::uint32_t             height;
+        std::vector<std::uint8_t> rgb888;
+    };
+
+    struct BenchPage
+    {
+        const char*              name;
+        std::vector<std::string> images;
+    };
+
+    constexpr int kSwitches = 200;
+
+    std::map<std::string, BenchImage> g_images;
+
+    void AddImage(const std::string& id, std::uint32_t w, std::uint32_t h)
+    {
+        BenchImage image{w, h, std::vector<std::uint8_t>(static_cast<std::size_t>(w) * h * 3U)};
+        for (std::size_t i = 0; i < image.rgb888.size(); ++i)
+        {
+            image.rgb888[i] = static_cast<std::uint8_t>(i * 7U);
+        }
+        g_images.emplace(id, std::move(image));
+    }
+
+    void* DecodeRgb888(void*, const char* id, std::size_t* out_size)
+    {
+        const auto it = g_images.find(id);
+        if (it == g_images.end())
+        {
+            return nullptr;
+        }
+        const BenchImage& src    = it->second;
+        const std::size_t pixels = static_cast<std::size_t>(src.width) * src.height;
+        auto* dst = static_cast<std::uint16_t*>(std::malloc(pixels * sizeof(std::uint16_t)));
+        if (dst == nullptr)
+        {
+            return nullptr;
+        }
+        const std::uint8_t* p = src.rgb888.data();
+        for (std::size_t i = 0; i < pixels; ++i, p += 3)
+        {
+            dst[i] = static_cast<std::uint16_t>(((p[0] & 0xF8U) << 8) | ((p[1] & 0xFCU) << 3)
+                                                | (p[2] >> 3));
+        }
+        *out_size = pixels * sizeof(std::uint16_t);
+        return dst;
+    }
+
+    void DiscardImage(void*, void* data)
+    {
+        std::free(data);
+    }
+
+    std::vector<BenchPage> MakeDashboard()
+    {
+        AddImage("wallpaper", 1280U, 720U);
+        AddImage("media_artwork", 400U, 400U);
+        std::vector<BenchPage> pages = {{"home", {}}, {"rooms", {}}, {"media", {"media_artwork"}},
+                                        {"settings", {}}};
+        const int icons[] = {6, 12, 4, 8};
+        for (std::size_t p = 0; p < pages.size(); ++p)
+        {
+            pages[p].images.insert(pages[p].images.begin(), "wallpaper");
+            for (int i = 0; i < icons[p]; ++i)
+            {
+                const std::string id = std::string(pages[p].name) + "_icon_" + std::to_string(i);
+                AddImage(id, 96U, 96U);
+                pages[p].images.push_back(id);
+            }
+        }
+        return pages;
+    }
+
+    void RunCase(const char* name, const std::vector<BenchPage>& pages, std::size_t budget, bool pin)
+    {
+        asset_cache_config_t config = {};
+        config.budget_bytes         = budget;
+        config.decode               = DecodeRgb888;
+        config.discard              = DiscardImage;
+        asset_cache_t* cache        = asset_cache_create(&config);
+        if (pin)
+        {
+            asset_cache_pin(cache, "wallpaper");
+        }
+
+        // Show the first page once so every case starts from the same state.
+        for (const auto& id : pages[0].images)
+        {
+            asset_cache_acquire(cache, id.c_str());
+        }
+        asset_cache_reset_stats(cache);
+
+        double worst_ms = 0.0;
+        auto   start    = Clock::now();
+        for (int i = 0; i < kSwitches; ++i)
+        {
+            const BenchPage& from = pages[static_cast<std::size_t>(i) % pages.size()];
+            const BenchPage& to   = pages[static_cast<std::size_t>(i + 1) % pages.size()];
+
+            const auto switch_start = Clock::now();
+            for (const auto& id : from.images)
+            {
+                asset_cache_release(cache, id.c_str());
+            }
+            for (const auto& id : to.images)
+            {
+                asset_cache_acquire(cache, id.c_str());
+            }
+            const double ms =
+                std::chrono::duration<double, std::milli>(Clock::now() - switch_start).count();
+            worst_ms = ms > worst_ms ? ms : worst_ms;
+        }
+        const double total_ms =
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        asset_cache_stats_t stats = {};
+        asset_cache_get_stats(cache, &stats);
+        std::printf("%-22s %8.3f ms/switch  worst %7.3f ms  hits %5u  misses %5u  evictions %5u  "
+                    "peak %5.2f MB\n",
+                    name,
+                    total_ms / kSwitches,
+                    worst_ms,
+                    stats.hits,
+                    stats.misses,
+                    stats.evictions,
+                    static_cast<double>(stats.bytes_peak) / (1024.0 * 1024.0));
+        asset_cache_destroy(cache);
+    }
+
+}  // namespace
+
+int main()
+{
+    const auto pages = MakeDashboard();
+    std::printf("page switches: %d across %zu pages (1280x720 wallpaper + 96x96 icons)\n",
+                kSwitches,
+                pages.size());
+    RunCase("no cache", pages, 0U, false);
+    RunCase("2 MB, wallpaper pinned", pages, 2U * 1024U * 1024U, true);
+    RunCase("8 MB, wallpaper pinned", pages, 8U * 1024U * 1024U, true);
+    return 0;
+}
@@ -0,0 +1,270 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Decode cost of compressed bundle entries. Encodes a synthetic 1280x720 wallpaper (flat
+// panels plus a gradient) with the same band layout and encoders as tools/gen_assets.py,
+// then decodes it band by band the way the image cache does.
+//
+//   bench_asset_decode                              built-in wallpaper, none / rle / lz4
+//   bench_asset_decode out/assets/assets.bundle     also every entry of a generated bundle
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "assets/asset_codec.h"
+
+namespace
+{
+
+    using Clock   = std::chrono::steady_clock;
+    using Buffer  = std::vector<std::uint8_t>;
+    using Encoder = std::function<Buffer(const std::uint8_t*, std::size_t)>;
+
+    constexpr std::uint16_t kWidth    = 1280U;
+    constexpr std::uint16_t kHeight   = 720U;
+    constexpr std::uint16_t kBandRows = 16U;
+    constexpr int           kRepeats  = 20;
+
+    Buffer EncodeRle16(const std::uint8_t* data, std::size_t len)
+    {
+        const std::size_t count = len / 2U;
+        auto              px    = [data](std::size_t i) {
+            return static_cast<std::uint16_t>(data[2 * i] | (data[2 * i + 1] << 8));
+        };
+        Buffer      out;
+        std::size_t i = 0U;
+        while (i < count)
+        {
+            std::size_t run = 1U;
+            while (i + run < count && run < 128U && px(i + run) == px(i))
+            {
+                ++run;
+            }
+            if (run >= 2U)
+            {
+                out.push_back(static_cast<std::uint8_t>(0x80U | (run - 1U)));
+                out.insert(out.end(), data + 2 * i, data + 2 * i + 2);
+                i += run;
+                continue;
+            }
+            const std::size_t start = i++;
+            while (i < count && i - start < 128U && !(i + 1U < count && px(i) == px(i + 1U)))
+            {
+                ++i;
+            }
+            out.push_back(static_cast<std::uint8_t>(i - start - 1U));
+            out.insert(out.end(), data + 2 * start, data + 2 * i);
+        }
+        return out;
+    }
+
+    void PutLz4Length(Buffer& out, std::size_t value)
+    {
+        for (; value >= 255U; value -= 255U)
+        {
+            out.push_back(255U);
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void PutLz4Sequence(Buffer&             out,
+                        const std::uint8_t* literals,
+                        std::size_t         literal_len,
+                        std::size_t         offset,
+                        std::size_t         match)
+    {
+        const std::size_t match_code = offset != 0U ? match - 4U : 0U;
+        out.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(literal_len, 15U) << 4)
+                                                | std::min<std::size_t>(match_code, 15U)));
+        if (literal_len >= 15U)
+        {
+            PutLz4Length(out, literal_len - 15U);
+        }
+        out.insert(out.end(), literals, literals + literal_len);
+        if (offset != 0U)
+        {
+            out.push_back(static_cast<std::uint8_t>(offset & 0xFFU));
+            out.push_back(static_cast<std::uint8_t>(offset >> 8));
+            if (match_code >= 15U)
+            {
+                PutLz4Length(out, match_code - 15U);
+            }
+        }
+    }
+
+    /** Greedy LZ4 block encoder with the same spec limits as lz4_encode() in gen_assets.py. */
+    Buffer EncodeLz4(const std::uint8_t* data, std::size_t len)
+    {
+        Buffer                                         out;
+        std::unordered_map<std::uint32_t, std::size_t> table;
+        std::size_t                                    anchor = 0U;
+        std::size_t                                    i      = 0U;
+        while (len > 12U && i < len - 12U)
+        {
+            std::uint32_t key;
+            std::memcpy(&key, data + i, sizeof(key));
+            const auto found = table.find(key);
+            const bool hit   = found != table.end() && i - found->second <= 0xFFFFU;
+            const std::size_t candidate = hit ? found->second : 0U;
+            table[key]                  = i;
+            if (!hit)
+            {
+                ++i;
+                continue;
+            }
+            std::size_t       match = 4U;
+            const std::size_t limit = len - 5U - i;
+            while (match < limit && data[candidate + match] == data[i + match])
+            {
+                ++match;
+            }
+            PutLz4Sequence(out, data + anchor, i - anchor, i - candidate, match);
+            i += match;
+            anchor = i;
+        }
+        PutLz4Sequence(out, data + anchor, len - anchor, 0U, 0U);
+        return out;
+    }
+
+    Buffer PackBands(const Buffer& pixels, std::uint16_t stride, const Encoder& encode)
+    {
+        std::vector<Buffer> bands;
+        for (std::size_t row = 0U; row < kHeight; row += kBandRows)
+        {
+            const std::size_t begin = row * stride;
+            const std::size_t end =
+                std::min<std::size_t>(pixels.size(), begin + std::size_t{kBandRows} * stride);
+            bands.push_back(encode(pixels.data() + begin, end - begin));
+        }
+        Buffer blob;
+        auto   put = [&blob](std::uint32_t v, int bytes) {
+            for (int i = 0; i < bytes; ++i)
+            {
+                blob.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+            }
+        };
+        put(kBandRows, 2);
+        put(static_cast<std::uint32_t>(bands.size()), 2);
+        std::uint32_t offset = 0U;
+        put(offset, 4);
+        for (const auto& band : bands)
+        {
+            offset += static_cast<std::uint32_t>(band.size());
+            put(offset, 4);
+        }
+        for (const auto& band : bands)
+        {
+            blob.insert(blob.end(), band.begin(), band.end());
+        }
+        return blob;
+    }
+
+    Buffer MakeWallpaper()
+    {
+        Buffer pixels(static_cast<std::size_t>(kWidth) * kHeight * 2U);
+        for (std::uint32_t y = 0; y < kHeight; ++y)
+        {
+            for (std::uint32_t x = 0; x < kWidth; ++x)
+            {
+                std::uint16_t v;
+                if (y < 96U || (x > 80U && x < 560U && y > 160U && y < 640U))
+                {
+                    v = 0xFFFFU;  // app bar and a card
+                }
+                else
+                {
+                    v = static_cast<std::uint16_t>(((y * 31U / kHeight) << 11)
+                                                   | ((x * 63U / kWidth) << 5) | 0x10U);
+                }
+                const std::size_t i = (static_cast<std::size_t>(y) * kWidth + x) * 2U;
+                pixels[i]           = static_cast<std::uint8_t>(v & 0xFFU);
+                pixels[i + 1]       = static_cast<std::uint8_t>(v >> 8);
+            }
+        }
+        return pixels;
+    }
+
+    void RunEntry(const char* name, const asset_bundle_entry_t& entry, const Buffer* expected)
+    {
+        Buffer dst(entry.raw_size);
+        double best_ms = 1e9;
+        for (int i = 0; i < kRepeats; ++i)
+        {
+            const auto start = Clock::now();
+            if (!asset_bundle_decode(&entry, dst.data()))
+            {
+                std::printf("%-28s decode failed\n", name);
+                return;
+            }
+            const double ms =
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            best_ms = ms < best_ms ? ms : best_ms;
+        }
+        if (expected != nullptr && dst != *expected)
+        {
+            std::printf("%-28s MISMATCH\n", name);
+            return;
+        }
+        std::printf("%-28s %5ux%-4u stored %8.1f KB  ratio %5.2f  decode %7.3f ms  %7.1f MB/s\n",
+                    name,
+                    entry.width,
+                    entry.height,
+                    entry.data_size / 1024.0,
+                    static_cast<double>(entry.data_size) / entry.raw_size,
+                    best_ms,
+                    entry.raw_size / (best_ms * 1000.0));
+    }
+
+    asset_bundle_entry_t WallpaperEntry(const Buffer& blob, std::uint8_t compression)
+    {
+        asset_bundle_entry_t entry = {};
+        entry.data                 = blob.data();
+        entry.data_size            = static_cast<std::uint32_t>(blob.size());
+        entry.width                = kWidth;
+        entry.height               = kHeight;
+        entry.stride               = kWidth * 2U;
+        entry.raw_size             = static_cast<std::uint32_t>(entry.stride) * kHeight;
+        entry.format               = ASSET_FORMAT_RGB565;
+        entry.compression          = compression;
+        return entry;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const Buffer wallpaper = MakeWallpaper();
+    const Buffer rle       = PackBands(wallpaper, kWidth * 2U, EncodeRle16);
+    const Buffer lz4       = PackBands(wallpaper, kWidth * 2U, EncodeLz4);
+
+    std::printf("best of %d decodes, %u-row bands\n", kRepeats, kBandRows);
+    RunEntry("wallpaper none", WallpaperEntry(wallpaper, ASSET_COMPRESSION_NONE), &wallpaper);
+    RunEntry("wallpaper rle", WallpaperEntry(rle, ASSET_COMPRESSION_RLE16), &wallpaper);
+    RunEntry("wallpaper lz4", WallpaperEntry(lz4, ASSET_COMPRESSION_LZ4), &wallpaper);
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        asset_bundle_t bundle;
+        if (!asset_bundle_open(&bundle, argv[arg]))
+        {
+            std::fprintf(stderr, "cannot open bundle %s\n", argv[arg]);
+            return 1;
+        }
+        for (std::uint32_t i = 0; i < bundle.entry_count; ++i)
+        {
+            asset_bundle_entry_t entry;
+            if (asset_bundle_entry_at(&bundle, i, &entry))
+            {
+                RunEntry(entry.id, entry, nullptr);
+            }
+        }
+        asset_bundle_close(&bundle);
+    }
+    return 0;
+}
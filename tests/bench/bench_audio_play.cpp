@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Drives the audioPlay() clip queue at increasing trigger rates against a simulated
+// I2S sink (blocking writes, two periods of DMA) and reports what the HALs would export.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "platform/audio/audio_play_queue.h"
+
+namespace
+{
+
+    using custom::platform::AudioPlayQueue;
+    using custom::platform::AudioStats;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uint32_t kSampleRate    = 48000U;
+    constexpr std::size_t   kPeriodFrames  = 480U;
+    constexpr std::uint64_t kDmaDepthUs    = 20000U;
+    constexpr std::size_t   kClickFrames   = 960U;  // 20 ms, like the UI tones
+    constexpr int           kRunMs         = 1000;
+
+    std::uint64_t NowUs()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                              Clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    /** Blocks like i2s_write() once more than kDmaDepthUs of audio is pending. */
+    class SimulatedI2s
+    {
+    public:
+        void Write(const std::int16_t*, std::size_t count)
+        {
+            const std::uint64_t now   = NowUs();
+            const std::uint64_t start = drained_at_ > now ? drained_at_ : now;
+            drained_at_ = start + (count / 2U) * 1000000ULL / kSampleRate;
+            if (drained_at_ > now + kDmaDepthUs)
+            {
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(drained_at_ - kDmaDepthUs - now));
+            }
+        }
+
+    private:
+        std::uint64_t drained_at_ = 0U;
+    };
+
+    void RunAtInterval(int interval_us)
+    {
+        SimulatedI2s device;
+        AudioStats   stats;
+
+        AudioPlayQueue::Config config;
+        config.sample_rate           = kSampleRate;
+        config.period_frames         = kPeriodFrames;
+        config.device_latency_frames = static_cast<std::uint32_t>(kDmaDepthUs * kSampleRate / 1000000U);
+        AudioPlayQueue queue(
+            [&device](const std::int16_t* samples, std::size_t count) { device.Write(samples, count); },
+            config,
+            stats);
+
+        std::atomic<bool> running{true};
+        std::thread       worker([&]() {
+            while (running.load())
+            {
+                queue.PlayNext(std::chrono::milliseconds(5));
+            }
+        });
+
+        const std::vector<std::int16_t> click(kClickFrames * 2U, 4000);
+        const auto                      end       = Clock::now() + std::chrono::milliseconds(kRunMs);
+        int                             submitted = 0;
+        while (Clock::now() < end)
+        {
+            queue.Submit(click, queue.Now());
+            ++submitted;
+            std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+        }
+
+        running.store(false);
+        worker.join();
+
+        const auto s = stats.Snapshot();
+        std::printf("%8d us | %6d | %6u | %7u | %9u | %9u | %9u | %8u | %9u\n",
+                    interval_us,
+                    submitted,
+                    s.clips_played,
+                    s.dropped_clips,
+                    s.underruns,
+                    s.trigger_to_sound_us.avg_us,
+                    s.trigger_to_sound_us.max_us,
+                    s.write_us.avg_us,
+                    s.max_queue_depth);
+    }
+
+}  // namespace
+
+int main()
+{
+    std::printf("interval    | submit | played | dropped | underruns | t2s avg   | t2s max   | write avg | max depth\n");
+    for (int interval_us : {100000, 50000, 20000, 10000, 5000, 1000})
+    {
+        RunAtInterval(interval_us);
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Publish/dispatch cost of the shared event buses. The old design was a signal of
+// std::string: every emit built a string (heap-allocated once past the small-string buffer)
+// and copied it through a std::function per subscriber, and each subscriber compared it
+// against the names it cares about. That baseline is rebuilt here next to EventBus::Publish()
+// (same thread) and EventBus::Post() + Dispatch() (queued, drained in batches), all with
+// four subscribers of which one matches the topic.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "platform/event_bus.h"
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kEvents      = 200000;
+    constexpr int kSubscribers = 4;
+
+    enum class BenchTopic : std::uint8_t
+    {
+        DisplayBrightness,
+        SpeakerVolume,
+        ChargeEnable,
+        UsbHidDevice,
+    };
+
+    struct BenchPayload
+    {
+        std::int32_t value = 0;
+        std::int16_t x     = 0;
+        std::int16_t y     = 0;
+    };
+
+    using Bus = custom::platform::EventBus<BenchTopic, BenchPayload, 8U, 64U>;
+
+    const char* const kTopicNames[kSubscribers] = {
+        "system.display_brightness_changed",
+        "system.speaker_volume_changed",
+        "system.charge_enable_changed",
+        "system.usb_hid_device_changed",
+    };
+
+    volatile std::int64_t g_sink = 0;
+
+    double NsPerEvent(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kEvents;
+    }
+
+    double BenchStringSignal()
+    {
+        std::vector<std::function<void(std::string)>> slots;
+        for (int s = 0; s < kSubscribers; ++s)
+        {
+            const std::string wanted = kTopicNames[s];
+            slots.emplace_back([wanted](std::string event) {
+                if (event.compare(0, wanted.size(), wanted) == 0)
+                {
+                    g_sink = g_sink + static_cast<std::int64_t>(event.size());
+                }
+            });
+        }
+
+        const auto start = Clock::now();
+        for (int i = 0; i < kEvents; ++i)
+        {
+            std::string event = kTopicNames[i % kSubscribers];
+            event += ":" + std::to_string(i & 0xFF);
+            for (auto& slot : slots)
+            {
+                slot(event);
+            }
+        }
+        return NsPerEvent(start);
+    }
+
+    void CountHandler(BenchTopic, const BenchPayload& payload, void*)
+    {
+        g_sink = g_sink + payload.value;
+    }
+
+    void Subscribe(Bus& bus)
+    {
+        for (int s = 0; s < kSubscribers; ++s)
+        {
+            bus.Subscribe(static_cast<BenchTopic>(s), CountHandler);
+        }
+    }
+
+    BenchPayload Payload(int i)
+    {
+        BenchPayload payload;
+        payload.value = i & 0xFF;
+        return payload;
+    }
+
+    double BenchPublish()
+    {
+        Bus bus;
+        Subscribe(bus);
+        const auto start = Clock::now();
+        for (int i = 0; i < kEvents; ++i)
+        {
+            bus.Publish(static_cast<BenchTopic>(i % kSubscribers), Payload(i));
+        }
+        return NsPerEvent(start);
+    }
+
+    double BenchPostDispatch(int batch)
+    {
+        Bus bus;
+        Subscribe(bus);
+        const auto start = Clock::now();
+        for (int i = 0; i < kEvents; i += batch)
+        {
+            for (int b = 0; b < batch; ++b)
+            {
+                bus.Post(static_cast<BenchTopic>((i + b) % kSubscribers), Payload(i + b));
+            }
+            bus.Dispatch();
+        }
+        return NsPerEvent(start);
+    }
+
+    /**
+     * A HAL task posting bursts of 16 events every 500 us while the main loop dispatches once
+     * per 1 ms tick. Reports the producer's cost per Post() and the owner's per delivered event.
+     */
+    void BenchCrossThread()
+    {
+        constexpr int kBursts = 1000;
+        constexpr int kBurst  = 16;
+        Bus           bus;
+        Subscribe(bus);
+
+        double      post_ns = 0.0;
+        std::thread producer([&bus, &post_ns]() {
+            for (int burst = 0; burst < kBursts; ++burst)
+            {
+                const auto start = Clock::now();
+                for (int b = 0; b < kBurst; ++b)
+                {
+                    bus.Post(static_cast<BenchTopic>(b % kSubscribers), Payload(b));
+                }
+                post_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+
+        double      dispatch_ns = 0.0;
+        std::size_t delivered   = 0U;
+        while (delivered + bus.GetStats().dropped < static_cast<std::size_t>(kBursts * kBurst))
+        {
+            const auto start = Clock::now();
+            delivered += bus.Dispatch();
+            dispatch_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        producer.join();
+
+        const Bus::Stats stats = bus.GetStats();
+        std::printf("  cross-thread, 1 ms dispatch   Post %.1f ns, Dispatch %.1f ns/event"
+                    "  (%u batches, max %u, %u dropped)\n",
+                    post_ns / (kBursts * kBurst),
+                    dispatch_ns / static_cast<double>(delivered),
+                    stats.batches,
+                    stats.max_batch,
+                    stats.dropped);
+    }
+
+}  // namespace
+
+int main()
+{
+    std::printf("%d events, %d subscribers (1 matching per event)\n", kEvents, kSubscribers);
+    std::printf("  Signal<std::string> emit      %8.1f ns/event\n", BenchStringSignal());
+    std::printf("  EventBus::Publish             %8.1f ns/event\n", BenchPublish());
+    for (int batch : {1, 8, 32})
+    {
+        std::printf("  Post + Dispatch, batch %-2d     %8.1f ns/event\n",
+                    batch,
+                    BenchPostDispatch(batch));
+    }
+    BenchCrossThread();
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Decode cost of Home Assistant state_changed frames. cJSON builds a DOM (one heap node per
+// key and value) before the handful of fields the rooms page needs can be read;
+// HaDecodeStateChanged() pulls tokens and copies only those fields into a fixed struct. Both
+// run over the same frames, recorded from a Home Assistant 2025.1 instance (ids and context
+// shortened), and the heap is counted by replacing the global operator new/delete and
+// cJSON's hooks.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "cJSON.h"
+#include "integration/ha_state_event.h"
+
+namespace
+{
+
+    using custom::integration::HaDecodeStateChanged;
+    using custom::integration::HaFrameKind;
+    using custom::integration::HaStateChanged;
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kRounds = 20000;
+
+    std::uint64_t g_allocations = 0U;
+    volatile int  g_sink        = 0;
+
+    struct RecordedFrame
+    {
+        const char* name;
+        const char* json;
+    };
+
+    const RecordedFrame kFrames[] = {
+        {"light (on, 11 attributes)",
+         R"({"id":2,"type":"event","event":{"event_type":"state_changed","data":{)"
+         R"("entity_id":"light.kitchen_main","old_state":{"entity_id":"light.kitchen_main",)"
+         R"("state":"off","attributes":{"min_color_temp_kelvin":2202,"max_color_temp_kelvin":)"
+         R"(6535,"supported_color_modes":["color_temp","hs"],"color_mode":null,"brightness":)"
+         R"(null,"color_temp_kelvin":null,"hs_color":null,"rgb_color":null,"xy_color":null,)"
+         R"("friendly_name":"Kitchen main","supported_features":40},"last_changed":)"
+         R"("2025-01-04T18:01:53.902114+00:00","last_reported":"2025-01-04T18:01:53.902114)"
+         R"(+00:00","last_updated":"2025-01-04T18:01:53.902114+00:00","context":{"id":)"
+         R"("01JGTYTJ","parent_id":null,"user_id":null}},"new_state":{"entity_id":)"
+         R"("light.kitchen_main","state":"on","attributes":{"min_color_temp_kelvin":2202,)"
+         R"("max_color_temp_kelvin":6535,"supported_color_modes":["color_temp","hs"],)"
+         R"("color_mode":"color_temp","brightness":191,"color_temp_kelvin":2700,"hs_color":)"
+         R"([28.391,65.659],"rgb_color":[255,167,87],"xy_color":[0.526,0.387],)"
+         R"("friendly_name":"Kitchen main","supported_features":40},"last_changed":)"
+         R"("2025-01-04T18:02:11.143981+00:00","last_reported":"2025-01-04T18:02:11.143981)"
+         R"(+00:00","last_updated":"2025-01-04T18:02:11.143981+00:00","context":{"id":)"
+         R"("01JGTYV3","parent_id":null,"user_id":"8a1f"}}},"origin":"LOCAL","time_fired":)"
+         R"("2025-01-04T18:02:11.143981+00:00","context":{"id":"01JGTYV3","parent_id":null,)"
+         R"("user_id":"8a1f"}}})"},
+        {"sensor (temperature)",
+         R"({"id":2,"type":"event","event":{"event_type":"state_changed","data":{)"
+         R"("entity_id":"sensor.bedroom_temperature","old_state":{"entity_id":)"
+         R"("sensor.bedroom_temperature","state":"21.4","attributes":{"state_class":)"
+         R"("measurement","unit_of_measurement":"°C","device_class":"temperature",)"
+         R"("friendly_name":"Bedroom Temperature"},"last_changed":"2025-01-04T18:00:02.51+00:00",)"
+         R"("last_reported":"2025-01-04T18:00:02.51+00:00","last_updated":)"
+         R"("2025-01-04T18:00:02.51+00:00","context":{"id":"01JGTYA1","parent_id":null,)"
+         R"("user_id":null}},"new_state":{"entity_id":"sensor.bedroom_temperature","state":)"
+         R"("21.6","attributes":{"state_class":"measurement","unit_of_measurement":"°C",)"
+         R"("device_class":"temperature","friendly_name":"Bedroom Temperature"},)"
+         R"("last_changed":"2025-01-04T18:02:12.77+00:00","last_reported":)"
+         R"("2025-01-04T18:02:12.77+00:00","last_updated":"2025-01-04T18:02:12.77+00:00",)"
+         R"("context":{"id":"01JGTYV4","parent_id":null,"user_id":null}}},"origin":"LOCAL",)"
+         R"("time_fired":"2025-01-04T18:02:12.77+00:00","context":{"id":"01JGTYV4",)"
+         R"("parent_id":null,"user_id":null}}})"},
+        {"media_player (playing)",
+         R"({"id":2,"type":"event","event":{"event_type":"state_changed","data":{)"
+         R"("entity_id":"media_player.living_room","old_state":{"entity_id":)"
+         R"("media_player.living_room","state":"playing","attributes":{"volume_level":0.32,)"
+         R"("is_volume_muted":false,"media_content_id":"spotify:track:4uLU6hMC",)"
+         R"("media_content_type":"music","media_duration":212,"media_position":87,)"
+         R"("media_position_updated_at":"2025-01-04T18:02:01.1+00:00","media_title":)"
+         R"("Never Gonna Give You Up","media_artist":"Rick Astley","media_album_name":)"
+         R"("Whenever You Need Somebody","source_list":["Living Room","Kitchen","Bedroom",)"
+         R"("Office"],"shuffle":false,"repeat":"off","entity_picture":)"
+         R"("/api/media_player_proxy/media_player.living_room?token=3f1c&cache=9a8b",)"
+         R"("friendly_name":"Living Room","supported_features":2096703},"last_changed":)"
+         R"("2025-01-04T17:58:40.2+00:00","last_reported":"2025-01-04T18:02:01.1+00:00",)"
+         R"("last_updated":"2025-01-04T18:02:01.1+00:00","context":{"id":"01JGTYT0",)"
+         R"("parent_id":null,"user_id":null}},"new_state":{"entity_id":)"
+         R"("media_player.living_room","state":"playing","attributes":{"volume_level":0.35,)"
+         R"("is_volume_muted":false,"media_content_id":"spotify:track:4uLU6hMC",)"
+         R"("media_content_type":"music","media_duration":212,"media_position":98,)"
+         R"("media_position_updated_at":"2025-01-04T18:02:12.3+00:00","media_title":)"
+         R"("Never Gonna Give You Up","media_artist":"Rick Astley","media_album_name":)"
+         R"("Whenever You Need Somebody","source_list":["Living Room","Kitchen","Bedroom",)"
+         R"("Office"],"shuffle":false,"repeat":"off","entity_picture":)"
+         R"("/api/media_player_proxy/media_player.living_room?token=3f1c&cache=9a8b",)"
+         R"("friendly_name":"Living Room","supported_features":2096703},"last_changed":)"
+         R"("2025-01-04T17:58:40.2+00:00","last_reported":"2025-01-04T18:02:12.3+00:00",)"
+         R"("last_updated":"2025-01-04T18:02:12.3+00:00","context":{"id":"01JGTYV5",)"
+         R"("parent_id":null,"user_id":null}}},"origin":"LOCAL","time_fired":)"
+         R"("2025-01-04T18:02:12.3+00:00","context":{"id":"01JGTYV5","parent_id":null,)"
+         R"("user_id":null}}})"},
+    };
+
+    void* CountedMalloc(std::size_t size)
+    {
+        g_allocations++;
+        return std::malloc(size);
+    }
+
+    /** What HaWsClient did per event before: full DOM, then look up the needed fields. */
+    bool DecodeWithCjson(const std::string& frame)
+    {
+        cJSON* message = cJSON_ParseWithLength(frame.data(), frame.size());
+        if (message == nullptr)
+        {
+            return false;
+        }
+        const cJSON* event     = cJSON_GetObjectItemCaseSensitive(message, "event");
+        const cJSON* data      = cJSON_GetObjectItemCaseSensitive(event, "data");
+        const cJSON* entity_id = cJSON_GetObjectItemCaseSensitive(data, "entity_id");
+        const cJSON* new_state = cJSON_GetObjectItemCaseSensitive(data, "new_state");
+        const cJSON* state     = cJSON_GetObjectItemCaseSensitive(new_state, "state");
+        const cJSON* attrs     = cJSON_GetObjectItemCaseSensitive(new_state, "attributes");
+        const cJSON* level     = cJSON_GetObjectItemCaseSensitive(attrs, "brightness");
+        const bool   ok        = cJSON_IsString(entity_id) && cJSON_IsString(state);
+        g_sink                 = g_sink + (cJSON_IsNumber(level) ? level->valueint : 0);
+        cJSON_Delete(message);
+        return ok;
+    }
+
+    bool DecodeInPlace(const std::string& frame, HaStateChanged& event)
+    {
+        const bool ok = HaDecodeStateChanged(frame.data(), frame.size(), event)
+                        == HaFrameKind::kStateChanged;
+        g_sink = g_sink + event.brightness;
+        return ok;
+    }
+
+    template <typename Decode>
+    void Measure(const char* label, const std::string& frame, Decode decode)
+    {
+        const std::uint64_t allocations = g_allocations;
+        const auto          start       = Clock::now();
+        for (int i = 0; i < kRounds; ++i)
+        {
+            if (!decode(frame))
+            {
+                std::printf("    %-10s failed to decode\n", label);
+                return;
+            }
+        }
+        const double ns =
+            std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kRounds;
+        std::printf("    %-10s %8.0f ns/frame  %6.1f MB/s  %5.1f allocations/frame\n",
+                    label,
+                    ns,
+                    static_cast<double>(frame.size()) * 1e3 / ns,
+                    static_cast<double>(g_allocations - allocations) / kRounds);
+    }
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    void* block = CountedMalloc(size);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
+int main()
+{
+    cJSON_Hooks hooks = {CountedMalloc, std::free};
+    cJSON_InitHooks(&hooks);
+
+    HaStateChanged event;
+    std::printf("state_changed decode, %d rounds per frame\n", kRounds);
+    for (const RecordedFrame& recorded : kFrames)
+    {
+        const std::string frame = recorded.json;
+        std::printf("  %s, %zu bytes\n", recorded.name, frame.size());
+        Measure("cJSON", frame, DecodeWithCjson);
+        Measure("tokenizer", frame, [&event](const std::string& f) {
+            return DecodeInPlace(f, event);
+        });
+    }
+    return 0;
+}
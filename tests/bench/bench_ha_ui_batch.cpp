@@ -0,0 +1,213 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// UI cost of Home Assistant state bursts. A network thread pushes state_changed events through
+// HaWsStubServer + HaWsClient at a fixed rate while the main thread runs a 60 Hz frame loop.
+// "per delta" is the unbatched path: every changed entity republishes the whole state and
+// refreshes all cards under the LVGL lock. "batched" goes through HaUiBatcher: one flush per
+// frame that refreshes only the rooms that changed. Reports the LVGL lock time per frame.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/ha_ui_batcher.h"
+#include "integration/ha_ws_client.h"
+#include "integration/ha_ws_stub_server.h"
+
+namespace
+{
+
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::HaUiBatcher;
+    using custom::integration::HaWsClient;
+    using custom::integration::HaWsStubServer;
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr const char*               kToken   = "bench-token";
+    constexpr int                       kRooms   = 12;
+    constexpr std::chrono::milliseconds kFrame   = std::chrono::milliseconds(16);
+    constexpr std::chrono::milliseconds kRunTime = std::chrono::milliseconds(1000);
+
+    volatile std::size_t g_sink = 0U;
+
+    std::vector<HaRoomLayout> BenchLayout()
+    {
+        std::vector<HaRoomLayout> layout;
+        for (int r = 0; r < kRooms; ++r)
+        {
+            const std::string id = "room" + std::to_string(r);
+            HaRoomLayout      room;
+            room.room_id            = id;
+            room.name               = id;
+            room.entities           = {"light." + id, "switch." + id + "_fan"};
+            room.temperature_entity = "sensor." + id + "_temperature";
+            layout.push_back(room);
+        }
+        return layout;
+    }
+
+    // Stand-in for ui_room_card_set_state(): format the labels a card shows
+    void UpdateCard(const room_t& room)
+    {
+        char text[32];
+        for (std::size_t e = 0; e < room.entity_count; ++e)
+        {
+            g_sink = g_sink
+                     + static_cast<std::size_t>(std::snprintf(
+                         text, sizeof(text), "%s %d", room.entities[e]->on ? "On" : "Off",
+                         static_cast<int>(room.entities[e]->value)));
+        }
+        g_sink = g_sink
+                 + static_cast<std::size_t>(std::snprintf(
+                     text, sizeof(text), "%d C %u%%", room.temp_c, room.humidity));
+    }
+
+    struct Result
+    {
+        std::uint32_t deltas        = 0U;
+        std::uint64_t cards         = 0U;
+        int           frames        = 0;
+        double        lock_us_total = 0.0;
+        double        lock_us_max   = 0.0;  // worst single frame
+    };
+
+    /**
+     * Scenes switch several rooms at once: every millisecond the producer changes
+     * @p rate / 1000 entities spread over the rooms, then lets the client read them.
+     */
+    Result Run(int rate, bool batched)
+    {
+        HaEntityStore  store(BenchLayout());
+        HaWsStubServer server(kToken);
+        HaWsClient     client(server, store, kToken);
+        std::mutex     lvgl_lock;
+
+        std::atomic<bool>   flush_requested{false};
+        std::atomic<double> frame_lock_us{0.0};  // lock time charged to the current frame
+        std::uint64_t       cards = 0U;
+        HaUiBatcher         batcher(
+            store,
+            [&flush_requested]() { flush_requested.store(true); },
+            [&cards](const room_t& room) {
+                UpdateCard(room);
+                cards++;
+            });
+
+        const auto publish_all = [&]() {
+            std::lock_guard<std::mutex> lock(lvgl_lock);
+            const auto                  start = Clock::now();
+            const rooms_state_t*        state = store.Publish();
+            for (std::size_t r = 0; r < state->room_count; ++r)
+            {
+                UpdateCard(state->rooms[r]);
+                cards++;
+            }
+            const double us =
+                std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            frame_lock_us.store(frame_lock_us.load() + us);
+        };
+        client.SetChangeCallback([&]() {
+            if (batched)
+            {
+                batcher.MarkChanged();
+            }
+            else
+            {
+                publish_all();
+            }
+        });
+
+        server.Attach(&client);
+        for (int r = 0; r < kRooms; ++r)
+        {
+            const std::string id = "room" + std::to_string(r);
+            server.SetState("light." + id, "off", 0);
+            server.SetState("switch." + id + "_fan", "off");
+            server.SetState("sensor." + id + "_temperature", "21");
+        }
+        server.Connect();
+        while (server.Pump() > 0U)
+        {
+        }
+
+        std::atomic<bool> done{false};
+        Result            result;
+        std::thread       producer([&]() {
+            const int  per_ms = std::max(1, rate / 1000);
+            const auto end    = Clock::now() + kRunTime;
+            int        n      = 0;
+            while (Clock::now() < end)
+            {
+                for (int i = 0; i < per_ms; ++i, ++n)
+                {
+                    const std::string id = "room" + std::to_string(n % kRooms);
+                    server.SetState("light." + id, "on", n % 255);
+                }
+                while (server.Pump() > 0U)
+                {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            result.deltas = client.GetStats().deltas_applied;
+            done.store(true);
+        });
+
+        auto next_frame = Clock::now() + kFrame;
+        while (!done.load() || flush_requested.load())
+        {
+            std::this_thread::sleep_until(next_frame);
+            next_frame += kFrame;
+            if (flush_requested.exchange(false))
+            {
+                std::lock_guard<std::mutex> lock(lvgl_lock);
+                const auto                  start = Clock::now();
+                batcher.Flush();
+                frame_lock_us.store(
+                    frame_lock_us.load()
+                    + std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+            const double us      = frame_lock_us.exchange(0.0);
+            result.lock_us_total += us;
+            result.lock_us_max    = std::max(result.lock_us_max, us);
+            result.frames++;
+        }
+        producer.join();
+        result.cards = cards;
+        return result;
+    }
+
+}  // namespace
+
+int main()
+{
+    std::printf("%d rooms, %d ms frames, %lld ms per run; LVGL lock time per frame\n",
+                kRooms,
+                static_cast<int>(kFrame.count()),
+                static_cast<long long>(kRunTime.count()));
+    for (int rate : {1000, 5000, 20000})
+    {
+        for (bool batched : {false, true})
+        {
+            const Result r = Run(rate, batched);
+            std::printf("  %5d/s %-9s  %6u deltas  %7llu cards  avg %8.1f us  max %8.1f us\n",
+                        rate,
+                        batched ? "batched" : "per delta",
+                        r.deltas,
+                        static_cast<unsigned long long>(r.cards),
+                        r.lock_us_total / std::max(1, r.frames),
+                        r.lock_us_max);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,953 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// Album art decode: time and peak heap to bring a cover down to the media page's 240x240 card.
+// Synthesises photo-like covers (gradients, soft shapes and grain) at the sizes music
+// services hand out, encodes them as baseline JPEG (optimised Huffman tables, IJG quality 85)
+// and as PNG (fixed-Huffman deflate), then decodes each through DecodeImageScaled(). Peak
+// heap counts every operator new made during one decode, output image included.
+//
+//   bench_image_decode                       built-in covers
+//   bench_image_decode cover.jpg art.png     also these files
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "platform/image/image_decoder.h"
+
+namespace
+{
+
+    using custom::platform::ImageDecodeInfo;
+    using custom::platform::ImageDecodeResult;
+    using custom::platform::ImageFormat;
+    using custom::platform::ImageScaleOptions;
+    using custom::platform::ScaledImage;
+    using Clock  = std::chrono::steady_clock;
+    using Buffer = std::vector<std::uint8_t>;
+
+    constexpr std::uint32_t kCardSide = 240U;
+    constexpr int           kRepeats  = 5;
+
+    std::size_t g_live_bytes = 0U;
+    std::size_t g_peak_bytes = 0U;
+
+    // ---- Photo-like test content ----
+
+    Buffer MakeCover(std::uint32_t width, std::uint32_t height, bool alpha)
+    {
+        const std::uint32_t channels = alpha ? 4U : 3U;
+        Buffer              pixels(static_cast<std::size_t>(width) * height * channels);
+        std::uint32_t       seed = 0x2545F491U;
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            for (std::uint32_t x = 0; x < width; ++x)
+            {
+                const double u = static_cast<double>(x) / width;
+                const double v = static_cast<double>(y) / height;
+                // Sky-to-ground gradient, a soft sun and a darker band, plus film grain
+                const double du  = u - 0.7;
+                const double dv  = v - 0.3;
+                const double sun = std::exp(-(du * du + dv * dv) * 40.0);
+                double       r   = 40.0 + 170.0 * v;
+                double       g   = 70.0 + 90.0 * u;
+                double       b   = 200.0 - 150.0 * v;
+                r += 200.0 * sun;
+                g += 160.0 * sun;
+                b += 60.0 * sun;
+                if (std::fabs(v - 0.75 - 0.05 * std::sin(u * 12.0)) < 0.06)
+                {
+                    r *= 0.4;
+                    g *= 0.5;
+                    b *= 0.6;
+                }
+                seed = seed * 1664525U + 1013904223U;
+                const double grain = static_cast<double>((seed >> 24) & 0x0FU) - 7.5;
+
+                const std::size_t i = (static_cast<std::size_t>(y) * width + x) * channels;
+                pixels[i]           = static_cast<std::uint8_t>(std::clamp(r + grain, 0.0, 255.0));
+                pixels[i + 1]       = static_cast<std::uint8_t>(std::clamp(g + grain, 0.0, 255.0));
+                pixels[i + 2]       = static_cast<std::uint8_t>(std::clamp(b + grain, 0.0, 255.0));
+                if (alpha)
+                {
+                    // Rounded-corner cut-out, as some services serve logos
+                    const double cu = std::max(std::fabs(u - 0.5) - 0.4, 0.0);
+                    const double cv = std::max(std::fabs(v - 0.5) - 0.4, 0.0);
+                    pixels[i + 3]   = cu * cu + cv * cv < 0.01 ? 255U : 0U;
+                }
+            }
+        }
+        return pixels;
+    }
+
+    // ---- Baseline JPEG encoder ----
+
+    constexpr std::uint8_t kZigzag[64] = {
+        0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,  12, 19, 26, 33, 40, 48,
+        41, 34, 27, 20, 13, 6,  7,  14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23,
+        30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    };
+
+    // ITU-T T.81 Annex K, natural order
+    constexpr std::uint8_t kLumaQuant[64] = {
+        16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+        14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+        18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+        49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99,
+    };
+
+    constexpr std::uint8_t kChromaQuant[64] = {
+        17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    };
+
+    using Block = std::array<std::int16_t, 64>;  // quantised, zigzag order
+
+    struct HuffmanCode
+    {
+        std::uint8_t  bits[17]    = {};  // codes of each length, 1..16
+        std::uint8_t  values[256] = {};
+        std::uint16_t code[256]   = {};
+        std::uint8_t  length[256] = {};
+        int           value_count = 0;
+    };
+
+    /** Optimal code lengths limited to 16 bits, as libjpeg's jpeg_gen_optimal_table(). */
+    HuffmanCode BuildHuffman(const std::vector<long>& counts)
+    {
+        long freq[257];
+        int  size[257] = {};
+        int  others[257];
+        for (int i = 0; i < 256; ++i)
+        {
+            freq[i]   = counts[i];
+            others[i] = -1;
+        }
+        freq[256]   = 1;  // reserves the all-ones code
+        others[256] = -1;
+
+        for (;;)
+        {
+            int c1 = -1;
+            int c2 = -1;
+            for (int i = 0; i <= 256; ++i)
+            {
+                if (freq[i] != 0 && (c1 < 0 || freq[i] <= freq[c1]))
+                {
+                    c1 = i;
+                }
+            }
+            for (int i = 0; i <= 256; ++i)
+            {
+                if (freq[i] != 0 && i != c1 && (c2 < 0 || freq[i] <= freq[c2]))
+                {
+                    c2 = i;
+                }
+            }
+            if (c2 < 0)
+            {
+                break;
+            }
+            freq[c1] += freq[c2];
+            freq[c2] = 0;
+            for (++size[c1]; others[c1] >= 0; ++size[c1])
+            {
+                c1 = others[c1];
+            }
+            others[c1] = c2;
+            for (++size[c2]; others[c2] >= 0; ++size[c2])
+            {
+                c2 = others[c2];
+            }
+        }
+
+        int per_length[33] = {};
+        for (int i = 0; i <= 256; ++i)
+        {
+            if (size[i] != 0)
+            {
+                per_length[std::min(size[i], 32)]++;
+            }
+        }
+        for (int i = 32; i > 16; --i)
+        {
+            while (per_length[i] > 0)
+            {
+                int j = i - 2;
+                while (per_length[j] == 0)
+                {
+                    --j;
+                }
+                per_length[i] -= 2;
+                per_length[i - 1]++;
+                per_length[j + 1] += 2;
+                per_length[j]--;
+            }
+        }
+        int longest = 16;
+        while (per_length[longest] == 0)
+        {
+            --longest;
+        }
+        per_length[longest]--;  // drop the reserved code
+
+        HuffmanCode table;
+        for (int len = 1; len <= 16; ++len)
+        {
+            table.bits[len] = static_cast<std::uint8_t>(per_length[len]);
+        }
+        for (int len = 1; len <= 32; ++len)
+        {
+            for (int symbol = 0; symbol < 256; ++symbol)
+            {
+                if (size[symbol] == len)
+                {
+                    table.values[table.value_count++] = static_cast<std::uint8_t>(symbol);
+                }
+            }
+        }
+        std::uint16_t code = 0U;
+        int           k    = 0;
+        for (int len = 1; len <= 16; ++len)
+        {
+            for (int n = 0; n < table.bits[len]; ++n, ++k)
+            {
+                table.code[table.values[k]]   = code++;
+                table.length[table.values[k]] = static_cast<std::uint8_t>(len);
+            }
+            code = static_cast<std::uint16_t>(code << 1);
+        }
+        return table;
+    }
+
+    class JpegBitWriter
+    {
+    public:
+        explicit JpegBitWriter(Buffer& out) : out_(out) {}
+
+        void Put(std::uint32_t value, int count)
+        {
+            for (int i = count - 1; i >= 0; --i)
+            {
+                acc_ = static_cast<std::uint8_t>((acc_ << 1) | ((value >> i) & 1U));
+                if (++used_ == 8)
+                {
+                    Emit();
+                }
+            }
+        }
+
+        void Flush()
+        {
+            while (used_ != 0)
+            {
+                Put(1U, 1);
+            }
+        }
+
+    private:
+        void Emit()
+        {
+            out_.push_back(acc_);
+            if (acc_ == 0xFFU)
+            {
+                out_.push_back(0x00U);
+            }
+            acc_  = 0U;
+            used_ = 0;
+        }
+
+        Buffer&      out_;
+        std::uint8_t acc_  = 0U;
+        int          used_ = 0;
+    };
+
+    int Category(int value)
+    {
+        int magnitude = value < 0 ? -value : value;
+        int bits      = 0;
+        for (; magnitude != 0; magnitude >>= 1)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /** Calls @p emit(table, symbol, extra, extra_bits) for each coded symbol of @p block. */
+    template <typename Emit>
+    void ScanBlock(const Block& block, int& dc_pred, int dc_table, int ac_table, Emit&& emit)
+    {
+        const int diff = block[0] - dc_pred;
+        dc_pred        = block[0];
+        const int cat  = Category(diff);
+        emit(dc_table, cat, diff < 0 ? diff - 1 : diff, cat);
+
+        int run = 0;
+        for (int k = 1; k < 64; ++k)
+        {
+            if (block[k] == 0)
+            {
+                ++run;
+                continue;
+            }
+            for (; run >= 16; run -= 16)
+            {
+                emit(ac_table, 0xF0, 0, 0);
+            }
+            const int size = Category(block[k]);
+            emit(ac_table, (run << 4) | size, block[k] < 0 ? block[k] - 1 : block[k], size);
+            run = 0;
+        }
+        if (run > 0)
+        {
+            emit(ac_table, 0x00, 0, 0);
+        }
+    }
+
+    void ForwardDct(const float* in, const std::uint8_t* quant, Block& out)
+    {
+        static float cosines[8][8];
+        static bool  ready = false;
+        if (!ready)
+        {
+            for (int k = 0; k < 8; ++k)
+            {
+                const float scale = k == 0 ? std::sqrt(0.125F) : 0.5F;
+                for (int n = 0; n < 8; ++n)
+                {
+                    cosines[k][n] = scale * std::cos((2.0F * n + 1.0F) * k * 3.14159265F / 16.0F);
+                }
+            }
+            ready = true;
+        }
+        float rows[64];
+        for (int y = 0; y < 8; ++y)
+        {
+            for (int k = 0; k < 8; ++k)
+            {
+                float sum = 0.0F;
+                for (int x = 0; x < 8; ++x)
+                {
+                    sum += cosines[k][x] * in[y * 8 + x];
+                }
+                rows[y * 8 + k] = sum;
+            }
+        }
+        float coefficients[64];
+        for (int k = 0; k < 8; ++k)
+        {
+            for (int u = 0; u < 8; ++u)
+            {
+                float sum = 0.0F;
+                for (int y = 0; y < 8; ++y)
+                {
+                    sum += cosines[k][y] * rows[y * 8 + u];
+                }
+                coefficients[k * 8 + u] = sum;
+            }
+        }
+        for (int z = 0; z < 64; ++z)
+        {
+            const int natural = kZigzag[z];
+            out[z] = static_cast<std::int16_t>(std::lround(coefficients[natural] / quant[natural]));
+        }
+    }
+
+    /** Baseline JPEG, 4:2:0 when @p subsample, else 4:4:4. */
+    Buffer EncodeJpeg(const Buffer& rgb, std::uint32_t width, std::uint32_t height, bool subsample)
+    {
+        constexpr int kQuality = 85;
+        std::uint8_t  quant[2][64];
+        const int     scale = kQuality < 50 ? 5000 / kQuality : 200 - 2 * kQuality;
+        for (int i = 0; i < 64; ++i)
+        {
+            const int luma   = (kLumaQuant[i] * scale + 50) / 100;
+            const int chroma = (kChromaQuant[i] * scale + 50) / 100;
+            quant[0][i]      = static_cast<std::uint8_t>(std::clamp(luma, 1, 255));
+            quant[1][i]      = static_cast<std::uint8_t>(std::clamp(chroma, 1, 255));
+        }
+
+        // Level-shifted YCbCr, edges replicated out to whole MCUs
+        const std::uint32_t step    = subsample ? 2U : 1U;  // chroma pixels per sample
+        const std::uint32_t mcu     = 8U * step;
+        const std::uint32_t mcus_x  = (width + mcu - 1U) / mcu;
+        const std::uint32_t mcus_y  = (height + mcu - 1U) / mcu;
+        const std::uint32_t plane_w = mcus_x * mcu;
+        const std::uint32_t plane_h = mcus_y * mcu;
+        std::vector<float>  planes[3];
+        for (auto& plane : planes)
+        {
+            plane.resize(static_cast<std::size_t>(plane_w) * plane_h);
+        }
+        for (std::uint32_t y = 0; y < plane_h; ++y)
+        {
+            for (std::uint32_t x = 0; x < plane_w; ++x)
+            {
+                const std::size_t row = std::min(y, height - 1U);
+                const std::size_t src = (row * width + std::min(x, width - 1U)) * 3U;
+                const float       r   = rgb[src];
+                const float       g   = rgb[src + 1];
+                const float       b   = rgb[src + 2];
+                const std::size_t dst = static_cast<std::size_t>(y) * plane_w + x;
+                planes[0][dst]        = 0.299F * r + 0.587F * g + 0.114F * b - 128.0F;
+                planes[1][dst]        = -0.168736F * r - 0.331264F * g + 0.5F * b;
+                planes[2][dst]        = 0.5F * r - 0.418688F * g - 0.081312F * b;
+            }
+        }
+
+        // Quantised blocks in scan order
+        std::vector<Block> blocks;
+        std::vector<int>   block_plane;
+        float              samples[64];
+        for (std::uint32_t my = 0; my < mcus_y; ++my)
+        {
+            for (std::uint32_t mx = 0; mx < mcus_x; ++mx)
+            {
+                for (std::uint32_t by = 0; by < step; ++by)
+                {
+                    for (std::uint32_t bx = 0; bx < step; ++bx)
+                    {
+                        for (int i = 0; i < 64; ++i)
+                        {
+                            const std::uint32_t x = mx * mcu + bx * 8U + (i & 7);
+                            const std::uint32_t y = my * mcu + by * 8U + (i >> 3);
+                            samples[i] = planes[0][static_cast<std::size_t>(y) * plane_w + x];
+                        }
+                        blocks.emplace_back();
+                        ForwardDct(samples, quant[0], blocks.back());
+                        block_plane.push_back(0);
+                    }
+                }
+                for (int c = 1; c < 3; ++c)
+                {
+                    for (int i = 0; i < 64; ++i)
+                    {
+                        const std::uint32_t x   = mx * mcu + (i & 7) * step;
+                        const std::uint32_t y   = my * mcu + (i >> 3) * step;
+                        float               sum = 0.0F;
+                        for (std::uint32_t dy = 0; dy < step; ++dy)
+                        {
+                            const std::size_t row = static_cast<std::size_t>(y + dy) * plane_w;
+                            for (std::uint32_t dx = 0; dx < step; ++dx)
+                            {
+                                sum += planes[c][row + x + dx];
+                            }
+                        }
+                        samples[i] = sum / static_cast<float>(step * step);
+                    }
+                    blocks.emplace_back();
+                    ForwardDct(samples, quant[1], blocks.back());
+                    block_plane.push_back(c);
+                }
+            }
+        }
+
+        // Pass one counts symbols for the tables (0: DC luma, 1: AC luma, 2: DC chroma,
+        // 3: AC chroma), pass two writes them
+        std::vector<long> counts[4];
+        for (auto& count : counts)
+        {
+            count.assign(256U, 0L);
+        }
+        auto count = [&counts](int table, int symbol, int, int) { counts[table][symbol]++; };
+        int  pred[3] = {};
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            const int dc = block_plane[i] != 0 ? 2 : 0;
+            ScanBlock(blocks[i], pred[block_plane[i]], dc, dc + 1, count);
+        }
+        HuffmanCode tables[4];
+        for (int t = 0; t < 4; ++t)
+        {
+            tables[t] = BuildHuffman(counts[t]);
+        }
+
+        Buffer out = {0xFF, 0xD8};
+        auto   put16 = [&out](std::uint32_t v) {
+            out.push_back(static_cast<std::uint8_t>(v >> 8));
+            out.push_back(static_cast<std::uint8_t>(v & 0xFFU));
+        };
+        for (int q = 0; q < 2; ++q)
+        {
+            put16(0xFFDBU);
+            put16(67U);
+            out.push_back(static_cast<std::uint8_t>(q));
+            for (int z = 0; z < 64; ++z)
+            {
+                out.push_back(quant[q][kZigzag[z]]);
+            }
+        }
+        put16(0xFFC0U);
+        put16(17U);
+        out.push_back(8U);
+        put16(height);
+        put16(width);
+        out.push_back(3U);
+        for (int c = 0; c < 3; ++c)
+        {
+            out.push_back(static_cast<std::uint8_t>(c + 1));
+            out.push_back(c == 0 && subsample ? 0x22U : 0x11U);
+            out.push_back(c == 0 ? 0U : 1U);
+        }
+        for (int t = 0; t < 4; ++t)
+        {
+            put16(0xFFC4U);
+            put16(static_cast<std::uint32_t>(19 + tables[t].value_count));
+            out.push_back(static_cast<std::uint8_t>(((t & 1) << 4) | (t >> 1)));
+            out.insert(out.end(), tables[t].bits + 1, tables[t].bits + 17);
+            out.insert(out.end(), tables[t].values, tables[t].values + tables[t].value_count);
+        }
+        put16(0xFFDAU);
+        put16(12U);
+        out.push_back(3U);
+        for (int c = 0; c < 3; ++c)
+        {
+            out.push_back(static_cast<std::uint8_t>(c + 1));
+            out.push_back(c == 0 ? 0x00U : 0x11U);
+        }
+        out.push_back(0U);
+        out.push_back(63U);
+        out.push_back(0U);
+
+        JpegBitWriter bits(out);
+        auto          write = [&bits, &tables](int table, int symbol, int extra, int extra_bits) {
+            bits.Put(tables[table].code[symbol], tables[table].length[symbol]);
+            if (extra_bits > 0)
+            {
+                bits.Put(static_cast<std::uint32_t>(extra) & ((1U << extra_bits) - 1U), extra_bits);
+            }
+        };
+        pred[0] = pred[1] = pred[2] = 0;
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            const int dc = block_plane[i] != 0 ? 2 : 0;
+            ScanBlock(blocks[i], pred[block_plane[i]], dc, dc + 1, write);
+        }
+        bits.Flush();
+        put16(0xFFD9U);
+        return out;
+    }
+
+    // ---- PNG encoder ----
+
+    std::uint32_t Crc32(const std::uint8_t* data, std::size_t len, std::uint32_t crc = 0U)
+    {
+        crc = ~crc;
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            crc ^= data[i];
+            for (int k = 0; k < 8; ++k)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+        }
+        return ~crc;
+    }
+
+    class DeflateBitWriter
+    {
+    public:
+        explicit DeflateBitWriter(Buffer& out) : out_(out) {}
+
+        /** Extra bits and block headers: least significant bit first. */
+        void Put(std::uint32_t value, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                acc_ |= ((value >> i) & 1U) << used_;
+                if (++used_ == 8)
+                {
+                    out_.push_back(static_cast<std::uint8_t>(acc_));
+                    acc_  = 0U;
+                    used_ = 0;
+                }
+            }
+        }
+
+        /** Huffman codes: most significant bit first. */
+        void PutCode(std::uint32_t code, int count)
+        {
+            for (int i = count - 1; i >= 0; --i)
+            {
+                Put((code >> i) & 1U, 1);
+            }
+        }
+
+        void Flush()
+        {
+            if (used_ != 0)
+            {
+                out_.push_back(static_cast<std::uint8_t>(acc_));
+                acc_  = 0U;
+                used_ = 0;
+            }
+        }
+
+    private:
+        Buffer&       out_;
+        std::uint32_t acc_  = 0U;
+        int           used_ = 0;
+    };
+
+    void PutFixedLiteral(DeflateBitWriter& bits, int symbol)
+    {
+        if (symbol < 144)
+        {
+            bits.PutCode(0x30U + symbol, 8);
+        }
+        else if (symbol < 256)
+        {
+            bits.PutCode(0x190U + (symbol - 144), 9);
+        }
+        else if (symbol < 280)
+        {
+            bits.PutCode(symbol - 256, 7);
+        }
+        else
+        {
+            bits.PutCode(0xC0U + (symbol - 280), 8);
+        }
+    }
+
+    void PutMatch(DeflateBitWriter& bits, std::uint32_t length, std::uint32_t distance)
+    {
+        static const std::uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,
+                                                      15, 17, 19, 23, 27, 31, 35, 43, 51,  59,
+                                                      67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const std::uint8_t  kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                       2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const std::uint16_t kDistBase[30]    = {
+            1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+            193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        int l = 28;
+        while (kLengthBase[l] > length)
+        {
+            --l;
+        }
+        PutFixedLiteral(bits, 257 + l);
+        bits.Put(length - kLengthBase[l], kLengthExtra[l]);
+        int d = 29;
+        while (kDistBase[d] > distance)
+        {
+            --d;
+        }
+        bits.PutCode(static_cast<std::uint32_t>(d), 5);
+        bits.Put(distance - kDistBase[d], d < 4 ? 0 : d / 2 - 1);
+    }
+
+    /** zlib stream of one fixed-Huffman block, greedy matches through a one-entry hash. */
+    Buffer Deflate(const Buffer& data)
+    {
+        Buffer           out = {0x78, 0x01};
+        DeflateBitWriter bits(out);
+        bits.Put(1U, 1);  // final block
+        bits.Put(1U, 2);  // fixed Huffman
+        std::vector<std::int64_t> head(1U << 15, -1);
+        std::size_t               i = 0U;
+        while (i < data.size())
+        {
+            if (i + 3U <= data.size())
+            {
+                const std::uint32_t hash =
+                    ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & 0x7FFFU;
+                const std::int64_t candidate = head[hash];
+                head[hash]                   = static_cast<std::int64_t>(i);
+                const std::size_t distance   = i - static_cast<std::size_t>(candidate);
+                if (candidate >= 0 && distance <= 32768U)
+                {
+                    std::size_t length = 0U;
+                    while (length < 258U && i + length < data.size()
+                           && data[i - distance + length] == data[i + length])
+                    {
+                        ++length;
+                    }
+                    if (length >= 3U)
+                    {
+                        PutMatch(bits,
+                                 static_cast<std::uint32_t>(length),
+                                 static_cast<std::uint32_t>(distance));
+                        i += length;
+                        continue;
+                    }
+                }
+            }
+            PutFixedLiteral(bits, data[i]);
+            ++i;
+        }
+        PutFixedLiteral(bits, 256);
+        bits.Flush();
+
+        std::uint32_t a = 1U;
+        std::uint32_t b = 0U;
+        for (const std::uint8_t byte : data)
+        {
+            a = (a + byte) % 65521U;
+            b = (b + a) % 65521U;
+        }
+        const std::uint32_t adler = (b << 16) | a;
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<std::uint8_t>(adler >> shift));
+        }
+        return out;
+    }
+
+    int Paeth(int a, int b, int c)
+    {
+        const int p  = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        return pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+    }
+
+    /** 8-bit RGB or RGBA, each row filtered with whichever of the five filters sums smallest. */
+    Buffer EncodePng(const Buffer& pixels, std::uint32_t width, std::uint32_t height, bool alpha)
+    {
+        const std::size_t bpp    = alpha ? 4U : 3U;
+        const std::size_t stride = width * bpp;
+        Buffer            filtered;
+        filtered.reserve((stride + 1U) * height);
+        Buffer candidate(stride);
+        Buffer best(stride);
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            const std::uint8_t* row       = pixels.data() + y * stride;
+            const std::uint8_t* up        = y > 0U ? row - stride : nullptr;
+            long                best_cost = -1;
+            int                 best_type = 0;
+            for (int type = 0; type < 5; ++type)
+            {
+                long cost = 0;
+                for (std::size_t x = 0; x < stride; ++x)
+                {
+                    const int a         = x >= bpp ? row[x - bpp] : 0;
+                    const int b         = up != nullptr ? up[x] : 0;
+                    const int c         = x >= bpp && up != nullptr ? up[x - bpp] : 0;
+                    const int predicted = type == 1 ? a
+                                          : type == 2 ? b
+                                          : type == 3 ? (a + b) / 2
+                                          : type == 4 ? Paeth(a, b, c)
+                                                      : 0;
+                    candidate[x] = static_cast<std::uint8_t>(row[x] - predicted);
+                    cost += std::abs(static_cast<std::int8_t>(candidate[x]));
+                }
+                if (best_cost < 0 || cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_type = type;
+                    best.swap(candidate);
+                }
+            }
+            filtered.push_back(static_cast<std::uint8_t>(best_type));
+            filtered.insert(filtered.end(), best.begin(), best.end());
+        }
+
+        Buffer out   = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+        auto   chunk = [&out](const char* type, const std::uint8_t* data, std::size_t len) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                out.push_back(static_cast<std::uint8_t>(len >> shift));
+            }
+            const std::size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data, data + len);
+            const std::uint32_t crc = Crc32(out.data() + start, len + 4U);
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                out.push_back(static_cast<std::uint8_t>(crc >> shift));
+            }
+        };
+        const std::uint8_t header[13] = {
+            static_cast<std::uint8_t>(width >> 24),  static_cast<std::uint8_t>(width >> 16),
+            static_cast<std::uint8_t>(width >> 8),   static_cast<std::uint8_t>(width),
+            static_cast<std::uint8_t>(height >> 24), static_cast<std::uint8_t>(height >> 16),
+            static_cast<std::uint8_t>(height >> 8),  static_cast<std::uint8_t>(height),
+            8U, static_cast<std::uint8_t>(alpha ? 6U : 2U), 0U, 0U, 0U,
+        };
+        chunk("IHDR", header, sizeof(header));
+        const Buffer zlib = Deflate(filtered);
+        for (std::size_t pos = 0U; pos < zlib.size(); pos += 65536U)
+        {
+            chunk("IDAT", zlib.data() + pos, std::min<std::size_t>(65536U, zlib.size() - pos));
+        }
+        chunk("IEND", nullptr, 0U);
+        return out;
+    }
+
+    // ---- Decode ----
+
+    void RunImage(const std::string& name, const Buffer& file)
+    {
+        ImageScaleOptions options;
+        options.width  = kCardSide;
+        options.height = kCardSide;
+
+        ImageDecodeInfo   info;
+        ImageDecodeResult result  = ImageDecodeResult::kOk;
+        ScaledImage       image;
+        double            best_ms = 1e9;
+        std::size_t       peak    = 0U;
+        for (int i = 0; i < kRepeats; ++i)
+        {
+            std::size_t pos  = 0U;
+            auto        read = [&file, &pos](std::uint8_t* dst, std::size_t len) {
+                const std::size_t n = std::min(len, file.size() - pos);
+                std::memcpy(dst, file.data() + pos, n);
+                pos += n;
+                return n;
+            };
+            image                  = ScaledImage();
+            const std::size_t base = g_live_bytes;
+            g_peak_bytes           = base;
+            const auto start       = Clock::now();
+            result                 = DecodeImageScaled(read, options, image, &info);
+            const double ms =
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            best_ms = ms < best_ms ? ms : best_ms;
+            peak    = g_peak_bytes - base;
+        }
+        if (result != ImageDecodeResult::kOk)
+        {
+            std::printf("%-22s %s\n", name.c_str(), ImageDecodeResultName(result));
+            return;
+        }
+
+        char reduction[16] = "-";
+        if (info.format == ImageFormat::kJpeg)
+        {
+            std::snprintf(reduction, sizeof(reduction), "1/%u", info.block_scale);
+        }
+        const double full_kb = 2.0 * info.source_width * info.source_height / 1024.0;
+        std::printf("%-22s %5ux%-5u %7.1f KB  DCT %-3s  %7.2f ms  peak %6.1f KB  "
+                    "(full-size RGB565 %6.0f KB)\n",
+                    name.c_str(),
+                    info.source_width,
+                    info.source_height,
+                    file.size() / 1024.0,
+                    reduction,
+                    best_ms,
+                    peak / 1024.0,
+                    full_kb);
+    }
+
+    bool ReadFile(const char* path, Buffer& out)
+    {
+        FILE* file = std::fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        std::uint8_t chunk[4096];
+        std::size_t  n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0U)
+        {
+            out.insert(out.end(), chunk, chunk + n);
+        }
+        std::fclose(file);
+        return true;
+    }
+
+}  // namespace
+
+// Counts live and peak heap; the size sits in front of each block
+void* operator new(std::size_t size)
+{
+    auto* block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *block = size;
+    g_live_bytes += size;
+    g_peak_bytes = std::max(g_peak_bytes, g_live_bytes);
+    return reinterpret_cast<std::uint8_t*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        auto* block = reinterpret_cast<std::size_t*>(static_cast<std::uint8_t*>(ptr)
+                                                     - sizeof(std::max_align_t));
+        g_live_bytes -= *block;
+        std::free(block);
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    ::operator delete(ptr);
+}
+
+int main(int argc, char** argv)
+{
+    struct Cover
+    {
+        const char*   name;
+        std::uint32_t width;
+        std::uint32_t height;
+        bool          png;
+        bool          subsample;  // JPEG 4:2:0
+        bool          alpha;      // PNG RGBA
+    };
+    const Cover covers[] = {
+        {"jpeg 4:2:0 3000x3000", 3000U, 3000U, false, true, false},
+        {"jpeg 4:2:0 1400x1400", 1400U, 1400U, false, true, false},
+        {"jpeg 4:2:0 1000x800", 1000U, 800U, false, true, false},
+        {"jpeg 4:4:4 640x640", 640U, 640U, false, false, false},
+        {"png rgb 1000x1000", 1000U, 1000U, true, false, false},
+        {"png rgba 640x640", 640U, 640U, true, false, true},
+    };
+
+    std::printf("best of %d decodes to a %ux%u card; peak heap includes the output\n",
+                kRepeats,
+                kCardSide,
+                kCardSide);
+    for (const Cover& cover : covers)
+    {
+        const Buffer pixels = MakeCover(cover.width, cover.height, cover.alpha);
+        RunImage(cover.name,
+                 cover.png ? EncodePng(pixels, cover.width, cover.height, cover.alpha)
+                           : EncodeJpeg(pixels, cover.width, cover.height, cover.subsample));
+    }
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        Buffer file;
+        if (!ReadFile(argv[arg], file))
+        {
+            std::fprintf(stderr, "cannot open %s\n", argv[arg]);
+            return 1;
+        }
+        const char* slash = std::strrchr(argv[arg], '/');
+        RunImage(slash != nullptr ? slash + 1 : argv[arg], file);
+    }
+    return 0;
+}
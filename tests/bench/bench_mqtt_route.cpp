@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// MQTT routing cost against the number of subscriptions. A home with Zigbee2MQTT, ESPHome and
+// Tasmota devices: one state topic per entity plus a few wildcard filters (discovery, bridge
+// and availability). Each message is routed either by scanning every filter with
+// MqttTopicMatches(), as a naive subscription list would, or by one MqttTopicTrie walk.
+// Traffic mixes tracked state topics with the unrelated chatter a shared broker carries.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "integration/mqtt_topic_trie.h"
+
+namespace
+{
+
+    using custom::integration::MqttTopicMatches;
+    using custom::integration::MqttTopicTrie;
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kMessages = 200000;
+
+    volatile std::uint32_t g_sink = 0U;
+
+    const char* const kWildcards[] = {
+        "homeassistant/+/+/config",
+        "homeassistant/+/+/+/config",
+        "zigbee2mqtt/bridge/#",
+        "+/availability",
+        "tasmota/discovery/#",
+    };
+
+    std::string StateTopic(std::size_t i)
+    {
+        // Spread over the three firmware families' topic layouts
+        switch (i % 3U)
+        {
+            case 0U:
+                return "zigbee2mqtt/device_" + std::to_string(i);
+            case 1U:
+                return "esphome/node_" + std::to_string(i / 8U) + "/sensor/value_"
+                       + std::to_string(i) + "/state";
+            default:
+                return "stat/tasmota_" + std::to_string(i) + "/POWER";
+        }
+    }
+
+    std::vector<std::string> Traffic(std::size_t subscriptions)
+    {
+        std::mt19937                               rng(42U);
+        std::uniform_int_distribution<std::size_t> pick(0U, subscriptions - 1U);
+        std::vector<std::string>                   topics;
+        for (int i = 0; i < 1024; ++i)
+        {
+            switch (i % 4)
+            {
+                case 0:
+                case 1:
+                    topics.push_back(StateTopic(pick(rng)));
+                    break;
+                case 2:
+                    topics.push_back("zigbee2mqtt/device_" + std::to_string(pick(rng))
+                                     + "/availability");
+                    break;
+                default:
+                    topics.push_back("tele/tasmota_" + std::to_string(pick(rng)) + "/SENSOR");
+                    break;
+            }
+        }
+        return topics;
+    }
+
+    template <typename Route>
+    double Measure(const std::vector<std::string>& traffic, int messages, Route route)
+    {
+        std::uint32_t matched = 0U;
+        const auto    start   = Clock::now();
+        for (int i = 0; i < messages; ++i)
+        {
+            matched += route(traffic[static_cast<std::size_t>(i) % traffic.size()]);
+        }
+        g_sink = g_sink + matched;
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / messages;
+    }
+
+    void Run(std::size_t subscriptions)
+    {
+        std::vector<std::string> filters(std::begin(kWildcards), std::end(kWildcards));
+        for (std::size_t i = 0; i < subscriptions; ++i)
+        {
+            filters.push_back(StateTopic(i));
+        }
+
+        MqttTopicTrie trie;
+        const auto    build_start = Clock::now();
+        for (std::size_t i = 0; i < filters.size(); ++i)
+        {
+            trie.Add(filters[i], static_cast<MqttTopicTrie::HandlerId>(i));
+        }
+        trie.Compile();
+        const double build_ms =
+            std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+
+        const std::vector<std::string> traffic = Traffic(subscriptions);
+
+        // The scan is slow enough at the top end that fewer messages still time it well
+        const int    scan_messages = static_cast<int>(kMessages / (subscriptions / 250U + 1U));
+        const double scan          = Measure(traffic, scan_messages, [&filters](const auto& topic) {
+            std::uint32_t found = 0U;
+            for (const std::string& filter : filters)
+            {
+                found += MqttTopicMatches(filter, topic) ? 1U : 0U;
+            }
+            return found;
+        });
+
+        const double walk = Measure(traffic, kMessages, [&trie](const auto& topic) {
+            return static_cast<std::uint32_t>(trie.Match(topic, [](MqttTopicTrie::HandlerId) {}));
+        });
+
+        std::printf("  %6zu filters  scan %10.0f ns/msg  trie %5.0f ns/msg  (%4.0fx)"
+                    "  %6zu nodes, compile %5.1f ms\n",
+                    filters.size(),
+                    scan,
+                    walk,
+                    scan / walk,
+                    trie.NodeCount(),
+                    build_ms);
+    }
+
+}  // namespace
+
+int main()
+{
+    std::printf("MQTT topic routing, %zu wildcard filters plus one state topic per entity\n",
+                sizeof(kWildcards) / sizeof(kWildcards[0]));
+    for (std::size_t subscriptions : {100U, 1000U, 5000U, 20000U})
+    {
+        Run(subscriptions);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+// CPU cost of moving UART monitor bytes between the UI and the RS485 task. The old path
+// pushed and popped one byte at a time on a mutex-guarded std::queue and handed the driver
+// one byte per uart_write_bytes() call; the new one copies whole spans through a SpscRing.
+// Both move 8-byte Modbus RTU frames (a register read request) with a stand-in driver
+// write that only counts its calls, so the figures are the queueing overhead alone.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+
+#include "platform/spsc_ring.h"
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int          kFrames             = 100000;
+    constexpr std::size_t  kFrameBytes         = 8U;
+    constexpr std::uint8_t kFrame[kFrameBytes] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD};
+
+    struct FakeUart
+    {
+        std::uint64_t calls = 0U;
+        std::uint64_t bytes = 0U;
+
+        int Write(const std::uint8_t*, std::size_t len)
+        {
+            calls++;
+            bytes += len;
+            return static_cast<int>(len);
+        }
+    };
+
+    double NsPerByte(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+               / (static_cast<double>(kFrames) * kFrameBytes);
+    }
+
+    double BenchLockedQueue(FakeUart& uart)
+    {
+        std::mutex               mutex;
+        std::queue<std::uint8_t> queue;
+        const auto               start = Clock::now();
+        for (int f = 0; f < kFrames; ++f)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (std::uint8_t byte : kFrame)
+                {
+                    queue.push(byte);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!queue.empty())
+            {
+                const std::uint8_t byte = queue.front();
+                queue.pop();
+                uart.Write(&byte, 1U);
+            }
+        }
+        return NsPerByte(start);
+    }
+
+    double BenchSpanRing(FakeUart& uart)
+    {
+        custom::platform::SpscRing<std::uint8_t> ring(4096U);
+        const auto                               start = Clock::now();
+        for (int f = 0; f < kFrames; ++f)
+        {
+            ring.Push(kFrame, kFrameBytes);
+            for (auto span = ring.ReadSpan(); span.size > 0U; span = ring.ReadSpan())
+            {
+                ring.CommitRead(static_cast<std::size_t>(uart.Write(span.data, span.size)));
+            }
+        }
+        return NsPerByte(start);
+    }
+
+}  // namespace
+
+int main()
+{
+    FakeUart     queued;
+    FakeUart     spans;
+    const double queue_ns = BenchLockedQueue(queued);
+    const double ring_ns  = BenchSpanRing(spans);
+
+    std::printf("uart monitor tx: %d frames of %zu bytes\n", kFrames, kFrameBytes);
+    std::printf("  mutex + std::queue, per byte  %6.2f ns/byte  %8.2f driver writes/frame\n",
+                queue_ns,
+                static_cast<double>(queued.calls) / kFrames);
+    std::printf("  SpscRing spans                %6.2f ns/byte  %8.2f driver writes/frame\n",
+                ring_ns,
+                static_cast<double>(spans.calls) / kFrames);
+    return 0;
+}
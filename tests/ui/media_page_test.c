@@ -217,5 +217,77 @@ int main(void)
         return 1;
     }
 
+    lv_obj_t* progress = ui_page_media_get_progress_bar();
+    if (!ensure(progress != NULL, "Progress bar missing"))
+    {
+        return 1;
+    }
+    lv_obj_t* progress_row = lv_obj_get_parent(progress);
+    if (!ensure(lv_obj_has_flag(progress_row, LV_OBJ_FLAG_HIDDEN),
+                "Progress shown for a track without a duration"))
+    {
+        return 1;
+    }
+
+    ui_page_media_now_playing_t track = {
+        .media_id   = "media.test",
+        .title      = "Test Track",
+        .artist     = "Test Artist",
+        .source     = "Test Source",
+        .playing    = true,
+        .volume     = 30,
+        .position_s = 65,
+        .duration_s = 200,
+    };
+    ui_page_media_set_now_playing(&track);
+    if (!ensure(!lv_obj_has_flag(progress_row, LV_OBJ_FLAG_HIDDEN), "Progress hidden"))
+    {
+        return 1;
+    }
+    if (!ensure(lv_bar_get_value(progress) == 65 && lv_bar_get_max_value(progress) == 200,
+                "Progress value incorrect"))
+    {
+        return 1;
+    }
+
+    track.duration_s = 0;
+    ui_page_media_set_now_playing(&track);
+    if (!ensure(lv_obj_has_flag(progress_row, LV_OBJ_FLAG_HIDDEN), "Progress not hidden"))
+    {
+        return 1;
+    }
+
+    lv_obj_t* artwork = ui_page_media_get_artwork();
+    if (!ensure(artwork != NULL && lv_obj_has_flag(artwork, LV_OBJ_FLAG_HIDDEN),
+                "Artwork shown before any was set"))
+    {
+        return 1;
+    }
+
+    static const uint16_t k_cover_pixels[4] = {0xF800, 0xF800, 0x001F, 0x001F};
+    lv_image_dsc_t        cover             = {0};
+
+    cover.header.magic  = LV_IMAGE_HEADER_MAGIC;
+    cover.header.cf     = LV_COLOR_FORMAT_RGB565;
+    cover.header.w      = 2;
+    cover.header.h      = 2;
+    cover.header.stride = 4;
+    cover.data_size     = sizeof(k_cover_pixels);
+    cover.data          = (const uint8_t*)k_cover_pixels;
+    ui_page_media_set_artwork(&cover);
+    lv_timer_handler_run_in_period(5);
+    if (!ensure(!lv_obj_has_flag(artwork, LV_OBJ_FLAG_HIDDEN)
+                    && lv_image_get_src(artwork) == (const void*)&cover,
+                "Artwork not shown"))
+    {
+        return 1;
+    }
+
+    ui_page_media_set_artwork(NULL);
+    if (!ensure(lv_obj_has_flag(artwork, LV_OBJ_FLAG_HIDDEN), "Artwork not hidden"))
+    {
+        return 1;
+    }
+
     return 0;
 }
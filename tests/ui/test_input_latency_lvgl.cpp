@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "lvgl.h"
+#include "platform/input/input_latency_lvgl.h"
+
+namespace
+{
+
+    using custom::platform::InputLatencySnapshot;
+    using custom::platform::InputLatencyTracker;
+
+    struct PointerState
+    {
+        bool       pressed = false;
+        lv_point_t point   = {0, 0};
+    };
+
+    PointerState pointer;
+
+    void ReadPointer(lv_indev_t* indev, lv_indev_data_t* data)
+    {
+        LV_UNUSED(indev);
+        data->point = pointer.point;
+        data->state = pointer.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    }
+
+    void FlushNoop(lv_display_t* display, const lv_area_t* area, uint8_t* px_map)
+    {
+        LV_UNUSED(area);
+        LV_UNUSED(px_map);
+        lv_display_flush_ready(display);
+    }
+
+    void CountPress(lv_event_t* event)
+    {
+        ++*static_cast<int*>(lv_event_get_user_data(event));
+    }
+
+}  // namespace
+
+TEST(InputLatencyLvgl, PressOnAClickableChildIsDispatched)
+{
+    lv_init();
+
+    constexpr uint32_t kHorRes      = 320;
+    constexpr uint32_t kVerRes      = 180;
+    constexpr uint32_t kBufferLines = 20;
+
+    static lv_color_t    buffer[kHorRes * kBufferLines];
+    static lv_draw_buf_t draw_buffer;
+    lv_result_t          init_result = lv_draw_buf_init(
+        &draw_buffer, kHorRes, kBufferLines, LV_COLOR_FORMAT_NATIVE, 0, buffer, sizeof(buffer));
+    ASSERT_EQ(init_result, LV_RESULT_OK);
+
+    lv_display_t* display = lv_display_create(kHorRes, kVerRes);
+    ASSERT_NE(display, nullptr);
+    lv_display_set_draw_buffers(display, &draw_buffer, nullptr);
+    lv_display_set_flush_cb(display, FlushNoop);
+    lv_display_set_default(display);
+
+    // Like the launcher pages: a full-screen clickable object that keeps PRESSED to itself
+    lv_obj_t* screen         = lv_screen_active();
+    lv_obj_t* page           = lv_obj_create(screen);
+    int       screen_presses = 0;
+    int       page_presses   = 0;
+    lv_obj_set_size(page, LV_PCT(100), LV_PCT(100));
+    lv_obj_add_event_cb(screen, CountPress, LV_EVENT_PRESSED, &screen_presses);
+    lv_obj_add_event_cb(page, CountPress, LV_EVENT_PRESSED, &page_presses);
+    lv_refr_now(display);
+
+    lv_indev_t* indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, ReadPointer);
+
+    std::uint64_t               now_us = 1000U;
+    InputLatencyTracker::Config config;
+    config.clock = [&now_us]() { return now_us; };
+    InputLatencyTracker     tracker(config);
+    std::vector<lv_point_t> pressed_at;
+    ASSERT_TRUE(custom::platform::InstrumentLvglInputLatency(
+        tracker, indev, display, [&pressed_at](const lv_point_t& point) {
+            pressed_at.push_back(point);
+        }));
+    EXPECT_FALSE(custom::platform::InstrumentLvglInputLatency(tracker, indev, display));
+
+    pointer.pressed = true;
+    pointer.point   = {40, 30};
+    lv_indev_read(indev);
+    EXPECT_EQ(1, page_presses);
+    EXPECT_EQ(0, screen_presses);
+
+    now_us += 4000U;
+    lv_obj_invalidate(page);
+    lv_refr_now(display);
+
+    pointer.pressed = false;
+    now_us += 1000U;
+    lv_indev_read(indev);
+
+    const InputLatencySnapshot snapshot = tracker.Snapshot();
+    EXPECT_EQ(1U, snapshot.presses);
+    EXPECT_EQ(0U, snapshot.no_frame);
+    EXPECT_EQ(1U, snapshot.read_to_dispatch.count);
+    EXPECT_EQ(1U, snapshot.dispatch_to_frame.count);
+    EXPECT_EQ(4000U, snapshot.read_to_frame.max_us);
+    ASSERT_EQ(1U, pressed_at.size());
+    EXPECT_EQ(40, pressed_at[0].x);
+    EXPECT_EQ(30, pressed_at[0].y);
+}
@@ -0,0 +1,268 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "integration/artwork_loader.h"
+
+namespace
+{
+
+    using custom::integration::ArtworkImage;
+    using custom::integration::ArtworkLoader;
+    using custom::platform::AudioSource;
+    using custom::platform::MemoryAudioSource;
+
+    // 4x4 solid red and solid blue PNGs
+    constexpr std::uint8_t kRedPng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04,
+        0x08, 0x02, 0x00, 0x00, 0x00, 0x26, 0x93, 0x09, 0x29, 0x00, 0x00, 0x00,
+        0x10, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0xF8, 0xCF, 0xC0, 0x00,
+        0x47, 0x0C, 0xC4, 0x71, 0x00, 0xAE, 0x93, 0x0F, 0xF1, 0x38, 0x5E, 0x8C,
+        0x11, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60,
+        0x82,
+    };
+
+    constexpr std::uint8_t kBluePng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04,
+        0x08, 0x02, 0x00, 0x00, 0x00, 0x26, 0x93, 0x09, 0x29, 0x00, 0x00, 0x00,
+        0x10, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0x60, 0x60, 0xF8, 0x8F,
+        0x84, 0x88, 0xE2, 0x00, 0x00, 0x8E, 0xB3, 0x0F, 0xF1, 0x5B, 0xA2, 0x80,
+        0xBC, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60,
+        0x82,
+    };
+
+    constexpr std::uint16_t kRed565  = 0xF800U;
+    constexpr std::uint16_t kBlue565 = 0x001FU;
+
+    constexpr const char* kRedUrl  = "http://ha.local/api/media_player_proxy/mp?token=t1&cache=r";
+    constexpr const char* kBlueUrl = "https://covers.example/blue.png";
+
+    /** Serves URLs from memory and counts the opens, in place of HTTP. */
+    class ArtworkLoaderTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            static int counter = 0;
+
+            sd_dir = ::testing::TempDir() + "artwork_test_" + std::to_string(counter++);
+            AddImage(kRedUrl, kRedPng, sizeof(kRedPng));
+            AddImage(kBlueUrl, kBluePng, sizeof(kBluePng));
+        }
+
+        void TearDown() override
+        {
+            for (std::uint32_t slot = 0U; slot < 256U; ++slot)
+            {
+                char name[16];
+                std::snprintf(name, sizeof(name), "/%04x.art", static_cast<unsigned>(slot));
+                std::remove((sd_dir + name).c_str());
+            }
+            std::remove(sd_dir.c_str());
+        }
+
+        void AddImage(const std::string& url, const std::uint8_t* data, std::size_t size)
+        {
+            images[ArtworkLoader::CacheKey(url)] = std::vector<std::uint8_t>(data, data + size);
+        }
+
+        ArtworkLoader::Config MakeConfig()
+        {
+            ArtworkLoader::Config config;
+            config.width  = 4U;
+            config.height = 4U;
+            config.sd_dir = sd_dir;
+            config.open   = [this](const std::string& url) -> std::unique_ptr<AudioSource> {
+                opens.push_back(url);
+                const auto found = images.find(ArtworkLoader::CacheKey(url));
+                if (found == images.end())
+                {
+                    return nullptr;
+                }
+                return std::make_unique<MemoryAudioSource>(found->second.data(),
+                                                           found->second.size());
+            };
+            return config;
+        }
+
+        /** What the media page would show after the next refresh tick. */
+        const ArtworkImage* Shown(ArtworkLoader& loader)
+        {
+            const ArtworkImage* image = nullptr;
+            if (loader.TakeReady(image))
+            {
+                shown = image;
+            }
+            return shown;
+        }
+
+        std::string                                      sd_dir;
+        std::map<std::string, std::vector<std::uint8_t>> images;
+        std::vector<std::string>                         opens;
+        const ArtworkImage*                              shown = nullptr;
+    };
+
+    TEST_F(ArtworkLoaderTest, FetchedCoverIsDecodedToCardSizeAndKeptInRam)
+    {
+        ArtworkLoader loader(MakeConfig());
+        loader.Show(kRedUrl);
+        EXPECT_EQ(nullptr, Shown(loader));  // nothing until the worker has run
+
+        ASSERT_TRUE(loader.RunOnce(0U));
+        const ArtworkImage* red = Shown(loader);
+        ASSERT_NE(nullptr, red);
+        EXPECT_EQ(4U, red->width);
+        EXPECT_EQ(4U, red->height);
+        EXPECT_EQ(std::vector<std::uint16_t>(16U, kRed565), red->pixels);
+
+        loader.Show(kBlueUrl);
+        EXPECT_EQ(nullptr, Shown(loader));  // the old cover goes at once
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+        EXPECT_EQ(kBlue565, Shown(loader)->pixels[0]);
+
+        // Back to a cover still in RAM: shown at once, no request for the worker
+        loader.Show(kRedUrl);
+        ASSERT_NE(nullptr, Shown(loader));
+        EXPECT_EQ(kRed565, Shown(loader)->pixels[0]);
+        EXPECT_EQ(2U, opens.size());
+
+        const ArtworkLoader::Stats stats = loader.GetStats();
+        EXPECT_EQ(1U, stats.ram_hits);
+        EXPECT_EQ(2U, stats.fetches);
+        EXPECT_EQ(0U, stats.sd_hits);
+        EXPECT_EQ(0U, stats.failures);
+    }
+
+    TEST_F(ArtworkLoaderTest, SdCacheOutlivesTheLoader)
+    {
+        {
+            ArtworkLoader loader(MakeConfig());
+            loader.Show(kRedUrl);
+            ASSERT_TRUE(loader.RunOnce(0U));
+        }
+
+        ArtworkLoader loader(MakeConfig());
+        loader.Show(kRedUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+        EXPECT_EQ(kRed565, Shown(loader)->pixels[0]);
+        EXPECT_EQ(1U, opens.size());
+        EXPECT_EQ(1U, loader.GetStats().sd_hits);
+        EXPECT_EQ(0U, loader.GetStats().fetches);
+    }
+
+    TEST_F(ArtworkLoaderTest, RamBudgetSpillsToSd)
+    {
+        ArtworkLoader::Config config = MakeConfig();
+        config.ram_budget_bytes      = sizeof(ArtworkImage) + 16U * sizeof(std::uint16_t);
+        ArtworkLoader loader(std::move(config));
+
+        loader.Show(kRedUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+        loader.Show(kBlueUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+
+        // Red made room for blue; it comes back from the card, not the network
+        loader.Show(kRedUrl);
+        EXPECT_EQ(nullptr, Shown(loader));
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+        EXPECT_EQ(kRed565, Shown(loader)->pixels[0]);
+        EXPECT_EQ(2U, loader.GetStats().fetches);
+        EXPECT_EQ(1U, loader.GetStats().sd_hits);
+    }
+
+    TEST_F(ArtworkLoaderTest, SlotCollisionIsAMissNotAWrongCover)
+    {
+        ArtworkLoader::Config config = MakeConfig();
+        config.sd_slots              = 1U;
+        {
+            ArtworkLoader loader(config);
+            loader.Show(kRedUrl);
+            ASSERT_TRUE(loader.RunOnce(0U));
+            loader.Show(kBlueUrl);  // takes over the only slot
+            ASSERT_TRUE(loader.RunOnce(0U));
+        }
+
+        ArtworkLoader loader(config);
+        loader.Show(kRedUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+        EXPECT_EQ(kRed565, Shown(loader)->pixels[0]);
+        EXPECT_EQ(0U, loader.GetStats().sd_hits);
+        EXPECT_EQ(1U, loader.GetStats().fetches);
+    }
+
+    TEST_F(ArtworkLoaderTest, RotatedTokenKeepsTheCover)
+    {
+        EXPECT_EQ("http://ha.local/api/media_player_proxy/mp?cache=r",
+                  ArtworkLoader::CacheKey(kRedUrl));
+        EXPECT_EQ("http://h/a?cache=1", ArtworkLoader::CacheKey("http://h/a?cache=1&token=x"));
+        EXPECT_EQ(kBlueUrl, ArtworkLoader::CacheKey(kBlueUrl));
+
+        ArtworkLoader loader(MakeConfig());
+        loader.Show(kRedUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_NE(nullptr, Shown(loader));
+
+        const ArtworkImage* image = nullptr;
+        loader.Show("http://ha.local/api/media_player_proxy/mp?token=t2&cache=r");
+        EXPECT_FALSE(loader.TakeReady(image));
+        ASSERT_TRUE(loader.RunOnce(0U));  // no request waiting
+        EXPECT_EQ(1U, opens.size());
+    }
+
+    TEST_F(ArtworkLoaderTest, OnlyTheLatestCoverIsFetched)
+    {
+        ArtworkLoader loader(MakeConfig());
+        loader.Show(kRedUrl);
+        loader.Show(kBlueUrl);  // skipped before the worker got to red
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_TRUE(loader.RunOnce(0U));
+        ASSERT_EQ(1U, opens.size());
+        EXPECT_EQ(kBlueUrl, opens[0]);
+
+        // Red finished after the page moved on: dropped, not shown
+        loader.Show(kRedUrl);
+        ASSERT_TRUE(loader.RunOnce(0U));
+        loader.Show("");
+        EXPECT_EQ(nullptr, Shown(loader));
+        const ArtworkImage* image = nullptr;
+        EXPECT_FALSE(loader.TakeReady(image));
+    }
+
+    TEST_F(ArtworkLoaderTest, UnreadableCoverShowsNothing)
+    {
+        const std::uint8_t garbage[] = {'<', 'h', 't', 'm', 'l', '>'};
+        AddImage("http://covers.example/error.html", garbage, sizeof(garbage));
+
+        ArtworkLoader loader(MakeConfig());
+        for (const char* url :
+             {"http://covers.example/missing.png", "http://covers.example/error.html"})
+        {
+            loader.Show(url);
+            ASSERT_TRUE(loader.RunOnce(0U));
+            EXPECT_EQ(nullptr, Shown(loader));
+        }
+        EXPECT_EQ(2U, loader.GetStats().failures);
+
+        loader.Stop();
+        EXPECT_FALSE(loader.RunOnce(0U));
+    }
+
+}  // namespace
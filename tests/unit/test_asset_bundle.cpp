@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "assets/asset_bundle.h"
+
+namespace
+{
+
+    struct BundleAsset
+    {
+        std::string               id;
+        std::uint16_t             width  = 0U;
+        std::uint16_t             height = 0U;
+        std::vector<std::uint8_t> pixels;
+        /** Forces the index hash, to exercise collisions. */
+        std::uint32_t hash_override = 0U;
+    };
+
+    void PutU16(std::vector<std::uint8_t>& out, std::size_t at, std::uint16_t v)
+    {
+        out[at]     = static_cast<std::uint8_t>(v & 0xFFU);
+        out[at + 1] = static_cast<std::uint8_t>(v >> 8);
+    }
+
+    void PutU32(std::vector<std::uint8_t>& out, std::size_t at, std::uint32_t v)
+    {
+        PutU16(out, at, static_cast<std::uint16_t>(v & 0xFFFFU));
+        PutU16(out, at + 2, static_cast<std::uint16_t>(v >> 16));
+    }
+
+    std::size_t AlignBlob(std::size_t v)
+    {
+        return (v + ASSET_BUNDLE_BLOB_ALIGN - 1U) / ASSET_BUNDLE_BLOB_ALIGN * ASSET_BUNDLE_BLOB_ALIGN;
+    }
+
+    /** Mirrors write_bundle() in tools/gen_assets.py. */
+    std::vector<std::uint8_t> BuildBundle(std::vector<BundleAsset> assets)
+    {
+        auto key = [](const BundleAsset& a) {
+            return a.hash_override != 0U ? a.hash_override : asset_bundle_hash(a.id.c_str());
+        };
+        std::sort(assets.begin(), assets.end(), [&](const BundleAsset& a, const BundleAsset& b) {
+            return key(a) != key(b) ? key(a) < key(b) : a.id < b.id;
+        });
+
+        std::string              strings;
+        std::vector<std::size_t> name_offsets;
+        for (const auto& asset : assets)
+        {
+            name_offsets.push_back(strings.size());
+            strings += asset.id;
+            strings.push_back('\0');
+        }
+
+        const std::size_t index_offset   = ASSET_BUNDLE_HEADER_SIZE;
+        const std::size_t strings_offset = index_offset + assets.size() * ASSET_BUNDLE_ENTRY_SIZE;
+        const std::size_t data_offset    = AlignBlob(strings_offset + strings.size());
+        std::size_t       total          = data_offset;
+        for (const auto& asset : assets)
+        {
+            total = AlignBlob(total + asset.pixels.size());
+        }
+
+        std::vector<std::uint8_t> out(total, 0U);
+        std::copy_n(ASSET_BUNDLE_MAGIC, 4, out.begin());
+        PutU16(out, 4, ASSET_BUNDLE_VERSION);
+        PutU16(out, 6, ASSET_BUNDLE_HEADER_SIZE);
+        PutU32(out, 8, static_cast<std::uint32_t>(assets.size()));
+        PutU32(out, 12, static_cast<std::uint32_t>(index_offset));
+        PutU32(out, 16, static_cast<std::uint32_t>(strings_offset));
+        PutU32(out, 20, static_cast<std::uint32_t>(strings.size()));
+        PutU32(out, 24, static_cast<std::uint32_t>(data_offset));
+        PutU32(out, 28, static_cast<std::uint32_t>(total));
+        std::copy(strings.begin(), strings.end(), out.begin() + strings_offset);
+
+        std::size_t blob = data_offset;
+        for (std::size_t i = 0; i < assets.size(); ++i)
+        {
+            const auto&       asset = assets[i];
+            const std::size_t e     = index_offset + i * ASSET_BUNDLE_ENTRY_SIZE;
+            const auto        size  = static_cast<std::uint32_t>(asset.pixels.size());
+            PutU32(out, e, key(asset));
+            PutU32(out, e + 4, static_cast<std::uint32_t>(name_offsets[i]));
+            PutU32(out, e + 8, static_cast<std::uint32_t>(blob));
+            PutU32(out, e + 12, size);
+            PutU32(out, e + 16, size);
+            PutU16(out, e + 20, asset.width);
+            PutU16(out, e + 22, asset.height);
+            PutU16(out, e + 24, static_cast<std::uint16_t>(asset.width * 2U));
+            out[e + 26] = ASSET_FORMAT_RGB565;
+            out[e + 27] = ASSET_COMPRESSION_NONE;
+            std::copy(asset.pixels.begin(), asset.pixels.end(), out.begin() + blob);
+            blob = AlignBlob(blob + asset.pixels.size());
+        }
+        return out;
+    }
+
+    BundleAsset SolidAsset(const std::string& id, std::uint16_t w, std::uint16_t h, std::uint8_t fill)
+    {
+        BundleAsset asset;
+        asset.id     = id;
+        asset.width  = w;
+        asset.height = h;
+        asset.pixels.assign(static_cast<std::size_t>(w) * h * 2U, fill);
+        return asset;
+    }
+
+    TEST(AssetBundleTest, HashIsFnv1aLikeTheGenerator)
+    {
+        EXPECT_EQ(0x811C9DC5U, asset_bundle_hash(""));
+        EXPECT_EQ(0x82FBF5CDU, asset_bundle_hash("blue"));
+    }
+
+    TEST(AssetBundleTest, FindsEveryIdWithoutCopying)
+    {
+        std::vector<BundleAsset> assets;
+        for (int i = 0; i < 40; ++i)
+        {
+            assets.push_back(SolidAsset("icon_" + std::to_string(i),
+                                        static_cast<std::uint16_t>(i + 1),
+                                        3U,
+                                        static_cast<std::uint8_t>(i)));
+        }
+        const auto blob = BuildBundle(assets);
+
+        asset_bundle_t bundle;
+        ASSERT_TRUE(asset_bundle_open_memory(&bundle, blob.data(), blob.size()));
+        EXPECT_EQ(40U, bundle.entry_count);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            const std::string    id = "icon_" + std::to_string(i);
+            asset_bundle_entry_t entry;
+            ASSERT_TRUE(asset_bundle_find(&bundle, id.c_str(), &entry)) << id;
+            EXPECT_EQ(id, entry.id);
+            EXPECT_EQ(i + 1, entry.width);
+            EXPECT_EQ(3U, entry.height);
+            EXPECT_EQ(entry.width * 2U, entry.stride);
+            EXPECT_EQ(entry.width * 6U, entry.data_size);
+            EXPECT_EQ(static_cast<std::uint8_t>(i), entry.data[0]);
+            EXPECT_GE(entry.data, blob.data());
+            EXPECT_LT(entry.data, blob.data() + blob.size());
+            EXPECT_EQ(0U, (entry.data - blob.data()) % ASSET_BUNDLE_BLOB_ALIGN);
+        }
+        EXPECT_FALSE(asset_bundle_find(&bundle, "icon_40", nullptr));
+        EXPECT_FALSE(asset_bundle_find(&bundle, "", nullptr));
+    }
+
+    TEST(AssetBundleTest, CollidingHashesAreResolvedByName)
+    {
+        auto a          = SolidAsset("first", 1U, 1U, 0x11U);
+        auto b          = SolidAsset("second", 1U, 1U, 0x22U);
+        auto c          = SolidAsset("third", 1U, 1U, 0x33U);
+        a.hash_override = asset_bundle_hash("second");
+        c.hash_override = asset_bundle_hash("second");
+        const auto blob = BuildBundle({a, b, c});
+
+        asset_bundle_t bundle;
+        ASSERT_TRUE(asset_bundle_open_memory(&bundle, blob.data(), blob.size()));
+        asset_bundle_entry_t entry;
+        ASSERT_TRUE(asset_bundle_find(&bundle, "second", &entry));
+        EXPECT_EQ(0x22U, entry.data[0]);
+        // "first" and "third" are stored under the wrong hash, so a lookup must not find them.
+        EXPECT_FALSE(asset_bundle_find(&bundle, "first", &entry));
+    }
+
+    TEST(AssetBundleTest, RejectsCorruptBundles)
+    {
+        const auto     good = BuildBundle({SolidAsset("logo", 4U, 4U, 0xAAU)});
+        asset_bundle_t bundle;
+
+        auto bad_magic = good;
+        bad_magic[0]   = 'X';
+        EXPECT_FALSE(asset_bundle_open_memory(&bundle, bad_magic.data(), bad_magic.size()));
+
+        auto bad_version = good;
+        PutU16(bad_version, 4, ASSET_BUNDLE_VERSION + 1U);
+        EXPECT_FALSE(asset_bundle_open_memory(&bundle, bad_version.data(), bad_version.size()));
+
+        EXPECT_FALSE(asset_bundle_open_memory(&bundle, good.data(), good.size() - 1U));
+
+        auto huge_index = good;
+        PutU32(huge_index, 8, 0x10000000U);
+        EXPECT_FALSE(asset_bundle_open_memory(&bundle, huge_index.data(), huge_index.size()));
+
+        // A blob that runs off the end keeps the bundle usable but hides that entry.
+        auto bad_blob = good;
+        PutU32(bad_blob, ASSET_BUNDLE_HEADER_SIZE + 12U, static_cast<std::uint32_t>(good.size()));
+        ASSERT_TRUE(asset_bundle_open_memory(&bundle, bad_blob.data(), bad_blob.size()));
+        EXPECT_FALSE(asset_bundle_find(&bundle, "logo", nullptr));
+    }
+
+    TEST(AssetBundleTest, TrailingPartitionSpaceIsIgnored)
+    {
+        auto blob = BuildBundle({SolidAsset("logo", 2U, 2U, 0x5AU)});
+        blob.resize(blob.size() + 4096U, 0xFFU);  // erased flash after the bundle
+
+        asset_bundle_t bundle;
+        ASSERT_TRUE(asset_bundle_open_memory(&bundle, blob.data(), blob.size()));
+        EXPECT_LT(bundle.size, blob.size());
+        EXPECT_TRUE(asset_bundle_find(&bundle, "logo", nullptr));
+    }
+
+    TEST(AssetBundleTest, OpenMapsABundleFile)
+    {
+        const auto        blob = BuildBundle({SolidAsset("wallpaper", 8U, 2U, 0x42U)});
+        const std::string path = ::testing::TempDir() + "asset_bundle_test.bundle";
+        FILE*             file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(blob.size(), std::fwrite(blob.data(), 1U, blob.size(), file));
+        std::fclose(file);
+
+        asset_bundle_t bundle;
+        ASSERT_TRUE(asset_bundle_open(&bundle, path.c_str()));
+        asset_bundle_entry_t entry;
+        ASSERT_TRUE(asset_bundle_find(&bundle, "wallpaper", &entry));
+        EXPECT_EQ(0x42U, entry.data[entry.data_size - 1U]);
+        asset_bundle_close(&bundle);
+        EXPECT_EQ(nullptr, bundle.base);
+        std::remove(path.c_str());
+
+        EXPECT_FALSE(asset_bundle_open(&bundle, path.c_str()));
+    }
+
+}  // namespace
@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "assets/asset_cache.h"
+
+namespace
+{
+
+    /** Decoder double: sizes per id, a decode counter and a live-buffer count. */
+    struct FakeImageDecoder
+    {
+        std::map<std::string, std::size_t> sizes;
+        int                                 decodes = 0;
+        int                                 live    = 0;
+
+        static void* Decode(void* ctx, const char* id, std::size_t* out_size)
+        {
+            auto*      self = static_cast<FakeImageDecoder*>(ctx);
+            const auto it   = self->sizes.find(id);
+            if (it == self->sizes.end())
+            {
+                return nullptr;
+            }
+            self->decodes++;
+            self->live++;
+            *out_size = it->second;
+            return std::calloc(1U, it->second);
+        }
+
+        static void Discard(void* ctx, void* data)
+        {
+            static_cast<FakeImageDecoder*>(ctx)->live--;
+            std::free(data);
+        }
+    };
+
+    class AssetCacheTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            decoder.sizes = {{"wallpaper", 600U}, {"a", 100U}, {"b", 100U}, {"c", 100U}};
+        }
+
+        void TearDown() override
+        {
+            asset_cache_destroy(cache);
+            EXPECT_EQ(0, decoder.live);
+        }
+
+        void Create(std::size_t budget)
+        {
+            asset_cache_config_t config = {};
+            config.budget_bytes         = budget;
+            config.decode               = &FakeImageDecoder::Decode;
+            config.discard              = &FakeImageDecoder::Discard;
+            config.ctx                  = &decoder;
+            cache                       = asset_cache_create(&config);
+            ASSERT_NE(nullptr, cache);
+        }
+
+        asset_cache_stats_t Stats() const
+        {
+            asset_cache_stats_t stats = {};
+            asset_cache_get_stats(cache, &stats);
+            return stats;
+        }
+
+        FakeImageDecoder decoder;
+        asset_cache_t*   cache = nullptr;
+    };
+
+    TEST_F(AssetCacheTest, SecondAcquireIsAHit)
+    {
+        Create(1000U);
+        const void* first = asset_cache_acquire(cache, "a");
+        ASSERT_NE(nullptr, first);
+        asset_cache_release(cache, "a");
+        EXPECT_EQ(first, asset_cache_acquire(cache, "a"));
+        asset_cache_release(cache, "a");
+
+        const auto stats = Stats();
+        EXPECT_EQ(1U, stats.hits);
+        EXPECT_EQ(1U, stats.misses);
+        EXPECT_EQ(1, decoder.decodes);
+        EXPECT_EQ(100U, stats.bytes_used);
+    }
+
+    TEST_F(AssetCacheTest, EvictsLeastRecentlyUsedFirst)
+    {
+        Create(250U);
+        for (const char* id : {"a", "b"})
+        {
+            asset_cache_acquire(cache, id);
+            asset_cache_release(cache, id);
+        }
+        asset_cache_acquire(cache, "a");  // b is now the coldest
+        asset_cache_release(cache, "a");
+        asset_cache_acquire(cache, "c");
+        asset_cache_release(cache, "c");
+
+        EXPECT_TRUE(asset_cache_contains(cache, "a"));
+        EXPECT_FALSE(asset_cache_contains(cache, "b"));
+        EXPECT_TRUE(asset_cache_contains(cache, "c"));
+        EXPECT_EQ(1U, Stats().evictions);
+    }
+
+    TEST_F(AssetCacheTest, ReferencedAndPinnedImagesSurviveEviction)
+    {
+        Create(700U);
+        ASSERT_NE(nullptr, asset_cache_pin(cache, "wallpaper"));
+        ASSERT_NE(nullptr, asset_cache_acquire(cache, "a"));
+
+        // Over budget while everything is in use: nothing can go yet.
+        ASSERT_NE(nullptr, asset_cache_acquire(cache, "b"));
+        EXPECT_EQ(800U, Stats().bytes_used);
+        EXPECT_EQ(0U, Stats().evictions);
+
+        // Releasing "a" trims back to the budget; the pinned wallpaper stays.
+        asset_cache_release(cache, "a");
+        EXPECT_FALSE(asset_cache_contains(cache, "a"));
+        EXPECT_TRUE(asset_cache_contains(cache, "wallpaper"));
+        EXPECT_EQ(700U, Stats().bytes_used);
+        EXPECT_EQ(1U, Stats().pinned);
+
+        asset_cache_release(cache, "b");
+        asset_cache_unpin(cache, "wallpaper");
+        asset_cache_set_budget(cache, 0U);
+        EXPECT_EQ(0U, Stats().entries);
+        EXPECT_EQ(800U, Stats().bytes_peak);
+    }
+
+    TEST_F(AssetCacheTest, ZeroBudgetDecodesEveryTime)
+    {
+        Create(0U);
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_NE(nullptr, asset_cache_acquire(cache, "wallpaper"));
+            asset_cache_release(cache, "wallpaper");
+        }
+        EXPECT_EQ(3, decoder.decodes);
+        EXPECT_EQ(0U, Stats().hits);
+        EXPECT_EQ(0U, Stats().bytes_used);
+    }
+
+    TEST_F(AssetCacheTest, UnknownIdsCountAsDecodeFailures)
+    {
+        Create(1000U);
+        EXPECT_EQ(nullptr, asset_cache_acquire(cache, "missing"));
+        asset_cache_release(cache, "missing");
+        EXPECT_EQ(1U, Stats().decode_failures);
+        EXPECT_EQ(0U, Stats().entries);
+
+        asset_cache_reset_stats(cache);
+        EXPECT_EQ(0U, Stats().misses);
+    }
+
+}  // namespace
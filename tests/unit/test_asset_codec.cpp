@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assets/asset_codec.h"
+
+namespace
+{
+
+    using Bytes = std::vector<std::uint8_t>;
+
+    /** Band table + payloads, as pack_bands() in tools/gen_assets.py writes them. */
+    Bytes BandedBlob(std::uint16_t band_rows, const std::vector<Bytes>& bands)
+    {
+        Bytes blob = {static_cast<std::uint8_t>(band_rows),
+                      static_cast<std::uint8_t>(band_rows >> 8),
+                      static_cast<std::uint8_t>(bands.size()),
+                      static_cast<std::uint8_t>(bands.size() >> 8)};
+        std::uint32_t offset = 0U;
+        auto          put    = [&blob](std::uint32_t v) {
+            for (int i = 0; i < 4; ++i)
+            {
+                blob.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+            }
+        };
+        put(0U);
+        for (const auto& band : bands)
+        {
+            offset += static_cast<std::uint32_t>(band.size());
+            put(offset);
+        }
+        for (const auto& band : bands)
+        {
+            blob.insert(blob.end(), band.begin(), band.end());
+        }
+        return blob;
+    }
+
+    asset_bundle_entry_t CodecEntry(const Bytes& blob, std::uint8_t compression, std::uint16_t w,
+                                    std::uint16_t h)
+    {
+        asset_bundle_entry_t entry = {};
+        entry.id                   = "test";
+        entry.data                 = blob.data();
+        entry.data_size            = static_cast<std::uint32_t>(blob.size());
+        entry.width                = w;
+        entry.height               = h;
+        entry.stride               = static_cast<std::uint16_t>(w * 2U);
+        entry.raw_size             = static_cast<std::uint32_t>(entry.stride) * h;
+        entry.format               = ASSET_FORMAT_RGB565;
+        entry.compression          = compression;
+        return entry;
+    }
+
+    TEST(AssetCodecTest, Rle16ExpandsRunsAndLiterals)
+    {
+        // Three copies of 0xF800, then two literal pixels.
+        const Bytes src = {0x82, 0x00, 0xF8, 0x01, 0x34, 0x12, 0x1F, 0x00};
+        Bytes       dst(10U);
+        ASSERT_EQ(10U, asset_rle16_decode(src.data(), src.size(), dst.data(), dst.size()));
+        EXPECT_EQ((Bytes{0x00, 0xF8, 0x00, 0xF8, 0x00, 0xF8, 0x34, 0x12, 0x1F, 0x00}), dst);
+
+        Bytes small(8U);
+        EXPECT_EQ(SIZE_MAX, asset_rle16_decode(src.data(), src.size(), small.data(), small.size()));
+        EXPECT_EQ(SIZE_MAX, asset_rle16_decode(src.data(), 6U, dst.data(), dst.size()));
+    }
+
+    TEST(AssetCodecTest, Lz4HandlesOverlappingMatches)
+    {
+        // "abcd", then an 8-byte match at offset 4, then the mandatory literal tail.
+        const Bytes src = {0x44, 'a', 'b', 'c', 'd', 0x04, 0x00, 0x50, 'e', 'f', 'g', 'h', 'i'};
+        Bytes       dst(17U);
+        ASSERT_EQ(17U, asset_lz4_decode(src.data(), src.size(), dst.data(), dst.size()));
+        EXPECT_EQ(std::string("abcdabcdabcdefghi"), std::string(dst.begin(), dst.end()));
+    }
+
+    TEST(AssetCodecTest, Lz4RejectsCorruptBlocks)
+    {
+        Bytes dst(32U);
+        // Match offset points before the start of the output.
+        const Bytes bad_offset = {0x10, 'a', 0x02, 0x00, 0x50, 'e', 'f', 'g', 'h', 'i'};
+        EXPECT_EQ(SIZE_MAX,
+                  asset_lz4_decode(bad_offset.data(), bad_offset.size(), dst.data(), 32U));
+        // Literal run longer than the input.
+        const Bytes truncated = {0x50, 'a', 'b'};
+        EXPECT_EQ(SIZE_MAX, asset_lz4_decode(truncated.data(), truncated.size(), dst.data(), 32U));
+        // Output larger than the destination.
+        const Bytes long_match = {0x1F, 'a', 0x01, 0x00, 0x40, 0x00, 'x', 'y', 'z', 'w', 'v'};
+        EXPECT_EQ(SIZE_MAX,
+                  asset_lz4_decode(long_match.data(), long_match.size(), dst.data(), 32U));
+    }
+
+    TEST(AssetCodecTest, StreamDecodesOneBandAtATime)
+    {
+        // 2x3 image in bands of two rows: a red band, then one blue row.
+        const Bytes blob  = BandedBlob(2U, {{0x83, 0x00, 0xF8}, {0x81, 0x1F, 0x00}});
+        const auto  entry = CodecEntry(blob, ASSET_COMPRESSION_RLE16, 2U, 3U);
+
+        asset_stream_t stream;
+        ASSERT_TRUE(asset_stream_open(&stream, &entry));
+        Bytes image(entry.raw_size, 0xEEU);
+        EXPECT_EQ(0U, asset_stream_row(&stream));
+        EXPECT_EQ(2U, asset_stream_next(&stream, image.data()));
+        EXPECT_EQ(2U, asset_stream_row(&stream));
+        EXPECT_EQ(1U, asset_stream_next(&stream, image.data() + 2U * entry.stride));
+        EXPECT_EQ(0U, asset_stream_next(&stream, image.data()));
+        EXPECT_FALSE(stream.error);
+        EXPECT_EQ((Bytes{0x00, 0xF8, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0xF8, 0x1F, 0x00, 0x1F, 0x00}),
+                  image);
+    }
+
+    TEST(AssetCodecTest, CorruptBandStopsTheStream)
+    {
+        // The second band decodes to one pixel instead of a full row.
+        const Bytes blob  = BandedBlob(2U, {{0x83, 0x00, 0xF8}, {0x80, 0x1F, 0x00}});
+        const auto  entry = CodecEntry(blob, ASSET_COMPRESSION_RLE16, 2U, 3U);
+        Bytes       image(entry.raw_size);
+        EXPECT_FALSE(asset_bundle_decode(&entry, image.data()));
+
+        // A band table that does not cover every row is rejected up front.
+        const Bytes    short_table = BandedBlob(1U, {{0x81, 0x00, 0xF8}});
+        const auto     bad_entry   = CodecEntry(short_table, ASSET_COMPRESSION_RLE16, 2U, 3U);
+        asset_stream_t stream;
+        EXPECT_FALSE(asset_stream_open(&stream, &bad_entry));
+    }
+
+    TEST(AssetCodecTest, UncompressedEntriesDecodeAsOneBand)
+    {
+        const Bytes raw   = {1, 2, 3, 4, 5, 6, 7, 8};
+        const auto  entry = CodecEntry(raw, ASSET_COMPRESSION_NONE, 2U, 2U);
+        Bytes       image(entry.raw_size);
+        ASSERT_TRUE(asset_bundle_decode(&entry, image.data()));
+        EXPECT_EQ(raw, image);
+    }
+
+}  // namespace
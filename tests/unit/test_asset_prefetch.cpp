@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "assets/asset_cache.h"
+#include "assets/asset_prefetch.h"
+
+namespace
+{
+
+    /** Prefetch ops backed by a real asset_cache with fake decodes, like asset_mount.c. */
+    struct PrefetchCacheHarness
+    {
+        std::map<std::string, std::size_t> sizes;
+        std::vector<std::string>           decoded;
+        asset_cache_t*                     cache = nullptr;
+
+        static void* Decode(void* ctx, const char* id, std::size_t* out_size)
+        {
+            auto*      self = static_cast<PrefetchCacheHarness*>(ctx);
+            const auto it   = self->sizes.find(id);
+            if (it == self->sizes.end())
+            {
+                return nullptr;
+            }
+            self->decoded.emplace_back(id);
+            *out_size = it->second;
+            return std::calloc(1U, it->second);
+        }
+
+        static void Discard(void* ctx, void* data)
+        {
+            (void)ctx;
+            std::free(data);
+        }
+
+        static bool IsReady(void* ctx, const char* id)
+        {
+            return asset_cache_contains(static_cast<PrefetchCacheHarness*>(ctx)->cache, id);
+        }
+
+        static bool Warm(void* ctx, const char* id)
+        {
+            auto* self = static_cast<PrefetchCacheHarness*>(ctx);
+            if (asset_cache_acquire(self->cache, id) == nullptr)
+            {
+                return false;
+            }
+            asset_cache_release(self->cache, id);
+            return true;
+        }
+    };
+
+    class AssetPrefetchTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            harness.sizes = {{"media_art", 100U}, {"media_bg", 100U}, {"cctv_grid", 100U}};
+
+            asset_cache_config_t config = {};
+            config.budget_bytes         = 1024U;
+            config.decode               = PrefetchCacheHarness::Decode;
+            config.discard              = PrefetchCacheHarness::Discard;
+            config.ctx                  = &harness;
+            harness.cache               = asset_cache_create(&config);
+            ASSERT_NE(nullptr, harness.cache);
+
+            asset_prefetch_ops_t ops = {};
+            ops.is_ready             = PrefetchCacheHarness::IsReady;
+            ops.warm                 = PrefetchCacheHarness::Warm;
+            ops.ctx                  = &harness;
+            asset_prefetch_init(&prefetch, &ops);
+        }
+
+        void TearDown() override
+        {
+            asset_cache_destroy(harness.cache);
+        }
+
+        PrefetchCacheHarness harness;
+        asset_prefetch_t     prefetch = {};
+    };
+
+    TEST_F(AssetPrefetchTest, StepsWarmOneImageAtATimeInQueueOrder)
+    {
+        EXPECT_TRUE(asset_prefetch_enqueue(&prefetch, "media_art"));
+        EXPECT_TRUE(asset_prefetch_enqueue(&prefetch, "cctv_grid"));
+        EXPECT_TRUE(asset_prefetch_enqueue(&prefetch, "media_art"));  // already queued
+        EXPECT_EQ(2U, prefetch.stats.queued);
+
+        EXPECT_TRUE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ(std::vector<std::string>{"media_art"}, harness.decoded);
+        EXPECT_FALSE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ((std::vector<std::string>{"media_art", "cctv_grid"}), harness.decoded);
+        EXPECT_FALSE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ(2U, prefetch.stats.warmed);
+    }
+
+    TEST_F(AssetPrefetchTest, ReadyImagesAreSkippedWithoutCostingAStep)
+    {
+        ASSERT_NE(nullptr, asset_cache_acquire(harness.cache, "media_art"));
+        asset_cache_release(harness.cache, "media_art");
+        harness.decoded.clear();
+
+        asset_prefetch_enqueue(&prefetch, "media_art");
+        asset_prefetch_enqueue(&prefetch, "media_bg");
+        EXPECT_FALSE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ(std::vector<std::string>{"media_bg"}, harness.decoded);
+        EXPECT_EQ(1U, prefetch.stats.skipped);
+        EXPECT_EQ(1U, prefetch.stats.warmed);
+    }
+
+    TEST_F(AssetPrefetchTest, CommitCancelsTheQueueAndScoresThePage)
+    {
+        asset_prefetch_enqueue(&prefetch, "media_art");
+        asset_prefetch_enqueue(&prefetch, "media_bg");
+        asset_prefetch_enqueue(&prefetch, "cctv_grid");
+        asset_prefetch_step(&prefetch);
+
+        // The user picks the media page before media_bg was warmed.
+        const char* const media[] = {"media_art", "media_bg"};
+        asset_prefetch_commit(&prefetch, media, 2U);
+        EXPECT_FALSE(asset_prefetch_pending(&prefetch));
+        EXPECT_FALSE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ(std::vector<std::string>{"media_art"}, harness.decoded);
+
+        EXPECT_EQ(2U, prefetch.stats.cancelled);
+        EXPECT_EQ(1U, prefetch.stats.commits);
+        EXPECT_EQ(1U, prefetch.stats.commit_hits);
+        EXPECT_EQ(1U, prefetch.stats.commit_misses);
+        EXPECT_EQ(0U, prefetch.stats.decode_free_commits);
+        EXPECT_EQ(50U, asset_prefetch_hit_rate(&prefetch.stats));
+    }
+
+    TEST_F(AssetPrefetchTest, FullyWarmedPageCommitsDecodeFree)
+    {
+        const char* const media[] = {"media_art", "media_bg"};
+        for (const char* id : media)
+        {
+            asset_prefetch_enqueue(&prefetch, id);
+        }
+        while (asset_prefetch_step(&prefetch))
+        {
+        }
+        asset_prefetch_commit(&prefetch, media, 2U);
+
+        // Showing the page now only hits the cache.
+        asset_cache_reset_stats(harness.cache);
+        for (const char* id : media)
+        {
+            EXPECT_NE(nullptr, asset_cache_acquire(harness.cache, id));
+        }
+        asset_cache_stats_t stats;
+        asset_cache_get_stats(harness.cache, &stats);
+        EXPECT_EQ(2U, stats.hits);
+        EXPECT_EQ(0U, stats.misses);
+
+        EXPECT_EQ(1U, prefetch.stats.decode_free_commits);
+        EXPECT_EQ(100U, asset_prefetch_hit_rate(&prefetch.stats));
+        for (const char* id : media)
+        {
+            asset_cache_release(harness.cache, id);
+        }
+    }
+
+    TEST_F(AssetPrefetchTest, FailedWarmsAreDeclinedAndTheQueueHasABound)
+    {
+        asset_prefetch_enqueue(&prefetch, "unknown");
+        EXPECT_FALSE(asset_prefetch_step(&prefetch));
+        EXPECT_EQ(1U, prefetch.stats.declined);
+
+        std::vector<std::string> ids;
+        for (unsigned i = 0; i <= ASSET_PREFETCH_QUEUE_MAX; ++i)
+        {
+            ids.push_back("id" + std::to_string(i));
+        }
+        for (unsigned i = 0; i < ASSET_PREFETCH_QUEUE_MAX; ++i)
+        {
+            EXPECT_TRUE(asset_prefetch_enqueue(&prefetch, ids[i].c_str()));
+        }
+        EXPECT_FALSE(asset_prefetch_enqueue(&prefetch, ids.back().c_str()));
+        asset_prefetch_cancel(&prefetch);
+        EXPECT_EQ(ASSET_PREFETCH_QUEUE_MAX, prefetch.stats.cancelled);
+        EXPECT_TRUE(asset_prefetch_enqueue(&prefetch, ids.back().c_str()));
+    }
+
+}  // namespace
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "platform/audio/audio_play_queue.h"
+
+namespace
+{
+
+    using custom::platform::AudioPlayQueue;
+    using custom::platform::AudioStats;
+
+    /** Simulated device: a manual clock plus a configurable cost per write call. */
+    struct FakeAudioDevice
+    {
+        std::uint64_t now_us          = 0U;
+        std::uint64_t write_cost_us   = 0U;
+        std::size_t   samples_written = 0U;
+    };
+
+    AudioPlayQueue MakeQueue(FakeAudioDevice& device, AudioStats& stats, std::size_t depth = 4U)
+    {
+        AudioPlayQueue::Config config;
+        config.max_depth             = depth;
+        config.sample_rate           = 48000U;
+        config.period_frames         = 480U;
+        config.device_latency_frames = 480U;
+        config.clock                 = [&device]() { return device.now_us; };
+        return AudioPlayQueue(
+            [&device](const std::int16_t*, std::size_t count) {
+                device.now_us += device.write_cost_us;
+                device.samples_written += count;
+            },
+            config,
+            stats);
+    }
+
+    std::vector<std::int16_t> Clip(std::size_t frames)
+    {
+        return std::vector<std::int16_t>(frames * 2U, 1000);
+    }
+
+    TEST(AudioPlayQueueTest, IdleDeviceLatencyIsThePipelineDepth)
+    {
+        FakeAudioDevice device;
+        AudioStats      stats;
+        AudioPlayQueue  queue = MakeQueue(device, stats);
+
+        ASSERT_TRUE(queue.Submit(Clip(960U), 0U));
+        device.now_us = 2000U;  // worker wakes up 2 ms after the tap
+        ASSERT_TRUE(queue.PlayNext(std::chrono::milliseconds(0)));
+
+        const auto snapshot = stats.Snapshot();
+        EXPECT_EQ(1U, snapshot.clips_played);
+        EXPECT_EQ(12000U, snapshot.trigger_to_sound_us.last_us);
+        EXPECT_EQ(2U, snapshot.write_us.count);
+        EXPECT_EQ(0U, snapshot.underruns);
+        EXPECT_EQ(960U * 2U, device.samples_written);
+    }
+
+    TEST(AudioPlayQueueTest, QueuedClipWaitsForTheBacklog)
+    {
+        FakeAudioDevice device;
+        AudioStats      stats;
+        AudioPlayQueue  queue = MakeQueue(device, stats);
+
+        ASSERT_TRUE(queue.Submit(Clip(960U), 0U));
+        ASSERT_TRUE(queue.Submit(Clip(480U), 0U));
+        EXPECT_EQ(2U, stats.Snapshot().max_queue_depth);
+
+        ASSERT_TRUE(queue.PlayNext(std::chrono::milliseconds(0)));
+        ASSERT_TRUE(queue.PlayNext(std::chrono::milliseconds(0)));
+
+        // 20 ms of the first clip still to play, then 10 ms of device pipeline.
+        EXPECT_EQ(30000U, stats.Snapshot().trigger_to_sound_us.last_us);
+        EXPECT_EQ(0U, stats.Snapshot().queue_depth);
+    }
+
+    TEST(AudioPlayQueueTest, SlowWritesInsideAClipCountAsUnderruns)
+    {
+        FakeAudioDevice device;
+        device.write_cost_us = 15000U;  // 10 ms of audio takes 15 ms to hand over
+        AudioStats     stats;
+        AudioPlayQueue queue = MakeQueue(device, stats);
+
+        ASSERT_TRUE(queue.Submit(Clip(480U * 4U), 0U));
+        ASSERT_TRUE(queue.PlayNext(std::chrono::milliseconds(0)));
+
+        const auto snapshot = stats.Snapshot();
+        EXPECT_EQ(3U, snapshot.underruns);
+        EXPECT_EQ(15000U, snapshot.write_us.max_us);
+    }
+
+    TEST(AudioPlayQueueTest, FullQueueDropsInsteadOfAddingLag)
+    {
+        FakeAudioDevice device;
+        AudioStats      stats;
+        AudioPlayQueue  queue = MakeQueue(device, stats, 2U);
+
+        EXPECT_TRUE(queue.Submit(Clip(10U), 0U));
+        EXPECT_TRUE(queue.Submit(Clip(10U), 0U));
+        EXPECT_FALSE(queue.Submit(Clip(10U), 0U));
+
+        EXPECT_EQ(1U, stats.Snapshot().dropped_clips);
+        EXPECT_EQ(2U, queue.Depth());
+        EXPECT_TRUE(queue.PlayNext(std::chrono::milliseconds(0)));
+    }
+
+    TEST(AudioPlayQueueTest, EmptyQueueTimesOut)
+    {
+        FakeAudioDevice device;
+        AudioStats      stats;
+        AudioPlayQueue  queue = MakeQueue(device, stats);
+        EXPECT_FALSE(queue.PlayNext(std::chrono::milliseconds(1)));
+    }
+
+    TEST(AudioPlayQueueTest, PrepareRunsAtTheQueueSampleRate)
+    {
+        AudioStats             stats;
+        std::uint32_t          prepared_rate = 0U;
+        AudioPlayQueue::Config config;
+        config.sample_rate = 44100U;
+        config.prepare     = [&prepared_rate](std::uint32_t rate) { prepared_rate = rate; };
+        AudioPlayQueue queue([](const std::int16_t*, std::size_t) {}, config, stats);
+
+        const std::vector<std::int16_t> clip = Clip(10U);
+        queue.PlayNow(clip.data(), clip.size(), queue.Now());
+        EXPECT_EQ(44100U, prepared_rate);
+    }
+
+    TEST(AudioPlayQueueTest, StatsRenderAsJson)
+    {
+        AudioStats stats;
+        stats.RecordUnderrun(2U);
+        stats.TriggerToSound().Record(8000U);
+
+        char buf[256];
+        ASSERT_GT(custom::platform::FormatAudioStatsJson(stats.Snapshot(), buf, sizeof(buf)), 0);
+        const std::string json(buf);
+        EXPECT_NE(std::string::npos, json.find("\"underruns\":2"));
+        EXPECT_NE(std::string::npos, json.find("\"trigger_to_sound_us\":{\"last\":8000"));
+
+        char tiny[8];
+        EXPECT_EQ(-1, custom::platform::FormatAudioStatsJson(stats.Snapshot(), tiny, sizeof(tiny)));
+    }
+
+}  // namespace
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "platform/audio/audio_resampler.h"
+
+namespace
+{
+
+    using custom::platform::LinearResampler;
+
+    /** Stereo ramp, the right channel mirrored, so interpolation errors show as steps. */
+    std::vector<std::int16_t> Ramp(std::size_t frames)
+    {
+        std::vector<std::int16_t> samples;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            samples.push_back(static_cast<std::int16_t>(i * 4U));
+            samples.push_back(static_cast<std::int16_t>(-static_cast<int>(i * 4U)));
+        }
+        return samples;
+    }
+
+    TEST(LinearResamplerTest, SameRatePassesThrough)
+    {
+        const std::vector<std::int16_t> in = Ramp(100U);
+        LinearResampler                 resampler;
+        resampler.SetRates(48000U, 48000U);
+
+        std::vector<std::int16_t> out;
+        resampler.Process(in.data(), 100U, out);
+        EXPECT_EQ(in, out);
+    }
+
+    TEST(LinearResamplerTest, PeriodsResampleLikeOneBlock)
+    {
+        // A clip fed one 480-frame period at a time, as the play queue writes it
+        const std::vector<std::int16_t> in = Ramp(4800U);
+        LinearResampler                 whole;
+        whole.SetRates(48000U, 44100U);
+        std::vector<std::int16_t> expected;
+        whole.Process(in.data(), 4800U, expected);
+
+        LinearResampler split;
+        split.SetRates(48000U, 44100U);
+        std::vector<std::int16_t> out;
+        for (std::size_t offset = 0; offset < 4800U; offset += 480U)
+        {
+            split.Process(in.data() + offset * 2U, 480U, out);
+        }
+
+        EXPECT_EQ(expected, out);
+        EXPECT_EQ(4410U, out.size() / 2U);
+        for (std::size_t i = 1; i < out.size() / 2U; ++i)
+        {
+            // 48/44.1 input frames per output frame, 4 per input frame on the ramp
+            EXPECT_NEAR(4.35, out[i * 2U] - out[(i - 1U) * 2U], 1.0) << i;
+            EXPECT_EQ(-out[i * 2U], out[i * 2U + 1U]) << i;
+        }
+    }
+
+    TEST(LinearResamplerTest, SingleFramesDownsample)
+    {
+        // Downsampling one frame at a time: most calls produce nothing, none produce junk
+        const std::vector<std::int16_t> in = Ramp(30U);
+        LinearResampler                 resampler;
+        resampler.SetRates(48000U, 16000U);
+        std::vector<std::int16_t> out;
+        for (std::size_t i = 0; i < 30U; ++i)
+        {
+            resampler.Process(in.data() + i * 2U, 1U, out);
+        }
+        ASSERT_EQ(10U, out.size() / 2U);
+        for (std::size_t i = 0; i < 10U; ++i)
+        {
+            EXPECT_EQ(static_cast<std::int16_t>(i * 12U), out[i * 2U]) << i;
+        }
+    }
+
+    TEST(LinearResamplerTest, RateChangeStartsOver)
+    {
+        const std::vector<std::int16_t> in = Ramp(10U);
+        LinearResampler                 resampler;
+        resampler.SetRates(48000U, 16000U);
+        std::vector<std::int16_t> out;
+        resampler.Process(in.data(), 10U, out);
+        EXPECT_EQ(3U, out.size() / 2U);  // frames 0, 3 and 6; 9 waits for the next call
+
+        resampler.SetRates(16000U, 48000U);
+        out.clear();
+        resampler.Process(in.data(), 2U, out);
+        ASSERT_EQ(3U, out.size() / 2U);
+        EXPECT_EQ(0, out[0]);  // no carry-over from the first rate
+    }
+
+}  // namespace
@@ -0,0 +1,315 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "platform/audio/audio_mixer.h"
+#include "platform/audio/audio_stream.h"
+
+namespace
+{
+
+    using custom::platform::AudioMixer;
+    using custom::platform::AudioSource;
+    using custom::platform::AudioStats;
+    using custom::platform::AudioStream;
+    using custom::platform::MemoryAudioSource;
+    using custom::platform::WavDecoder;
+
+    void AppendLe16(std::vector<std::uint8_t>& out, std::uint16_t v)
+    {
+        out.push_back(static_cast<std::uint8_t>(v & 0xFFU));
+        out.push_back(static_cast<std::uint8_t>(v >> 8));
+    }
+
+    void AppendLe32(std::vector<std::uint8_t>& out, std::uint32_t v)
+    {
+        AppendLe16(out, static_cast<std::uint16_t>(v & 0xFFFFU));
+        AppendLe16(out, static_cast<std::uint16_t>(v >> 16));
+    }
+
+    void AppendTag(std::vector<std::uint8_t>& out, const char* tag)
+    {
+        out.insert(out.end(), tag, tag + 4);
+    }
+
+    std::vector<std::uint8_t> MakeWav(std::uint16_t                     channels,
+                                      std::uint16_t                     bits,
+                                      const std::vector<std::uint8_t>& payload,
+                                      bool                              with_list_chunk = false)
+    {
+        std::vector<std::uint8_t> wav;
+        AppendTag(wav, "RIFF");
+        AppendLe32(wav, 0U);
+        AppendTag(wav, "WAVE");
+
+        if (with_list_chunk)
+        {
+            AppendTag(wav, "LIST");
+            AppendLe32(wav, 5U);
+            wav.insert(wav.end(), {'I', 'N', 'F', 'O', 'x', 0});  // odd size + pad byte
+        }
+
+        AppendTag(wav, "fmt ");
+        AppendLe32(wav, 16U);
+        AppendLe16(wav, 1U);
+        AppendLe16(wav, channels);
+        AppendLe32(wav, 48000U);
+        AppendLe32(wav, 48000U * channels * bits / 8U);
+        AppendLe16(wav, static_cast<std::uint16_t>(channels * bits / 8U));
+        AppendLe16(wav, bits);
+
+        AppendTag(wav, "data");
+        AppendLe32(wav, static_cast<std::uint32_t>(payload.size()));
+        wav.insert(wav.end(), payload.begin(), payload.end());
+        return wav;
+    }
+
+    std::vector<std::uint8_t> RampPayload16(std::size_t samples)
+    {
+        std::vector<std::uint8_t> payload;
+        for (std::size_t i = 0; i < samples; ++i)
+        {
+            AppendLe16(payload, static_cast<std::uint16_t>(static_cast<std::int16_t>(i * 3 - 500)));
+        }
+        return payload;
+    }
+
+    /** Hands out at most a few bytes per read, like a congested socket. */
+    class TricklingSource : public AudioSource
+    {
+    public:
+        TricklingSource(const std::vector<std::uint8_t>& data, std::size_t step) :
+            inner_(data.data(), data.size()), step_(step)
+        {
+        }
+
+        std::size_t Read(std::uint8_t* dst, std::size_t len) override
+        {
+            return inner_.Read(dst, std::min(len, step_));
+        }
+        bool AtEnd() const override
+        {
+            return inner_.AtEnd();
+        }
+        std::size_t Tell() const override
+        {
+            return inner_.Tell();
+        }
+
+    private:
+        MemoryAudioSource inner_;
+        std::size_t       step_;
+    };
+
+    AudioStream::Config SmallStreamConfig()
+    {
+        AudioStream::Config config;
+        config.chunk_frames    = 64U;
+        config.prefetch_frames = 256U;
+        config.capacity_frames = 512U;
+        return config;
+    }
+
+    TEST(AudioStreamTest, WavDecoderSkipsUnknownChunksAndDecodes16Bit)
+    {
+        const auto wav = MakeWav(2U, 16U, RampPayload16(200U), true);
+        MemoryAudioSource source(wav.data(), wav.size());
+        WavDecoder        decoder;
+        ASSERT_TRUE(decoder.Open(source));
+        EXPECT_EQ(48000U, decoder.Format().sample_rate);
+        EXPECT_EQ(2U, decoder.Format().channels);
+
+        std::vector<std::int16_t> pcm(400U);
+        std::size_t               frames = 0U;
+        while (!decoder.AtEnd())
+        {
+            frames += decoder.Decode(pcm.data() + frames * 2U, 16U);
+        }
+        ASSERT_EQ(100U, frames);
+        for (std::size_t i = 0; i < 200U; ++i)
+        {
+            EXPECT_EQ(static_cast<std::int16_t>(i * 3 - 500), pcm[i]);
+        }
+    }
+
+    TEST(AudioStreamTest, WavDecoderReassemblesFramesSplitAcrossReads)
+    {
+        const auto      wav = MakeWav(2U, 16U, RampPayload16(64U));
+        TricklingSource source(wav, 3U);
+        WavDecoder      decoder;
+        ASSERT_TRUE(decoder.Open(source));
+
+        std::vector<std::int16_t> pcm(64U);
+        std::size_t               frames = 0U;
+        for (int guard = 0; guard < 1000 && !decoder.AtEnd(); ++guard)
+        {
+            frames += decoder.Decode(pcm.data() + frames * 2U, 8U);
+        }
+        ASSERT_EQ(32U, frames);
+        EXPECT_EQ(static_cast<std::int16_t>(63 * 3 - 500), pcm[63]);
+    }
+
+    TEST(AudioStreamTest, WavDecoderRejectsCompressedFormats)
+    {
+        auto wav = MakeWav(1U, 16U, RampPayload16(4U));
+        wav[20]  = 0x55U;  // MPEG layer 3 format tag
+        MemoryAudioSource source(wav.data(), wav.size());
+        WavDecoder        decoder;
+        EXPECT_FALSE(decoder.Open(source));
+    }
+
+    TEST(AudioStreamTest, MonoEightBitIsWidenedToStereo)
+    {
+        const std::vector<std::uint8_t> payload = {128U, 255U, 0U, 192U};
+        const auto                      wav     = MakeWav(1U, 8U, payload);
+        AudioStream stream(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                           std::make_unique<WavDecoder>(),
+                           SmallStreamConfig());
+        ASSERT_TRUE(stream.Open());
+        while (stream.Pump() != AudioStream::PumpResult::kEnd)
+        {
+        }
+
+        std::int16_t out[8] = {};
+        EXPECT_EQ(4U, stream.Read(out, 4U));
+        const std::int16_t expected[8] = {0, 0, 127 * 256, 127 * 256, -32768, -32768, 64 * 256, 64 * 256};
+        EXPECT_EQ(0, std::memcmp(expected, out, sizeof(out)));
+        EXPECT_TRUE(stream.Finished());
+    }
+
+    TEST(AudioStreamTest, PrefetchGatesPlaybackWithoutCountingUnderruns)
+    {
+        const auto  wav = MakeWav(2U, 16U, RampPayload16(4096U));
+        AudioStream stream(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                           std::make_unique<WavDecoder>(),
+                           SmallStreamConfig());
+        ASSERT_TRUE(stream.Open());
+
+        std::vector<std::int16_t> period(128U * 2U);
+        EXPECT_EQ(0U, stream.Read(period.data(), 128U));
+        EXPECT_EQ(0U, stream.Stats().underruns);
+
+        // A decode thread that keeps up: pump whenever there is room, then play a period.
+        std::size_t played = 0U;
+        while (!stream.Finished())
+        {
+            while (stream.Pump() == AudioStream::PumpResult::kDecoded)
+            {
+            }
+            played += stream.Read(period.data(), 128U);
+        }
+
+        const auto stats = stream.Stats();
+        EXPECT_EQ(2048U, played);
+        EXPECT_EQ(2048U, stats.decoded_frames);
+        EXPECT_EQ(0U, stats.underruns);
+        EXPECT_LE(stats.max_buffered, 512U);
+    }
+
+    TEST(AudioStreamTest, StarvedSinkCountsUnderrunsAndRebuffers)
+    {
+        const auto  wav = MakeWav(2U, 16U, RampPayload16(4096U));
+        AudioStream stream(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                           std::make_unique<WavDecoder>(),
+                           SmallStreamConfig());
+        ASSERT_TRUE(stream.Open());
+
+        for (int i = 0; i < 4; ++i)
+        {
+            stream.Pump();
+        }
+
+        std::vector<std::int16_t> period(300U * 2U);
+        EXPECT_EQ(256U, stream.Read(period.data(), 300U));
+        EXPECT_EQ(1U, stream.Stats().underruns);
+        EXPECT_EQ(44U, stream.Stats().underrun_frames);
+
+        // Back in prefetch: silence is expected and not another underrun.
+        stream.Pump();
+        EXPECT_EQ(0U, stream.Read(period.data(), 32U));
+        EXPECT_EQ(1U, stream.Stats().underruns);
+    }
+
+    TEST(AudioStreamTest, UnderrunsReachAudioStatsWhileTheStreamPlays)
+    {
+        const auto  wav = MakeWav(2U, 16U, RampPayload16(4096U));
+        AudioStream stream(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                           std::make_unique<WavDecoder>(),
+                           SmallStreamConfig());
+        ASSERT_TRUE(stream.Open());
+        AudioStats stats;
+        stream.ReportUnderrunsTo(&stats);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            stream.Pump();
+        }
+        std::vector<std::int16_t> period(300U * 2U);
+        stream.Read(period.data(), 300U);
+
+        // Counted during the stall, long before the stream ends
+        EXPECT_FALSE(stream.Finished());
+        EXPECT_EQ(1U, stats.Snapshot().underruns);
+    }
+
+    TEST(AudioStreamTest, RecommendedPrefetchCoversStallPlusOneChunk)
+    {
+        EXPECT_EQ(5U * 1024U, custom::platform::RecommendedPrefetchFrames(48000U, 80U, 1024U));
+        EXPECT_EQ(1024U, custom::platform::RecommendedPrefetchFrames(48000U, 0U, 1024U));
+    }
+
+    TEST(AudioStreamTest, SourceCanBeReadThroughStdio)
+    {
+        const std::vector<std::uint8_t> blob = {'I', 'D', '3', 1, 2, 3, 4, 5};
+        FILE*                           file = custom::platform::OpenAudioSourceAsFile(
+            std::make_unique<MemoryAudioSource>(blob.data(), blob.size()));
+        ASSERT_NE(nullptr, file);
+
+        char head[3] = {};
+        ASSERT_EQ(3U, std::fread(head, 1U, 3U, file));
+        EXPECT_EQ(0, std::memcmp("ID3", head, 3));
+        ASSERT_EQ(0, std::fseek(file, 0, SEEK_SET));
+        std::uint8_t all[8] = {};
+        EXPECT_EQ(8U, std::fread(all, 1U, sizeof(all), file));
+        EXPECT_EQ(5U, all[7]);
+        EXPECT_EQ(0, std::fclose(file));
+    }
+
+    TEST(AudioStreamTest, MixerSumsVoicesAndSaturates)
+    {
+        std::vector<std::uint8_t> payload;
+        for (int i = 0; i < 8; ++i)
+        {
+            AppendLe16(payload, 30000U);
+        }
+        const auto wav = MakeWav(2U, 16U, payload);
+
+        AudioStream a(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                      std::make_unique<WavDecoder>(),
+                      SmallStreamConfig());
+        AudioStream b(std::make_unique<MemoryAudioSource>(wav.data(), wav.size()),
+                      std::make_unique<WavDecoder>(),
+                      SmallStreamConfig());
+        ASSERT_TRUE(a.Open());
+        ASSERT_TRUE(b.Open());
+        a.Pump();
+        b.Pump();
+
+        AudioMixer mixer;
+        ASSERT_TRUE(mixer.AddVoice(&a));
+        ASSERT_TRUE(mixer.AddVoice(&b, 50U));
+        EXPECT_EQ(2U, mixer.ActiveVoices());
+
+        std::int16_t out[12] = {};
+        EXPECT_EQ(4U, mixer.Mix(out, 6U));
+        EXPECT_EQ(32767, out[0]);
+        EXPECT_EQ(0, out[8]);
+    }
+
+}  // namespace
@@ -0,0 +1,199 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "platform/camera/camera_preview.h"
+#include "platform/camera/synthetic_frame_source.h"
+#include "platform/triple_buffer.h"
+
+namespace
+{
+
+    using custom::platform::CameraPreview;
+    using custom::platform::FitInside;
+    using custom::platform::FitRect;
+    using custom::platform::FramePacer;
+    using custom::platform::FrameTarget;
+    using custom::platform::FrameView;
+    using custom::platform::TripleBuffer;
+
+    struct Canvas
+    {
+        Canvas(std::uint32_t w, std::uint32_t h) : pixels(static_cast<std::size_t>(w) * h, 0U)
+        {
+            target.pixels    = pixels.data();
+            target.width     = w;
+            target.height    = h;
+            target.stride_px = w;
+        }
+
+        std::vector<std::uint16_t> pixels;
+        FrameTarget                target;
+    };
+
+    FrameView ViewOf(const std::vector<std::uint16_t>& pixels, std::uint32_t w, std::uint32_t h)
+    {
+        FrameView view;
+        view.pixels    = pixels.data();
+        view.width     = w;
+        view.height    = h;
+        view.stride_px = w;
+        return view;
+    }
+
+    TEST(CameraPreviewTest, FitInsideLetterboxesAndPillarboxes)
+    {
+        const FitRect wide = FitInside(1280U, 720U, 640U, 480U);
+        EXPECT_EQ(0U, wide.x);
+        EXPECT_EQ(60U, wide.y);
+        EXPECT_EQ(640U, wide.width);
+        EXPECT_EQ(360U, wide.height);
+
+        const FitRect tall = FitInside(720U, 1280U, 1280U, 720U);
+        EXPECT_EQ(405U, tall.width);
+        EXPECT_EQ(720U, tall.height);
+        EXPECT_EQ((1280U - 405U) / 2U, tall.x);
+    }
+
+    TEST(CameraPreviewTest, SoftwareScaleHalvesAndKeepsBordersUntouched)
+    {
+        // 4x2 source with a distinct value per pixel, scaled into the middle of a 4x3 canvas.
+        const std::vector<std::uint16_t> src = {1, 2, 3, 4, 5, 6, 7, 8};
+        Canvas                           canvas(4U, 3U);
+        canvas.pixels.assign(canvas.pixels.size(), 0xAAAAU);
+        canvas.target.pixels = canvas.pixels.data();
+
+        FitRect rect;
+        rect.x      = 1U;
+        rect.y      = 1U;
+        rect.width  = 2U;
+        rect.height = 1U;
+        custom::platform::ScaleRgb565Nearest(ViewOf(src, 4U, 2U), canvas.target, rect);
+
+        // Centre sampling picks source columns 1 and 3 of row 1.
+        EXPECT_EQ(6U, canvas.pixels[1U * 4U + 1U]);
+        EXPECT_EQ(8U, canvas.pixels[1U * 4U + 2U]);
+        EXPECT_EQ(0xAAAAU, canvas.pixels[0]);
+        EXPECT_EQ(0xAAAAU, canvas.pixels[1U * 4U + 3U]);
+        EXPECT_EQ(0xAAAAU, canvas.pixels[2U * 4U + 1U]);
+    }
+
+    TEST(CameraPreviewTest, PacerDropsEarlyFramesButToleratesJitter)
+    {
+        FramePacer pacer(30U);  // 33.3 ms
+        EXPECT_TRUE(pacer.Admit(1000000U));
+        EXPECT_FALSE(pacer.Admit(1016000U));  // 60 fps sensor: every other frame goes
+        EXPECT_TRUE(pacer.Admit(1031000U));   // a couple of ms early is still on cadence
+        EXPECT_TRUE(pacer.Admit(1066000U));
+        EXPECT_TRUE(pacer.Admit(2000000U));  // after a stall the cadence restarts
+        EXPECT_FALSE(pacer.Admit(2010000U));
+    }
+
+    TEST(CameraPreviewTest, SyntheticFramesAreLetterboxedIntoTheSurface)
+    {
+        custom::platform::SyntheticFrameSource source(64U, 36U);
+        Canvas                                 canvas(32U, 24U);
+        custom::platform::CapturedFrame        frame;
+        ASSERT_TRUE(source.Dequeue(frame));
+        ASSERT_TRUE(custom::platform::SoftwareBlit(frame.view, canvas.target));
+
+        // 16:9 into 4:3 leaves three blank rows top and bottom.
+        EXPECT_EQ(0U, canvas.pixels[1U * 32U + 16U]);
+        EXPECT_EQ(0xF800U, canvas.pixels[12U * 32U + 20U]);  // red bar, right of the marker
+        EXPECT_EQ(0U, canvas.pixels[22U * 32U + 16U]);
+        EXPECT_EQ(1U, source.FrameIndex());
+    }
+
+    TEST(CameraPreviewTest, TripleBufferHandsOverTheNewestSlot)
+    {
+        TripleBuffer<int> buffer(0, 1, 2);
+        EXPECT_EQ(1, buffer.Front());
+        EXPECT_FALSE(buffer.Acquire());
+
+        buffer.Back() = 10;
+        EXPECT_FALSE(buffer.Publish());
+        buffer.Back() = 20;
+        EXPECT_TRUE(buffer.Publish());  // 10 was never seen
+
+        ASSERT_TRUE(buffer.Acquire());
+        EXPECT_EQ(20, buffer.Front());
+        EXPECT_FALSE(buffer.Acquire());
+        EXPECT_EQ(20, buffer.Front());
+    }
+
+    TEST(CameraPreviewTest, TripleBufferNeverHandsTheFrontToTheProducer)
+    {
+        TripleBuffer<int> buffer(0, 0, 0);
+        for (int i = 1; i < 50; ++i)
+        {
+            buffer.Back() = i;
+            buffer.Publish();
+            if (i % 3 == 0)
+            {
+                ASSERT_TRUE(buffer.Acquire());
+                EXPECT_EQ(i, buffer.Front());
+            }
+            EXPECT_NE(&buffer.Back(), &buffer.Front());
+        }
+    }
+
+    TEST(CameraPreviewTest, UiAlwaysGetsTheFreshestFrame)
+    {
+        Canvas                c0(8U, 4U), c1(8U, 4U), c2(8U, 4U);
+        CameraPreview::Config config;
+        config.max_fps = 0U;  // unpaced
+        CameraPreview preview({c0.target, c1.target, c2.target},
+                              [](const FrameView& src, const FrameTarget& dst) {
+                                  dst.pixels[0] = src.pixels[0];
+                                  return true;
+                              },
+                              config);
+
+        std::vector<std::uint16_t> frame(8U * 4U);
+        for (std::uint16_t value = 1U; value <= 3U; ++value)
+        {
+            frame[0] = value;
+            EXPECT_TRUE(preview.Offer(ViewOf(frame, 8U, 4U), value));
+        }
+        ASSERT_TRUE(preview.AcquireLatest());
+        EXPECT_EQ(3U, preview.Front().pixels[0]);
+        EXPECT_FALSE(preview.AcquireLatest());
+
+        const auto stats = preview.Stats();
+        EXPECT_EQ(3U, stats.captured);
+        EXPECT_EQ(1U, stats.displayed);
+        EXPECT_EQ(2U, stats.dropped_stale);
+    }
+
+    TEST(CameraPreviewTest, FailedBlitIsNotPublishedAndCloseStopsWrites)
+    {
+        Canvas                           c0(4U, 4U), c1(4U, 4U), c2(4U, 4U);
+        const std::vector<std::uint16_t> src(16U, 1U);
+        bool                             fail = true;
+        CameraPreview                    preview(
+            {c0.target, c1.target, c2.target},
+            [&fail](const FrameView& frame, const FrameTarget& dst) {
+                return !fail && custom::platform::SoftwareBlit(frame, dst);
+            },
+            CameraPreview::Config());
+
+        EXPECT_FALSE(preview.Offer(ViewOf(src, 4U, 4U), 0U));
+        EXPECT_EQ(1U, preview.Stats().blit_failures);
+        EXPECT_FALSE(preview.AcquireLatest());
+
+        fail = false;
+        EXPECT_TRUE(preview.Offer(ViewOf(src, 4U, 4U), 100000U));
+        ASSERT_TRUE(preview.AcquireLatest());
+        EXPECT_EQ(1U, preview.Front().pixels[5]);
+
+        preview.Close();
+        EXPECT_FALSE(preview.Offer(ViewOf(src, 4U, 4U), 200000U));
+        EXPECT_EQ(2U, preview.Stats().captured);
+    }
+
+}  // namespace
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "diag/diag_metrics.h"
+
+namespace
+{
+
+    // The registry is process-wide and never forgets a metric, so the tests share these
+    DIAG_METRIC_COUNTER_DEFINE(g_test_frames, "test_frames_total", "Frames rendered");
+    DIAG_METRIC_GAUGE_DEFINE(g_test_queue_depth, "test_queue_depth", "Events waiting");
+    DIAG_METRIC_HISTOGRAM_DEFINE(
+        g_test_frame_us, "test_frame_us", "Frame time", 1000U, 4000U, 16000U);
+    DIAG_METRIC_COUNTER_DEFINE(g_test_contended, "test_contended_total", "Concurrent adds");
+
+    int g_test_collector_runs = 0;
+
+    void TestTaskCollector(diag_metrics_writer_t* out, void* user_data)
+    {
+        (void)user_data;
+        g_test_collector_runs++;
+        diag_metric_set(&g_test_queue_depth, 7);
+        diag_metrics_write_sample(out, "test_stack_free_bytes", "Stack left", "task", "lvgl", 1200);
+        diag_metrics_write_sample(out, "test_stack_free_bytes", "Stack left", "task", "a\"b", 64);
+        diag_metrics_write_sample(out, "test_heap_free_bytes", "Heap", nullptr, nullptr, 4096);
+    }
+
+    void RegisterTestMetrics()
+    {
+        static bool registered = false;
+        if (!registered)
+        {
+            ASSERT_EQ(ESP_OK, diag_metric_register(&g_test_frames));
+            ASSERT_EQ(ESP_OK, diag_metric_register(&g_test_queue_depth));
+            ASSERT_EQ(ESP_OK, diag_metric_register(&g_test_frame_us));
+            ASSERT_EQ(ESP_OK, diag_metric_register(&g_test_frames));  // no-op the second time
+            ASSERT_EQ(ESP_OK, diag_metrics_register_collector(TestTaskCollector, nullptr));
+            registered = true;
+        }
+    }
+
+    bool AppendToString(const char* data, size_t len, void* user_data)
+    {
+        static_cast<std::string*>(user_data)->append(data, len);
+        return true;
+    }
+
+    std::string Export(diag_metrics_format_t format)
+    {
+        std::string text;
+        EXPECT_EQ(ESP_OK, diag_metrics_export(format, AppendToString, &text));
+        return text;
+    }
+
+    bool Contains(const std::string& text, const char* needle)
+    {
+        return text.find(needle) != std::string::npos;
+    }
+
+    TEST(DiagMetricsTest, ExportsPrometheusText)
+    {
+        RegisterTestMetrics();
+        const std::uint32_t frames = g_test_frames.counter;
+        diag_metric_add(&g_test_frames, 3U);
+        for (std::uint32_t us : {500U, 1000U, 1001U, 20000U})
+        {
+            diag_metric_observe(&g_test_frame_us, us);
+        }
+
+        const std::string text = Export(DIAG_METRICS_PROMETHEUS);
+        EXPECT_TRUE(Contains(text, "# TYPE test_frames_total counter\n"));
+        EXPECT_TRUE(
+            Contains(text, ("test_frames_total " + std::to_string(frames + 3U) + "\n").c_str()));
+        EXPECT_TRUE(Contains(text, "# TYPE test_queue_depth gauge\ntest_queue_depth 7\n"));
+
+        // le is inclusive and buckets are cumulative
+        EXPECT_TRUE(Contains(text, "# TYPE test_frame_us histogram\n"));
+        EXPECT_TRUE(Contains(text, "test_frame_us_bucket{le=\"1000\"} 2\n"));
+        EXPECT_TRUE(Contains(text, "test_frame_us_bucket{le=\"4000\"} 3\n"));
+        EXPECT_TRUE(Contains(text, "test_frame_us_bucket{le=\"16000\"} 3\n"));
+        EXPECT_TRUE(Contains(text, "test_frame_us_bucket{le=\"+Inf\"} 4\n"));
+        EXPECT_TRUE(Contains(text, "test_frame_us_sum 22501\ntest_frame_us_count 4\n"));
+
+        // One header per labelled family, label values escaped
+        EXPECT_TRUE(Contains(text,
+                             "# HELP test_stack_free_bytes Stack left\n"
+                             "# TYPE test_stack_free_bytes gauge\n"
+                             "test_stack_free_bytes{task=\"lvgl\"} 1200\n"
+                             "test_stack_free_bytes{task=\"a\\\"b\"} 64\n"));
+        EXPECT_TRUE(Contains(text, "test_heap_free_bytes 4096\n"));
+    }
+
+    TEST(DiagMetricsTest, ExportsJsonTelemetry)
+    {
+        RegisterTestMetrics();
+        const int runs = g_test_collector_runs;
+
+        const std::string json = Export(DIAG_METRICS_JSON);
+        EXPECT_EQ(runs + 1, g_test_collector_runs);
+        ASSERT_FALSE(json.empty());
+        EXPECT_EQ('{', json.front());
+        EXPECT_EQ('}', json.back());
+        EXPECT_TRUE(Contains(json, "\"test_stack_free_bytes\":{\"lvgl\":1200,\"a\\\"b\":64}"));
+        EXPECT_TRUE(Contains(json, ",\"test_heap_free_bytes\":4096"));
+        EXPECT_TRUE(Contains(json, "\"test_queue_depth\":7"));
+        EXPECT_TRUE(Contains(json, "\"test_frame_us\":{\"le\":[1000,4000,16000],\"counts\":["));
+        EXPECT_FALSE(Contains(json, ",,"));
+        EXPECT_FALSE(Contains(json, "{,"));
+    }
+
+    TEST(DiagMetricsTest, SinkCanAbortTheExport)
+    {
+        RegisterTestMetrics();
+        int  calls = 0;
+        auto stop  = [](const char*, size_t, void* user_data) {
+            (*static_cast<int*>(user_data))++;
+            return false;
+        };
+        EXPECT_EQ(ESP_FAIL, diag_metrics_export(DIAG_METRICS_PROMETHEUS, stop, &calls));
+        EXPECT_EQ(1, calls);
+    }
+
+    TEST(DiagMetricsTest, RejectsIncompleteMetrics)
+    {
+        diag_metric_t unnamed = {};
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, diag_metric_register(&unnamed));
+        diag_metric_t no_buckets = {};
+        no_buckets.name          = "test_broken";
+        no_buckets.type          = DIAG_METRIC_HISTOGRAM;
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, diag_metric_register(&no_buckets));
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, diag_metrics_export(DIAG_METRICS_JSON, nullptr, nullptr));
+    }
+
+    TEST(DiagMetricsTest, CountersAreSafeFromManyThreads)
+    {
+        ASSERT_EQ(ESP_OK, diag_metric_register(&g_test_contended));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([]() {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    diag_metric_add(&g_test_contended, 1U);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(40000U, g_test_contended.counter);
+    }
+
+}  // namespace
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "platform/event_bus.h"
+
+namespace
+{
+
+    enum class TestTopic : std::uint8_t
+    {
+        Brightness,
+        Volume,
+        Touch,
+    };
+
+    struct TestPayload
+    {
+        std::int32_t value = 0;
+    };
+
+    using TestBus = custom::platform::EventBus<TestTopic, TestPayload, 4U, 8U>;
+
+    struct Recorder
+    {
+        std::vector<TestTopic>    topics;
+        std::vector<std::int32_t> values;
+
+        static void Record(TestTopic topic, const TestPayload& payload, void* ctx)
+        {
+            auto* self = static_cast<Recorder*>(ctx);
+            self->topics.push_back(topic);
+            self->values.push_back(payload.value);
+        }
+    };
+
+    TestPayload Value(std::int32_t value)
+    {
+        TestPayload payload;
+        payload.value = value;
+        return payload;
+    }
+
+    TEST(EventBusTest, PublishReachesOnlyMatchingSubscribers)
+    {
+        TestBus  bus;
+        Recorder brightness;
+        Recorder everything;
+        ASSERT_NE(TestBus::kInvalidSubscription,
+                  bus.Subscribe(TestTopic::Brightness, Recorder::Record, &brightness));
+        ASSERT_NE(TestBus::kInvalidSubscription, bus.SubscribeAll(Recorder::Record, &everything));
+
+        bus.Publish(TestTopic::Brightness, Value(40));
+        bus.Publish(TestTopic::Volume, Value(70));
+
+        EXPECT_EQ((std::vector<std::int32_t>{40}), brightness.values);
+        EXPECT_EQ((std::vector<TestTopic>{TestTopic::Brightness, TestTopic::Volume}),
+                  everything.topics);
+        EXPECT_EQ(2U, bus.GetStats().published);
+    }
+
+    TEST(EventBusTest, SubscriberTableIsFixedAndSlotsAreReused)
+    {
+        TestBus  bus;
+        Recorder recorder;
+        int      ids[4];
+        for (int& id : ids)
+        {
+            id = bus.SubscribeAll(Recorder::Record, &recorder);
+            ASSERT_NE(TestBus::kInvalidSubscription, id);
+        }
+        EXPECT_EQ(TestBus::kInvalidSubscription, bus.SubscribeAll(Recorder::Record, &recorder));
+        EXPECT_EQ(TestBus::kInvalidSubscription, bus.SubscribeAll(nullptr));
+
+        bus.Unsubscribe(ids[2]);
+        EXPECT_EQ(3U, bus.SubscriberCount());
+        EXPECT_EQ(ids[2], bus.Subscribe(TestTopic::Touch, Recorder::Record, &recorder));
+    }
+
+    TEST(EventBusTest, PostedEventsWaitForDispatchAndKeepOrder)
+    {
+        TestBus  bus;
+        Recorder recorder;
+        bus.SubscribeAll(Recorder::Record, &recorder);
+
+        EXPECT_TRUE(bus.Post(TestTopic::Volume, Value(1)));
+        EXPECT_TRUE(bus.Post(TestTopic::Touch, Value(2)));
+        EXPECT_TRUE(bus.Post(TestTopic::Volume, Value(3)));
+        EXPECT_TRUE(recorder.values.empty());
+        EXPECT_EQ(3U, bus.Pending());
+
+        EXPECT_EQ(2U, bus.Dispatch(2U));
+        EXPECT_EQ((std::vector<std::int32_t>{1, 2}), recorder.values);
+        EXPECT_EQ(1U, bus.Dispatch());
+        EXPECT_EQ(0U, bus.Dispatch());
+        EXPECT_EQ((std::vector<std::int32_t>{1, 2, 3}), recorder.values);
+
+        const auto stats = bus.GetStats();
+        EXPECT_EQ(3U, stats.posted);
+        EXPECT_EQ(3U, stats.dispatched);
+        EXPECT_EQ(2U, stats.batches);
+        EXPECT_EQ(2U, stats.max_batch);
+    }
+
+    TEST(EventBusTest, FullQueueDropsNewestEvent)
+    {
+        TestBus  bus;
+        Recorder recorder;
+        bus.SubscribeAll(Recorder::Record, &recorder);
+
+        for (std::int32_t i = 0; i < 8; ++i)
+        {
+            ASSERT_TRUE(bus.Post(TestTopic::Touch, Value(i)));
+        }
+        EXPECT_FALSE(bus.Post(TestTopic::Touch, Value(99)));
+        EXPECT_EQ(8U, bus.Dispatch());
+        EXPECT_EQ(7, recorder.values.back());
+        EXPECT_EQ(1U, bus.GetStats().dropped);
+        EXPECT_EQ(8U, bus.GetStats().max_queued);
+
+        // The ring wraps cleanly once drained
+        EXPECT_TRUE(bus.Post(TestTopic::Touch, Value(100)));
+        EXPECT_EQ(1U, bus.Dispatch());
+        EXPECT_EQ(100, recorder.values.back());
+    }
+
+    TEST(EventBusTest, HandlerMayUnsubscribeDuringDelivery)
+    {
+        struct OneShot
+        {
+            TestBus* bus   = nullptr;
+            int      id    = TestBus::kInvalidSubscription;
+            int      calls = 0;
+
+            static void Handle(TestTopic, const TestPayload&, void* ctx)
+            {
+                auto* self = static_cast<OneShot*>(ctx);
+                self->calls++;
+                self->bus->Unsubscribe(self->id);
+            }
+        };
+
+        TestBus bus;
+        OneShot once;
+        once.bus = &bus;
+        once.id  = bus.SubscribeAll(OneShot::Handle, &once);
+
+        bus.Post(TestTopic::Touch, Value(1));
+        bus.Post(TestTopic::Touch, Value(2));
+        bus.Dispatch();
+        EXPECT_EQ(1, once.calls);
+        EXPECT_EQ(0U, bus.SubscriberCount());
+    }
+
+    TEST(EventBusTest, PostFromManyThreadsDeliversEveryEvent)
+    {
+        custom::platform::EventBus<TestTopic, TestPayload, 2U, 64U> bus;
+        std::int64_t                                                sum = 0;
+        bus.SubscribeAll(
+            [](TestTopic, const TestPayload& payload, void* ctx) {
+                *static_cast<std::int64_t*>(ctx) += payload.value;
+            },
+            &sum);
+
+        constexpr int            kThreads   = 4;
+        constexpr std::int32_t   kPerThread = 500;
+        std::vector<std::thread> producers;
+        std::int64_t             accepted[kThreads] = {};
+        for (int t = 0; t < kThreads; ++t)
+        {
+            producers.emplace_back([&bus, &accepted, t]() {
+                for (std::int32_t i = 1; i <= kPerThread; ++i)
+                {
+                    while (!bus.Post(TestTopic::Volume, Value(i)))
+                    {
+                        std::this_thread::yield();
+                    }
+                    accepted[t] += i;
+                }
+            });
+        }
+
+        std::int64_t expected = static_cast<std::int64_t>(kThreads) * kPerThread
+                                * (kPerThread + 1) / 2;
+        while (sum < expected)
+        {
+            if (bus.Dispatch() == 0U)
+            {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+        bus.Dispatch();
+
+        std::int64_t total_accepted = 0;
+        for (std::int64_t value : accepted)
+        {
+            total_accepted += value;
+        }
+        EXPECT_EQ(expected, total_accepted);
+        EXPECT_EQ(expected, sum);
+        EXPECT_LE(bus.GetStats().max_batch, 64U);
+    }
+
+}  // namespace
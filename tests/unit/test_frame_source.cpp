@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "platform/camera/frame_source.h"
+#include "platform/camera/raw_file_frame_source.h"
+#include "platform/camera/synthetic_frame_source.h"
+
+namespace
+{
+
+    using custom::platform::CameraPreview;
+    using custom::platform::CapturedFrame;
+    using custom::platform::CaptureResult;
+    using custom::platform::FrameTarget;
+    using custom::platform::RawFileFrameSource;
+    using custom::platform::RawPixelFormat;
+    using custom::platform::SyntheticFrameSource;
+
+    /** Writes @p bytes to a temporary file that is removed with the object. */
+    class TempRawFile
+    {
+    public:
+        explicit TempRawFile(const std::vector<std::uint8_t>& bytes)
+        {
+            static int counter = 0;
+
+            path_ = ::testing::TempDir() + "frame_source_" + std::to_string(counter++) + ".raw";
+            std::FILE* file = std::fopen(path_.c_str(), "wb");
+            std::fwrite(bytes.data(), 1U, bytes.size(), file);
+            std::fclose(file);
+        }
+        ~TempRawFile()
+        {
+            std::remove(path_.c_str());
+        }
+
+        const std::string& Path() const
+        {
+            return path_;
+        }
+
+    private:
+        std::string path_;
+    };
+
+    struct PreviewSurfaces
+    {
+        explicit PreviewSurfaces(std::uint32_t w, std::uint32_t h)
+        {
+            for (std::size_t i = 0; i < 3U; ++i)
+            {
+                storage[i].assign(static_cast<std::size_t>(w) * h, 0U);
+                targets[i].pixels    = storage[i].data();
+                targets[i].width     = w;
+                targets[i].height    = h;
+                targets[i].stride_px = w;
+            }
+        }
+
+        std::vector<std::uint16_t> storage[3];
+        CameraPreview::Surfaces    targets;
+    };
+
+    TEST(FrameSourceTest, DequeueFailsInsteadOfReusingHeldBuffers)
+    {
+        SyntheticFrameSource source(16U, 8U, 2U);
+        CapturedFrame        a, b, c;
+        ASSERT_TRUE(source.Dequeue(a));
+        ASSERT_TRUE(source.Dequeue(b));
+        EXPECT_NE(a.index, b.index);
+        EXPECT_FALSE(source.Dequeue(c));  // both buffers are out, like EAGAIN from DQBUF
+
+        source.Requeue(a);
+        source.Requeue(a);  // double requeue is ignored
+        EXPECT_EQ(1U, source.QueuedBuffers());
+        ASSERT_TRUE(source.Dequeue(c));
+        EXPECT_EQ(a.index, c.index);
+    }
+
+    TEST(FrameSourceTest, RawRgb565FileLoops)
+    {
+        // Two 2x1 frames: {1, 2} then {3, 4}, plus a partial third frame that is skipped.
+        TempRawFile        file({1, 0, 2, 0, 3, 0, 4, 0, 9});
+        RawFileFrameSource source(file.Path(), 2U, 1U, RawPixelFormat::kRgb565);
+        ASSERT_TRUE(source.IsOpen());
+
+        std::vector<std::uint16_t> seen;
+        for (int i = 0; i < 3; ++i)
+        {
+            CapturedFrame frame;
+            ASSERT_TRUE(source.Dequeue(frame));
+            seen.push_back(frame.view.pixels[0]);
+            source.Requeue(frame);
+        }
+        EXPECT_EQ((std::vector<std::uint16_t>{1U, 3U, 1U}), seen);
+    }
+
+    TEST(FrameSourceTest, RawYuyvFileIsConvertedToRgb565)
+    {
+        // Y=235 is full white and Y=16 full black with neutral chroma.
+        TempRawFile        file({235, 128, 16, 128});
+        RawFileFrameSource source(file.Path(), 2U, 1U, RawPixelFormat::kYuyv);
+        ASSERT_TRUE(source.IsOpen());
+
+        CapturedFrame frame;
+        ASSERT_TRUE(source.Dequeue(frame));
+        EXPECT_EQ(0xFFFFU, frame.view.pixels[0]);
+        EXPECT_EQ(0x0000U, frame.view.pixels[1]);
+    }
+
+    TEST(FrameSourceTest, ShortOrMissingFilesDoNotOpen)
+    {
+        TempRawFile        file({1, 2, 3});
+        RawFileFrameSource short_file(file.Path(), 2U, 1U, RawPixelFormat::kRgb565);
+        EXPECT_FALSE(short_file.IsOpen());
+        EXPECT_EQ(nullptr, custom::platform::OpenFrameSource("file:/nonexistent.rgb565", 4U, 4U, 0U));
+        EXPECT_EQ(nullptr, custom::platform::OpenFrameSource("bogus", 4U, 4U, 0U));
+        EXPECT_NE(nullptr, custom::platform::OpenFrameSource("pattern", 4U, 4U, 0U));
+    }
+
+    TEST(FrameSourceTest, PumpCaptureRequeuesEveryBuffer)
+    {
+        SyntheticFrameSource  source(64U, 36U, 2U);
+        PreviewSurfaces       surfaces(32U, 18U);
+        CameraPreview::Config config;
+        config.max_fps = 0U;
+        CameraPreview preview(surfaces.targets, nullptr, config);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_EQ(CaptureResult::kDisplayed, custom::platform::PumpCapture(source, preview));
+            EXPECT_EQ(2U, source.QueuedBuffers());
+        }
+        EXPECT_TRUE(preview.AcquireLatest());
+        EXPECT_EQ(9U, preview.Stats().dropped_stale);
+
+        preview.Close();
+        EXPECT_EQ(CaptureResult::kDropped, custom::platform::PumpCapture(source, preview));
+        EXPECT_EQ(2U, source.QueuedBuffers());
+    }
+
+}  // namespace
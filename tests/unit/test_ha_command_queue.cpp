@@ -0,0 +1,322 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "integration/ha_command_queue.h"
+#include "integration/ha_entity_store.h"
+#include "integration/ha_ws_client.h"
+#include "integration/ha_ws_stub_server.h"
+#include "integration/rooms_provider.h"
+
+namespace
+{
+
+    using custom::integration::HaCommand;
+    using custom::integration::HaCommandQueue;
+    using custom::integration::HaCommandSink;
+    using custom::integration::HaEntityState;
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::HaWsClient;
+    using custom::integration::HaWsStubServer;
+
+    constexpr const char* kCommandToken = "command-token";
+    constexpr int         kPlugCount    = 6;
+
+    std::vector<HaRoomLayout> CommandLayout()
+    {
+        HaRoomLayout kitchen;
+        kitchen.room_id  = "kitchen";
+        kitchen.name     = "Kitchen";
+        kitchen.entities = {"light.kitchen_main", "switch.kitchen_fan"};
+
+        HaRoomLayout office;
+        office.room_id = "office";
+        office.name    = "Office";
+        for (int i = 0; i < kPlugCount; ++i)
+        {
+            office.entities.push_back("switch.plug_" + std::to_string(i));
+        }
+        return {kitchen, office};
+    }
+
+    HaCommandQueue::Config CommandConfig()
+    {
+        HaCommandQueue::Config config;
+        config.debounce_ms = 300U;
+        config.burst       = 2U;
+        config.interval_ms = 100U;
+        config.timeout_ms  = 2000U;
+        return config;
+    }
+
+    /** Answers inside SendCommand(), as a reply racing the send on another task would. */
+    class ImmediateReplySink : public HaCommandSink
+    {
+    public:
+        ImmediateReplySink(HaCommandQueue& queue, bool success) : queue_(queue), success_(success)
+        {
+        }
+
+        std::uint32_t SendCommand(const HaCommand& command) override
+        {
+            sent_.emplace_back(command.entity_id);
+            const std::uint32_t id = next_id_++;
+            queue_.OnResult(id, success_);
+            return id;
+        }
+
+        const std::vector<std::string>& Sent() const
+        {
+            return sent_;
+        }
+
+    private:
+        HaCommandQueue&          queue_;
+        bool                     success_;
+        std::uint32_t            next_id_ = 1U;
+        std::vector<std::string> sent_;
+    };
+
+    class HaCommandQueueTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            rooms_provider_reset_state();
+            client.SetCommandResultCallback(
+                [this](std::uint32_t id, bool success) { queue.OnResult(id, success); });
+            queue.SetChangeCallback([this]() { changes++; });
+            server.Attach(&client);
+
+            server.SetState("light.kitchen_main", "on", 128);
+            server.SetState("switch.kitchen_fan", "off");
+            for (int i = 0; i < kPlugCount; ++i)
+            {
+                server.SetState("switch.plug_" + std::to_string(i), "off");
+            }
+            server.Connect();
+            DeliverAll();
+            ASSERT_EQ(HaWsClient::State::kLive, client.GetState());
+            queue.SetSink(&client, now);
+        }
+
+        void TearDown() override
+        {
+            rooms_provider_reset_state();
+        }
+
+        void DeliverAll()
+        {
+            while (server.Pump() > 0U)
+            {
+            }
+        }
+
+        /** Run the UI loop for @p ms in 10 ms frames, with replies arriving within a frame. */
+        void Run(std::uint32_t ms, bool deliver = true)
+        {
+            for (std::uint32_t t = 0U; t < ms; t += 10U)
+            {
+                now += 10U;
+                queue.Poll(now);
+                if (deliver)
+                {
+                    DeliverAll();
+                }
+            }
+        }
+
+        HaEntityState Shown(const char* entity_id) const
+        {
+            HaEntityState state;
+            EXPECT_TRUE(store.Peek(entity_id, state)) << entity_id;
+            return state;
+        }
+
+        HaEntityStore  store{CommandLayout()};
+        HaWsStubServer server{kCommandToken};
+        HaWsClient     client{server, store, kCommandToken};
+        HaCommandQueue queue{store, CommandConfig()};
+        std::uint32_t  now     = 1000U;
+        int            changes = 0;
+    };
+
+    TEST_F(HaCommandQueueTest, RapidTapsCoalesceIntoOneCommand)
+    {
+        // Five taps, 50 ms apart: the card flips on every tap, the server hears once
+        for (int tap = 0; tap < 5; ++tap)
+        {
+            ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+            EXPECT_EQ(tap % 2 == 0, Shown("switch.kitchen_fan").on);
+            Run(50U);
+        }
+        EXPECT_EQ(0U, server.ServiceCalls());
+        Run(500U);
+        EXPECT_EQ(1U, server.ServiceCalls());
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(0U, queue.Pending());
+
+        // An even number of taps ends where it started and sends nothing
+        for (int tap = 0; tap < 4; ++tap)
+        {
+            queue.Toggle("switch.kitchen_fan", now);
+            Run(50U);
+        }
+        Run(500U);
+        EXPECT_EQ(1U, server.ServiceCalls());
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+
+        const HaCommandQueue::Stats stats = queue.GetStats();
+        EXPECT_EQ(9U, stats.actions);
+        EXPECT_EQ(1U, stats.sent);
+        EXPECT_EQ(4U, stats.cancelled);  // every second tap was back where it started
+        EXPECT_EQ(0U, stats.failed);
+    }
+
+    TEST_F(HaCommandQueueTest, BrightnessDragSendsOnlyTheLatestValue)
+    {
+        // One second of dragging at 60 steps/s, with a 50 ms round trip to the server
+        std::int32_t last = 0;
+        for (int step = 0; step < 60; ++step)
+        {
+            last = 20 + step * 3;
+            ASSERT_TRUE(queue.SetBrightness("light.kitchen_main", last, now));
+            EXPECT_EQ(last, Shown("light.kitchen_main").brightness);
+            now += 16U;
+            queue.Poll(now);
+            if (step % 3 == 2)
+            {
+                DeliverAll();
+            }
+        }
+        Run(200U);
+
+        const HaCommandQueue::Stats stats = queue.GetStats();
+        EXPECT_EQ(60U, stats.actions);
+        EXPECT_LE(server.ServiceCalls(), 15U);  // one per round trip, not one per step
+        EXPECT_EQ(stats.sent, server.ServiceCalls());
+        EXPECT_EQ(0U, queue.Pending());
+        EXPECT_EQ(last, Shown("light.kitchen_main").brightness);
+        EXPECT_TRUE(Shown("light.kitchen_main").on);
+
+        // Dragging to 0 turns the light off
+        queue.SetBrightness("light.kitchen_main", 0, now);
+        Run(100U);
+        EXPECT_FALSE(Shown("light.kitchen_main").on);
+    }
+
+    TEST_F(HaCommandQueueTest, RejectedCommandRollsBack)
+    {
+        server.FailServiceCalls(true);
+        ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(1, changes);
+
+        Run(500U);
+        EXPECT_EQ(1U, server.ServiceCalls());
+        EXPECT_FALSE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(2, changes);
+        EXPECT_EQ(1U, queue.GetStats().failed);
+        EXPECT_EQ(1U, queue.GetStats().rolled_back);
+        EXPECT_EQ(0U, queue.Pending());
+    }
+
+    TEST_F(HaCommandQueueTest, CommandWithoutResultTimesOut)
+    {
+        ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+        Run(400U, false);
+        EXPECT_EQ(1U, server.ServiceCalls());
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+
+        Run(2000U, false);
+        EXPECT_FALSE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(1U, queue.GetStats().rolled_back);
+
+        // The late reply belongs to nothing any more; its state_changed is the truth
+        DeliverAll();
+        EXPECT_EQ(1U, queue.GetStats().failed);
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+    }
+
+    TEST_F(HaCommandQueueTest, ReplyBeforeTheSendReturnsIsKept)
+    {
+        // The sink runs without the queue lock, so a reply can land before Poll() records its id
+        ImmediateReplySink sink(queue, true);
+        queue.SetSink(&sink, now);
+        ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+        ASSERT_TRUE(queue.SetBrightness("light.kitchen_main", 200, now));
+
+        Run(400U, false);
+        EXPECT_EQ(2U, sink.Sent().size());
+        EXPECT_EQ(0U, queue.Pending());
+        EXPECT_EQ(2U, queue.GetStats().sent);
+        EXPECT_EQ(0U, queue.GetStats().failed);
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(200, Shown("light.kitchen_main").brightness);
+
+        // Nothing was left waiting for a result that already came
+        Run(3000U, false);
+        EXPECT_EQ(0U, queue.GetStats().rolled_back);
+        EXPECT_TRUE(Shown("switch.kitchen_fan").on);
+    }
+
+    TEST_F(HaCommandQueueTest, RejectionBeforeTheSendReturnsRollsBack)
+    {
+        ImmediateReplySink sink(queue, false);
+        queue.SetSink(&sink, now);
+        ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+
+        Run(400U, false);
+        EXPECT_EQ(1U, sink.Sent().size());
+        EXPECT_FALSE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(1U, queue.GetStats().failed);
+        EXPECT_EQ(1U, queue.GetStats().rolled_back);
+        EXPECT_EQ(0U, queue.Pending());
+    }
+
+    TEST_F(HaCommandQueueTest, RateLimitSpacesCommandsOut)
+    {
+        for (int i = 0; i < kPlugCount; ++i)
+        {
+            ASSERT_TRUE(queue.Toggle("switch.plug_" + std::to_string(i), now));
+        }
+        Run(300U);
+        EXPECT_EQ(2U, server.ServiceCalls());  // the burst
+        Run(100U);
+        EXPECT_EQ(3U, server.ServiceCalls());
+        Run(500U);
+        EXPECT_EQ(static_cast<std::uint32_t>(kPlugCount), server.ServiceCalls());
+        EXPECT_GT(queue.GetStats().throttled, 0U);
+        for (int i = 0; i < kPlugCount; ++i)
+        {
+            EXPECT_TRUE(Shown(("switch.plug_" + std::to_string(i)).c_str()).on);
+        }
+    }
+
+    TEST_F(HaCommandQueueTest, RefusesWhatCannotBeCommanded)
+    {
+        EXPECT_FALSE(queue.Toggle("switch.not_in_layout", now));
+
+        server.Disconnect();
+        queue.SetSink(nullptr, now);
+        EXPECT_FALSE(queue.Toggle("switch.kitchen_fan", now));
+
+        // Connected but not yet synced: the client refuses to send, so the tap rolls back
+        queue.SetSink(&client, now);
+        store.Apply("switch.kitchen_fan", "off", -1);
+        ASSERT_TRUE(queue.Toggle("switch.kitchen_fan", now));
+        Run(400U, false);
+        EXPECT_EQ(0U, server.ServiceCalls());
+        EXPECT_FALSE(Shown("switch.kitchen_fan").on);
+        EXPECT_EQ(1U, queue.GetStats().rolled_back);
+    }
+
+}  // namespace
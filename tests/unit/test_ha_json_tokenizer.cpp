@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "integration/ha_json_tokenizer.h"
+#include "integration/ha_state_event.h"
+
+namespace
+{
+
+    using custom::integration::HaDecodeStateChanged;
+    using custom::integration::HaFrameKind;
+    using custom::integration::HaJsonToken;
+    using custom::integration::HaJsonTokenizer;
+    using custom::integration::HaStateChanged;
+
+    // As sent by Home Assistant 2025.1 for a dimmable light, old_state trimmed
+    constexpr const char* kLightEvent =
+        R"({"id":2,"type":"event","event":{"event_type":"state_changed","data":{)"
+        R"("entity_id":"light.kitchen_main","old_state":{"entity_id":"light.kitchen_main",)"
+        R"("state":"off","attributes":{"brightness":null}},"new_state":{)"
+        R"("entity_id":"light.kitchen_main","state":"on","attributes":{)"
+        R"("supported_color_modes":["brightness","color_temp"],"color_mode":"color_temp",)"
+        R"("brightness":191,"color_temp_kelvin":2700,"hs_color":[28.391,65.659],)"
+        R"("friendly_name":"Kitchen \"main\" éclairage","supported_features":40},)"
+        R"("last_changed":"2025-01-04T18:02:11.143981+00:00","context":{)"
+        R"("id":"01JGTYV3","parent_id":null,"user_id":null}}},"origin":"LOCAL",)"
+        R"("time_fired":"2025-01-04T18:02:11.143981+00:00","context":{"id":"01JGTYV3"}}})";
+
+    std::vector<HaJsonToken> Tokens(const std::string& json)
+    {
+        HaJsonTokenizer          tokenizer(json.data(), json.size());
+        std::vector<HaJsonToken> tokens;
+        for (;;)
+        {
+            tokens.push_back(tokenizer.Next());
+            if (tokens.back() == HaJsonToken::kEnd || tokens.back() == HaJsonToken::kError)
+            {
+                return tokens;
+            }
+        }
+    }
+
+    TEST(HaJsonTokenizerTest, WalksNestedValues)
+    {
+        const std::string json = R"( {"a":[1,-2.5e3,"x"],"b":{"c":true,"d":null},"e":false} )";
+        HaJsonTokenizer   tokenizer(json.data(), json.size());
+
+        EXPECT_EQ(HaJsonToken::kObjectBegin, tokenizer.Next());
+        EXPECT_EQ(HaJsonToken::kKey, tokenizer.Next());
+        EXPECT_EQ("a", tokenizer.Text());
+        EXPECT_EQ(HaJsonToken::kArrayBegin, tokenizer.Next());
+        EXPECT_EQ(HaJsonToken::kNumber, tokenizer.Next());
+        EXPECT_EQ(HaJsonToken::kNumber, tokenizer.Next());
+        double value = 0.0;
+        EXPECT_TRUE(tokenizer.NumberValue(value));
+        EXPECT_DOUBLE_EQ(-2500.0, value);
+        EXPECT_EQ(HaJsonToken::kString, tokenizer.Next());
+        EXPECT_EQ("x", tokenizer.Text());
+        EXPECT_EQ(HaJsonToken::kArrayEnd, tokenizer.Next());
+
+        EXPECT_EQ(HaJsonToken::kKey, tokenizer.Next());
+        EXPECT_TRUE(tokenizer.SkipValue());  // all of "b"
+        EXPECT_EQ(1U, tokenizer.Depth());
+        EXPECT_EQ(HaJsonToken::kKey, tokenizer.Next());
+        EXPECT_EQ("e", tokenizer.Text());
+        EXPECT_EQ(HaJsonToken::kFalse, tokenizer.Next());
+        EXPECT_EQ(HaJsonToken::kObjectEnd, tokenizer.Next());
+        EXPECT_EQ(HaJsonToken::kEnd, tokenizer.Next());
+    }
+
+    TEST(HaJsonTokenizerTest, RejectsMalformedInput)
+    {
+        for (const char* bad : {"{not json",
+                                R"({"a":1,})",
+                                R"({"a" 1})",
+                                R"([1 2])",
+                                R"({"a":[1}])",
+                                R"({"a":01})",
+                                R"({"a":"\x"})",
+                                R"({"a":"unterminated)",
+                                R"({"a":1}{)",
+                                R"({"a":tru})"})
+        {
+            EXPECT_EQ(HaJsonToken::kError, Tokens(bad).back()) << bad;
+        }
+        EXPECT_EQ(HaJsonToken::kError, Tokens(std::string(100, '[')).back());
+    }
+
+    TEST(HaJsonTokenizerTest, CopyTextDecodesEscapes)
+    {
+        const std::string json = R"(["tab\there \"q\" é 😀 a\/b"])";
+        HaJsonTokenizer   tokenizer(json.data(), json.size());
+        tokenizer.Next();
+        ASSERT_EQ(HaJsonToken::kString, tokenizer.Next());
+
+        char text[64];
+        ASSERT_TRUE(tokenizer.CopyText(text, sizeof(text)));
+        EXPECT_STREQ("tab\there \"q\" \xC3\xA9 \xF0\x9F\x98\x80 a/b", text);
+        EXPECT_FALSE(tokenizer.CopyText(text, 8U));
+        EXPECT_STREQ("", text);
+    }
+
+    TEST(HaStateEventTest, DecodesOnlyTheFieldsTheRoomsPageUses)
+    {
+        HaStateChanged event;
+        ASSERT_EQ(HaFrameKind::kStateChanged,
+                  HaDecodeStateChanged(kLightEvent, std::strlen(kLightEvent), event));
+        EXPECT_EQ(2U, event.id);
+        EXPECT_STREQ("light.kitchen_main", event.entity_id);
+        EXPECT_STREQ("on", event.state);
+        EXPECT_FALSE(event.removed);
+        EXPECT_EQ(191, event.brightness);  // from new_state, not old_state
+    }
+
+    TEST(HaStateEventTest, ClassifiesOtherFrames)
+    {
+        HaStateChanged    event;
+        const std::string removed =
+            R"({"id":2,"type":"event","event":{"event_type":"state_changed","data":{)"
+            R"("entity_id":"sensor.gone","old_state":{"state":"3"},"new_state":null}}})";
+        ASSERT_EQ(HaFrameKind::kStateChanged,
+                  HaDecodeStateChanged(removed.data(), removed.size(), event));
+        EXPECT_TRUE(event.removed);
+        EXPECT_STREQ("sensor.gone", event.entity_id);
+
+        const std::string result = R"({"id":3,"type":"result","success":true,"result":[]})";
+        EXPECT_EQ(HaFrameKind::kOther, HaDecodeStateChanged(result.data(), result.size(), event));
+        const std::string other =
+            R"({"id":2,"type":"event","event":{"event_type":"call_service","data":{}}})";
+        EXPECT_EQ(HaFrameKind::kOther, HaDecodeStateChanged(other.data(), other.size(), event));
+
+        const std::string truncated(kLightEvent, std::strlen(kLightEvent) - 3U);
+        EXPECT_EQ(HaFrameKind::kMalformed,
+                  HaDecodeStateChanged(truncated.data(), truncated.size(), event));
+    }
+
+}  // namespace
@@ -0,0 +1,311 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/ha_media_player.h"
+#include "integration/ha_ws_client.h"
+#include "integration/ha_ws_stub_server.h"
+#include "integration/rooms_provider.h"
+
+namespace
+{
+
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaMediaPlayer;
+    using custom::integration::HaMediaView;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::HaStubTrack;
+    using custom::integration::HaWsClient;
+    using custom::integration::HaWsStubServer;
+    using custom::integration::HaWsTransport;
+
+    constexpr const char* kMediaToken  = "media-token";
+    constexpr const char* kMediaEntity = "media_player.living_room";
+
+    constexpr const char* kProxyPicture =
+        "/api/media_player_proxy/media_player.living_room?token=abc&cache=1f2e";
+    constexpr const char* kCdnPicture = "https://covers.example/analog-sunshine.jpg";
+
+    std::vector<HaRoomLayout> MediaTestLayout()
+    {
+        HaRoomLayout living;
+        living.room_id  = "living";
+        living.name     = "Living Room";
+        living.entities = {"light.living_main"};
+        return {living};
+    }
+
+    class HaMediaPlayerTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            rooms_provider_reset_state();
+            server.Attach(&client);
+            player.Attach(&client);
+            server.SetState("light.living_main", "on", 200);
+            server.AddMediaPlayer(
+                kMediaEntity,
+                {HaStubTrack{"Coffee Shop Jazz", "Lo-Fi Ensemble", 240.0, kProxyPicture},
+                 HaStubTrack{"Analog Sunshine", "Night Drive", 180.0, kCdnPicture}});
+        }
+
+        void TearDown() override
+        {
+            rooms_provider_reset_state();
+        }
+
+        void ConnectAndSync()
+        {
+            server.Connect();
+            Drain();
+        }
+
+        void Drain()
+        {
+            while (server.Pump() > 0U)
+            {
+            }
+        }
+
+        /** Local and server time move together, as they do on a real device. */
+        void Elapse(std::uint32_t ms)
+        {
+            now_ms += ms;
+            server.AdvanceClock(ms / 1000.0);
+        }
+
+        std::uint32_t  now_ms = 1000U;
+        HaEntityStore  store{MediaTestLayout()};
+        HaWsStubServer server{kMediaToken};
+        HaWsClient     client{server, store, kMediaToken};
+        HaMediaPlayer  player{kMediaEntity, [this]() { return now_ms; }};
+    };
+
+    TEST_F(HaMediaPlayerTest, SnapshotFillsTheView)
+    {
+        EXPECT_FALSE(player.View(now_ms).available);
+
+        ConnectAndSync();
+        const HaMediaView view = player.View(now_ms);
+        EXPECT_TRUE(view.available);
+        EXPECT_FALSE(view.playing);
+        EXPECT_EQ("Coffee Shop Jazz", view.title);
+        EXPECT_EQ("Lo-Fi Ensemble", view.artist);
+        EXPECT_EQ(std::string(kMediaEntity), view.source);  // the stub's friendly_name
+        EXPECT_EQ(50U, view.volume);
+        EXPECT_EQ(0U, view.position_s);
+        EXPECT_EQ(240U, view.duration_s);
+    }
+
+    TEST_F(HaMediaPlayerTest, PositionAdvancesLocallyBetweenUpdates)
+    {
+        ConnectAndSync();
+        ASSERT_TRUE(server.MediaService(kMediaEntity, "media_play"));
+        Drain();
+        const std::size_t bytes = server.BytesSent();
+
+        HaMediaView view;
+        ASSERT_TRUE(player.TakeViewIfChanged(now_ms, view));
+        EXPECT_TRUE(view.playing);
+        EXPECT_EQ(0U, view.position_s);
+
+        // A 250 ms UI timer: one push per second shown, nothing from the network
+        int pushes = 0;
+        for (int tick = 0; tick < 40; ++tick)
+        {
+            Elapse(250U);
+            pushes += player.TakeViewIfChanged(now_ms, view) ? 1 : 0;
+        }
+        EXPECT_EQ(10, pushes);
+        EXPECT_EQ(10U, view.position_s);
+        EXPECT_EQ(static_cast<std::uint32_t>(server.MediaPosition(kMediaEntity)), view.position_s);
+        EXPECT_EQ(0U, server.PendingFrames());
+        EXPECT_EQ(bytes, server.BytesSent());
+
+        // Stops at the end of the track rather than running past it
+        Elapse(600U * 1000U);
+        EXPECT_EQ(240U, player.View(now_ms).position_s);
+    }
+
+    TEST_F(HaMediaPlayerTest, ReportedPositionIsCorrectedForItsAge)
+    {
+        ConnectAndSync();
+        ASSERT_TRUE(server.MediaService(kMediaEntity, "media_play"));
+        Drain();
+
+        // The volume event 30 s later carries media_position 0, stamped when play started
+        Elapse(30U * 1000U);
+        ASSERT_TRUE(server.MediaService(kMediaEntity, "volume_set", 0.8));
+        now_ms += 45000U;  // a local clock that has nothing to do with the server's
+        Drain();
+        EXPECT_EQ(80U, player.View(now_ms).volume);
+        EXPECT_EQ(30U, player.View(now_ms).position_s);
+        EXPECT_EQ(32U, player.View(now_ms + 2000U).position_s);
+    }
+
+    TEST_F(HaMediaPlayerTest, PlayPauseShowsAtOnceAndIsConfirmed)
+    {
+        ConnectAndSync();
+        ASSERT_TRUE(player.PlayPause(now_ms));
+        EXPECT_TRUE(player.View(now_ms).playing);  // before any reply
+        EXPECT_EQ(1U, server.ServiceCalls());
+        Drain();
+
+        Elapse(12000U);
+        EXPECT_EQ(12U, player.View(now_ms).position_s);
+        ASSERT_TRUE(player.PlayPause(now_ms));
+        Drain();
+        Elapse(5000U);
+        const HaMediaView paused = player.View(now_ms);
+        EXPECT_FALSE(paused.playing);
+        EXPECT_EQ(12U, paused.position_s);
+        EXPECT_EQ(2U, server.ServiceCalls());
+    }
+
+    TEST_F(HaMediaPlayerTest, UnconfirmedCommandFallsBack)
+    {
+        ConnectAndSync();
+        server.FailServiceCalls(true);
+        ASSERT_TRUE(player.PlayPause(now_ms));
+        ASSERT_TRUE(player.SetVolume(90U, now_ms));
+        Drain();
+        EXPECT_TRUE(player.View(now_ms).playing);
+        EXPECT_EQ(90U, player.View(now_ms).volume);
+
+        Elapse(HaMediaPlayer::kOptimisticHoldMs);
+        const HaMediaView view = player.View(now_ms);
+        EXPECT_FALSE(view.playing);
+        EXPECT_EQ(50U, view.volume);
+        EXPECT_EQ(0U, view.position_s);
+    }
+
+    TEST_F(HaMediaPlayerTest, TrackAndVolumeCommandsReachTheServer)
+    {
+        ConnectAndSync();
+        ASSERT_TRUE(player.PlayPause(now_ms));
+        Drain();
+        Elapse(20000U);
+
+        ASSERT_TRUE(player.Next());
+        Drain();
+        HaMediaView view = player.View(now_ms);
+        EXPECT_EQ("Analog Sunshine", view.title);
+        EXPECT_EQ(180U, view.duration_s);
+        EXPECT_EQ(0U, view.position_s);
+        EXPECT_TRUE(view.playing);
+
+        ASSERT_TRUE(player.SetVolume(70U, now_ms));
+        EXPECT_EQ(70U, player.View(now_ms).volume);
+        ASSERT_TRUE(player.Previous());
+        Drain();
+        view = player.View(now_ms);
+        EXPECT_EQ("Coffee Shop Jazz", view.title);
+        EXPECT_EQ(70U, view.volume);
+        EXPECT_EQ(4U, server.ServiceCalls());
+    }
+
+    TEST_F(HaMediaPlayerTest, DisconnectMakesThePlayerUnavailable)
+    {
+        EXPECT_FALSE(player.PlayPause(now_ms));  // not connected yet
+        ConnectAndSync();
+        ASSERT_TRUE(player.PlayPause(now_ms));
+        Drain();
+
+        server.Disconnect();
+        const HaMediaView view = player.View(now_ms);
+        EXPECT_FALSE(view.available);
+        EXPECT_FALSE(view.playing);
+        EXPECT_FALSE(player.Next());
+
+        ConnectAndSync();
+        EXPECT_TRUE(player.View(now_ms).available);
+        EXPECT_TRUE(player.View(now_ms).playing);
+        EXPECT_EQ(2U, server.GetStatesRequests());
+    }
+
+    TEST_F(HaMediaPlayerTest, CoverPathsResolveAgainstTheServer)
+    {
+        player.SetPictureBase("http://homeassistant.local:8123/");
+        ConnectAndSync();
+        EXPECT_EQ(std::string("http://homeassistant.local:8123") + kProxyPicture,
+                  player.View(now_ms).artwork_url);
+
+        HaMediaView view;
+        ASSERT_TRUE(player.TakeViewIfChanged(now_ms, view));
+        ASSERT_TRUE(server.MediaService(kMediaEntity, "media_next_track"));
+        Drain();
+        ASSERT_TRUE(player.TakeViewIfChanged(now_ms, view));
+        EXPECT_EQ(kCdnPicture, view.artwork_url);  // already absolute
+    }
+
+    TEST_F(HaMediaPlayerTest, OnlyObservedEventsAreParsed)
+    {
+        ConnectAndSync();
+        const std::uint32_t before = client.GetStats().dom_parses;
+        server.SetState("light.living_main", "off");
+        server.SetState("sensor.outside", "12");
+        Drain();
+        EXPECT_EQ(before, client.GetStats().dom_parses);
+
+        ASSERT_TRUE(server.MediaService(kMediaEntity, "media_next_track"));
+        Drain();
+        EXPECT_EQ(before + 1U, client.GetStats().dom_parses);
+        EXPECT_EQ("Analog Sunshine", player.View(now_ms).title);
+    }
+
+    class MediaRecordingTransport : public HaWsTransport
+    {
+    public:
+        bool SendText(const std::string& text) override
+        {
+            sent.push_back(text);
+            return true;
+        }
+
+        std::vector<std::string> sent;
+    };
+
+    TEST(HaMediaPlayerSyncTest, ReplaysAnEventThatBeatTheSnapshot)
+    {
+        MediaRecordingTransport transport;
+        HaEntityStore           store(MediaTestLayout());
+        HaWsClient              client(transport, store, kMediaToken);
+        HaMediaPlayer           player(kMediaEntity, []() { return 0U; });
+        player.Attach(&client);
+
+        const auto feed = [&client](const std::string& frame) {
+            client.OnText(frame.data(), frame.size());
+        };
+        client.OnConnected();
+        feed(R"({"type":"auth_required"})");
+        feed(R"({"type":"auth_ok"})");
+        feed(R"({"id":1,"type":"event","event":{"event_type":"state_changed","data":{)"
+             R"("entity_id":"media_player.living_room","new_state":{)"
+             R"("entity_id":"media_player.living_room","state":"playing","attributes":{)"
+             R"("media_title":"Newer","volume_level":0.25}}},)"
+             R"("time_fired":"2025-01-01T00:00:10.000000+00:00"}})");
+        EXPECT_FALSE(player.View(0U).available);
+        feed(R"({"id":2,"type":"result","success":true,"result":[)"
+             R"({"entity_id":"media_player.living_room","state":"paused",)"
+             R"("attributes":{"media_title":"Older","app_name":"Spotify",)"
+             R"("friendly_name":"Living Room"}}]})");
+
+        const HaMediaView view = player.View(0U);
+        EXPECT_TRUE(view.available);
+        EXPECT_TRUE(view.playing);
+        EXPECT_EQ("Newer", view.title);
+        EXPECT_EQ(25U, view.volume);
+        EXPECT_EQ("", view.source);  // the event's attributes replace the snapshot's
+        rooms_provider_reset_state();
+    }
+
+}  // namespace
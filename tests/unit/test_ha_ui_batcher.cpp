@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/ha_ui_batcher.h"
+#include "integration/rooms_provider.h"
+
+namespace
+{
+
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaEntityUpdate;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::HaUiBatcher;
+
+    std::vector<HaRoomLayout> BatcherLayout()
+    {
+        std::vector<HaRoomLayout> layout;
+        for (const char* id : {"kitchen", "office", "hall"})
+        {
+            HaRoomLayout room;
+            room.room_id            = id;
+            room.name               = id;
+            room.entities           = {std::string("light.") + id};
+            room.temperature_entity = std::string("sensor.") + id + "_temperature";
+            layout.push_back(room);
+        }
+        return layout;
+    }
+
+    class HaUiBatcherTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            rooms_provider_reset_state();
+            store.Publish();
+        }
+
+        void TearDown() override
+        {
+            rooms_provider_reset_state();
+        }
+
+        HaEntityStore            store{BatcherLayout()};
+        int                      scheduled = 0;
+        std::vector<std::string> applied;
+        HaUiBatcher              batcher{
+            store,
+            [this]() { scheduled++; },
+            [this](const room_t& room) { applied.emplace_back(room.room_id); }};
+    };
+
+    TEST_F(HaUiBatcherTest, SceneBurstSchedulesOneFlushForTheChangedRoom)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            store.Apply(HaEntityUpdate{"light.kitchen", "on", i % 256});
+            store.Apply(HaEntityUpdate{"sensor.kitchen_temperature", std::to_string(i % 30), -1});
+            batcher.MarkChanged();
+        }
+        EXPECT_EQ(1, scheduled);
+
+        EXPECT_EQ(1U, batcher.Flush());
+        ASSERT_EQ(1U, applied.size());
+        EXPECT_EQ("kitchen", applied[0]);
+
+        const room_t& kitchen = rooms_provider_get_state()->rooms[0];
+        EXPECT_EQ(95, kitchen.entities[0]->value);  // brightness 243 from the last update
+        EXPECT_EQ(19, kitchen.temp_c);
+
+        EXPECT_EQ(0U, batcher.Flush());
+        const HaUiBatcher::Stats stats = batcher.GetStats();
+        EXPECT_EQ(500U, stats.changes);
+        EXPECT_EQ(2U, stats.flushes);
+        EXPECT_EQ(1U, stats.max_rooms);
+        EXPECT_EQ(1U, stats.empty_passes);
+    }
+
+    TEST_F(HaUiBatcherTest, ChangeDuringFlushSchedulesAnother)
+    {
+        store.Apply(HaEntityUpdate{"light.office", "on", 255});
+        batcher.MarkChanged();
+        ASSERT_EQ(1, scheduled);
+
+        HaUiBatcher racing(
+            store,
+            [this]() { scheduled++; },
+            [&](const room_t&) {
+                // The network task lands another delta while the UI is applying this one
+                store.Apply(HaEntityUpdate{"light.hall", "on", 255});
+                racing.MarkChanged();
+            });
+        racing.MarkChanged();
+        EXPECT_EQ(2, scheduled);
+        EXPECT_EQ(1U, racing.Flush());
+        EXPECT_EQ(3, scheduled);
+        EXPECT_EQ(1U, batcher.Flush());
+        EXPECT_EQ("hall", applied.at(0));
+    }
+
+    TEST_F(HaUiBatcherTest, DisconnectRefreshesEveryCard)
+    {
+        store.MarkAllUnavailable();
+        batcher.MarkChanged();
+        EXPECT_EQ(3U, batcher.Flush());
+        EXPECT_EQ(3U, applied.size());
+    }
+
+    // A producer thread fires deltas as fast as it can while the test thread runs a 60 Hz-ish
+    // frame loop. Every frame applies at most one flush and the last value always lands.
+    TEST(HaUiBatcherStressTest, ThousandsOfDeltasCollapseToOneFlushPerFrame)
+    {
+        rooms_provider_reset_state();
+        HaEntityStore     store(BatcherLayout());
+        std::atomic<bool> flush_requested{false};
+        std::size_t       cards = 0U;
+        HaUiBatcher       batcher(
+            store,
+            [&flush_requested]() { flush_requested.store(true); },
+            [&cards](const room_t&) { cards++; });
+
+        constexpr int     kDeltas = 20000;
+        std::atomic<bool> done{false};
+        std::thread       producer([&]() {
+            static const char* const kLights[] = {"light.kitchen", "light.office", "light.hall"};
+            for (int i = 1; i <= kDeltas; ++i)
+            {
+                if (store.Apply(HaEntityUpdate{kLights[i % 3], "on", i % 255}))
+                {
+                    batcher.MarkChanged();
+                }
+            }
+            done.store(true);
+        });
+
+        int frames = 0;
+        while (!done.load() || flush_requested.load())
+        {
+            if (flush_requested.exchange(false))
+            {
+                batcher.Flush();
+            }
+            frames++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        producer.join();
+
+        const HaUiBatcher::Stats stats = batcher.GetStats();
+        EXPECT_LE(stats.flushes, static_cast<std::uint32_t>(frames));
+        EXPECT_LE(stats.max_rooms, 3U);
+        EXPECT_LT(cards, static_cast<std::size_t>(kDeltas));
+
+        // The last update of each light wins
+        const rooms_state_t* state = rooms_provider_get_state();
+        EXPECT_EQ((19998 % 255 * 100 + 127) / 255, state->rooms[0].entities[0]->value);
+        EXPECT_EQ((19999 % 255 * 100 + 127) / 255, state->rooms[1].entities[0]->value);
+        EXPECT_EQ((20000 % 255 * 100 + 127) / 255, state->rooms[2].entities[0]->value);
+        rooms_provider_reset_state();
+    }
+
+}  // namespace
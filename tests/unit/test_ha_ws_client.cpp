@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/ha_ws_client.h"
+#include "integration/ha_ws_stub_server.h"
+#include "integration/rooms_provider.h"
+
+namespace
+{
+
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaEntityUpdate;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::HaWebSocketUrl;
+    using custom::integration::HaWsClient;
+    using custom::integration::HaWsStubServer;
+    using custom::integration::HaWsTransport;
+
+    constexpr const char* kToken = "test-token";
+
+    std::vector<HaRoomLayout> TestLayout()
+    {
+        HaRoomLayout kitchen;
+        kitchen.room_id            = "kitchen";
+        kitchen.name               = "Kitchen";
+        kitchen.entities           = {"light.kitchen_main", "switch.kitchen_fan"};
+        kitchen.temperature_entity = "sensor.kitchen_temperature";
+        kitchen.humidity_entity    = "sensor.kitchen_humidity";
+
+        HaRoomLayout office;
+        office.room_id  = "office";
+        office.name     = "Office";
+        office.entities = {"light.office_desk"};
+        return {kitchen, office};
+    }
+
+    const room_entity_t* FindEntity(const rooms_state_t* state, const char* entity_id)
+    {
+        for (std::size_t r = 0; state != nullptr && r < state->room_count; ++r)
+        {
+            const room_t& room = state->rooms[r];
+            for (std::size_t e = 0; e < room.entity_count; ++e)
+            {
+                if (std::strcmp(room.entities[e]->entity_id, entity_id) == 0)
+                {
+                    return room.entities[e];
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    class RecordingTransport : public HaWsTransport
+    {
+    public:
+        bool SendText(const std::string& text) override
+        {
+            sent.push_back(text);
+            return true;
+        }
+
+        std::vector<std::string> sent;
+    };
+
+    class HaSyncTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            rooms_provider_reset_state();
+            client.SetChangeCallback([this]() {
+                changes++;
+                store.Publish();
+            });
+            server.Attach(&client);
+
+            server.SetState("light.kitchen_main", "on", 128);
+            server.SetState("switch.kitchen_fan", "off");
+            server.SetState("sensor.kitchen_temperature", "21.6");
+            server.SetState("sensor.kitchen_humidity", "44");
+            server.SetState("light.office_desk", "off");
+            for (int i = 0; i < 200; ++i)
+            {
+                server.SetState("sensor.untracked_" + std::to_string(i), std::to_string(i));
+            }
+        }
+
+        void TearDown() override
+        {
+            rooms_provider_reset_state();
+        }
+
+        void ConnectAndSync()
+        {
+            server.Connect();
+            while (server.Pump() > 0U)
+            {
+            }
+        }
+
+        HaEntityStore  store{TestLayout()};
+        HaWsStubServer server{kToken};
+        HaWsClient     client{server, store, kToken};
+        int            changes = 0;
+    };
+
+    TEST(HaWebSocketUrlTest, DerivesTheApiEndpointFromTheConfiguredUrl)
+    {
+        EXPECT_EQ("ws://ha.local:8123/api/websocket", HaWebSocketUrl("http://ha.local:8123"));
+        EXPECT_EQ("wss://ha.example.com/api/websocket", HaWebSocketUrl("https://ha.example.com/"));
+    }
+
+    TEST(HaEntityStoreTest, TracksOnlyLayoutEntities)
+    {
+        HaEntityStore store(TestLayout());
+        EXPECT_EQ(5U, store.EntityCount());
+        EXPECT_FALSE(store.Apply(HaEntityUpdate{"light.garage", "on", 255}));
+
+        EXPECT_TRUE(store.Apply(HaEntityUpdate{"light.kitchen_main", "on", 255}));
+        EXPECT_FALSE(store.Apply(HaEntityUpdate{"light.kitchen_main", "on", 255}));
+        EXPECT_TRUE(store.Apply(HaEntityUpdate{"sensor.kitchen_temperature", "-3.4", -1}));
+
+        const rooms_state_t* state = store.Publish();
+        ASSERT_EQ(state, rooms_provider_get_state());
+        ASSERT_EQ(2U, state->room_count);
+        EXPECT_STREQ("light.kitchen_main", room_primary_entity(&state->rooms[0])->entity_id);
+        EXPECT_EQ(100, FindEntity(state, "light.kitchen_main")->value);
+        EXPECT_EQ(-3, state->rooms[0].temp_c);
+        EXPECT_FALSE(FindEntity(state, "light.office_desk")->available);
+        rooms_provider_reset_state();
+    }
+
+    TEST_F(HaSyncTest, SnapshotFillsTheRoomsState)
+    {
+        ConnectAndSync();
+        ASSERT_EQ(HaWsClient::State::kLive, client.GetState());
+        EXPECT_EQ(1U, server.GetStatesRequests());
+        EXPECT_EQ(1, changes);
+
+        const rooms_state_t* state = rooms_provider_get_state();
+        const room_entity_t* light = FindEntity(state, "light.kitchen_main");
+        ASSERT_NE(nullptr, light);
+        EXPECT_TRUE(light->available);
+        EXPECT_TRUE(light->on);
+        EXPECT_EQ(50, light->value);
+        EXPECT_FALSE(FindEntity(state, "switch.kitchen_fan")->on);
+        EXPECT_EQ(22, state->rooms[0].temp_c);
+        EXPECT_EQ(44U, state->rooms[0].humidity);
+    }
+
+    TEST_F(HaSyncTest, DeltasUpdateOnlyWhatChanged)
+    {
+        ConnectAndSync();
+        changes                    = 0;
+        const std::uint32_t before = client.GetStats().dom_parses;
+
+        server.SetState("switch.kitchen_fan", "on");
+        server.SetState("sensor.untracked_7", "8");
+        server.SetState("light.office_desk", "off");  // no visible change
+        EXPECT_EQ(3U, server.Pump());
+
+        EXPECT_EQ(1, changes);
+        EXPECT_TRUE(FindEntity(rooms_provider_get_state(), "switch.kitchen_fan")->on);
+        EXPECT_EQ(1U, client.GetStats().deltas_applied);
+        EXPECT_EQ(2U, client.GetStats().deltas_ignored);
+        EXPECT_EQ(1U, server.GetStatesRequests());  // no polling for changes
+        EXPECT_EQ(before, client.GetStats().dom_parses);  // events are decoded in place
+
+        server.RemoveEntity("light.office_desk");
+        server.Pump();
+        EXPECT_FALSE(FindEntity(rooms_provider_get_state(), "light.office_desk")->available);
+    }
+
+    TEST_F(HaSyncTest, ReconnectMarksStaleAndResyncs)
+    {
+        ConnectAndSync();
+        server.Disconnect();
+        EXPECT_EQ(HaWsClient::State::kDisconnected, client.GetState());
+        EXPECT_FALSE(FindEntity(rooms_provider_get_state(), "light.kitchen_main")->available);
+
+        server.SetState("light.kitchen_main", "off");
+        ConnectAndSync();
+        EXPECT_EQ(2U, server.GetStatesRequests());
+        const room_entity_t* light = FindEntity(rooms_provider_get_state(), "light.kitchen_main");
+        EXPECT_TRUE(light->available);
+        EXPECT_FALSE(light->on);
+    }
+
+    TEST(HaWsClientTest, RejectedTokenStopsBeforeSubscribing)
+    {
+        HaEntityStore  other_store(TestLayout());
+        HaWsStubServer strict("other-token");
+        HaWsClient     rejected(strict, other_store, kToken);
+        strict.Attach(&rejected);
+        strict.Connect();
+        while (strict.Pump() > 0U)
+        {
+        }
+        EXPECT_EQ(HaWsClient::State::kAuthFailed, rejected.GetState());
+        EXPECT_EQ(0U, strict.GetStatesRequests());
+    }
+
+    TEST(HaWsClientTest, ReplaysDeltasThatBeatTheSnapshot)
+    {
+        RecordingTransport transport;
+        HaEntityStore      store(TestLayout());
+        HaWsClient         client(transport, store, kToken);
+
+        const auto feed = [&client](const std::string& frame) {
+            client.OnText(frame.data(), frame.size());
+        };
+        client.OnConnected();
+        feed(R"({"type":"auth_required"})");
+        ASSERT_EQ(1U, transport.sent.size());
+        EXPECT_NE(std::string::npos, transport.sent[0].find(kToken));
+
+        feed(R"({"type":"auth_ok"})");
+        ASSERT_EQ(3U, transport.sent.size());
+        EXPECT_NE(std::string::npos, transport.sent[1].find("subscribe_events"));
+        EXPECT_NE(std::string::npos, transport.sent[2].find("get_states"));
+
+        // The change is delivered before the (older) snapshot that still says "off"
+        feed(R"({"id":1,"type":"event","event":{"event_type":"state_changed","data":{)"
+             R"("entity_id":"light.office_desk","new_state":{"entity_id":"light.office_desk",)"
+             R"("state":"on","attributes":{"brightness":255}}}}})");
+        EXPECT_EQ(HaWsClient::State::kSyncing, client.GetState());
+        feed(R"({"id":2,"type":"result","success":true,"result":[)"
+             R"({"entity_id":"light.office_desk","state":"off","attributes":{}}]})");
+        EXPECT_EQ(HaWsClient::State::kLive, client.GetState());
+
+        const room_entity_t* desk = FindEntity(store.Publish(), "light.office_desk");
+        EXPECT_TRUE(desk->on);
+        EXPECT_EQ(100, desk->value);
+
+        feed("{not json");
+        EXPECT_EQ(1U, client.GetStats().parse_errors);
+        rooms_provider_reset_state();
+    }
+
+}  // namespace
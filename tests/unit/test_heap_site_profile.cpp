@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "platform/memory/heap_site_profile.h"
+
+namespace
+{
+
+    using custom::platform::HeapSiteProfile;
+    using custom::platform::HeapTagScope;
+
+    const void* FakeBlock(std::uintptr_t address)
+    {
+        return reinterpret_cast<const void*>(address);
+    }
+
+    std::string Report(const HeapSiteProfile& profile)
+    {
+        std::string text;
+        profile.Write([&text](const char* data, std::size_t len) {
+            text.append(data, len);
+            return true;
+        });
+        return text;
+    }
+
+    TEST(HeapSiteProfileTest, ChargesFreesBackToTheAllocatingSite)
+    {
+        std::vector<HeapSiteProfile::Slot> slots(64U);
+        auto profile = std::make_unique<HeapSiteProfile>(slots.data(), slots.size());
+
+        profile->OnAlloc(FakeBlock(0x1000U), 24U, "lvgl");
+        profile->OnAlloc(FakeBlock(0x2000U), 3000U, "lvgl");
+        profile->OnAlloc(FakeBlock(0x3000U), 100000U, "mqtt");
+        profile->OnAlloc(FakeBlock(0x4000U), 8U, nullptr);
+        profile->OnFree(FakeBlock(0x1000U));
+        // Never seen: allocated before the profile existed
+        profile->OnFree(FakeBlock(0x9000U));
+
+        HeapSiteProfile::TagSummary summaries[4];
+        ASSERT_EQ(3U, profile->Summaries(summaries, 4U));
+        EXPECT_STREQ("mqtt", summaries[0].name);
+        EXPECT_EQ(100000U, summaries[0].live_bytes);
+        EXPECT_EQ(1U, summaries[0].classes[HeapSiteProfile::SizeClass(100000U)].live_blocks);
+        EXPECT_STREQ("lvgl", summaries[1].name);
+        EXPECT_EQ(3000U, summaries[1].live_bytes);
+        EXPECT_EQ(1U, summaries[1].live_blocks);
+        EXPECT_EQ(2U, summaries[1].allocs);
+        EXPECT_EQ(0U, summaries[1].classes[HeapSiteProfile::SizeClass(24U)].live_blocks);
+        EXPECT_STREQ("[other]", summaries[2].name);
+
+        const HeapSiteProfile::Stats stats = profile->GetStats();
+        EXPECT_EQ(3U, stats.tracked);
+        EXPECT_EQ(0U, stats.untracked);
+        EXPECT_EQ(64U, stats.capacity);
+
+        const std::string report = Report(*profile);
+        EXPECT_EQ(0U, report.find("site "));
+        EXPECT_LT(report.find("\nmqtt "), report.find("\nlvgl "));
+        EXPECT_NE(std::string::npos, report.find("# 3 blocks tracked of 64 slots"));
+    }
+
+    TEST(HeapSiteProfileTest, SortsSizesIntoClasses)
+    {
+        EXPECT_EQ(0U, HeapSiteProfile::SizeClass(0U));
+        EXPECT_EQ(0U, HeapSiteProfile::SizeClass(16U));
+        EXPECT_EQ(1U, HeapSiteProfile::SizeClass(17U));
+        EXPECT_EQ(6U, HeapSiteProfile::SizeClass(1024U));
+        EXPECT_EQ(custom::platform::kHeapSizeClasses - 1U, HeapSiteProfile::SizeClass(65537U));
+    }
+
+    TEST(HeapSiteProfileTest, CountsWhatTheTableCannotHold)
+    {
+        std::vector<HeapSiteProfile::Slot> slots(4U);
+        auto profile = std::make_unique<HeapSiteProfile>(slots.data(), slots.size());
+        for (std::uintptr_t block = 1U; block <= 6U; ++block)
+        {
+            profile->OnAlloc(FakeBlock(block * 0x100U), 32U, "ui");
+        }
+        EXPECT_EQ(4U, profile->GetStats().tracked);
+        EXPECT_EQ(2U, profile->GetStats().untracked);
+
+        // A freed slot is reused
+        profile->OnFree(FakeBlock(0x100U));
+        profile->OnAlloc(FakeBlock(0x700U), 32U, "ui");
+        EXPECT_EQ(4U, profile->GetStats().tracked);
+        EXPECT_EQ(2U, profile->GetStats().untracked);
+
+        HeapSiteProfile::TagSummary summary;
+        ASSERT_EQ(1U, profile->Summaries(&summary, 1U));
+        EXPECT_EQ(7U, summary.allocs);
+        EXPECT_EQ(4U, summary.live_blocks);
+        EXPECT_EQ(128U, summary.live_bytes);
+    }
+
+    TEST(HeapSiteProfileTest, TagsFollowTheInnermostScopeOnEachThread)
+    {
+        EXPECT_EQ(nullptr, HeapTagScope::Current());
+        {
+            HeapTagScope outer("lvgl");
+            {
+                HeapTagScope inner("jpeg");
+                EXPECT_STREQ("jpeg", HeapTagScope::Current());
+                std::thread([]() { EXPECT_EQ(nullptr, HeapTagScope::Current()); }).join();
+            }
+            EXPECT_STREQ("lvgl", HeapTagScope::Current());
+        }
+        EXPECT_EQ(nullptr, HeapTagScope::Current());
+    }
+
+    TEST(HeapSiteProfileTest, BalancesUnderConcurrentAllocators)
+    {
+        std::vector<HeapSiteProfile::Slot> slots(4096U);
+        auto profile = std::make_unique<HeapSiteProfile>(slots.data(), slots.size());
+        // Named up front: a tag first seen by two threads at once may land in [other]
+        for (std::uintptr_t worker = 0U; worker < 4U; ++worker)
+        {
+            const std::string tag = "worker" + std::to_string(worker);
+            profile->OnAlloc(FakeBlock(0x10000000U), 48U, tag.c_str());
+            profile->OnFree(FakeBlock(0x10000000U));
+        }
+
+        std::vector<std::thread> threads;
+        for (std::uintptr_t worker = 0U; worker < 4U; ++worker)
+        {
+            threads.emplace_back([&profile, worker]() {
+                const std::string tag = "worker" + std::to_string(worker);
+                for (std::uintptr_t i = 0U; i < 2000U; ++i)
+                {
+                    const void* block = FakeBlock((worker << 20U) + ((i % 256U) + 1U) * 16U);
+                    profile->OnAlloc(block, 48U, tag.c_str());
+                    profile->OnFree(block);
+                }
+                profile->OnAlloc(FakeBlock((worker << 20U) + 8U), 48U, tag.c_str());
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        HeapSiteProfile::TagSummary summaries[8];
+        ASSERT_EQ(4U, profile->Summaries(summaries, 8U));
+        for (const HeapSiteProfile::TagSummary& summary : summaries)
+        {
+            if (summary.name == nullptr)
+            {
+                continue;
+            }
+            EXPECT_EQ(1U, summary.live_blocks) << summary.name;
+            EXPECT_EQ(48U, summary.live_bytes) << summary.name;
+            EXPECT_EQ(2002U, summary.allocs) << summary.name;
+        }
+        EXPECT_EQ(4U, profile->GetStats().tracked);
+    }
+
+}  // namespace
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#include "platform/input/hid_input_queue.h"
+
+namespace
+{
+
+    using custom::platform::KeyboardReportDecoder;
+    using custom::platform::KeyEvent;
+    using custom::platform::PointerEventQueue;
+    using custom::platform::PointerReport;
+    using custom::platform::PointerState;
+
+    PointerReport Motion(std::int16_t dx, std::int16_t dy, std::uint8_t buttons = 0U)
+    {
+        PointerReport report;
+        report.dx      = dx;
+        report.dy      = dy;
+        report.buttons = buttons;
+        return report;
+    }
+
+    TEST(PointerEventQueueTest, CoalescesMotionIntoOneRead)
+    {
+        PointerEventQueue queue(16U);
+        for (int i = 0; i < 10; ++i)
+        {
+            ASSERT_TRUE(queue.Push(Motion(3, -2)));
+        }
+
+        PointerState cursor{100, 100, 0U};
+        EXPECT_FALSE(queue.Drain(cursor, 720, 1280));
+        EXPECT_EQ(130, cursor.x);
+        EXPECT_EQ(80, cursor.y);
+
+        const PointerEventQueue::Stats stats = queue.GetStats();
+        EXPECT_EQ(10U, stats.drained);
+        EXPECT_EQ(9U, stats.coalesced);
+        EXPECT_EQ(10U, stats.max_batch);
+    }
+
+    TEST(PointerEventQueueTest, QuickClickIsNotLost)
+    {
+        // Press and release both arrive between two LVGL reads; the old shared-state path
+        // only ever showed LVGL the final, released state.
+        PointerEventQueue queue(16U);
+        queue.Push(Motion(5, 0));
+        queue.Push(Motion(0, 0, 0x01U));
+        queue.Push(Motion(1, 1, 0x01U));
+        queue.Push(Motion(0, 0, 0x00U));
+        queue.Push(Motion(2, 0));
+
+        PointerState cursor{0, 0, 0U};
+        ASSERT_TRUE(queue.Drain(cursor, 720, 1280));
+        EXPECT_EQ(0x01U, cursor.buttons);
+        EXPECT_EQ(5, cursor.x);
+
+        ASSERT_TRUE(queue.Drain(cursor, 720, 1280));
+        EXPECT_EQ(0x00U, cursor.buttons);
+        EXPECT_EQ(6, cursor.x);
+        EXPECT_EQ(1, cursor.y);
+
+        EXPECT_FALSE(queue.Drain(cursor, 720, 1280));
+        EXPECT_EQ(8, cursor.x);
+    }
+
+    TEST(PointerEventQueueTest, ClampsToTheScreenAndCountsDrops)
+    {
+        PointerEventQueue queue(4U);
+        for (int i = 0; i < 6; ++i)
+        {
+            queue.Push(Motion(-500, 900));
+        }
+        EXPECT_EQ(2U, queue.GetStats().dropped);
+
+        PointerState cursor{10, 10, 0U};
+        queue.Drain(cursor, 720, 1280);
+        EXPECT_EQ(0, cursor.x);
+        EXPECT_EQ(1280, cursor.y);
+    }
+
+    TEST(PointerEventQueueTest, KeepsEveryEdgeAcrossThreads)
+    {
+        PointerEventQueue queue(64U);
+        constexpr int     kClicks = 2000;
+        std::thread       producer([&]() {
+            for (int i = 0; i < kClicks * 2; ++i)
+            {
+                while (!queue.Push(Motion(1, 0, static_cast<std::uint8_t>((i + 1) & 1))))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        PointerState cursor{0, 0, 0U};
+        int          edges = 0;
+        while (edges < kClicks * 2)
+        {
+            const std::uint8_t before = cursor.buttons;
+            queue.Drain(cursor, 1 << 20, 1 << 20);
+            edges += cursor.buttons != before ? 1 : 0;
+        }
+        producer.join();
+        EXPECT_EQ(kClicks * 2, cursor.x);
+        EXPECT_EQ(static_cast<std::uint32_t>(kClicks * 2), queue.GetStats().drained);
+    }
+
+    TEST(KeyboardReportDecoderTest, ReportsPressAndReleaseEdges)
+    {
+        KeyboardReportDecoder decoder;
+        KeyEvent              edges[KeyboardReportDecoder::kBootKeys * 2];
+
+        const std::uint8_t press_a[8] = {0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00};
+        ASSERT_EQ(1U, decoder.Decode(press_a, sizeof(press_a), edges, 12U));
+        EXPECT_EQ(0x04U, edges[0].usage);
+        EXPECT_EQ(0x02U, edges[0].modifiers);
+        EXPECT_TRUE(edges[0].pressed);
+
+        // 'b' joins while 'a' is held: only the new key is reported
+        const std::uint8_t add_b[8] = {0x00, 0x00, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00};
+        ASSERT_EQ(1U, decoder.Decode(add_b, sizeof(add_b), edges, 12U));
+        EXPECT_EQ(0x05U, edges[0].usage);
+
+        // Rollover errors leave the held keys alone
+        const std::uint8_t rollover[8] = {0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01};
+        EXPECT_EQ(0U, decoder.Decode(rollover, sizeof(rollover), edges, 12U));
+
+        const std::uint8_t none[8] = {};
+        ASSERT_EQ(2U, decoder.Decode(none, sizeof(none), edges, 12U));
+        EXPECT_FALSE(edges[0].pressed);
+        EXPECT_FALSE(edges[1].pressed);
+        EXPECT_EQ(0U, decoder.Decode(none, sizeof(none), edges, 12U));
+        EXPECT_EQ(0U, decoder.Decode(none, 4U, edges, 12U));
+    }
+
+}  // namespace
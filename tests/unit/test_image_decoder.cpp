@@ -0,0 +1,735 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "platform/image/image_decoder.h"
+
+namespace
+{
+
+    using custom::platform::DecodeImageScaled;
+    using custom::platform::ImageDecodeInfo;
+    using custom::platform::ImageDecodeResult;
+    using custom::platform::ImageFormat;
+    using custom::platform::ImageReader;
+    using custom::platform::ImageScaleOptions;
+    using custom::platform::ScaledImage;
+
+    using Bytes = std::vector<std::uint8_t>;
+
+    struct Rgb
+    {
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+    };
+
+    constexpr Rgb kRed   = {220, 30, 40};
+    constexpr Rgb kGreen = {30, 200, 60};
+    constexpr Rgb kBlue  = {40, 50, 210};
+    constexpr Rgb kWhite = {250, 250, 250};
+
+    /** kRed, kGreen / kBlue, kWhite, split at the middle. */
+    Rgb Quadrant(std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height)
+    {
+        const bool right  = x >= width / 2U;
+        const bool bottom = y >= height / 2U;
+        return bottom ? (right ? kWhite : kBlue) : (right ? kGreen : kRed);
+    }
+
+    /** Reads @p data at most @p chunk bytes at a time. */
+    ImageReader ReaderOver(const Bytes& data, std::size_t chunk = SIZE_MAX)
+    {
+        auto offset = std::make_shared<std::size_t>(0U);
+        return [&data, chunk, offset](std::uint8_t* dst, std::size_t len) {
+            const std::size_t n = std::min({len, chunk, data.size() - *offset});
+            if (n > 0U)
+            {
+                std::memcpy(dst, data.data() + *offset, n);
+            }
+            *offset += n;
+            return n;
+        };
+    }
+
+    ImageDecodeResult Decode(const Bytes&     data,
+                             std::uint32_t    card_width,
+                             std::uint32_t    card_height,
+                             ScaledImage&     out,
+                             ImageDecodeInfo* info       = nullptr,
+                             std::uint32_t    background = 0x000000U)
+    {
+        ImageScaleOptions options;
+        options.width      = card_width;
+        options.height     = card_height;
+        options.background = background;
+        return DecodeImageScaled(ReaderOver(data), options, out, info);
+    }
+
+    void ExpectPixel(const ScaledImage& image, std::uint32_t x, std::uint32_t y, Rgb expected,
+                     int tolerance)
+    {
+        SCOPED_TRACE("pixel " + std::to_string(x) + "," + std::to_string(y));
+        ASSERT_LT(x, image.width);
+        ASSERT_LT(y, image.height);
+        const std::uint16_t pixel = image.pixels[y * image.width + x];
+        // RGB565 keeps the top bits of each channel
+        EXPECT_NEAR(expected.r & 0xF8, (pixel >> 8) & 0xF8, tolerance);
+        EXPECT_NEAR(expected.g & 0xFC, (pixel >> 3) & 0xFC, tolerance);
+        EXPECT_NEAR(expected.b & 0xF8, (pixel << 3) & 0xF8, tolerance);
+    }
+
+    /* ---- JPEG ---- */
+
+    struct FlatJpegSpec
+    {
+        std::uint32_t width            = 0U;
+        std::uint32_t height           = 0U;
+        bool          gray             = false;
+        std::uint8_t  luma_h           = 1U;  // sampling factors; chroma is always 1x1
+        std::uint8_t  luma_v           = 1U;
+        std::uint16_t restart_interval = 0U;
+    };
+
+    class JpegBitWriter
+    {
+    public:
+        explicit JpegBitWriter(Bytes& out) : out_(out)
+        {
+        }
+
+        void Put(std::uint32_t value, int count)
+        {
+            for (int bit = count - 1; bit >= 0; --bit)
+            {
+                byte_ = static_cast<std::uint8_t>((byte_ << 1) | ((value >> bit) & 1U));
+                if (++filled_ == 8)
+                {
+                    Emit();
+                }
+            }
+        }
+
+        /** Pad the last byte with ones, as before a restart marker or EOI. */
+        void Flush()
+        {
+            while (filled_ != 0)
+            {
+                Put(1U, 1);
+            }
+        }
+
+    private:
+        void Emit()
+        {
+            out_.push_back(byte_);
+            if (byte_ == 0xFFU)
+            {
+                out_.push_back(0x00U);
+            }
+            byte_   = 0U;
+            filled_ = 0;
+        }
+
+        Bytes&       out_;
+        std::uint8_t byte_   = 0U;
+        int          filled_ = 0;
+    };
+
+    /**
+     * Baseline JPEG in which every block is flat, so only DC coefficients are coded: all
+     * quantisers are 1, the DC table holds the 12 categories at 4 bits each and the AC table
+     * only EOB. @p colour is sampled once per MCU.
+     */
+    Bytes FlatJpeg(const FlatJpegSpec&                                 spec,
+                   const std::function<Rgb(std::uint32_t, std::uint32_t)>& colour)
+    {
+        Bytes      out     = {0xFF, 0xD8};
+        const auto segment = [&out](std::uint8_t marker, const Bytes& body) {
+            const std::size_t length = body.size() + 2U;
+            out.insert(out.end(),
+                       {0xFF,
+                        marker,
+                        static_cast<std::uint8_t>(length >> 8),
+                        static_cast<std::uint8_t>(length)});
+            out.insert(out.end(), body.begin(), body.end());
+        };
+
+        const int          components = spec.gray ? 1 : 3;
+        const std::uint8_t luma_h     = spec.gray ? 1U : spec.luma_h;
+        const std::uint8_t luma_v     = spec.gray ? 1U : spec.luma_v;
+
+        Bytes quant(65U, 1U);
+        quant[0] = 0x00;  // 8-bit table 0
+        segment(0xDB, quant);
+
+        Bytes frame = {8,
+                       static_cast<std::uint8_t>(spec.height >> 8),
+                       static_cast<std::uint8_t>(spec.height),
+                       static_cast<std::uint8_t>(spec.width >> 8),
+                       static_cast<std::uint8_t>(spec.width),
+                       static_cast<std::uint8_t>(components)};
+        for (int c = 0; c < components; ++c)
+        {
+            const auto id       = static_cast<std::uint8_t>(c + 1);
+            const auto sampling = static_cast<std::uint8_t>(c == 0 ? (luma_h << 4) | luma_v : 0x11);
+            frame.insert(frame.end(), {id, sampling, 0x00});
+        }
+        segment(0xC0, frame);
+
+        Bytes dc_table(17U, 0U);
+        dc_table[4] = 12U;  // twelve 4-bit codes: code n is category n
+        for (std::uint8_t category = 0U; category < 12U; ++category)
+        {
+            dc_table.push_back(category);
+        }
+        segment(0xC4, dc_table);
+        Bytes ac_table(17U, 0U);
+        ac_table[0] = 0x10U;  // AC table 0
+        ac_table[1] = 1U;     // EOB, the only symbol, is "0"
+        ac_table.push_back(0x00U);
+        segment(0xC4, ac_table);
+
+        if (spec.restart_interval != 0U)
+        {
+            segment(0xDD,
+                    {static_cast<std::uint8_t>(spec.restart_interval >> 8),
+                     static_cast<std::uint8_t>(spec.restart_interval)});
+        }
+
+        Bytes scan = {static_cast<std::uint8_t>(components)};
+        for (int c = 0; c < components; ++c)
+        {
+            scan.insert(scan.end(), {static_cast<std::uint8_t>(c + 1), 0x00});
+        }
+        scan.insert(scan.end(), {0, 63, 0});
+        segment(0xDA, scan);
+
+        JpegBitWriter       bits(out);
+        const std::uint32_t mcu_width  = 8U * luma_h;
+        const std::uint32_t mcu_height = 8U * luma_v;
+        const std::uint32_t mcus_x     = (spec.width + mcu_width - 1U) / mcu_width;
+        const std::uint32_t mcus_y     = (spec.height + mcu_height - 1U) / mcu_height;
+
+        int           predictions[3] = {0, 0, 0};
+        std::uint32_t restarts       = 0U;
+        for (std::uint32_t mcu = 0U; mcu < mcus_x * mcus_y; ++mcu)
+        {
+            if (spec.restart_interval != 0U && mcu > 0U && mcu % spec.restart_interval == 0U)
+            {
+                bits.Flush();
+                out.insert(out.end(), {0xFF, static_cast<std::uint8_t>(0xD0U + (restarts++ & 7U))});
+                predictions[0] = predictions[1] = predictions[2] = 0;
+            }
+
+            const Rgb    rgb = colour((mcu % mcus_x) * mcu_width, (mcu / mcus_x) * mcu_height);
+            const double y   = 0.299 * rgb.r + 0.587 * rgb.g + 0.114 * rgb.b;
+
+            const double levels[3] = {y, (rgb.b - y) / 1.772 + 128.0, (rgb.r - y) / 1.402 + 128.0};
+            for (int c = 0; c < components; ++c)
+            {
+                const int blocks = c == 0 ? luma_h * luma_v : 1;
+                for (int block = 0; block < blocks; ++block)
+                {
+                    // A flat block's DC coefficient is eight times its level shift
+                    const int dc   = static_cast<int>(std::lround(8.0 * (levels[c] - 128.0)));
+                    const int diff = dc - predictions[c];
+                    predictions[c] = dc;
+
+                    int category = 0;
+                    while ((std::abs(diff) >> category) != 0)
+                    {
+                        category++;
+                    }
+                    bits.Put(static_cast<std::uint32_t>(category), 4);
+                    if (category > 0)
+                    {
+                        const int magnitude = diff < 0 ? diff + (1 << category) - 1 : diff;
+                        bits.Put(static_cast<std::uint32_t>(magnitude), category);
+                    }
+                    bits.Put(0U, 1);  // EOB
+                }
+            }
+        }
+        bits.Flush();
+        out.insert(out.end(), {0xFF, 0xD9});
+        return out;
+    }
+
+    Bytes QuadrantJpeg(std::uint32_t size, std::uint16_t restart_interval = 0U)
+    {
+        FlatJpegSpec spec;
+        spec.width            = size;
+        spec.height           = size;
+        spec.luma_h           = 2U;  // 4:2:0, what cameras and cover art mostly use
+        spec.luma_v           = 2U;
+        spec.restart_interval = restart_interval;
+        return FlatJpeg(spec, [size](std::uint32_t x, std::uint32_t y) {
+            return Quadrant(x, y, size, size);
+        });
+    }
+
+    TEST(ImageDecoderTest, JpegIsReducedInTheDctThenBoxFiltered)
+    {
+        const Bytes jpeg = QuadrantJpeg(64U);
+
+        ScaledImage     half;
+        ImageDecodeInfo info;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(jpeg, 32U, 32U, half, &info));
+        EXPECT_EQ(ImageFormat::kJpeg, info.format);
+        EXPECT_EQ(64U, info.source_width);
+        EXPECT_EQ(64U, info.source_height);
+        EXPECT_EQ(2U, info.block_scale);
+        ASSERT_EQ(32U, half.width);
+        ASSERT_EQ(32U, half.height);
+        ASSERT_EQ(32U * 32U, half.pixels.size());
+        ExpectPixel(half, 8U, 8U, kRed, 8);
+        ExpectPixel(half, 24U, 8U, kGreen, 8);
+        ExpectPixel(half, 8U, 24U, kBlue, 8);
+        ExpectPixel(half, 24U, 24U, kWhite, 8);
+
+        // An eighth is the DC coefficient alone
+        ScaledImage eighth;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(jpeg, 8U, 8U, eighth, &info));
+        EXPECT_EQ(8U, info.block_scale);
+        ASSERT_EQ(8U, eighth.width);
+        ExpectPixel(eighth, 1U, 1U, kRed, 8);
+        ExpectPixel(eighth, 6U, 1U, kGreen, 8);
+        ExpectPixel(eighth, 1U, 6U, kBlue, 8);
+        ExpectPixel(eighth, 6U, 6U, kWhite, 8);
+    }
+
+    TEST(ImageDecoderTest, JpegIsCroppedToTheCardShape)
+    {
+        // Blue, green and red bands of 32, 64 and 32 columns
+        FlatJpegSpec spec;
+        spec.width       = 128U;
+        spec.height      = 64U;
+        const Bytes jpeg = FlatJpeg(spec, [](std::uint32_t x, std::uint32_t) {
+            return x < 32U ? kBlue : (x < 96U ? kGreen : kRed);
+        });
+
+        ScaledImage square;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(jpeg, 32U, 32U, square));
+        ASSERT_EQ(32U, square.width);
+        ASSERT_EQ(32U, square.height);
+        for (std::uint32_t x = 0U; x < square.width; x += 7U)
+        {
+            ExpectPixel(square, x, 16U, kGreen, 8);  // only the middle band is left
+        }
+
+        ScaledImage     wide;
+        ImageDecodeInfo info;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(jpeg, 64U, 16U, wide, &info));
+        ASSERT_EQ(64U, wide.width);
+        ASSERT_EQ(16U, wide.height);
+        EXPECT_EQ(2U, info.block_scale);
+        ExpectPixel(wide, 4U, 8U, kBlue, 8);
+        ExpectPixel(wide, 32U, 8U, kGreen, 8);
+        ExpectPixel(wide, 60U, 8U, kRed, 8);
+    }
+
+    TEST(ImageDecoderTest, SmallImagesAreNeverScaledUp)
+    {
+        FlatJpegSpec spec;
+        spec.width       = 20U;  // partial MCUs on both edges
+        spec.height      = 12U;
+        spec.gray        = true;
+        const Rgb   gray = {128, 128, 128};
+        const Bytes jpeg = FlatJpeg(spec, [gray](std::uint32_t, std::uint32_t) { return gray; });
+
+        ScaledImage     out;
+        ImageDecodeInfo info;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(jpeg, 240U, 240U, out, &info));
+        EXPECT_EQ(1U, info.block_scale);
+        ASSERT_EQ(12U, out.width);  // the largest square, at its own size
+        ASSERT_EQ(12U, out.height);
+        ExpectPixel(out, 0U, 0U, gray, 4);
+        ExpectPixel(out, 11U, 11U, gray, 4);
+    }
+
+    TEST(ImageDecoderTest, JpegRestartIntervalsDecodeTheSame)
+    {
+        ScaledImage plain;
+        ASSERT_EQ(ImageDecodeResult::kOk, Decode(QuadrantJpeg(64U), 32U, 32U, plain));
+        for (const std::uint16_t interval : {1U, 3U})
+        {
+            ScaledImage restarted;
+            ASSERT_EQ(ImageDecodeResult::kOk,
+                      Decode(QuadrantJpeg(64U, interval), 32U, 32U, restarted));
+            EXPECT_EQ(plain.pixels, restarted.pixels) << "interval " << interval;
+        }
+    }
+
+    TEST(ImageDecoderTest, BadInputIsReportedNotDecoded)
+    {
+        ScaledImage out;
+        EXPECT_EQ(ImageDecodeResult::kTruncated, Decode({}, 32U, 32U, out));
+        EXPECT_EQ(ImageDecodeResult::kUnknownFormat,
+                  Decode({'G', 'I', 'F', '8', '9', 'a', 1, 0}, 32U, 32U, out));
+
+        const Bytes jpeg = QuadrantJpeg(64U);
+        EXPECT_EQ(ImageDecodeResult::kTruncated,
+                  Decode(Bytes(jpeg.begin(), jpeg.begin() + jpeg.size() / 2U), 32U, 32U, out));
+        EXPECT_EQ(ImageDecodeResult::kCorrupt, Decode({0xFF, 0xD8, 0xFF, 0xD9}, 32U, 32U, out));
+
+        // Progressive, 16x16 gray: refused at the frame header
+        const Bytes progressive = {0xFF, 0xD8, 0xFF, 0xC2, 0x00, 0x0B, 0x08, 0x00,
+                                   0x10, 0x00, 0x10, 0x01, 0x01, 0x11, 0x00};
+        EXPECT_EQ(ImageDecodeResult::kUnsupported, Decode(progressive, 32U, 32U, out));
+
+        // 60000 x 60000 is refused before anything is allocated for it
+        const Bytes huge = {0xFF, 0xD8, 0xFF, 0xC0, 0x00, 0x0B, 0x08, 0xEA,
+                            0x60, 0xEA, 0x60, 0x01, 0x01, 0x11, 0x00};
+        EXPECT_EQ(ImageDecodeResult::kTooLarge, Decode(huge, 32U, 32U, out));
+    }
+
+    /* ---- PNG ---- */
+
+    std::uint32_t Crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0U)
+    {
+        crc = ~crc;
+        for (std::size_t i = 0U; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+        }
+        return ~crc;
+    }
+
+    void PutBe32(Bytes& out, std::uint32_t value)
+    {
+        out.insert(out.end(),
+                   {static_cast<std::uint8_t>(value >> 24),
+                    static_cast<std::uint8_t>(value >> 16),
+                    static_cast<std::uint8_t>(value >> 8),
+                    static_cast<std::uint8_t>(value)});
+    }
+
+    void PutChunk(Bytes& out, const char* type, const Bytes& body)
+    {
+        PutBe32(out, static_cast<std::uint32_t>(body.size()));
+        const std::size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), body.begin(), body.end());
+        PutBe32(out, Crc32(out.data() + start, out.size() - start));
+    }
+
+    struct PngSpec
+    {
+        std::uint32_t width      = 0U;
+        std::uint32_t height     = 0U;
+        std::uint8_t  depth      = 8U;
+        std::uint8_t  color_type = 2U;
+        Bytes         palette;  // PLTE
+        Bytes         alpha;    // tRNS
+        bool          interlaced = false;
+    };
+
+    /**
+     * PNG of @p rows (packed, unfiltered) in stored deflate blocks. Row y is filtered with
+     * filter y % 5, and the zlib stream is split over two IDAT chunks.
+     */
+    Bytes StoredPng(const PngSpec& spec, const Bytes& rows)
+    {
+        static const int kChannels[] = {1, 0, 3, 1, 2, 0, 4};  // by colour type
+
+        const std::size_t row_bytes =
+            (static_cast<std::size_t>(spec.width) * kChannels[spec.color_type] * spec.depth + 7U)
+            / 8U;
+        const std::size_t pixel_bytes =
+            std::max<std::size_t>(1U, kChannels[spec.color_type] * spec.depth / 8U);
+
+        Bytes filtered;
+        for (std::uint32_t y = 0U; y < spec.height; ++y)
+        {
+            const std::uint8_t* row   = rows.data() + y * row_bytes;
+            const std::uint8_t* prior = y > 0U ? row - row_bytes : nullptr;
+            const int           type  = static_cast<int>(y % 5U);
+            filtered.push_back(static_cast<std::uint8_t>(type));
+            for (std::size_t i = 0U; i < row_bytes; ++i)
+            {
+                const int a = i >= pixel_bytes ? row[i - pixel_bytes] : 0;
+                const int b = prior != nullptr ? prior[i] : 0;
+                const int c = prior != nullptr && i >= pixel_bytes ? prior[i - pixel_bytes] : 0;
+
+                int predicted = 0;
+                if (type == 1)
+                {
+                    predicted = a;
+                }
+                else if (type == 2)
+                {
+                    predicted = b;
+                }
+                else if (type == 3)
+                {
+                    predicted = (a + b) / 2;
+                }
+                else if (type == 4)
+                {
+                    const int pa = std::abs(b - c);
+                    const int pb = std::abs(a - c);
+                    const int pc = std::abs(a + b - 2 * c);
+                    predicted    = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                }
+                filtered.push_back(static_cast<std::uint8_t>(row[i] - predicted));
+            }
+        }
+
+        Bytes         zlib    = {0x78, 0x01};
+        std::uint32_t adler_a = 1U;
+        std::uint32_t adler_b = 0U;
+        for (std::size_t offset = 0U; offset < filtered.size(); offset += 65535U)
+        {
+            const std::size_t length = std::min<std::size_t>(65535U, filtered.size() - offset);
+            const bool        last   = offset + length == filtered.size();
+            zlib.insert(zlib.end(),
+                        {static_cast<std::uint8_t>(last ? 1U : 0U),
+                         static_cast<std::uint8_t>(length),
+                         static_cast<std::uint8_t>(length >> 8),
+                         static_cast<std::uint8_t>(~length),
+                         static_cast<std::uint8_t>(~length >> 8)});
+            zlib.insert(zlib.end(), filtered.begin() + offset, filtered.begin() + offset + length);
+        }
+        for (const std::uint8_t byte : filtered)
+        {
+            adler_a = (adler_a + byte) % 65521U;
+            adler_b = (adler_b + adler_a) % 65521U;
+        }
+        PutBe32(zlib, (adler_b << 16) | adler_a);
+
+        Bytes png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        Bytes header;
+        PutBe32(header, spec.width);
+        PutBe32(header, spec.height);
+        const auto interlace = static_cast<std::uint8_t>(spec.interlaced ? 1U : 0U);
+        header.insert(header.end(), {spec.depth, spec.color_type, 0, 0, interlace});
+        PutChunk(png, "IHDR", header);
+        if (!spec.palette.empty())
+        {
+            PutChunk(png, "PLTE", spec.palette);
+        }
+        if (!spec.alpha.empty())
+        {
+            PutChunk(png, "tRNS", spec.alpha);
+        }
+        const std::size_t split = zlib.size() / 2U;
+        PutChunk(png, "IDAT", Bytes(zlib.begin(), zlib.begin() + split));
+        PutChunk(png, "IDAT", Bytes(zlib.begin() + split, zlib.end()));
+        PutChunk(png, "IEND", {});
+        return png;
+    }
+
+    Bytes QuadrantRows(std::uint32_t size, bool with_alpha)
+    {
+        Bytes rows;
+        for (std::uint32_t y = 0U; y < size; ++y)
+        {
+            for (std::uint32_t x = 0U; x < size; ++x)
+            {
+                const Rgb rgb = Quadrant(x, y, size, size);
+                rows.insert(rows.end(), {rgb.r, rgb.g, rgb.b});
+                if (with_alpha)
+                {
+                    rows.push_back(x % 2U == 0U ? 255U : 0U);
+                }
+            }
+        }
+        return rows;
+    }
+
+    // 16x16 RGB quadrants, rows filtered y % 5, from zlib with Z_FIXED and Z_RLE
+    constexpr std::uint8_t kFixedHuffmanPng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10,
+        0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x91, 0x68, 0x36, 0x00, 0x00, 0x00,
+        0x66, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x63, 0xB8, 0x23, 0xA7, 0x81,
+        0x15, 0xC9, 0x9D, 0xB0, 0xC1, 0x8A, 0x18, 0x81, 0x72, 0x0C, 0xD8, 0x80,
+        0xD3, 0x2A, 0x11, 0xAC, 0xE2, 0x4C, 0x0C, 0x24, 0x02, 0xE6, 0x3C, 0x7E,
+        0xEC, 0x26, 0x2D, 0x0C, 0xE5, 0xC2, 0x2A, 0xCE, 0x42, 0xAA, 0x0D, 0x0C,
+        0x83, 0xD0, 0xD3, 0xBB, 0x94, 0xF7, 0x2D, 0xE3, 0x0A, 0xC5, 0x44, 0xD7,
+        0x6B, 0x8B, 0xF3, 0x24, 0xE3, 0x31, 0x11, 0xE9, 0x9E, 0xD6, 0x30, 0xBA,
+        0x84, 0x15, 0xFD, 0xC2, 0x01, 0x18, 0x81, 0x72, 0x58, 0x0D, 0xBA, 0x74,
+        0x42, 0x83, 0x4A, 0x9E, 0x16, 0x91, 0xCC, 0xC4, 0x2A, 0x91, 0x99, 0x22,
+        0x42, 0xA5, 0x98, 0x26, 0xD5, 0xD3, 0x00, 0x2C, 0x71, 0x81, 0x08, 0x97,
+        0x37, 0xD5, 0x53, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE,
+        0x42, 0x60, 0x82,
+    };
+
+    constexpr std::uint8_t kDynamicHuffmanPng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10,
+        0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x91, 0x68, 0x36, 0x00, 0x00, 0x00,
+        0xD2, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x95, 0xC1, 0xA1, 0x61, 0x03,
+        0x31, 0x0C, 0x05, 0x50, 0xE5, 0x72, 0xC8, 0xA4, 0xE4, 0x88, 0xC9, 0x27,
+        0x25, 0x1F, 0x0B, 0x0B, 0x65, 0x07, 0x63, 0x93, 0x92, 0x10, 0x93, 0xE2,
+        0x0E, 0x53, 0x62, 0x90, 0x11, 0x0A, 0x8A, 0x85, 0x45, 0x4A, 0x34, 0x49,
+        0x50, 0x17, 0x70, 0xC0, 0xBD, 0x27, 0x09, 0x26, 0x98, 0x60, 0x82, 0x09,
+        0x26, 0x98, 0x60, 0x82, 0x70, 0x83, 0x1B, 0xDC, 0xE0, 0x06, 0x37, 0xB8,
+        0xC1, 0x0D, 0x6E, 0x97, 0x04, 0x65, 0xE5, 0xF6, 0x38, 0x64, 0x65, 0x93,
+        0x93, 0xAE, 0xE3, 0xED, 0x90, 0x95, 0xEF, 0x56, 0x64, 0x65, 0x97, 0xB3,
+        0x12, 0x4C, 0x30, 0xC1, 0x04, 0x13, 0x4C, 0x30, 0xC1, 0x04, 0xE1, 0x06,
+        0x37, 0xB8, 0xC1, 0x0D, 0x6E, 0x70, 0x83, 0x1B, 0xDC, 0x2E, 0x09, 0xCA,
+        0xCA, 0xED, 0x71, 0xC8, 0xCA, 0x26, 0x27, 0x5D, 0x7F, 0xDE, 0x7F, 0x67,
+        0x69, 0xB3, 0xB4, 0x59, 0xDA, 0x2C, 0x6D, 0x96, 0x36, 0x4B, 0x9B, 0xA5,
+        0xFD, 0x7D, 0x7D, 0x8E, 0xDA, 0x47, 0xED, 0xA3, 0xF6, 0x51, 0xFB, 0xA8,
+        0x7D, 0xD4, 0x3E, 0x6A, 0xDF, 0xE5, 0x2C, 0x6A, 0x50, 0x83, 0x1A, 0xD4,
+        0xA0, 0x06, 0x35, 0xA8, 0x41, 0x8D, 0xE7, 0x0B, 0x17, 0x6A, 0xC8, 0x4A,
+        0x38, 0x65, 0x65, 0x93, 0x93, 0xAE, 0x47, 0xBD, 0xCB, 0xCA, 0xFD, 0xE3,
+        0x90, 0x95, 0x5D, 0xCE, 0xA2, 0x06, 0x35, 0xA8, 0x41, 0x0D, 0x6A, 0x50,
+        0x83, 0x1A, 0xD4, 0x78, 0xBE, 0xF0, 0x0F, 0x2C, 0x71, 0x81, 0x08, 0x15,
+        0x70, 0x12, 0x61, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE,
+        0x42, 0x60, 0x82,
+    };
+
+    void ExpectQuadrants(const ScaledImage& image)
+    {
+        ASSERT_EQ(8U, image.width);
+        ASSERT_EQ(8U, image.height);
+        ExpectPixel(image, 1U, 1U, kRed, 0);
+        ExpectPixel(image, 6U, 1U, kGreen, 0);
+        ExpectPixel(image, 1U, 6U, kBlue, 0);
+        ExpectPixel(image, 6U, 6U, kWhite, 0);
+    }
+
+    TEST(ImageDecoderTest, PngAllFiltersAndBlockTypes)
+    {
+        PngSpec spec;
+        spec.width  = 16U;
+        spec.height = 16U;
+
+        ScaledImage     stored;
+        ImageDecodeInfo info;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(StoredPng(spec, QuadrantRows(16U, false)), 8U, 8U, stored, &info));
+        EXPECT_EQ(ImageFormat::kPng, info.format);
+        EXPECT_EQ(16U, info.source_width);
+        ExpectQuadrants(stored);
+
+        ScaledImage fixed;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(Bytes(std::begin(kFixedHuffmanPng), std::end(kFixedHuffmanPng)),
+                         8U,
+                         8U,
+                         fixed));
+        EXPECT_EQ(stored.pixels, fixed.pixels);
+
+        ScaledImage dynamic;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(Bytes(std::begin(kDynamicHuffmanPng), std::end(kDynamicHuffmanPng)),
+                         8U,
+                         8U,
+                         dynamic));
+        EXPECT_EQ(stored.pixels, dynamic.pixels);
+    }
+
+    TEST(ImageDecoderTest, ReadingInSmallPiecesDecodesTheSame)
+    {
+        PngSpec spec;
+        spec.width       = 16U;
+        spec.height      = 16U;
+        const Bytes png  = StoredPng(spec, QuadrantRows(16U, false));
+        const Bytes jpeg = QuadrantJpeg(64U);
+
+        ImageScaleOptions options;
+        options.width  = 8U;
+        options.height = 8U;
+        for (const Bytes* data : {&png, &jpeg})
+        {
+            ScaledImage whole;
+            ScaledImage trickled;
+            ASSERT_EQ(ImageDecodeResult::kOk, DecodeImageScaled(ReaderOver(*data), options, whole));
+            ASSERT_EQ(ImageDecodeResult::kOk,
+                      DecodeImageScaled(ReaderOver(*data, 1U), options, trickled));
+            EXPECT_EQ(whole.pixels, trickled.pixels);
+        }
+    }
+
+    TEST(ImageDecoderTest, PngTransparencyShowsTheBackground)
+    {
+        // Every other column is transparent: half the colour, half the background
+        PngSpec rgba;
+        rgba.width      = 16U;
+        rgba.height     = 16U;
+        rgba.color_type = 6U;
+        ScaledImage blended;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(StoredPng(rgba, QuadrantRows(16U, true)), 8U, 8U, blended, nullptr,
+                         0x000000U));
+        ExpectPixel(blended, 1U, 1U, {110, 15, 20}, 8);
+
+        // Palette index 1 is fully transparent through tRNS
+        PngSpec palette;
+        palette.width      = 4U;
+        palette.height     = 4U;
+        palette.depth      = 2U;
+        palette.color_type = 3U;
+        palette.palette    = {255, 0, 0, 0, 255, 0};
+        palette.alpha      = {255, 0};
+        const Bytes rows   = {0x00, 0x00, 0x55, 0x55};  // two rows of index 0, two of 1
+        ScaledImage indexed;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(StoredPng(palette, rows), 2U, 2U, indexed, nullptr, 0x0000FFU));
+        ExpectPixel(indexed, 0U, 0U, {255, 0, 0}, 0);
+        ExpectPixel(indexed, 0U, 1U, {0, 0, 255}, 0);
+    }
+
+    TEST(ImageDecoderTest, PngGrayDepths)
+    {
+        // 1-bit columns alternating black and white average to mid gray
+        PngSpec bits;
+        bits.width      = 16U;
+        bits.height     = 2U;
+        bits.depth      = 1U;
+        bits.color_type = 0U;
+        ScaledImage mixed;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(StoredPng(bits, {0x55, 0x55, 0x55, 0x55}), 8U, 1U, mixed));
+        ASSERT_EQ(8U, mixed.width);
+        ExpectPixel(mixed, 3U, 0U, {128, 128, 128}, 0);
+
+        // 16-bit samples keep their high byte
+        PngSpec deep;
+        deep.width      = 2U;
+        deep.height     = 2U;
+        deep.depth      = 16U;
+        deep.color_type = 0U;
+        ScaledImage gray;
+        ASSERT_EQ(ImageDecodeResult::kOk,
+                  Decode(StoredPng(deep, Bytes(8U, 0xAB)), 2U, 2U, gray));
+        ExpectPixel(gray, 1U, 1U, {0xAB, 0xAB, 0xAB}, 0);
+    }
+
+    TEST(ImageDecoderTest, PngThatCannotBeStreamedIsRefused)
+    {
+        PngSpec spec;
+        spec.width       = 16U;
+        spec.height      = 16U;
+        const Bytes rows = QuadrantRows(16U, false);
+
+        ScaledImage out;
+        const Bytes png = StoredPng(spec, rows);
+        EXPECT_EQ(ImageDecodeResult::kTruncated,
+                  Decode(Bytes(png.begin(), png.begin() + png.size() * 3U / 5U), 8U, 8U, out));
+
+        spec.interlaced = true;
+        EXPECT_EQ(ImageDecodeResult::kUnsupported, Decode(StoredPng(spec, rows), 8U, 8U, out));
+    }
+
+}  // namespace
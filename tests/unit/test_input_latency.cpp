@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "platform/input/input_latency.h"
+
+namespace
+{
+
+    using custom::platform::InputLatencySnapshot;
+    using custom::platform::InputLatencyTracker;
+    using custom::platform::LatencyHistogram;
+    using custom::platform::LatencyPercentiles;
+
+    InputLatencyTracker MakeTracker(std::uint64_t* now_us)
+    {
+        InputLatencyTracker::Config config;
+        config.frame_timeout_us = 100000U;
+        config.clock            = [now_us]() { return *now_us; };
+        return InputLatencyTracker(config);
+    }
+
+    TEST(LatencyHistogramTest, ReportsBucketUpperEdges)
+    {
+        LatencyHistogram histogram(1000U, 50U);
+        for (std::uint32_t i = 1; i <= 100U; ++i)
+        {
+            histogram.Record(i * 100U);  // 0.1 ms ... 10 ms
+        }
+
+        const LatencyPercentiles summary = histogram.Summary();
+        EXPECT_EQ(100U, summary.count);
+        EXPECT_EQ(100U, summary.min_us);
+        EXPECT_EQ(10000U, summary.max_us);
+        EXPECT_EQ(5050U, summary.avg_us);
+        EXPECT_EQ(6000U, summary.p50_us);
+        EXPECT_EQ(10000U, summary.p95_us);
+        EXPECT_EQ(10000U, summary.p99_us);
+    }
+
+    TEST(LatencyHistogramTest, OverflowReportsTheMaximum)
+    {
+        LatencyHistogram histogram(1000U, 4U);
+        histogram.Record(500U);
+        histogram.Record(250000U);
+
+        const LatencyPercentiles summary = histogram.Summary();
+        EXPECT_EQ(1000U, summary.p50_us);
+        EXPECT_EQ(250000U, summary.p99_us);
+
+        histogram.Reset();
+        EXPECT_EQ(0U, histogram.Summary().count);
+        EXPECT_EQ(0U, histogram.Summary().min_us);
+    }
+
+    TEST(InputLatencyTrackerTest, TimesAPressToTheFrameThatDrewIt)
+    {
+        std::uint64_t       now     = 1000U;
+        InputLatencyTracker tracker = MakeTracker(&now);
+
+        tracker.OnIndevRead(false);
+        now += 5000U;
+        tracker.OnIndevRead(true);  // press sampled here
+        now += 300U;
+        tracker.OnPressDispatched();
+
+        // A refresh with nothing to draw does not count as the reaction
+        now += 2000U;
+        tracker.OnRefreshReady();
+        now += 14000U;
+        tracker.OnRenderStart();
+        now += 4000U;
+        tracker.OnRefreshReady();
+
+        const InputLatencySnapshot snapshot = tracker.Snapshot();
+        EXPECT_EQ(1U, snapshot.presses);
+        EXPECT_EQ(0U, snapshot.no_frame);
+        EXPECT_EQ(5000U, snapshot.read_interval.max_us);
+        EXPECT_EQ(300U, snapshot.read_to_dispatch.max_us);
+        EXPECT_EQ(20000U, snapshot.dispatch_to_frame.max_us);
+        EXPECT_EQ(20300U, snapshot.read_to_frame.max_us);
+    }
+
+    TEST(InputLatencyTrackerTest, OnlyTheFirstReadOfAPressStartsTheClock)
+    {
+        std::uint64_t       now     = 1U;
+        InputLatencyTracker tracker = MakeTracker(&now);
+
+        tracker.OnIndevRead(true);
+        now += 5000U;
+        tracker.OnIndevRead(true);  // still held
+        tracker.OnPressDispatched();
+        tracker.OnRenderStart();
+        now += 1000U;
+        tracker.OnRefreshReady();
+
+        const InputLatencySnapshot snapshot = tracker.Snapshot();
+        EXPECT_EQ(5000U, snapshot.read_to_dispatch.max_us);
+        EXPECT_EQ(6000U, snapshot.read_to_frame.max_us);
+    }
+
+    TEST(InputLatencyTrackerTest, CountsPressesThatNeverRedraw)
+    {
+        std::uint64_t       now     = 1U;
+        InputLatencyTracker tracker = MakeTracker(&now);
+
+        tracker.OnIndevRead(true);
+        tracker.OnPressDispatched();
+        now += 150000U;
+        tracker.OnRefreshReady();  // past the timeout, nothing rendered
+
+        // A dispatch that did not come from a timed read still gets a dispatch->frame sample
+        tracker.OnPressDispatched();
+        tracker.OnRenderStart();
+        now += 8000U;
+        tracker.OnRefreshReady();
+
+        const InputLatencySnapshot snapshot = tracker.Snapshot();
+        EXPECT_EQ(2U, snapshot.presses);
+        EXPECT_EQ(1U, snapshot.no_frame);
+        EXPECT_EQ(1U, snapshot.dispatch_to_frame.count);
+        EXPECT_EQ(0U, snapshot.read_to_frame.count);
+
+        tracker.Reset();
+        EXPECT_EQ(0U, tracker.Snapshot().presses);
+    }
+
+}  // namespace
@@ -0,0 +1,428 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "platform/modbus/modbus_crc.h"
+#include "platform/modbus/modbus_master.h"
+#include "platform/modbus/modbus_poller.h"
+#include "platform/modbus/modbus_serial_transport.h"
+#include "platform/modbus/modbus_slave_sim.h"
+
+#if CUSTOM_PLATFORM_HAS_TERMIOS
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <stdlib.h>
+#    include <unistd.h>
+#endif
+
+namespace
+{
+
+    using custom::platform::LoopbackModbusTransport;
+    using custom::platform::ModbusAppendCrc;
+    using custom::platform::ModbusBuildRead;
+    using custom::platform::ModbusBuildWriteMultiple;
+    using custom::platform::ModbusCheckCrc;
+    using custom::platform::ModbusCrc16;
+    using custom::platform::ModbusFunction;
+    using custom::platform::ModbusMaster;
+    using custom::platform::ModbusPoller;
+    using custom::platform::ModbusRequest;
+    using custom::platform::ModbusResult;
+    using custom::platform::ModbusSlaveSim;
+    using custom::platform::ModbusStatus;
+    using custom::platform::ModbusTiming;
+    using custom::platform::ModbusTimingForBaud;
+    using custom::platform::kModbusMaxFrame;
+
+    std::uint16_t BitwiseCrc(const std::uint8_t* data, std::size_t length)
+    {
+        std::uint16_t crc = 0xFFFFU;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1U) ? static_cast<std::uint16_t>((crc >> 1) ^ 0xA001U)
+                                 : static_cast<std::uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    // Master and simulated bus sharing one virtual microsecond clock
+    struct SimBus
+    {
+        std::uint64_t           now_us = 1000U;
+        LoopbackModbusTransport transport{115200U, &now_us};
+        ModbusMaster            master;
+
+        explicit SimBus(std::uint8_t retries = 1U)
+            : master(transport, MakeConfig(retries))
+        {
+        }
+
+        ModbusMaster::Config MakeConfig(std::uint8_t retries)
+        {
+            ModbusMaster::Config config;
+            config.baud     = 115200U;
+            config.retries  = retries;
+            config.clock    = [this]() { return now_us; };
+            config.sleep_us = [this](std::uint64_t us) { now_us += us; };
+            return config;
+        }
+
+        // Drive the poller like the bus task does, until the virtual clock reaches end_us
+        void RunUntil(ModbusPoller& poller, std::uint64_t end_us)
+        {
+            while (now_us < end_us)
+            {
+                now_us += static_cast<std::uint64_t>(poller.RunOnce().count());
+            }
+        }
+    };
+
+    TEST(ModbusCrcTest, MatchesBitwiseReference)
+    {
+        const std::uint8_t request[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+        EXPECT_EQ(0xCDC5U, ModbusCrc16(request, sizeof(request)));
+
+        std::vector<std::uint8_t> data(257U);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::uint8_t>(i * 37U + 11U);
+        }
+        for (std::size_t length : {0U, 1U, 2U, 7U, 8U, 255U, 257U})
+        {
+            EXPECT_EQ(BitwiseCrc(data.data(), length), ModbusCrc16(data.data(), length)) << length;
+        }
+
+        // Continuing over a split buffer gives the same result, odd split included
+        const std::uint16_t head = ModbusCrc16(data.data(), 101U);
+        EXPECT_EQ(ModbusCrc16(data.data(), data.size()),
+                  ModbusCrc16(data.data() + 101U, data.size() - 101U, head));
+    }
+
+    TEST(ModbusCrcTest, AppendAndCheck)
+    {
+        std::uint8_t frame[8] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+        EXPECT_EQ(8U, ModbusAppendCrc(frame, 6U));
+        EXPECT_EQ(0xC5U, frame[6]);
+        EXPECT_EQ(0xCDU, frame[7]);
+        EXPECT_TRUE(ModbusCheckCrc(frame, 8U));
+        frame[3] ^= 0x01U;
+        EXPECT_FALSE(ModbusCheckCrc(frame, 8U));
+        EXPECT_FALSE(ModbusCheckCrc(frame, 2U));
+    }
+
+    TEST(ModbusRequestTest, EncodesOnceAndRejectsBadArguments)
+    {
+        ModbusRequest request;
+        ASSERT_TRUE(
+            ModbusBuildRead(request, 0x11U, ModbusFunction::kReadHoldingRegisters, 0x006BU, 3U));
+        const std::uint8_t expected[] = {0x11, 0x03, 0x00, 0x6B, 0x00, 0x03, 0x76, 0x87};
+        ASSERT_EQ(sizeof(expected), request.length);
+        EXPECT_EQ(0, std::memcmp(expected, request.frame, sizeof(expected)));
+        EXPECT_EQ(11U, request.response_length);
+
+        EXPECT_FALSE(ModbusBuildRead(request, 0U, ModbusFunction::kReadInputRegisters, 0U, 1U));
+        EXPECT_FALSE(ModbusBuildRead(request, 1U, ModbusFunction::kReadInputRegisters, 0U, 126U));
+        EXPECT_FALSE(
+            ModbusBuildRead(request, 1U, ModbusFunction::kReadInputRegisters, 0xFFFFU, 2U));
+        EXPECT_FALSE(ModbusBuildRead(request, 1U, ModbusFunction::kWriteSingleRegister, 0U, 1U));
+
+        const std::uint16_t values[2] = {0x000AU, 0x0102U};
+        ASSERT_TRUE(ModbusBuildWriteMultiple(request, 0x11U, 0x0001U, 2U, values));
+        const std::uint8_t write[] = {0x11, 0x10, 0x00, 0x01, 0x00, 0x02, 0x04,
+                                      0x00, 0x0A, 0x01, 0x02, 0xC6, 0xF0};
+        ASSERT_EQ(sizeof(write), request.length);
+        EXPECT_EQ(0, std::memcmp(write, request.frame, sizeof(write)));
+        EXPECT_EQ(8U, request.response_length);
+    }
+
+    TEST(ModbusTimingTest, FollowsTheSpec)
+    {
+        const ModbusTiming slow = ModbusTimingForBaud(9600U);
+        EXPECT_EQ(1146U, slow.char_us);
+        EXPECT_EQ(4011U, slow.t35_us);
+        const ModbusTiming fast = ModbusTimingForBaud(115200U);
+        EXPECT_EQ(96U, fast.char_us);
+        EXPECT_EQ(750U, fast.t15_us);
+        EXPECT_EQ(1750U, fast.t35_us);
+    }
+
+    TEST(ModbusMasterTest, ReadsAndWritesThroughSimulatedDevice)
+    {
+        SimBus         bus;
+        ModbusSlaveSim meter(3U);
+        bus.transport.Attach(meter);
+        meter.SetHolding(10U, 0x1234U);
+        meter.SetHolding(11U, 0xBEEFU);
+        meter.SetInput(0U, 2301U);
+
+        std::uint16_t regs[2] = {};
+        ASSERT_TRUE(bus.master.ReadHoldingRegisters(3U, 10U, 2U, regs).Ok());
+        EXPECT_EQ(0x1234U, regs[0]);
+        EXPECT_EQ(0xBEEFU, regs[1]);
+        ASSERT_TRUE(bus.master.ReadInputRegisters(3U, 0U, 1U, regs).Ok());
+        EXPECT_EQ(2301U, regs[0]);
+
+        ASSERT_TRUE(bus.master.WriteSingleRegister(3U, 20U, 77U).Ok());
+        const std::uint16_t values[3] = {1U, 2U, 3U};
+        ASSERT_TRUE(bus.master.WriteMultipleRegisters(3U, 30U, 3U, values).Ok());
+        EXPECT_EQ(77U, meter.Holding(20U));
+        EXPECT_EQ(3U, meter.Holding(32U));
+
+        const ModbusMaster::Stats stats = bus.master.GetStats();
+        EXPECT_EQ(4U, stats.transactions);
+        EXPECT_EQ(4U, stats.ok);
+        EXPECT_EQ(0U, stats.retries);
+    }
+
+    TEST(ModbusMasterTest, ExceptionIsReportedWithoutRetry)
+    {
+        SimBus         bus;
+        ModbusSlaveSim device(1U, 16U);
+        bus.transport.Attach(device);
+
+        std::uint16_t      regs[4] = {};
+        const ModbusResult result  = bus.master.ReadHoldingRegisters(1U, 14U, 4U, regs);
+        EXPECT_EQ(ModbusStatus::kException, result.status);
+        EXPECT_EQ(0x02U, result.exception);
+        EXPECT_EQ(1U, device.RequestsHandled());
+        EXPECT_EQ(0U, bus.master.GetStats().retries);
+    }
+
+    TEST(ModbusMasterTest, RetriesLostAndCorruptedReplies)
+    {
+        SimBus         bus(2U);
+        ModbusSlaveSim device(1U);
+        bus.transport.Attach(device);
+        device.SetHolding(0U, 42U);
+
+        std::uint16_t value = 0U;
+        bus.transport.drop_replies    = 1U;
+        bus.transport.corrupt_replies = 1U;
+        ASSERT_TRUE(bus.master.ReadHoldingRegisters(1U, 0U, 1U, &value).Ok());
+        EXPECT_EQ(42U, value);
+
+        ModbusMaster::Stats stats = bus.master.GetStats();
+        EXPECT_EQ(1U, stats.timeouts);
+        EXPECT_EQ(1U, stats.crc_errors);
+        EXPECT_EQ(2U, stats.retries);
+
+        // Nobody at address 9: every attempt times out after the response timeout
+        const std::uint64_t before = bus.now_us;
+        EXPECT_EQ(ModbusStatus::kTimeout,
+                  bus.master.ReadHoldingRegisters(9U, 0U, 1U, &value).status);
+        EXPECT_GE(bus.now_us - before, 3U * 100000U);
+    }
+
+    TEST(ModbusMasterTest, BackToBackFramesKeepTheInterFrameGap)
+    {
+        SimBus         bus;
+        ModbusSlaveSim device(1U);
+        bus.transport.Attach(device);
+
+        std::uint16_t regs[8] = {};
+        for (int i = 0; i < 5; ++i)
+        {
+            ASSERT_TRUE(bus.master.ReadHoldingRegisters(1U, 0U, 8U, regs).Ok());
+        }
+
+        // Each request starts exactly t3.5 after the previous reply ended, not later
+        const auto&         starts = bus.transport.write_start_us;
+        const std::uint64_t reply  = bus.transport.turnaround_us
+                                    + (5U + 2U * 8U) * bus.master.Timing().char_us;
+        ASSERT_EQ(5U, starts.size());
+        for (std::size_t i = 1; i < starts.size(); ++i)
+        {
+            EXPECT_EQ(bus.transport.write_end_us[i - 1] + reply + 1750U, starts[i]);
+        }
+    }
+
+    TEST(ModbusPollerTest, MergesNeighbouringPollsIntoOneRequest)
+    {
+        SimBus         bus;
+        ModbusSlaveSim meter(1U);
+        bus.transport.Attach(meter);
+        for (std::uint16_t i = 0; i < 128U; ++i)
+        {
+            meter.SetHolding(i, static_cast<std::uint16_t>(i * 10U));
+        }
+
+        ModbusPoller               poller(bus.master);
+        std::vector<std::uint16_t> seen[4];
+        const std::uint16_t        starts[4] = {0U, 4U, 10U, 100U};
+        for (int i = 0; i < 4; ++i)
+        {
+            ModbusPoller::Poll poll;
+            poll.start   = starts[i];
+            poll.count   = 2U;
+            poll.on_data = [&seen, i](ModbusResult result, const std::uint16_t* regs,
+                                      std::uint16_t count) {
+                ASSERT_TRUE(result.Ok());
+                seen[i].assign(regs, regs + count);
+            };
+            ASSERT_NE(ModbusPoller::kInvalidPoll, poller.Add(poll));
+        }
+
+        poller.RunOnce();
+        EXPECT_EQ(1U, meter.RequestsHandled());
+        EXPECT_EQ((std::vector<std::uint16_t>{0U, 10U}), seen[0]);
+        EXPECT_EQ((std::vector<std::uint16_t>{40U, 50U}), seen[1]);
+        EXPECT_EQ((std::vector<std::uint16_t>{100U, 110U}), seen[2]);
+        EXPECT_TRUE(seen[3].empty());
+
+        // Register 100 is too far from the others and goes out on its own
+        poller.RunOnce();
+        EXPECT_EQ(2U, meter.RequestsHandled());
+        EXPECT_EQ((std::vector<std::uint16_t>{1000U, 1010U}), seen[3]);
+    }
+
+    TEST(ModbusPollerTest, EachPollKeepsItsOwnRate)
+    {
+        SimBus         bus;
+        ModbusSlaveSim meter(1U);
+        ModbusSlaveSim thermostat(2U);
+        bus.transport.Attach(meter);
+        bus.transport.Attach(thermostat);
+
+        ModbusPoller       poller(bus.master);
+        ModbusPoller::Poll fast;
+        fast.slave  = 1U;
+        fast.period = std::chrono::milliseconds(100);
+        ModbusPoller::Poll slow;
+        slow.slave  = 2U;
+        slow.period = std::chrono::milliseconds(1000);
+        const int fast_id = poller.Add(fast);
+        const int slow_id = poller.Add(slow);
+
+        bus.RunUntil(poller, 1000U + 2000000U);
+
+        ModbusPoller::PollStats stats;
+        ASSERT_TRUE(poller.GetPollStats(fast_id, stats));
+        EXPECT_EQ(20U, stats.runs);
+        EXPECT_LT(stats.max_late_us, 5000U);
+        ASSERT_TRUE(poller.GetPollStats(slow_id, stats));
+        EXPECT_EQ(2U, stats.runs);
+        EXPECT_EQ(22U, meter.RequestsHandled() + thermostat.RequestsHandled());
+    }
+
+    TEST(ModbusPollerTest, BacksOffAnUnresponsiveDevice)
+    {
+        SimBus             bus(0U);
+        ModbusPoller       poller(bus.master);
+        ModbusPoller::Poll poll;
+        poll.slave  = 9U;
+        poll.period = std::chrono::milliseconds(100);
+        std::vector<std::uint64_t> attempts;
+        poll.on_data = [&](ModbusResult result, const std::uint16_t* regs, std::uint16_t) {
+            EXPECT_EQ(ModbusStatus::kTimeout, result.status);
+            EXPECT_EQ(nullptr, regs);
+            attempts.push_back(bus.now_us);
+        };
+        const int id = poller.Add(poll);
+
+        bus.RunUntil(poller, 1000U + 10000000U);
+
+        // Without back-off a dead device is asked every 100 ms; with it, every 800 ms at most
+        ASSERT_GE(attempts.size(), 4U);
+        EXPECT_LT(attempts.size(), 20U);
+        EXPECT_GE(attempts.back() - attempts[attempts.size() - 2U], 800000U);
+
+        ModbusPoller::PollStats stats;
+        ASSERT_TRUE(poller.GetPollStats(id, stats));
+        EXPECT_EQ(stats.runs, stats.consecutive_failures);
+    }
+
+    TEST(ModbusPollerTest, QueuedWritesGoBeforePolls)
+    {
+        SimBus         bus;
+        ModbusSlaveSim device(1U);
+        bus.transport.Attach(device);
+
+        ModbusPoller       poller(bus.master);
+        ModbusPoller::Poll poll;
+        bool               polled = false;
+        poll.on_data = [&](ModbusResult, const std::uint16_t* regs, std::uint16_t) {
+            polled = true;
+            EXPECT_EQ(5U, regs[0]);
+        };
+        poller.Add(poll);
+
+        bool written = false;
+        ASSERT_TRUE(poller.QueueWrite(1U, 0U, 5U, [&](ModbusResult result) {
+            written = result.Ok();
+            EXPECT_FALSE(polled);
+        }));
+        EXPECT_EQ(0, poller.RunOnce().count());
+        EXPECT_TRUE(written);
+        poller.RunOnce();
+        EXPECT_TRUE(polled);
+        EXPECT_FALSE(poller.QueueWrite(0U, 0U, 1U));
+    }
+
+#if CUSTOM_PLATFORM_HAS_TERMIOS
+    using custom::platform::SerialModbusTransport;
+
+    // Same stack over a real pty: the "device" thread serves the slave end like an adapter would
+    TEST(ModbusSerialTest, TalksToADeviceOverAPty)
+    {
+        const int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master_fd, 0);
+        ASSERT_EQ(0, grantpt(master_fd));
+        ASSERT_EQ(0, unlockpt(master_fd));
+        const char* slave_path = ptsname(master_fd);
+        ASSERT_NE(nullptr, slave_path);
+
+        SerialModbusTransport device_side(slave_path, 115200U);
+        ASSERT_TRUE(device_side.IsOpen());
+        SerialModbusTransport host_side(master_fd);
+
+        ModbusSlaveSim meter(5U);
+        meter.SetHolding(1U, 2301U);
+        std::thread device([&]() {
+            std::uint8_t frame[kModbusMaxFrame];
+            for (int served = 0; served < 2;)
+            {
+                // A request ends after t3.5 of silence
+                std::size_t length =
+                    device_side.Read(frame, sizeof(frame), std::chrono::seconds(2));
+                if (length == 0U)
+                {
+                    return;
+                }
+                while (const std::size_t more = device_side.Read(
+                           frame + length, sizeof(frame) - length, std::chrono::microseconds(1750)))
+                {
+                    length += more;
+                }
+                const std::vector<std::uint8_t> reply = meter.Handle(frame, length);
+                device_side.Write(reply.data(), reply.size());
+                served++;
+            }
+        });
+
+        ModbusMaster::Config config;
+        config.response_timeout = std::chrono::milliseconds(1000);
+        ModbusMaster  master(host_side, config);
+        std::uint16_t value = 0U;
+        EXPECT_TRUE(master.WriteSingleRegister(5U, 2U, 99U).Ok());
+        EXPECT_TRUE(master.ReadHoldingRegisters(5U, 1U, 1U, &value).Ok());
+        device.join();
+
+        EXPECT_EQ(2301U, value);
+        EXPECT_EQ(99U, meter.Holding(2U));
+    }
+#endif
+
+}  // namespace
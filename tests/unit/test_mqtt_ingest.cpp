@@ -0,0 +1,299 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "integration/ha_entity_store.h"
+#include "integration/mqtt_ingest.h"
+#include "integration/mqtt_stub_broker.h"
+#include "integration/mqtt_topic_trie.h"
+#include "integration/rooms_provider.h"
+
+namespace
+{
+
+    using custom::integration::HaEntityStore;
+    using custom::integration::HaRoomLayout;
+    using custom::integration::MqttFilterValid;
+    using custom::integration::MqttIngest;
+    using custom::integration::MqttStubBroker;
+    using custom::integration::MqttTopicMatches;
+    using custom::integration::MqttTopicTrie;
+
+    std::vector<MqttTopicTrie::HandlerId> Routed(const MqttTopicTrie& trie, const char* topic)
+    {
+        std::vector<MqttTopicTrie::HandlerId> ids;
+        trie.Match(topic, [&ids](MqttTopicTrie::HandlerId id) { ids.push_back(id); });
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    std::vector<HaRoomLayout> MqttLayout()
+    {
+        HaRoomLayout kitchen;
+        kitchen.room_id            = "kitchen";
+        kitchen.name               = "Kitchen";
+        kitchen.entities           = {"light.kitchen_main", "switch.kitchen_fan"};
+        kitchen.temperature_entity = "sensor.kitchen_temperature";
+        return {kitchen};
+    }
+
+    const room_entity_t* FindMqttEntity(const char* entity_id)
+    {
+        const rooms_state_t* state = rooms_provider_get_state();
+        for (std::size_t r = 0; state != nullptr && r < state->room_count; ++r)
+        {
+            const room_t& room = state->rooms[r];
+            for (std::size_t e = 0; e < room.entity_count; ++e)
+            {
+                if (std::strcmp(room.entities[e]->entity_id, entity_id) == 0)
+                {
+                    return room.entities[e];
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    TEST(MqttTopicTrieTest, MatchesExactAndWildcardFilters)
+    {
+        MqttTopicTrie trie;
+        ASSERT_TRUE(trie.Add("home/kitchen/light", 0U));
+        ASSERT_TRUE(trie.Add("home/+/light", 1U));
+        ASSERT_TRUE(trie.Add("home/#", 2U));
+        ASSERT_TRUE(trie.Add("#", 3U));
+        ASSERT_TRUE(trie.Add("home/kitchen/light/#", 4U));  // also matches the parent level
+        ASSERT_TRUE(trie.Add("$SYS/#", 5U));
+        ASSERT_TRUE(trie.Add("+/+/light", 6U));
+        ASSERT_TRUE(trie.Add("home/kitchen/light", 7U));  // same filter, second handler
+        trie.Compile();
+        EXPECT_EQ(8U, trie.FilterCount());
+
+        using Ids = std::vector<MqttTopicTrie::HandlerId>;
+        EXPECT_EQ((Ids{0U, 1U, 2U, 3U, 4U, 6U, 7U}), Routed(trie, "home/kitchen/light"));
+        EXPECT_EQ((Ids{2U, 3U, 4U}), Routed(trie, "home/kitchen/light/set"));
+        EXPECT_EQ((Ids{1U, 2U, 3U, 6U}), Routed(trie, "home/office/light"));
+        EXPECT_EQ((Ids{2U, 3U}), Routed(trie, "home"));
+        EXPECT_EQ((Ids{3U}), Routed(trie, "garden//light/x"));
+        EXPECT_EQ((Ids{3U, 6U}), Routed(trie, "/x/light"));
+        // Wildcards in the first level never match $-topics
+        EXPECT_EQ((Ids{5U}), Routed(trie, "$SYS/broker/load"));
+    }
+
+    TEST(MqttTopicTrieTest, RejectsInvalidFilters)
+    {
+        MqttTopicTrie trie;
+        for (const char* bad : {"", "home/#/light", "home/kit+chen", "home#", "#/x"})
+        {
+            EXPECT_FALSE(MqttFilterValid(bad)) << bad;
+            EXPECT_FALSE(trie.Add(bad, 0U)) << bad;
+        }
+        EXPECT_EQ(0U, trie.FilterCount());
+        EXPECT_TRUE(MqttFilterValid("+/+/#"));
+    }
+
+    TEST(MqttTopicTrieTest, AgreesWithTheReferenceMatcher)
+    {
+        // Few distinct level names so that filters and topics collide often
+        const char*                     names[] = {"a", "b", "c", "$x", ""};
+        std::mt19937                    rng(7U);
+        std::uniform_int_distribution<> pick_name(0, 4);
+        std::uniform_int_distribution<> pick_depth(1, 5);
+        std::uniform_int_distribution<> pick_kind(0, 9);
+
+        std::vector<std::string> filters;
+        MqttTopicTrie            trie;
+        for (int i = 0; i < 300; ++i)
+        {
+            std::string filter;
+            const int   depth = pick_depth(rng);
+            for (int level = 0; level < depth; ++level)
+            {
+                const int kind = pick_kind(rng);
+                filter += level > 0 ? "/" : "";
+                if (kind == 0 && level == depth - 1)
+                {
+                    filter += "#";
+                }
+                else
+                {
+                    filter += kind < 3 ? "+" : names[pick_name(rng)];
+                }
+            }
+            if (filter.empty())
+            {
+                continue;  // one empty level: a topic, but not a valid filter
+            }
+            ASSERT_TRUE(trie.Add(filter, static_cast<MqttTopicTrie::HandlerId>(filters.size())));
+            filters.push_back(filter);
+        }
+        trie.Compile();
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string topic;
+            const int   depth = pick_depth(rng);
+            for (int level = 0; level < depth; ++level)
+            {
+                topic += level > 0 ? "/" : "";
+                topic += names[pick_name(rng)];
+            }
+            std::vector<MqttTopicTrie::HandlerId> expected;
+            for (std::size_t f = 0; f < filters.size(); ++f)
+            {
+                if (MqttTopicMatches(filters[f], topic))
+                {
+                    expected.push_back(static_cast<MqttTopicTrie::HandlerId>(f));
+                }
+            }
+            ASSERT_EQ(expected, Routed(trie, topic.c_str())) << topic;
+        }
+    }
+
+    class MqttIngestTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            rooms_provider_reset_state();
+            ingest.SetChangeCallback([this]() {
+                changes++;
+                store.Publish();
+            });
+            broker.Attach(&ingest);
+
+            // Retained, as Zigbee2MQTT and ESPHome publish them
+            broker.Publish(
+                "homeassistant/light/kitchen_main/config",
+                R"({"~":"z2m/kitchen_main","name":"Main","schema":"json","stat_t":"~",)"
+                R"("cmd_t":"~/set","brightness":true,"device":{"ids":["0x00158d"]}})",
+                true);
+            broker.Publish("homeassistant/switch/esp_kitchen/kitchen_fan/config",
+                           R"({"name":"Fan","state_topic":"esp/kitchen/fan/state"})",
+                           true);
+            broker.Publish("homeassistant/sensor/kitchen_t/config",
+                           R"({"object_id":"kitchen_temperature","stat_t":"esp/kitchen/temp"})",
+                           true);
+            broker.Publish("homeassistant/sensor/garage_t/config",
+                           R"({"stat_t":"esp/garage/temp"})",
+                           true);
+            broker.Publish("z2m/kitchen_main", R"({"state":"ON","brightness":128})", true);
+            broker.Publish("esp/kitchen/fan/state", "OFF", true);
+            broker.Publish("esp/kitchen/temp", "21.6", true);
+            broker.Publish("esp/garage/temp", "9.5", true);
+        }
+
+        void TearDown() override
+        {
+            rooms_provider_reset_state();
+        }
+
+        void ConnectAndDrain()
+        {
+            broker.Connect();
+            while (broker.Pump() > 0U)
+            {
+            }
+        }
+
+        HaEntityStore  store{MqttLayout()};
+        MqttStubBroker broker;
+        MqttIngest     ingest{broker, store};
+        int            changes = 0;
+    };
+
+    TEST_F(MqttIngestTest, DiscoveryFollowsRetainedConfigsToState)
+    {
+        ConnectAndDrain();
+
+        const room_entity_t* light = FindMqttEntity("light.kitchen_main");
+        ASSERT_NE(nullptr, light);
+        EXPECT_TRUE(light->available);
+        EXPECT_TRUE(light->on);
+        EXPECT_EQ(50, light->value);
+        EXPECT_TRUE(FindMqttEntity("switch.kitchen_fan")->available);
+        EXPECT_FALSE(FindMqttEntity("switch.kitchen_fan")->on);
+        EXPECT_EQ(22, rooms_provider_get_state()->rooms[0].temp_c);
+
+        // Two discovery filters plus one state topic per tracked entity; the garage is skipped
+        const std::vector<std::string>& subscriptions = broker.Subscriptions();
+        EXPECT_EQ(5U, subscriptions.size());
+        EXPECT_EQ(subscriptions.end(),
+                  std::find(subscriptions.begin(), subscriptions.end(), "esp/garage/temp"));
+        EXPECT_EQ(1U, ingest.GetStats().configs_other);
+        EXPECT_EQ(0U, ingest.GetStats().parse_errors);
+    }
+
+    TEST_F(MqttIngestTest, LiveMessagesUpdateOnlyWhatChanged)
+    {
+        ConnectAndDrain();
+        changes = 0;
+
+        broker.Publish("esp/kitchen/fan/state", "ON");
+        broker.Publish("esp/garage/temp", "9.7");  // not subscribed, never delivered
+        broker.Publish("z2m/kitchen_main", R"({"state":"ON","brightness":128,"linkquality":87})");
+        EXPECT_EQ(2U, broker.Pump());
+        EXPECT_EQ(1, changes);
+        EXPECT_TRUE(FindMqttEntity("switch.kitchen_fan")->on);
+
+        broker.Publish("z2m/kitchen_main", R"({"state":"OFF"})");
+        broker.Publish("z2m/kitchen_main", R"({"state":"ON","brightness":)");
+        broker.Pump();
+        EXPECT_FALSE(FindMqttEntity("light.kitchen_main")->on);
+        EXPECT_EQ(1U, ingest.GetStats().parse_errors);
+    }
+
+    TEST_F(MqttIngestTest, ConfigChangesRerouteState)
+    {
+        ConnectAndDrain();
+        const std::uint32_t recompiles = ingest.GetStats().recompiles;
+
+        // Same config again: nothing to recompile
+        broker.Publish("homeassistant/switch/esp_kitchen/kitchen_fan/config",
+                       R"({"name":"Fan","state_topic":"esp/kitchen/fan/state"})",
+                       true);
+        broker.Pump();
+        EXPECT_EQ(recompiles, ingest.GetStats().recompiles);
+
+        // Default light schema with a separate brightness topic
+        broker.Publish("homeassistant/light/kitchen_main/config",
+                       R"({"stat_t":"lights/kitchen","bri_stat_t":"lights/kitchen/bri"})",
+                       true);
+        broker.Publish("lights/kitchen", "ON", true);
+        broker.Publish("lights/kitchen/bri", "255", true);
+        while (broker.Pump() > 0U)
+        {
+        }
+        EXPECT_EQ(recompiles + 1U, ingest.GetStats().recompiles);
+        EXPECT_EQ(100, FindMqttEntity("light.kitchen_main")->value);
+
+        // An empty retained config removes the entity
+        broker.Publish("homeassistant/switch/esp_kitchen/kitchen_fan/config", "", true);
+        broker.Pump();
+        EXPECT_FALSE(FindMqttEntity("switch.kitchen_fan")->available);
+        broker.Publish("esp/kitchen/fan/state", "ON");
+        broker.Pump();
+        EXPECT_FALSE(FindMqttEntity("switch.kitchen_fan")->available);
+    }
+
+    TEST_F(MqttIngestTest, ReconnectMarksStaleAndResubscribes)
+    {
+        ConnectAndDrain();
+        broker.Disconnect();
+        EXPECT_FALSE(FindMqttEntity("light.kitchen_main")->available);
+
+        ConnectAndDrain();
+        EXPECT_EQ(5U, broker.Subscriptions().size());
+        EXPECT_TRUE(FindMqttEntity("light.kitchen_main")->available);
+        EXPECT_TRUE(FindMqttEntity("switch.kitchen_fan")->available);
+    }
+
+}  // namespace
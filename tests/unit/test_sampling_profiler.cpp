@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "platform/profiling/sampling_profiler.h"
+
+namespace
+{
+
+    using custom::platform::ProfileTimer;
+    using custom::platform::SamplingProfiler;
+
+    SamplingProfiler::Config ProfilerConfig(std::size_t cores, std::size_t ring_capacity)
+    {
+        SamplingProfiler::Config config;
+        config.cores         = cores;
+        config.ring_capacity = ring_capacity;
+        config.drain_period  = std::chrono::milliseconds(5);
+        return config;
+    }
+
+    /** Ticks from a thread, like the tick interrupt would, alternating two PCs on core 0. */
+    class ThreadTimer : public ProfileTimer
+    {
+    public:
+        bool Start(SamplingProfiler& profiler) override
+        {
+            if (running_.exchange(true))
+            {
+                return false;
+            }
+            thread_ = std::thread([this, &profiler]() {
+                while (running_.load())
+                {
+                    profiler.Record(0U, ticks_ % 4U == 0U ? 0x40001000U : 0x40002000U, "lvgl");
+                    profiler.Record(1U, 0U, "IDLE1");
+                    ticks_++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            });
+            return true;
+        }
+
+        void Stop() override
+        {
+            running_ = false;
+            thread_.join();
+        }
+
+        std::uint32_t Ticks() const
+        {
+            return ticks_;
+        }
+
+    private:
+        std::atomic<bool> running_{false};
+        std::uint32_t     ticks_ = 0U;
+        std::thread       thread_;
+    };
+
+    /** Fires a fixed burst synchronously from Start(). */
+    class BurstTimer : public ProfileTimer
+    {
+    public:
+        explicit BurstTimer(int samples) : samples_(samples)
+        {
+        }
+
+        bool Start(SamplingProfiler& profiler) override
+        {
+            for (int i = 0; i < samples_; ++i)
+            {
+                profiler.Record(0U, 0x1000U, "busy task;x");
+            }
+            return true;
+        }
+
+        void Stop() override
+        {
+        }
+
+    private:
+        int samples_;
+    };
+
+    bool AppendTo(std::string& text, const char* data, std::size_t len)
+    {
+        text.append(data, len);
+        return true;
+    }
+
+    TEST(SamplingProfilerTest, FoldsSamplesHottestFirst)
+    {
+        SamplingProfiler profiler(ProfilerConfig(2U, 64U));
+        ThreadTimer      timer;
+        std::string      folded;
+        ASSERT_TRUE(profiler.Capture(timer,
+                                     std::chrono::milliseconds(60),
+                                     [&folded](const char* data, std::size_t len) {
+                                         return AppendTo(folded, data, len);
+                                     }));
+
+        EXPECT_EQ(0U, profiler.Dropped());
+        EXPECT_EQ(timer.Ticks() * 2U, profiler.Samples());
+        // Both cores tick equally; the PC-less core folds to the task alone
+        EXPECT_EQ(0U, folded.find("IDLE1 " + std::to_string(timer.Ticks()) + "\n"));
+        EXPECT_NE(std::string::npos, folded.find("\nlvgl;0x40002000 "));
+        EXPECT_NE(std::string::npos, folded.find("\nlvgl;0x40001000 "));
+        EXPECT_LT(folded.find("lvgl;0x40002000"), folded.find("lvgl;0x40001000"));
+    }
+
+    TEST(SamplingProfilerTest, CountsWhatTheRingCouldNotHold)
+    {
+        SamplingProfiler profiler(ProfilerConfig(1U, 16U));
+        BurstTimer       timer(40);
+        std::string      folded;
+        ASSERT_TRUE(profiler.Capture(timer,
+                                     std::chrono::milliseconds(0),
+                                     [&folded](const char* data, std::size_t len) {
+                                         return AppendTo(folded, data, len);
+                                     },
+                                     [](std::uintptr_t pc) {
+                                         return "fn at " + std::to_string(pc);
+                                     }));
+
+        EXPECT_EQ(16U, profiler.Samples());
+        EXPECT_EQ(24U, profiler.Dropped());
+        // Separators inside names would split frames, so they are replaced
+        EXPECT_EQ("busy_task_x;fn_at_4096 16\n[dropped] 24\n", folded);
+    }
+
+    TEST(SamplingProfilerTest, GivesUpWhenTheTimerIsTaken)
+    {
+        SamplingProfiler first(ProfilerConfig(1U, 64U));
+        SamplingProfiler second(ProfilerConfig(1U, 64U));
+        ThreadTimer      timer;
+        ASSERT_TRUE(timer.Start(first));
+        int writes = 0;
+        EXPECT_FALSE(second.Capture(timer,
+                                    std::chrono::milliseconds(10),
+                                    [&writes](const char*, std::size_t) {
+                                        writes++;
+                                        return true;
+                                    }));
+        timer.Stop();
+        EXPECT_EQ(0, writes);
+
+        // A writer that gives up stops the output
+        BurstTimer burst(4);
+        EXPECT_FALSE(second.Capture(
+            burst, std::chrono::milliseconds(0), [](const char*, std::size_t) { return false; }));
+    }
+
+}  // namespace
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "platform/spsc_ring.h"
+
+namespace
+{
+
+    using ByteRing = custom::platform::SpscRing<std::uint8_t>;
+
+    std::size_t PushText(ByteRing& ring, const std::string& text)
+    {
+        return ring.Push(reinterpret_cast<const std::uint8_t*>(text.data()), text.size());
+    }
+
+    std::string DrainBySpans(ByteRing& ring)
+    {
+        std::string out;
+        for (auto span = ring.ReadSpan(); span.size > 0U; span = ring.ReadSpan())
+        {
+            out.append(reinterpret_cast<const char*>(span.data), span.size);
+            ring.CommitRead(span.size);
+        }
+        return out;
+    }
+
+    TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo)
+    {
+        ByteRing ring(100U);
+        EXPECT_EQ(128U, ring.Capacity());
+        EXPECT_EQ(128U, ring.Free());
+        EXPECT_TRUE(ring.Empty());
+    }
+
+    TEST(SpscRingTest, BulkPushStopsWhenFull)
+    {
+        ByteRing ring(8U);
+        EXPECT_EQ(8U, PushText(ring, "0123456789"));
+        EXPECT_EQ(0U, ring.Free());
+
+        char out[16] = {};
+        EXPECT_EQ(8U, ring.Pop(reinterpret_cast<std::uint8_t*>(out), sizeof(out)));
+        EXPECT_STREQ("01234567", out);
+    }
+
+    TEST(SpscRingTest, ReadSpanSplitsAtTheWrapPoint)
+    {
+        ByteRing ring(8U);
+        PushText(ring, "abcdef");
+        std::uint8_t skip[4];
+        ring.Pop(skip, sizeof(skip));  // read position now 4
+        PushText(ring, "ghijkl");      // fills 6..7 then wraps to 0..3
+
+        auto first = ring.ReadSpan();
+        EXPECT_EQ(4U, first.size);
+        EXPECT_EQ(0, std::memcmp(first.data, "efgh", 4U));
+        ring.CommitRead(first.size);
+
+        auto second = ring.ReadSpan();
+        EXPECT_EQ(4U, second.size);
+        EXPECT_EQ(0, std::memcmp(second.data, "ijkl", 4U));
+        ring.CommitRead(second.size);
+        EXPECT_TRUE(ring.Empty());
+        EXPECT_EQ(0U, ring.ReadSpan().size);
+    }
+
+    TEST(SpscRingTest, WriteSpanFillsInPlace)
+    {
+        ByteRing ring(8U);
+        PushText(ring, "xyz");
+        std::uint8_t skip[3];
+        ring.Pop(skip, sizeof(skip));
+
+        auto span = ring.WriteSpan();
+        ASSERT_EQ(5U, span.size);  // up to the end of the buffer, not all 8 free bytes
+        std::memcpy(span.data, "hello", 5U);
+        ring.CommitWrite(5U);
+
+        span = ring.WriteSpan();
+        ASSERT_EQ(3U, span.size);
+        std::memcpy(span.data, "!!!", 3U);
+        ring.CommitWrite(2U);  // a partial commit publishes only what was filled
+
+        EXPECT_EQ("hello!!", DrainBySpans(ring));
+    }
+
+    TEST(SpscRingTest, SpansCarryAByteStreamAcrossThreads)
+    {
+        ByteRing    ring(64U);
+        std::string sent;
+        for (int i = 0; i < 20000; ++i)
+        {
+            sent.push_back(static_cast<char>('a' + (i * 7) % 26));
+        }
+
+        std::thread producer([&ring, &sent]() {
+            std::size_t offset = 0U;
+            while (offset < sent.size())
+            {
+                auto span = ring.WriteSpan();
+                if (span.size == 0U)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const std::size_t n = std::min(span.size, sent.size() - offset);
+                std::memcpy(span.data, sent.data() + offset, n);
+                ring.CommitWrite(n);
+                offset += n;
+            }
+        });
+
+        std::string received;
+        while (received.size() < sent.size())
+        {
+            const std::string chunk = DrainBySpans(ring);
+            if (chunk.empty())
+            {
+                std::this_thread::yield();
+            }
+            received += chunk;
+        }
+        producer.join();
+        EXPECT_EQ(sent, received);
+    }
+
+}  // namespace
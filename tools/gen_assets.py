@@ -5,7 +5,11 @@
 
 This script walks `custom/assets` (or any input directory) for PNG/JPG/WEBP
 files, converts them into RGB565 binary blobs, and emits a manifest describing
-where the runtime should mount them.
+where the runtime should mount them. It also packs every image into a single
+memory-mappable `assets.bundle` (layout in `custom/assets/asset_bundle.h`) so the
+firmware can resolve ids without opening a file per image. Large images can be
+stored RLE- or LZ4-compressed in independent row bands (`custom/assets/asset_codec.h`);
+the script prints a size/time report for the bundle.
 """
 
 from __future__ import annotations
@@ -15,16 +19,34 @@ import hashlib
 import json
 import os
 import re
+import struct
 import sys
-from dataclasses import dataclass
+import time
+from dataclasses import dataclass, field
 from datetime import datetime, timezone
 from pathlib import Path
-from typing import Iterable, List
+from typing import Callable, Iterable, List, Tuple
 
 from PIL import Image
 
 SUPPORTED_EXTENSIONS = {".png", ".jpg", ".jpeg", ".webp"}
 
+BUNDLE_NAME = "assets.bundle"
+BUNDLE_MAGIC = b"T5AB"
+BUNDLE_VERSION = 1
+BUNDLE_HEADER = struct.Struct("<4sHHIIIIII")
+BUNDLE_ENTRY = struct.Struct("<IIIIIHHHBBI")
+BUNDLE_BLOB_ALIGN = 64
+FORMAT_RGB565 = 1
+COMPRESSION_NONE = 0
+COMPRESSION_RLE16 = 1
+COMPRESSION_LZ4 = 2
+CODEC_NAMES = {COMPRESSION_NONE: "none", COMPRESSION_RLE16: "rle", COMPRESSION_LZ4: "lz4"}
+DEFAULT_BAND_ROWS = 16
+# Uncompressed entries are drawn straight from the mapping, so only compress when it
+# saves a meaningful amount of flash.
+MIN_COMPRESSION_SAVING = 0.125
+
 
 def parse_args() -> argparse.Namespace:
     parser = argparse.ArgumentParser(description="Generate runtime asset bundle")
@@ -35,6 +57,18 @@ def parse_args() -> argparse.Namespace:
         default="/spiffs/custom/assets",
         help="Root mount path used by the firmware to locate assets",
     )
+    parser.add_argument(
+        "--compress",
+        choices=["auto", "none", "rle", "lz4"],
+        default="auto",
+        help="Bundle compression; auto keeps the smallest codec that saves at least 12.5%%",
+    )
+    parser.add_argument(
+        "--band-rows",
+        type=int,
+        default=DEFAULT_BAND_ROWS,
+        help="Rows per independently compressed band",
+    )
     return parser.parse_args()
 
 
@@ -56,6 +90,8 @@ class AssetEntry:
     height: int
     binary_path: Path
     checksum: str
+    # Little-endian pixels, the layout LVGL draws from directly
+    bundle_pixels: bytes = field(repr=False, default=b"")
 
     @property
     def mount_path(self) -> str:
@@ -71,13 +107,13 @@ def iter_source_images(root: Path) -> Iterable[Path]:
         yield path
 
 
-def to_rgb565(image: Image.Image) -> bytes:
+def to_rgb565(image: Image.Image, little_endian: bool = False) -> bytes:
     rgb_image = image.convert("RGB")
     pixels = bytearray()
     for r, g, b in rgb_image.getdata():
         value = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
-        pixels.append((value >> 8) & 0xFF)
-        pixels.append(value & 0xFF)
+        hi, lo = (value >> 8) & 0xFF, value & 0xFF
+        pixels.extend((lo, hi) if little_endian else (hi, lo))
     return bytes(pixels)
 
 
@@ -87,6 +123,7 @@ def process_image(path: Path, root: Path, bin_root: Path) -> AssetEntry:
     with Image.open(path) as image:
         width, height = image.size
         payload = to_rgb565(image)
+        bundle_pixels = to_rgb565(image, little_endian=True)
 
     binary_name = f"{asset_id}.bin"
     binary_path = bin_root / binary_name
@@ -101,6 +138,7 @@ def process_image(path: Path, root: Path, bin_root: Path) -> AssetEntry:
         height=height,
         binary_path=Path("bin") / binary_name,
         checksum=checksum,
+        bundle_pixels=bundle_pixels,
     )
 
 
@@ -110,6 +148,7 @@ def write_manifest(output_dir: Path, mount_root: str, assets: List[AssetEntry],
         "generated_at": datetime.now(timezone.utc).isoformat(),
         "source_root": str(source_root),
         "mount_root": mount_root,
+        "bundle": BUNDLE_NAME,
         "assets": [
             {
                 "id": entry.asset_id,
@@ -128,6 +167,221 @@ def write_manifest(output_dir: Path, mount_root: str, assets: List[AssetEntry],
     manifest_path.write_text(json.dumps(manifest, indent=2))
 
 
+def fnv1a32(text: str) -> int:
+    value = 0x811C9DC5
+    for byte in text.encode("utf-8"):
+        value ^= byte
+        value = (value * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def align_up(value: int, alignment: int) -> int:
+    return (value + alignment - 1) // alignment * alignment
+
+
+def rle16_encode(data: bytes) -> bytes:
+    """Runs of up to 128 equal pixels or literal spans of up to 128 pixels."""
+    pixels = memoryview(data).cast("H")
+    count = len(pixels)
+    out = bytearray()
+    i = 0
+    while i < count:
+        run = 1
+        while i + run < count and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            out.append(0x80 | (run - 1))
+            out += data[2 * i : 2 * i + 2]
+            i += run
+            continue
+        start = i
+        i += 1
+        while i < count and i - start < 128 and not (i + 1 < count and pixels[i] == pixels[i + 1]):
+            i += 1
+        out.append(i - start - 1)
+        out += data[2 * start : 2 * i]
+    return bytes(out)
+
+
+def _lz4_length(out: bytearray, value: int) -> None:
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def _lz4_sequence(out: bytearray, literals: bytes, offset: int = 0, match: int = 0) -> None:
+    match_code = match - 4 if offset else 0
+    out.append((min(len(literals), 15) << 4) | min(match_code, 15))
+    if len(literals) >= 15:
+        _lz4_length(out, len(literals) - 15)
+    out += literals
+    if offset:
+        out += struct.pack("<H", offset)
+        if match_code >= 15:
+            _lz4_length(out, match_code - 15)
+
+
+def lz4_encode(data: bytes) -> bytes:
+    """Raw LZ4 block; uses the lz4 package when installed, else a greedy encoder."""
+    try:
+        import lz4.block  # type: ignore
+
+        return lz4.block.compress(data, store_size=False)
+    except ImportError:
+        pass
+
+    # Spec limits: the last match starts 12+ bytes before the end, the last 5 bytes are literals.
+    size = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    while i < size - 12:
+        key = data[i : i + 4]
+        candidate = table.get(key, -1)
+        table[key] = i
+        if candidate < 0 or i - candidate > 0xFFFF:
+            i += 1
+            continue
+        match = 4
+        limit = size - 5 - i
+        while match < limit and data[candidate + match] == data[i + match]:
+            match += 1
+        _lz4_sequence(out, data[anchor:i], i - candidate, match)
+        i += match
+        anchor = i
+    _lz4_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+ENCODERS = {COMPRESSION_RLE16: rle16_encode, COMPRESSION_LZ4: lz4_encode}
+
+
+def pack_bands(entry: AssetEntry, band_rows: int, encoder: Callable[[bytes], bytes]) -> bytes:
+    stride = entry.width * 2
+    bands = [
+        encoder(entry.bundle_pixels[row * stride : (row + band_rows) * stride])
+        for row in range(0, entry.height, band_rows)
+    ]
+    offsets = [0]
+    for band in bands:
+        offsets.append(offsets[-1] + len(band))
+    table = struct.pack("<HH", band_rows, len(bands)) + struct.pack(f"<{len(offsets)}I", *offsets)
+    return table + b"".join(bands)
+
+
+def encode_entry(entry: AssetEntry, mode: str, band_rows: int) -> Tuple[int, bytes, float]:
+    """Return (compression, stored blob, encode seconds) for one asset."""
+    raw = entry.bundle_pixels
+    if mode == "none" or entry.height == 0:
+        return COMPRESSION_NONE, raw, 0.0
+
+    if mode == "auto":
+        codecs = [COMPRESSION_RLE16, COMPRESSION_LZ4]
+    else:
+        codecs = [COMPRESSION_RLE16 if mode == "rle" else COMPRESSION_LZ4]
+
+    best = (COMPRESSION_NONE, raw)
+    started = time.perf_counter()
+    for codec in codecs:
+        blob = pack_bands(entry, band_rows, ENCODERS[codec])
+        if len(blob) < len(best[1]):
+            best = (codec, blob)
+    elapsed = time.perf_counter() - started
+
+    if mode == "auto" and len(best[1]) > len(raw) * (1.0 - MIN_COMPRESSION_SAVING):
+        best = (COMPRESSION_NONE, raw)
+    return best[0], best[1], elapsed
+
+
+def print_bundle_report(rows: List[Tuple[AssetEntry, int, int, float]]) -> None:
+    print(f"{'asset':<32} {'size':>11} {'raw KB':>9} {'stored KB':>10} {'ratio':>6} {'codec':>5} {'enc ms':>8}")
+    total_raw = total_stored = 0
+    total_time = 0.0
+    for entry, compression, stored, seconds in rows:
+        raw = len(entry.bundle_pixels)
+        total_raw += raw
+        total_stored += stored
+        total_time += seconds
+        ratio = stored / raw if raw else 1.0
+        print(
+            f"{entry.asset_id:<32} {f'{entry.width}x{entry.height}':>11} {raw / 1024:9.1f} "
+            f"{stored / 1024:10.1f} {ratio:6.2f} {CODEC_NAMES[compression]:>5} {seconds * 1000:8.1f}"
+        )
+    ratio = total_stored / total_raw if total_raw else 1.0
+    print(
+        f"{'total':<32} {'':>11} {total_raw / 1024:9.1f} {total_stored / 1024:10.1f} "
+        f"{ratio:6.2f} {'':>5} {total_time * 1000:8.1f}"
+    )
+
+
+def write_bundle(
+    output_dir: Path,
+    assets: List[AssetEntry],
+    compress: str = "none",
+    band_rows: int = DEFAULT_BAND_ROWS,
+) -> Path:
+    """Pack every asset behind a hash-sorted index; see custom/assets/asset_bundle.h."""
+    ordered = sorted(assets, key=lambda entry: (fnv1a32(entry.asset_id), entry.asset_id))
+
+    strings = bytearray()
+    name_offsets = []
+    for entry in ordered:
+        name_offsets.append(len(strings))
+        strings.extend(entry.asset_id.encode("utf-8") + b"\0")
+
+    index_offset = BUNDLE_HEADER.size
+    strings_offset = index_offset + BUNDLE_ENTRY.size * len(ordered)
+    data_offset = align_up(strings_offset + len(strings), BUNDLE_BLOB_ALIGN)
+
+    index = bytearray()
+    blobs = bytearray()
+    report = []
+    for entry, name_offset in zip(ordered, name_offsets):
+        compression, stored, seconds = encode_entry(entry, compress, band_rows)
+        report.append((entry, compression, len(stored), seconds))
+        blob_offset = data_offset + len(blobs)
+        index.extend(
+            BUNDLE_ENTRY.pack(
+                fnv1a32(entry.asset_id),
+                name_offset,
+                blob_offset,
+                len(stored),
+                len(entry.bundle_pixels),
+                entry.width,
+                entry.height,
+                entry.width * 2,
+                FORMAT_RGB565,
+                compression,
+                0,
+            )
+        )
+        blobs.extend(stored)
+        blobs.extend(b"\0" * (align_up(len(blobs), BUNDLE_BLOB_ALIGN) - len(blobs)))
+
+    total_size = data_offset + len(blobs)
+    header = BUNDLE_HEADER.pack(
+        BUNDLE_MAGIC,
+        BUNDLE_VERSION,
+        BUNDLE_HEADER.size,
+        len(ordered),
+        index_offset,
+        strings_offset,
+        len(strings),
+        data_offset,
+        total_size,
+    )
+    padding = b"\0" * (data_offset - strings_offset - len(strings))
+
+    bundle_path = output_dir / BUNDLE_NAME
+    output_dir.mkdir(parents=True, exist_ok=True)
+    bundle_path.write_bytes(header + bytes(index) + bytes(strings) + padding + bytes(blobs))
+    if report:
+        print_bundle_report(report)
+    return bundle_path
+
+
 def remove_stale_bins(bin_root: Path, assets: List[AssetEntry]) -> None:
     valid = {entry.binary_path for entry in assets}
     if not bin_root.exists():
@@ -152,6 +406,10 @@ def main() -> int:
 
     remove_stale_bins(bin_root, assets)
     write_manifest(output_root, args.mount_root.rstrip("/"), assets, source_root)
+    if args.band_rows <= 0:
+        print("--band-rows must be positive", file=sys.stderr)
+        return 1
+    write_bundle(output_root, assets, args.compress, args.band_rows)
 
     print(f"Processed {len(assets)} assets into {output_root}")
     return 0
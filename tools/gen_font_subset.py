@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+
+"""Generate Montserrat subsets holding only the glyphs the UI can show.
+
+The script scans `custom/ui` (or any input directory) for the font sizes it uses
+(`UI_FONT(18)`, see `custom/ui/ui_fonts.h`), the characters in its string literals and
+the `LV_SYMBOL_*` icons it references. It then runs `lv_font_conv` once per size with
+printable ASCII (room names, entity states and numbers arrive at runtime) plus those
+extra characters and icons. The output is `ui_font_montserrat_<size>.c` and
+`ui_font_subset.h` in the output directory, which `ui_fonts.h` picks up automatically.
+The script prints glyph counts and bitmap bytes next to LVGL's built-in fonts and writes
+the same numbers to `font_subset.json`. With `--sdkconfig` it also lists built-in sizes
+that are enabled but referenced nowhere.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+SOURCE_EXTENSIONS = {".c", ".cc", ".cpp", ".h"}
+ASCII_RANGE = (0x20, 0x7E)
+DEFAULT_BPP = 4
+FONT_NAME = "ui_font_montserrat_{size}"
+HEADER_NAME = "ui_font_subset.h"
+REPORT_NAME = "font_subset.json"
+
+# Relative to the LVGL checkout; the same files LVGL builds its own fonts from.
+TEXT_FONT = Path("scripts/built_in_font/Montserrat-Medium.ttf")
+SYMBOL_FONT = Path("scripts/built_in_font/FontAwesome5-Solid+Brands+Regular.woff")
+SYMBOL_DEFS = Path("src/font/lv_symbol_def.h")
+BUILTIN_FONT = "src/font/lv_font_montserrat_{size}.c"
+
+# Where the desktop build, the ESP-IDF component manager and the test build keep LVGL.
+LVGL_CANDIDATES = [
+    Path("platforms/desktop/dependencies/lvgl"),
+    Path("dependencies/lvgl"),
+    Path("platforms/tab5/managed_components/lvgl__lvgl"),
+    Path("tests/build/_deps/lvgl-src"),
+]
+
+UI_FONT_RE = re.compile(r"\bUI_FONT\(\s*(\d+)\s*\)")
+BUILTIN_REF_RE = re.compile(r"\blv_font_montserrat_(\d+)\b")
+SYMBOL_RE = re.compile(r"\bLV_SYMBOL_([A-Z0-9_]+)\b")
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+# e.g. #define LV_SYMBOL_AUDIO "\xEF\x80\x81" /*61441, 0xF001*/
+SYMBOL_DEF_RE = re.compile(
+    r"#define\s+LV_SYMBOL_([A-Z0-9_]+)\s+\"[^\"]*\"\s*/\*\s*\d+,\s*0x([0-9A-Fa-f]+)"
+)
+SDKCONFIG_RE = re.compile(r"^CONFIG_LV_FONT_MONTSERRAT_(\d+)=y\s*$", re.MULTILINE)
+SDKCONFIG_DEFAULT_RE = re.compile(r"^CONFIG_LV_FONT_DEFAULT_MONTSERRAT_(\d+)=y\s*$", re.MULTILINE)
+
+
+@dataclass
+class UiScan:
+    sizes: Set[int] = field(default_factory=set)
+    builtin_refs: Dict[int, List[str]] = field(default_factory=dict)
+    symbols: Set[str] = field(default_factory=set)
+    # Non-ASCII character -> "file:line" locations that use it.
+    extra_chars: Dict[str, List[str]] = field(default_factory=dict)
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Generate Montserrat subsets for the UI")
+    parser.add_argument("input", type=Path, help="UI source directory to scan")
+    parser.add_argument("output", type=Path, help="Directory to write the subset fonts to")
+    parser.add_argument("--lvgl", type=Path, help="LVGL checkout (default: search the repo)")
+    parser.add_argument("--bpp", type=int, choices=[1, 2, 4, 8], default=DEFAULT_BPP)
+    parser.add_argument(
+        "--font-conv",
+        default=os.environ.get("LV_FONT_CONV", "lv_font_conv"),
+        help="lv_font_conv command (npm i -g lv_font_conv, or 'npx lv_font_conv')",
+    )
+    parser.add_argument(
+        "--scan",
+        type=Path,
+        action="append",
+        default=[],
+        help="Extra source directories checked for built-in font references",
+    )
+    parser.add_argument(
+        "--sdkconfig",
+        type=Path,
+        action="append",
+        default=[],
+        help="sdkconfig(.defaults) whose enabled Montserrat sizes are checked for use",
+    )
+    parser.add_argument(
+        "--report-only",
+        action="store_true",
+        help="Scan and report without running lv_font_conv",
+    )
+    return parser.parse_args()
+
+
+def iter_sources(root: Path, skip: Optional[Path] = None) -> Iterable[Path]:
+    for path in sorted(root.rglob("*")):
+        if path.suffix not in SOURCE_EXTENSIONS or not path.is_file():
+            continue
+        if skip is not None and skip in path.parents:
+            continue
+        yield path
+
+
+def decode_c_string(body: str) -> str:
+    """Decode the escapes that matter for glyph coverage; sources are UTF-8 already."""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        ch = body[i]
+        if ch != "\\":
+            out += ch.encode("utf-8")
+            i += 1
+            continue
+        nxt = body[i + 1] if i + 1 < len(body) else ""
+        if nxt in ("u", "U"):
+            digits = 4 if nxt == "u" else 8
+            out += chr(int(body[i + 2 : i + 2 + digits], 16)).encode("utf-8")
+            i += 2 + digits
+        elif nxt == "x":
+            match = re.match(r"[0-9A-Fa-f]{1,2}", body[i + 2 :])
+            out.append(int(match.group(0), 16) if match else 0)
+            i += 2 + (len(match.group(0)) if match else 0)
+        else:
+            out += {"n": b"\n", "t": b"\t", "r": b"\r", "0": b"\0"}.get(nxt, nxt.encode("utf-8"))
+            i += 2
+    return out.decode("utf-8", errors="replace")
+
+
+def scan_ui(root: Path, skip: Path) -> UiScan:
+    scan = UiScan()
+    for path in iter_sources(root, skip):
+        rel = path.relative_to(root)
+        for lineno, line in enumerate(path.read_text(encoding="utf-8").splitlines(), 1):
+            stripped = line.lstrip()
+            if stripped.startswith("#include") or stripped.startswith("//"):
+                continue
+            location = f"{rel}:{lineno}"
+            scan.sizes.update(int(size) for size in UI_FONT_RE.findall(line))
+            for size in BUILTIN_REF_RE.findall(line):
+                scan.builtin_refs.setdefault(int(size), []).append(location)
+            scan.symbols.update(SYMBOL_RE.findall(line))
+            for literal in STRING_RE.findall(line):
+                for ch in decode_c_string(literal):
+                    if ord(ch) > ASCII_RANGE[1]:
+                        scan.extra_chars.setdefault(ch, []).append(location)
+    return scan
+
+
+def scan_builtin_refs(roots: Iterable[Path]) -> Set[int]:
+    sizes: Set[int] = set()
+    for root in roots:
+        for path in iter_sources(root):
+            text = path.read_text(encoding="utf-8", errors="replace")
+            sizes.update(int(size) for size in BUILTIN_REF_RE.findall(text))
+    return sizes
+
+
+def find_lvgl(explicit: Optional[Path]) -> Optional[Path]:
+    candidates = [explicit] if explicit is not None else LVGL_CANDIDATES
+    for candidate in candidates:
+        if candidate is not None and (candidate / SYMBOL_DEFS).is_file():
+            return candidate
+    return None
+
+
+def load_symbol_codepoints(lvgl: Path) -> Dict[str, int]:
+    text = (lvgl / SYMBOL_DEFS).read_text(encoding="utf-8")
+    return {name: int(cp, 16) for name, cp in SYMBOL_DEF_RE.findall(text)}
+
+
+def bitmap_stats(source: Path) -> Tuple[int, int]:
+    """(glyph count, bitmap bytes) of an lv_font_conv-generated font source."""
+    if not source.is_file():
+        return 0, 0
+    text = source.read_text(encoding="utf-8", errors="replace")
+    bitmap = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", text, re.DOTALL)
+    glyphs = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\n\};", text, re.DOTALL)
+    bitmap_bytes = len(re.findall(r"0x[0-9a-fA-F]{2}", bitmap.group(1))) if bitmap else 0
+    # Entry 0 is the reserved "no glyph" descriptor.
+    glyph_count = len(re.findall(r"\{\.bitmap_index", glyphs.group(1))) - 1 if glyphs else 0
+    return glyph_count, bitmap_bytes
+
+
+def format_ranges(codepoints: Iterable[int]) -> str:
+    return ",".join(hex(cp) for cp in sorted(codepoints))
+
+
+def run_font_conv(
+    command: str,
+    lvgl: Path,
+    size: int,
+    bpp: int,
+    extra_chars: str,
+    symbol_cps: List[int],
+    output: Path,
+) -> None:
+    args = shlex.split(command) + [
+        "--no-compress",
+        "--no-prefilter",
+        "--force-fast-kern-format",
+        "--format",
+        "lvgl",
+        "--bpp",
+        str(bpp),
+        "--size",
+        str(size),
+        "--lv-font-name",
+        FONT_NAME.format(size=size),
+        "--font",
+        str(lvgl / TEXT_FONT),
+        "-r",
+        f"{hex(ASCII_RANGE[0])}-{hex(ASCII_RANGE[1])}",
+    ]
+    if extra_chars:
+        args += ["--symbols", extra_chars]
+    if symbol_cps:
+        args += ["--font", str(lvgl / SYMBOL_FONT), "-r", format_ranges(symbol_cps)]
+    args += ["-o", str(output)]
+    subprocess.run(args, check=True)
+
+
+def write_header(output_dir: Path, sizes: List[int]) -> None:
+    lines = [
+        "/* Generated by tools/gen_font_subset.py; do not edit. */",
+        "#pragma once",
+        "",
+        "#define UI_FONT_SUBSET 1",
+        "",
+    ]
+    lines += [f"LV_FONT_DECLARE({FONT_NAME.format(size=size)})" for size in sizes]
+    (output_dir / HEADER_NAME).write_text("\n".join(lines) + "\n", encoding="utf-8")
+
+
+def print_report(rows: List[Dict[str, int]]) -> None:
+    print(f"{'size':>4}  {'glyphs':>13}  {'bitmap KB':>17}  {'saved KB':>8}")
+    total_builtin = total_subset = 0
+    for row in rows:
+        total_builtin += row["builtin_bytes"]
+        total_subset += row["subset_bytes"]
+        saved = (row["builtin_bytes"] - row["subset_bytes"]) / 1024
+        print(
+            f"{row['size']:>4}  {row['builtin_glyphs']:>5} -> {row['subset_glyphs']:<5}"
+            f"  {row['builtin_bytes'] / 1024:>7.1f} -> {row['subset_bytes'] / 1024:<7.1f}"
+            f"  {saved:>8.1f}"
+        )
+    if total_builtin:
+        print(f"total bitmap: {total_builtin / 1024:.1f} KB -> {total_subset / 1024:.1f} KB")
+
+
+def main() -> int:
+    args = parse_args()
+    if not args.input.is_dir():
+        print(f"Input directory {args.input} not found", file=sys.stderr)
+        return 1
+
+    scan = scan_ui(args.input, args.output)
+    sizes = sorted(scan.sizes)
+    for size, locations in sorted(scan.builtin_refs.items()):
+        print(f"warning: lv_font_montserrat_{size} used directly at {', '.join(locations)}; "
+              "use UI_FONT() so the subset applies", file=sys.stderr)
+
+    lvgl = find_lvgl(args.lvgl)
+    symbol_map = load_symbol_codepoints(lvgl) if lvgl is not None else {}
+    unknown = sorted(name for name in scan.symbols if name not in symbol_map)
+    symbol_cps = sorted({symbol_map[name] for name in scan.symbols if name in symbol_map})
+    # Icons inside literals (LV_SYMBOL_* expanded by hand) come from the symbol font.
+    symbol_range = set(symbol_map.values())
+    text_chars = sorted(ch for ch in scan.extra_chars if ord(ch) not in symbol_range)
+    symbol_cps = sorted(
+        set(symbol_cps) | {ord(ch) for ch in scan.extra_chars if ord(ch) in symbol_range}
+    )
+    extra = "".join(text_chars)
+
+    print(f"sizes: {', '.join(str(size) for size in sizes) or 'none'}")
+    print(f"text: printable ASCII + {extra!r}")
+    print(f"icons: {', '.join(sorted(scan.symbols)) or 'none'}")
+    if lvgl is None:
+        print("warning: no LVGL checkout found (pass --lvgl); icons and built-in sizes unknown",
+              file=sys.stderr)
+    elif unknown:
+        print(f"warning: unknown symbols {', '.join(unknown)}", file=sys.stderr)
+
+    enabled_unused: Dict[str, List[int]] = {}
+    if args.sdkconfig:
+        # Once the subsets are generated, UI_FONT() sizes no longer need the built-in font.
+        referenced = scan_builtin_refs([args.input] + args.scan)
+        if args.report_only:
+            referenced |= set(sizes)
+        for sdkconfig in args.sdkconfig:
+            text = sdkconfig.read_text()
+            referenced |= {int(size) for size in SDKCONFIG_DEFAULT_RE.findall(text)}
+            enabled = {int(size) for size in SDKCONFIG_RE.findall(text)}
+            unused = sorted(enabled - referenced)
+            enabled_unused[str(sdkconfig)] = unused
+            if unused:
+                print(f"{sdkconfig}: built-in sizes enabled but unused: "
+                      f"{', '.join(str(size) for size in unused)}")
+
+    rows: List[Dict[str, int]] = []
+    if not args.report_only:
+        if lvgl is None:
+            return 1
+        if shutil.which(shlex.split(args.font_conv)[0]) is None:
+            print(f"{args.font_conv} not found; install it with `npm i -g lv_font_conv`",
+                  file=sys.stderr)
+            return 1
+        args.output.mkdir(parents=True, exist_ok=True)
+        for size in sizes:
+            output = args.output / f"{FONT_NAME.format(size=size)}.c"
+            run_font_conv(args.font_conv, lvgl, size, args.bpp, extra, symbol_cps, output)
+            builtin_glyphs, builtin_bytes = bitmap_stats(lvgl / BUILTIN_FONT.format(size=size))
+            subset_glyphs, subset_bytes = bitmap_stats(output)
+            rows.append(
+                {
+                    "size": size,
+                    "builtin_glyphs": builtin_glyphs,
+                    "builtin_bytes": builtin_bytes,
+                    "subset_glyphs": subset_glyphs,
+                    "subset_bytes": subset_bytes,
+                }
+            )
+        write_header(args.output, sizes)
+        print_report(rows)
+
+        report = {
+            "sizes": sizes,
+            "bpp": args.bpp,
+            "ascii": [ASCII_RANGE[0], ASCII_RANGE[1]],
+            "extra_chars": {ch: locs for ch, locs in sorted(scan.extra_chars.items())},
+            "symbols": sorted(scan.symbols),
+            "fonts": rows,
+            "sdkconfig_unused_sizes": enabled_unused,
+        }
+        (args.output / REPORT_NAME).write_text(
+            json.dumps(report, indent=2, ensure_ascii=False) + "\n", encoding="utf-8"
+        )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+
+"""Turn the raw addresses in a /profile capture into function names.
+
+`GET /profile?seconds=N` (the diag server on the Tab5, or the desktop build started with
+`TAB5_PROFILE_PORT`) returns folded stacks whose frames are addresses, because the device
+carries no symbol tables:
+
+    lvgl;0x4001a2b4 57                 (Tab5: absolute address in the firmware ELF)
+    main;app_desktop_build+0x3459 21   (desktop: offset into the named module)
+
+This script resolves them with addr2line against the given ELF, expands inlined calls into
+their own frames, merges stacks that end up identical and prints the result in the same
+folded format, ready for `flamegraph.pl` or speedscope:
+
+    curl -s "http://tab5.local/profile?seconds=10" > tab5.folded
+    tools/symbolize_profile.py tab5.folded \\
+        --elf platforms/tab5/build/m5tab5_userdemo.elf | flamegraph.pl > cpu.svg
+
+Frames from other desktop modules (libc, SDL) are resolved when `--lib-dir` holds them and
+are otherwise left as they are.
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import shutil
+import subprocess
+import sys
+from collections import defaultdict
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Tuple
+
+ADDR_FRAME = re.compile(r"^0x([0-9a-fA-F]+)$")
+MODULE_FRAME = re.compile(r"^(.+)\+0x([0-9a-fA-F]+)$")
+ADDR2LINE_CANDIDATES = ("riscv32-esp-elf-addr2line", "addr2line")
+
+
+def find_addr2line(requested: Optional[str]) -> str:
+    if requested:
+        return requested
+    for candidate in ADDR2LINE_CANDIDATES:
+        path = shutil.which(candidate)
+        if path:
+            return path
+    sys.exit("error: no addr2line found, pass --addr2line")
+
+
+def parse_folded(lines: Iterable[str]) -> List[Tuple[List[str], int]]:
+    stacks = []
+    for number, line in enumerate(lines, 1):
+        line = line.rstrip("\n")
+        if not line:
+            continue
+        stack, _, count = line.rpartition(" ")
+        if not stack or not count.isdigit():
+            sys.exit(f"error: line {number} is not folded-stack output: {line!r}")
+        stacks.append((stack.split(";"), int(count)))
+    return stacks
+
+
+def resolve(addr2line: str, binary: Path, addresses: List[int]) -> Dict[int, List[str]]:
+    """Map each address to its frames, outermost first, with inlined callers expanded."""
+    if not addresses:
+        return {}
+    cmd = [addr2line, "-e", str(binary), "-a", "-f", "-i", "-C"]
+    cmd += [f"0x{address:x}" for address in addresses]
+    output = subprocess.run(cmd, check=True, capture_output=True, text=True).stdout.splitlines()
+
+    # With -a each address is echoed first, then one function/location pair per inline level,
+    # innermost first
+    resolved: Dict[int, List[str]] = {}
+    current: Optional[int] = None
+    functions: List[str] = []
+    index = 0
+    while index < len(output):
+        line = output[index]
+        if ADDR_FRAME.match(line):
+            if current is not None:
+                resolved[current] = functions
+            current = int(line, 16)
+            functions = []
+            index += 1
+            continue
+        if current is not None and line != "??":
+            functions.append(line.replace(";", "_").replace(" ", "_"))
+        index += 2
+    if current is not None:
+        resolved[current] = functions
+    return {address: list(reversed(names)) for address, names in resolved.items() if names}
+
+
+def symbolize(stacks, addr2line: str, elf: Path, lib_dir: Optional[Path]):
+    wanted: Dict[Path, set] = defaultdict(set)
+    for frames, _ in stacks:
+        for frame in frames:
+            target = locate(frame, elf, lib_dir)
+            if target:
+                wanted[target[0]].add(target[1])
+
+    names: Dict[Tuple[Path, int], List[str]] = {}
+    for binary, addresses in wanted.items():
+        for address, frames in resolve(addr2line, binary, sorted(addresses)).items():
+            names[(binary, address)] = frames
+
+    merged: Dict[str, int] = defaultdict(int)
+    for frames, count in stacks:
+        out: List[str] = []
+        for frame in frames:
+            target = locate(frame, elf, lib_dir)
+            out.extend(names.get(target, [frame]) if target else [frame])
+        merged[";".join(out)] += count
+    return sorted(merged.items(), key=lambda item: (-item[1], item[0]))
+
+
+def locate(frame: str, elf: Path, lib_dir: Optional[Path]) -> Optional[Tuple[Path, int]]:
+    match = ADDR_FRAME.match(frame)
+    if match:
+        return elf, int(match.group(1), 16)
+    match = MODULE_FRAME.match(frame)
+    if not match:
+        return None
+    module, offset = match.group(1), int(match.group(2), 16)
+    if module == elf.name:
+        return elf, offset
+    if lib_dir and (lib_dir / module).is_file():
+        return lib_dir / module, offset
+    return None
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("folded", help="capture from /profile, or - for stdin")
+    parser.add_argument("--elf", required=True, type=Path, help="firmware ELF or desktop executable")
+    parser.add_argument("--addr2line", help="addr2line to use (default: the ESP toolchain's, then the host's)")
+    parser.add_argument("--lib-dir", type=Path, help="directory holding the desktop build's shared libraries")
+    parser.add_argument("-o", "--output", help="write here instead of stdout")
+    args = parser.parse_args(argv)
+
+    if not args.elf.is_file():
+        sys.exit(f"error: {args.elf} not found")
+    if args.folded == "-":
+        stacks = parse_folded(sys.stdin)
+    else:
+        with open(args.folded, encoding="utf-8") as handle:
+            stacks = parse_folded(handle)
+
+    result = symbolize(stacks, find_addr2line(args.addr2line), args.elf, args.lib_dir)
+    text = "".join(f"{stack} {count}\n" for stack, count in result)
+    if args.output:
+        Path(args.output).write_text(text, encoding="utf-8")
+    else:
+        sys.stdout.write(text)
+
+    total = sum(count for _, count in result)
+    print(f"{total} samples in {len(result)} stacks", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())